@@ -81,6 +81,8 @@ bool      DecalManager::smDecalsOn = true;
 bool      DecalManager::smDebugRender = false;
 F32       DecalManager::smDecalLifeTimeScale = 1.0f;
 bool      DecalManager::smPoolBuffers = true;
+bool      DecalManager::smThreadedClipping = true;
+U32       DecalManager::smMaxClipMSPerFrame = 2;
 const U32 DecalManager::smMaxVerts = 6000;
 const U32 DecalManager::smMaxIndices = 10000;
 
@@ -261,6 +263,16 @@ void DecalManager::consoleInit()
       "If false, will just clear them at the end of a frame.\n"
       "@ingroup Decals" );
 
+   Con::addVariable( "$Decals::threadedClipping", TypeBool, &smThreadedClipping,
+      "If true, decal geometry is clipped by jobs on the worker threads and "
+      "shows up once the job is done.\n"
+      "@ingroup Decals" );
+
+   Con::addVariable( "$Decals::maxClipMSPerFrame", TypeS32, &smMaxClipMSPerFrame,
+      "The time in milliseconds the main thread may spend on clipping decals "
+      "in a frame.  Decals over the budget are clipped in later frames.\n"
+      "@ingroup Decals" );
+
    Con::addVariable( "$Decals::debugRender", TypeBool, &smDebugRender,
       "If true, the decal spheres will be visualized when in the editor.\n\n"
       "@ingroup Decals" );
@@ -305,22 +317,17 @@ bool DecalManager::_handleGFXEvent(GFXDevice::GFXDeviceEventType event)
    return true;
 }
 
-bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts, const Point2F *clipDepth )
+void DecalManager::_initClipper( DecalInstance *decal, const Point2F *clipDepth, ClippedPolyList *clipper, MatrixF *outProjMat, Box3F *outBox )
 {
-   PROFILE_SCOPE( DecalManager_clipDecal );
-
-   // Free old verts and indices.
-   _freeBuffers( decal );
-
    F32 halfSize = decal->mSize * 0.5f;
    
    // Ugly hack for ProjectedShadow!
    F32 halfSizeZ = clipDepth ? clipDepth->x : halfSize;
    F32 negHalfSize = clipDepth ? clipDepth->y : halfSize;
-   Point3F decalHalfSize( halfSize, halfSize, halfSize );
    Point3F decalHalfSizeZ( halfSizeZ, halfSizeZ, halfSizeZ );
 
-   MatrixF projMat( true );
+   MatrixF &projMat = *outProjMat;
+   projMat.identity();
    decal->getWorldMatrix( &projMat );
 
    const VectorF &crossVec = decal->mNormal;
@@ -330,39 +337,34 @@ bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts,
    projMat.getColumn( 0, &newRight );
    projMat.getColumn( 1, &newFwd );   
 
-   VectorF objRight( 1.0f, 0, 0 );
-   VectorF objFwd( 0, 1.0f, 0 );
-   VectorF objUp( 0, 0, 1.0f );
-
    // See above re: decalHalfSizeZ hack.
-   mClipper.clear();
-   mClipper.mPlaneList.setSize(6);
-   mClipper.mPlaneList[0].set( ( decalPos + ( -newRight * halfSize ) ), -newRight );
-   mClipper.mPlaneList[1].set( ( decalPos + ( -newFwd * halfSize ) ), -newFwd );
-   mClipper.mPlaneList[2].set( ( decalPos + ( -crossVec * decalHalfSizeZ ) ), -crossVec );
-   mClipper.mPlaneList[3].set( ( decalPos + ( newRight * halfSize ) ), newRight );
-   mClipper.mPlaneList[4].set( ( decalPos + ( newFwd * halfSize ) ), newFwd );
-   mClipper.mPlaneList[5].set( ( decalPos + ( crossVec * negHalfSize ) ), crossVec );
+   clipper->clear();
+   clipper->mPlaneList.setSize(6);
+   clipper->mPlaneList[0].set( ( decalPos + ( -newRight * halfSize ) ), -newRight );
+   clipper->mPlaneList[1].set( ( decalPos + ( -newFwd * halfSize ) ), -newFwd );
+   clipper->mPlaneList[2].set( ( decalPos + ( -crossVec * decalHalfSizeZ ) ), -crossVec );
+   clipper->mPlaneList[3].set( ( decalPos + ( newRight * halfSize ) ), newRight );
+   clipper->mPlaneList[4].set( ( decalPos + ( newFwd * halfSize ) ), newFwd );
+   clipper->mPlaneList[5].set( ( decalPos + ( crossVec * negHalfSize ) ), crossVec );
 
-   mClipper.mNormal = decal->mNormal;
+   clipper->mNormal = decal->mNormal;
 
    const DecalData *decalData = decal->mDataBlock;
 
-   mClipper.mNormalTolCosineRadians = mCos( mDegToRad( decalData->clippingAngle ) );
+   clipper->mNormalTolCosineRadians = mCos( mDegToRad( decalData->clippingAngle ) );
 
-   Box3F box( -decalHalfSizeZ, decalHalfSizeZ );
+   *outBox = Box3F( -decalHalfSizeZ, decalHalfSizeZ );
 
-   projMat.mul( box );
-
-   PROFILE_START( DecalManager_clipDecal_buildPolyList );
-   getContainer()->buildPolyList( PLC_Decal, box, decalData->clippingMasks, &mClipper );   
-   PROFILE_END();
+   projMat.mul( *outBox );
+}
 
-   mClipper.cullUnusedVerts();
-   mClipper.triangulate();
+bool DecalManager::_finishClipper( ClippedPolyList &clipper, bool skipVertexNormals )
+{
+   clipper.cullUnusedVerts();
+   clipper.triangulate();
    
-   const U32 numVerts = mClipper.mVertexList.size();
-   const U32 numIndices = mClipper.mIndexList.size();
+   const U32 numVerts = clipper.mVertexList.size();
+   const U32 numIndices = clipper.mIndexList.size();
 
    if ( !numVerts || !numIndices )
       return false;
@@ -373,17 +375,19 @@ bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts,
         numIndices > smMaxIndices )
       return false;
 
-   if ( !decalData->skipVertexNormals )
-      mClipper.generateNormals();
-   
-#ifdef DECALMANAGER_DEBUG
-   mDebugPlanes.clear();
-   mDebugPlanes.merge( mClipper.mPlaneList );
-#endif
+   if ( !skipVertexNormals )
+      clipper.generateNormals();
+
+   return true;
+}
+
+void DecalManager::_fillGeometry( const ClippedPolyList &clipper, const MatrixF &projMat, F32 halfSize, const RectF &texRect, DecalVertex *outVerts, U16 *outIndices )
+{
+   Point3F decalHalfSize( halfSize, halfSize, halfSize );
+
+   VectorF objRight( 1.0f, 0, 0 );
+   VectorF objFwd( 0, 1.0f, 0 );
 
-   decal->mVertCount = numVerts;
-   decal->mIndxCount = numIndices;
-   
    Vector<Point3F> tmpPoints;
 
    tmpPoints.push_back(( objFwd * decalHalfSize ) + ( objRight * decalHalfSize ));
@@ -392,7 +396,8 @@ bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts,
    
    Point3F lowerLeft(( -objFwd * decalHalfSize ) + ( objRight * decalHalfSize ));
 
-   projMat.inverse();
+   MatrixF worldToDecal( projMat );
+   worldToDecal.inverse();
 
    _generateWindingOrder( lowerLeft, &tmpPoints );
 
@@ -403,25 +408,17 @@ bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts,
 
    Point2F uv( 0, 0 );
    Point3F vecX(0.0f, 0.0f, 0.0f);
-
-   // Allocate memory for vert and index arrays
-   _allocBuffers( decal );  
-
-   // Mark this so that the color will be assigned on these verts the next
-   // time it renders, since we just threw away the previous verts.
-   decal->mLastAlpha = -1;
-   
    Point3F vertPoint( 0, 0, 0 );
 
-   for ( U32 i = 0; i < mClipper.mVertexList.size(); i++ )
+   for ( U32 i = 0; i < clipper.mVertexList.size(); i++ )
    {
-      const ClippedPolyList::Vertex &vert = mClipper.mVertexList[i];
+      const ClippedPolyList::Vertex &vert = clipper.mVertexList[i];
       vertPoint = vert.point;
 
       // Transform this point to
       // object space to look up the
       // UV coordinate for this vertex.
-      projMat.mulP( vertPoint );
+      worldToDecal.mulP( vertPoint );
 
       // Clamp the point to be within the quad.
       vertPoint.x = mClampF( vertPoint.x, -decalHalfSize.x, decalHalfSize.x );
@@ -430,51 +427,93 @@ bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts,
       // Get our UV.
       uv = quadToSquare.transform( Point2F( vertPoint.x, vertPoint.y ) );
 
-      const RectF &rect = decal->mDataBlock->texRect[decal->mTextureRectIdx];
-
-      uv *= rect.extent;
-      uv += rect.point;      
+      uv *= texRect.extent;
+      uv += texRect.point;      
 
       // Set the world space vertex position.
-      decal->mVerts[i].point = vert.point;
+      outVerts[i].point = vert.point;
       
-      decal->mVerts[i].texCoord.set( uv.x, uv.y );
+      outVerts[i].texCoord.set( uv.x, uv.y );
       
-      if ( mClipper.mNormalList.empty() )
+      if ( clipper.mNormalList.empty() )
          continue;
 
-      decal->mVerts[i].normal = mClipper.mNormalList[i];
-      decal->mVerts[i].normal.normalize();
+      outVerts[i].normal = clipper.mNormalList[i];
+      outVerts[i].normal.normalize();
 
-      if( mFabs( decal->mVerts[i].normal.z ) > 0.8f ) 
-         mCross( decal->mVerts[i].normal, Point3F( 1.0f, 0.0f, 0.0f ), &vecX );
-      else if ( mFabs( decal->mVerts[i].normal.x ) > 0.8f )
-         mCross( decal->mVerts[i].normal, Point3F( 0.0f, 1.0f, 0.0f ), &vecX );
-      else if ( mFabs( decal->mVerts[i].normal.y ) > 0.8f )
-         mCross( decal->mVerts[i].normal, Point3F( 0.0f, 0.0f, 1.0f ), &vecX );
+      if( mFabs( outVerts[i].normal.z ) > 0.8f ) 
+         mCross( outVerts[i].normal, Point3F( 1.0f, 0.0f, 0.0f ), &vecX );
+      else if ( mFabs( outVerts[i].normal.x ) > 0.8f )
+         mCross( outVerts[i].normal, Point3F( 0.0f, 1.0f, 0.0f ), &vecX );
+      else if ( mFabs( outVerts[i].normal.y ) > 0.8f )
+         mCross( outVerts[i].normal, Point3F( 0.0f, 0.0f, 1.0f ), &vecX );
    
-      decal->mVerts[i].tangent = mCross( decal->mVerts[i].normal, vecX );
+      outVerts[i].tangent = mCross( outVerts[i].normal, vecX );
    }
 
    U32 curIdx = 0;
-   for ( U32 j = 0; j < mClipper.mPolyList.size(); j++ )
+   for ( U32 j = 0; j < clipper.mPolyList.size(); j++ )
    {
       // Write indices for each Poly
-      ClippedPolyList::Poly *poly = &mClipper.mPolyList[j];                  
+      const ClippedPolyList::Poly *poly = &clipper.mPolyList[j];                  
 
       AssertFatal( poly->vertexCount == 3, "Got non-triangle poly!" );
 
-      decal->mIndices[curIdx] = mClipper.mIndexList[poly->vertexStart];         
+      outIndices[curIdx] = clipper.mIndexList[poly->vertexStart];         
       curIdx++;
-      decal->mIndices[curIdx] = mClipper.mIndexList[poly->vertexStart + 1];            
+      outIndices[curIdx] = clipper.mIndexList[poly->vertexStart + 1];            
       curIdx++;
-      decal->mIndices[curIdx] = mClipper.mIndexList[poly->vertexStart + 2];                
+      outIndices[curIdx] = clipper.mIndexList[poly->vertexStart + 2];                
       curIdx++;
    } 
+}
+
+bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts, const Point2F *clipDepth )
+{
+   PROFILE_SCOPE( DecalManager_clipDecal );
+
+   // This clip replaces any that is still running for the decal.
+   _cancelClipJobs( decal );
+
+   // Free old verts and indices.
+   _freeBuffers( decal );
+
+   MatrixF projMat;
+   Box3F box;
+   _initClipper( decal, clipDepth, &mClipper, &projMat, &box );
+
+   const DecalData *decalData = decal->mDataBlock;
+
+   PROFILE_START( DecalManager_clipDecal_buildPolyList );
+   getContainer()->buildPolyList( PLC_Decal, box, decalData->clippingMasks, &mClipper );   
+   PROFILE_END();
+
+   if ( !_finishClipper( mClipper, decalData->skipVertexNormals ) )
+      return false;
+   
+#ifdef DECALMANAGER_DEBUG
+   mDebugPlanes.clear();
+   mDebugPlanes.merge( mClipper.mPlaneList );
+#endif
+
+   decal->mVertCount = mClipper.mVertexList.size();
+   decal->mIndxCount = mClipper.mIndexList.size();
+
+   // Allocate memory for vert and index arrays
+   _allocBuffers( decal );  
+
+   // Mark this so that the color will be assigned on these verts the next
+   // time it renders, since we just threw away the previous verts.
+   decal->mLastAlpha = -1;
+
+   _fillGeometry( mClipper, projMat, decal->mSize * 0.5f, decalData->texRect[decal->mTextureRectIdx], decal->mVerts, decal->mIndices );
 
    if ( !edgeVerts )
       return true;
 
+   MatrixF worldToDecal( projMat );
+   worldToDecal.inverse();
+
    Point3F tmpHullPt( 0, 0, 0 );
    Vector<Point3F> tmpHullPts;
 
@@ -482,7 +521,7 @@ bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts,
    {
       const ClippedPolyList::Vertex &vert = mClipper.mVertexList[i];
       tmpHullPt = vert.point;
-      projMat.mulP( tmpHullPt );
+      worldToDecal.mulP( tmpHullPt );
       tmpHullPts.push_back( tmpHullPt );
    }
 
@@ -490,13 +529,206 @@ bool DecalManager::clipDecal( DecalInstance *decal, Vector<Point3F> *edgeVerts,
    U32 verts = _generateConvexHull( tmpHullPts, edgeVerts );
    edgeVerts->setSize( verts );
 
-   projMat.inverse();
    for ( U32 i = 0; i < edgeVerts->size(); i++ )
       projMat.mulP( (*edgeVerts)[i] );
 
    return true;
 }
 
+bool DecalManager::_clipFlaggedDecal( DecalInstance *decal, U32 clipStartTime, bool *clippedAny )
+{
+   // Decals over the clipping budget keep their flag and are clipped in
+   // a later frame; at least one decal is clipped each frame.
+   if (  !( decal->mFlags & ClipDecal ) || decal->mFlags & CustomDecal ||
+         ( *clippedAny && Platform::getRealMilliseconds() - clipStartTime >= smMaxClipMSPerFrame ) )
+      return true;
+
+   // Turn off the flag so we don't continually try to clip
+   // if it fails.
+   decal->mFlags = decal->mFlags & ~ClipDecal;
+   *clippedAny = true;
+
+   if ( smThreadedClipping )
+   {
+      // The geometry is committed when the job is done.  Until then
+      // the decal keeps rendering its old geometry, if it has any.
+      _queueClipJob( decal );
+      return true;
+   }
+
+   if ( clipDecal( decal ) )
+      return true;
+
+   // If the decal is one placed at run-time (not the editor)
+   // then we should also permanently delete the decal instance.
+   // A decal placed by the editor will be flagged to attempt
+   // clipping again the next time it is modified.
+   if ( !( decal->mFlags & SaveDecal ) )
+      removeDecal( decal );
+
+   return false;
+}
+
+void DecalManager::_queueClipJob( DecalInstance *decal )
+{
+   PROFILE_SCOPE( DecalManager_queueClipJob );
+
+   // A newer clip replaces any that is still running for the decal.
+   _cancelClipJobs( decal );
+
+   ClipJob *job = new ClipJob;
+   job->manager = this;
+   job->decal = decal;
+   job->submitTime = Platform::getRealMilliseconds();
+
+   const DecalData *decalData = decal->mDataBlock;
+   job->halfSize = decal->mSize * 0.5f;
+   job->texRect = decalData->texRect[decal->mTextureRectIdx];
+   job->skipVertexNormals = decalData->skipVertexNormals;
+
+   Box3F box;
+   _initClipper( decal, NULL, &job->clipper, &job->projMat, &box );
+
+   // Scene queries aren't thread-safe, so the geometry is gathered here
+   // and clipped by the job.  The gather list has no planes and accepts
+   // everything.
+   PROFILE_START( DecalManager_queueClipJob_buildPolyList );
+   getContainer()->buildPolyList( PLC_Decal, box, decalData->clippingMasks, &job->geometry );
+   PROFILE_END();
+
+   mClipJobs.push_back( job );
+
+   if ( job->geometry.isEmpty() )
+      job->done = 1;
+   else
+      ThreadPool::GLOBAL().queueJob( &_clipDecalJob, job, &mClipJobCounter );
+}
+
+void DecalManager::_clipDecalJob( void *data, U32 begin, U32 end )
+{
+   ClipJob *job = reinterpret_cast<ClipJob*>( data );
+   const U32 startTime = Platform::getRealMilliseconds();
+
+   // Feed the gathered geometry through the clipper of the job.  The
+   // gather list is in world space, which is what the clipper expects.
+   const ClippedPolyList &geometry = job->geometry;
+   ClippedPolyList &clipper = job->clipper;
+
+   for ( U32 i = 0; i < geometry.mVertexList.size(); i++ )
+      clipper.addPointAndNormal( geometry.mVertexList[i].point, geometry.mNormalList[i] );
+
+   for ( U32 i = 0; i < geometry.mPolyList.size(); i++ )
+   {
+      const ClippedPolyList::Poly &poly = geometry.mPolyList[i];
+
+      // Keep the clipping flag the poly was gathered with.
+      clipper.mAllowClipping = ( poly.polyFlags & CLIPPEDPOLYLIST_FLAG_ALLOWCLIPPING ) != 0;
+      clipper.begin( poly.material, poly.surfaceKey );
+      for ( U32 j = 0; j < poly.vertexCount; j++ )
+         clipper.vertex( geometry.mIndexList[ poly.vertexStart + j ] );
+      clipper.mPolyList.last().plane = poly.plane;
+      clipper.end();
+   }
+
+   if ( job->manager->_finishClipper( clipper, job->skipVertexNormals ) )
+   {
+      job->verts.setSize( clipper.mVertexList.size() );
+      job->indices.setSize( clipper.mIndexList.size() );
+      job->manager->_fillGeometry( clipper, job->projMat, job->halfSize, job->texRect, job->verts.address(), job->indices.address() );
+      job->success = true;
+   }
+
+   job->clipTime = Platform::getRealMilliseconds() - startTime;
+
+   dFetchAndAdd( job->done, 1 );
+}
+
+void DecalManager::_commitClipJobs( bool wait )
+{
+   if ( mClipJobs.empty() )
+      return;
+
+   PROFILE_SCOPE( DecalManager_commitClipJobs );
+
+   if ( wait )
+      ThreadPool::GLOBAL().waitForJobs( mClipJobCounter );
+
+   const U32 now = Platform::getRealMilliseconds();
+   U32 committed = 0;
+   U32 latency = 0;
+   U32 clipTime = 0;
+
+   for ( U32 i = 0; i < mClipJobs.size(); )
+   {
+      ClipJob *job = mClipJobs[i];
+      if ( !dAtomicRead( job->done ) )
+      {
+         i++;
+         continue;
+      }
+      mClipJobs.erase( i );
+
+      DecalInstance *decal = job->decal;
+      if ( decal )
+      {
+         committed++;
+         latency += now - job->submitTime;
+         clipTime += job->clipTime;
+
+         _freeBuffers( decal );
+
+         if ( job->success )
+         {
+            decal->mVertCount = job->verts.size();
+            decal->mIndxCount = job->indices.size();
+            _allocBuffers( decal );
+
+            dMemcpy( decal->mVerts, job->verts.address(), job->verts.size() * sizeof( DecalVertex ) );
+            dMemcpy( decal->mIndices, job->indices.address(), job->indices.size() * sizeof( U16 ) );
+
+            // Make sure the color is assigned on the new verts.
+            decal->mLastAlpha = -1;
+         }
+         else if ( !( decal->mFlags & SaveDecal ) )
+         {
+            // Clipping failed to get any geometry.  A decal placed at
+            // run-time is deleted; an editor decal waits to be modified.
+            removeDecal( decal );
+         }
+      }
+
+      delete job;
+   }
+
+   if ( committed )
+   {
+      Con::setIntVariable( "$Decal::ClipLatency", latency / committed );
+      Con::setIntVariable( "$Decal::ClipTime", clipTime );
+   }
+}
+
+void DecalManager::_cancelClipJobs( DecalInstance *decal )
+{
+   if ( mClipJobs.empty() )
+      return;
+
+   if ( decal )
+   {
+      for ( U32 i = 0; i < mClipJobs.size(); i++ )
+      {
+         if ( mClipJobs[i]->decal == decal )
+            mClipJobs[i]->decal = NULL;
+      }
+      return;
+   }
+
+   ThreadPool::GLOBAL().waitForJobs( mClipJobCounter );
+
+   for ( U32 i = 0; i < mClipJobs.size(); i++ )
+      delete mClipJobs[i];
+   mClipJobs.clear();
+}
+
 DecalInstance* DecalManager::addDecal( const Point3F &pos,
                                        const Point3F &normal,
                                        F32 rotAroundNormal,
@@ -551,6 +783,7 @@ void DecalManager::removeDecal( DecalInstance *inst )
    
    // Release its geometry (if it has any).
 
+   _cancelClipJobs( inst );
    _freeBuffers( inst );
    
    // Remove it from the decal file.
@@ -1002,6 +1235,9 @@ void DecalManager::prepRenderImage( SceneRenderState* state )
    if ( !state->isDiffusePass() )
       return;
 
+   // Pick up the geometry of finished clip jobs.
+   _commitClipJobs( false );
+
    PROFILE_START( DecalManager_RenderDecals_SphereTreeCull );
 
    const Frustum& rootFrustum = state->getCameraFrustum();
@@ -1060,6 +1296,9 @@ void DecalManager::prepRenderImage( SceneRenderState* state )
    DecalInstance *dinst;
    DecalData *ddata;
 
+   const U32 clipStartTime = Platform::getRealMilliseconds();
+   bool clippedAny = false;
+
    // Loop through DecalQueue once for preRendering work.
    // 1. Update DecalInstance fade (over time)
    // 2. Clip geometry if flagged to do so.
@@ -1103,32 +1342,13 @@ void DecalManager::prepRenderImage( SceneRenderState* state )
       }
 
       // Build clipped geometry for this decal if needed.
-      if ( dinst->mFlags & ClipDecal && !( dinst->mFlags & CustomDecal ) )
-      {  
-         // Turn off the flag so we don't continually try to clip
-         // if it fails.
-         dinst->mFlags = dinst->mFlags & ~ClipDecal;
-
-         if ( !(dinst->mFlags & CustomDecal) && !clipDecal( dinst ) )
-         {
-            // Clipping failed to get any geometry...
-
-            // Remove it from the render queue.
-            mDecalQueue.erase_fast( i );
-            i--;
-
-            // If the decal is one placed at run-time (not the editor)
-            // then we should also permanently delete the decal instance.
-            if ( !(dinst->mFlags & SaveDecal) )
-            {
-               removeDecal( dinst );
-            }
-
-            // If this is a decal placed by the editor it will be
-            // flagged to attempt clipping again the next time it is
-            // modified. For now we just skip rendering it.      
-            continue;
-         }         
+      if ( !_clipFlaggedDecal( dinst, clipStartTime, &clippedAny ) )
+      {
+         // Clipping failed to get any geometry, so remove it from the
+         // render queue.
+         mDecalQueue.erase_fast( i );
+         i--;
+         continue;
       }
 
       // If we get here and the decal still does not have any geometry
@@ -1443,6 +1663,7 @@ void DecalManager::prepRenderImage( SceneRenderState* state )
    Con::setIntVariable( "$Decal::Batches", batches.size() );
    Con::setIntVariable( "$Decal::Buffers", mPBs.size() + mPBPool.size() );
    Con::setIntVariable( "$Decal::DecalsRendered", mDecalQueue.size() );
+   Con::setIntVariable( "$Decal::ClipJobsPending", mClipJobs.size() );
 #endif
 
    if( smDebugRender && gEditingMission )
@@ -1560,6 +1781,8 @@ bool DecalManager::loadDecals( const UTF8 *fileName )
 void DecalManager::clearData()
 {
    mClearDataSignal.trigger();
+
+   _cancelClipJobs( NULL );
    
    // Free all geometry buffers.
    
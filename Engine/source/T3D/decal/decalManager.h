@@ -63,6 +63,10 @@
 #include "core/dataChunker.h"
 #endif
 
+#ifndef _THREADPOOL_H_
+#include "platform/threads/threadPool.h"
+#endif
+
 
 //#define DECALMANAGER_DEBUG
 
@@ -97,6 +101,53 @@ class DecalManager : public SceneObject
       /// to avoid excessive memory allocations.
       ClippedPolyList mClipper;
 
+      /// A decal being clipped on a worker thread.
+      struct ClipJob
+      {
+         DecalManager *manager;
+
+         /// The decal the result goes to; NULL if the decal was removed or
+         /// clipped again while the job was running.
+         DecalInstance *decal;
+
+         /// Scene geometry around the decal, gathered unclipped on the
+         /// main thread.
+         ClippedPolyList geometry;
+
+         /// The clipper of this job, set up with the decal planes.
+         ClippedPolyList clipper;
+
+         MatrixF projMat;
+         F32 halfSize;
+         RectF texRect;
+         bool skipVertexNormals;
+
+         /// @name Results
+         /// @{
+         Vector<DecalVertex> verts;
+         Vector<U16> indices;
+         bool success;
+         /// @}
+
+         /// Real time at which the job was queued.
+         U32 submitTime;
+
+         /// Real milliseconds spent clipping on the worker.
+         U32 clipTime;
+
+         /// Set by the job when it is done.
+         volatile U32 done;
+
+         ClipJob() : manager( NULL ), decal( NULL ), halfSize( 0.0f ), skipVertexNormals( false ),
+            success( false ), submitTime( 0 ), clipTime( 0 ), done( 0 ) {}
+      };
+
+      /// Clip jobs that have not been committed yet.
+      Vector<ClipJob*> mClipJobs;
+
+      /// Counts the jobs of mClipJobs.
+      ThreadPool::JobCounter mClipJobCounter;
+
       Vector<DecalInstance*> mDecalQueue;
 
       StringTableEntry mDataFileName;
@@ -136,6 +187,8 @@ class DecalManager : public SceneObject
       static bool smDecalsOn;
       static F32 smDecalLifeTimeScale;   
       static bool smPoolBuffers;
+      static bool smThreadedClipping;
+      static U32 smMaxClipMSPerFrame;
       static const U32 smMaxVerts;
       static const U32 smMaxIndices;
 
@@ -161,6 +214,39 @@ class DecalManager : public SceneObject
       
       void _generateWindingOrder( const Point3F &cornerPoint, Vector<Point3F> *sortPoints );
 
+      /// @name Clipping
+      /// @{
+
+      /// Set up the planes of a clipper for the decal and return the decal
+      /// transform and the world box to gather geometry from.
+      void _initClipper( DecalInstance *decal, const Point2F *clipDepth, ClippedPolyList *clipper, MatrixF *outProjMat, Box3F *outBox );
+
+      /// Triangulate the clipped geometry and generate normals.
+      /// @return False if there is no geometry or too much of it.
+      bool _finishClipper( ClippedPolyList &clipper, bool skipVertexNormals );
+
+      /// Write the vertices and indices of the clipped geometry.
+      void _fillGeometry( const ClippedPolyList &clipper, const MatrixF &projMat, F32 halfSize, const RectF &texRect, DecalVertex *outVerts, U16 *outIndices );
+
+      /// Clip the decal if it is flagged for clipping and the clipping
+      /// budget of the frame, which started at clipStartTime, allows it.
+      /// @return False if clipping failed and the decal has no geometry.
+      bool _clipFlaggedDecal( DecalInstance *decal, U32 clipStartTime, bool *clippedAny );
+
+      /// Gather the geometry for the decal and queue a job to clip it.
+      void _queueClipJob( DecalInstance *decal );
+
+      /// Copy the results of the finished clip jobs to their decals.
+      void _commitClipJobs( bool wait );
+
+      /// Drop the results of the clip jobs for the decal, or of all jobs
+      /// if decal is NULL.
+      void _cancelClipJobs( DecalInstance *decal );
+
+      static void _clipDecalJob( void *data, U32 begin, U32 end );
+
+      /// @}
+
       // Helpers for creating and deleting the vert and index arrays
       // held by DecalInstance.
       void _allocBuffers( DecalInstance *inst );
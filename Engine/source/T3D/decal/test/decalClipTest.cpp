@@ -0,0 +1,307 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "T3D/decal/decalManager.h"
+#include "T3D/decal/decalInstance.h"
+#include "T3D/objectTypes.h"
+#include "scene/sceneManager.h"
+#include "collision/abstractPolyList.h"
+#include "console/console.h"
+
+FIXTURE(DecalClip)
+{
+public:
+   /// A box for decals to be clipped against.
+   class BoxObject : public SceneObject
+   {
+   public:
+      BoxObject(const Box3F& box)
+      {
+         mTypeMask |= StaticShapeObjectType;
+         mNetFlags.set(IsGhost);
+         mObjBox = box;
+      }
+
+      virtual bool onAdd()
+      {
+         if (!Parent::onAdd())
+            return false;
+         resetWorldBox();
+         addToScene();
+         return true;
+      }
+
+      virtual void onRemove()
+      {
+         removeFromScene();
+         Parent::onRemove();
+      }
+
+      virtual bool buildPolyList(PolyListContext context, AbstractPolyList* polyList, const Box3F& box, const SphereF& sphere)
+      {
+         polyList->setTransform(&mObjToWorld, mObjScale);
+         polyList->setObject(this);
+         polyList->addBox(mObjBox);
+         return true;
+      }
+   };
+
+   /// Gives the tests access to the clipping steps.
+   class TestDecalManager : public DecalManager
+   {
+   public:
+      void queueClipJob(DecalInstance* decal) { _queueClipJob(decal); }
+      void commitClipJobs(bool wait) { _commitClipJobs(wait); }
+      void cancelClipJobs(DecalInstance* decal) { _cancelClipJobs(decal); }
+      bool clipFlaggedDecal(DecalInstance* decal, U32 clipStartTime, bool* clippedAny) { return _clipFlaggedDecal(decal, clipStartTime, clippedAny); }
+      void freeBuffers(DecalInstance* decal) { _freeBuffers(decal); }
+      U32 getNumClipJobs() const { return mClipJobs.size(); }
+   };
+
+   Vector<BoxObject*> mBoxes;
+   TestDecalManager* mManager;
+   DecalData mDecalData;
+   Vector<DecalInstance*> mDecals;
+
+   bool mThreadedClipping;
+   S32 mMaxClipMSPerFrame;
+
+   virtual void SetUp()
+   {
+      mThreadedClipping = Con::getBoolVariable("$Decals::threadedClipping");
+      mMaxClipMSPerFrame = Con::getIntVariable("$Decals::maxClipMSPerFrame");
+
+      // A floor with steps on it, so decals cover faces of several
+      // objects facing different ways.
+      addBox(Box3F(Point3F(-20.0f, -20.0f, -1.0f), Point3F(20.0f, 20.0f, 0.0f)));
+      addBox(Box3F(Point3F(0.0f, 0.0f, 0.0f), Point3F(2.0f, 2.0f, 0.5f)));
+      addBox(Box3F(Point3F(-3.0f, 1.0f, 0.0f), Point3F(-1.5f, 4.0f, 1.0f)));
+
+      mManager = new TestDecalManager();
+      gClientSceneGraph->addObjectToScene(mManager);
+   }
+
+   virtual void TearDown()
+   {
+      mManager->cancelClipJobs(NULL);
+      for (U32 i = 0; i < mDecals.size(); i++)
+      {
+         mManager->freeBuffers(mDecals[i]);
+         delete mDecals[i];
+      }
+      mDecals.clear();
+
+      gClientSceneGraph->removeObjectFromScene(mManager);
+      delete mManager;
+
+      for (U32 i = 0; i < mBoxes.size(); i++)
+         mBoxes[i]->deleteObject();
+      mBoxes.clear();
+
+      Con::setBoolVariable("$Decals::threadedClipping", mThreadedClipping);
+      Con::setIntVariable("$Decals::maxClipMSPerFrame", mMaxClipMSPerFrame);
+   }
+
+   void addBox(const Box3F& box)
+   {
+      BoxObject* obj = new BoxObject(box);
+      obj->registerObject();
+      mBoxes.push_back(obj);
+   }
+
+   /// A decal flagged for clipping that is not in a decal file.
+   DecalInstance* addDecal(const Point3F& pos, const Point3F& normal, U8 flags = ClipDecal)
+   {
+      DecalInstance* decal = new DecalInstance;
+      decal->mDataBlock = &mDecalData;
+      decal->mPosition = pos;
+      decal->mNormal = normal;
+      decal->mNormal.normalize();
+      decal->mTangent = mCross(Point3F(0.0f, 1.0f, 0.0f), decal->mNormal);
+      decal->mTangent.normalize();
+      decal->mRotAroundNormal = 0.0f;
+      decal->mSize = 3.0f;
+      decal->mCreateTime = 0;
+      decal->mVisibility = 1.0f;
+      decal->mLastAlpha = -1.0f;
+      decal->mTextureRectIdx = 0;
+      decal->mVerts = NULL;
+      decal->mIndices = NULL;
+      decal->mVertCount = 0;
+      decal->mIndxCount = 0;
+      decal->mFlags = flags;
+      decal->mRenderPriority = 0;
+      decal->mCustomTex = NULL;
+
+      mDecals.push_back(decal);
+      return decal;
+   }
+
+   /// Decals over the steps, some tilted so they cover side faces too.
+   void addDecals()
+   {
+      addDecal(Point3F(1.0f, 1.0f, 0.5f), Point3F(0.0f, 0.0f, 1.0f));
+      addDecal(Point3F(2.0f, 1.0f, 0.25f), Point3F(0.4f, 0.2f, 1.0f));
+      addDecal(Point3F(-1.5f, 2.5f, 0.5f), Point3F(-0.5f, 0.0f, 1.0f));
+      addDecal(Point3F(-2.0f, 0.5f, 0.0f), Point3F(0.2f, -0.4f, 1.0f));
+      addDecal(Point3F(5.0f, 5.0f, 0.0f), Point3F(0.0f, 0.0f, 1.0f));
+      addDecal(Point3F(0.0f, 0.0f, 0.3f), Point3F(-0.3f, -0.3f, 1.0f));
+   }
+
+   /// The serial clipper takes the vertices of each object just before
+   /// its polys while a job takes all of them first, so the vertex order
+   /// may differ.  The triangles come out in the same order, so compare
+   /// the vertices they index.
+   void expectSameGeometry(const DecalInstance* expected, const DecalInstance* decal)
+   {
+      ASSERT_EQ(expected->mVertCount, decal->mVertCount);
+      ASSERT_EQ(expected->mIndxCount, decal->mIndxCount);
+
+      for (U32 i = 0; i < expected->mIndxCount; i++)
+      {
+         ASSERT_LT(expected->mIndices[i], expected->mVertCount);
+         ASSERT_LT(decal->mIndices[i], decal->mVertCount);
+
+         const DecalVertex& a = expected->mVerts[expected->mIndices[i]];
+         const DecalVertex& b = decal->mVerts[decal->mIndices[i]];
+         EXPECT_TRUE(a.point.equal(b.point, 1e-4f)) << "index " << i;
+         EXPECT_TRUE(a.normal.equal(b.normal, 1e-4f)) << "index " << i;
+         EXPECT_TRUE(a.tangent.equal(b.tangent, 1e-4f)) << "index " << i;
+         EXPECT_NEAR(a.texCoord.x, b.texCoord.x, 1e-4f) << "index " << i;
+         EXPECT_NEAR(a.texCoord.y, b.texCoord.y, 1e-4f) << "index " << i;
+      }
+   }
+};
+
+TEST_FIX(DecalClip, ThreadedMatchesSerial)
+{
+   addDecals();
+   const U32 count = mDecals.size();
+   addDecals();
+
+   for (U32 i = 0; i < count; i++)
+   {
+      ASSERT_TRUE(mManager->clipDecal(mDecals[i]));
+      EXPECT_GT(mDecals[i]->mIndxCount, 0U);
+   }
+
+   for (U32 i = 0; i < count; i++)
+      mManager->queueClipJob(mDecals[count + i]);
+   mManager->commitClipJobs(true);
+   EXPECT_EQ(0U, mManager->getNumClipJobs());
+
+   for (U32 i = 0; i < count; i++)
+      expectSameGeometry(mDecals[i], mDecals[count + i]);
+}
+
+TEST_FIX(DecalClip, CancelledJobIsDiscarded)
+{
+   DecalInstance* cancelled = addDecal(Point3F(1.0f, 1.0f, 0.5f), Point3F(0.0f, 0.0f, 1.0f));
+   DecalInstance* removed = addDecal(Point3F(-1.5f, 2.5f, 0.5f), Point3F(0.0f, 0.0f, 1.0f));
+   DecalInstance* reclipped = addDecal(Point3F(0.0f, 0.0f, 0.3f), Point3F(0.0f, 0.0f, 1.0f));
+
+   mManager->queueClipJob(cancelled);
+   mManager->queueClipJob(removed);
+   mManager->queueClipJob(reclipped);
+
+   mManager->cancelClipJobs(cancelled);
+   mManager->removeDecal(removed);
+
+   // Clipping the decal again on the main thread wins over its job.
+   ASSERT_TRUE(mManager->clipDecal(reclipped));
+   const DecalVertex* verts = reclipped->mVerts;
+
+   mManager->commitClipJobs(true);
+   EXPECT_EQ(0U, mManager->getNumClipJobs());
+
+   EXPECT_TRUE(cancelled->mVerts == NULL);
+   EXPECT_EQ(0U, cancelled->mVertCount);
+   EXPECT_TRUE(removed->mVerts == NULL);
+   EXPECT_EQ(0U, removed->mVertCount);
+   EXPECT_EQ(verts, reclipped->mVerts);
+}
+
+TEST_FIX(DecalClip, ClipBudget)
+{
+   DecalInstance* first = addDecal(Point3F(1.0f, 1.0f, 0.5f), Point3F(0.0f, 0.0f, 1.0f));
+   DecalInstance* second = addDecal(Point3F(-1.5f, 2.5f, 0.5f), Point3F(0.0f, 0.0f, 1.0f));
+   DecalInstance* custom = addDecal(Point3F(5.0f, 5.0f, 0.0f), Point3F(0.0f, 0.0f, 1.0f), ClipDecal | CustomDecal);
+
+   // With no budget only the first decal of the frame is clipped.
+   Con::setBoolVariable("$Decals::threadedClipping", false);
+   Con::setIntVariable("$Decals::maxClipMSPerFrame", 0);
+
+   bool clippedAny = false;
+   U32 startTime = Platform::getRealMilliseconds();
+   EXPECT_TRUE(mManager->clipFlaggedDecal(first, startTime, &clippedAny));
+   EXPECT_TRUE(mManager->clipFlaggedDecal(second, startTime, &clippedAny));
+   EXPECT_TRUE(mManager->clipFlaggedDecal(custom, startTime, &clippedAny));
+
+   EXPECT_TRUE(clippedAny);
+   EXPECT_FALSE(first->mFlags & ClipDecal);
+   EXPECT_GT(first->mIndxCount, 0U);
+   EXPECT_TRUE(second->mFlags & ClipDecal);
+   EXPECT_EQ(0U, second->mIndxCount);
+
+   // The next frame picks it up, on a worker this time.
+   Con::setBoolVariable("$Decals::threadedClipping", true);
+   Con::setIntVariable("$Decals::maxClipMSPerFrame", 1000);
+
+   clippedAny = false;
+   startTime = Platform::getRealMilliseconds();
+   EXPECT_TRUE(mManager->clipFlaggedDecal(second, startTime, &clippedAny));
+   EXPECT_TRUE(mManager->clipFlaggedDecal(custom, startTime, &clippedAny));
+   EXPECT_FALSE(second->mFlags & ClipDecal);
+   EXPECT_EQ(1U, mManager->getNumClipJobs());
+
+   mManager->commitClipJobs(true);
+   EXPECT_GT(second->mIndxCount, 0U);
+
+   // Custom decals are never clipped by the manager.
+   EXPECT_TRUE(custom->mFlags & ClipDecal);
+   EXPECT_TRUE(custom->mVerts == NULL);
+}
+
+TEST_FIX(DecalClip, FailedClipRemovesDecal)
+{
+   // Nothing to project onto out here.
+   DecalInstance* serial = addDecal(Point3F(100.0f, 100.0f, 50.0f), Point3F(0.0f, 0.0f, 1.0f));
+   DecalInstance* threaded = addDecal(Point3F(100.0f, 100.0f, 50.0f), Point3F(0.0f, 0.0f, 1.0f));
+
+   Con::setBoolVariable("$Decals::threadedClipping", false);
+   bool clippedAny = false;
+   EXPECT_FALSE(mManager->clipFlaggedDecal(serial, Platform::getRealMilliseconds(), &clippedAny));
+   EXPECT_TRUE(serial->mVerts == NULL);
+
+   Con::setBoolVariable("$Decals::threadedClipping", true);
+   clippedAny = false;
+   EXPECT_TRUE(mManager->clipFlaggedDecal(threaded, Platform::getRealMilliseconds(), &clippedAny));
+   mManager->commitClipJobs(true);
+   EXPECT_EQ(0U, mManager->getNumClipJobs());
+   EXPECT_TRUE(threaded->mVerts == NULL);
+}
+
+#endif
@@ -37,6 +37,11 @@
 #include "T3D/gameBase/gameProcess.h"
 #include "lighting/lightInfo.h"
 #include "console/engineAPI.h"
+#include "platform/threads/threadPool.h"
+
+#if defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )
+#include <xmmintrin.h>
+#endif
 
 #if defined(TORQUE_OS_XENON)
 #  include "gfx/D3D9/360/gfx360MemVertexBuffer.h"
@@ -44,6 +49,9 @@
 
 Point3F ParticleEmitter::mWindVelocity( 0.0, 0.0, 0.0 );
 const F32 ParticleEmitter::AgedSpinToRadians = (1.0f/1000.0f) * (1.0f/360.0f) * M_PI_F * 2.0f;
+bool ParticleEmitter::smUseSoA = false;
+bool ParticleEmitter::smParallelUpdates = true;
+Vector<ParticleEmitter*> ParticleEmitter::smPendingUpdates( __FILE__, __LINE__ );
 
 IMPLEMENT_CO_DATABLOCK_V1(ParticleEmitterData);
 IMPLEMENT_CONOBJECT(ParticleEmitter);
@@ -740,6 +748,12 @@ ParticleEmitter::ParticleEmitter()
 
    mCurBuffSize = 0;
 
+   mUseSoA = false;
+   mPendingUpdateMS = 0;
+   mPendingUpdateCount = 0;
+   mPendingIndex = 0;
+   mPendingBBox = false;
+
    mDead = false;
    mDataBlock = NULL;
 
@@ -758,6 +772,21 @@ ParticleEmitter::~ParticleEmitter()
    }
 }
 
+//-----------------------------------------------------------------------------
+// consoleInit
+//-----------------------------------------------------------------------------
+void ParticleEmitter::consoleInit()
+{
+   Con::addVariable( "ParticleEmitter::useSoA", TypeBool, &smUseSoA,
+      "@brief If true, emitters created afterwards keep their particles in "
+      "structure-of-arrays storage and update them with SIMD kernels.\n\n"
+      "@ingroup FX" );
+   Con::addVariable( "ParticleEmitter::parallelUpdates", TypeBool, &smParallelUpdates,
+      "@brief If true, the particle updates of structure-of-arrays emitters "
+      "run in parallel on the worker threads.\n\n"
+      "@ingroup FX" );
+}
+
 //-----------------------------------------------------------------------------
 // onAdd
 //-----------------------------------------------------------------------------
@@ -789,6 +818,12 @@ bool ParticleEmitter::onAdd()
 //-----------------------------------------------------------------------------
 void ParticleEmitter::onRemove()
 {
+   if( mPendingUpdateMS )
+   {
+      _removePending();
+      mPendingUpdateMS = 0;
+   }
+
    removeFromScene();
    Parent::onRemove();
 }
@@ -833,6 +868,17 @@ bool ParticleEmitter::onNewDataBlock( GameBaseData *dptr, bool reload )
       store_block[n_part_capacity-1].next = NULL;
       part_list_head.next = NULL;
       n_parts = 0;
+
+      if( mPendingUpdateMS )
+      {
+         _removePending();
+         mPendingUpdateMS = 0;
+         mPendingBBox = false;
+      }
+      mUseSoA = smUseSoA;
+      mSoA.clear();
+      if( mUseSoA )
+         mSoA.reserve( n_part_capacity );
    }
 
    scriptOnNewDataBlock();
@@ -847,11 +893,20 @@ ColorF ParticleEmitter::getCollectiveColor()
 	U32 count = 0;
 	ColorF color = ColorF(0.0f, 0.0f, 0.0f);
 
-   count = n_parts;
-   for( Particle* part = part_list_head.next; part != NULL; part = part->next )
+   if( mUseSoA )
    {
-      color += part->color;
+      flushPendingUpdate();
+      for( U32 i = 0; i < mSoA.size(); i++ )
+         color += ColorF( mSoA.colorR[i], mSoA.colorG[i], mSoA.colorB[i], mSoA.colorA[i] );
    }
+   else
+   {
+      for( Particle* part = part_list_head.next; part != NULL; part = part->next )
+      {
+         color += part->color;
+      }
+   }
+   count = n_parts;
 
 	if(count > 0)
    {
@@ -879,9 +934,11 @@ void ParticleEmitter::prepRenderImage(SceneRenderState* state)
 
    PROFILE_SCOPE(ParticleEmitter_prepRenderImage);
 
+   updatePending();
+
    if (  mDead ||
          n_parts == 0 || 
-         part_list_head.next == NULL )
+         ( mUseSoA ? mSoA.size() == 0 : part_list_head.next == NULL ) )
       return;
 
    RenderPassManager *renderManager = state->getRenderPass();
@@ -920,6 +977,8 @@ void ParticleEmitter::prepRenderImage(SceneRenderState* state)
    // use first particle's texture unless there is an emitter texture to override it
    if (mDataBlock->textureHandle)
      ri->diffuseTex = &*(mDataBlock->textureHandle);
+   else if (mUseSoA)
+     ri->diffuseTex = &*(mSoA.dataBlock[mSoA.size() - 1]->textureHandle);
    else
      ri->diffuseTex = &*(part_list_head.next->dataBlock->textureHandle);
 
@@ -1109,7 +1168,24 @@ void ParticleEmitter::emitParticles(const Point3F& start,
       // NOTE: We are assuming that the just added particle is at the head of our
       //  list.  If that changes, so must this...
       U32 advanceMS = numMilliseconds - currTime;
-      if (mDataBlock->overrideAdvance == false && advanceMS != 0) 
+      if (mDataBlock->overrideAdvance == false && advanceMS != 0 && mUseSoA)
+      {
+         // The newest particle is at the end of the streams.
+         U32 last = mSoA.size() - 1;
+         if (advanceMS > mSoA.totalLifetime[last])
+         {
+            mSoA.removeLast();
+            n_parts--;
+         }
+         else
+         {
+            mSoA.integrate( last, last + 1, F32(advanceMS) / 1000.0f, mWindVelocity );
+            mSoA.updateKeys( last, last + 1,
+                             mDataBlock->useEmitterColors ? colors : NULL,
+                             mDataBlock->useEmitterSizes ? sizes : NULL );
+         }
+      }
+      else if (mDataBlock->overrideAdvance == false && advanceMS != 0) 
       {
          Particle* last_part = part_list_head.next;
          if (advanceMS > last_part->totalLifetime) 
@@ -1141,7 +1217,12 @@ void ParticleEmitter::emitParticles(const Point3F& start,
 
    // DMMFIX: Lame and slow...
    if( particlesAdded == true )
-      updateBBox();
+   {
+      if( mPendingUpdateMS )
+         mPendingBBox = true;
+      else
+         updateBBox();
+   }
 
 
    if( n_parts > 0 && getSceneManager() == NULL )
@@ -1231,11 +1312,24 @@ void ParticleEmitter::updateBBox()
    Point3F minPt(1e10,   1e10,  1e10);
    Point3F maxPt(-1e10, -1e10, -1e10);
 
-   for (Particle* part = part_list_head.next; part != NULL; part = part->next)
+   if (mUseSoA)
    {
-      Point3F particleSize(part->size * 0.5f, 0.0f, part->size * 0.5f);
-      minPt.setMin( part->pos - particleSize );
-      maxPt.setMax( part->pos + particleSize );
+      for (U32 i = 0; i < mSoA.size(); i++)
+      {
+         Point3F pos(mSoA.posX[i], mSoA.posY[i], mSoA.posZ[i]);
+         Point3F particleSize(mSoA.partSize[i] * 0.5f, 0.0f, mSoA.partSize[i] * 0.5f);
+         minPt.setMin( pos - particleSize );
+         maxPt.setMax( pos + particleSize );
+      }
+   }
+   else
+   {
+      for (Particle* part = part_list_head.next; part != NULL; part = part->next)
+      {
+         Point3F particleSize(part->size * 0.5f, 0.0f, part->size * 0.5f);
+         minPt.setMin( part->pos - particleSize );
+         maxPt.setMax( part->pos + particleSize );
+      }
    }
    
    mObjBox = Box3F(minPt, maxPt);
@@ -1263,20 +1357,32 @@ void ParticleEmitter::addParticle(const Point3F& pos,
    {
       // In an emergency we allocate additional particles in blocks of 16.
       // This should happen rarely.
-      Particle* store_block = new Particle[16];
-      part_store.push_back(store_block);
-      n_part_capacity += 16;
-      for (S32 i = 0; i < 16; i++)
+      if (mUseSoA)
+         mSoA.reserve(n_part_capacity + 16);
+      else
       {
-        store_block[i].next = part_freelist;
-        part_freelist = &store_block[i];
+         Particle* store_block = new Particle[16];
+         part_store.push_back(store_block);
+         for (S32 i = 0; i < 16; i++)
+         {
+           store_block[i].next = part_freelist;
+           part_freelist = &store_block[i];
+         }
       }
+      n_part_capacity += 16;
       mDataBlock->allocPrimBuffer(n_part_capacity); // allocate larger primitive buffer or will crash 
    }
-   Particle* pNew = part_freelist;
-   part_freelist = pNew->next;
-   pNew->next = part_list_head.next;
-   part_list_head.next = pNew;
+
+   // SoA particles are set up here and then copied into the streams.
+   Particle soaPart;
+   Particle* pNew = &soaPart;
+   if (!mUseSoA)
+   {
+      pNew = part_freelist;
+      part_freelist = pNew->next;
+      pNew->next = part_list_head.next;
+      part_list_head.next = pNew;
+   }
 
    Point3F ejectionAxis = axis;
    F32 theta = (mDataBlock->thetaMax - mDataBlock->thetaMin) * gRandGen.randF() +
@@ -1310,6 +1416,8 @@ void ParticleEmitter::addParticle(const Point3F& pos,
    mDataBlock->particleDataBlocks[dBlockIndex]->initializeParticle(pNew, vel);
    updateKeyData( pNew );
 
+   if (mUseSoA)
+      mSoA.add( *pNew );
 }
 
 
@@ -1344,6 +1452,26 @@ void ParticleEmitter::advanceTime(F32 dt)
    U32 numMSToUpdate = (U32)(dt * 1000.0f);
    if( numMSToUpdate == 0 ) return;
 
+   if( mUseSoA )
+   {
+      // Finish a step that nobody rendered before deferring the next one.
+      flushPendingUpdate();
+
+      if( mSoA.size() == 0 )
+      {
+         if( mDeleteWhenEmpty )
+            mDeleteOnTick = true;
+         return;
+      }
+
+      // The step runs with the other emitters in updatePending().
+      mPendingUpdateMS = numMSToUpdate;
+      mPendingUpdateCount = mSoA.size();
+      mPendingIndex = smPendingUpdates.size();
+      smPendingUpdates.push_back( this );
+      return;
+   }
+
    // TODO: Prefetch
 
    // remove dead particles
@@ -1451,6 +1579,89 @@ void ParticleEmitter::update( U32 ms )
    }
 }
 
+//-----------------------------------------------------------------------------
+// Update SoA particles
+//-----------------------------------------------------------------------------
+void ParticleEmitter::updateSoA()
+{
+   PROFILE_SCOPE(ParticleEmitter_updateSoA);
+
+   // Particles emitted after the step was deferred are left alone.
+   U32 count = mSoA.age( mPendingUpdateCount, mPendingUpdateMS );
+   mSoA.integrate( 0, count, F32(mPendingUpdateMS) / 1000.0f, mWindVelocity );
+   mSoA.updateKeys( 0, count,
+                    mDataBlock->useEmitterColors ? colors : NULL,
+                    mDataBlock->useEmitterSizes ? sizes : NULL );
+
+   n_parts = mSoA.size();
+   if( n_parts < 1 && mDeleteWhenEmpty )
+      mDeleteOnTick = true;
+
+   mPendingUpdateMS = 0;
+}
+
+void ParticleEmitter::flushPendingUpdate()
+{
+   if( !mPendingUpdateMS )
+      return;
+
+   _removePending();
+   updateSoA();
+
+   if( mPendingBBox )
+   {
+      mPendingBBox = false;
+      updateBBox();
+   }
+}
+
+void ParticleEmitter::_removePending()
+{
+   AssertFatal( smPendingUpdates[ mPendingIndex ] == this, "ParticleEmitter::_removePending - bad pending slot" );
+
+   // Order doesn't matter, so fill the hole with the last emitter.
+   ParticleEmitter *last = smPendingUpdates.last();
+   smPendingUpdates[ mPendingIndex ] = last;
+   last->mPendingIndex = mPendingIndex;
+   smPendingUpdates.pop_back();
+}
+
+void ParticleEmitter::_updatePendingJob( void *data, U32 begin, U32 end )
+{
+   ParticleEmitter **emitters = (ParticleEmitter**)data;
+   for( U32 i = begin; i < end; i++ )
+      emitters[i]->updateSoA();
+}
+
+void ParticleEmitter::updatePending()
+{
+   if( smPendingUpdates.empty() )
+      return;
+
+   PROFILE_SCOPE(ParticleEmitter_updatePending);
+
+   // Each emitter only touches its own particles, so they can be
+   // updated on any thread.
+   if( smParallelUpdates && smPendingUpdates.size() > 1 )
+      ThreadPool::GLOBAL().parallelFor( 0, smPendingUpdates.size(), 1, &_updatePendingJob, smPendingUpdates.address() );
+   else
+      _updatePendingJob( smPendingUpdates.address(), 0, smPendingUpdates.size() );
+
+   // Bounds touch the scene container, so they are updated here on the
+   // main thread.
+   for( U32 i = 0; i < smPendingUpdates.size(); i++ )
+   {
+      ParticleEmitter *emitter = smPendingUpdates[i];
+      if( emitter->mPendingBBox )
+      {
+         emitter->mPendingBBox = false;
+         emitter->updateBBox();
+      }
+   }
+
+   smPendingUpdates.clear();
+}
+
 //-----------------------------------------------------------------------------
 // Copy particles to vertex buffer
 //-----------------------------------------------------------------------------
@@ -1482,6 +1693,29 @@ void ParticleEmitter::copyToVB( const Point3F &camPos, const ColorF &ambientColo
 
    PROFILE_START(ParticleEmitter_copyToVB);
 
+   const bool soaBillboards = mUseSoA &&
+                              !mDataBlock->orientParticles &&
+                              !mDataBlock->alignParticles &&
+                              !mDataBlock->sortParticles;
+
+   // SoA particles are gathered into a newest-first list for the vertex
+   // setup that has no SoA version.
+   static Vector<Particle> gatheredParticles(__FILE__, __LINE__);
+   Particle *head = part_list_head.next;
+   if (mUseSoA && !soaBillboards)
+   {
+     PROFILE_SCOPE(ParticleEmitter_copyToVB_Gather);
+
+     const U32 count = mSoA.size();
+     gatheredParticles.setSize(count);
+     for (U32 i = 0; i < count; i++)
+     {
+       mSoA.get(count - 1 - i, gatheredParticles[i]);
+       gatheredParticles[i].next = (i + 1 < count) ? &gatheredParticles[i + 1] : NULL;
+     }
+     head = count ? gatheredParticles.address() : NULL;
+   }
+
    PROFILE_START(ParticleEmitter_copyToVB_Sort);
    // build sorted list of particles (far to near)
    if (mDataBlock->sortParticles)
@@ -1492,7 +1726,7 @@ void ParticleEmitter::copyToVB( const Point3F &camPos, const ColorF &ambientColo
      Point3F viewvec; modelview.getRow(1, &viewvec);
 
      // add each particle and a distance based sort key to orderedVector
-     for (Particle* pp = part_list_head.next; pp != NULL; pp = pp->next)
+     for (Particle* pp = head; pp != NULL; pp = pp->next)
      {
        orderedVector.increment();
        orderedVector.last().p = pp;
@@ -1538,7 +1772,7 @@ void ParticleEmitter::copyToVB( const Point3F &camPos, const ColorF &ambientColo
         // do unsorted-oriented particles
         else
         {
-          for (Particle* partPtr = part_list_head.next; partPtr != NULL; partPtr = partPtr->next, buffPtr-=4)
+          for (Particle* partPtr = head; partPtr != NULL; partPtr = partPtr->next, buffPtr-=4)
              setupOriented(partPtr, camPos, ambientColor, buffPtr);
         }
       }
@@ -1554,7 +1788,7 @@ void ParticleEmitter::copyToVB( const Point3F &camPos, const ColorF &ambientColo
         // do unsorted-oriented particles
         else
         {
-          for (Particle* partPtr = part_list_head.next; partPtr != NULL; partPtr = partPtr->next, buffPtr+=4)
+          for (Particle* partPtr = head; partPtr != NULL; partPtr = partPtr->next, buffPtr+=4)
              setupOriented(partPtr, camPos, ambientColor, buffPtr);
         }
       }
@@ -1578,7 +1812,7 @@ void ParticleEmitter::copyToVB( const Point3F &camPos, const ColorF &ambientColo
          // do unsorted-oriented particles
          else
          {
-            Particle *partPtr = part_list_head.next;
+            Particle *partPtr = head;
             for (; partPtr != NULL; partPtr = partPtr->next, buffPtr-=4)
                setupAligned(partPtr, ambientColor, buffPtr);
          }
@@ -1595,7 +1829,7 @@ void ParticleEmitter::copyToVB( const Point3F &camPos, const ColorF &ambientColo
          // do unsorted-oriented particles
          else
          {
-            Particle *partPtr = part_list_head.next;
+            Particle *partPtr = head;
             for (; partPtr != NULL; partPtr = partPtr->next, buffPtr+=4)
                setupAligned(partPtr, ambientColor, buffPtr);
          }
@@ -1616,7 +1850,11 @@ void ParticleEmitter::copyToVB( const Point3F &camPos, const ColorF &ambientColo
       MatrixF camView = GFX->getWorldMatrix();
       camView.transpose();  // inverse - this gets the particles facing camera
 
-      if (mDataBlock->reverseOrder)
+      if (soaBillboards)
+      {
+        setupBillboardsSoA( camView, ambientColor, buffPtr );
+      }
+      else if (mDataBlock->reverseOrder)
       {
         buffPtr += 4*(n_parts-1);
         // do sorted-billboard particles
@@ -1629,7 +1867,7 @@ void ParticleEmitter::copyToVB( const Point3F &camPos, const ColorF &ambientColo
         // do unsorted-billboard particles
         else
         {
-          for (Particle* partPtr = part_list_head.next; partPtr != NULL; partPtr = partPtr->next, buffPtr-=4)
+          for (Particle* partPtr = head; partPtr != NULL; partPtr = partPtr->next, buffPtr-=4)
              setupBillboard( partPtr, basePoints, camView, ambientColor, buffPtr );
         }
       }
@@ -1645,7 +1883,7 @@ void ParticleEmitter::copyToVB( const Point3F &camPos, const ColorF &ambientColo
         // do unsorted-billboard particles
         else
         {
-          for (Particle* partPtr = part_list_head.next; partPtr != NULL; partPtr = partPtr->next, buffPtr+=4)
+          for (Particle* partPtr = head; partPtr != NULL; partPtr = partPtr->next, buffPtr+=4)
              setupBillboard( partPtr, basePoints, camView, ambientColor, buffPtr );
         }
       }
@@ -1758,6 +1996,150 @@ void ParticleEmitter::setupBillboard( Particle *part,
    ++basePts;
 }
 
+//-----------------------------------------------------------------------------
+// Set up SoA particles for billboard style render
+//-----------------------------------------------------------------------------
+
+// Copy the billboard UVs of a particle, animated or not.
+static inline void setBillboardTexCoords( ParticleEmitter::ParticleVertexType *lVerts,
+                                          const ParticleData *data,
+                                          U32 currentAge )
+{
+   if (data->animateTexture && !data->animTexFrames.empty())
+   {
+      S32 fm = (S32)(currentAge*(1.0/1000.0)*data->framesPerSec);
+      U8 fm_tile = data->animTexFrames[fm % data->numFrames];
+      S32 uv0 = fm_tile + fm_tile/data->animTexTiling.x;
+      S32 uv1 = uv0 + (data->animTexTiling.x + 1);
+      lVerts[0].texCoord = data->animTexUVs[uv0];
+      lVerts[1].texCoord = data->animTexUVs[uv1];
+      lVerts[2].texCoord = data->animTexUVs[uv1 + 1];
+      lVerts[3].texCoord = data->animTexUVs[uv0 + 1];
+      return;
+   }
+
+   for (U32 i = 0; i < 4; i++)
+      lVerts[i].texCoord = data->texCoords[i];
+}
+
+void ParticleEmitter::setupBillboardsSoA( const MatrixF &camView,
+                                          const ColorF &ambientColor,
+                                          ParticleVertexType *lVerts )
+{
+   PROFILE_SCOPE(ParticleEmitter_setupBillboardsSoA);
+
+   // The billboard plane is spanned by the camera's right and up axes.
+   Point3F axisU, axisV;
+   camView.getColumn(0, &axisU);
+   camView.getColumn(2, &axisV);
+
+   // mLerp( color, color * ambient, lerp ) is a per channel scale.
+   const F32 ambientLerp = mClampF( mDataBlock->ambientFactor, 0.0f, 1.0f );
+   const ColorF colorScale( 1.0f + ( ambientColor.red - 1.0f ) * ambientLerp,
+                            1.0f + ( ambientColor.green - 1.0f ) * ambientLerp,
+                            1.0f + ( ambientColor.blue - 1.0f ) * ambientLerp,
+                            1.0f + ( ambientColor.alpha - 1.0f ) * ambientLerp );
+
+   // Match the ordering of the particle list: newest first, unless reversed.
+   const U32 count = mSoA.size();
+   const bool reverse = mDataBlock->reverseOrder;
+
+   // With base points (-1,1), (-1,-1), (1,-1) and (1,1) rotated by the spin,
+   // each corner is pos +/- p * U +/- q * V or pos +/- q * U +/- p * V where
+   // p = width * (cos + sin) and q = width * (cos - sin).
+   U32 i = 0;
+
+#if defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )
+
+   const __m128 zero = _mm_setzero_ps();
+   const __m128 half = _mm_set1_ps( 0.5f );
+   const __m128 ux = _mm_set1_ps( axisU.x ), uy = _mm_set1_ps( axisU.y ), uz = _mm_set1_ps( axisU.z );
+   const __m128 vx = _mm_set1_ps( axisV.x ), vy = _mm_set1_ps( axisV.y ), vz = _mm_set1_ps( axisV.z );
+
+   for ( ; i + 4 <= count; i += 4 )
+   {
+      __m128 sinCos[2];
+      F32 *sy = (F32*)&sinCos[0];
+      F32 *cy = (F32*)&sinCos[1];
+      for (U32 l = 0; l < 4; l++)
+         mSinCos( mSoA.spinSpeed[i+l] * mSoA.currentAge[i+l] * AgedSpinToRadians, sy[l], cy[l] );
+
+      const __m128 width = _mm_mul_ps( _mm_loadu_ps( mSoA.partSize + i ), half );
+      const __m128 p = _mm_mul_ps( width, _mm_add_ps( sinCos[1], sinCos[0] ) );
+      const __m128 q = _mm_mul_ps( width, _mm_sub_ps( sinCos[1], sinCos[0] ) );
+      const __m128 np = _mm_sub_ps( zero, p );
+      const __m128 nq = _mm_sub_ps( zero, q );
+
+      const __m128 cornerU[4] = { np, nq, p, q };
+      const __m128 cornerV[4] = { q, np, nq, p };
+
+      const __m128 posX = _mm_loadu_ps( mSoA.posX + i );
+      const __m128 posY = _mm_loadu_ps( mSoA.posY + i );
+      const __m128 posZ = _mm_loadu_ps( mSoA.posZ + i );
+
+      __m128 points[4][3];
+      for (U32 k = 0; k < 4; k++)
+      {
+         points[k][0] = _mm_add_ps( posX, _mm_add_ps( _mm_mul_ps( cornerU[k], ux ), _mm_mul_ps( cornerV[k], vx ) ) );
+         points[k][1] = _mm_add_ps( posY, _mm_add_ps( _mm_mul_ps( cornerU[k], uy ), _mm_mul_ps( cornerV[k], vy ) ) );
+         points[k][2] = _mm_add_ps( posZ, _mm_add_ps( _mm_mul_ps( cornerU[k], uz ), _mm_mul_ps( cornerV[k], vz ) ) );
+      }
+
+      __m128 partCol[4];
+      partCol[0] = _mm_mul_ps( _mm_loadu_ps( mSoA.colorR + i ), _mm_set1_ps( colorScale.red ) );
+      partCol[1] = _mm_mul_ps( _mm_loadu_ps( mSoA.colorG + i ), _mm_set1_ps( colorScale.green ) );
+      partCol[2] = _mm_mul_ps( _mm_loadu_ps( mSoA.colorB + i ), _mm_set1_ps( colorScale.blue ) );
+      partCol[3] = _mm_mul_ps( _mm_loadu_ps( mSoA.colorA + i ), _mm_set1_ps( colorScale.alpha ) );
+
+      const F32 (*pts)[3][4] = (const F32 (*)[3][4])points;
+      const F32 (*cols)[4] = (const F32 (*)[4])partCol;
+
+      for (U32 l = 0; l < 4; l++)
+      {
+         const U32 index = i + l;
+         ParticleVertexType *verts = lVerts + 4 * ( reverse ? index : count - 1 - index );
+         const ColorF color( cols[0][l], cols[1][l], cols[2][l], cols[3][l] );
+
+         for (U32 k = 0; k < 4; k++)
+         {
+            verts[k].point.set( pts[k][0][l], pts[k][1][l], pts[k][2][l] );
+            verts[k].color = color;
+         }
+
+         setBillboardTexCoords( verts, mSoA.dataBlock[index], mSoA.currentAge[index] );
+      }
+   }
+
+#endif
+
+   for ( ; i < count; i++ )
+   {
+      F32 sy, cy;
+      mSinCos( mSoA.spinSpeed[i] * mSoA.currentAge[i] * AgedSpinToRadians, sy, cy );
+
+      const F32 width = mSoA.partSize[i] * 0.5f;
+      const F32 p = width * ( cy + sy );
+      const F32 q = width * ( cy - sy );
+      const F32 cornerU[4] = { -p, -q, p, q };
+      const F32 cornerV[4] = { q, -p, -q, p };
+
+      const Point3F pos( mSoA.posX[i], mSoA.posY[i], mSoA.posZ[i] );
+      const ColorF color( mSoA.colorR[i] * colorScale.red,
+                          mSoA.colorG[i] * colorScale.green,
+                          mSoA.colorB[i] * colorScale.blue,
+                          mSoA.colorA[i] * colorScale.alpha );
+
+      ParticleVertexType *verts = lVerts + 4 * ( reverse ? i : count - 1 - i );
+      for (U32 k = 0; k < 4; k++)
+      {
+         verts[k].point = pos + axisU * cornerU[k] + axisV * cornerV[k];
+         verts[k].color = color;
+      }
+
+      setBillboardTexCoords( verts, mSoA.dataBlock[i], mSoA.currentAge[i] );
+   }
+}
+
 //-----------------------------------------------------------------------------
 // Set up oriented particle
 //-----------------------------------------------------------------------------
@@ -39,6 +39,10 @@
 #include "T3D/fx/particle.h"
 #endif
 
+#ifndef _PARTICLESOA_H_
+#include "T3D/fx/particleSoA.h"
+#endif
+
 #if defined(TORQUE_OS_XENON)
 #include "gfx/D3D9/360/gfx360MemVertexBuffer.h"
 #endif
@@ -141,6 +145,20 @@ class ParticleEmitter : public GameBase
 
    static Point3F mWindVelocity;
    static void setWindVelocity( const Point3F &vel ){ mWindVelocity = vel; }
+
+   /// If set, emitters store their particles in a ParticleSoA and
+   /// update them in batches instead of walking the particle list.
+   static bool smUseSoA;
+
+   /// If set, the deferred updates of SoA emitters are spread over the
+   /// worker threads of the global thread pool.
+   static bool smParallelUpdates;
+
+   static void consoleInit();
+
+   /// Run the particle updates deferred by SoA emitters since the last
+   /// call.  This is done before the first emitter renders.
+   static void updatePending();
    
    ColorF getCollectiveColor();
 
@@ -201,11 +219,11 @@ class ParticleEmitter : public GameBase
    void addParticle(const Point3F &pos, const Point3F &axis, const Point3F &vel, const Point3F &axisx);
 
 
-   inline void setupBillboard( Particle *part,
-                               Point3F *basePts,
-                               const MatrixF &camView,
-                               const ColorF &ambientColor,
-                               ParticleVertexType *lVerts );
+   void setupBillboard( Particle *part,
+                        Point3F *basePts,
+                        const MatrixF &camView,
+                        const ColorF &ambientColor,
+                        ParticleVertexType *lVerts );
 
    inline void setupOriented( Particle *part,
                               const Point3F &camPos,
@@ -216,6 +234,11 @@ class ParticleEmitter : public GameBase
                               const ColorF &ambientColor,
                               ParticleVertexType *lVerts );
 
+   /// Set up all SoA particles as unsorted billboards.
+   void setupBillboardsSoA( const MatrixF &camView,
+                            const ColorF &ambientColor,
+                            ParticleVertexType *lVerts );
+
    /// Updates the bounding box for the particle system
    void updateBBox();
 
@@ -237,6 +260,21 @@ class ParticleEmitter : public GameBase
 
    void update( U32 ms );
    inline void updateKeyData( Particle *part );
+
+   /// Age, integrate and key the SoA particles for the deferred step.
+   void updateSoA();
+
+   /// Run the deferred step of this emitter now if it has one.
+   void flushPendingUpdate();
+
+   /// Take this emitter off the pending list in constant time.  The
+   /// pending step itself is left to the caller.
+   void _removePending();
+
+   static void _updatePendingJob( void *data, U32 begin, U32 end );
+
+   /// Compares the list and SoA paths of update and vertex setup.
+   friend class ParticleSoAFixture;
  
 
   private:
@@ -282,6 +320,31 @@ class ParticleEmitter : public GameBase
    S32        n_parts;
    S32       mCurBuffSize;
 
+   /// @name SoA storage
+   /// Used instead of the particle list if smUseSoA was set when the
+   /// datablock was assigned.
+   /// @{
+
+   bool        mUseSoA;
+   ParticleSoA mSoA;
+
+   /// Milliseconds of the deferred step, zero if none is pending.
+   U32         mPendingUpdateMS;
+
+   /// Number of particles that existed when the step was deferred.
+   U32         mPendingUpdateCount;
+
+   /// Slot of this emitter in smPendingUpdates.
+   U32         mPendingIndex;
+
+   /// Set if particles were emitted while a step was pending.  The
+   /// bounds are updated once the step has moved them.
+   bool        mPendingBBox;
+
+   static Vector<ParticleEmitter*> smPendingUpdates;
+
+   /// @}
+
 };
 
 #endif // _H_PARTICLE_EMITTER
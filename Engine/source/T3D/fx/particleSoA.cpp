@@ -0,0 +1,359 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "T3D/fx/particleSoA.h"
+
+#if defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )
+#include <xmmintrin.h>
+#endif
+
+
+ParticleSoA::ParticleSoA()
+   : mSize( 0 ),
+     mCapacity( 0 ),
+     mMemory( NULL )
+{
+   _setStreams( NULL, 0 );
+}
+
+ParticleSoA::~ParticleSoA()
+{
+   dFree_aligned( mMemory );
+}
+
+void ParticleSoA::_setStreams( U8 *memory, U32 capacity )
+{
+   F32 **floatStreams[ NumFloatStreams ] =
+   {
+      &posX, &posY, &posZ,
+      &velX, &velY, &velZ,
+      &accX, &accY, &accZ,
+      &orientX, &orientY, &orientZ,
+      &colorR, &colorG, &colorB, &colorA,
+      &partSize,
+      &spinSpeed,
+      &dragCoefficient, &windCoefficient, &gravityCoefficient,
+   };
+
+   // Capacity is a multiple of four, so every stream stays 16 byte aligned.
+   for ( U32 i = 0; i < NumFloatStreams; i++ )
+   {
+      *floatStreams[i] = (F32*)memory;
+      memory += capacity * sizeof( F32 );
+   }
+
+   currentAge = (U32*)memory;
+   memory += capacity * sizeof( U32 );
+   totalLifetime = (U32*)memory;
+   memory += capacity * sizeof( U32 );
+   dataBlock = (ParticleData**)memory;
+}
+
+void ParticleSoA::reserve( U32 count )
+{
+   if ( count <= mCapacity )
+      return;
+
+   const U32 capacity = ( count + 3 ) & ~3;
+   const U32 bytesPerParticle = NumFloatStreams * sizeof( F32 ) + 2 * sizeof( U32 ) + sizeof( ParticleData* );
+
+   U8 *memory = (U8*)dMalloc_aligned( capacity * bytesPerParticle, 16 );
+   dMemset( memory, 0, capacity * bytesPerParticle );
+
+   // Copy each stream of the old block over to the new one.
+   if ( mMemory )
+   {
+      const U32 oldCapacity = mCapacity;
+      const U32 streamSizes[] = { sizeof( F32 ), sizeof( U32 ), sizeof( ParticleData* ) };
+      const U32 streamCounts[] = { NumFloatStreams, 2, 1 };
+
+      U8 *src = mMemory;
+      U8 *dst = memory;
+      for ( U32 type = 0; type < 3; type++ )
+      {
+         for ( U32 i = 0; i < streamCounts[type]; i++ )
+         {
+            dMemcpy( dst, src, mSize * streamSizes[type] );
+            src += oldCapacity * streamSizes[type];
+            dst += capacity * streamSizes[type];
+         }
+      }
+
+      dFree_aligned( mMemory );
+   }
+
+   mMemory = memory;
+   mCapacity = capacity;
+   _setStreams( mMemory, mCapacity );
+}
+
+U32 ParticleSoA::add( const Particle &part )
+{
+   if ( mSize == mCapacity )
+      reserve( mCapacity + getMax( mCapacity / 2, (U32)16 ) );
+
+   const U32 i = mSize++;
+
+   posX[i] = part.pos.x;
+   posY[i] = part.pos.y;
+   posZ[i] = part.pos.z;
+   velX[i] = part.vel.x;
+   velY[i] = part.vel.y;
+   velZ[i] = part.vel.z;
+   accX[i] = part.acc.x;
+   accY[i] = part.acc.y;
+   accZ[i] = part.acc.z;
+   orientX[i] = part.orientDir.x;
+   orientY[i] = part.orientDir.y;
+   orientZ[i] = part.orientDir.z;
+   colorR[i] = part.color.red;
+   colorG[i] = part.color.green;
+   colorB[i] = part.color.blue;
+   colorA[i] = part.color.alpha;
+   partSize[i] = part.size;
+   spinSpeed[i] = part.spinSpeed;
+   dragCoefficient[i] = part.dataBlock->dragCoefficient;
+   windCoefficient[i] = part.dataBlock->windCoefficient;
+   gravityCoefficient[i] = part.dataBlock->gravityCoefficient;
+   currentAge[i] = part.currentAge;
+   totalLifetime[i] = getMax( part.totalLifetime, (U32)1 );
+   dataBlock[i] = part.dataBlock;
+
+   return i;
+}
+
+void ParticleSoA::get( U32 i, Particle &part ) const
+{
+   part.pos.set( posX[i], posY[i], posZ[i] );
+   part.vel.set( velX[i], velY[i], velZ[i] );
+   part.acc.set( accX[i], accY[i], accZ[i] );
+   part.orientDir.set( orientX[i], orientY[i], orientZ[i] );
+   part.color.set( colorR[i], colorG[i], colorB[i], colorA[i] );
+   part.size = partSize[i];
+   part.spinSpeed = spinSpeed[i];
+   part.currentAge = currentAge[i];
+   part.totalLifetime = totalLifetime[i];
+   part.dataBlock = dataBlock[i];
+}
+
+void ParticleSoA::_move( U32 dst, U32 src )
+{
+   F32 *floatStreams = posX;
+   for ( U32 s = 0; s < NumFloatStreams; s++, floatStreams += mCapacity )
+      floatStreams[dst] = floatStreams[src];
+
+   currentAge[dst] = currentAge[src];
+   totalLifetime[dst] = totalLifetime[src];
+   dataBlock[dst] = dataBlock[src];
+}
+
+U32 ParticleSoA::age( U32 count, U32 ms )
+{
+   AssertFatal( count <= mSize, "ParticleSoA::age - count out of range" );
+
+   // Stream compaction; survivors keep their order.
+   U32 live = 0;
+   for ( U32 i = 0; i < count; i++ )
+   {
+      currentAge[i] += ms;
+      if ( currentAge[i] > totalLifetime[i] )
+         continue;
+
+      if ( live != i )
+         _move( live, i );
+      live++;
+   }
+
+   if ( live != count )
+   {
+      U32 dst = live;
+      for ( U32 i = count; i < mSize; i++, dst++ )
+         _move( dst, i );
+      mSize = dst;
+   }
+
+   return live;
+}
+
+void ParticleSoA::integrate( U32 begin, U32 end, F32 dt, const Point3F &wind )
+{
+   U32 i = begin;
+
+#if defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )
+
+   const __m128 t = _mm_set1_ps( dt );
+   const __m128 windX = _mm_set1_ps( wind.x );
+   const __m128 windY = _mm_set1_ps( wind.y );
+   const __m128 windZ = _mm_set1_ps( wind.z );
+   const __m128 gravity = _mm_set1_ps( -9.81f );
+
+   for ( ; i + 4 <= end; i += 4 )
+   {
+      const __m128 drag = _mm_loadu_ps( dragCoefficient + i );
+      const __m128 windCoef = _mm_loadu_ps( windCoefficient + i );
+
+      // a = acc - vel * drag - wind * windCoef + gravity * gravityCoef
+      __m128 vx = _mm_loadu_ps( velX + i );
+      __m128 ax = _mm_sub_ps( _mm_loadu_ps( accX + i ), _mm_mul_ps( vx, drag ) );
+      ax = _mm_sub_ps( ax, _mm_mul_ps( windX, windCoef ) );
+      vx = _mm_add_ps( vx, _mm_mul_ps( ax, t ) );
+      _mm_storeu_ps( velX + i, vx );
+      _mm_storeu_ps( posX + i, _mm_add_ps( _mm_loadu_ps( posX + i ), _mm_mul_ps( vx, t ) ) );
+
+      __m128 vy = _mm_loadu_ps( velY + i );
+      __m128 ay = _mm_sub_ps( _mm_loadu_ps( accY + i ), _mm_mul_ps( vy, drag ) );
+      ay = _mm_sub_ps( ay, _mm_mul_ps( windY, windCoef ) );
+      vy = _mm_add_ps( vy, _mm_mul_ps( ay, t ) );
+      _mm_storeu_ps( velY + i, vy );
+      _mm_storeu_ps( posY + i, _mm_add_ps( _mm_loadu_ps( posY + i ), _mm_mul_ps( vy, t ) ) );
+
+      __m128 vz = _mm_loadu_ps( velZ + i );
+      __m128 az = _mm_sub_ps( _mm_loadu_ps( accZ + i ), _mm_mul_ps( vz, drag ) );
+      az = _mm_sub_ps( az, _mm_mul_ps( windZ, windCoef ) );
+      az = _mm_add_ps( az, _mm_mul_ps( gravity, _mm_loadu_ps( gravityCoefficient + i ) ) );
+      vz = _mm_add_ps( vz, _mm_mul_ps( az, t ) );
+      _mm_storeu_ps( velZ + i, vz );
+      _mm_storeu_ps( posZ + i, _mm_add_ps( _mm_loadu_ps( posZ + i ), _mm_mul_ps( vz, t ) ) );
+   }
+
+#endif
+
+   for ( ; i < end; i++ )
+   {
+      const F32 ax = accX[i] - velX[i] * dragCoefficient[i] - wind.x * windCoefficient[i];
+      const F32 ay = accY[i] - velY[i] * dragCoefficient[i] - wind.y * windCoefficient[i];
+      const F32 az = accZ[i] - velZ[i] * dragCoefficient[i] - wind.z * windCoefficient[i] - 9.81f * gravityCoefficient[i];
+
+      velX[i] += ax * dt;
+      velY[i] += ay * dt;
+      velZ[i] += az * dt;
+      posX[i] += velX[i] * dt;
+      posY[i] += velY[i] * dt;
+      posZ[i] += velZ[i] * dt;
+   }
+}
+
+void ParticleSoA::_updateKeysScalar( U32 index, const ColorF *emitterColors, const F32 *emitterSizes )
+{
+   const ParticleData *data = dataBlock[index];
+   const F32 t = F32( currentAge[index] ) / F32( totalLifetime[index] );
+   AssertFatal( t <= 1.0f, "Out out bounds filter function for particle." );
+
+   for ( U32 i = 1; i < ParticleData::PDC_NUM_KEYS; i++ )
+   {
+      if ( data->times[i] >= t )
+      {
+         const F32 firstPart = ( t - data->times[i-1] ) / ( data->times[i] - data->times[i-1] );
+
+         const ColorF *colors = emitterColors ? emitterColors : data->colors;
+         ColorF color;
+         color.interpolate( colors[i-1], colors[i], firstPart );
+         colorR[index] = color.red;
+         colorG[index] = color.green;
+         colorB[index] = color.blue;
+         colorA[index] = color.alpha;
+
+         const F32 *sizes = emitterSizes ? emitterSizes : data->sizes;
+         partSize[index] = ( sizes[i-1] * ( 1.0f - firstPart ) ) + ( sizes[i] * firstPart );
+         break;
+      }
+   }
+}
+
+#if defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )
+
+/// Return a where mask is set, b elsewhere.
+static inline __m128 _select( __m128 mask, __m128 a, __m128 b )
+{
+   return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+}
+
+/// Pick key i-1 and key i for each lane from the segment masks.
+static inline void _selectKeys( __m128 seg1, __m128 seg2, F32 k0, F32 k1, F32 k2, F32 k3, __m128 &from, __m128 &to )
+{
+   from = _select( seg1, _mm_set1_ps( k0 ), _select( seg2, _mm_set1_ps( k1 ), _mm_set1_ps( k2 ) ) );
+   to = _select( seg1, _mm_set1_ps( k1 ), _select( seg2, _mm_set1_ps( k2 ), _mm_set1_ps( k3 ) ) );
+}
+
+#endif
+
+void ParticleSoA::updateKeys( U32 begin, U32 end, const ColorF *emitterColors, const F32 *emitterSizes )
+{
+   U32 i = begin;
+
+#if defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )
+
+   for ( ; i + 4 <= end; i += 4 )
+   {
+      // Groups of particles from different datablocks have different keys.
+      const ParticleData *data = dataBlock[i];
+      if ( dataBlock[i+1] != data || dataBlock[i+2] != data || dataBlock[i+3] != data )
+      {
+         for ( U32 j = i; j < i + 4; j++ )
+            _updateKeysScalar( j, emitterColors, emitterSizes );
+         continue;
+      }
+
+      const F32 *times = data->times;
+      const ColorF *colors = emitterColors ? emitterColors : data->colors;
+      const F32 *sizes = emitterSizes ? emitterSizes : data->sizes;
+
+      const __m128 t = _mm_div_ps(
+         _mm_setr_ps( (F32)currentAge[i], (F32)currentAge[i+1], (F32)currentAge[i+2], (F32)currentAge[i+3] ),
+         _mm_setr_ps( (F32)totalLifetime[i], (F32)totalLifetime[i+1], (F32)totalLifetime[i+2], (F32)totalLifetime[i+3] ) );
+
+      // The first key with times[k] >= t picks the segment.  Lanes past the
+      // last key keep their values.
+      const __m128 le1 = _mm_cmple_ps( t, _mm_set1_ps( times[1] ) );
+      const __m128 le2 = _mm_cmple_ps( t, _mm_set1_ps( times[2] ) );
+      const __m128 le3 = _mm_cmple_ps( t, _mm_set1_ps( times[3] ) );
+      const __m128 seg1 = le1;
+      const __m128 seg2 = _mm_andnot_ps( le1, le2 );
+
+      __m128 t0, t1;
+      _selectKeys( seg1, seg2, times[0], times[1], times[2], times[3], t0, t1 );
+      const __m128 f = _mm_div_ps( _mm_sub_ps( t, t0 ), _mm_sub_ps( t1, t0 ) );
+      const __m128 invF = _mm_sub_ps( _mm_set1_ps( 1.0f ), f );
+
+      #define lerpKey( stream, k0, k1, k2, k3 ) \
+      { \
+         __m128 from, to; \
+         _selectKeys( seg1, seg2, k0, k1, k2, k3, from, to ); \
+         const __m128 value = _mm_add_ps( _mm_mul_ps( from, invF ), _mm_mul_ps( to, f ) ); \
+         _mm_storeu_ps( stream + i, _select( le3, value, _mm_loadu_ps( stream + i ) ) ); \
+      }
+
+      lerpKey( colorR, colors[0].red, colors[1].red, colors[2].red, colors[3].red );
+      lerpKey( colorG, colors[0].green, colors[1].green, colors[2].green, colors[3].green );
+      lerpKey( colorB, colors[0].blue, colors[1].blue, colors[2].blue, colors[3].blue );
+      lerpKey( colorA, colors[0].alpha, colors[1].alpha, colors[2].alpha, colors[3].alpha );
+      lerpKey( partSize, sizes[0], sizes[1], sizes[2], sizes[3] );
+
+      #undef lerpKey
+   }
+
+#endif
+
+   for ( ; i < end; i++ )
+      _updateKeysScalar( i, emitterColors, emitterSizes );
+}
@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _PARTICLESOA_H_
+#define _PARTICLESOA_H_
+
+#ifndef _PARTICLE_H_
+#include "T3D/fx/particle.h"
+#endif
+
+
+/// Structure-of-arrays particle storage used by ParticleEmitter when
+/// ParticleEmitter::smUseSoA is set.
+///
+/// Every particle attribute lives in its own 16 byte aligned stream so the
+/// update kernels can work on four particles at a time.  Live particles are
+/// packed into [0, size()) from oldest to newest.
+class ParticleSoA
+{
+public:
+
+   ParticleSoA();
+   ~ParticleSoA();
+
+   U32 size() const { return mSize; }
+   U32 capacity() const { return mCapacity; }
+
+   /// Make room for at least count particles, keeping the current ones.
+   void reserve( U32 count );
+
+   void clear() { mSize = 0; }
+
+   /// Drop the newest particle.
+   void removeLast() { mSize--; }
+
+   /// Append a particle and return its index.
+   U32 add( const Particle &part );
+
+   /// Copy a particle out.  The next pointer is left alone.
+   void get( U32 index, Particle &part ) const;
+
+   /// Add ms to the age of the particles in [0, count) and remove the ones
+   /// that outlived their lifetime, keeping the order of the rest.  Particles
+   /// in [count, size()) are not aged but are moved down as well.
+   /// @return The number of particles left in the aged range.
+   U32 age( U32 count, U32 ms );
+
+   /// Apply acceleration, drag, wind and gravity to the particles in
+   /// [begin, end) over dt seconds.
+   void integrate( U32 begin, U32 end, F32 dt, const Point3F &wind );
+
+   /// Interpolate the color and size keys of the particles in [begin, end)
+   /// from their age.  If emitterColors or emitterSizes are set, they are
+   /// used instead of the keys of the particle's datablock.
+   void updateKeys( U32 begin, U32 end, const ColorF *emitterColors, const F32 *emitterSizes );
+
+   /// @name Streams
+   /// @{
+
+   F32 *posX, *posY, *posZ;
+   F32 *velX, *velY, *velZ;
+   F32 *accX, *accY, *accZ;
+   F32 *orientX, *orientY, *orientZ;
+   F32 *colorR, *colorG, *colorB, *colorA;
+   F32 *partSize;
+   F32 *spinSpeed;
+
+   /// Coefficients copied from the datablock when the particle is added.
+   F32 *dragCoefficient, *windCoefficient, *gravityCoefficient;
+
+   U32 *currentAge;
+   U32 *totalLifetime;
+   ParticleData **dataBlock;
+
+   /// @}
+
+protected:
+
+   enum
+   {
+      NumFloatStreams = 21,
+   };
+
+   U32 mSize;
+   U32 mCapacity;
+
+   /// Single allocation holding all the streams.
+   U8 *mMemory;
+
+   void _setStreams( U8 *memory, U32 capacity );
+
+   /// Copy particle src over particle dst.
+   void _move( U32 dst, U32 src );
+
+   void _updateKeysScalar( U32 index, const ColorF *emitterColors, const F32 *emitterSizes );
+};
+
+#endif // _PARTICLESOA_H_
@@ -447,9 +447,13 @@ void Splash::processTick(const Move*)
       if( mCurrMS >= mEndingMS )
       {
          mDead = true;
-         if( mCurrMS >= (mEndingMS + mDataBlock->ringLifetime * 1000) )
+
+         // Delete through the event queue, which is safe from a worker
+         // thread.  Only post the event on the tick the time runs out.
+         const F32 deleteMS = mEndingMS + mDataBlock->ringLifetime * 1000;
+         if( mCurrMS >= deleteMS && mCurrMS - TickMs < deleteMS )
          {
-            deleteObject();
+            safeDeleteObject();
          }
       }
    }
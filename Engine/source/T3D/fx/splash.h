@@ -169,6 +169,11 @@ protected:
    bool        onAdd();
    void        onRemove();
    void        processTick(const Move *move);
+
+   /// The tick only advances the splash's own timer, so splashes can be
+   /// ticked on the worker threads.
+   bool        isTickThreadSafe() const { return true; }
+
    void        advanceTime(F32 dt);
    void        updateEmitters( F32 dt );
    void        updateWave( F32 dt );
@@ -184,6 +189,9 @@ public:
    ~Splash();
    void setInitialState(const Point3F& point, const Point3F& normal, const F32 fade = 1.0);
 
+   /// Returns true once the splash has run its course.
+   bool isDead() const { return mDead; }
+
    U32  packUpdate  (NetConnection *conn, U32 mask, BitStream* stream);
    void unpackUpdate(NetConnection *conn,           BitStream* stream);
 
@@ -0,0 +1,339 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "T3D/fx/particleEmitter.h"
+#include "T3D/fx/particleSoA.h"
+#include "math/mRandom.h"
+
+FIXTURE(ParticleSoA)
+{
+public:
+   enum
+   {
+      // Not a multiple of four so the scalar tail runs as well.
+      NumParticles = 37,
+   };
+
+   typedef ParticleEmitter::ParticleVertexType VertexType;
+
+   ParticleData mData[2];
+   ParticleEmitterData mEmitterData;
+   Particle mParticles[ NumParticles ];
+   ParticleSoA mSoA;
+   MRandomLCG mRand;
+   Point3F mWindVelocity;
+
+   /// Emitters holding the same particles in a list and in SoA streams.
+   ParticleEmitter *mListEmitter;
+   ParticleEmitter *mSoAEmitter;
+   Particle mListParticles[ NumParticles ];
+
+   virtual void SetUp()
+   {
+      mRand.setSeed( 1234 );
+
+      for ( U32 d = 0; d < 2; d++ )
+      {
+         mData[d].dragCoefficient = 0.5f + d;
+         mData[d].windCoefficient = 0.25f * d;
+         mData[d].gravityCoefficient = 1.0f - 0.5f * d;
+
+         for ( U32 k = 0; k < ParticleData::PDC_NUM_KEYS; k++ )
+         {
+            mData[d].colors[k].set( mRand.randF(), mRand.randF(), mRand.randF(), mRand.randF() );
+            mData[d].sizes[k] = mRand.randF( 0.1f, 4.0f );
+            mData[d].texCoords[k] += Point2F( 0.5f * d, 0.25f * d );
+         }
+         mData[d].times[1] = 0.2f + 0.3f * d;
+         mData[d].times[2] = 0.7f;
+      }
+
+      for ( U32 i = 0; i < NumParticles; i++ )
+      {
+         Particle &part = mParticles[i];
+         part.pos.set( mRand.randF( -10.0f, 10.0f ), mRand.randF( -10.0f, 10.0f ), mRand.randF( 0.0f, 10.0f ) );
+         part.vel.set( mRand.randF( -5.0f, 5.0f ), mRand.randF( -5.0f, 5.0f ), mRand.randF( -5.0f, 5.0f ) );
+         part.acc.set( mRand.randF( -1.0f, 1.0f ), mRand.randF( -1.0f, 1.0f ), mRand.randF( -1.0f, 1.0f ) );
+         part.orientDir.set( 0.0f, 0.0f, 1.0f );
+         part.totalLifetime = 1000 + mRand.randI( 0, 1000 );
+         part.currentAge = mRand.randI( 0, part.totalLifetime );
+         part.color.set( 1.0f, 1.0f, 1.0f, 1.0f );
+         part.size = 1.0f;
+         part.spinSpeed = mRand.randF( -0.5f, 0.5f );
+         part.next = NULL;
+
+         // Runs of eight share a datablock, with some groups of four mixed.
+         part.dataBlock = &mData[ ( i / 8 + ( i % 11 == 5 ) ) % 2 ];
+
+         mSoA.add( part );
+      }
+
+      mEmitterData.ambientFactor = 0.5f;
+
+      mWindVelocity = ParticleEmitter::mWindVelocity;
+      ParticleEmitter::setWindVelocity( Point3F( 2.0f, -1.0f, 0.5f ) );
+
+      mListEmitter = createEmitter( false );
+      mSoAEmitter = createEmitter( true );
+   }
+
+   virtual void TearDown()
+   {
+      delete mListEmitter;
+      delete mSoAEmitter;
+
+      ParticleEmitter::setWindVelocity( mWindVelocity );
+   }
+
+   /// An unregistered emitter holding mParticles.
+   ParticleEmitter *createEmitter( bool useSoA )
+   {
+      ParticleEmitter *emitter = new ParticleEmitter;
+      emitter->mDataBlock = &mEmitterData;
+      emitter->mUseSoA = useSoA;
+      emitter->n_parts = NumParticles;
+      emitter->n_part_capacity = NumParticles;
+
+      // Like addParticle(), the list is newest first and the SoA streams
+      // oldest first.
+      if ( useSoA )
+      {
+         for ( S32 i = NumParticles - 1; i >= 0; i-- )
+            emitter->mSoA.add( mParticles[i] );
+      }
+      else
+      {
+         for ( U32 i = 0; i < NumParticles; i++ )
+         {
+            mListParticles[i] = mParticles[i];
+            mListParticles[i].next = i + 1 < NumParticles ? &mListParticles[ i + 1 ] : NULL;
+         }
+         emitter->part_list_head.next = mListParticles;
+      }
+
+      return emitter;
+   }
+
+   /// Step both emitters, running the deferred SoA update straight away.
+   void advanceEmitters( F32 dt )
+   {
+      mListEmitter->advanceTime( dt );
+      mSoAEmitter->advanceTime( dt );
+      mSoAEmitter->flushPendingUpdate();
+   }
+
+   static void expectParticleNear( const Particle &expected, const Particle &part, F32 tolerance, U32 i )
+   {
+      EXPECT_EQ( expected.currentAge, part.currentAge ) << "particle " << i;
+      EXPECT_NEAR( expected.pos.x, part.pos.x, tolerance ) << "particle " << i;
+      EXPECT_NEAR( expected.pos.y, part.pos.y, tolerance ) << "particle " << i;
+      EXPECT_NEAR( expected.pos.z, part.pos.z, tolerance ) << "particle " << i;
+      EXPECT_NEAR( expected.vel.x, part.vel.x, tolerance ) << "particle " << i;
+      EXPECT_NEAR( expected.vel.y, part.vel.y, tolerance ) << "particle " << i;
+      EXPECT_NEAR( expected.vel.z, part.vel.z, tolerance ) << "particle " << i;
+      EXPECT_NEAR( expected.color.red, part.color.red, tolerance ) << "particle " << i;
+      EXPECT_NEAR( expected.color.green, part.color.green, tolerance ) << "particle " << i;
+      EXPECT_NEAR( expected.color.blue, part.color.blue, tolerance ) << "particle " << i;
+      EXPECT_NEAR( expected.color.alpha, part.color.alpha, tolerance ) << "particle " << i;
+      EXPECT_NEAR( expected.size, part.size, tolerance ) << "particle " << i;
+   }
+
+   void expectMatchesList( const ParticleSoA &soa, F32 tolerance )
+   {
+      for ( U32 i = 0; i < NumParticles; i++ )
+      {
+         Particle part;
+         soa.get( i, part );
+         expectParticleNear( mParticles[i], part, tolerance, i );
+      }
+   }
+
+   /// The SoA emitter must hold the particles of the list emitter, in
+   /// reverse order.
+   void expectEmittersMatch( F32 tolerance )
+   {
+      ASSERT_EQ( mListEmitter->n_parts, mSoAEmitter->n_parts );
+      ASSERT_EQ( (U32)mListEmitter->n_parts, mSoAEmitter->mSoA.size() );
+
+      U32 index = mSoAEmitter->mSoA.size();
+      for ( Particle *expected = mListEmitter->part_list_head.next; expected != NULL; expected = expected->next )
+      {
+         Particle part;
+         mSoAEmitter->mSoA.get( --index, part );
+         expectParticleNear( *expected, part, tolerance, index );
+      }
+      EXPECT_EQ( 0U, index );
+   }
+
+   U32 getParticleCount() const { return mListEmitter->n_parts; }
+
+   /// Set up billboards for both emitters and compare the vertices.
+   void expectBillboardsMatch( const MatrixF &camView, const ColorF &ambientColor )
+   {
+      const U32 count = mListEmitter->n_parts;
+      Vector<VertexType> listVerts, soaVerts;
+      listVerts.setSize( 4 * count );
+      soaVerts.setSize( 4 * count );
+
+      // The corners and walk of unsorted billboards in copyToVB().
+      Point3F basePoints[4];
+      basePoints[0] = Point3F(-1.0, 0.0,  1.0);
+      basePoints[1] = Point3F(-1.0, 0.0, -1.0);
+      basePoints[2] = Point3F( 1.0, 0.0, -1.0);
+      basePoints[3] = Point3F( 1.0, 0.0,  1.0);
+
+      VertexType *buffPtr = listVerts.address();
+      S32 step = 4;
+      if ( mEmitterData.reverseOrder )
+      {
+         buffPtr += 4 * ( count - 1 );
+         step = -4;
+      }
+      for ( Particle *part = mListEmitter->part_list_head.next; part != NULL; part = part->next, buffPtr += step )
+         mListEmitter->setupBillboard( part, basePoints, camView, ambientColor, buffPtr );
+
+      mSoAEmitter->setupBillboardsSoA( camView, ambientColor, soaVerts.address() );
+
+      for ( U32 i = 0; i < 4 * count; i++ )
+      {
+         const VertexType &expected = listVerts[i];
+         const VertexType &vert = soaVerts[i];
+         EXPECT_NEAR( expected.point.x, vert.point.x, 1e-4f ) << "vertex " << i;
+         EXPECT_NEAR( expected.point.y, vert.point.y, 1e-4f ) << "vertex " << i;
+         EXPECT_NEAR( expected.point.z, vert.point.z, 1e-4f ) << "vertex " << i;
+         EXPECT_EQ( expected.texCoord, vert.texCoord ) << "vertex " << i;
+
+         // Rounding to bytes may differ by one.
+         ColorI expectedColor, color;
+         expected.color.getColor( &expectedColor );
+         vert.color.getColor( &color );
+         EXPECT_NEAR( expectedColor.red, color.red, 1 ) << "vertex " << i;
+         EXPECT_NEAR( expectedColor.green, color.green, 1 ) << "vertex " << i;
+         EXPECT_NEAR( expectedColor.blue, color.blue, 1 ) << "vertex " << i;
+         EXPECT_NEAR( expectedColor.alpha, color.alpha, 1 ) << "vertex " << i;
+      }
+   }
+};
+
+TEST_FIX(ParticleSoA, UpdateMatchesList)
+{
+   // Enough steps for some particles to die.
+   for ( U32 step = 0; step < 10; step++ )
+   {
+      advanceEmitters( 0.032f );
+      expectEmittersMatch( 1e-4f );
+   }
+
+   EXPECT_LT( getParticleCount(), (U32)NumParticles );
+}
+
+TEST_FIX(ParticleSoA, UpdateWithEmitterKeysMatchesList)
+{
+   ColorF colors[ ParticleData::PDC_NUM_KEYS ];
+   F32 sizes[ ParticleData::PDC_NUM_KEYS ];
+   for ( U32 k = 0; k < ParticleData::PDC_NUM_KEYS; k++ )
+   {
+      colors[k].set( mRand.randF(), mRand.randF(), mRand.randF(), mRand.randF() );
+      sizes[k] = mRand.randF( 0.1f, 4.0f );
+   }
+
+   mEmitterData.useEmitterColors = true;
+   mEmitterData.useEmitterSizes = true;
+   mListEmitter->setColors( colors );
+   mListEmitter->setSizes( sizes );
+   mSoAEmitter->setColors( colors );
+   mSoAEmitter->setSizes( sizes );
+
+   for ( U32 step = 0; step < 3; step++ )
+   {
+      advanceEmitters( 0.016f );
+      expectEmittersMatch( 1e-4f );
+   }
+}
+
+TEST_FIX(ParticleSoA, BillboardsMatchList)
+{
+   advanceEmitters( 0.032f );
+
+   MatrixF camView( EulerF( 0.3f, -0.2f, 1.1f ), Point3F( 0.0f, 0.0f, 0.0f ) );
+   camView.transpose();
+   const ColorF ambientColor( 0.2f, 0.4f, 0.6f, 0.8f );
+
+   expectBillboardsMatch( camView, ambientColor );
+
+   mEmitterData.reverseOrder = true;
+   expectBillboardsMatch( camView, ambientColor );
+}
+
+TEST_FIX(ParticleSoA, VectorMatchesScalar)
+{
+   // Single particle ranges never take the four wide path.
+   ParticleSoA scalar;
+   for ( U32 i = 0; i < NumParticles; i++ )
+      scalar.add( mParticles[i] );
+
+   const Point3F wind( -1.0f, 3.0f, 0.0f );
+   mSoA.integrate( 0, NumParticles, 0.016f, wind );
+   mSoA.updateKeys( 0, NumParticles, NULL, NULL );
+   for ( U32 i = 0; i < NumParticles; i++ )
+   {
+      scalar.integrate( i, i + 1, 0.016f, wind );
+      scalar.updateKeys( i, i + 1, NULL, NULL );
+   }
+
+   for ( U32 i = 0; i < NumParticles; i++ )
+      scalar.get( i, mParticles[i] );
+
+   expectMatchesList( mSoA, 1e-6f );
+}
+
+TEST_FIX(ParticleSoA, AgeKeepsOrder)
+{
+   const U32 ms = 400;
+   U32 expected = 0;
+   for ( U32 i = 0; i < NumParticles; i++ )
+   {
+      if ( mParticles[i].currentAge + ms <= mParticles[i].totalLifetime )
+      {
+         mParticles[ expected ] = mParticles[i];
+         mParticles[ expected ].currentAge += ms;
+         expected++;
+      }
+   }
+
+   EXPECT_EQ( expected, mSoA.age( NumParticles, ms ) );
+   ASSERT_EQ( expected, mSoA.size() );
+
+   for ( U32 i = 0; i < expected; i++ )
+   {
+      Particle part;
+      mSoA.get( i, part );
+      EXPECT_EQ( mParticles[i].currentAge, part.currentAge );
+      EXPECT_EQ( mParticles[i].pos, part.pos );
+   }
+}
+
+#endif
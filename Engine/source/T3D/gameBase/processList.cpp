@@ -25,7 +25,9 @@
 
 #include "T3D/gameBase/gameBase.h"
 #include "platform/profiler.h"
+#include "platform/threads/threadPool.h"
 #include "console/consoleTypes.h"
+#include "core/module.h"
 
 #ifdef TORQUE_EXPERIMENTAL_EC
 #include "T3D/components/coreInterfaces.h"
@@ -36,6 +38,7 @@
 ProcessObject::ProcessObject()
  : mProcessTag( 0 ),   
    mOrderGUID( 0 ),
+   mTickGroup( 0 ),
    mProcessTick( false ),
    mIsGameBase( false )
 { 
@@ -109,6 +112,21 @@ void ProcessObject::plJoin(ProcessObject * head)
 
 //--------------------------------------------------------------------------
 
+bool ProcessList::smParallelTicks = true;
+U32 ProcessList::smMinParallelGroups = 8;
+
+AFTER_MODULE_INIT( Sim )
+{
+   Con::addVariable( "$ProcessList::parallelTicks", TypeBool, &ProcessList::smParallelTicks,
+      "@brief If true, consecutive objects that are tick thread safe are ticked on the worker threads.\n"
+      "@ingroup GameObjects" );
+
+   Con::addVariable( "$ProcessList::minParallelGroups", TypeS32, &ProcessList::smMinParallelGroups,
+      "@brief The least number of independent thread safe objects or processAfter chains "
+      "in a run for which ticking is spread across the worker threads.\n"
+      "@ingroup GameObjects" );
+}
+
 ProcessList::ProcessList()
 {
    mCurrentTag = 0;
@@ -125,70 +143,73 @@ void ProcessList::addObject( ProcessObject *obj )
    obj->plLinkAfter(&mHead);
 }
 
-//----------------------------------------------------------------------------
-
-void ProcessList::orderList()
+U32 ProcessList::nextTag()
 {
    // ProcessObject tags are initialized to 0, so current tag should never be 0.
    if (++mCurrentTag == 0)
       mCurrentTag++;
+   return mCurrentTag;
+}
 
-   // Install a temporary head node
-   ProcessObject list;
-   list.plLinkBefore(mHead.mProcessLink.next);
-   mHead.plUnlink();
+//----------------------------------------------------------------------------
 
-   // start out by (bubble) sorting list by GUID
-   for (ProcessObject * cur = list.mProcessLink.next; cur != &list; cur = cur->mProcessLink.next)
+static S32 QSORT_CALLBACK compareProcessOrder( const void *a, const void *b )
+{
+   const ProcessObject *objA = *(const ProcessObject**)a;
+   const ProcessObject *objB = *(const ProcessObject**)b;
+
+   if ( objA->mOrderGUID != objB->mOrderGUID )
+      return objA->mOrderGUID < objB->mOrderGUID ? -1 : 1;
+
+   // Keep the list order for equal GUIDs.  The tags hold list positions here.
+   return S32( objA->mProcessTag ) - S32( objB->mProcessTag );
+}
+
+void ProcessList::orderList()
+{
+   PROFILE_SCOPE( ProcessList_OrderList );
+
+   // Gather the list, tagging each object with its position so the
+   // sort by GUID is stable.
+   mSortList.clear();
+   for (ProcessObject * pobj = mHead.mProcessLink.next; pobj != &mHead; pobj = pobj->mProcessLink.next)
    {
-      if (cur->mOrderGUID == 0)
-         // special case -- can be no lower, so accept as lowest (this is also
-         // a common value since it is what non ordered objects have)
-         continue;
+      pobj->mProcessTag = mSortList.size();
+      mSortList.push_back(pobj);
+   }
 
-      for (ProcessObject * walk = cur->mProcessLink.next; walk != &list; walk = walk->mProcessLink.next)
-      {
-         if (walk->mOrderGUID < cur->mOrderGUID)
-         {
-            // swap walk and cur -- need to be careful because walk might be just after cur
-            // so insert after item before cur and before item after walk
-            ProcessObject * before = cur->mProcessLink.prev;
-            ProcessObject * after = walk->mProcessLink.next;
-            cur->plUnlink();
-            walk->plUnlink();
-            cur->plLinkBefore(after);
-            walk->plLinkAfter(before);
-            ProcessObject * swap = walk;
-            walk = cur;
-            cur = swap;
-         }
-      }
+   dQsort(mSortList.address(), mSortList.size(), sizeof(ProcessObject*), compareProcessOrder);
+
+   const U32 memberTag = nextTag();
+   const U32 placedTag = nextTag();
+   for (U32 i = 0; i < mSortList.size(); i++)
+   {
+      mSortList[i]->mProcessTag = memberTag;
+      mSortList[i]->plUnlink();
    }
 
-   // Reverse topological sort into the original head node
-   while (list.mProcessLink.next != &list) 
+   // Topological sort back into the head node.  Each object is placed after
+   // the chain of objects it processes after, so every object and link is
+   // visited once.
+   Vector<ProcessObject*> chain;
+   for (U32 i = 0; i < mSortList.size(); i++)
    {
-      ProcessObject * ptr = list.mProcessLink.next;
-      ProcessObject * afterObject = ptr->getAfterObject();
-      ptr->mProcessTag = mCurrentTag;
-      ptr->plUnlink();
-      if (afterObject) 
+      ProcessObject * ptr = mSortList[i];
+      while (ptr && ptr->mProcessTag == memberTag)
       {
-         // Build chain "stack" of dependent objects and patch
-         // it to the end of the current list.
-         while (afterObject && afterObject->mProcessTag != mCurrentTag)
-         {
-            afterObject->mProcessTag = mCurrentTag;
-            afterObject->plUnlink();
-            afterObject->plLinkBefore(ptr);
-            ptr = afterObject;
-            afterObject = ptr->getAfterObject();
-         }
-         ptr->plJoin(&mHead);
+         ptr->mProcessTag = placedTag;
+         chain.push_back(ptr);
+         ptr = ptr->getAfterObject();
+      }
+
+      while (chain.size())
+      {
+         chain.last()->plLinkBefore(&mHead);
+         chain.pop_back();
       }
-      else
-         ptr->plLinkBefore(&mHead);
    }
+
+   mSortList.clear();
    mDirty = false;
 }
 
@@ -255,6 +276,99 @@ bool ProcessList::advanceTime(SimTime timeDelta)
 
 //----------------------------------------------------------------------------
 
+void ProcessList::tickThreadSafeRun( const Vector<ProcessObject*> &run )
+{
+   PROFILE_SCOPE( ProcessList_TickThreadSafeRun );
+
+   static const U32 InvalidGroup = U32(-1);
+
+   // Split the run into processAfter() chains.  orderList() puts every
+   // object after the object it processes after, so a chain member is
+   // always grouped before its dependents.
+   const U32 runTag = nextTag();
+   for (U32 i = 0; i < run.size(); i++)
+   {
+      run[i]->mProcessTag = runTag;
+      run[i]->mTickGroup = InvalidGroup;
+   }
+
+   mTickGroups.clear();
+   for (U32 i = 0; i < run.size(); i++)
+   {
+      ProcessObject * pobj = run[i];
+      ProcessObject * afterObject = pobj->getAfterObject();
+
+      if (afterObject && afterObject->mProcessTag == runTag)
+      {
+         // The list is out of order, so tick the run as it is.
+         if (afterObject->mTickGroup == InvalidGroup)
+         {
+            for (U32 j = 0; j < run.size(); j++)
+               onTickObject(run[j]);
+            return;
+         }
+
+         pobj->mTickGroup = afterObject->mTickGroup;
+      }
+      else
+      {
+         pobj->mTickGroup = mTickGroups.size();
+         mTickGroups.increment();
+         mTickGroups.last().start = 0;
+         mTickGroups.last().count = 0;
+      }
+
+      mTickGroups[pobj->mTickGroup].count++;
+   }
+
+   if (mTickGroups.size() < getMax(smMinParallelGroups, 2U))
+   {
+      for (U32 i = 0; i < run.size(); i++)
+         onTickObject(run[i]);
+      return;
+   }
+
+   // Lay the chains out contiguously, keeping list order within each.
+   U32 numTickObjects = 0;
+   for (U32 i = 0; i < mTickGroups.size(); i++)
+   {
+      mTickGroups[i].start = numTickObjects;
+      numTickObjects += mTickGroups[i].count;
+      mTickGroups[i].count = 0;
+   }
+
+   mTickObjects.setSize(numTickObjects);
+   for (U32 i = 0; i < run.size(); i++)
+   {
+      TickGroup &group = mTickGroups[run[i]->mTickGroup];
+      mTickObjects[group.start + group.count++] = run[i];
+   }
+
+   ThreadPool::GLOBAL().parallelFor( 0, mTickGroups.size(), 16, &_tickGroupsJob, this );
+}
+
+void ProcessList::_tickGroupsJob( void *data, U32 begin, U32 end )
+{
+   ProcessList *list = reinterpret_cast< ProcessList* >( data );
+
+   // Tick with the same math state as the main thread.  The objects do
+   // not affect each other, so the results don't depend on which thread
+   // ticks which chain.
+   U32 mathState = Platform::getMathControlState();
+   Platform::setMathControlStateKnown();
+
+   for (U32 i = begin; i < end; i++)
+   {
+      const TickGroup &group = list->mTickGroups[i];
+      for (U32 j = 0; j < group.count; j++)
+         list->onTickObject( list->mTickObjects[group.start + j] );
+   }
+
+   Platform::setMathControlState(mathState);
+}
+
+//----------------------------------------------------------------------------
+
 void ProcessList::advanceObjects()
 {
    PROFILE_START(ProcessList_AdvanceObjects);
@@ -266,6 +380,23 @@ void ProcessList::advanceObjects()
    mHead.plUnlink();
    for (ProcessObject * pobj = list.mProcessLink.next; pobj != &list; pobj = list.mProcessLink.next)
    {
+      // Tick runs of consecutive thread safe objects together.  Nothing
+      // else ticks while the run is gathered, so no object in it can be
+      // deleted before it ticks.
+      if ( smParallelTicks && pobj->isTickThreadSafe() )
+      {
+         mTickRun.clear();
+         for (; pobj != &list && pobj->isTickThreadSafe(); pobj = list.mProcessLink.next)
+         {
+            pobj->plUnlink();
+            pobj->plLinkBefore(&mHead);
+            mTickRun.push_back(pobj);
+         }
+
+         tickThreadSafeRun(mTickRun);
+         continue;
+      }
+
       pobj->plUnlink();
       pobj->plLinkBefore(&mHead);
       
@@ -283,6 +414,3 @@ void ProcessList::advanceObjects()
 
    PROFILE_END();
 }
-
-
-
@@ -29,6 +29,9 @@
 #ifndef _TSIGNAL_H_
 #include "core/util/tSignal.h"
 #endif
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
 
 //----------------------------------------------------------------------------
 
@@ -88,6 +91,16 @@ public:
    /// @see processAfter
    virtual ProcessObject* getAfterObject() const { return NULL; }
 
+   /// Returns true if processTick() may run on a worker thread.
+   ///
+   /// Consecutive thread safe objects in the process list are ticked in
+   /// parallel with each other, except for objects in the same processAfter()
+   /// chain.  They still tick after all objects before them in the list and
+   /// before all objects after them.  Their tick must not touch state shared
+   /// with other objects (script, the scene container, other objects' fields)
+   /// and must use safeDeleteObject() rather than deleting objects directly.
+   virtual bool isTickThreadSafe() const { return false; }
+
    /// Processes a move event and updates object state once every 32 milliseconds.
    ///
    /// This takes place both on the client and server, every 32 milliseconds (1 tick).
@@ -126,6 +139,7 @@ public:
 
    U32 mProcessTag;                       // Tag used during sort
    U32 mOrderGUID;                        // UID for keeping order synced (e.g., across network or runs of sim)
+   U32 mTickGroup;                        // processAfter() chain this object ticks with when ticked in parallel
    Link mProcessLink;                     // Ordered process queue
 
    bool mProcessTick;
@@ -158,6 +172,14 @@ public:
 
    PreTickSignal& preTickSignal() { return mPreTick; }
    PostTickSignal& postTickSignal() { return mPostTick; }
+
+   /// If false, all objects are ticked on the main thread.
+   static bool smParallelTicks;
+
+   /// The least number of thread safe processAfter() chains in a run of
+   /// consecutive thread safe objects for which ticking is spread across
+   /// the worker threads.
+   static U32 smMinParallelGroups;
    
    virtual void addObject( ProcessObject *obj );
    
@@ -174,6 +196,23 @@ protected:
    virtual void onPreTickObject( ProcessObject* ) {}
    virtual void onTickObject( ProcessObject* ) {}   
 
+   /// A processAfter() chain of objects that must tick in order.
+   struct TickGroup
+   {
+      U32 start;        ///< First object in mTickObjects.
+      U32 count;        ///< Number of objects in the chain.
+   };
+
+   /// Returns a fresh value for ProcessObject::mProcessTag.
+   U32 nextTag();
+
+   /// Ticks a run of consecutive thread safe objects, spreading their
+   /// processAfter() chains across the worker threads.
+   void tickThreadSafeRun( const Vector<ProcessObject*> &run );
+
+   /// Ticks the chains in the given range of mTickGroups.
+   static void _tickGroupsJob( void *data, U32 begin, U32 end );
+
 protected:
 
    ProcessObject mHead;
@@ -181,6 +220,13 @@ protected:
    U32 mCurrentTag;
    bool mDirty;
 
+   /// The current run of thread safe objects, and its chains and
+   /// their objects in list order.
+   Vector<ProcessObject*> mTickRun;
+   Vector<TickGroup> mTickGroups;
+   Vector<ProcessObject*> mTickObjects;
+   Vector<ProcessObject*> mSortList;
+
    U32 mTotalTicks;
    SimTime mLastTick;
    SimTime mLastTime;
@@ -0,0 +1,255 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "T3D/gameBase/processList.h"
+#include "T3D/fx/splash.h"
+#include "platform/platformIntrinsics.h"
+
+FIXTURE(ProcessList)
+{
+public:
+   /// Records the order objects are ticked in.
+   static volatile U32 smTickCounter;
+
+   class TestObject : public ProcessObject
+   {
+   public:
+      bool mThreadSafe;
+      ProcessObject* mAfter;
+      U32 mTickOrder;
+      U32 mTickCount;
+
+      TestObject() : mThreadSafe(false), mAfter(NULL), mTickOrder(0), mTickCount(0) {}
+
+      virtual ProcessObject* getAfterObject() const { return mAfter; }
+      virtual bool isTickThreadSafe() const { return mThreadSafe; }
+
+      virtual void processTick(const Move*)
+      {
+         U32 order;
+         do
+         {
+            order = dAtomicRead(smTickCounter);
+         } while (!dCompareAndSwap(smTickCounter, order, order + 1));
+
+         mTickOrder = order;
+         mTickCount++;
+      }
+   };
+
+   class TestProcessList : public ProcessList
+   {
+   protected:
+      virtual void onTickObject(ProcessObject* pobj) { pobj->processTick(NULL); }
+   };
+
+   TestProcessList mList;
+   Vector<TestObject*> mObjects;
+   bool mSavedParallelTicks;
+   U32 mSavedMinParallelGroups;
+
+   virtual void SetUp()
+   {
+      mSavedParallelTicks = ProcessList::smParallelTicks;
+      mSavedMinParallelGroups = ProcessList::smMinParallelGroups;
+      smTickCounter = 0;
+
+      // Mostly thread safe objects with a few serial ones and some short
+      // processAfter() chains.
+      for (U32 i = 0; i < 400; i++)
+      {
+         TestObject* obj = new TestObject();
+         obj->mOrderGUID = i;
+         obj->mThreadSafe = (i % 50) != 7;
+         if (i % 5 == 3)
+            obj->mAfter = mObjects.last();
+
+         mObjects.push_back(obj);
+         mList.addObject(obj);
+      }
+      mList.markDirty();
+   }
+
+   virtual void TearDown()
+   {
+      for (U32 i = 0; i < mObjects.size(); i++)
+         delete mObjects[i];
+      mObjects.clear();
+
+      ProcessList::smParallelTicks = mSavedParallelTicks;
+      ProcessList::smMinParallelGroups = mSavedMinParallelGroups;
+   }
+
+   void tick()
+   {
+      smTickCounter = 0;
+      mList.advanceTime(TickMs);
+   }
+};
+
+volatile U32 ProcessListFixture::smTickCounter = 0;
+
+TEST_FIX(ProcessList, SerialTicksInListOrder)
+{
+   ProcessList::smParallelTicks = false;
+   tick();
+
+   for (U32 i = 0; i < mObjects.size(); i++)
+   {
+      EXPECT_EQ(1, mObjects[i]->mTickCount);
+      EXPECT_EQ(i, mObjects[i]->mTickOrder);
+   }
+}
+
+TEST_FIX(ProcessList, ParallelTicksKeepOrderConstraints)
+{
+   ProcessList::smParallelTicks = true;
+   ProcessList::smMinParallelGroups = 2;
+
+   for (U32 pass = 0; pass < 10; pass++)
+   {
+      tick();
+
+      for (U32 i = 0; i < mObjects.size(); i++)
+      {
+         TestObject* obj = mObjects[i];
+         EXPECT_EQ(pass + 1, obj->mTickCount);
+
+         // Chains tick in order.
+         if (obj->mAfter)
+         {
+            EXPECT_LT(static_cast<TestObject*>(obj->mAfter)->mTickOrder, obj->mTickOrder);
+         }
+
+         // Serial objects tick after everything before them in the list
+         // and before everything after them.
+         if (!obj->mThreadSafe)
+         {
+            EXPECT_EQ(i, obj->mTickOrder);
+            for (U32 j = 0; j < mObjects.size(); j++)
+            {
+               if (j < i)
+               {
+                  EXPECT_LT(mObjects[j]->mTickOrder, obj->mTickOrder);
+               }
+               else if (j > i)
+               {
+                  EXPECT_GT(mObjects[j]->mTickOrder, obj->mTickOrder);
+               }
+            }
+         }
+      }
+   }
+}
+
+FIXTURE(ProcessListSplash)
+{
+public:
+   /// A list of splashes with a serial object every few splashes so
+   /// that the splashes tick in several runs.
+   struct SplashList
+   {
+      ProcessListFixture::TestProcessList list;
+      Vector<Splash*> splashes;
+      Vector<ProcessObject*> serial;
+
+      ~SplashList()
+      {
+         for (U32 i = 0; i < splashes.size(); i++)
+            delete splashes[i];
+         for (U32 i = 0; i < serial.size(); i++)
+            delete serial[i];
+      }
+
+      /// Adds a few splashes each tick so that they have all run for a
+      /// different number of ticks at the end.
+      void run(U32 numTicks)
+      {
+         U32 orderGUID = 0;
+         for (U32 t = 0; t < numTicks; t++)
+         {
+            for (U32 i = 0; i < 8; i++)
+            {
+               Splash* splash = new Splash();
+               splash->mOrderGUID = orderGUID++;
+               splashes.push_back(splash);
+               list.addObject(splash);
+            }
+
+            ProcessObject* obj = new ProcessObject();
+            obj->mOrderGUID = orderGUID++;
+            serial.push_back(obj);
+            list.addObject(obj);
+
+            list.markDirty();
+            list.advanceTime(TickMs);
+         }
+      }
+   };
+
+   bool mSavedParallelTicks;
+   U32 mSavedMinParallelGroups;
+
+   virtual void SetUp()
+   {
+      mSavedParallelTicks = ProcessList::smParallelTicks;
+      mSavedMinParallelGroups = ProcessList::smMinParallelGroups;
+   }
+
+   virtual void TearDown()
+   {
+      ProcessList::smParallelTicks = mSavedParallelTicks;
+      ProcessList::smMinParallelGroups = mSavedMinParallelGroups;
+   }
+};
+
+TEST_FIX(ProcessListSplash, ParallelTicksMatchSerial)
+{
+   const U32 numTicks = 64;
+
+   ProcessList::smParallelTicks = false;
+   SplashList serial;
+   serial.run(numTicks);
+
+   ProcessList::smParallelTicks = true;
+   ProcessList::smMinParallelGroups = 2;
+   SplashList parallel;
+   parallel.run(numTicks);
+
+   ASSERT_EQ(serial.splashes.size(), parallel.splashes.size());
+   for (U32 i = 0; i < serial.splashes.size(); i++)
+   {
+      // Splashes added on tick t have been ticked numTicks - t times and
+      // die once their default 1000ms lifetime is up.
+      const U32 numSplashTicks = numTicks - i / 8;
+      const bool expectDead = numSplashTicks * TickMs >= 1000;
+
+      EXPECT_EQ(expectDead, serial.splashes[i]->isDead()) << "Splash " << i;
+      EXPECT_EQ(serial.splashes[i]->isDead(), parallel.splashes[i]->isDead()) << "Splash " << i;
+   }
+}
+
+#endif
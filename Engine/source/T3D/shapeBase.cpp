@@ -50,6 +50,7 @@
 #include "math/mTransform.h"
 #include "math/mRandom.h"
 #include "platform/profiler.h"
+#include "core/frameAllocator.h"
 #include "gfx/gfxCubemap.h"
 #include "gfx/gfxDrawUtil.h"
 #include "gfx/gfxTransformSaver.h"
@@ -2412,6 +2413,36 @@ TSShape const* ShapeBase::getShape()
    return mShapeInstance? mShapeInstance->getShape(): 0;
 }
 
+void ShapeBase::animateRenderList( SceneObject** objects, U32 numObjects )
+{
+   PROFILE_SCOPE( ShapeBase_AnimateRenderList );
+
+   if ( !numObjects )
+      return;
+
+   FrameTemp< TSShapeInstance* > instances( numObjects );
+   U32 numInstances = 0;
+
+   for ( U32 i = 0; i < numObjects; i++ )
+   {
+      if ( !( objects[ i ]->getTypeMask() & ShapeBaseObjectType ) )
+         continue;
+
+      ShapeBase* shape = static_cast< ShapeBase* >( objects[ i ] );
+      if ( !shape->mShapeInstance || shape->mShapeInstance->getCurrentDetail() < 0 )
+         continue;
+
+      if ( ( shape->getDamageState() == Destroyed ) && ( !shape->mDataBlock->renderWhenDestroyed ) )
+         continue;
+
+      instances[ numInstances++ ] = shape->mShapeInstance;
+   }
+
+   // The detail level is the one picked on the last frame.  If it changes
+   // in prepBatchRender() the new one is animated there as before.
+   TSShapeInstance::animateBatch( instances.address(), numInstances );
+}
+
 void ShapeBase::prepRenderImage( SceneRenderState *state )
 {
    _prepRenderImage( state, true, true );
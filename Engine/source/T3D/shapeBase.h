@@ -1788,6 +1788,12 @@ public:
    /// Returns true if the last frame calculated rendered
    bool didRenderLastRender() { return mLastRenderFrame == sLastRenderFrame; }
 
+   /// Animate the shape instances of the ShapeBase objects in the list at
+   /// their current detail level with TSShapeInstance::animateBatch(), so
+   /// their prepRenderImage() finds them already animated.  Objects of
+   /// other types are skipped.
+   static void animateRenderList( SceneObject** objects, U32 numObjects );
+
    /// Sets the state of this object as hidden or not. If an object is hidden
    /// it is removed entirely from collisions, it is not ghosted and is
    /// essentially "non existant" as far as simulation is concerned.
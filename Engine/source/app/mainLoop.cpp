@@ -36,6 +36,7 @@
 #include "core/threadStatic.h"
 #include "core/iTickable.h"
 #include "core/stream/fileStream.h"
+#include "core/resourceManager.h"
 
 #include "windowManager/platformWindowMgr.h"
 
@@ -622,6 +623,7 @@ bool StandardMainLoop::doMainLoop()
          keepRunning = false;
 
       ThreadPool::processMainThreadWorkItems();
+      ResourceManager::get().processAsyncLoads();
       Sampler::endFrame();
       PROFILE_END_NAMED(MainLoop);
    }
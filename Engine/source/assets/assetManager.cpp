@@ -68,15 +68,17 @@ AssetManager AssetDatabase;
 //-----------------------------------------------------------------------------
 
 AssetManager::AssetManager() :
+    mScanCacheFile( "" ),
+    mScanCacheLoaded( false ),
+    mEchoInfo( false ),
+    mIgnoreAutoUnload( true ),
     mLoadedInternalAssetsCount( 0 ),
     mLoadedExternalAssetsCount( 0 ),
     mLoadedPrivateAssetsCount( 0 ),
+    mAcquiredReferenceCount( 0 ),
     mMaxLoadedInternalAssetsCount( 0 ),
     mMaxLoadedExternalAssetsCount( 0 ),
-    mMaxLoadedPrivateAssetsCount( 0 ),
-    mAcquiredReferenceCount( 0 ),
-    mEchoInfo( false ),
-    mIgnoreAutoUnload( true )
+    mMaxLoadedPrivateAssetsCount( 0 )
 {
 }
 
@@ -102,6 +104,10 @@ void AssetManager::onRemove()
         mAssetTagsManifest->deleteObject();
     }
 
+    // Save any changes to the asset scan cache.
+    if ( mScanCacheLoaded && mScanCache.isDirty() )
+        saveScanCache();
+
     // Call parent.
     Parent::onRemove();
 }
@@ -115,6 +121,7 @@ void AssetManager::initPersistFields()
 
     addField( "EchoInfo", TypeBool, Offset(mEchoInfo, AssetManager), "Whether the asset manager echos extra information to the console or not." );
     addField( "IgnoreAutoUnload", TypeBool, Offset(mIgnoreAutoUnload, AssetManager), "Whether the asset manager should ignore unloading of auto-unload assets or not." );
+    addField( "ScanCacheFile", TypeString, Offset(mScanCacheFile, AssetManager), "The file used to persist the results of declared and referenced asset scans between runs.  No cache is used if empty." );
 }
 
 //-----------------------------------------------------------------------------
@@ -807,6 +814,9 @@ bool AssetManager::renameDeclaredAsset( const char* pAssetIdFrom, const char* pA
         return false;
     }
 
+    // The asset file has changed so it must be scanned again.
+    mScanCache.removeEntries( pAssetDefinition->mAssetBaseFilePath );
+
     // Update asset definition.
     pAssetDefinition->mAssetId = assetIdTo;
     pAssetDefinition->mAssetName = StringTable->insert( StringUnit::getUnit( assetIdTo, 1, ASSET_SCOPE_TOKEN ) );
@@ -1106,6 +1116,9 @@ bool AssetManager::deleteAsset( const char* pAssetId, const bool deleteLooseFile
     // Remove asset.
     removeDeclaredAsset( pAssetId );
 
+    // The asset file is being removed so it must not be scanned again.
+    mScanCache.removeEntries( assetDefinitionFile );
+
     // Delete the asset definition file.
     if ( !dFileDelete( assetDefinitionFile ) )
     {
@@ -1188,6 +1201,9 @@ bool AssetManager::refreshAsset( const char* pAssetId )
 
             // Save asset.
             mTaml.write( pAssetBase, pAssetDefinition->mAssetBaseFilePath );
+
+            // The asset file has changed so it must be scanned again.
+            mScanCache.removeEntries( pAssetDefinition->mAssetBaseFilePath );
         
             // Remove asset dependencies.
             removeAssetDependencies( pAssetId );
@@ -1387,6 +1403,47 @@ void AssetManager::unregisterAssetPtrRefreshNotify( AssetPtrBase* pAssetPtrBase
 
 //-----------------------------------------------------------------------------
 
+bool AssetManager::saveScanCache( void )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(AssetManager_SaveScanCache);
+
+    // Fetch the scan cache.
+    AssetScanCache* pScanCache = getScanCache();
+
+    // Finish if no scan cache is used.
+    if ( pScanCache == NULL )
+    {
+        // Warn.
+        Con::warnf( "Asset Manager: Cannot save the asset scan cache as no scan cache file is specified." );
+        return false;
+    }
+
+    // Expand the file-path.
+    char scanCacheFilePathBuffer[1024];
+    Con::expandPath( scanCacheFilePathBuffer, sizeof(scanCacheFilePathBuffer), mScanCacheFile );
+
+    // Save the scan cache.
+    return pScanCache->save( scanCacheFilePathBuffer );
+}
+
+//-----------------------------------------------------------------------------
+
+void AssetManager::invalidateScanCacheFile( const char* pFilePath )
+{
+    // Sanity!
+    AssertFatal( pFilePath != NULL, "Cannot invalidate a NULL scan cache file-path." );
+
+    // Expand the file-path.
+    char filePathBuffer[1024];
+    Con::expandPath( filePathBuffer, sizeof(filePathBuffer), pFilePath );
+
+    // Remove any scans of the file.
+    mScanCache.removeEntries( StringTable->insert( filePathBuffer ) );
+}
+
+//-----------------------------------------------------------------------------
+
 bool AssetManager::loadAssetTags( ModuleDefinition* pModuleDefinition )
 {
     // Sanity!
@@ -2357,6 +2414,9 @@ bool AssetManager::scanDeclaredAssets( const char* pPath, const char* pExtension
 
     TamlAssetDeclaredVisitor assetDeclaredVisitor;
 
+    // Fetch the scan cache.
+    AssetScanCache* pScanCache = getScanCache();
+
     // Iterate files.
     for ( Vector<Platform::FileInfo>::iterator fileItr = files.begin(); fileItr != files.end(); ++fileItr )
     {
@@ -2384,12 +2444,37 @@ bool AssetManager::scanDeclaredAssets( const char* pPath, const char* pExtension
         char assetFileBuffer[1024];
         dSprintf( assetFileBuffer, sizeof(assetFileBuffer), "%s/%s", fileInfo.pFullPath, fileInfo.pFileName );
 
-        // Parse the filename.
-        if ( !mTaml.parse( assetFileBuffer, assetDeclaredVisitor ) )
+        // Find any valid scan of the file.
+        StringTableEntry assetFilePath = StringTable->insert( assetFileBuffer );
+        AssetScanCache::Entry* pScanCacheEntry = pScanCache != NULL ? pScanCache->findEntry( AssetScanCache::DeclaredEntry, assetFilePath, fileInfo.fileSize ) : NULL;
+
+        // Did we find a scan?
+        if ( pScanCacheEntry != NULL )
         {
-            // Warn.
-            Con::warnf( "Asset Manager: Failed to parse file containing asset declaration: '%s'.", assetFileBuffer );
-            continue;
+            // Yes, so use it instead of parsing the file.
+            assetDeclaredVisitor.getAssetDefinition() = pScanCacheEntry->mAssetDefinition;
+            assetDeclaredVisitor.getAssetDependencies() = pScanCacheEntry->mAssetIds;
+            assetDeclaredVisitor.getAssetLooseFiles() = pScanCacheEntry->mLooseFiles;
+        }
+        else
+        {
+            // No, so parse the filename.
+            U32 contentHash = 0;
+            if ( !mTaml.parse( assetFilePath, assetDeclaredVisitor, pScanCache != NULL ? &contentHash : NULL ) )
+            {
+                // Warn.
+                Con::warnf( "Asset Manager: Failed to parse file containing asset declaration: '%s'.", assetFileBuffer );
+                continue;
+            }
+
+            // Store the scan.
+            if ( pScanCache != NULL )
+            {
+                pScanCacheEntry = pScanCache->createEntry( AssetScanCache::DeclaredEntry, assetFilePath, fileInfo.fileSize, contentHash );
+                pScanCacheEntry->mAssetDefinition = assetDeclaredVisitor.getAssetDefinition();
+                pScanCacheEntry->mAssetIds = assetDeclaredVisitor.getAssetDependencies();
+                pScanCacheEntry->mLooseFiles = assetDeclaredVisitor.getAssetLooseFiles();
+            }
         }
 
         // Fetch asset definition.
@@ -2548,6 +2633,12 @@ bool AssetManager::scanReferencedAssets( const char* pPath, const char* pExtensi
 
     TamlAssetReferencedVisitor assetReferencedVisitor;
 
+    // Fetch the scan cache.
+    AssetScanCache* pScanCache = getScanCache();
+
+    // Referenced asset Ids of each file.
+    Vector<typeAssetId> referencedAssetIds;
+
     // Iterate files.
     for ( Vector<Platform::FileInfo>::iterator fileItr = files.begin(); fileItr != files.end(); ++fileItr )
     {
@@ -2578,19 +2669,41 @@ bool AssetManager::scanReferencedAssets( const char* pPath, const char* pExtensi
         // Format reference file-path.
         typeReferenceFilePath referenceFilePath = StringTable->insert( assetFileBuffer );
 
-        // Parse the filename.
-        if ( !mTaml.parse( referenceFilePath, assetReferencedVisitor ) )
+        // Find any valid scan of the file.
+        AssetScanCache::Entry* pScanCacheEntry = pScanCache != NULL ? pScanCache->findEntry( AssetScanCache::ReferencedEntry, referenceFilePath, fileInfo.fileSize ) : NULL;
+
+        // Did we find a scan?
+        if ( pScanCacheEntry != NULL )
         {
-            // Warn.
-            Con::warnf( "Asset Manager: Failed to parse file containing asset references: '%s'.", referenceFilePath );
-            continue;
+            // Yes, so use it instead of parsing the file.
+            referencedAssetIds = pScanCacheEntry->mAssetIds;
         }
+        else
+        {
+            // No, so parse the filename.
+            U32 contentHash = 0;
+            if ( !mTaml.parse( referenceFilePath, assetReferencedVisitor, pScanCache != NULL ? &contentHash : NULL ) )
+            {
+                // Warn.
+                Con::warnf( "Asset Manager: Failed to parse file containing asset references: '%s'.", referenceFilePath );
+                continue;
+            }
+
+            // Fetch usage map.
+            const TamlAssetReferencedVisitor::typeAssetReferencedHash& assetReferencedMap = assetReferencedVisitor.getAssetReferencedMap();
+
+            // Fetch the referenced asset Ids.
+            referencedAssetIds.clear();
+            for( TamlAssetReferencedVisitor::typeAssetReferencedHash::const_iterator usageItr = assetReferencedMap.begin(); usageItr != assetReferencedMap.end(); ++usageItr )
+                referencedAssetIds.push_back( usageItr->key );
 
-        // Fetch usage map.
-        const TamlAssetReferencedVisitor::typeAssetReferencedHash& assetReferencedMap = assetReferencedVisitor.getAssetReferencedMap();
+            // Store the scan.
+            if ( pScanCache != NULL )
+                pScanCache->createEntry( AssetScanCache::ReferencedEntry, referenceFilePath, fileInfo.fileSize, contentHash )->mAssetIds = referencedAssetIds;
+        }
 
         // Do we have any asset references?
-        if ( assetReferencedMap.size() > 0 )
+        if ( referencedAssetIds.size() > 0 )
         {
             // Info.
             if ( mEchoInfo )
@@ -2599,10 +2712,10 @@ bool AssetManager::scanReferencedAssets( const char* pPath, const char* pExtensi
             }
 
             // Iterate usage.
-            for( TamlAssetReferencedVisitor::typeAssetReferencedHash::const_iterator usageItr = assetReferencedMap.begin(); usageItr != assetReferencedMap.end(); ++usageItr )
+            for( Vector<typeAssetId>::iterator usageItr = referencedAssetIds.begin(); usageItr != referencedAssetIds.end(); ++usageItr )
             {
                 // Fetch asset name.
-                typeAssetId assetId = usageItr->key;
+                typeAssetId assetId = *usageItr;
 
                 // Info.
                 if ( mEchoInfo )
@@ -2629,6 +2742,37 @@ bool AssetManager::scanReferencedAssets( const char* pPath, const char* pExtensi
 
 //-----------------------------------------------------------------------------
 
+AssetScanCache* AssetManager::getScanCache( void )
+{
+    // Finish if no scan cache is used.
+    if ( mScanCacheFile == NULL || *mScanCacheFile == 0 )
+        return NULL;
+
+    // Is the scan cache loaded?
+    if ( !mScanCacheLoaded )
+    {
+        // No, so flag as loaded.
+        mScanCacheLoaded = true;
+
+        // Expand the file-path.
+        char scanCacheFilePathBuffer[1024];
+        Con::expandPath( scanCacheFilePathBuffer, sizeof(scanCacheFilePathBuffer), mScanCacheFile );
+
+        // Load the scan cache.
+        if ( mScanCache.load( scanCacheFilePathBuffer ) && mEchoInfo )
+        {
+            Con::printf( "Asset Manager: Loaded asset scan cache '%s' with %d declared and %d referenced asset files.",
+                scanCacheFilePathBuffer,
+                mScanCache.getEntryCount( AssetScanCache::DeclaredEntry ),
+                mScanCache.getEntryCount( AssetScanCache::ReferencedEntry ) );
+        }
+    }
+
+    return &mScanCache;
+}
+
+//-----------------------------------------------------------------------------
+
 AssetDefinition* AssetManager::findAsset( const char* pAssetId )
 {
     // Debug Profiling.
@@ -2741,6 +2885,9 @@ void AssetManager::renameAssetReferences( StringTableEntry assetIdFrom, StringTa
                 assetIdFrom, assetIdTo, referencedAssetItr->value );
         }
 
+        // The referencing file has changed so it must be scanned again.
+        mScanCache.removeEntries( referencedAssetItr->value );
+
         // Move to next reference.
         referencedAssetItr++;
     }
@@ -2792,6 +2939,9 @@ void AssetManager::removeAssetReferences( StringTableEntry assetId )
                 referencedAssetItr->value );
         }
 
+        // The referencing file has changed so it must be scanned again.
+        mScanCache.removeEntries( referencedAssetItr->value );
+
         // Move to next reference.
         referencedAssetItr++;
     }
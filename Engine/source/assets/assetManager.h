@@ -59,6 +59,10 @@
 #include "assets/assetFieldTypes.h"
 #endif
 
+#ifndef _ASSET_SCAN_CACHE_H_
+#include "assets/assetScanCache.h"
+#endif
+
 // Debug Profiling.
 #include "platform/profiler.h"
 
@@ -99,6 +103,11 @@ private:
     /// Asset pointer refresh notifications.
     typeAssetPtrRefreshHash             mAssetPtrRefreshNotifications;
 
+    /// Persistent results of declared and referenced asset scans.
+    AssetScanCache                      mScanCache;
+    StringTableEntry                    mScanCacheFile;
+    bool                                mScanCacheLoaded;
+
     /// Miscellaneous.
     bool                                mEchoInfo;
     bool                                mIgnoreAutoUnload;
@@ -331,6 +340,10 @@ public:
     void registerAssetPtrRefreshNotify( AssetPtrBase* pAssetPtrBase, AssetPtrCallback* pCallback );
     void unregisterAssetPtrRefreshNotify( AssetPtrBase* pAssetPtrBase );
 
+    /// Asset scan cache.
+    bool saveScanCache( void );
+    void invalidateScanCacheFile( const char* pFilePath );
+
     /// Asset tags.
     bool loadAssetTags( ModuleDefinition* pModuleDefinition );
     bool saveAssetTags( void );
@@ -373,6 +386,7 @@ public:
 private:
     bool scanDeclaredAssets( const char* pPath, const char* pExtension, const bool recurse, ModuleDefinition* pModuleDefinition );
     bool scanReferencedAssets( const char* pPath, const char* pExtension, const bool recurse );
+    AssetScanCache* getScanCache( void );
     AssetDefinition* findAsset( const char* pAssetId );
     void addReferencedAsset( StringTableEntry assetId, StringTableEntry referenceFilePath );
     void renameAssetReferences( StringTableEntry assetIdFrom, StringTableEntry assetIdTo );
@@ -400,6 +400,29 @@ DefineEngineMethod(AssetManager, refreshAllAssets, void, (bool includeUnloaded),
 
 //-----------------------------------------------------------------------------
 
+DefineEngineMethod(AssetManager, saveScanCache, bool, (),,
+   "Save the results of declared and referenced asset scans to the file specified by the 'ScanCacheFile' field.\n"
+   "The scan cache is also saved automatically when the asset manager is removed.\n"
+   "@return Whether the save was successful or not.\n")
+{
+    // Save scan cache.
+    return object->saveScanCache();
+}
+
+//-----------------------------------------------------------------------------
+
+DefineEngineMethod(AssetManager, invalidateScanCacheFile, void, (const char* filePath),,
+   "Discard any cached scan of the specified file so that it is parsed again when next scanned.\n"
+   "Editors should call this when they change an asset or referencing file.\n"
+   "@param filePath The changed file.\n"
+   "@return No return value.\n")
+{
+    // Invalidate scan cache file.
+    object->invalidateScanCacheFile(filePath);
+}
+
+//-----------------------------------------------------------------------------
+
 DefineEngineMethod(AssetManager, saveAssetTags, bool, (),,
    "Save the currently loaded asset tags manifest.\n"
    "@return Whether the save was successful or not.\n")
@@ -0,0 +1,436 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2013 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _ASSET_SCAN_CACHE_H_
+#include "assets/assetScanCache.h"
+#endif
+
+#ifndef _FILESTREAM_H_
+#include "core/stream/fileStream.h"
+#endif
+
+#ifndef _FILEIO_H_
+#include "core/fileio.h"
+#endif
+
+#ifndef _HASHFUNCTION_H_
+#include "core/util/hashFunction.h"
+#endif
+
+#ifndef _CONSOLE_H_
+#include "console/console.h"
+#endif
+
+// Debug Profiling.
+#include "platform/profiler.h"
+
+//-----------------------------------------------------------------------------
+
+static const U32 scanCacheMaxStringLength = 1024;
+
+//-----------------------------------------------------------------------------
+
+static StringTableEntry readCacheString( Stream& stream )
+{
+    char buffer[scanCacheMaxStringLength];
+    stream.readLongString( sizeof(buffer), buffer );
+    return StringTable->insert( buffer );
+}
+
+//-----------------------------------------------------------------------------
+
+static void writeCacheString( Stream& stream, StringTableEntry string )
+{
+    stream.writeLongString( scanCacheMaxStringLength, string );
+}
+
+//-----------------------------------------------------------------------------
+
+bool AssetScanCache::load( const char* pFilename )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(AssetScanCache_Load);
+
+    // Sanity!
+    AssertFatal( pFilename != NULL, "Cannot load asset scan cache from a NULL filename." );
+
+    // Clear any existing entries.
+    clear();
+
+    FileStream stream;
+
+    // Finish if there's no cache yet.
+    if ( !stream.open( pFilename, Torque::FS::File::Read ) )
+        return false;
+
+    // Is the signature and version correct?
+    char signatureBuffer[256];
+    stream.readString( signatureBuffer );
+    U32 version = 0;
+    U32 fileTimeSize = 0;
+    stream.read( &version );
+    stream.read( &fileTimeSize );
+    if ( dStrcmp( signatureBuffer, ASSET_SCAN_CACHE_SIGNATURE ) != 0 || version != ASSET_SCAN_CACHE_VERSION || fileTimeSize != sizeof(FileTime) )
+    {
+        // No, so warn.
+        Con::warnf( "Asset Manager: Ignoring asset scan cache '%s' as it is not compatible.", pFilename );
+        return false;
+    }
+
+    // Iterate entry types.
+    for ( U32 entryType = 0; entryType < EntryTypeCount; ++entryType )
+    {
+        // Read entry count.
+        U32 entryCount = 0;
+        stream.read( &entryCount );
+
+        for ( U32 entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+        {
+            // Finish if the cache is truncated.
+            if ( stream.getStatus() != Stream::Ok )
+            {
+                // Warn.
+                Con::warnf( "Asset Manager: Ignoring asset scan cache '%s' as it is truncated.", pFilename );
+                clear();
+                return false;
+            }
+
+            Entry* pEntry = new Entry();
+
+            // Read file state.
+            pEntry->mFilePath = readCacheString( stream );
+            stream.read( sizeof(FileTime), &pEntry->mModifyTime );
+            stream.read( &pEntry->mFileSize );
+            stream.read( &pEntry->mContentHash );
+
+            // Read asset definition.
+            AssetDefinition& assetDefinition = pEntry->mAssetDefinition;
+            assetDefinition.mAssetBaseFilePath = readCacheString( stream );
+            assetDefinition.mAssetName = readCacheString( stream );
+            assetDefinition.mAssetDescription = readCacheString( stream );
+            assetDefinition.mAssetCategory = readCacheString( stream );
+            assetDefinition.mAssetType = readCacheString( stream );
+            stream.read( &assetDefinition.mAssetAutoUnload );
+            stream.read( &assetDefinition.mAssetInternal );
+
+            // Read asset Ids.
+            U32 assetIdCount = 0;
+            stream.read( &assetIdCount );
+            for ( U32 index = 0; index < assetIdCount && stream.getStatus() == Stream::Ok; ++index )
+                pEntry->mAssetIds.push_back( readCacheString( stream ) );
+
+            // Read loose files.
+            U32 looseFileCount = 0;
+            stream.read( &looseFileCount );
+            for ( U32 index = 0; index < looseFileCount && stream.getStatus() == Stream::Ok; ++index )
+                pEntry->mLooseFiles.push_back( readCacheString( stream ) );
+
+            // Store entry.
+            typeEntryHash::iterator entryItr = mEntries[entryType].find( pEntry->mFilePath );
+            if ( entryItr != mEntries[entryType].end() )
+            {
+                delete entryItr->value;
+                entryItr->value = pEntry;
+            }
+            else
+            {
+                mEntries[entryType].insert( pEntry->mFilePath, pEntry );
+            }
+        }
+    }
+
+    // Finish if the cache is truncated.
+    if ( stream.getStatus() != Stream::Ok )
+    {
+        // Warn.
+        Con::warnf( "Asset Manager: Ignoring asset scan cache '%s' as it is truncated.", pFilename );
+        clear();
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool AssetScanCache::save( const char* pFilename )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(AssetScanCache_Save);
+
+    // Sanity!
+    AssertFatal( pFilename != NULL, "Cannot save asset scan cache to a NULL filename." );
+
+    // Remove entries for files that no longer exist.
+    pruneEntries();
+
+    FileStream stream;
+
+    // File opened?
+    if ( !stream.open( pFilename, Torque::FS::File::Write ) )
+    {
+        // No, so warn.
+        Con::warnf( "Asset Manager: Could not open asset scan cache '%s' for write.", pFilename );
+        return false;
+    }
+
+    // Write signature and version.
+    stream.writeString( ASSET_SCAN_CACHE_SIGNATURE );
+    stream.write( (U32)ASSET_SCAN_CACHE_VERSION );
+    stream.write( (U32)sizeof(FileTime) );
+
+    // Iterate entry types.
+    for ( U32 entryType = 0; entryType < EntryTypeCount; ++entryType )
+    {
+        // Write entry count.
+        stream.write( (U32)mEntries[entryType].size() );
+
+        for ( typeEntryHash::iterator entryItr = mEntries[entryType].begin(); entryItr != mEntries[entryType].end(); ++entryItr )
+        {
+            const Entry* pEntry = entryItr->value;
+
+            // Write file state.
+            writeCacheString( stream, pEntry->mFilePath );
+            stream.write( sizeof(FileTime), &pEntry->mModifyTime );
+            stream.write( pEntry->mFileSize );
+            stream.write( pEntry->mContentHash );
+
+            // Write asset definition.
+            const AssetDefinition& assetDefinition = pEntry->mAssetDefinition;
+            writeCacheString( stream, assetDefinition.mAssetBaseFilePath );
+            writeCacheString( stream, assetDefinition.mAssetName );
+            writeCacheString( stream, assetDefinition.mAssetDescription );
+            writeCacheString( stream, assetDefinition.mAssetCategory );
+            writeCacheString( stream, assetDefinition.mAssetType );
+            stream.write( assetDefinition.mAssetAutoUnload );
+            stream.write( assetDefinition.mAssetInternal );
+
+            // Write asset Ids.
+            stream.write( (U32)pEntry->mAssetIds.size() );
+            for ( U32 index = 0; index < (U32)pEntry->mAssetIds.size(); ++index )
+                writeCacheString( stream, pEntry->mAssetIds[index] );
+
+            // Write loose files.
+            stream.write( (U32)pEntry->mLooseFiles.size() );
+            for ( U32 index = 0; index < (U32)pEntry->mLooseFiles.size(); ++index )
+                writeCacheString( stream, pEntry->mLooseFiles[index] );
+        }
+    }
+
+    const bool status = stream.getStatus() == Stream::Ok;
+
+    // Close file.
+    stream.close();
+
+    // Flag as clean.
+    if ( status )
+        mDirty = false;
+
+    return status;
+}
+
+//-----------------------------------------------------------------------------
+
+void AssetScanCache::clear( void )
+{
+    // Iterate entry types.
+    for ( U32 entryType = 0; entryType < EntryTypeCount; ++entryType )
+    {
+        // Delete entries.
+        for ( typeEntryHash::iterator entryItr = mEntries[entryType].begin(); entryItr != mEntries[entryType].end(); ++entryItr )
+            delete entryItr->value;
+
+        mEntries[entryType].clear();
+    }
+
+    mDirty = false;
+}
+
+//-----------------------------------------------------------------------------
+
+AssetScanCache::Entry* AssetScanCache::findEntry( const EntryType entryType, StringTableEntry filePath, const U32 fileSize )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(AssetScanCache_FindEntry);
+
+    // Find entry.
+    typeEntryHash::iterator entryItr = mEntries[entryType].find( filePath );
+
+    // Finish if there isn't one.
+    if ( entryItr == mEntries[entryType].end() )
+        return NULL;
+
+    Entry* pEntry = entryItr->value;
+
+    // Finish if the file has changed size.
+    if ( pEntry->mFileSize != fileSize )
+        return NULL;
+
+    // Fetch the file modification time.
+    FileTime createTime;
+    FileTime modifyTime;
+    if ( !Platform::getFileTimes( filePath, &createTime, &modifyTime ) )
+        return NULL;
+
+    // Has the file been modified?
+    if ( Platform::compareFileTimes( modifyTime, pEntry->mModifyTime ) != 0 )
+    {
+        // Yes, so finish if the contents have changed.
+        U32 contentHash;
+        if ( !hashFileContents( filePath, contentHash ) || contentHash != pEntry->mContentHash )
+            return NULL;
+
+        // The contents are the same so the entry is valid for the new time.
+        pEntry->mModifyTime = modifyTime;
+        mDirty = true;
+    }
+
+    // Flag as seen.
+    pEntry->mSeen = true;
+
+    return pEntry;
+}
+
+//-----------------------------------------------------------------------------
+
+AssetScanCache::Entry* AssetScanCache::createEntry( const EntryType entryType, StringTableEntry filePath, const U32 fileSize, const U32 contentHash )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(AssetScanCache_CreateEntry);
+
+    // Find any existing entry.
+    typeEntryHash::iterator entryItr = mEntries[entryType].find( filePath );
+
+    Entry* pEntry;
+
+    // Did we find an entry?
+    if ( entryItr == mEntries[entryType].end() )
+    {
+        // No, so create one.
+        pEntry = new Entry();
+        pEntry->mFilePath = filePath;
+        mEntries[entryType].insert( filePath, pEntry );
+    }
+    else
+    {
+        // Yes, so reset it.
+        pEntry = entryItr->value;
+        pEntry->mAssetDefinition.reset();
+        pEntry->mAssetIds.clear();
+        pEntry->mLooseFiles.clear();
+    }
+
+    // Record the file state.
+    FileTime createTime;
+    Platform::getFileTimes( filePath, &createTime, &pEntry->mModifyTime );
+    pEntry->mFileSize = fileSize;
+    pEntry->mContentHash = contentHash;
+
+    // Flag as seen.
+    pEntry->mSeen = true;
+
+    // Flag as dirty.
+    mDirty = true;
+
+    return pEntry;
+}
+
+//-----------------------------------------------------------------------------
+
+void AssetScanCache::removeEntries( StringTableEntry filePath )
+{
+    // Iterate entry types.
+    for ( U32 entryType = 0; entryType < EntryTypeCount; ++entryType )
+    {
+        // Find entry.
+        typeEntryHash::iterator entryItr = mEntries[entryType].find( filePath );
+
+        // Skip if not found.
+        if ( entryItr == mEntries[entryType].end() )
+            continue;
+
+        // Remove entry.
+        delete entryItr->value;
+        mEntries[entryType].erase( entryItr );
+
+        // Flag as dirty.
+        mDirty = true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+bool AssetScanCache::hashFileContents( StringTableEntry filePath, U32& contentHash )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(AssetScanCache_HashFileContents);
+
+    File file;
+
+    // Finish if the file cannot be read.
+    if ( file.open( filePath, File::Read ) != File::Ok )
+        return false;
+
+    // Read the file.
+    const U32 fileSize = file.getSize();
+    Vector<char> buffer;
+    buffer.setSize( getMax( fileSize, (U32)1 ) );
+    const bool status = file.read( fileSize, buffer.address() ) == File::Ok;
+    file.close();
+
+    // Finish if the read failed.
+    if ( !status )
+        return false;
+
+    // Hash the contents.
+    contentHash = Torque::hash( (const U8*)buffer.address(), fileSize, 0 );
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+void AssetScanCache::pruneEntries( void )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(AssetScanCache_PruneEntries);
+
+    // Iterate entry types.
+    for ( U32 entryType = 0; entryType < EntryTypeCount; ++entryType )
+    {
+        // Gather entries that have not been seen and whose files are gone.
+        Vector<StringTableEntry> staleFiles;
+        for ( typeEntryHash::iterator entryItr = mEntries[entryType].begin(); entryItr != mEntries[entryType].end(); ++entryItr )
+        {
+            if ( !entryItr->value->mSeen && !Platform::isFile( entryItr->key ) )
+                staleFiles.push_back( entryItr->key );
+        }
+
+        // Remove the stale entries.
+        for ( U32 index = 0; index < (U32)staleFiles.size(); ++index )
+        {
+            typeEntryHash::iterator entryItr = mEntries[entryType].find( staleFiles[index] );
+            delete entryItr->value;
+            mEntries[entryType].erase( entryItr );
+        }
+    }
+}
@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2013 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _ASSET_SCAN_CACHE_H_
+#define _ASSET_SCAN_CACHE_H_
+
+#ifndef _TDICTIONARY_H_
+#include "core/util/tDictionary.h"
+#endif
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+#ifndef _ASSET_DEFINITION_H_
+#include "assets/assetDefinition.h"
+#endif
+
+//-----------------------------------------------------------------------------
+
+#define ASSET_SCAN_CACHE_SIGNATURE      "AssetScanCache"
+#define ASSET_SCAN_CACHE_VERSION        1
+
+//-----------------------------------------------------------------------------
+
+/// A persistent record of the results of scanning declared and referenced
+/// asset files, keyed by the file-path.
+///
+/// An entry is valid while the file modification time and size are
+/// unchanged.  If they have changed then the file contents are hashed and
+/// compared so that files which were only touched are not parsed again.
+class AssetScanCache
+{
+public:
+    struct Entry
+    {
+        Entry() : mFileSize( 0 ), mContentHash( 0 ), mSeen( false ) { dMemset( &mModifyTime, 0, sizeof(mModifyTime) ); }
+
+        StringTableEntry            mFilePath;
+        FileTime                    mModifyTime;
+        U32                         mFileSize;
+        U32                         mContentHash;
+
+        /// Whether the entry was used or updated since being loaded.
+        bool                        mSeen;
+
+        /// Declared asset state.
+        AssetDefinition             mAssetDefinition;
+
+        /// Dependencies of a declared asset or the assets referenced by a file.
+        Vector<StringTableEntry>    mAssetIds;
+
+        /// Loose files of a declared asset.
+        Vector<StringTableEntry>    mLooseFiles;
+    };
+
+    enum EntryType
+    {
+        DeclaredEntry,
+        ReferencedEntry,
+
+        EntryTypeCount
+    };
+
+private:
+    typedef HashMap<StringTableEntry, Entry*> typeEntryHash;
+
+    typeEntryHash       mEntries[EntryTypeCount];
+    bool                mDirty;
+
+public:
+    AssetScanCache() : mDirty( false ) {}
+    virtual ~AssetScanCache() { clear(); }
+
+    /// Read/write the cache.
+    bool load( const char* pFilename );
+    bool save( const char* pFilename );
+    void clear( void );
+    inline bool isDirty( void ) const { return mDirty; }
+
+    /// Find a valid entry for the file, NULL if there is none or it is out-of-date.
+    Entry* findEntry( const EntryType entryType, StringTableEntry filePath, const U32 fileSize );
+
+    /// Create (or reset) the entry for the file so it can be filled in with the results of a scan.
+    /// The content hash is of the bytes the scan parsed, so the file isn't read again.
+    Entry* createEntry( const EntryType entryType, StringTableEntry filePath, const U32 fileSize, const U32 contentHash );
+
+    /// Discard any entries for the file so that it is scanned again.
+    void removeEntries( StringTableEntry filePath );
+
+    inline U32 getEntryCount( const EntryType entryType ) const { return (U32)mEntries[entryType].size(); }
+
+private:
+    static bool hashFileContents( StringTableEntry filePath, U32& contentHash );
+    void pruneEntries( void );
+};
+
+#endif // _ASSET_SCAN_CACHE_H_
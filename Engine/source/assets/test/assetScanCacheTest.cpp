@@ -0,0 +1,195 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "assets/assetScanCache.h"
+#include "persistence/taml/taml.h"
+#include "persistence/taml/tamlParser.h"
+#include "assets/tamlAssetDeclaredVisitor.h"
+#include "core/stream/fileStream.h"
+#include "core/util/hashFunction.h"
+#include "core/volume.h"
+
+FIXTURE(AssetScanCache)
+{
+public:
+   // Files written by the test, deleted even if it fails part way.
+   Vector<String> mFiles;
+
+   virtual void TearDown()
+   {
+      for (U32 i = 0; i < mFiles.size(); i++)
+         dFileDelete(mFiles[i]);
+      mFiles.clear();
+   }
+
+   StringTableEntry writeFile(const char* filename, const char* contents)
+   {
+      mFiles.push_back(filename);
+
+      FileStream stream;
+      if (stream.open(filename, Torque::FS::File::Write))
+      {
+         stream.write(dStrlen(contents), contents);
+         stream.close();
+      }
+
+      return StringTable->insert(filename);
+   }
+
+   static U32 hashFile(const char* filename)
+   {
+      void* pData = NULL;
+      U32 dataSize = 0;
+      if (!Torque::FS::ReadFile(filename, pData, dataSize) || pData == NULL)
+         return 0;
+
+      const U32 contentHash = Torque::hash((const U8*)pData, dataSize, 0);
+      delete [] (char*)pData;
+      return contentHash;
+   }
+
+   // Makes the entry look as if the file was touched since it was scanned.
+   static void touchEntry(AssetScanCache::Entry* pEntry)
+   {
+      dMemset(&pEntry->mModifyTime, 0, sizeof(pEntry->mModifyTime));
+   }
+};
+
+TEST_FIX(AssetScanCache, SaveAndLoad)
+{
+   static const char* contents = "<ImageAsset AssetName=\"Test\" />";
+   StringTableEntry declaredFile = writeFile("assetScanCacheTest.asset.taml", contents);
+   StringTableEntry referencingFile = writeFile("assetScanCacheTest.level.taml", contents);
+   mFiles.push_back("assetScanCacheTest.cache");
+
+   AssetScanCache source;
+   AssetScanCache::Entry* pEntry = source.createEntry(AssetScanCache::DeclaredEntry, declaredFile, dStrlen(contents), hashFile(declaredFile));
+   pEntry->mAssetDefinition.mAssetName = StringTable->insert("Test");
+   pEntry->mAssetDefinition.mAssetType = StringTable->insert("ImageAsset");
+   pEntry->mAssetDefinition.mAssetInternal = true;
+   pEntry->mAssetIds.push_back(StringTable->insert("Core:Dependency"));
+   pEntry->mLooseFiles.push_back(StringTable->insert("test.png"));
+   source.createEntry(AssetScanCache::ReferencedEntry, referencingFile, dStrlen(contents), hashFile(referencingFile))
+      ->mAssetIds.push_back(StringTable->insert("Core:Test"));
+
+   EXPECT_TRUE(source.isDirty());
+   ASSERT_TRUE(source.save("assetScanCacheTest.cache"));
+   EXPECT_FALSE(source.isDirty());
+
+   AssetScanCache result;
+   ASSERT_TRUE(result.load("assetScanCacheTest.cache"));
+   EXPECT_EQ(1, result.getEntryCount(AssetScanCache::DeclaredEntry));
+   EXPECT_EQ(1, result.getEntryCount(AssetScanCache::ReferencedEntry));
+
+   pEntry = result.findEntry(AssetScanCache::DeclaredEntry, declaredFile, dStrlen(contents));
+   ASSERT_TRUE(pEntry != NULL)
+      << "An unchanged file should have a valid entry";
+   EXPECT_EQ(StringTable->insert("Test"), pEntry->mAssetDefinition.mAssetName);
+   EXPECT_EQ(StringTable->insert("ImageAsset"), pEntry->mAssetDefinition.mAssetType);
+   EXPECT_TRUE(pEntry->mAssetDefinition.mAssetInternal);
+   ASSERT_EQ(1, pEntry->mAssetIds.size());
+   EXPECT_EQ(StringTable->insert("Core:Dependency"), pEntry->mAssetIds[0]);
+   ASSERT_EQ(1, pEntry->mLooseFiles.size());
+   EXPECT_EQ(StringTable->insert("test.png"), pEntry->mLooseFiles[0]);
+
+   pEntry = result.findEntry(AssetScanCache::ReferencedEntry, referencingFile, dStrlen(contents));
+   ASSERT_TRUE(pEntry != NULL);
+   ASSERT_EQ(1, pEntry->mAssetIds.size());
+   EXPECT_EQ(StringTable->insert("Core:Test"), pEntry->mAssetIds[0]);
+
+   EXPECT_TRUE(result.findEntry(AssetScanCache::DeclaredEntry, declaredFile, dStrlen(contents) + 1) == NULL)
+      << "A change of size should invalidate the entry";
+}
+
+TEST_FIX(AssetScanCache, RejectsBadCache)
+{
+   StringTableEntry cacheFile = writeFile("assetScanCacheTest.cache", "NotAScanCache");
+
+   AssetScanCache cache;
+   EXPECT_FALSE(cache.load(cacheFile));
+   EXPECT_EQ(0, cache.getEntryCount(AssetScanCache::DeclaredEntry));
+   EXPECT_FALSE(cache.load("assetScanCacheTest.missing"));
+}
+
+TEST_FIX(AssetScanCache, TouchedFiles)
+{
+   static const char* contents = "<ImageAsset AssetName=\"Test\" />";
+   StringTableEntry file = writeFile("assetScanCacheTest.asset.taml", contents);
+
+   AssetScanCache cache;
+   touchEntry(cache.createEntry(AssetScanCache::DeclaredEntry, file, dStrlen(contents), hashFile(file)));
+   cache.save("assetScanCacheTest.cache");
+   mFiles.push_back("assetScanCacheTest.cache");
+
+   EXPECT_TRUE(cache.findEntry(AssetScanCache::DeclaredEntry, file, dStrlen(contents)) != NULL)
+      << "A touched file with the same contents should not be scanned again";
+   EXPECT_TRUE(cache.isDirty())
+      << "The new modification time should be saved";
+
+   // Same size, different contents.
+   writeFile(file, "<ImageAsset AssetName=\"Tset\" />");
+   touchEntry(cache.findEntry(AssetScanCache::DeclaredEntry, file, dStrlen(contents)));
+
+   EXPECT_TRUE(cache.findEntry(AssetScanCache::DeclaredEntry, file, dStrlen(contents)) == NULL)
+      << "A file with new contents should be scanned again";
+
+   cache.removeEntries(file);
+   EXPECT_EQ(0, cache.getEntryCount(AssetScanCache::DeclaredEntry));
+}
+
+TEST_FIX(AssetScanCache, ParseHashesFileContents)
+{
+   // The hash is of the file as stored, before new lines are normalized.
+   static const char* contents = "<ImageAsset\r\n   AssetName=\"Test\" />\r\n";
+   StringTableEntry file = writeFile("assetScanCacheTest.asset.taml", contents);
+
+   Taml taml;
+   TamlAssetDeclaredVisitor visitor;
+   U32 contentHash = 0;
+   ASSERT_TRUE(taml.parse(file, visitor, &contentHash));
+   EXPECT_EQ(StringTable->insert("Test"), visitor.getAssetDefinition().mAssetName);
+   EXPECT_EQ(hashFile(file), contentHash);
+
+   // A mapped binary copy.
+   SimObject* object = new SimObject();
+   object->registerObject();
+   object->setDataField(StringTable->insert("AssetName"), NULL, "Test");
+   mFiles.push_back("assetScanCacheTest.asset.mbaml");
+   taml.write(object, "assetScanCacheTest.asset.mbaml");
+   object->deleteObject();
+
+   visitor.clear();
+   contentHash = 0;
+   ASSERT_TRUE(taml.parse("assetScanCacheTest.asset.mbaml", visitor, &contentHash));
+   EXPECT_EQ(hashFile("assetScanCacheTest.asset.mbaml"), contentHash);
+
+   // Entries made from the parse hash survive a touch.
+   AssetScanCache cache;
+   touchEntry(cache.createEntry(AssetScanCache::DeclaredEntry, file, dStrlen(contents), hashFile(file)));
+   EXPECT_TRUE(cache.findEntry(AssetScanCache::DeclaredEntry, file, dStrlen(contents)) != NULL);
+}
+
+#endif
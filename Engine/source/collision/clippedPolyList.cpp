@@ -29,13 +29,11 @@
 
 #include "core/tAlgorithm.h"
 
-bool ClippedPolyList::allowClipping = true;
-
-
 //----------------------------------------------------------------------------
 
 ClippedPolyList::ClippedPolyList()
- : mNormal( Point3F::Zero ),
+ : mAllowClipping( true ),
+   mNormal( Point3F::Zero ),
    mNormalTolCosineRadians( 0.0f )
 {
    VECTOR_SET_ASSOCIATION(mPolyList);
@@ -132,7 +130,7 @@ void ClippedPolyList::begin(BaseMatInstance* material,U32 surfaceKey)
    poly.surfaceKey = surfaceKey;
 
    poly.polyFlags = 0;
-   if(ClippedPolyList::allowClipping)
+   if(mAllowClipping)
       poly.polyFlags = CLIPPEDPOLYLIST_FLAG_ALLOWCLIPPING;
 }
 
@@ -63,8 +63,9 @@ public:
 	  U32 polyFlags;
    };
 
-   /// ???
-   static bool allowClipping;
+   /// If set, polys added from now on get CLIPPEDPOLYLIST_FLAG_ALLOWCLIPPING.
+   /// Set per list so lists filled on other threads are not affected.
+   bool mAllowClipping;
 
    typedef Vector<PlaneF> PlaneList;
    typedef Vector<Vertex> VertexList;
@@ -0,0 +1,204 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "collision/collisionWorld.h"
+
+#include "collision/convex.h"
+#include "core/module.h"
+#include "core/util/tDictionary.h"
+#include "console/consoleTypes.h"
+#include "platform/threads/thread.h"
+#include "platform/threads/threadPool.h"
+#include "platform/profiler.h"
+
+
+bool CollisionWorld::smParallelNarrowPhase = true;
+U32 CollisionWorld::smMinParallelStates = 8;
+U32 CollisionWorld::smStatesPerJob = 4;
+
+Vector< CollisionWorld::Pair > CollisionWorld::smPairs;
+Vector< U32 > CollisionWorld::smGroups;
+Vector< MatrixF > CollisionWorld::smAXforms;
+Vector< MatrixF > CollisionWorld::smAXformsInv;
+
+
+MODULE_BEGIN( CollisionWorld )
+
+   MODULE_INIT
+   {
+      Con::addVariable( "$Collision::parallelNarrowPhase", TypeBool, &CollisionWorld::smParallelNarrowPhase,
+         "If true, the GJK distance tests of convex collision queries are run on the worker threads.\n"
+         "@ingroup Collision" );
+
+      Con::addVariable( "$Collision::minParallelStates", TypeS32, &CollisionWorld::smMinParallelStates,
+         "Convex collision queries testing fewer states than this are run on the main thread.\n"
+         "@ingroup Collision" );
+
+      Con::addVariable( "$Collision::statesPerJob", TypeS32, &CollisionWorld::smStatesPerJob,
+         "The number of collision states tested by each narrow phase job.\n"
+         "@ingroup Collision" );
+   }
+
+MODULE_END;
+
+
+//----------------------------------------------------------------------------
+
+void CollisionWorld::findClosestStates( Query* queries, U32 numQueries )
+{
+   PROFILE_SCOPE( CollisionWorld_FindClosestStates );
+
+   AssertFatal( ThreadManager::isMainThread(), "CollisionWorld::findClosestStates - Convex state lists may only be changed on the main thread!" );
+
+   // The state lists share the global free lists and convex tags, so
+   // the broad phase stays on this thread.
+   PROFILE_START( CollisionWorld_UpdateStateLists );
+   for ( U32 i = 0; i < numQueries; i++ )
+      queries[ i ].convex->updateStateList( queries[ i ].transform, queries[ i ].scale );
+   PROFILE_END();
+
+   _gatherPairs( queries, numQueries );
+
+   Batch batch;
+   batch.queries = queries;
+   batch.aXforms = smAXforms.address();
+   batch.aXformsInv = smAXformsInv.address();
+   batch.pairs = smPairs.address();
+   batch.groups = smGroups.address();
+
+   const U32 numGroups = smGroups.size();
+   if ( smParallelNarrowPhase && numGroups >= getMax( smMinParallelStates, 2U ) )
+      ThreadPool::GLOBAL().parallelFor( 0, numGroups, getMax( smStatesPerJob, 1U ), &_narrowPhaseJob, &batch );
+   else
+      _narrowPhaseJob( &batch, 0, numGroups );
+
+   // Pick the closest state of each query in state list order, which
+   // is the order findClosestState() has always used.
+   for ( U32 i = 0; i < numQueries; i++ )
+   {
+      queries[ i ].closest = NULL;
+      queries[ i ].distance = 1E30f;
+   }
+
+   for ( U32 i = 0; i < smPairs.size(); i++ )
+   {
+      const Pair &pair = smPairs[ i ];
+      Query &query = queries[ pair.query ];
+      if ( pair.distance < query.distance )
+      {
+         query.distance = pair.distance;
+         query.closest = pair.state;
+      }
+   }
+
+   for ( U32 i = 0; i < numQueries; i++ )
+   {
+      if ( queries[ i ].distance >= queries[ i ].dontCareDist )
+         queries[ i ].closest = NULL;
+   }
+}
+
+void CollisionWorld::_gatherPairs( Query* queries, U32 numQueries )
+{
+   smPairs.clear();
+   smGroups.clear();
+   smAXforms.setSize( numQueries );
+   smAXformsInv.setSize( numQueries );
+
+   // A state can only be shared when both of its convexes are queried.
+   HashTable< CollisionState*, U32 > lastPairOfState;
+   const bool canShare = numQueries > 1;
+
+   for ( U32 i = 0; i < numQueries; i++ )
+   {
+      const Query &query = queries[ i ];
+
+      // Prepare scaled version of transform
+      _scaledTransform( query.transform, query.scale, &smAXforms[ i ], &smAXformsInv[ i ] );
+
+      CollisionStateList *head = &query.convex->mList;
+      for ( CollisionStateList *itr = head->mNext; itr != head; itr = itr->mNext )
+      {
+         Pair pair;
+         pair.state = itr->mState;
+         pair.link = itr;
+         pair.query = i;
+         pair.next = InvalidPair;
+         pair.distance = 1E30f;
+
+         // The other convex is b once the state is oriented for this query.
+         const Convex *other = ( itr->mState->mLista == itr ) ? itr->mState->b : itr->mState->a;
+         _scaledTransform( other->getTransform(), other->getScale(), &pair.bXform, &pair.bXformInv );
+
+         const U32 index = smPairs.size();
+         smPairs.push_back( pair );
+
+         HashTable< CollisionState*, U32 >::Iterator last = canShare ? lastPairOfState.find( pair.state ) : lastPairOfState.end();
+         if ( last != lastPairOfState.end() )
+         {
+            smPairs[ last->value ].next = index;
+            last->value = index;
+         }
+         else
+         {
+            smGroups.push_back( index );
+            if ( canShare )
+               lastPairOfState.insertUnique( pair.state, index );
+         }
+      }
+   }
+}
+
+void CollisionWorld::_scaledTransform( const MatrixF& xform, const Point3F& scale, MatrixF* outXform, MatrixF* outXformInv )
+{
+   *outXform = xform;
+   outXform->scale( scale );
+
+   MatrixF temp( xform );
+   outXformInv->identity();
+   outXformInv->scale( Point3F( 1.0f / scale.x, 1.0f / scale.y, 1.0f / scale.z ) );
+   temp.affineInverse();
+   outXformInv->mul( temp );
+}
+
+void CollisionWorld::_narrowPhaseJob( void* data, U32 begin, U32 end )
+{
+   Batch *batch = reinterpret_cast< Batch* >( data );
+
+   for ( U32 i = begin; i < end; i++ )
+   {
+      // Only this job touches the state, so it can be oriented and
+      // tested in place.
+      for ( U32 p = batch->groups[ i ]; p != InvalidPair; p = batch->pairs[ p ].next )
+      {
+         Pair &pair = batch->pairs[ p ];
+         CollisionState *state = pair.state;
+         if ( state->mLista != pair.link )
+            state->swap();
+
+         const Query &query = batch->queries[ pair.query ];
+         pair.distance = state->distance( batch->aXforms[ pair.query ], pair.bXform, query.dontCareDist,
+            &batch->aXformsInv[ pair.query ], &pair.bXformInv );
+      }
+   }
+}
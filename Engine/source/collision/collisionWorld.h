@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _COLLISIONWORLD_H_
+#define _COLLISIONWORLD_H_
+
+#ifndef _MMATH_H_
+#include "math/mMath.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+class Convex;
+struct CollisionState;
+struct CollisionStateList;
+
+
+//----------------------------------------------------------------------------
+
+/// Runs the narrow phase of convex collision queries.
+///
+/// A query asks for the collision state closest to a Convex placed at a
+/// given transform, the same question Convex::findClosestState() answers.
+/// The state lists of all queries in a batch are brought up to date on the
+/// calling thread first, since they share the global free lists and the
+/// Convex tags.  The GJK distance for every state is then computed on the
+/// ThreadPool.
+///
+/// Work is split by CollisionState and not by query.  A state shared by two
+/// queries of the batch, such as two vehicles touching each other, is run
+/// by one job in query order.  Each state therefore sees the same sequence
+/// of calls it would see if the queries ran one after the other, and the
+/// closest state of each query is picked in state list order on the
+/// calling thread.  Results do not depend on the thread count.
+///
+/// Only Convex::support() runs on the worker threads.  The transforms of
+/// both convexes of every state are fetched on the calling thread, since
+/// some getTransform() implementations return shared scratch matrices.
+/// Implementations of support() must not change any state; shapes
+/// precompute their hull accelerators when their datablocks load.
+///
+/// Convex::findClosestState() submits a batch of one, which is how Vehicle
+/// and RigidShape use it.  A single query is still split by state, so a
+/// vehicle next to many convexes is tested in parallel.  Movers are not
+/// batched together as each one's collision response moves it before the
+/// next one queries.  Player resolves its movement with extruded poly
+/// lists rather than GJK states and does not use this class.  Objects
+/// whose queries do not depend on each other's response can submit them
+/// together with findClosestStates().
+class CollisionWorld
+{
+public:
+
+   struct Query
+   {
+      /// @name Input
+      /// @{
+      Convex* convex;         ///< Convex to test.
+      MatrixF transform;      ///< Transform to test the convex at.
+      Point3F scale;          ///< Scale of the convex.
+      F32 dontCareDist;       ///< States further away than this are ignored.
+      /// @}
+
+      /// @name Output
+      /// @{
+      CollisionState* closest;   ///< Closest state or NULL if none is within dontCareDist.
+      F32 distance;              ///< Distance of the closest state.
+      /// @}
+
+      Query()
+         :  convex( NULL ),
+            transform( true ),
+            scale( 1.0f, 1.0f, 1.0f ),
+            dontCareDist( 1.0f ),
+            closest( NULL ),
+            distance( 1E30f )
+      {
+      }
+   };
+
+   /// Resolve a batch of queries.
+   ///
+   /// All state lists are updated before any distance is computed, so a
+   /// state dropped by a later query in the batch is never tested.
+   static void findClosestStates( Query* queries, U32 numQueries );
+
+   /// If false, the narrow phase is run on the calling thread.
+   static bool smParallelNarrowPhase;
+
+   /// Batches with fewer states than this are run on the calling thread.
+   static U32 smMinParallelStates;
+
+   /// Number of states each narrow phase job handles.
+   static U32 smStatesPerJob;
+
+protected:
+
+   /// A state that has to be tested for a query.
+   struct Pair
+   {
+      CollisionState* state;
+      CollisionStateList* link;  ///< The query convex's link into the state.
+      U32 query;
+      U32 next;                  ///< Next pair of the same state or InvalidPair.
+      F32 distance;
+      MatrixF bXform;            ///< Scaled transform of the other convex.
+      MatrixF bXformInv;         ///< Inverse of bXform.
+   };
+
+   enum { InvalidPair = U32_MAX };
+
+   /// Job data for the narrow phase.
+   struct Batch
+   {
+      const Query* queries;
+      const MatrixF* aXforms;       ///< Scaled query transforms.
+      const MatrixF* aXformsInv;    ///< Inverses of aXforms.
+      Pair* pairs;
+      const U32* groups;            ///< First pair of each distinct state.
+   };
+
+   static void _gatherPairs( Query* queries, U32 numQueries );
+
+   /// Build a scaled transform and its inverse.
+   static void _scaledTransform( const MatrixF& xform, const Point3F& scale, MatrixF* outXform, MatrixF* outXformInv );
+
+   static void _narrowPhaseJob( void* data, U32 begin, U32 end );
+
+   /// Scratch space reused between batches.  Batches are only submitted
+   /// from the main thread.
+   static Vector< Pair > smPairs;
+   static Vector< U32 > smGroups;
+   static Vector< MatrixF > smAXforms;
+   static Vector< MatrixF > smAXformsInv;
+};
+
+#endif // _COLLISIONWORLD_H_
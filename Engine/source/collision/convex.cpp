@@ -28,6 +28,7 @@
 #include "collision/collision.h"
 #include "scene/sceneObject.h"
 #include "collision/gjk.h"
+#include "collision/collisionWorld.h"
 #include "collision/concretePolyList.h"
 #include "platform/profiler.h"
 
@@ -548,47 +549,14 @@ CollisionState* Convex::findClosestState(const MatrixF& mat, const Point3F& scal
 {
    PROFILE_SCOPE( Convex_FindClosestState );
 
-   updateStateList(mat, scale);
-   F32 dist = +1E30f;
-   CollisionState *st = 0;
+   CollisionWorld::Query query;
+   query.convex = this;
+   query.transform = mat;
+   query.scale = scale;
+   query.dontCareDist = dontCareDist;
+   CollisionWorld::findClosestStates(&query, 1);
 
-   // Prepare scaled version of transform
-   MatrixF axform = mat;
-   axform.scale(scale);
-   MatrixF axforminv(true);
-   MatrixF temp(mat);
-   axforminv.scale(Point3F(1.0f/scale.x, 1.0f/scale.y, 1.0f/scale.z));
-   temp.affineInverse();
-   axforminv.mul(temp);
-
-   for (CollisionStateList* itr = mList.mNext; itr != &mList; itr = itr->mNext) 
-   {
-      CollisionState* state = itr->mState;
-      if (state->mLista != itr)
-         state->swap();
-
-      // Prepare scaled version of transform
-      MatrixF bxform = state->b->getTransform();
-      temp = bxform;
-      Point3F bscale = state->b->getScale();
-      bxform.scale(bscale);
-      MatrixF bxforminv(true);
-      bxforminv.scale(Point3F(1.0f/bscale.x, 1.0f/bscale.y, 1.0f/bscale.z));
-      temp.affineInverse();
-      bxforminv.mul(temp);
-
-      //
-      F32 dd = state->distance(axform, bxform, dontCareDist, &axforminv, &bxforminv);
-      if (dd < dist) 
-      {
-         dist = dd;
-         st = state;
-      }
-   }
-   if (dist < dontCareDist)
-      return st;
-   else
-      return NULL;
+   return query.closest;
 }
 
 
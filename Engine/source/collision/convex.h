@@ -165,6 +165,8 @@ struct CollisionWorkingList
 
 class Convex {
 
+   friend class CollisionWorld;
+
    /// @name Linked list management
    /// @{
    
@@ -223,7 +225,9 @@ public:
    /// Returns the list of objects currently inside the bounds of this Convex
    CollisionWorkingList& getWorkingList() { return mWorking; }
 
-   /// Finds the closest
+   /// Finds the closest collision state within dontCareDist of this Convex
+   /// placed at the given transform.
+   /// @see CollisionWorld::findClosestStates
    CollisionState* findClosestState(const MatrixF& mat, const Point3F& scale, const F32 dontCareDist = 1);
 
    /// Returns the list of objects this object is testing against
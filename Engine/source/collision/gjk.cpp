@@ -38,9 +38,6 @@ static F32 sTolerance = 1E-3f;    // Distance tolerance
 static F32 sEpsilon2 = 1E-20f;    // Zero length vector
 static U32 sIteration = 15;       // Stuck in a loop?
 
-S32 num_iterations = 0;
-S32 num_irregularities = 0;
-
 
 //----------------------------------------------------------------------------
 
@@ -273,7 +270,7 @@ void GjkCollisionState::getClosestPoints(Point3F& p1, Point3F& p2)
 
 bool GjkCollisionState::intersect(const MatrixF& a2w, const MatrixF& b2w)
 {
-   num_iterations = 0;
+   U32 numIterations = 0;
    MatrixF w2a,w2b;
 
    w2a = a2w;
@@ -301,19 +298,15 @@ bool GjkCollisionState::intersect(const MatrixF& a2w, const MatrixF& b2w)
       VectorF w = sa - sb;
       if (mDot(v,w) > 0)
          return false;
-      if (degenerate(w)) {
-         ++num_irregularities;
+      if (degenerate(w))
          return false;
-      }
 
       y[last] = w;
       all_bits = bits | last_bit;
 
-      ++num_iterations;
-      if (!closest(v) || num_iterations > sIteration) {
-         ++num_irregularities;
+      ++numIterations;
+      if (!closest(v) || numIterations > sIteration)
          return false;
-      }
    }
    while (bits < 15 && v.lenSquared() > sEpsilon2);
    return true;
@@ -322,7 +315,7 @@ bool GjkCollisionState::intersect(const MatrixF& a2w, const MatrixF& b2w)
 F32 GjkCollisionState::distance(const MatrixF& a2w, const MatrixF& b2w,
    const F32 dontCareDist, const MatrixF* _w2a, const MatrixF* _w2b)
 {
-   num_iterations = 0;
+   U32 numIterations = 0;
    MatrixF w2a,w2b;
 
    if (_w2a == NULL || _w2b == NULL) {
@@ -363,19 +356,15 @@ F32 GjkCollisionState::distance(const MatrixF& a2w, const MatrixF& b2w,
       if (mFabs(dist - mu) <= dist * rel_error)
          return dist;
 
-      ++num_iterations;
-      if (degenerate(w) || num_iterations > sIteration) {
-         ++num_irregularities;
+      ++numIterations;
+      if (degenerate(w) || numIterations > sIteration)
          return dist;
-      }
 
       y[last] = w;
       all_bits = bits | last_bit;
 
-      if (!closest(v)) {
-         ++num_irregularities;
+      if (!closest(v))
          return dist;
-      }
 
       dist = v.len();
    }
@@ -0,0 +1,250 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "collision/collisionWorld.h"
+#include "collision/convex.h"
+
+FIXTURE(CollisionWorld)
+{
+public:
+   /// An oriented box that doesn't need a scene object.
+   class TestConvex : public Convex
+   {
+   public:
+      MatrixF mTransform;
+      Point3F mScale;
+      Box3F mBox;
+
+      TestConvex( const Point3F &pos, const EulerF &rot, const Point3F &halfSize )
+         :  mTransform( rot, pos ),
+            mScale( 1.0f, 1.0f, 1.0f ),
+            mBox( -halfSize, halfSize )
+      {
+         mType = BoxConvexType;
+      }
+
+      CollisionStateList* getStateHead() { return &mList; }
+
+      virtual const MatrixF& getTransform() const { return mTransform; }
+      virtual const Point3F& getScale() const { return mScale; }
+      virtual Box3F getBoundingBox() const { return getBoundingBox( mTransform, mScale ); }
+
+      virtual Box3F getBoundingBox( const MatrixF &mat, const Point3F &scale ) const
+      {
+         Box3F box = mBox;
+         box.minExtents.convolve( scale );
+         box.maxExtents.convolve( scale );
+         mat.mul( box );
+         return box;
+      }
+
+      virtual Point3F support( const VectorF &v ) const
+      {
+         return Point3F( v.x >= 0.0f ? mBox.maxExtents.x : mBox.minExtents.x,
+                         v.y >= 0.0f ? mBox.maxExtents.y : mBox.minExtents.y,
+                         v.z >= 0.0f ? mBox.maxExtents.z : mBox.minExtents.z );
+      }
+   };
+
+   enum
+   {
+      NumQueries = 4,
+      GridSize = 6,
+   };
+
+   Vector< TestConvex* > mConvexes;
+   TestConvex* mQueryConvexes[ NumQueries ];
+   CollisionWorld::Query mQueries[ NumQueries ];
+
+   bool mParallelNarrowPhase;
+   U32 mMinParallelStates;
+   U32 mStatesPerJob;
+
+   virtual void SetUp()
+   {
+      mParallelNarrowPhase = CollisionWorld::smParallelNarrowPhase;
+      mMinParallelStates = CollisionWorld::smMinParallelStates;
+      mStatesPerJob = CollisionWorld::smStatesPerJob;
+
+      // A floor of boxes to drive over.
+      for ( U32 x = 0; x < GridSize; x++ )
+      {
+         for ( U32 y = 0; y < GridSize; y++ )
+         {
+            const Point3F pos( x * 1.5f, y * 1.5f, ( x + y ) % 3 * 0.1f );
+            const EulerF rot( 0.0f, 0.0f, ( x * GridSize + y ) * 0.2f );
+            mConvexes.push_back( new TestConvex( pos, rot, Point3F( 0.5f, 0.5f, 0.5f ) ) );
+         }
+      }
+
+      // Queries 0 and 1 are close enough to share a state.
+      const Point3F queryPos[ NumQueries ] =
+      {
+         Point3F( 2.0f, 2.0f, 1.1f ),
+         Point3F( 3.3f, 2.2f, 1.2f ),
+         Point3F( 5.0f, 6.0f, 0.9f ),
+         Point3F( 30.0f, 30.0f, 30.0f ),
+      };
+
+      for ( U32 i = 0; i < NumQueries; i++ )
+      {
+         const EulerF rot( 0.1f * i, 0.0f, 0.3f * i );
+         mQueryConvexes[ i ] = new TestConvex( queryPos[ i ], rot, Point3F( 0.6f, 0.4f, 0.3f ) );
+
+         CollisionWorld::Query &query = mQueries[ i ];
+         query.convex = mQueryConvexes[ i ];
+         query.transform = mQueryConvexes[ i ]->mTransform;
+         query.scale.set( 1.0f, 1.0f + 0.1f * i, 1.0f );
+         query.dontCareDist = 1.0f;
+      }
+
+      // Every query sees the floor and the other queries.
+      for ( U32 i = 0; i < NumQueries; i++ )
+      {
+         for ( U32 j = 0; j < mConvexes.size(); j++ )
+            mQueryConvexes[ i ]->addToWorkingList( mConvexes[ j ] );
+
+         for ( U32 j = 0; j < NumQueries; j++ )
+         {
+            if ( j != i )
+               mQueryConvexes[ i ]->addToWorkingList( mQueryConvexes[ j ] );
+         }
+      }
+   }
+
+   virtual void TearDown()
+   {
+      CollisionWorld::smParallelNarrowPhase = mParallelNarrowPhase;
+      CollisionWorld::smMinParallelStates = mMinParallelStates;
+      CollisionWorld::smStatesPerJob = mStatesPerJob;
+
+      for ( U32 i = 0; i < NumQueries; i++ )
+         delete mQueryConvexes[ i ];
+      for ( U32 i = 0; i < mConvexes.size(); i++ )
+         delete mConvexes[ i ];
+      mConvexes.clear();
+   }
+
+   /// The serial loop Convex::findClosestState() ran before CollisionWorld.
+   static CollisionState* findClosestSerial( TestConvex *convex, const MatrixF &mat, const Point3F &scale, F32 dontCareDist, F32 *outDist )
+   {
+      MatrixF axform = mat;
+      axform.scale( scale );
+      MatrixF axforminv( true );
+      MatrixF temp( mat );
+      axforminv.scale( Point3F( 1.0f / scale.x, 1.0f / scale.y, 1.0f / scale.z ) );
+      temp.affineInverse();
+      axforminv.mul( temp );
+
+      F32 dist = 1E30f;
+      CollisionState *st = NULL;
+
+      CollisionStateList *head = convex->getStateHead();
+      for ( CollisionStateList *itr = head->mNext; itr != head; itr = itr->mNext )
+      {
+         CollisionState *state = itr->mState;
+         if ( state->mLista != itr )
+            state->swap();
+
+         MatrixF bxform = state->b->getTransform();
+         temp = bxform;
+         Point3F bscale = state->b->getScale();
+         bxform.scale( bscale );
+         MatrixF bxforminv( true );
+         bxforminv.scale( Point3F( 1.0f / bscale.x, 1.0f / bscale.y, 1.0f / bscale.z ) );
+         temp.affineInverse();
+         bxforminv.mul( temp );
+
+         const F32 dd = state->distance( axform, bxform, dontCareDist, &axforminv, &bxforminv );
+         if ( dd < dist )
+         {
+            dist = dd;
+            st = state;
+         }
+      }
+
+      *outDist = dist;
+      return dist < dontCareDist ? st : NULL;
+   }
+
+   void expectMatchesSerial()
+   {
+      for ( U32 i = 0; i < NumQueries; i++ )
+      {
+         const CollisionWorld::Query &query = mQueries[ i ];
+
+         F32 dist;
+         CollisionState *expected = findClosestSerial( mQueryConvexes[ i ], query.transform, query.scale, query.dontCareDist, &dist );
+
+         EXPECT_EQ( expected, query.closest ) << "query " << i;
+         if ( expected != NULL )
+         {
+            EXPECT_FLOAT_EQ( dist, query.distance ) << "query " << i;
+         }
+      }
+   }
+};
+
+TEST_FIX(CollisionWorld, ParallelBatchMatchesSerial)
+{
+   CollisionWorld::smParallelNarrowPhase = true;
+   CollisionWorld::smMinParallelStates = 2;
+   CollisionWorld::smStatesPerJob = 1;
+
+   CollisionWorld::findClosestStates( mQueries, NumQueries );
+
+   EXPECT_TRUE( mQueries[ 0 ].closest != NULL ) << "The query above the floor should touch it";
+   EXPECT_TRUE( mQueries[ 3 ].closest == NULL ) << "The query far away should touch nothing";
+
+   expectMatchesSerial();
+}
+
+TEST_FIX(CollisionWorld, SerialBatchMatchesSerial)
+{
+   CollisionWorld::smParallelNarrowPhase = false;
+
+   CollisionWorld::findClosestStates( mQueries, NumQueries );
+
+   expectMatchesSerial();
+}
+
+TEST_FIX(CollisionWorld, FindClosestStateMatchesBatch)
+{
+   CollisionWorld::smParallelNarrowPhase = true;
+   CollisionWorld::smMinParallelStates = 2;
+   CollisionWorld::smStatesPerJob = 1;
+
+   CollisionWorld::findClosestStates( mQueries, NumQueries );
+
+   for ( U32 i = 0; i < NumQueries; i++ )
+   {
+      const CollisionWorld::Query &query = mQueries[ i ];
+      EXPECT_EQ( query.closest, mQueryConvexes[ i ]->findClosestState( query.transform, query.scale, query.dontCareDist ) )
+         << "query " << i;
+   }
+}
+
+#endif
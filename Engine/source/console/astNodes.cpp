@@ -51,6 +51,24 @@ namespace Compiler
          ip = walk->compileStmt(codeStream, ip);
       return codeStream.tell();
    }
+
+   /// Emit the instruction selecting the non-array variable @a varName,
+   /// using its frame slot if it has one.
+   static void compileSetCurVar(CodeStream &codeStream, StringTableEntry varName, bool create)
+   {
+      const S32 slot = getLocalSlot(varName);
+      if(slot >= 0)
+      {
+         codeStream.emit(create ? OP_SETCURVAR_LOCAL_CREATE : OP_SETCURVAR_LOCAL);
+         codeStream.emitSTE(varName);
+         codeStream.emit(slot);
+      }
+      else
+      {
+         codeStream.emit(create ? OP_SETCURVAR_CREATE : OP_SETCURVAR);
+         codeStream.emitSTE(varName);
+      }
+   }
 }
 
 using namespace Compiler;
@@ -702,7 +720,7 @@ U32 VarNode::compile(CodeStream &codeStream, U32 ip, TypeReq type)
    // OP_LOADVAR (type)
    
    // else
-   // OP_SETCURVAR
+   // OP_SETCURVAR (or OP_SETCURVAR_LOCAL + slot)
    // varName
    // OP_LOADVAR (type)
    
@@ -711,16 +729,18 @@ U32 VarNode::compile(CodeStream &codeStream, U32 ip, TypeReq type)
    
    precompileIdent(varName);
 
-   codeStream.emit(arrayIndex ? OP_LOADIMMED_IDENT : OP_SETCURVAR);
-   codeStream.emitSTE(varName);
-   
    if(arrayIndex)
    {
+      codeStream.emit(OP_LOADIMMED_IDENT);
+      codeStream.emitSTE(varName);
       codeStream.emit(OP_ADVANCE_STR);
       ip = arrayIndex->compile(codeStream, ip, TypeReqString);
       codeStream.emit(OP_REWIND_STR);
       codeStream.emit(OP_SETCURVAR_ARRAY);
    }
+   else
+      compileSetCurVar(codeStream, varName, false);
+
    switch(type)
    {
    case TypeReqUInt:
@@ -948,7 +968,7 @@ U32 AssignExprNode::compile(CodeStream &codeStream, U32 ip, TypeReq type)
    
    //else
    // eval expr
-   // OP_SETCURVAR_CREATE
+   // OP_SETCURVAR_CREATE (or OP_SETCURVAR_LOCAL_CREATE + slot)
    // varname
    // OP_SAVEVAR
    
@@ -972,10 +992,8 @@ U32 AssignExprNode::compile(CodeStream &codeStream, U32 ip, TypeReq type)
          codeStream.emit(OP_TERMINATE_REWIND_STR);
    }
    else
-   {
-      codeStream.emit(OP_SETCURVAR_CREATE);
-      codeStream.emitSTE(varName);
-   }
+      compileSetCurVar(codeStream, varName, true);
+
    switch(subType)
    {
    case TypeReqString:
@@ -1067,7 +1085,7 @@ U32 AssignOpExprNode::compile(CodeStream &codeStream, U32 ip, TypeReq type)
    // OP_SETCURVAR_ARRAY_CREATE
    
    // else
-   // OP_SETCURVAR_CREATE
+   // OP_SETCURVAR_CREATE (or OP_SETCURVAR_LOCAL_CREATE + slot)
    // varName
    
    // OP_LOADVAR_FLT or UINT
@@ -1080,10 +1098,7 @@ U32 AssignOpExprNode::compile(CodeStream &codeStream, U32 ip, TypeReq type)
    
    ip = expr->compile(codeStream, ip, subType);
    if(!arrayIndex)
-   {
-      codeStream.emit(OP_SETCURVAR_CREATE);
-      codeStream.emitSTE(varName);
-   }
+      compileSetCurVar(codeStream, varName, true);
    else
    {
       codeStream.emit(OP_LOADIMMED_IDENT);
@@ -1241,8 +1256,8 @@ U32 SlotAccessNode::compile(CodeStream &codeStream, U32 ip, TypeReq type)
    codeStream.emit(OP_SETCUROBJECT);
    
    codeStream.emit(OP_SETCURFIELD);
-   
    codeStream.emitSTE(slotName);
+   codeStream.emit(allocFieldCache());
 
    if(arrayExpr)
    {
@@ -1346,6 +1361,7 @@ U32 SlotAssignNode::compile(CodeStream &codeStream, U32 ip, TypeReq type)
       codeStream.emit(OP_SETCUROBJECT_NEW);
    codeStream.emit(OP_SETCURFIELD);
    codeStream.emitSTE(slotName);
+   codeStream.emit(allocFieldCache());
 
    if(arrayExpr)
    {
@@ -1412,6 +1428,7 @@ U32 SlotAssignOpNode::compile(CodeStream &codeStream, U32 ip, TypeReq type)
    codeStream.emit(OP_SETCUROBJECT);
    codeStream.emit(OP_SETCURFIELD);
    codeStream.emitSTE(slotName);
+   codeStream.emit(allocFieldCache());
    
    if(arrayExpr)
    {
@@ -1543,15 +1560,18 @@ U32 FunctionDeclStmtNode::compileStmt(CodeStream &codeStream, U32 ip)
    // func end ip
    // argc
    // ident array[argc]
+   // local slot count
    // code
    // OP_RETURN_VOID
    setCurrentStringTable(&getFunctionStringTable());
    setCurrentFloatTable(&getFunctionFloatTable());
+   beginLocalSlots();
    
    argc = 0;
    for(VarNode *walk = args; walk; walk = (VarNode *)((StmtNode*)walk)->getNext())
    {
       precompileIdent(walk->varName);
+      addArgumentSlot(walk->varName);
       argc++;
    }
    
@@ -1575,6 +1595,7 @@ U32 FunctionDeclStmtNode::compileStmt(CodeStream &codeStream, U32 ip)
    {
       codeStream.emitSTE(walk->varName);
    }
+   const U32 slotCountIp = codeStream.emit(0);
    CodeBlock::smInFunction = true;
    ip = compileBlock(stmts, codeStream, ip);
 
@@ -1586,6 +1607,8 @@ U32 FunctionDeclStmtNode::compileStmt(CodeStream &codeStream, U32 ip)
    codeStream.emit(OP_RETURN_VOID);
    
    codeStream.patch(endIp, codeStream.tell());
+   codeStream.patch(slotCountIp, getLocalSlotCount());
+   endLocalSlots();
    
    setCurrentStringTable(&getGlobalStringTable());
    setCurrentFloatTable(&getGlobalFloatTable());
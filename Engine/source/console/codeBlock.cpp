@@ -29,6 +29,7 @@
 #include "core/strings/stringFunctions.h"
 #include "core/stringTable.h"
 #include "core/stream/fileStream.h"
+#include "console/consoleObject.h"
 
 using namespace Compiler;
 
@@ -53,6 +54,8 @@ CodeBlock::CodeBlock()
 
    refCount = 0;
    code = NULL;
+   fieldCacheCount = 0;
+   fieldCaches = NULL;
    name = NULL;
    fullPath = NULL;
    modPath = NULL;
@@ -74,6 +77,7 @@ CodeBlock::~CodeBlock()
    delete[] globalFloats;
    delete[] functionFloats;
    delete[] code;
+   delete[] fieldCaches;
    delete[] breakList;
 }
 
@@ -406,6 +410,10 @@ bool CodeBlock::read(StringTableEntry fileName, Stream &st)
    st.read(&codeLength);
    st.read(&lineBreakPairCount);
 
+   st.read(&fieldCacheCount);
+   if(fieldCacheCount)
+      fieldCaches = new FieldLookupCache[fieldCacheCount];
+
    U32 totSize = codeLength + lineBreakPairCount * 2;
    code = new U32[totSize];
 
@@ -542,6 +550,7 @@ bool CodeBlock::compile(const char *codeFileName, StringTableEntry fileName, con
    U32 totSize = codeSize + codeStream.getNumLineBreaks() * 2;
    st.write(codeSize);
    st.write(lineBreakPairCount);
+   st.write(getFieldCacheCount());
 
    // Write out our bytecode, doing a bit of compression for low numbers.
    U32 i;   
@@ -655,6 +664,10 @@ ConsoleValueRef CodeBlock::compileExec(StringTableEntry fileName, const char *in
 
    globalFloats    = getGlobalFloatTable().build();
    functionFloats  = getFunctionFloatTable().build();
+
+   fieldCacheCount = getFieldCacheCount();
+   if(fieldCacheCount)
+      fieldCaches = new FieldLookupCache[fieldCacheCount];
    
    codeStream.emit(OP_RETURN);
    codeStream.emitCodeStream(&codeSize, &code, &lineBreakPairs);
@@ -738,14 +751,15 @@ void CodeBlock::dumpInstructions( U32 startIp, bool upToReturn )
             bool hasBody = bool(code[ip+6]);
             U32 newIp = code[ ip + 7 ];
             U32 argc = code[ ip + 8 ];
+            U32 numSlots = code[ ip + 9 + (argc * 2) ];
             endFuncIp = newIp;
             
-            Con::printf( "%i: OP_FUNC_DECL name=%s nspace=%s package=%s hasbody=%i newip=%i argc=%i",
-               ip - 1, fnName, fnNamespace, fnPackage, hasBody, newIp, argc );
+            Con::printf( "%i: OP_FUNC_DECL name=%s nspace=%s package=%s hasbody=%i newip=%i argc=%i slots=%i",
+               ip - 1, fnName, fnNamespace, fnPackage, hasBody, newIp, argc, numSlots );
                
-            // Skip args.
+            // Skip args and slot count.
                            
-            ip += 9 + (argc * 2);
+            ip += 10 + (argc * 2);
             smInFunction = true;
             break;
          }
@@ -1025,6 +1039,26 @@ void CodeBlock::dumpInstructions( U32 startIp, bool upToReturn )
             break;
          }
          
+         case OP_SETCURVAR_LOCAL:
+         {
+            StringTableEntry var = CodeToSTE(code, ip);
+            U32 slot = code[ ip + 2 ];
+            
+            Con::printf( "%i: OP_SETCURVAR_LOCAL var=%s slot=%i", ip - 1, var, slot );
+            ip += 3;
+            break;
+         }
+         
+         case OP_SETCURVAR_LOCAL_CREATE:
+         {
+            StringTableEntry var = CodeToSTE(code, ip);
+            U32 slot = code[ ip + 2 ];
+            
+            Con::printf( "%i: OP_SETCURVAR_LOCAL_CREATE var=%s slot=%i", ip - 1, var, slot );
+            ip += 3;
+            break;
+         }
+         
          case OP_SETCURVAR_ARRAY:
          {
             Con::printf( "%i: OP_SETCURVAR_ARRAY", ip - 1 );
@@ -1107,8 +1141,9 @@ void CodeBlock::dumpInstructions( U32 startIp, bool upToReturn )
          case OP_SETCURFIELD:
          {
             StringTableEntry curField = CodeToSTE(code, ip);
-            Con::printf( "%i: OP_SETCURFIELD field=%s", ip - 1, curField );
-            ip += 2;
+            U32 cacheIndex = code[ ip + 2 ];
+            Con::printf( "%i: OP_SETCURFIELD field=%s cache=%i", ip - 1, curField, cacheIndex );
+            ip += 3;
             break;
          }
          
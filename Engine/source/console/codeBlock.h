@@ -29,6 +29,7 @@
 class Stream;
 class ConsoleValue;
 class ConsoleValueRef;
+struct FieldLookupCache;
 
 /// Core TorqueScript code management class.
 ///
@@ -77,6 +78,10 @@ public:
    U32 codeSize;
    U32 *code;
 
+   /// Field lookup caches indexed by the operand of OP_SETCURFIELD.
+   U32 fieldCacheCount;
+   FieldLookupCache *fieldCaches;
+
    U32 refCount;
    U32 lineBreakPairCount;
    U32 *lineBreakPairs;
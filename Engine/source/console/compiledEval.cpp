@@ -258,6 +258,32 @@ inline void ExprEvalState::setCurVarNameCreate(StringTableEntry name)
    }
 }
 
+inline void ExprEvalState::setCurVarLocal(StringTableEntry name, U32 slot)
+{
+   Dictionary& frame = getCurrentFrame();
+   AssertFatal( slot < frame.localSlots.size(), "ExprEvalState::setCurVarLocal - Slot out of range!" );
+
+   Dictionary::Entry*& entry = frame.localSlots[ slot ];
+   if( !entry )
+      entry = frame.lookup(name);
+
+   currentVariable = entry;
+   if(!currentVariable && gWarnUndefinedScriptVariables)
+	   Con::warnf(ConsoleLogEntry::Script, "Variable referenced before assignment: %s", name);
+}
+
+inline void ExprEvalState::setCurVarLocalCreate(StringTableEntry name, U32 slot)
+{
+   Dictionary& frame = getCurrentFrame();
+   AssertFatal( slot < frame.localSlots.size(), "ExprEvalState::setCurVarLocalCreate - Slot out of range!" );
+
+   Dictionary::Entry*& entry = frame.localSlots[ slot ];
+   if( !entry )
+      entry = frame.add(name);
+
+   currentVariable = entry;
+}
+
 //------------------------------------------------------------
 
 inline S32 ExprEvalState::getIntVariable()
@@ -500,10 +526,14 @@ ConsoleValueRef CodeBlock::exec(U32 ip, const char *functionName, Namespace *thi
       gEvalState.pushFrame(thisFunctionName, thisNamespace);
       popFrame = true;
 
+      // The slot count follows the argument names; argument i always
+      // lives in slot i.
+      gEvalState.getCurrentFrame().initLocalSlots(code[ip + (fnArgc * 2) + (2 + 6 + 1)]);
+
       for(i = 0; i < wantedArgc; i++)
       {
          StringTableEntry var = CodeToSTE(code, ip + (2 + 6 + 1) + (i * 2));
-         gEvalState.setCurVarNameCreate(var);
+         gEvalState.setCurVarLocalCreate(var, i);
 
          ConsoleValueRef ref = argv[i+1];
 
@@ -526,7 +556,7 @@ ConsoleValueRef CodeBlock::exec(U32 ip, const char *functionName, Namespace *thi
          }
       }
 
-      ip = ip + (fnArgc * 2) + (2 + 6 + 1);
+      ip = ip + (fnArgc * 2) + (2 + 6 + 2);
       curFloatTable = functionFloats;
       curStringTable = functionStrings;
       curStringTableLen = functionStringsMaxLen;
@@ -583,6 +613,7 @@ ConsoleValueRef CodeBlock::exec(U32 ip, const char *functionName, Namespace *thi
    U32 failJump = 0;
    StringTableEntry prevField = NULL;
    StringTableEntry curField = NULL;
+   FieldLookupCache *curFieldCache = NULL;
    SimObject *prevObject = NULL;
    SimObject *curObject = NULL;
    SimObject *saveObject=NULL;
@@ -1376,6 +1407,38 @@ breakContinue:
             curNSDocBlock = NULL;
             break;
 
+         case OP_SETCURVAR_LOCAL:
+            var = CodeToSTE(code, ip);
+
+            // See OP_SETCURVAR
+            prevField = NULL;
+            prevObject = NULL;
+            curObject = NULL;
+
+            gEvalState.setCurVarLocal(var, code[ip + 2]);
+            ip += 3;
+
+            // See OP_SETCURVAR for why we do this.
+            curFNDocBlock = NULL;
+            curNSDocBlock = NULL;
+            break;
+
+         case OP_SETCURVAR_LOCAL_CREATE:
+            var = CodeToSTE(code, ip);
+
+            // See OP_SETCURVAR
+            prevField = NULL;
+            prevObject = NULL;
+            curObject = NULL;
+
+            gEvalState.setCurVarLocalCreate(var, code[ip + 2]);
+            ip += 3;
+
+            // See OP_SETCURVAR for why we do this.
+            curFNDocBlock = NULL;
+            curNSDocBlock = NULL;
+            break;
+
          case OP_SETCURVAR_ARRAY:
             var = STR.getSTValue();
 
@@ -1493,7 +1556,9 @@ breakContinue:
             dStrcpy( prevFieldArray, curFieldArray );
             curField = CodeToSTE(code, ip);
             curFieldArray[0] = 0;
-            ip += 2;
+            AssertFatal( code[ip + 2] < fieldCacheCount, "CodeBlock::exec - Field cache index out of range!" );
+            curFieldCache = &fieldCaches[ code[ip + 2] ];
+            ip += 3;
             break;
 
          case OP_SETCURFIELD_ARRAY:
@@ -1508,7 +1573,7 @@ breakContinue:
 
          case OP_LOADFIELD_UINT:
             if(curObject)
-               intStack[_UINT+1] = U32(dAtoi(curObject->getDataField(curField, curFieldArray)));
+               intStack[_UINT+1] = U32(dAtoi(curObject->getDataField(curField, curFieldArray, *curFieldCache)));
             else
             {
                // The field is not being retrieved from an object. Maybe it's
@@ -1521,7 +1586,7 @@ breakContinue:
 
          case OP_LOADFIELD_FLT:
             if(curObject)
-               floatStack[_FLT+1] = dAtof(curObject->getDataField(curField, curFieldArray));
+               floatStack[_FLT+1] = dAtof(curObject->getDataField(curField, curFieldArray, *curFieldCache));
             else
             {
                // The field is not being retrieved from an object. Maybe it's
@@ -1535,7 +1600,7 @@ breakContinue:
          case OP_LOADFIELD_STR:
             if(curObject)
             {
-               val = curObject->getDataField(curField, curFieldArray);
+               val = curObject->getDataField(curField, curFieldArray, *curFieldCache);
                STR.setStringValue( val );
             }
             else
@@ -1550,7 +1615,7 @@ breakContinue:
          case OP_SAVEFIELD_UINT:
             STR.setIntValue(intStack[_UINT]);
             if(curObject)
-               curObject->setDataField(curField, curFieldArray, STR.getStringValue());
+               curObject->setDataField(curField, curFieldArray, STR.getStringValue(), *curFieldCache);
             else
             {
                // The field is not being set on an object. Maybe it's
@@ -1563,7 +1628,7 @@ breakContinue:
          case OP_SAVEFIELD_FLT:
             STR.setFloatValue(floatStack[_FLT]);
             if(curObject)
-               curObject->setDataField(curField, curFieldArray, STR.getStringValue());
+               curObject->setDataField(curField, curFieldArray, STR.getStringValue(), *curFieldCache);
             else
             {
                // The field is not being set on an object. Maybe it's
@@ -1575,7 +1640,7 @@ breakContinue:
 
          case OP_SAVEFIELD_STR:
             if(curObject)
-               curObject->setDataField(curField, curFieldArray, STR.getStringValue());
+               curObject->setDataField(curField, curFieldArray, STR.getStringValue(), *curFieldCache);
             else
             {
                // The field is not being set on an object. Maybe it's
@@ -108,6 +108,68 @@ namespace Compiler
          gGlobalStringTable.add(ident);
    }
 
+   //------------------------------------------------------------
+
+   bool gSlotLocalVariables = true;
+
+   static bool gInLocalSlotScope = false;
+   static Vector<StringTableEntry> gLocalSlotNames;
+
+   void beginLocalSlots()
+   {
+      gInLocalSlotScope = gSlotLocalVariables;
+      gLocalSlotNames.clear();
+   }
+
+   void endLocalSlots()
+   {
+      gInLocalSlotScope = false;
+      gLocalSlotNames.clear();
+   }
+
+   void addArgumentSlot(StringTableEntry varName)
+   {
+      // Arguments are not deduplicated; the VM relies on argument i
+      // being bound to slot i.
+      gLocalSlotNames.push_back(varName);
+   }
+
+   S32 getLocalSlot(StringTableEntry varName)
+   {
+      if(!gInLocalSlotScope || !varName || varName[0] != '%')
+         return -1;
+
+      for(U32 i = 0; i < gLocalSlotNames.size(); i++)
+      {
+         if(gLocalSlotNames[i] == varName)
+            return i;
+      }
+
+      gLocalSlotNames.push_back(varName);
+      return gLocalSlotNames.size() - 1;
+   }
+
+   U32 getLocalSlotCount()
+   {
+      return gLocalSlotNames.size();
+   }
+
+   //------------------------------------------------------------
+
+   static U32 gFieldCacheCount = 0;
+
+   U32 allocFieldCache()
+   {
+      return gFieldCacheCount++;
+   }
+
+   U32 getFieldCacheCount()
+   {
+      return gFieldCacheCount;
+   }
+
+   //------------------------------------------------------------
+
    void resetTables()
    {
       setCurrentStringTable(&gGlobalStringTable);
@@ -117,6 +179,8 @@ namespace Compiler
       getFunctionFloatTable().reset();
       getFunctionStringTable().reset();
       getIdentTable().reset();
+      endLocalSlots();
+      gFieldCacheCount = 0;
    }
 
    void *consoleAlloc(U32 size) { return gConsoleAllocator.alloc(size);  }
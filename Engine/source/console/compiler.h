@@ -165,6 +165,9 @@ namespace Compiler
       OP_ITER,             ///< Enter foreach loop.
       OP_ITER_END,         ///< End foreach loop.
 
+      OP_SETCURVAR_LOCAL,        ///< Select a function local through its frame slot.
+      OP_SETCURVAR_LOCAL_CREATE, ///< Select or create a function local through its frame slot.
+
       OP_INVALID   // 90
    };
 
@@ -264,6 +267,47 @@ namespace Compiler
 
    CompilerIdentTable &getIdentTable();
 
+   //------------------------------------------------------------
+
+   /// @name Local Variable Slots
+   ///
+   /// While a function body is compiled, every distinct %local it references
+   /// is given a fixed index into the frame's slot table.  Arguments always
+   /// occupy the first slots in declaration order.  The VM resolves a slot to
+   /// its Dictionary::Entry on first use and indexes the slot afterwards.
+   /// @{
+
+   /// If false, locals are compiled to plain name lookups.
+   extern bool gSlotLocalVariables;
+
+   void beginLocalSlots();
+   void endLocalSlots();
+
+   /// Reserve the next slot for a function argument.
+   void addArgumentSlot(StringTableEntry varName);
+
+   /// Return the slot for the given local or -1 if the variable
+   /// must be resolved by name.
+   S32 getLocalSlot(StringTableEntry varName);
+
+   U32 getLocalSlotCount();
+
+   /// @}
+
+   /// @name Field Lookup Caches
+   ///
+   /// Every OP_SETCURFIELD carries the index of a FieldLookupCache owned by
+   /// the CodeBlock, so field accesses on objects of the same class skip the
+   /// field search.
+   /// @{
+
+   /// Reserve the next field lookup cache of the block being compiled.
+   U32 allocFieldCache();
+
+   U32 getFieldCacheCount();
+
+   /// @}
+
    void precompileIdent(StringTableEntry ident);
 
    /// Helper function to reset the float, string, and ident tables to a base
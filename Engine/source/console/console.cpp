@@ -39,6 +39,8 @@
 #include "console/engineAPI.h"
 #include <stdarg.h>
 #include "platform/threads/mutex.h"
+#include "platform/threads/threadPool.h"
+#include "console/consoleLogQueue.h"
 #include "core/util/journal/journal.h"
 
 extern StringStack STR;
@@ -251,6 +253,21 @@ static bool active = false;
 static bool newLogFile;
 static const char *logFileName;
 
+/// Writes the log file on its own thread when $Con::asyncLog is set.  It is
+/// created the first time it is needed and only deleted on shutdown, so
+/// other threads may hold on to it.
+static ConsoleLogWriter *consoleLogWriter = NULL;
+static bool consoleLogWriterActive = false;
+static bool asyncLog = true;
+static S32 logMaxFileSize = 0;
+static S32 logMaxFiles = 4;
+static S32 logFlushInterval = 100;
+
+/// Lines printed on other threads, waiting to be handed to the consumers
+/// and the log buffer on the main thread.
+static ConsoleLogQueue *threadLogQueue = NULL;
+static volatile U32 threadLogDrainPending = 0;
+
 static const S32 MaxCompletionBufferSize = 4096;
 static char completionBuffer[MaxCompletionBufferSize];
 static char tabBuffer[MaxCompletionBufferSize] = {0};
@@ -287,6 +304,22 @@ DefineConsoleFunction( cls, void, (), , "()"
    consoleLog.setSize(0);
 };
 
+DefineConsoleFunction( flushConsoleLog, void, (), , "()"
+				"@brief Waits until all queued console output has been written to the log file.\n\n"
+				"Only has an effect while $Con::asyncLog is set.\n\n"
+				"@ingroup Console")
+{
+   if(consoleLogWriterActive)
+      consoleLogWriter->flush();
+};
+
+DefineConsoleFunction( getConsoleLogDropped, S32, (), , "()"
+				"@brief Returns the number of console lines the log writer has dropped because its queue was full.\n\n"
+				"@ingroup Console")
+{
+   return consoleLogWriter ? consoleLogWriter->getTotalDropped() : 0;
+};
+
 DefineConsoleFunction( getClipboard, const char*, (), , "()"
 				"@brief Get text from the clipboard.\n\n"
 				"@internal")
@@ -339,6 +372,9 @@ void init()
 	   "@ingroup Console\n");
    addVariable("Con::warnUndefinedVariables", TypeBool, &gWarnUndefinedScriptVariables, "If true, a warning will be displayed in the console whenever a undefined variable is used in script.\n"
 	   "@ingroup Console\n");
+   addVariable("Con::slotLocalVariables", TypeBool, &Compiler::gSlotLocalVariables, "If true, function locals are compiled to frame slots instead of "
+      "being looked up by name on every access. Only affects scripts compiled afterwards.\n"
+	   "@ingroup Console\n");
    addVariable( "instantGroup", TypeRealString, &gInstantGroup, "The group that objects will be added to when they are created.\n"
 	   "@ingroup Console\n");
 
@@ -373,6 +409,19 @@ void init()
    addVariable("Con::useTimestamp", TypeBool, &useTimestamp, "If true a timestamp is prepended to every console message.\n"
 	   "@ingroup Console\n");
 
+   addVariable("Con::asyncLog", TypeBool, &asyncLog, "If true, the log file is written by a background thread instead of on every print. "
+      "Lines are dropped rather than stalling the caller when the thread falls behind. Takes effect the next time the log mode changes.\n"
+	   "@ingroup Console\n");
+   addVariable("Con::logMaxFileSize", TypeS32, &logMaxFileSize, "If greater than zero, the asynchronous log writer starts a new log file once the current one "
+      "would grow beyond this many bytes. The old file is renamed to console.1.log, console.1.log to console.2.log and so on.\n"
+	   "@ingroup Console\n");
+   addVariable("Con::logMaxFiles", TypeS32, &logMaxFiles, "The number of rotated log files to keep. See $Con::logMaxFileSize.\n"
+	   "@ingroup Console\n");
+   addVariable("Con::logFlushInterval", TypeS32, &logFlushInterval, "The longest time in milliseconds a line waits before the asynchronous log writer writes it.\n"
+	   "@ingroup Console\n");
+
+   threadLogQueue = new ConsoleLogQueue;
+
    // Plug us into the journaled console input signal.
    smConsoleInput.notify(postConsoleInput);
 }
@@ -386,6 +435,16 @@ void shutdown()
 
    smConsoleInput.remove(postConsoleInput);
 
+   if(consoleLogWriter)
+   {
+      consoleLogWriter->shutdown();
+      delete consoleLogWriter;
+      consoleLogWriter = NULL;
+      consoleLogWriterActive = false;
+   }
+   delete threadLogQueue;
+   threadLogQueue = NULL;
+
    consoleLogFile.close();
    Namespace::shutdown();
    AbstractClassRep::shutdown();
@@ -534,6 +593,18 @@ U32 tabComplete(char* inputBuffer, U32 cursorPos, U32 maxResultLength, bool forw
 }
 
 //------------------------------------------------------------------------------
+static void writeLogLine(const char *string)
+{
+   if (consoleLogWriterActive)
+   {
+      consoleLogWriter->log(string);
+      return;
+   }
+
+   consoleLogFile.write(dStrlen(string), string);
+   consoleLogFile.write(2, "\r\n");
+}
+
 static void log(const char *string)
 {
    // Bail if we ain't logging.
@@ -542,16 +613,19 @@ static void log(const char *string)
       return;
    }
 
-   // In mode 1, we open, append, close on each log write.
-   if ((consoleLogMode & 0x3) == 1) 
+   // In mode 1, we open, append, close on each log write.  The log writer
+   // does this per batch on its own.
+   const bool reopen = !consoleLogWriterActive && (consoleLogMode & 0x3) == 1;
+   if (reopen) 
    {
       consoleLogFile.open(defLogFileName, Torque::FS::File::ReadWrite);
    }
 
    // Write to the log if its status is hunky-dory.
-   if ((consoleLogFile.getStatus() == Stream::Ok) || (consoleLogFile.getStatus() == Stream::EOS)) 
+   if (consoleLogWriterActive || (consoleLogFile.getStatus() == Stream::Ok) || (consoleLogFile.getStatus() == Stream::EOS)) 
    {
-      consoleLogFile.setPosition(consoleLogFile.getStreamSize());
+      if (!consoleLogWriterActive)
+         consoleLogFile.setPosition(consoleLogFile.getStreamSize());
       // If this is the first write...
       if (newLogFile) 
       {
@@ -559,14 +633,14 @@ static void log(const char *string)
          Platform::LocalTime lt;
          Platform::getLocalTime(lt);
          char buffer[128];
-         dSprintf(buffer, sizeof(buffer), "//-------------------------- %d/%d/%d -- %02d:%02d:%02d -----\r\n",
+         dSprintf(buffer, sizeof(buffer), "//-------------------------- %d/%d/%d -- %02d:%02d:%02d -----",
                lt.month + 1,
                lt.monthday,
                lt.year + 1900,
                lt.hour,
                lt.min,
                lt.sec);
-         consoleLogFile.write(dStrlen(buffer), buffer);
+         writeLogLine(buffer);
          newLogFile = false;
          if (consoleLogMode & 0x4) 
          {
@@ -577,18 +651,16 @@ static void log(const char *string)
             getLockLog(log, size);
             for (line = 0; line < size; line++) 
             {
-               consoleLogFile.write(dStrlen(log[line].mString), log[line].mString);
-               consoleLogFile.write(2, "\r\n");
+               writeLogLine(log[line].mString);
             }
             unlockLog();
          }
       }
       // Now write what we came here to write.
-      consoleLogFile.write(dStrlen(string), string);
-      consoleLogFile.write(2, "\r\n");
+      writeLogLine(string);
    }
 
-   if ((consoleLogMode & 0x3) == 1) 
+   if (reopen) 
    {
       consoleLogFile.close();
    }
@@ -596,29 +668,10 @@ static void log(const char *string)
 
 //------------------------------------------------------------------------------
 
-static void _printf(ConsoleLogEntry::Level level, ConsoleLogEntry::Type type, const char* fmt, va_list argptr)
+/// Hand a formatted message to the consumers, the log buffer and, if
+/// @a writeFile is set, the log file.  Main thread only.
+static void _dispatch(ConsoleLogEntry::Level level, ConsoleLogEntry::Type type, char *buffer, bool writeFile)
 {
-   if (!active)
-	   return;
-   Con::active = false; 
-
-   char buffer[8192];
-   U32 offset = 0;
-   if( gEvalState.traceOn && gEvalState.getStackDepth() > 0 )
-   {
-      offset = gEvalState.getStackDepth() * 3;
-      for(U32 i = 0; i < offset; i++)
-         buffer[i] = ' ';
-   }
-
-   if (useTimestamp)
-   {
-      static U32 startTime = Platform::getRealMilliseconds();
-      U32 curTime = Platform::getRealMilliseconds() - startTime;
-      offset += dSprintf(buffer + offset, sizeof(buffer) - offset, "[+%4d.%03d]", U32(curTime * 0.001), curTime % 1000);
-   }
-   dVsprintf(buffer + offset, sizeof(buffer) - offset, fmt, argptr);
-
    for(S32 i = 0; i < gConsumers.size(); i++)
       gConsumers[i](level, buffer);
 
@@ -639,7 +692,8 @@ static void _printf(ConsoleLogEntry::Level level, ConsoleLogEntry::Type type, co
          if(eofPos)
             *eofPos = 0;
 
-         log(pos);
+         if(writeFile)
+            log(pos);
          if(logBufferEnabled && !consoleLogLocked)
          {
             ConsoleLogEntry entry;
@@ -665,6 +719,125 @@ static void _printf(ConsoleLogEntry::Level level, ConsoleLogEntry::Type type, co
          pos = eofPos + 1;
       }
    }
+}
+
+static U32 _printTimestamp(char *buffer, U32 size)
+{
+   static U32 startTime = Platform::getRealMilliseconds();
+   U32 curTime = Platform::getRealMilliseconds() - startTime;
+   return dSprintf(buffer, size, "[+%4d.%03d]", U32(curTime * 0.001), curTime % 1000);
+}
+
+/// Hands the messages printed on other threads to the main thread.
+///
+/// Each queued message starts with three characters: the level, the type
+/// and whether the message already went to the log writer.
+static void _drainThreadLog()
+{
+   Vector<char> text;
+   for(;;)
+   {
+      text.clear();
+      if(!threadLogQueue->pop(text))
+         break;
+      text.push_back(0);
+
+      const ConsoleLogEntry::Level level = (ConsoleLogEntry::Level)(text[0] - '0');
+      const ConsoleLogEntry::Type type = (ConsoleLogEntry::Type)(text[1] - '0');
+      const bool written = text[2] == '1';
+
+      Con::active = false;
+      _dispatch(level, type, text.address() + 3, !written);
+      Con::active = true;
+   }
+
+   const U32 dropped = threadLogQueue->takeDropped();
+   if(dropped)
+      Con::warnf("Con - %d messages printed on other threads were dropped.", dropped);
+}
+
+struct ThreadLogDrainItem : public ThreadPool::WorkItem
+{
+   virtual void execute()
+   {
+      dCompareAndSwap(threadLogDrainPending, 1, 0);
+      if(active)
+         _drainThreadLog();
+   }
+};
+
+/// Print from a thread other than the main thread.  The message goes to
+/// the log writer right away and to the rest on the main thread.
+static void _printfThreaded(ConsoleLogEntry::Level level, ConsoleLogEntry::Type type, const char* fmt, va_list argptr)
+{
+   char buffer[8192];
+   buffer[0] = '0' + level;
+   buffer[1] = '0' + type;
+   buffer[2] = '0';
+
+   U32 offset = 3;
+   if (useTimestamp)
+      offset += _printTimestamp(buffer + offset, sizeof(buffer) - offset);
+   dVsprintf(buffer + offset, sizeof(buffer) - offset, fmt, argptr);
+
+   if(consoleLogMode && consoleLogWriterActive)
+   {
+      // Same line splitting as _dispatch(), on a copy.
+      char line[8192];
+      dStrcpy(line, buffer + 3);
+      for(char *pos = line; *pos; pos++)
+      {
+         if(*pos == '\t')
+            *pos = '^';
+      }
+
+      char *pos = line;
+      for(;;)
+      {
+         char *eofPos = dStrchr(pos, '\n');
+         if(eofPos)
+            *eofPos = 0;
+         consoleLogWriter->log(pos);
+         if(!eofPos)
+            break;
+         pos = eofPos + 1;
+      }
+
+      buffer[2] = '1';
+   }
+
+   threadLogQueue->push(buffer, dStrlen(buffer));
+   if(dCompareAndSwap(threadLogDrainPending, 0, 1))
+      ThreadPool::queueWorkItemOnMainThread(new ThreadLogDrainItem);
+}
+
+static void _printf(ConsoleLogEntry::Level level, ConsoleLogEntry::Type type, const char* fmt, va_list argptr)
+{
+   if (!active)
+	   return;
+
+   if (!isMainThread())
+   {
+      _printfThreaded(level, type, fmt, argptr);
+      return;
+   }
+
+   Con::active = false; 
+
+   char buffer[8192];
+   U32 offset = 0;
+   if( gEvalState.traceOn && gEvalState.getStackDepth() > 0 )
+   {
+      offset = gEvalState.getStackDepth() * 3;
+      for(U32 i = 0; i < offset; i++)
+         buffer[i] = ' ';
+   }
+
+   if (useTimestamp)
+      offset += _printTimestamp(buffer + offset, sizeof(buffer) - offset);
+   dVsprintf(buffer + offset, sizeof(buffer) - offset, fmt, argptr);
+
+   _dispatch(level, type, buffer, true);
 
    Con::active = true;
 }
@@ -1676,10 +1849,34 @@ void setLogMode(S32 newMode)
          // Enabling logging when it was previously disabled.
          newLogFile = true;
       }
+      if (consoleLogWriterActive) {
+         // Write out what is queued and stop the writer thread.
+         consoleLogWriter->shutdown();
+         consoleLogWriterActive = false;
+      }
       if ((consoleLogMode & 0x3) == 2) {
          // Changing away from mode 2, must close logfile.
          consoleLogFile.close();
       }
+      if ((newMode & 0x3) && asyncLog) {
+         // Hand the file to the log writer.  Mode 2 keeps it open and
+         // starts it empty, mode 1 appends and closes it after every batch.
+         ConsoleLogWriter::Settings settings;
+         settings.mFileName = defLogFileName;
+         settings.mTruncate = (newMode & 0x3) == 2;
+         settings.mKeepOpen = (newMode & 0x3) == 2;
+         settings.mMaxFileSize = getMax(logMaxFileSize, 0);
+         settings.mMaxFiles = getMax(logMaxFiles, 0);
+         settings.mFlushIntervalMS = getMax(logFlushInterval, 1);
+
+         if (!consoleLogWriter)
+            consoleLogWriter = new ConsoleLogWriter(settings);
+         else
+            consoleLogWriter->setSettings(settings);
+
+         consoleLogWriter->start();
+         consoleLogWriterActive = true;
+      }
       else if ((newMode & 0x3) == 2) {
 #ifdef _XBOX
          // Xbox is not going to support logging to a file. Use the OutputDebugStr
@@ -354,6 +354,22 @@ void Dictionary::remove(Dictionary::Entry *ent)
    hashTable->mChunker.free( ent );
 
    hashTable->count--;
+
+   // Frames sharing this table may have the entry cached in a slot.
+   if( exprState )
+      exprState->invalidateLocalSlots( hashTable );
+}
+
+void Dictionary::initLocalSlots(U32 count)
+{
+   localSlots.setSize( count );
+   clearLocalSlots();
+}
+
+void Dictionary::clearLocalSlots()
+{
+   if( localSlots.size() )
+      dMemset( localSlots.address(), 0, localSlots.size() * sizeof( Entry* ) );
 }
 
 Dictionary::Dictionary()
@@ -403,6 +419,7 @@ void Dictionary::reset()
    if( hashTable && hashTable->owner != this )
    {
       hashTable = NULL;
+      localSlots.clear();
       return;
    }
       
@@ -422,6 +439,7 @@ void Dictionary::reset()
    
    ownHashTable.count = 0;
    hashTable = NULL;
+   localSlots.clear();
    
    scopeName = NULL;
    scopeNamespace = NULL;
@@ -829,6 +847,15 @@ void ExprEvalState::pushFrameRef(S32 stackIndex)
    #endif
 }
 
+void ExprEvalState::invalidateLocalSlots(Dictionary::HashTableData* table)
+{
+   for( U32 i = 0; i < mStackDepth; ++ i )
+   {
+      if( stack[ i ]->hashTable == table )
+         stack[ i ]->clearLocalSlots();
+   }
+}
+
 ExprEvalState::ExprEvalState()
 {
    VECTOR_SET_ASSOCIATION(stack);
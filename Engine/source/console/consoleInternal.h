@@ -421,6 +421,10 @@ public:
    CodeBlock *code;
    U32 ip;
 
+   /// Entries of the %locals of the function running in this frame, indexed
+   /// by the slots the compiler assigned.  Filled lazily by the VM.
+   Vector< Entry* > localSlots;
+
    Dictionary();
    ~Dictionary();
 
@@ -430,6 +434,12 @@ public:
    void remove(Entry *);
    void reset();
 
+   /// Size the local slot table for a function with @a count slots.
+   void initLocalSlots(U32 count);
+
+   /// Forget every cached local slot entry.
+   void clearLocalSlots();
+
    void exportVariables( const char *varString, const char *fileName, bool append );
    void exportVariables( const char *varString, Vector<String> *names, Vector<String> *values );
    void deleteVariables( const char *varString );
@@ -504,6 +514,8 @@ public:
 
    void setCurVarName(StringTableEntry name);
    void setCurVarNameCreate(StringTableEntry name);
+   void setCurVarLocal(StringTableEntry name, U32 slot);
+   void setCurVarLocalCreate(StringTableEntry name, U32 slot);
 
    S32 getIntVariable();
    F64 getFloatVariable();
@@ -520,6 +532,10 @@ public:
    /// Puts a reference to an existing stack frame
    /// on the top of the stack.
    void pushFrameRef(S32 stackIndex);
+
+   /// Drop the cached local slots of every frame using the given hash table.
+   /// Called when an entry is removed from it.
+   void invalidateLocalSlots(Dictionary::HashTableData* table);
  
    U32 getStackDepth() const
    {
@@ -0,0 +1,342 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "console/consoleLogQueue.h"
+
+#include "core/volume.h"
+#include "core/util/path.h"
+#include "core/strings/stringFunctions.h"
+
+
+//-----------------------------------------------------------------------------
+// ConsoleLogQueue.
+//-----------------------------------------------------------------------------
+
+ConsoleLogQueue::ConsoleLogQueue()
+   :  mEnqueuePos( 0 ),
+      mDequeuePos( 0 ),
+      mDropped( 0 ),
+      mTotalDropped( 0 )
+{
+   mSlots = new Slot[ NumSlots ];
+   for( U32 i = 0; i < NumSlots; i ++ )
+      mSlots[ i ].mSequence = i;
+}
+
+ConsoleLogQueue::~ConsoleLogQueue()
+{
+   delete [] mSlots;
+}
+
+bool ConsoleLogQueue::push( const char* line, U32 length )
+{
+   if( length > SlotTextSize * MaxSlotsPerLine )
+      length = SlotTextSize * MaxSlotsPerLine;
+
+   const U32 numSlots = length ? ( length + SlotTextSize - 1 ) / SlotTextSize : 1;
+
+   // Claim all slots of the line at once, so lines from different threads
+   // never interleave.
+   U32 pos;
+   for( ;; )
+   {
+      pos = dAtomicRead( mEnqueuePos );
+
+      bool stale = false;
+      for( U32 i = 0; i < numSlots; i ++ )
+      {
+         const U32 slotPos = pos + i;
+         const S32 diff = S32( dAtomicRead( mSlots[ slotPos & ( NumSlots - 1 ) ].mSequence ) - slotPos );
+
+         if( diff < 0 )
+         {
+            // The slot still holds a line the consumer has not read.
+            dFetchAndAdd( mDropped, 1 );
+            dFetchAndAdd( mTotalDropped, 1 );
+            return false;
+         }
+         else if( diff > 0 )
+         {
+            // Another producer got here first.
+            stale = true;
+            break;
+         }
+      }
+
+      if( !stale && dCompareAndSwap( mEnqueuePos, pos, pos + numSlots ) )
+         break;
+   }
+
+   for( U32 i = 0; i < numSlots; i ++ )
+   {
+      const U32 slotPos = pos + i;
+      Slot& slot = mSlots[ slotPos & ( NumSlots - 1 ) ];
+
+      const U32 chunk = getMin( length, ( U32 ) SlotTextSize );
+      dMemcpy( slot.mText, line, chunk );
+      slot.mLength = chunk;
+      slot.mMore = ( i + 1 < numSlots );
+
+      line += chunk;
+      length -= chunk;
+
+      // Hand the slot to the consumer.
+      dCompareAndSwap( slot.mSequence, slotPos, slotPos + 1 );
+   }
+
+   return true;
+}
+
+bool ConsoleLogQueue::pop( Vector< char >& outText )
+{
+   const U32 startPos = mDequeuePos;
+   U32 pos = startPos;
+
+   Slot* slot = &mSlots[ pos & ( NumSlots - 1 ) ];
+   if( dAtomicRead( slot->mSequence ) != pos + 1 )
+      return false;
+
+   for( ;; )
+   {
+      outText.merge( slot->mText, slot->mLength );
+      const bool more = slot->mMore;
+
+      // Free the slot for the next round.
+      dCompareAndSwap( slot->mSequence, pos + 1, pos + NumSlots );
+      pos ++;
+
+      if( !more )
+         break;
+
+      // The rest of the line was claimed together with its first slot, so
+      // the producer is busy copying it.
+      slot = &mSlots[ pos & ( NumSlots - 1 ) ];
+      while( dAtomicRead( slot->mSequence ) != pos + 1 )
+         Platform::sleep( 0 );
+   }
+
+   dFetchAndAdd( mDequeuePos, pos - startPos );
+   return true;
+}
+
+U32 ConsoleLogQueue::getNumPending() const
+{
+   return getEnqueuePos() - getDequeuePos();
+}
+
+U32 ConsoleLogQueue::takeDropped()
+{
+   for( ;; )
+   {
+      const U32 dropped = dAtomicRead( mDropped );
+      if( !dropped || dCompareAndSwap( mDropped, dropped, 0 ) )
+         return dropped;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// ConsoleLogWriter.
+//-----------------------------------------------------------------------------
+
+ConsoleLogWriter::ConsoleLogWriter( const Settings& settings )
+   :  mSettings( settings ),
+      mWakeup( 0 ),
+      mWakePending( 0 ),
+      mWrittenPos( 0 ),
+      mStreamOpen( false ),
+      mFileSize( 0 ),
+      mTruncateNext( settings.mTruncate )
+{
+}
+
+ConsoleLogWriter::~ConsoleLogWriter()
+{
+   shutdown();
+}
+
+bool ConsoleLogWriter::log( const char* line )
+{
+   if( !mQueue.push( line, dStrlen( line ) ) )
+   {
+      _wake();
+      return false;
+   }
+
+   // Don't wait for the interval if the queue is filling up.
+   if( mQueue.getNumPending() >= ConsoleLogQueue::NumSlots / 2 )
+      _wake();
+
+   return true;
+}
+
+void ConsoleLogWriter::flush( S32 timeoutMS )
+{
+   if( !isAlive() )
+      return;
+
+   const U32 target = mQueue.getEnqueuePos();
+   const U32 endTime = Platform::getRealMilliseconds() + timeoutMS;
+
+   _wake();
+   while( S32( dAtomicRead( mWrittenPos ) - target ) < 0 )
+   {
+      if( timeoutMS != -1 && Platform::getRealMilliseconds() >= endTime )
+         break;
+
+      Platform::sleep( 1 );
+   }
+}
+
+void ConsoleLogWriter::shutdown()
+{
+   if( !isAlive() )
+      return;
+
+   stop();
+   mWakeup.release();
+   join();
+}
+
+void ConsoleLogWriter::setSettings( const Settings& settings )
+{
+   AssertFatal( !isAlive(), "ConsoleLogWriter::setSettings - Cannot change the settings while the writer is running!" );
+
+   mSettings = settings;
+   mTruncateNext = settings.mTruncate;
+}
+
+void ConsoleLogWriter::_wake()
+{
+   if( dCompareAndSwap( mWakePending, 0, 1 ) )
+      mWakeup.release();
+}
+
+void ConsoleLogWriter::run( void* arg )
+{
+   while( !checkForStop() )
+   {
+      mWakeup.acquire( true, mSettings.mFlushIntervalMS );
+      dCompareAndSwap( mWakePending, 1, 0 );
+
+      _drain();
+   }
+
+   // Write out what was queued before we were asked to stop.
+   _drain();
+   _closeFile();
+}
+
+void ConsoleLogWriter::_drain()
+{
+   mBatch.clear();
+
+   const U32 dropped = mQueue.takeDropped();
+   if( dropped )
+   {
+      char buffer[ 128 ];
+      dSprintf( buffer, sizeof( buffer ), "[Console log queue full, %d lines dropped]\r\n", dropped );
+      mBatch.merge( buffer, dStrlen( buffer ) );
+   }
+
+   while( mQueue.pop( mBatch ) )
+      mBatch.merge( "\r\n", 2 );
+
+   const U32 pos = mQueue.getDequeuePos();
+
+   if( !mBatch.empty() )
+   {
+      if( mSettings.mMaxFileSize && mFileSize && mFileSize + mBatch.size() > mSettings.mMaxFileSize )
+         _rotate();
+
+      if( _openFile() )
+      {
+         mStream.write( mBatch.size(), mBatch.address() );
+         mStream.flush();
+         mFileSize += mBatch.size();
+
+         if( !mSettings.mKeepOpen )
+            _closeFile();
+      }
+   }
+
+   // Only this thread writes the position.
+   dCompareAndSwap( mWrittenPos, dAtomicRead( mWrittenPos ), pos );
+}
+
+bool ConsoleLogWriter::_openFile()
+{
+   if( mStreamOpen )
+      return true;
+
+   if( mTruncateNext )
+   {
+      mStreamOpen = mStream.open( mSettings.mFileName, Torque::FS::File::Write );
+      mFileSize = 0;
+      mTruncateNext = false;
+   }
+   else
+   {
+      mStreamOpen = mStream.open( mSettings.mFileName, Torque::FS::File::ReadWrite );
+      if( mStreamOpen )
+      {
+         mFileSize = mStream.getStreamSize();
+         mStream.setPosition( mFileSize );
+      }
+   }
+
+   return mStreamOpen;
+}
+
+void ConsoleLogWriter::_closeFile()
+{
+   if( !mStreamOpen )
+      return;
+
+   mStream.close();
+   mStreamOpen = false;
+}
+
+String ConsoleLogWriter::_getRotatedFileName( U32 index ) const
+{
+   Torque::Path path( mSettings.mFileName );
+   path.setFileName( String::ToString( "%s.%d", path.getFileName().c_str(), index ) );
+   return path.getFullPath();
+}
+
+void ConsoleLogWriter::_rotate()
+{
+   _closeFile();
+
+   if( mSettings.mMaxFiles )
+   {
+      // Shift the older files up and drop the oldest one.
+      Torque::FS::Remove( _getRotatedFileName( mSettings.mMaxFiles ) );
+      for( U32 i = mSettings.mMaxFiles - 1; i > 0; i -- )
+         Torque::FS::Rename( _getRotatedFileName( i ), _getRotatedFileName( i + 1 ) );
+
+      Torque::FS::Rename( mSettings.mFileName, _getRotatedFileName( 1 ) );
+   }
+
+   mTruncateNext = true;
+   mFileSize = 0;
+}
@@ -0,0 +1,238 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _CONSOLELOGQUEUE_H_
+#define _CONSOLELOGQUEUE_H_
+
+#ifndef _PLATFORM_THREADS_THREAD_H_
+#include "platform/threads/thread.h"
+#endif
+#ifndef _PLATFORMINTRINSICS_H_
+#include "platform/platformIntrinsics.h"
+#endif
+#ifndef _PLATFORM_THREAD_SEMAPHORE_H_
+#include "platform/threads/semaphore.h"
+#endif
+#ifndef _FILESTREAM_H_
+#include "core/stream/fileStream.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+/// Bounded queue of console log lines with many producers and one consumer.
+///
+/// Lines are copied into fixed size slots.  A line longer than a slot takes
+/// several consecutive slots, which a producer claims at once with a single
+/// compare-and-swap on the enqueue position.  Each slot carries a sequence
+/// number that tells whether it is free, being written or ready, so neither
+/// side ever takes a lock.
+///
+/// When the queue is full the line is dropped and counted instead of
+/// waiting for the consumer.
+class ConsoleLogQueue
+{
+public:
+
+   enum
+   {
+      /// Number of slots.  Must be a power of two.
+      NumSlots = 4096,
+
+      /// Text stored in one slot.
+      SlotTextSize = 248,
+
+      /// Most slots a single line may take.  Longer lines are truncated.
+      MaxSlotsPerLine = 32,
+   };
+
+protected:
+
+   struct Slot
+   {
+      /// Equal to the position of the slot when it is free, to the position
+      /// plus one when it holds a line for the consumer.
+      volatile U32 mSequence;
+
+      U16 mLength;
+
+      /// True if the line continues in the next slot.
+      bool mMore;
+
+      char mText[ SlotTextSize ];
+   };
+
+   /// Next position producers claim.
+   volatile U32 mEnqueuePos;
+   U8 mEnqueuePad[ 64 - sizeof( U32 ) ];
+
+   /// Next position the consumer reads.  Only written by the consumer.
+   volatile U32 mDequeuePos;
+   U8 mDequeuePad[ 64 - sizeof( U32 ) ];
+
+   /// Lines dropped since the consumer last asked.
+   volatile U32 mDropped;
+
+   /// Lines dropped over the life of the queue.
+   volatile U32 mTotalDropped;
+
+   Slot* mSlots;
+
+public:
+
+   ConsoleLogQueue();
+   ~ConsoleLogQueue();
+
+   /// Queue a line.  Safe to call from any thread.
+   /// @return false if the queue was full and the line was dropped.
+   bool push( const char* line, U32 length );
+
+   /// Append the next line to @a outText without a terminator.  Must only
+   /// be called by the consumer.
+   /// @return false if the queue is empty.
+   bool pop( Vector< char >& outText );
+
+   /// Number of slots in use.
+   U32 getNumPending() const;
+
+   /// Position the next pushed line will get.  The consumer has read every
+   /// line pushed before once getDequeuePos() has reached it.
+   U32 getEnqueuePos() const { return dAtomicRead( const_cast< volatile U32& >( mEnqueuePos ) ); }
+   U32 getDequeuePos() const { return dAtomicRead( const_cast< volatile U32& >( mDequeuePos ) ); }
+
+   /// Return the number of lines dropped since the last call and reset it.
+   U32 takeDropped();
+
+   /// Return the number of lines dropped since the queue was created.
+   U32 getTotalDropped() const { return dAtomicRead( const_cast< volatile U32& >( mTotalDropped ) ); }
+};
+
+
+/// Thread that writes the console log file.
+///
+/// Any thread may queue lines with log().  The writer wakes up periodically,
+/// or once the queue is half full, and writes everything queued so far with
+/// a single write to the file.  The file can be rotated once it grows past
+/// a size limit: "console.log" becomes "console.1.log" and so on, and the
+/// oldest file is deleted.
+class ConsoleLogWriter : public Thread
+{
+public:
+
+   typedef Thread Parent;
+
+   struct Settings
+   {
+      /// Full path of the log file.
+      String mFileName;
+
+      /// Empty the file when the writer starts instead of appending to it.
+      bool mTruncate;
+
+      /// Keep the file open between batches.  If false, it is opened and
+      /// closed for every batch.
+      bool mKeepOpen;
+
+      /// Rotate the file once it is larger than this.  Zero disables rotation.
+      U32 mMaxFileSize;
+
+      /// Number of rotated files to keep.
+      U32 mMaxFiles;
+
+      /// Longest time a line waits in the queue, in milliseconds.
+      U32 mFlushIntervalMS;
+
+      Settings()
+         :  mTruncate( false ),
+            mKeepOpen( true ),
+            mMaxFileSize( 0 ),
+            mMaxFiles( 4 ),
+            mFlushIntervalMS( 100 )
+      {
+      }
+   };
+
+protected:
+
+   Settings mSettings;
+   ConsoleLogQueue mQueue;
+
+   /// Signalled to wake the writer up early.
+   Semaphore mWakeup;
+
+   /// Set while a wake up is pending so bursts of lines only signal once.
+   volatile U32 mWakePending;
+
+   /// Queue position up to which lines have been handed to the file.
+   volatile U32 mWrittenPos;
+
+   /// @name Writer Thread State
+   /// @{
+
+   FileStream mStream;
+   bool mStreamOpen;
+   U32 mFileSize;
+   bool mTruncateNext;
+   Vector< char > mBatch;
+
+   /// @}
+
+   void _wake();
+   bool _openFile();
+   void _closeFile();
+   void _rotate();
+   void _drain();
+
+   /// Return the name of the rotated file with the given index.
+   String _getRotatedFileName( U32 index ) const;
+
+public:
+
+   ConsoleLogWriter( const Settings& settings );
+   virtual ~ConsoleLogWriter();
+
+   /// Queue a line for the file.  Safe to call from any thread.
+   /// @return false if the line was dropped because the queue was full.
+   bool log( const char* line );
+
+   /// Wait until every line queued before the call has been written.
+   /// @param timeoutMS Time to wait at most, or -1 to wait until done.
+   void flush( S32 timeoutMS = -1 );
+
+   /// Write out everything queued and stop the thread.
+   void shutdown();
+
+   const Settings& getSettings() const { return mSettings; }
+
+   /// Change the settings.  The thread must not be running.  Lines queued in
+   /// the meantime are written to the new file once the thread is started.
+   void setSettings( const Settings& settings );
+
+   /// Number of lines dropped because the queue was full.
+   U32 getTotalDropped() const { return mQueue.getTotalDropped(); }
+
+   // Thread.
+   virtual void run( void* arg = 0 );
+};
+
+#endif // _CONSOLELOGQUEUE_H_
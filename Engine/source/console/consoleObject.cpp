@@ -90,11 +90,57 @@ void AbstractClassRep::init()
    }
 }
 
+static inline U32 hashFieldName(StringTableEntry name)
+{
+   return U32( ( (dsize_t)name >> 2 ) * 2654435761u );
+}
+
+void AbstractClassRep::_buildFieldHash()
+{
+   U32 tableSize = 16;
+   while( tableSize < mFieldList.size() * 2 )
+      tableSize <<= 1;
+
+   mFieldHash.setSize( tableSize );
+   for( U32 i = 0; i < tableSize; i++ )
+      mFieldHash[ i ] = -1;
+
+   const U32 mask = tableSize - 1;
+   for( U32 i = 0; i < mFieldList.size(); i++ )
+   {
+      StringTableEntry name = mFieldList[ i ].pFieldname;
+      U32 slot = hashFieldName( name ) & mask;
+
+      // Keep the first occurrence of a name like the linear search did.
+      bool duplicate = false;
+      while( mFieldHash[ slot ] != -1 )
+      {
+         if( mFieldList[ mFieldHash[ slot ] ].pFieldname == name )
+         {
+            duplicate = true;
+            break;
+         }
+         slot = ( slot + 1 ) & mask;
+      }
+
+      if( !duplicate )
+         mFieldHash[ slot ] = i;
+   }
+}
+
 const AbstractClassRep::Field *AbstractClassRep::findField(StringTableEntry name) const
 {
-   for(U32 i = 0; i < mFieldList.size(); i++)
-      if(mFieldList[i].pFieldname == name)
-         return &mFieldList[i];
+   if( mFieldList.empty() )
+      return NULL;
+
+   AssertFatal( !mFieldHash.empty(), "AbstractClassRep::findField - Field hash not built; class not registered?" );
+
+   const U32 mask = mFieldHash.size() - 1;
+   for( U32 slot = hashFieldName( name ) & mask; mFieldHash[ slot ] != -1; slot = ( slot + 1 ) & mask )
+   {
+      if( mFieldList[ mFieldHash[ slot ] ].pFieldname == name )
+         return &mFieldList[ mFieldHash[ slot ] ];
+   }
 
    return NULL;
 }
@@ -227,6 +273,9 @@ void AbstractClassRep::initialize()
 
       // And of course delete it every round.
       sg_tempFieldList.clear();
+
+      // Build the field lookup hash up front.
+      walk->_buildFieldHash();
    }
 
    // Calculate counts and bit sizes for the various NetClasses.
@@ -94,6 +94,7 @@ enum NetDirection
 class SimObject;
 class TypeValidator;
 class ConsoleClassObject;
+struct FieldLookupCache;
 
 DECLARE_SCOPE( ConsoleAPI );
 
@@ -519,6 +520,23 @@ public:
 
    const Field* findField( StringTableEntry fieldName ) const;
 
+   /// Look up a field through an inline cache.  The cache is refreshed
+   /// whenever it was filled for a different class or field name.
+   const Field* findField( StringTableEntry fieldName, FieldLookupCache& cache ) const;
+
+protected:
+
+   /// Open addressed hash of mFieldList indices keyed on the field name.
+   ///
+   /// Built once when the class is registered with the console, before any
+   /// lookups can happen, so findField() only ever reads it and is safe to
+   /// call from several threads.
+   Vector< S32 > mFieldHash;
+
+   void _buildFieldHash();
+
+public:
+
    /// @}
 
    /// @name Console Type Interface
@@ -559,6 +577,35 @@ public:
 extern AbstractClassRep::FieldList sg_tempFieldList;
 
 
+/// Remembers the result of a field lookup for one class.
+///
+/// The script VM keeps one of these per field access instruction so that
+/// repeated accesses on objects of the same class skip the field search.
+struct FieldLookupCache
+{
+   const AbstractClassRep* mClassRep;
+   StringTableEntry mFieldName;
+
+   /// The static field or NULL if the name does not refer to one, in which
+   /// case the access goes straight to the dynamic fields.
+   const AbstractClassRep::Field* mField;
+
+   FieldLookupCache()
+      : mClassRep( NULL ), mFieldName( NULL ), mField( NULL ) {}
+};
+
+inline const AbstractClassRep::Field* AbstractClassRep::findField( StringTableEntry fieldName, FieldLookupCache& cache ) const
+{
+   if( cache.mClassRep != this || cache.mFieldName != fieldName )
+   {
+      cache.mClassRep = this;
+      cache.mFieldName = fieldName;
+      cache.mField = findField( fieldName );
+   }
+
+   return cache.mField;
+}
+
 //=============================================================================
 //    ConcreteClassRep.
 //=============================================================================
@@ -55,14 +55,14 @@ class ConsoleValue;
 class SimEvent
 {
 public:
-   SimEvent *nextEvent;     ///< Linked list details - pointer to next item in the list.
+   U32 queueIndex;          ///< Position in the event queue heap while pending.
    SimTime startTime;       ///< When the event was posted.
    SimTime time;            ///< When the event is scheduled to occur.
    U32 sequenceCount;       ///< Unique ID. These are assigned sequentially based on order
    ///  of addition to the list.
    SimObject *destObject;   ///< Object on which this event will be applied.
 
-   SimEvent() { destObject = NULL; }
+   SimEvent() { destObject = NULL; queueIndex = 0; }
    virtual ~SimEvent() {}   ///< Destructor
    ///
    /// A dummy virtual destructor is required
@@ -35,6 +35,7 @@
 #include "platform/platformIntrinsics.h"
 #include "platform/profiler.h"
 #include "math/mMathFn.h"
+#include "core/util/tDictionary.h"
 
 extern ExprEvalState gEvalState;
 
@@ -58,9 +59,101 @@ SimTime gCurrentTime;
 SimTime gTargetTime;
 
 void *gEventQueueMutex;
-SimEvent *gEventQueue;
 U32 gEventSequence;
 
+/// Pending events as a binary min-heap ordered by time and then by sequence
+/// count, so events due at the same time fire in the order they were posted.
+/// Each event stores its heap position in SimEvent::queueIndex.
+Vector<SimEvent*> gEventQueue;
+
+/// Pending events by sequence count.
+HashTable<U32, SimEvent*> gEventLookup;
+
+//---------------------------------------------------------------------------
+// event queue heap
+
+static inline bool eventFiresBefore(const SimEvent *a, const SimEvent *b)
+{
+   if(a->time != b->time)
+      return a->time < b->time;
+
+   // Sequence counts wrap, so compare them as a difference.
+   return S32(a->sequenceCount - b->sequenceCount) < 0;
+}
+
+static inline void placeEvent(SimEvent *event, U32 index)
+{
+   gEventQueue[index] = event;
+   event->queueIndex = index;
+}
+
+static void siftEventUp(U32 index)
+{
+   SimEvent *event = gEventQueue[index];
+   while(index > 0)
+   {
+      U32 parent = (index - 1) >> 1;
+      if(!eventFiresBefore(event, gEventQueue[parent]))
+         break;
+      placeEvent(gEventQueue[parent], index);
+      index = parent;
+   }
+   placeEvent(event, index);
+}
+
+static void siftEventDown(U32 index)
+{
+   const U32 count = gEventQueue.size();
+   SimEvent *event = gEventQueue[index];
+   for(;;)
+   {
+      U32 child = (index << 1) + 1;
+      if(child >= count)
+         break;
+      if(child + 1 < count && eventFiresBefore(gEventQueue[child + 1], gEventQueue[child]))
+         child++;
+      if(!eventFiresBefore(gEventQueue[child], event))
+         break;
+      placeEvent(gEventQueue[child], index);
+      index = child;
+   }
+   placeEvent(event, index);
+}
+
+static void pushEvent(SimEvent *event)
+{
+   gEventQueue.increment();
+   placeEvent(event, gEventQueue.size() - 1);
+   siftEventUp(event->queueIndex);
+   gEventLookup.insertUnique(event->sequenceCount, event);
+}
+
+/// Take the event out of the heap and the lookup table without deleting it.
+static void removeEvent(SimEvent *event)
+{
+   const U32 index = event->queueIndex;
+   SimEvent *last = gEventQueue.last();
+   gEventQueue.decrement();
+
+   if(last != event)
+   {
+      placeEvent(last, index);
+      if(index > 0 && eventFiresBefore(last, gEventQueue[(index - 1) >> 1]))
+         siftEventUp(index);
+      else
+         siftEventDown(index);
+   }
+
+   gEventLookup.erase(event->sequenceCount);
+}
+
+static SimEvent *findEvent(U32 eventSequence)
+{
+   SimEvent *event = NULL;
+   gEventLookup.find(eventSequence, event);
+   return event;
+}
+
 //---------------------------------------------------------------------------
 // event queue init/shutdown
 
@@ -69,7 +162,8 @@ static void initEventQueue()
    gCurrentTime = 0;
    gTargetTime = 0;
    gEventSequence = 1;
-   gEventQueue = NULL;
+   gEventQueue.clear();
+   gEventLookup.clear();
    gEventQueueMutex = Mutex::createMutex();
 }
 
@@ -77,13 +171,10 @@ static void shutdownEventQueue()
 {
    // Delete all pending events
    Mutex::lockMutex(gEventQueueMutex);
-   SimEvent *walk = gEventQueue;
-   while(walk)
-   {
-      SimEvent *temp = walk->nextEvent;
-      delete walk;
-      walk = temp;
-   }
+   for(U32 i = 0; i < gEventQueue.size(); i++)
+      delete gEventQueue[i];
+   gEventQueue.clear();
+   gEventLookup.clear();
    Mutex::unlockMutex(gEventQueueMutex);
    Mutex::destroyMutex(gEventQueueMutex);
 }
@@ -115,19 +206,11 @@ U32 postEvent(SimObject *destObject, SimEvent* event,U32 time)
       return InvalidEventId;
    }
    event->sequenceCount = gEventSequence++;
-   SimEvent **walk = &gEventQueue;
-   SimEvent *current;
-   
-   while((current = *walk) != NULL && (current->time < event->time))
-      walk = &(current->nextEvent);
-   
-   // [tom, 6/24/2005] This ensures that SimEvents are dispatched in the same order that they are posted.
+
+   // [tom, 6/24/2005] Events must be dispatched in the same order that they are posted.
    // This is needed to ensure Con::threadSafeExecute() executes script code in the correct order.
-   while((current = *walk) != NULL && (current->time == event->time))
-      walk = &(current->nextEvent);
-   
-   event->nextEvent = current;
-   *walk = event;
+   // The heap breaks ties on the sequence count to guarantee this.
+   pushEvent(event);
 
    U32 seqCount = event->sequenceCount;
 
@@ -143,20 +226,11 @@ void cancelEvent(U32 eventSequence)
 {
    Mutex::lockMutex(gEventQueueMutex);
 
-   SimEvent **walk = &gEventQueue;
-   SimEvent *current;
-   
-   while((current = *walk) != NULL)
+   SimEvent *event = findEvent(eventSequence);
+   if(event)
    {
-      if(current->sequenceCount == eventSequence)
-      {
-         *walk = current->nextEvent;
-         delete current;
-         Mutex::unlockMutex(gEventQueueMutex);
-         return;
-      }
-      else
-         walk = &(current->nextEvent);
+      removeEvent(event);
+      delete event;
    }
 
    Mutex::unlockMutex(gEventQueueMutex);
@@ -166,19 +240,28 @@ void cancelPendingEvents(SimObject *obj)
 {
    Mutex::lockMutex(gEventQueueMutex);
 
-   SimEvent **walk = &gEventQueue;
-   SimEvent *current;
-   
-   while((current = *walk) != NULL)
+   // Compact the surviving events and rebuild the heap once rather than
+   // removing the matches one by one.
+   U32 count = 0;
+   for(U32 i = 0; i < gEventQueue.size(); i++)
    {
-      if(current->destObject == obj)
+      SimEvent *event = gEventQueue[i];
+      if(event->destObject == obj)
       {
-         *walk = current->nextEvent;
-         delete current;
+         gEventLookup.erase(event->sequenceCount);
+         delete event;
       }
       else
-         walk = &(current->nextEvent);
+         placeEvent(event, count++);
+   }
+
+   if(count != gEventQueue.size())
+   {
+      gEventQueue.setSize(count);
+      for(S32 i = S32(count / 2) - 1; i >= 0; i--)
+         siftEventDown(i);
    }
+
    Mutex::unlockMutex(gEventQueueMutex);
 }
 
@@ -188,48 +271,45 @@ void cancelPendingEvents(SimObject *obj)
 bool isEventPending(U32 eventSequence)
 {
    Mutex::lockMutex(gEventQueueMutex);
-
-   for(SimEvent *walk = gEventQueue; walk; walk = walk->nextEvent)
-      if(walk->sequenceCount == eventSequence)
-      {
-         Mutex::unlockMutex(gEventQueueMutex);
-         return true;
-      }
+   bool pending = findEvent(eventSequence) != NULL;
    Mutex::unlockMutex(gEventQueueMutex);
-   return false;
+   return pending;
 }
 
 U32 getEventTimeLeft(U32 eventSequence)
 {
    Mutex::lockMutex(gEventQueueMutex);
 
-   for(SimEvent *walk = gEventQueue; walk; walk = walk->nextEvent)
-      if(walk->sequenceCount == eventSequence)
-      {
-         SimTime t = walk->time - getCurrentTime();
-         Mutex::unlockMutex(gEventQueueMutex);
-         return t;
-      }
+   SimEvent *event = findEvent(eventSequence);
+   SimTime t = event ? event->time - getCurrentTime() : 0;
 
    Mutex::unlockMutex(gEventQueueMutex);
 
-   return 0;   
+   return t;
 }
 
 U32 getScheduleDuration(U32 eventSequence)
 {
-   for(SimEvent *walk = gEventQueue; walk; walk = walk->nextEvent)
-      if(walk->sequenceCount == eventSequence)
-         return (walk->time-walk->startTime);
-   return 0;
+   Mutex::lockMutex(gEventQueueMutex);
+
+   SimEvent *event = findEvent(eventSequence);
+   SimTime t = event ? event->time - event->startTime : 0;
+
+   Mutex::unlockMutex(gEventQueueMutex);
+
+   return t;
 }
 
 U32 getTimeSinceStart(U32 eventSequence)
 {
-   for(SimEvent *walk = gEventQueue; walk; walk = walk->nextEvent)
-      if(walk->sequenceCount == eventSequence)
-         return (getCurrentTime()-walk->startTime);
-   return 0;
+   Mutex::lockMutex(gEventQueueMutex);
+
+   SimEvent *event = findEvent(eventSequence);
+   SimTime t = event ? getCurrentTime() - event->startTime : 0;
+
+   Mutex::unlockMutex(gEventQueueMutex);
+
+   return t;
 }
 
 //---------------------------------------------------------------------------
@@ -243,10 +323,10 @@ void advanceToTime(SimTime targetTime)
    Mutex::lockMutex(gEventQueueMutex);
 
    gTargetTime = targetTime;
-   while(gEventQueue && gEventQueue->time <= targetTime)
+   while(gEventQueue.size() && gEventQueue.first()->time <= targetTime)
    {
-      SimEvent *event = gEventQueue;
-      gEventQueue = gEventQueue->nextEvent;
+      SimEvent *event = gEventQueue.first();
+      removeEvent(event);
       AssertFatal(event->time >= gCurrentTime,
          "Sim::advanceToTime() - Event time is less than current time.");
       gCurrentTime = event->time;
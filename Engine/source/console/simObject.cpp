@@ -904,52 +904,64 @@ void SimObject::assignFieldsFrom(SimObject *parent)
 void SimObject::setDataField(StringTableEntry slotName, const char *array, const char *value)
 {
    // first search the static fields if enabled
-   if(mFlags.test(ModStaticFields))
-   {
-      const AbstractClassRep::Field *fld = findField(slotName);
-      if(fld)
-      {
-         // Skip the special field types as they are not data.
-         if ( fld->type >= AbstractClassRep::ARCFirstCustomField )
-            return;
+   const AbstractClassRep::Field *fld = mFlags.test(ModStaticFields) ? findField(slotName) : NULL;
+   _setDataField(fld, slotName, array, value);
+}
 
-         S32 array1 = array ? dAtoi(array) : 0;
+//-----------------------------------------------------------------------------
 
-         if(array1 >= 0 && array1 < fld->elementCount && fld->elementCount >= 1)
-         {
-            // If the set data notify callback returns true, then go ahead and
-            // set the data, otherwise, assume the set notify callback has either
-            // already set the data, or has deemed that the data should not
-            // be set at all.
-            FrameTemp<char> buffer(2048);
-            FrameTemp<char> bufferSecure(2048); // This buffer is used to make a copy of the data
-            // so that if the prep functions or any other functions use the string stack, the data
-            // is not corrupted.
+void SimObject::setDataField(StringTableEntry slotName, const char *array, const char *value, FieldLookupCache &cache)
+{
+   const AbstractClassRep::Field *fld = mFlags.test(ModStaticFields) ? getClassRep()->findField(slotName, cache) : NULL;
+   _setDataField(fld, slotName, array, value);
+}
 
-            ConsoleBaseType *cbt = ConsoleBaseType::getType( fld->type );
-            AssertFatal( cbt != NULL, "Could not resolve Type Id." );
+//-----------------------------------------------------------------------------
 
-            const char* szBuffer = cbt->prepData( value, buffer, 2048 );
-            dMemset( bufferSecure, 0, 2048 );
-            dMemcpy( bufferSecure, szBuffer, dStrlen( szBuffer ) );
+void SimObject::_setDataField(const AbstractClassRep::Field *fld, StringTableEntry slotName, const char *array, const char *value)
+{
+   if(fld)
+   {
+      // Skip the special field types as they are not data.
+      if ( fld->type >= AbstractClassRep::ARCFirstCustomField )
+         return;
 
-            if( (*fld->setDataFn)( this, array, bufferSecure ) )
-               Con::setData(fld->type, (void *) (((const char *)this) + fld->offset), array1, 1, &value, fld->table);
+      S32 array1 = array ? dAtoi(array) : 0;
 
-            if(fld->validator)
-               fld->validator->validateType(this, (void *) (((const char *)this) + fld->offset));
+      if(array1 >= 0 && array1 < fld->elementCount && fld->elementCount >= 1)
+      {
+         // If the set data notify callback returns true, then go ahead and
+         // set the data, otherwise, assume the set notify callback has either
+         // already set the data, or has deemed that the data should not
+         // be set at all.
+         FrameTemp<char> buffer(2048);
+         FrameTemp<char> bufferSecure(2048); // This buffer is used to make a copy of the data
+         // so that if the prep functions or any other functions use the string stack, the data
+         // is not corrupted.
 
-            onStaticModified( slotName, value );
+         ConsoleBaseType *cbt = ConsoleBaseType::getType( fld->type );
+         AssertFatal( cbt != NULL, "Could not resolve Type Id." );
 
-            return;
-         }
+         const char* szBuffer = cbt->prepData( value, buffer, 2048 );
+         dMemset( bufferSecure, 0, 2048 );
+         dMemcpy( bufferSecure, szBuffer, dStrlen( szBuffer ) );
+
+         if( (*fld->setDataFn)( this, array, bufferSecure ) )
+            Con::setData(fld->type, (void *) (((const char *)this) + fld->offset), array1, 1, &value, fld->table);
 
          if(fld->validator)
             fld->validator->validateType(this, (void *) (((const char *)this) + fld->offset));
 
          onStaticModified( slotName, value );
+
          return;
       }
+
+      if(fld->validator)
+         fld->validator->validateType(this, (void *) (((const char *)this) + fld->offset));
+
+      onStaticModified( slotName, value );
+      return;
    }
 
    if(mFlags.test(ModDynamicFields))
@@ -957,7 +969,8 @@ void SimObject::setDataField(StringTableEntry slotName, const char *array, const
       if(!mFieldDictionary)
          mFieldDictionary = new SimFieldDictionary;
 
-      if(!array)
+      // See _getDataField().
+      if(!array || !array[0])
       {
          mFieldDictionary->setFieldValue(slotName, value);
          onDynamicModified( slotName, value );
@@ -978,19 +991,30 @@ void SimObject::setDataField(StringTableEntry slotName, const char *array, const
 
 const char *SimObject::getDataField(StringTableEntry slotName, const char *array)
 {
-   if(mFlags.test(ModStaticFields))
+   const AbstractClassRep::Field *fld = mFlags.test(ModStaticFields) ? findField(slotName) : NULL;
+   return _getDataField(fld, slotName, array);
+}
+
+//-----------------------------------------------------------------------------
+
+const char *SimObject::getDataField(StringTableEntry slotName, const char *array, FieldLookupCache &cache)
+{
+   const AbstractClassRep::Field *fld = mFlags.test(ModStaticFields) ? getClassRep()->findField(slotName, cache) : NULL;
+   return _getDataField(fld, slotName, array);
+}
+
+//-----------------------------------------------------------------------------
+
+const char *SimObject::_getDataField(const AbstractClassRep::Field *fld, StringTableEntry slotName, const char *array)
+{
+   if(fld)
    {
       S32 array1 = array ? dAtoi(array) : -1;
-      const AbstractClassRep::Field *fld = findField(slotName);
-
-      if(fld)
-      {
-         if(array1 == -1 && fld->elementCount == 1)
-            return (*fld->getDataFn)( this, Con::getData(fld->type, (void *) (((const char *)this) + fld->offset), 0, fld->table, fld->flag) );
-         if(array1 >= 0 && array1 < fld->elementCount)
-            return (*fld->getDataFn)( this, Con::getData(fld->type, (void *) (((const char *)this) + fld->offset), array1, fld->table, fld->flag) );// + typeSizes[fld.type] * array1));
-         return "";
-      }
+      if(array1 == -1 && fld->elementCount == 1)
+         return (*fld->getDataFn)( this, Con::getData(fld->type, (void *) (((const char *)this) + fld->offset), 0, fld->table, fld->flag) );
+      if(array1 >= 0 && array1 < fld->elementCount)
+         return (*fld->getDataFn)( this, Con::getData(fld->type, (void *) (((const char *)this) + fld->offset), array1, fld->table, fld->flag) );// + typeSizes[fld.type] * array1));
+      return "";
    }
 
    if(mFlags.test(ModDynamicFields))
@@ -998,7 +1022,9 @@ const char *SimObject::getDataField(StringTableEntry slotName, const char *array
       if(!mFieldDictionary)
          return "";
 
-      if(!array)
+      // An empty index names the same entry as no index, so skip
+      // building and interning the combined name.
+      if(!array || !array[0])
       {
          if (const char* val = mFieldDictionary->getFieldValue(slotName))
             return val;
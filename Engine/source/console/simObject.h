@@ -416,6 +416,16 @@ class SimObject: public ConsoleObject, public TamlCallbacks
       
       static bool _setPersistentID( void* object, const char* index, const char* data );
          
+      /// @}
+
+      /// @name Field Access
+      /// @{
+
+      /// Shared implementation of getDataField() and setDataField() once the
+      /// static field (or NULL for a dynamic field) has been resolved.
+      const char* _getDataField( const AbstractClassRep::Field* fld, StringTableEntry slotName, const char* array );
+      void _setDataField( const AbstractClassRep::Field* fld, StringTableEntry slotName, const char* array, const char* value );
+
       /// @}
       
       /// @name Namespace management
@@ -495,6 +505,12 @@ class SimObject: public ConsoleObject, public TamlCallbacks
       /// @param   value       Value to store.
       void setDataField(StringTableEntry slotName, const char *array, const char *value);
 
+      /// Versions of getDataField() and setDataField() that resolve the static
+      /// field through the given lookup cache.  Used by the script VM, which
+      /// keeps a cache per field access instruction.
+      const char *getDataField(StringTableEntry slotName, const char *array, FieldLookupCache &cache);
+      void setDataField(StringTableEntry slotName, const char *array, const char *value, FieldLookupCache &cache);
+
       const char *getPrefixedDataField(StringTableEntry fieldName, const char *array);
 
       void setPrefixedDataField(StringTableEntry fieldName, const char *array, const char *value);
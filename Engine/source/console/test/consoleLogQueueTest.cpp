@@ -0,0 +1,172 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "platform/threads/thread.h"
+#include "console/consoleLogQueue.h"
+
+FIXTURE(ConsoleLogQueue)
+{
+public:
+   enum
+   {
+      NumProducers = 4,
+      LinesPerProducer = 20000,
+   };
+
+   /// Pushes numbered lines, some of them long enough to span slots.
+   struct ProducerThread : public Thread
+   {
+      ConsoleLogQueue& mQueue;
+      U32 mId;
+      U32 mDropped;
+
+      ProducerThread(ConsoleLogQueue& queue, U32 id)
+         : mQueue(queue), mId(id), mDropped(0) {}
+
+      virtual void run(void*)
+      {
+         char line[1024];
+         for(U32 i = 0; i < LinesPerProducer; i++)
+         {
+            S32 len = dSprintf(line, sizeof(line), "%d %d ", mId, i);
+
+            // Pad every seventh line past a single slot.
+            if(i % 7 == 0)
+            {
+               for(; len < 600; len++)
+                  line[len] = 'a' + (i % 26);
+               line[len] = 0;
+            }
+
+            if(!mQueue.push(line, len))
+               mDropped++;
+         }
+      }
+   };
+};
+
+TEST_FIX(ConsoleLogQueue, LongLines)
+{
+   ConsoleLogQueue queue;
+
+   char line[ConsoleLogQueue::SlotTextSize * 3];
+   dMemset(line, 'x', sizeof(line));
+   EXPECT_TRUE(queue.push(line, sizeof(line)));
+   EXPECT_TRUE(queue.push("", 0));
+
+   Vector<char> text;
+   EXPECT_TRUE(queue.pop(text));
+   EXPECT_EQ(sizeof(line), text.size());
+   EXPECT_EQ(0, dMemcmp(line, text.address(), sizeof(line)));
+
+   text.clear();
+   EXPECT_TRUE(queue.pop(text));
+   EXPECT_EQ(0, text.size());
+   EXPECT_FALSE(queue.pop(text));
+}
+
+TEST_FIX(ConsoleLogQueue, DropsWhenFull)
+{
+   ConsoleLogQueue queue;
+
+   for(U32 i = 0; i < ConsoleLogQueue::NumSlots; i++)
+      EXPECT_TRUE(queue.push("line", 4));
+
+   EXPECT_FALSE(queue.push("line", 4));
+   EXPECT_EQ(1, queue.takeDropped());
+   EXPECT_EQ(0, queue.takeDropped());
+   EXPECT_EQ(1, queue.getTotalDropped());
+
+   Vector<char> text;
+   EXPECT_TRUE(queue.pop(text));
+   EXPECT_TRUE(queue.push("line", 4));
+}
+
+TEST_FIX(ConsoleLogQueue, ManyProducers)
+{
+   ConsoleLogQueue queue;
+
+   ProducerThread* producers[NumProducers];
+   for(U32 i = 0; i < NumProducers; i++)
+   {
+      producers[i] = new ProducerThread(queue, i);
+      producers[i]->start();
+   }
+
+   // Lines of each producer must arrive whole and in order.
+   S32 next[NumProducers];
+   for(U32 i = 0; i < NumProducers; i++)
+      next[i] = -1;
+
+   U32 received = 0;
+   bool running = true;
+   Vector<char> text;
+   while(running || queue.getNumPending())
+   {
+      running = false;
+      for(U32 i = 0; i < NumProducers; i++)
+         running |= producers[i]->isAlive();
+
+      text.clear();
+      if(!queue.pop(text))
+      {
+         Platform::sleep(0);
+         continue;
+      }
+      text.push_back(0);
+      received++;
+
+      // Failures must not leave the loop, the producers are still
+      // writing to the queue until they are joined below.
+      S32 id = -1, index = -1;
+      EXPECT_EQ(2, dSscanf(text.address(), "%d %d", &id, &index));
+      const bool validId = id >= 0 && id < NumProducers;
+      EXPECT_TRUE(validId);
+      if(!validId)
+         continue;
+
+      EXPECT_GT(index, next[id]);
+      next[id] = index;
+
+      if(index % 7 == 0)
+      {
+         EXPECT_EQ(600, dStrlen(text.address()));
+      }
+   }
+
+   U32 dropped = 0;
+   for(U32 i = 0; i < NumProducers; i++)
+   {
+      producers[i]->join();
+      dropped += producers[i]->mDropped;
+      delete producers[i];
+   }
+
+   EXPECT_EQ(NumProducers * LinesPerProducer, received + dropped);
+   EXPECT_EQ(dropped, queue.getTotalDropped());
+}
+
+#endif
@@ -105,4 +105,29 @@ TEST(Console, RuntimeClassRep)
       << "Unregistration of type failed";
 }
 
+TEST(Console, FindFieldMatchesLinearSearch)
+{
+   // The field hashes are built at registration, so every registered
+   // class must find the first field of each name like a linear scan.
+   for (AbstractClassRep* rep = AbstractClassRep::getClassList(); rep; rep = rep->getNextClass())
+   {
+      const AbstractClassRep::FieldList& fields = rep->mFieldList;
+      for (U32 i = 0; i < fields.size(); i++)
+      {
+         const AbstractClassRep::Field* expected = NULL;
+         for (U32 j = 0; j < fields.size() && !expected; j++)
+         {
+            if (fields[j].pFieldname == fields[i].pFieldname)
+               expected = &fields[j];
+         }
+
+         EXPECT_EQ(expected, rep->findField(fields[i].pFieldname))
+            << rep->getClassName() << "::" << fields[i].pFieldname;
+      }
+
+      EXPECT_TRUE(rep->findField(StringTable->insert("_utNotAField")) == NULL)
+         << rep->getClassName();
+   }
+}
+
 #endif
\ No newline at end of file
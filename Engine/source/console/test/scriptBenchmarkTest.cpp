@@ -0,0 +1,162 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "console/console.h"
+#include "console/compiler.h"
+#include "console/engineAPI.h"
+#include "core/strings/stringFunctions.h"
+
+FIXTURE(ScriptBenchmark)
+{
+public:
+   // Defines the benchmark functions with the given suffix. The bodies are
+   // modelled on typical gameplay callbacks: a handful of arguments and
+   // locals that are read and written several times per call.
+   static void defineFunctions(const char* suffix, bool slotLocals)
+   {
+      const bool oldSlotLocals = Compiler::gSlotLocalVariables;
+      Compiler::gSlotLocalVariables = slotLocals;
+
+      char script[2048];
+      dSprintf(script, sizeof(script),
+         "function benchOnDamage%s(%%obj, %%amount, %%scale)\n"
+         "{\n"
+         "   %%health = 100 - %%obj;\n"
+         "   %%armor = %%scale * 10;\n"
+         "   %%damage = %%amount * %%scale - %%armor * 0.1;\n"
+         "   if (%%damage < 0)\n"
+         "      %%damage = 0;\n"
+         "   %%health -= %%damage;\n"
+         "   %%state = %%health > 0 ? \"alive\" : \"dead\";\n"
+         "   return %%health;\n"
+         "}\n"
+         "function benchRecurse%s(%%n)\n"
+         "{\n"
+         "   %%local = %%n * 2;\n"
+         "   if (%%n > 0)\n"
+         "      %%local += benchRecurse%s(%%n - 1);\n"
+         "   return %%local;\n"
+         "}\n"
+         "function benchEvalShared%s(%%n)\n"
+         "{\n"
+         "   %%value = %%n;\n"
+         "   eval(\"%%value = %%value + 1;\");\n"
+         "   return %%value;\n"
+         "}\n"
+         "function benchRun%s(%%count)\n"
+         "{\n"
+         "   %%sum = 0;\n"
+         "   for (%%i = 0; %%i < %%count; %%i++)\n"
+         "      %%sum += benchOnDamage%s(%%i %% 100, 20, 0.5);\n"
+         "   return %%sum;\n"
+         "}\n",
+         suffix, suffix, suffix, suffix, suffix, suffix);
+      Con::evaluate(script, false, "scriptBenchmarkTest");
+
+      Compiler::gSlotLocalVariables = oldSlotLocals;
+   }
+
+   // Runs the callback loop and returns the calls per second.
+   static F64 measureCallsPerSecond(const char* suffix, U32 count)
+   {
+      char fnName[64];
+      dSprintf(fnName, sizeof(fnName), "benchRun%s", suffix);
+
+      char countStr[32];
+      dSprintf(countStr, sizeof(countStr), "%u", count);
+
+      const U32 start = Platform::getRealMilliseconds();
+      Con::executef((const char*)fnName, (const char*)countStr);
+      const U32 elapsed = getMax(Platform::getRealMilliseconds() - start, U32(1));
+
+      return F64(count) * 1000.0 / F64(elapsed);
+   }
+};
+
+TEST_FIX(ScriptBenchmark, LocalSlotsMatchNamedLookup)
+{
+   defineFunctions("Named", false);
+   defineFunctions("Slots", true);
+
+   EXPECT_EQ(dAtoi(Con::executef("benchOnDamageNamed", "10", "20", "0.5")),
+      dAtoi(Con::executef("benchOnDamageSlots", "10", "20", "0.5")))
+      << "Slot resolved locals should produce the same result";
+
+   EXPECT_EQ(dAtoi(Con::executef("benchRecurseNamed", "10")),
+      dAtoi(Con::executef("benchRecurseSlots", "10")))
+      << "Each recursion level should have its own slots";
+
+   EXPECT_EQ(6, dAtoi(Con::executef("benchEvalSharedSlots", "5")))
+      << "eval() should see and modify slot resolved locals";
+}
+
+TEST_FIX(ScriptBenchmark, FieldCacheAcrossClasses)
+{
+   Con::evaluate(
+      "function benchFieldAccess(%obj, %value)\n"
+      "{\n"
+      "   %obj.health = %value;\n"
+      "   %obj.internalName = \"bench\" @ %value;\n"
+      "   return %obj.internalName SPC %obj.health;\n"
+      "}\n"
+      "new ScriptObject(BenchFieldScriptObject);\n"
+      "new SimSet(BenchFieldSimSet);\n",
+      false, "scriptBenchmarkTest");
+
+   // The same instructions see two different classes, so the caches have
+   // to be refilled on every switch.
+   for (U32 i = 0; i < 4; i++)
+   {
+      EXPECT_STREQ("bench1 1", Con::executef("benchFieldAccess", "BenchFieldScriptObject", "1"))
+         << "Static and dynamic fields should be read back";
+      EXPECT_STREQ("bench2 2", Con::executef("benchFieldAccess", "BenchFieldSimSet", "2"))
+         << "Static and dynamic fields should be read back";
+   }
+
+   Con::evaluate("BenchFieldScriptObject.delete(); BenchFieldSimSet.delete();", false, "scriptBenchmarkTest");
+}
+
+TEST_FIX(ScriptBenchmark, LocalSlotsCallsPerSecond)
+{
+   const U32 numCalls = 200000;
+
+   defineFunctions("Named", false);
+   defineFunctions("Slots", true);
+
+   // Warm up both paths so frames and string buffers are allocated.
+   measureCallsPerSecond("Named", 1000);
+   measureCallsPerSecond("Slots", 1000);
+
+   const F64 named = measureCallsPerSecond("Named", numCalls);
+   const F64 slots = measureCallsPerSecond("Slots", numCalls);
+
+   Con::printf("ScriptBenchmark: named locals %.0f calls/s, slot locals %.0f calls/s (%.2fx)",
+      named, slots, slots / named);
+
+   EXPECT_GT(named, 0.0);
+   EXPECT_GT(slots, 0.0);
+}
+
+#endif
@@ -0,0 +1,156 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "console/console.h"
+#include "console/sim.h"
+#include "console/simEvents.h"
+#include "console/simObject.h"
+#include "math/mRandom.h"
+
+FIXTURE(SimEventQueue)
+{
+public:
+   /// Appends its id to a shared list when it fires.
+   class RecordEvent : public SimEvent
+   {
+   public:
+      Vector<U32>* mLog;
+      U32 mId;
+
+      RecordEvent(Vector<U32>* log, U32 id) : mLog(log), mId(id) {}
+
+      virtual void process(SimObject*)
+      {
+         mLog->push_back(mId);
+      }
+   };
+
+   SimObject* mObject;
+
+   virtual void SetUp()
+   {
+      mObject = new SimObject();
+      mObject->registerObject();
+   }
+
+   virtual void TearDown()
+   {
+      mObject->deleteObject();
+   }
+};
+
+TEST_FIX(SimEventQueue, FiresInTimeThenPostOrder)
+{
+   Vector<U32> log;
+   const SimTime now = Sim::getCurrentTime();
+
+   Sim::postEvent(mObject, new RecordEvent(&log, 0), now + 20);
+   Sim::postEvent(mObject, new RecordEvent(&log, 1), now + 10);
+   Sim::postEvent(mObject, new RecordEvent(&log, 2), now + 20);
+   U32 cancelled = Sim::postEvent(mObject, new RecordEvent(&log, 3), now + 10);
+   Sim::postEvent(mObject, new RecordEvent(&log, 4), now + 10);
+   Sim::postEvent(mObject, new RecordEvent(&log, 5), now + 5);
+
+   EXPECT_TRUE(Sim::isEventPending(cancelled));
+   EXPECT_EQ(10, Sim::getEventTimeLeft(cancelled));
+   Sim::cancelEvent(cancelled);
+   EXPECT_FALSE(Sim::isEventPending(cancelled));
+
+   Sim::advanceToTime(now + 20);
+
+   ASSERT_EQ(5, log.size());
+   EXPECT_EQ(5, log[0]);
+   EXPECT_EQ(1, log[1]) << "Events due at the same time should fire in post order";
+   EXPECT_EQ(4, log[2]);
+   EXPECT_EQ(0, log[3]);
+   EXPECT_EQ(2, log[4]);
+}
+
+TEST_FIX(SimEventQueue, CancelPendingEventsForObject)
+{
+   Vector<U32> log;
+   const SimTime now = Sim::getCurrentTime();
+
+   SimObject* other = new SimObject();
+   other->registerObject();
+
+   U32 kept = Sim::postEvent(mObject, new RecordEvent(&log, 0), now + 10);
+   U32 dropped = Sim::postEvent(other, new RecordEvent(&log, 1), now + 5);
+   Sim::postEvent(mObject, new RecordEvent(&log, 2), now + 1);
+   Sim::postEvent(other, new RecordEvent(&log, 3), now + 15);
+
+   Sim::cancelPendingEvents(other);
+   EXPECT_TRUE(Sim::isEventPending(kept));
+   EXPECT_FALSE(Sim::isEventPending(dropped));
+
+   Sim::advanceToTime(now + 20);
+   other->deleteObject();
+
+   ASSERT_EQ(2, log.size());
+   EXPECT_EQ(2, log[0]);
+   EXPECT_EQ(0, log[1]);
+}
+
+TEST_FIX(SimEventQueue, PostAndCancelBenchmark)
+{
+   const U32 numEvents = 100000;
+
+   Vector<U32> log;
+   Vector<U32> ids;
+   ids.reserve(numEvents);
+
+   const SimTime now = Sim::getCurrentTime();
+   gRandGen.setSeed(1376312589);
+
+   U32 start = Platform::getRealMilliseconds();
+   for (U32 i = 0; i < numEvents; i++)
+      ids.push_back(Sim::postEvent(mObject, new RecordEvent(&log, i), now + 1 + gRandGen.randI(0, 10000)));
+   const U32 postTime = Platform::getRealMilliseconds() - start;
+
+   // Cancel the even numbered events in a scattered order.
+   start = Platform::getRealMilliseconds();
+   for (U32 i = 0; i < numEvents; i += 2)
+      Sim::cancelEvent(ids[(i * 7919) % numEvents]);
+   const U32 cancelTime = Platform::getRealMilliseconds() - start;
+
+   start = Platform::getRealMilliseconds();
+   U32 pending = 0;
+   for (U32 i = 0; i < numEvents; i++)
+      pending += Sim::isEventPending(ids[i]) ? 1 : 0;
+   const U32 pendingTime = Platform::getRealMilliseconds() - start;
+
+   Con::printf("SimEventQueue: %u events posted in %ums, half cancelled in %ums, %u pending checks in %ums",
+      numEvents, postTime, cancelTime, numEvents, pendingTime);
+
+   EXPECT_EQ(numEvents / 2, pending);
+
+   Sim::cancelPendingEvents(mObject);
+   for (U32 i = 0; i < numEvents; i++)
+      EXPECT_FALSE(Sim::isEventPending(ids[i]));
+   EXPECT_EQ(0, log.size());
+}
+
+#endif
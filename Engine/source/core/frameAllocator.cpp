@@ -22,16 +22,144 @@
 
 #include "core/frameAllocator.h"
 #include "console/console.h"
+#include "console/engineAPI.h"
+#include "core/module.h"
+#include "platform/threads/mutex.h"
+#include "platform/threads/thread.h"
 
-U8*   FrameAllocator::smBuffer = NULL;
-U32   FrameAllocator::smWaterMark = 0;
-U32   FrameAllocator::smHighWaterMark = 0;
+FrameAllocator::Arena*  FrameAllocator::smMainArena = NULL;
+FrameAllocator::Arena*  FrameAllocator::smArenaList = NULL;
+ThreadStorage           FrameAllocator::smThreadArena;
+U32                     FrameAllocator::smThreadFrameSize = TORQUE_THREAD_FRAME_SIZE;
 
-#ifdef TORQUE_DEBUG
-U32   FrameAllocator::smMaxFrameAllocation = 0;
+/// Guards FrameAllocator::smArenaList.
+static Mutex sgArenaListMutex;
+
+FrameAllocator::Arena* FrameAllocator::_createArena(const U32 frameSize)
+{
+   Arena* arena = new Arena;
+   arena->buffer = new U8[frameSize];
+   arena->size = frameSize;
+   arena->waterMark = 0;
+   arena->maxWaterMark = 0;
+   arena->threadId = ThreadManager::getCurrentThreadId();
+
+   MutexHandle lock;
+   lock.lock( &sgArenaListMutex, true );
+   arena->next = smArenaList;
+   smArenaList = arena;
+
+   return arena;
+}
+
+void FrameAllocator::_destroyArena(Arena* arena)
+{
+   {
+      MutexHandle lock;
+      lock.lock( &sgArenaListMutex, true );
+      for (Arena** ptr = &smArenaList; *ptr != NULL; ptr = &(*ptr)->next)
+      {
+         if (*ptr == arena)
+         {
+            *ptr = arena->next;
+            break;
+         }
+      }
+   }
+
+   delete [] arena->buffer;
+   delete arena;
+}
+
+void FrameAllocator::init(const U32 frameSize)
+{
+#ifdef FRAMEALLOCATOR_DEBUG_GUARD
+   AssertISV( false, "FRAMEALLOCATOR_DEBUG_GUARD has been removed because it allows non-contiguous memory allocation by the FrameAllocator, and this is *not* ok." );
+#endif
+
+   AssertFatal(smMainArena == NULL, "Error, already initialized");
+   smMainArena = _createArena(frameSize);
+   smThreadArena.set(smMainArena);
+}
+
+void FrameAllocator::destroy()
+{
+   AssertFatal(smMainArena != NULL, "Error, not initialized");
+
+   // Free the arenas of threads that did not clean up after themselves.
+   while (smArenaList != NULL)
+      _destroyArena(smArenaList);
+
+   smMainArena = NULL;
+   smThreadArena.set(NULL);
+}
+
+void FrameAllocator::initThread(const U32 frameSize)
+{
+   AssertFatal(smMainArena != NULL, "Error, not initialized");
+   AssertFatal(smThreadArena.get() == NULL, "Error, thread already initialized");
+
+   smThreadArena.set(_createArena(frameSize));
+}
+
+void FrameAllocator::destroyThread()
+{
+   Arena* arena = reinterpret_cast<Arena*>(smThreadArena.get());
+   if (arena == NULL || arena == smMainArena)
+      return;
+
+   AssertFatal(arena->waterMark == 0, "Error, thread exits with frame allocations outstanding");
+   _destroyArena(arena);
+   smThreadArena.set(NULL);
+}
+
+void FrameAllocator::resetMaxFrameAllocations()
+{
+   MutexHandle lock;
+   lock.lock( &sgArenaListMutex, true );
+   for (Arena* arena = smArenaList; arena != NULL; arena = arena->next)
+      arena->maxWaterMark = arena->waterMark;
+}
+
+void FrameAllocator::getStats(char* buffer, const U32 bufferSize)
+{
+   MutexHandle lock;
+   lock.lock( &sgArenaListMutex, true );
+
+   U32 length = 0;
+   buffer[0] = '\0';
+   for (Arena* arena = smArenaList; arena != NULL && length < bufferSize; arena = arena->next)
+   {
+      length += dSprintf(buffer + length, bufferSize - length, "%s%u %u %u %u",
+         length ? "\n" : "", arena->threadId, arena->size, arena->waterMark, arena->maxWaterMark);
+   }
+}
+
+AFTER_MODULE_INIT( Sim )
+{
+   Con::addVariable( "$FrameAllocator::threadFrameSize", TypeS32, &FrameAllocator::smThreadFrameSize,
+      "Size in bytes of the frame allocator arenas created for threads other than the main thread.\n"
+      "@ingroup Console\n" );
+}
 
 ConsoleFunction(getMaxFrameAllocation, S32, 1,1, "getMaxFrameAllocation();")
 {
    return FrameAllocator::getMaxFrameAllocation();
 }
-#endif
+
+DefineEngineFunction( getFrameAllocatorStats, const char*, ( bool reset ), ( false ),
+   "@brief Return the usage of the frame allocator arenas of all threads.\n\n"
+   "@param reset If true, the high water marks are reset after they have been read.\n"
+   "@return One line per thread in the format \"threadId size waterMark highWaterMark\" "
+   "with all sizes in bytes.\n"
+   "@ingroup Console" )
+{
+   const U32 bufferSize = 2048;
+   char* buffer = Con::getReturnBuffer( bufferSize );
+   FrameAllocator::getStats( buffer, bufferSize );
+
+   if ( reset )
+      FrameAllocator::resetMaxFrameAllocations();
+
+   return buffer;
+}
@@ -36,6 +36,16 @@
 /// memory which is allocated and expected to be contiguous.
 #define FRAMEALLOCATOR_BYTE_ALIGNMENT 4
 
+#ifndef _PLATFORMTLS_H_
+#include "platform/platformTLS.h"
+#endif
+
+/// Default size of the frame allocator arena of threads other than the main
+/// thread.  The main thread's arena is sized by TORQUE_FRAME_SIZE.
+#ifndef TORQUE_THREAD_FRAME_SIZE
+#define TORQUE_THREAD_FRAME_SIZE 4 << 20
+#endif
+
 /// Temporary memory pool for per-frame allocations.
 ///
 /// In the course of rendering a frame, it is often necessary to allocate
@@ -52,72 +62,123 @@
 ///   // Free frameAllocator memory
 ///   FrameAllocator::setWaterMark(waterMark);
 /// @endcode
+///
+/// Every thread allocates from its own arena, so the FrameAllocator can be
+/// used from ThreadPool work items as well as from the main thread.  The main
+/// thread's arena is created by init().  Other threads get an arena of
+/// getThreadFrameSize() bytes on their first allocation unless they call
+/// initThread() with a size of their own.
 class FrameAllocator
 {
-   static U8*   smBuffer;
-   static U32   smHighWaterMark;
-   static U32   smWaterMark;
+public:
 
-#ifdef TORQUE_DEBUG
-   static U32 smMaxFrameAllocation;
-#endif
+   /// The scratch memory of a single thread.
+   struct Arena
+   {
+      U8* buffer;
+
+      /// Size of #buffer in bytes.
+      U32 size;
+
+      U32 waterMark;
+
+      /// Largest water mark seen since the arena was created or the
+      /// statistics were last reset.
+      U32 maxWaterMark;
+
+      /// Id of the thread owning the arena.
+      U32 threadId;
+
+      Arena* next;
+   };
+
+private:
+
+   /// The arena of the thread that called init().
+   static Arena* smMainArena;
+
+   /// All arenas that are alive.
+   static Arena* smArenaList;
+
+   /// The arena of the current thread.
+   static ThreadStorage smThreadArena;
+
+   static Arena* _createArena(const U32 frameSize);
+   static void _destroyArena(Arena* arena);
 
   public:
-   inline static void init(const U32 frameSize);
-   inline static void destroy();
+   /// Size of the arenas created for threads on demand.
+   static U32 smThreadFrameSize;
+
+   static void init(const U32 frameSize);
+   static void destroy();
+
+   /// Create the frame arena of the calling thread with the given size.
+   /// Threads that don't call this get an arena of getThreadFrameSize()
+   /// bytes on their first allocation.
+   static void initThread(const U32 frameSize);
+
+   /// Free the frame arena of the calling thread.  Call this before a
+   /// thread that has used the FrameAllocator exits.
+   static void destroyThread();
+
+   /// Return the frame arena of the calling thread.
+   inline static Arena* getThreadArena();
 
    inline static void* alloc(const U32 allocSize);
+   inline static void* alloc(Arena* arena, const U32 allocSize);
 
    inline static void setWaterMark(const U32);
    inline static U32  getWaterMark();
    inline static U32  getHighWaterMark();
 
-#ifdef TORQUE_DEBUG
-   static U32 getMaxFrameAllocation() { return smMaxFrameAllocation; }
-#endif
+   static U32 getThreadFrameSize() { return smThreadFrameSize; }
+   static void setThreadFrameSize(const U32 frameSize) { smThreadFrameSize = frameSize; }
+
+   /// Return the largest water mark reached on the calling thread.
+   static U32 getMaxFrameAllocation() { return getThreadArena()->maxWaterMark; }
+
+   /// Reset the largest water mark of all arenas to their current water mark.
+   static void resetMaxFrameAllocations();
+
+   /// Write the statistics of all arenas into the given buffer, one line
+   /// per thread in the format "threadId size waterMark maxWaterMark".
+   static void getStats(char* buffer, const U32 bufferSize);
 };
 
-void FrameAllocator::init(const U32 frameSize)
+FrameAllocator::Arena* FrameAllocator::getThreadArena()
 {
-#ifdef FRAMEALLOCATOR_DEBUG_GUARD
-   AssertISV( false, "FRAMEALLOCATOR_DEBUG_GUARD has been removed because it allows non-contiguous memory allocation by the FrameAllocator, and this is *not* ok." );
-#endif
+   Arena* arena = reinterpret_cast<Arena*>(smThreadArena.get());
+   if (arena == NULL)
+   {
+      initThread(smThreadFrameSize);
+      arena = reinterpret_cast<Arena*>(smThreadArena.get());
+   }
 
-   AssertFatal(smBuffer == NULL, "Error, already initialized");
-   smBuffer = new U8[frameSize];
-   smWaterMark = 0;
-   smHighWaterMark = frameSize;
+   return arena;
 }
 
-void FrameAllocator::destroy()
+void* FrameAllocator::alloc(const U32 allocSize)
 {
-   AssertFatal(smBuffer != NULL, "Error, not initialized");
-
-   delete [] smBuffer;
-   smBuffer = NULL;
-   smWaterMark = 0;
-   smHighWaterMark = 0;
+   return alloc(getThreadArena(), allocSize);
 }
 
-
-void* FrameAllocator::alloc(const U32 allocSize)
+void* FrameAllocator::alloc(Arena* arena, const U32 allocSize)
 {
    U32 _allocSize = allocSize;
 
-   AssertFatal(smBuffer != NULL, "Error, no buffer!");
-   AssertFatal(smWaterMark + _allocSize <= smHighWaterMark, "Error alloc too large, increase frame size!");
-   smWaterMark = ( smWaterMark + ( FRAMEALLOCATOR_BYTE_ALIGNMENT - 1 ) ) & (~( FRAMEALLOCATOR_BYTE_ALIGNMENT - 1 ));
+   AssertFatal(arena->buffer != NULL, "Error, no buffer!");
+   U32 waterMark = ( arena->waterMark + ( FRAMEALLOCATOR_BYTE_ALIGNMENT - 1 ) ) & (~( FRAMEALLOCATOR_BYTE_ALIGNMENT - 1 ));
+   AssertFatal(waterMark + _allocSize <= arena->size, "Error alloc too large, increase frame size!");
 
    // Sanity check.
-   AssertFatal( !( smWaterMark & ( FRAMEALLOCATOR_BYTE_ALIGNMENT - 1 ) ), "Frame allocation is not on a specified byte boundry." );
+   AssertFatal( !( waterMark & ( FRAMEALLOCATOR_BYTE_ALIGNMENT - 1 ) ), "Frame allocation is not on a specified byte boundry." );
 
-   U8* p = &smBuffer[smWaterMark];
-   smWaterMark += _allocSize;
+   U8* p = &arena->buffer[waterMark];
+   arena->waterMark = waterMark + _allocSize;
 
-#ifdef TORQUE_DEBUG
-   if (smWaterMark > smMaxFrameAllocation)
-      smMaxFrameAllocation = smWaterMark;
-#endif
+   if (arena->waterMark > arena->maxWaterMark)
+      arena->maxWaterMark = arena->waterMark;
 
    return p;
 }
@@ -125,18 +186,19 @@ void* FrameAllocator::alloc(const U32 allocSize)
 
 void FrameAllocator::setWaterMark(const U32 waterMark)
 {
-   AssertFatal(waterMark < smHighWaterMark, "Error, invalid waterMark");
-   smWaterMark = waterMark;
+   Arena* arena = getThreadArena();
+   AssertFatal(waterMark < arena->size, "Error, invalid waterMark");
+   arena->waterMark = waterMark;
 }
 
 U32 FrameAllocator::getWaterMark()
 {
-   return smWaterMark;
+   return getThreadArena()->waterMark;
 }
 
 U32 FrameAllocator::getHighWaterMark()
 {
-   return smHighWaterMark;
+   return getThreadArena()->size;
 }
 
 /// Helper class to deal with FrameAllocator usage.
@@ -156,28 +218,30 @@ U32 FrameAllocator::getHighWaterMark()
 /// don't have to remember to reset the FrameAllocator on every posssible branch.
 class FrameAllocatorMarker
 {
+   FrameAllocator::Arena* mArena;
    U32 mMarker;
 
 public:
    FrameAllocatorMarker()
    {
-      mMarker = FrameAllocator::getWaterMark();
+      mArena = FrameAllocator::getThreadArena();
+      mMarker = mArena->waterMark;
    }
 
    ~FrameAllocatorMarker()
    {
-      FrameAllocator::setWaterMark(mMarker);
+      mArena->waterMark = mMarker;
    }
 
    void* alloc(const U32 allocSize) const
    {
-      return FrameAllocator::alloc(allocSize);
+      return FrameAllocator::alloc(mArena, allocSize);
    }
 
    template<typename T>
    T* alloc(const U32 numElements) const
    {
-      return reinterpret_cast<T *>(FrameAllocator::alloc(numElements * sizeof(T)));
+      return reinterpret_cast<T *>(FrameAllocator::alloc(mArena, numElements * sizeof(T)));
    }
 };
 
@@ -208,6 +272,7 @@ template<class T>
 class FrameTemp
 {
 protected:
+   FrameAllocator::Arena *mArena;
    U32 mWaterMark;
    T *mMemory;
    U32 mNumObjectsInMemory;
@@ -231,8 +296,9 @@ public:
    FrameTemp( const U32 count = 1 ) : mNumObjectsInMemory( count )
    {
       AssertFatal( count > 0, "Allocating a FrameTemp with less than one instance" );
-      mWaterMark = FrameAllocator::getWaterMark();
-      mMemory = reinterpret_cast<T *>( FrameAllocator::alloc( sizeof( T ) * count ) );
+      mArena = FrameAllocator::getThreadArena();
+      mWaterMark = mArena->waterMark;
+      mMemory = reinterpret_cast<T *>( FrameAllocator::alloc( mArena, sizeof( T ) * count ) );
 
       for( S32 i = 0; i < mNumObjectsInMemory; i++ )
          constructInPlace<T>( &mMemory[i] );
@@ -245,7 +311,7 @@ public:
       for( S32 i = 0; i < mNumObjectsInMemory; i++ )
          destructInPlace<T>( &mMemory[i] );
 
-      FrameAllocator::setWaterMark( mWaterMark );
+      mArena->waterMark = mWaterMark;
    }
 
    /// NOTE: This will return the memory, NOT perform a ones-complement
@@ -293,13 +359,14 @@ public:
    inline FrameTemp<type>::FrameTemp( const U32 count ) \
    { \
       AssertFatal( count > 0, "Allocating a FrameTemp with less than one instance" ); \
-      mWaterMark = FrameAllocator::getWaterMark(); \
-      mMemory = reinterpret_cast<type *>( FrameAllocator::alloc( sizeof( type ) * count ) ); \
+      mArena = FrameAllocator::getThreadArena(); \
+      mWaterMark = mArena->waterMark; \
+      mMemory = reinterpret_cast<type *>( FrameAllocator::alloc( mArena, sizeof( type ) * count ) ); \
    } \
    template<>\
    inline FrameTemp<type>::~FrameTemp() \
    { \
-      FrameAllocator::setWaterMark( mWaterMark ); \
+      mArena->waterMark = mWaterMark; \
    } \
 
 FRAME_TEMP_NC_SPEC(char);
@@ -72,39 +72,69 @@ void  ResourceBase::assign(const ResourceBase &inResource, void* resource)
    if (mResourceHeader->getSignature())
    {
       AssertFatal(inResource.mResourceHeader->getSignature() == getSignature(),"Resource::assign: mis-matching signature");
+
+      // Someone needs the resource right now; finish loading it.
+      if (mResourceHeader->mAsyncLoad)
+         ResourceManager::get()._completeAsyncLoad(mResourceHeader);
    }
    else
    {
       mResourceHeader->mSignature = getSignature();
 
-      const Torque::Path   path = mResourceHeader->getPath();
-
       if (resource == NULL)
-      {
-         if ( !getStaticLoadSignal().trigger(path, &resource) && (resource != NULL) )
-         {
-            mResourceHeader->mResource = createHolder(resource);
-            mResourceHeader->mNotifyUnload = _getNotifyUnloadFn();
-            _triggerPostLoadSignal();
-            return;
-         }
-
-         resource = create(path);
-      }
-
-      if (resource)
-      {
-         mResourceHeader->mResource = createHolder(resource);
-         mResourceHeader->mNotifyUnload = _getNotifyUnloadFn();
-         _triggerPostLoadSignal();
-      }
-      else
-      {
-         // Failed to create...delete signature so we can attempt to successfully create resource later
-         Con::warnf("Failed to create resource: [%s]", path.getFullPath().c_str() );
-
-         mResourceHeader->mSignature = 0;
-      }
+         resource = _createResource(mResourceHeader->getPath());
+
+      _setResource(resource);
+   }
+}
+
+void ResourceBase::assignAsync(const ResourceBase &inResource, F32 priority)
+{
+   mResourceHeader = inResource.mResourceHeader;
+
+   if ( mResourceHeader == NULL || mResourceHeader.getPointer() == &(ResourceBase::smBlank) )
+      return;
+
+   if (mResourceHeader->getSignature())
+   {
+      // Already loaded or loading.
+      AssertFatal(inResource.mResourceHeader->getSignature() == getSignature(),"Resource::assignAsync: mis-matching signature");
+      return;
    }
+
+   mResourceHeader->mSignature = getSignature();
+   ResourceManager::get()._startAsyncLoad(*this, priority);
+}
+
+void ResourceBase::_completeAsyncLoad() const
+{
+   ResourceManager::get()._completeAsyncLoad(mResourceHeader);
+}
+
+void *ResourceBase::_createResource(const Torque::Path &path)
+{
+   void *resource = NULL;
+
+   if ( !getStaticLoadSignal().trigger(path, &resource) && (resource != NULL) )
+      return resource;
+
+   return create(path);
+}
+
+bool ResourceBase::_setResource(void *resource)
+{
+   if (resource)
+   {
+      mResourceHeader->mResource = createHolder(resource);
+      mResourceHeader->mNotifyUnload = _getNotifyUnloadFn();
+      _triggerPostLoadSignal();
+      return true;
+   }
+
+   // Failed to create...delete signature so we can attempt to successfully create resource later
+   Con::warnf("Failed to create resource: [%s]", mResourceHeader->getPath().getFullPath().c_str() );
+
+   mResourceHeader->mSignature = 0;
+   return false;
 }
 
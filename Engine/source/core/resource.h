@@ -48,6 +48,7 @@
 #endif
 
 class ResourceManager;
+struct ResourceAsyncLoad;
 
 // This is a utility class used by the resource manager.
 // The prime responsibility of this class is to delete
@@ -107,6 +108,40 @@ public:
       return mResourceHeader->getChecksum();
    }
 
+   /// Return true if the resource is still being loaded asynchronously.
+   /// @see ResourceManager::loadAsync
+   bool isLoading() const { return mResourceHeader->mAsyncLoad != NULL; }
+
+   /// Return true if the resource data is available.
+   bool isLoaded() const { return mResourceHeader->getResource() != NULL; }
+
+   /// Functions used to load a resource type asynchronously.
+   /// @see ResourceRegisterAsyncLoader
+   struct AsyncLoader
+   {
+      /// Called on the main thread when the load is started, before the
+      /// decode function is queued.  Lets a type do the main thread work
+      /// that create() does ahead of reading the file.
+      typedef void ( *StartFn )( const Torque::Path &path );
+
+      /// Called on a worker thread to read and decode the resource.  Return
+      /// false if the resource can't be decoded off the main thread, in which
+      /// case it is created with create() on the main thread instead.
+      /// Otherwise set outDecoded to the decoded data, or NULL on failure.
+      typedef bool ( *DecodeFn )( const Torque::Path &path, void **outDecoded );
+
+      /// Called on the main thread to turn the decoded data into the
+      /// resource.  If there is no finish function, the decoded data
+      /// is the resource.
+      typedef void *( *FinishFn )( const Torque::Path &path, void *decoded );
+
+      StartFn start;
+      DecodeFn decode;
+      FinishFn finish;
+
+      AsyncLoader() : start( NULL ), decode( NULL ), finish( NULL ) {}
+   };
+
 protected:
 
    typedef void ( *NotifyUnloadFn )( const Torque::Path& path, void* resource );
@@ -117,7 +152,8 @@ protected:
       Header()
       : mSignature(0),
          mResource(NULL),
-         mNotifyUnload( NULL )
+         mNotifyUnload( NULL ),
+         mAsyncLoad( NULL )
       {
       }
 
@@ -138,6 +174,9 @@ protected:
       ResourceHolderBase*  mResource;
       Torque::Path         mPath;
       NotifyUnloadFn       mNotifyUnload;
+
+      /// The pending asynchronous load of this resource, if any.
+      ResourceAsyncLoad*   mAsyncLoad;
    };
 
 protected:
@@ -148,6 +187,31 @@ protected:
 
    void assign(const ResourceBase &inResource, void* resource = NULL);
 
+   /// Like assign() but the resource is loaded in the background when it
+   /// isn't already loaded.
+   /// @see ResourceManager::loadAsync
+   void assignAsync(const ResourceBase &inResource, F32 priority);
+
+   /// Complete the pending asynchronous load of the resource.  Must be
+   /// called on the main thread.
+   void _completeAsyncLoad() const;
+
+   /// Return the resource data, completing a pending asynchronous load
+   /// first.
+   void *_getResource() const
+   {
+      if (isLoading())
+         _completeAsyncLoad();
+      return mResourceHeader->getResource();
+   }
+
+   /// Create the resource through the load signal or create().
+   void *_createResource(const Torque::Path &path);
+
+   /// Attach the created resource to the header, or mark the header as
+   /// failed if it is NULL.  Return true on success.
+   bool _setResource(void *resource);
+
    // The following functions are virtual, but cannot be pure-virtual
    // because we need to be able to instantiate this class.
 
@@ -184,6 +248,15 @@ protected:
    
    virtual void _triggerPostLoadSignal() {}
    virtual NotifyUnloadFn _getNotifyUnloadFn() { return ( NotifyUnloadFn ) NULL; }
+
+   virtual AsyncLoader &_getAsyncLoader()
+   {
+      static AsyncLoader sLoader;
+      return sLoader;
+   }
+
+   /// Return a new handle of the same resource type to the same resource.
+   virtual ResourceBase *_clone() const { return new ResourceBase( *this ); }
 };
 
 // This is a utility class used by resource manager.  Classes derived
@@ -250,9 +323,18 @@ public:
       return sUnloadSignal;
    }
 
+   /// The functions used to load resources of this type asynchronously.  Types
+   /// without a decode function are created on the main thread.
+   /// @see ResourceRegisterAsyncLoader
+   static AsyncLoader &getAsyncLoader()
+   {
+      static AsyncLoader sLoader;
+      return sLoader;
+   }
+
 private:
-   T        *getResource() { return (T*)mResourceHeader->getResource(); }
-   const T  *getResource() const { return (T*)mResourceHeader->getResource(); }
+   T        *getResource() { return (T*)_getResource(); }
+   const T  *getResource() const { return (T*)_getResource(); }
 
    Signature   getSignature() const { return Resource<T>::signature(); }
 
@@ -264,6 +346,8 @@ private:
    
    virtual void _triggerPostLoadSignal() { getPostLoadSignal().trigger( *this ); }
    virtual NotifyUnloadFn _getNotifyUnloadFn() { return ( NotifyUnloadFn ) &_notifyUnload; }
+   virtual AsyncLoader &_getAsyncLoader() { return getAsyncLoader(); }
+   virtual ResourceBase *_clone() const { return new Resource< T >( *this ); }
 
    // These are to be define by instantiated resources
    // No generic version is provided...however, since
@@ -309,6 +393,23 @@ class ResourceRegisterPostLoadSignal
       }
 };
 
+/// This template may be used to register asynchronous loading functions as follows:
+///   static ResourceRegisterAsyncLoader<T> sgAuto( decodeFunction, finishFunction, startFunction );
+template< class T >
+class ResourceRegisterAsyncLoader
+{
+   public:
+
+      ResourceRegisterAsyncLoader( ResourceBase::AsyncLoader::DecodeFn decode,
+                                   ResourceBase::AsyncLoader::FinishFn finish = NULL,
+                                   ResourceBase::AsyncLoader::StartFn start = NULL )
+      {
+         Resource< T >::getAsyncLoader().start = start;
+         Resource< T >::getAsyncLoader().decode = decode;
+         Resource< T >::getAsyncLoader().finish = finish;
+      }
+};
+
 template< class T >
 class ResourceRegisterUnloadSignal
 {
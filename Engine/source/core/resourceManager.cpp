@@ -25,7 +25,12 @@
 
 #include "core/volume.h"
 #include "console/console.h"
+#include "console/consoleTypes.h"
 #include "core/util/autoPtr.h"
+#include "core/module.h"
+#include "platform/threads/threadPool.h"
+#include "platform/threads/thread.h"
+#include "platform/profiler.h"
 
 #include "console/engineAPI.h"
 
@@ -33,6 +38,104 @@ using namespace Torque;
 
 static AutoPtr< ResourceManager > smInstance;
 
+S32 ResourceManager::smAsyncFinishTimeMS = 4;
+
+//-----------------------------------------------------------------------------
+//    Asynchronous loading.
+//-----------------------------------------------------------------------------
+
+/// State of an asynchronous load shared between the main thread and the
+/// worker decoding the resource.
+struct ResourceAsyncState : public ThreadSafeRefCount< ResourceAsyncState >
+{
+   enum Status
+   {
+      Queued,     ///< Waiting for a worker.
+      Decoding,   ///< A worker is decoding the resource.
+      Decoded,    ///< Ready to be finished on the main thread.
+      Taken,      ///< The main thread took the load before a worker did.
+   };
+
+   volatile U32 mStatus;
+   U32 mStatusPad;
+
+   Torque::Path mPath;
+   ResourceBase::AsyncLoader::DecodeFn mDecode;
+
+   /// Set by the worker; true if the decode function declined and the
+   /// resource has to be created on the main thread.
+   bool mCreateOnMainThread;
+
+   /// The decoded data.
+   void* mDecoded;
+
+   ResourceAsyncState()
+      : mStatus( Queued ),
+        mDecode( NULL ),
+        mCreateOnMainThread( false ),
+        mDecoded( NULL ) {}
+};
+
+/// A pending load, owned by the main thread.
+struct ResourceAsyncLoad
+{
+   /// Handle of the right resource type; keeps the header alive.
+   ResourceBase* mHandle;
+
+   ThreadSafeRef< ResourceAsyncState > mState;
+
+   ResourceManager::AsyncLoadSignal mSignal;
+
+   ResourceAsyncLoad() : mHandle( NULL ) {}
+   ~ResourceAsyncLoad() { delete mHandle; }
+};
+
+/// ThreadPool context for resource decoding.
+static ThreadContext sgResourceLoadContext( "ResourceLoad", ThreadContext::ROOT_CONTEXT(), 1.0f );
+
+/// Decodes a resource on a worker thread.
+class ResourceDecodeWorkItem : public ThreadWorkItem
+{
+public:
+
+   typedef ThreadWorkItem Parent;
+
+   ResourceDecodeWorkItem( ResourceAsyncState* state, F32 priority )
+      : Parent( &sgResourceLoadContext ),
+        mState( state ),
+        mPriority( priority ) {}
+
+   virtual F32 getPriority() { return mPriority; }
+
+   virtual bool isCancellationRequested()
+   {
+      return ( dAtomicRead( mState->mStatus ) == ResourceAsyncState::Taken );
+   }
+
+protected:
+
+   ThreadSafeRef< ResourceAsyncState > mState;
+   F32 mPriority;
+
+   virtual void execute()
+   {
+      if( !dCompareAndSwap( mState->mStatus, ResourceAsyncState::Queued, ResourceAsyncState::Decoding ) )
+         return;
+
+      PROFILE_SCOPE( ResourceDecodeWorkItem_execute );
+
+      void* decoded = NULL;
+      if( mState->mDecode( mState->mPath, &decoded ) )
+         mState->mDecoded = decoded;
+      else
+         mState->mCreateOnMainThread = true;
+
+      dCompareAndSwap( mState->mStatus, ResourceAsyncState::Decoding, ResourceAsyncState::Decoded );
+   }
+};
+
+//-----------------------------------------------------------------------------
+
 ResourceManager::ResourceManager()
 :  mIterSigFilter( U32_MAX )
 {
@@ -41,6 +144,15 @@ ResourceManager::ResourceManager()
 ResourceManager::~ResourceManager()
 {
    // TODO: Dump resources that have not been released?
+
+   // Drop pending loads.  Workers still holding their state will
+   // find it taken.
+   for ( U32 i = 0; i < mAsyncLoads.size(); i++ )
+   {
+      ResourceAsyncLoad *load = mAsyncLoads[i];
+      dCompareAndSwap( load->mState->mStatus, ResourceAsyncState::Queued, ResourceAsyncState::Taken );
+      load->mHandle->mResourceHeader->mAsyncLoad = NULL;
+   }
 }
 
 ResourceManager &ResourceManager::get()
@@ -164,6 +276,146 @@ bool ResourceManager::remove( ResourceBase::Header* header )
    return true;
 }
 
+void ResourceManager::_startAsyncLoad( ResourceBase &resource, F32 priority )
+{
+   AssertFatal( ThreadManager::isMainThread(), "ResourceManager::_startAsyncLoad - resources must be loaded from the main thread" );
+
+   ResourceBase::Header *header = resource.mResourceHeader;
+   AssertFatal( header->mAsyncLoad == NULL, "ResourceManager::_startAsyncLoad - resource is already loading" );
+
+#ifdef TORQUE_DEBUG_RES_MANAGER
+   Con::printf( "ResourceManager::_startAsyncLoad : [%s]", header->getPath().getFullPath().c_str() );
+#endif
+
+   ResourceAsyncLoad *load = new ResourceAsyncLoad;
+   load->mHandle = resource._clone();
+   load->mState = new ResourceAsyncState;
+   load->mState->mPath = header->getPath();
+   load->mState->mDecode = resource._getAsyncLoader().decode;
+
+   header->mAsyncLoad = load;
+   mAsyncLoads.push_back( load );
+
+   // Types without a decoder, or with load signal handlers that may want
+   // to take over, are created on the main thread.
+   if ( load->mState->mDecode == NULL || !resource.getStaticLoadSignal().isEmpty() )
+   {
+      load->mState->mStatus = ResourceAsyncState::Decoded;
+      load->mState->mCreateOnMainThread = true;
+      return;
+   }
+
+   ResourceBase::AsyncLoader::StartFn start = resource._getAsyncLoader().start;
+   if ( start )
+      start( load->mState->mPath );
+
+   ThreadSafeRef< ResourceDecodeWorkItem > item( new ResourceDecodeWorkItem( load->mState, priority ) );
+   ThreadPool::GLOBAL().queueWorkItem( item );
+}
+
+void ResourceManager::_completeAsyncLoad( ResourceBase::Header *header )
+{
+   AssertFatal( ThreadManager::isMainThread(), "ResourceManager::_completeAsyncLoad - resources must be loaded from the main thread" );
+
+   ResourceAsyncLoad *load = header->mAsyncLoad;
+   if ( !load )
+      return;
+
+   PROFILE_SCOPE( ResourceManager_completeAsyncLoad );
+
+   // Decode it here if no worker has started on it yet, otherwise wait
+   // for the worker to finish.  Decoding rather than calling create()
+   // keeps the start function from running twice.
+   ResourceAsyncState *state = load->mState;
+   if ( dCompareAndSwap( state->mStatus, ResourceAsyncState::Queued, ResourceAsyncState::Taken ) )
+   {
+      void* decoded = NULL;
+      if ( state->mDecode( state->mPath, &decoded ) )
+         state->mDecoded = decoded;
+      else
+         state->mCreateOnMainThread = true;
+   }
+   else
+   {
+      while ( dAtomicRead( state->mStatus ) == ResourceAsyncState::Decoding )
+         Platform::sleep( 0 );
+   }
+
+   mAsyncLoads.remove( load );
+   _finishAsyncLoad( load );
+}
+
+void ResourceManager::_finishAsyncLoad( ResourceAsyncLoad *load )
+{
+   ResourceBase *handle = load->mHandle;
+   ResourceAsyncState *state = load->mState;
+   ResourceBase::Header *header = handle->mResourceHeader;
+
+   header->mAsyncLoad = NULL;
+
+   void *resource = NULL;
+   if ( state->mCreateOnMainThread )
+      resource = handle->_createResource( state->mPath );
+   else if ( state->mDecoded )
+   {
+      ResourceBase::AsyncLoader::FinishFn finish = handle->_getAsyncLoader().finish;
+      resource = finish ? finish( state->mPath, state->mDecoded ) : state->mDecoded;
+   }
+
+   const bool success = handle->_setResource( resource );
+   load->mSignal.trigger( *handle, success );
+
+   delete load;
+}
+
+ResourceManager::AsyncLoadSignal *ResourceManager::getAsyncLoadSignal( const ResourceBase &resource )
+{
+   ResourceAsyncLoad *load = resource.mResourceHeader->mAsyncLoad;
+   return load ? &load->mSignal : NULL;
+}
+
+void ResourceManager::processAsyncLoads()
+{
+   if ( mAsyncLoads.empty() )
+      return;
+
+   PROFILE_SCOPE( ResourceManager_processAsyncLoads );
+
+   const U32 endTime = Platform::getRealMilliseconds() + getMax( smAsyncFinishTimeMS, 0 );
+   bool finishedOne = false;
+
+   for ( U32 i = 0; i < mAsyncLoads.size(); )
+   {
+      ResourceAsyncLoad *load = mAsyncLoads[i];
+      ResourceAsyncState *state = load->mState;
+
+      // Nobody but us holds the resource anymore, so cancel it if we can.
+      if ( load->mHandle->mResourceHeader->getRefCount() == 1 &&
+           dCompareAndSwap( state->mStatus, ResourceAsyncState::Queued, ResourceAsyncState::Taken ) )
+      {
+         mAsyncLoads.erase( i );
+
+         load->mHandle->mResourceHeader->mAsyncLoad = NULL;
+         load->mHandle->mResourceHeader->mSignature = 0;
+         load->mSignal.trigger( *load->mHandle, false );
+         delete load;
+         continue;
+      }
+
+      if ( dAtomicRead( state->mStatus ) != ResourceAsyncState::Decoded ||
+           ( finishedOne && Platform::getRealMilliseconds() >= endTime ) )
+      {
+         i++;
+         continue;
+      }
+
+      // Remove it before finishing as the signals may start new loads.
+      mAsyncLoads.erase( i );
+      _finishAsyncLoad( load );
+      finishedOne = true;
+   }
+}
+
 void ResourceManager::notifiedFileChanged( const Torque::Path &path )
 {
    reloadResource( path, true );
@@ -247,4 +499,20 @@ DefineEngineFunction( reloadResource, void, ( const char* path ),,
    ResourceManager::get().reloadResource( path );
 }
 
+DefineEngineFunction( getNumPendingResourceLoads, S32, (),,
+   "Return the number of resources that are still being loaded in the background.\n"
+   "@ingroup Editors\n"
+   "@internal")
+{
+   return ResourceManager::get().getNumAsyncLoads();
+}
+
 ConsoleFunctionGroupEnd( ResourceManagerFunctions );
+
+AFTER_MODULE_INIT( Sim )
+{
+   Con::addVariable( "$ResourceManager::asyncFinishTimeMS", TypeS32, &ResourceManager::smAsyncFinishTimeMS,
+      "Milliseconds per frame the main thread may spend finishing resources loaded in the background.\n"
+      "At least one resource is finished every frame.\n"
+      "@ingroup Console\n" );
+}
@@ -31,6 +31,10 @@
 #include "core/util/tDictionary.h"
 #endif
 
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
 class ResourceManager
 {
 public:
@@ -40,6 +44,46 @@ public:
    ResourceBase load(const Torque::Path &path);
    ResourceBase find(const Torque::Path &path);
 
+   /// Start loading the resource at path in the background and return a
+   /// pending handle to it right away.
+   ///
+   /// The file is read and decoded on the global ThreadPool by the type's
+   /// registered AsyncLoader; what must happen on the main thread is done
+   /// from processAsyncLoads().  Types without a decode function are created
+   /// on the main thread from processAsyncLoads().
+   ///
+   /// Using the pending handle as a regular resource, by dereferencing it or
+   /// converting it to a pointer, completes the load on the spot.  Check
+   /// ResourceBase::isLoading() to avoid that.  Releasing every handle to a
+   /// resource that is still queued cancels its load.
+   ///
+   /// @param priority Priority relative to other ThreadPool work items.
+   /// @see getAsyncLoadSignal
+   template<class T> Resource<T> loadAsync(const Torque::Path &path, F32 priority = 1.0f)
+   {
+      Resource<T> resource;
+      static_cast<ResourceBase&>(resource).assignAsync(load(path), priority);
+      return resource;
+   }
+
+   /// Signal fired on the main thread when an asynchronous load has completed.
+   typedef Signal<void(const ResourceBase &resource, bool success)> AsyncLoadSignal;
+
+   /// Return the completion signal of a pending resource or NULL if the
+   /// resource is not loading.
+   AsyncLoadSignal *getAsyncLoadSignal(const ResourceBase &resource);
+
+   /// Finish asynchronous loads that are ready, within the time budget
+   /// of smAsyncFinishTimeMS.  Called once per frame from the main loop.
+   void processAsyncLoads();
+
+   /// Return the number of asynchronous loads that have not completed.
+   U32 getNumAsyncLoads() const { return mAsyncLoads.size(); }
+
+   /// Milliseconds per frame processAsyncLoads() may spend finishing loads.
+   /// At least one load is finished each frame.
+   static S32 smAsyncFinishTimeMS;
+
    ResourceBase startResourceList( ResourceBase::Signature inSignature = U32_MAX );
    ResourceBase nextResource();
 
@@ -62,6 +106,7 @@ public:
 
 protected:
 
+   friend class ResourceBase;
    friend class ResourceBase::Header;
 
    ResourceManager();
@@ -70,6 +115,16 @@ protected:
 
    void  notifiedFileChanged( const Torque::Path &path );
 
+   /// Queue the asynchronous load of a resource whose header has just
+   /// been given its signature.
+   void _startAsyncLoad( ResourceBase &resource, F32 priority );
+
+   /// Complete the pending load of a header right away.
+   void _completeAsyncLoad( ResourceBase::Header *header );
+
+   /// Create the resource of a load and fire its completion signal.
+   void _finishAsyncLoad( ResourceAsyncLoad *load );
+
    typedef HashTable<String,ResourceBase::Header*> ResourceHeaderMap;
 
    /// The map of resources.
@@ -84,6 +139,10 @@ protected:
    U32 mIterSigFilter;
 
    ChangedSignal mChangeSignal;
+
+   /// Asynchronous loads that have not completed, in the order they
+   /// were started.
+   Vector<ResourceAsyncLoad*> mAsyncLoads;
 };
 
 #endif
@@ -23,9 +23,10 @@
 #include "core/strings/stringFunctions.h"
 #include "core/stringTable.h"
 #include "platform/profiler.h"
+#include "platform/platformIntrinsics.h"
 
 _StringTable *_gStringTable = NULL;
-const U32 _StringTable::csm_stInitSize = 29;
+const U32 _StringTable::csm_stInitSize = 7;
 
 //---------------------------------------------------------------
 //
@@ -82,19 +83,52 @@ U32 _StringTable::hashStringn(const char* str, S32 len)
 //--------------------------------------
 _StringTable::_StringTable()
 {
-   buckets = (Node **) dMalloc(csm_stInitSize * sizeof(Node *));
-   for(U32 i = 0; i < csm_stInitSize; i++) {
-      buckets[i] = 0;
+   for(U32 i = 0; i < NumShards; i++)
+   {
+      mShards[i].buckets = allocBuckets(csm_stInitSize);
+      mShards[i].itemCount = 0;
+      mShards[i].lock = 0;
    }
-
-   numBuckets = csm_stInitSize;
-   itemCount = 0;
 }
 
 //--------------------------------------
 _StringTable::~_StringTable()
 {
-   dFree(buckets);
+   for(U32 i = 0; i < NumShards; i++)
+   {
+      BucketArray *walk = mShards[i].buckets;
+      while(walk)
+      {
+         BucketArray *temp = walk->retiredNext;
+         dFree(walk);
+         walk = temp;
+      }
+   }
+}
+
+//--------------------------------------
+_StringTable::BucketArray* _StringTable::allocBuckets(const U32 numBuckets)
+{
+   BucketArray *array = (BucketArray *) dMalloc(sizeof(BucketArray) + (numBuckets - 1) * sizeof(Node *));
+   array->numBuckets = numBuckets;
+   array->retiredNext = NULL;
+   for(U32 i = 0; i < numBuckets; i++)
+      array->buckets[i] = NULL;
+   return array;
+}
+
+//--------------------------------------
+void _StringTable::lockShard(Shard &shard)
+{
+   // Inserts of new strings are short and rare once the game is running,
+   // so spinning is cheaper than an OS mutex.
+   while(!dCompareAndSwap(shard.lock, 0, 1))
+      Platform::sleep(0);
+}
+
+void _StringTable::unlockShard(Shard &shard)
+{
+   dCompareAndSwap(shard.lock, 1, 0);
 }
 
 
@@ -104,6 +138,9 @@ void _StringTable::create()
    //AssertFatal(_gStringTable == NULL, "StringTable::create: StringTable already exists.");
    if(!_gStringTable)
    {
+      if (sgInitTable)
+         initTolowerTable();
+
       _gStringTable = new _StringTable;
       _gStringTable->_EmptyString = _gStringTable->insert("");
    }
@@ -119,6 +156,31 @@ void _StringTable::destroy()
 }
 
 
+//--------------------------------------
+StringTableEntry _StringTable::find(const Shard &shard, U32 key, const char *val, S32 len, const bool caseSens)
+{
+   const BucketArray *array = shard.buckets;
+   const Node *walk = array->buckets[key % array->numBuckets];
+   for(; walk; walk = walk->next)
+   {
+      if(len < 0)
+      {
+         if(caseSens && !dStrcmp(walk->val, val))
+            return walk->val;
+         else if(!caseSens && !dStricmp(walk->val, val))
+            return walk->val;
+      }
+      else
+      {
+         if(caseSens && !dStrncmp(walk->val, val, len) && walk->val[len] == 0)
+            return walk->val;
+         else if(!caseSens && !dStrnicmp(walk->val, val, len) && walk->val[len] == 0)
+            return walk->val;
+      }
+   }
+   return NULL;
+}
+
 //--------------------------------------
 StringTableEntry _StringTable::insert(const char* _val, const bool caseSens)
 {
@@ -130,29 +192,49 @@ StringTableEntry _StringTable::insert(const char* _val, const bool caseSens)
       val = "";
    //-
 
-   Node **walk, *temp;
    U32 key = hashString(val);
-   walk = &buckets[key % numBuckets];
+   Shard &shard = getShard(key);
+
+   // Most inserts are of strings already in the table, so look first
+   // without taking the lock.
+   StringTableEntry ret = find(shard, key, val, -1, caseSens);
+   if(ret)
+      return ret;
+
+   lockShard(shard);
+
+   // Walk again, another thread may have added the string meanwhile.
+   // New strings go to the end of the bucket list so that case sens
+   // strings are always after their corresponding case insens strings.
+   BucketArray *array = shard.buckets;
+   Node * volatile *walk = &array->buckets[key % array->numBuckets];
+   Node *temp;
    while((temp = *walk) != NULL)   {
-      if(caseSens && !dStrcmp(temp->val, val))
-         return temp->val;
-      else if(!caseSens && !dStricmp(temp->val, val))
+      if((caseSens && !dStrcmp(temp->val, val)) || (!caseSens && !dStricmp(temp->val, val)))
+      {
+         unlockShard(shard);
          return temp->val;
+      }
       walk = &(temp->next);
    }
-   char *ret = 0;
-   if(!*walk) {
-      *walk = (Node *) mempool.alloc(sizeof(Node));
-      (*walk)->next = 0;
-      (*walk)->val = (char *) mempool.alloc(dStrlen(val) + 1);
-      dStrcpy((*walk)->val, val);
-      ret = (*walk)->val;
-      itemCount ++;
-   }
-   if(itemCount > 2 * numBuckets) {
-      resize(4 * numBuckets - 1);
+
+   // Keep nodes pointer aligned, the string follows the node.
+   const U32 len = dStrlen(val);
+   Node *node = (Node *) shard.mempool.alloc((sizeof(Node) + len + 1 + 7) & ~7);
+   node->next = NULL;
+   node->val = (char *) (node + 1);
+   dStrcpy(node->val, val);
+
+   // Publish the node only once it is complete.
+   dCompareAndSwap(*walk, (Node *) NULL, node);
+
+   shard.itemCount ++;
+   if(shard.itemCount > 2 * array->numBuckets) {
+      resizeShard(shard, 4 * array->numBuckets - 1);
    }
-   return ret;
+
+   unlockShard(shard);
+   return node->val;
 }
 
 //--------------------------------------
@@ -170,17 +252,8 @@ StringTableEntry _StringTable::lookup(const char* val, const bool  caseSens)
 {
    PROFILE_SCOPE(StringTableLookup);
 
-   Node **walk, *temp;
    U32 key = hashString(val);
-   walk = &buckets[key % numBuckets];
-   while((temp = *walk) != NULL)   {
-      if(caseSens && !dStrcmp(temp->val, val))
-            return temp->val;
-      else if(!caseSens && !dStricmp(temp->val, val))
-         return temp->val;
-      walk = &(temp->next);
-   }
-   return NULL;
+   return find(getShard(key), key, val, -1, caseSens);
 }
 
 //--------------------------------------
@@ -188,56 +261,59 @@ StringTableEntry _StringTable::lookupn(const char* val, S32 len, const bool  cas
 {
    PROFILE_SCOPE(StringTableLookupN);
 
-   Node **walk, *temp;
    U32 key = hashStringn(val, len);
-   walk = &buckets[key % numBuckets];
-   while((temp = *walk) != NULL) {
-      if(caseSens && !dStrncmp(temp->val, val, len) && temp->val[len] == 0)
-         return temp->val;
-      else if(!caseSens && !dStrnicmp(temp->val, val, len) && temp->val[len] == 0)
-         return temp->val;
-      walk = &(temp->next);
-   }
-   return NULL;
+   return find(getShard(key), key, val, len, caseSens);
 }
 
 //--------------------------------------
 void _StringTable::resize(const U32 _newSize)
+{
+   const U32 newSize = _newSize / NumShards;
+
+   for(U32 i = 0; i < NumShards; i++)
+   {
+      lockShard(mShards[i]);
+      resizeShard(mShards[i], newSize);
+      unlockShard(mShards[i]);
+   }
+}
+
+//--------------------------------------
+void _StringTable::resizeShard(Shard &shard, const U32 _newSize)
 {
    /// avoid a possible 0 division
    const U32 newSize = _newSize ? _newSize : 1;
 
-   Node *head = NULL, *walk, *temp;
-   U32 i;
-   // reverse individual bucket lists
-   // we do this because new strings are added at the end of bucket
-   // lists so that case sens strings are always after their
-   // corresponding case insens strings
+   BucketArray *oldArray = shard.buckets;
+   BucketArray *newArray = allocBuckets(newSize);
 
-   for(i = 0; i < numBuckets; i++) {
-      walk = buckets[i];
-      while(walk)
+   // Readers may still be walking the old lists, so copy the nodes
+   // instead of relinking them.  Appending in the old order keeps case
+   // sens strings after their corresponding case insens strings.
+   Node **tails = (Node **) dMalloc(newSize * sizeof(Node *));
+   for(U32 i = 0; i < newSize; i++)
+      tails[i] = NULL;
+
+   for(U32 i = 0; i < oldArray->numBuckets; i++) {
+      for(Node *walk = oldArray->buckets[i]; walk; walk = walk->next)
       {
-         temp = walk->next;
-         walk->next = head;
-         head = walk;
-         walk = temp;
+         const U32 index = hashString(walk->val) % newSize;
+
+         Node *temp = (Node *) shard.mempool.alloc((sizeof(Node) + 7) & ~7);
+         temp->val = walk->val;
+         temp->next = NULL;
+
+         if(tails[index])
+            tails[index]->next = temp;
+         else
+            newArray->buckets[index] = temp;
+         tails[index] = temp;
       }
    }
-   buckets = (Node **) dRealloc(buckets, newSize * sizeof(Node));
-   for(i = 0; i < newSize; i++) {
-      buckets[i] = 0;
-   }
-   numBuckets = newSize;
-   walk = head;
-   while(walk) {
-      U32 key;
-      Node *temp = walk;
-
-      walk = walk->next;
-      key = hashString(temp->val);
-      temp->next = buckets[key % newSize];
-      buckets[key % newSize] = temp;
-   }
-}
 
+   dFree(tails);
+
+   // Swap in the new array and keep the old one alive.
+   newArray->retiredNext = oldArray;
+   dCompareAndSwap(shard.buckets, oldArray, newArray);
+}
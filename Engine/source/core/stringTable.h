@@ -70,6 +70,13 @@
 ///  The scripting engine and the resource manager are the primary users of the
 ///  StringTable.
 ///
+/// The table may be used from any thread.  It is split into shards by hash,
+/// each with its own bucket array, arena and insert lock, so inserts on
+/// different threads rarely contend.  Lookups, and inserts of strings that
+/// are already present, take no lock at all: nodes are only ever appended to
+/// a chain, and a shard that grows gets a fresh bucket array and fresh nodes
+/// instead of relinking the ones readers may be walking.
+///
 /// @note Be aware that the StringTable NEVER DEALLOCATES memory, so be careful when you
 ///       add strings to it. If you carelessly add many strings, you will end up wasting
 ///       space.
@@ -83,16 +90,50 @@ private:
    struct Node
    {
       char *val;
-      Node *next;
+      Node * volatile next;
+   };
+
+   /// Buckets of a shard.  Never changed once replaced, so readers that
+   /// still hold an old array can finish walking it.
+   struct BucketArray
+   {
+      U32 numBuckets;
+      BucketArray *retiredNext;  ///< Older arrays kept until the table is destroyed.
+      Node * volatile buckets[1];
    };
 
-   Node**      buckets;
-   U32         numBuckets;
-   U32         itemCount;
-   DataChunker mempool;
+   struct Shard
+   {
+      BucketArray * volatile buckets;
+      U32 itemCount;
+      volatile U32 lock;         ///< Held while inserting.
+      DataChunker mempool;
+   };
+
+   enum
+   {
+      NumShards = 64,            ///< Must be a power of two.
+      ShardShift = 26            ///< 32 - log2(NumShards)
+   };
+
+   Shard mShards[NumShards];
 
    StringTableEntry _EmptyString;
 
+   Shard& getShard(U32 key) { return mShards[(key * 2654435769U) >> ShardShift]; }
+
+   static BucketArray* allocBuckets(U32 numBuckets);
+
+   /// Find a string in the current buckets of a shard without locking.
+   /// @param len Length of @a val, or -1 if it is zero terminated.
+   static StringTableEntry find(const Shard &shard, U32 key, const char *val, S32 len, bool caseSens);
+
+   void lockShard(Shard &shard);
+   void unlockShard(Shard &shard);
+
+   /// Give a shard a new bucket array.  The shard must be locked.
+   void resizeShard(Shard &shard, U32 newSize);
+
   protected:
    static const U32 csm_stInitSize;
 
@@ -144,8 +185,8 @@ private:
 
 
    /// Resize the StringTable to be able to hold newSize items. This
-   /// is called automatically by the StringTable when the table is
-   /// full past a certain threshhold.
+   /// is called automatically for each shard of the StringTable when
+   /// it is full past a certain threshhold.
    ///
    /// @param newSize   Number of new items to allocate space for.
    void             resize(const U32 newSize);
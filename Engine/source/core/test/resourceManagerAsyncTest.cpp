@@ -0,0 +1,191 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "platform/platformIntrinsics.h"
+#include "core/resourceManager.h"
+#include "core/util/fourcc.h"
+#include "core/strings/stringFunctions.h"
+
+/// A resource type whose data is the number in its file name.
+struct AsyncTestResource
+{
+   S32 value;
+   bool finished;
+};
+
+namespace {
+
+   /// Order in which the load steps last ran.
+   volatile U32 sgAsyncStep;
+   U32 sgStartStep;
+   U32 sgDecodeStep;
+   U32 sgFinishStep;
+   volatile U32 sgNumDecodes;
+   U32 sgNumCreates;
+
+   void resetSteps()
+   {
+      sgAsyncStep = 0;
+      sgStartStep = sgDecodeStep = sgFinishStep = 0;
+      sgNumDecodes = 0;
+      sgNumCreates = 0;
+   }
+
+   void startAsyncTest(const Torque::Path &path)
+   {
+      dFetchAndAdd(sgAsyncStep, 1);
+      sgStartStep = dAtomicRead(sgAsyncStep);
+   }
+
+   bool decodeAsyncTest(const Torque::Path &path, void **outDecoded)
+   {
+      // Keep the load pending for a while.
+      Platform::sleep(20);
+
+      AsyncTestResource *res = new AsyncTestResource;
+      res->value = dAtoi(path.getFileName());
+      res->finished = false;
+      *outDecoded = res;
+
+      dFetchAndAdd(sgAsyncStep, 1);
+      sgDecodeStep = dAtomicRead(sgAsyncStep);
+      dFetchAndAdd(sgNumDecodes, 1);
+      return true;
+   }
+
+   void *finishAsyncTest(const Torque::Path &path, void *decoded)
+   {
+      dFetchAndAdd(sgAsyncStep, 1);
+      sgFinishStep = dAtomicRead(sgAsyncStep);
+
+      AsyncTestResource *res = reinterpret_cast<AsyncTestResource*>(decoded);
+      res->finished = true;
+      return res;
+   }
+
+   ResourceRegisterAsyncLoader<AsyncTestResource> sgAsyncTestLoader(decodeAsyncTest, finishAsyncTest, startAsyncTest);
+
+   struct AsyncLoadListener
+   {
+      U32 mNumCalls;
+      bool mSuccess;
+
+      AsyncLoadListener() : mNumCalls(0), mSuccess(false) {}
+
+      void onLoaded(const ResourceBase &resource, bool success)
+      {
+         mNumCalls++;
+         mSuccess = success;
+      }
+   };
+
+} // namespace
+
+template<> void *Resource<AsyncTestResource>::create(const Torque::Path &path)
+{
+   sgNumCreates++;
+
+   AsyncTestResource *res = new AsyncTestResource;
+   res->value = dAtoi(path.getFileName());
+   res->finished = false;
+   return res;
+}
+
+template<> ResourceBase::Signature Resource<AsyncTestResource>::signature()
+{
+   return MakeFourCC('a','t','s','t');
+}
+
+TEST(ResourceManager, AsyncDereferenceCompletesLoad)
+{
+   resetSteps();
+
+   Resource<AsyncTestResource> res = ResourceManager::get().loadAsync<AsyncTestResource>("asyncTest/42.tst");
+   EXPECT_TRUE(res.isLoading());
+   EXPECT_FALSE(res.isLoaded());
+
+   // Using the handle must finish the load rather than return NULL.
+   AsyncTestResource *data = res;
+   ASSERT_TRUE(data != NULL);
+   EXPECT_EQ(42, data->value);
+   EXPECT_TRUE(data->finished);
+   EXPECT_EQ(42, res->value);
+   EXPECT_FALSE(res.isLoading());
+   EXPECT_TRUE(res.isLoaded());
+
+   // Start, decode and finish ran once each and in that order.
+   EXPECT_EQ(1, sgNumDecodes);
+   EXPECT_EQ(0, sgNumCreates);
+   EXPECT_EQ(1, sgStartStep);
+   EXPECT_EQ(2, sgDecodeStep);
+   EXPECT_EQ(3, sgFinishStep);
+}
+
+TEST(ResourceManager, AsyncProcessFinishesLoad)
+{
+   resetSteps();
+
+   Resource<AsyncTestResource> res = ResourceManager::get().loadAsync<AsyncTestResource>("asyncTest/7.tst");
+   ASSERT_TRUE(res.isLoading());
+
+   AsyncLoadListener listener;
+   ResourceManager::get().getAsyncLoadSignal(res)->notify(&listener, &AsyncLoadListener::onLoaded);
+
+   const U32 limit = Platform::getRealMilliseconds() + 5000;
+   while (res.isLoading() && Platform::getRealMilliseconds() < limit)
+   {
+      ResourceManager::get().processAsyncLoads();
+      Platform::sleep(1);
+   }
+
+   EXPECT_FALSE(res.isLoading());
+   EXPECT_EQ(1, listener.mNumCalls);
+   EXPECT_TRUE(listener.mSuccess);
+
+   EXPECT_EQ(7, res->value);
+   EXPECT_TRUE(res->finished);
+   EXPECT_EQ(1, sgNumDecodes);
+   EXPECT_EQ(0, sgNumCreates);
+   EXPECT_EQ(3, sgFinishStep);
+}
+
+TEST(ResourceManager, AsyncLoadOfLoadedResource)
+{
+   resetSteps();
+
+   Resource<AsyncTestResource> loaded = ResourceManager::get().load("asyncTest/3.tst");
+   ASSERT_TRUE(loaded != NULL);
+   EXPECT_EQ(1, sgNumCreates);
+
+   // Already loaded; nothing is queued.
+   Resource<AsyncTestResource> res = ResourceManager::get().loadAsync<AsyncTestResource>("asyncTest/3.tst");
+   EXPECT_FALSE(res.isLoading());
+   EXPECT_EQ(3, res->value);
+   EXPECT_EQ(0, sgNumDecodes);
+   EXPECT_EQ(0, sgStartStep);
+}
+
+#endif
@@ -0,0 +1,161 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "platform/threads/thread.h"
+#include "core/stringTable.h"
+#include "core/strings/stringFunctions.h"
+#include "console/console.h"
+
+FIXTURE(StringTables)
+{
+public:
+   enum
+   {
+      NumThreads = 4,
+      NumStrings = 20000,
+   };
+
+   /// Inserts the same set of strings as every other thread, in a
+   /// different order, and remembers the entries it got.
+   struct InsertThread : public Thread
+   {
+      const char *mPrefix;
+      U32 mOffset;
+      StringTableEntry *mEntries;
+
+      InsertThread(const char *prefix, U32 offset, StringTableEntry *entries)
+         : mPrefix(prefix), mOffset(offset), mEntries(entries) {}
+
+      virtual void run(void*)
+      {
+         char buffer[64];
+         for(U32 i = 0; i < NumStrings; i++)
+         {
+            const U32 index = (i + mOffset) % NumStrings;
+            dSprintf(buffer, sizeof(buffer), "%s_%d", mPrefix, index);
+            mEntries[index] = StringTable->insert(buffer);
+
+            // Hit strings another thread is likely adding right now.
+            dSprintf(buffer, sizeof(buffer), "%s_%d", mPrefix, (index + 1) % NumStrings);
+            StringTable->lookup(buffer);
+         }
+      }
+   };
+
+   /// Runs one InsertThread per thread and returns the time taken.
+   static U32 insertFromThreads(const char *prefix, U32 numThreads, StringTableEntry entries[][NumStrings])
+   {
+      InsertThread *threads[NumThreads];
+      const U32 start = Platform::getRealMilliseconds();
+
+      for(U32 i = 0; i < numThreads; i++)
+      {
+         threads[i] = new InsertThread(prefix, i * (NumStrings / numThreads), entries[i]);
+         threads[i]->start();
+      }
+      for(U32 i = 0; i < numThreads; i++)
+      {
+         threads[i]->join();
+         delete threads[i];
+      }
+
+      return Platform::getRealMilliseconds() - start;
+   }
+};
+
+TEST_FIX(StringTables, CaseSensitivity)
+{
+   StringTableEntry upper = StringTable->insert("StringTableTest_Case");
+   EXPECT_EQ(upper, StringTable->insert("stringtabletest_case"));
+   EXPECT_EQ(upper, StringTable->lookup("STRINGTABLETEST_CASE"));
+
+   StringTableEntry lower = StringTable->insert("stringtabletest_case", true);
+   EXPECT_NE(upper, lower);
+   EXPECT_STREQ("stringtabletest_case", lower);
+   EXPECT_EQ(lower, StringTable->lookup("stringtabletest_case", true));
+
+   // Insensitive lookups keep finding the first spelling.
+   EXPECT_EQ(upper, StringTable->lookup("stringtabletest_case"));
+
+   EXPECT_EQ(upper, StringTable->lookupn("StringTableTest_CaseXYZ", 20));
+   EXPECT_TRUE(StringTable->lookup("StringTableTest_Missing") == NULL);
+   EXPECT_EQ(StringTable->EmptyString(), StringTable->insert(NULL));
+}
+
+TEST_FIX(StringTables, EntriesSurviveGrowth)
+{
+   char buffer[64];
+   Vector<StringTableEntry> entries;
+   for(U32 i = 0; i < 10000; i++)
+   {
+      dSprintf(buffer, sizeof(buffer), "StringTableTest_Grow_%d", i);
+      entries.push_back(StringTable->insert(buffer));
+   }
+
+   for(U32 i = 0; i < entries.size(); i++)
+   {
+      dSprintf(buffer, sizeof(buffer), "StringTableTest_Grow_%d", i);
+      EXPECT_EQ(entries[i], StringTable->lookup(buffer));
+      EXPECT_STREQ(buffer, entries[i]);
+   }
+}
+
+TEST_FIX(StringTables, ConcurrentInserts)
+{
+   static StringTableEntry entries[NumThreads][NumStrings];
+   insertFromThreads("StringTableTest_Concurrent", NumThreads, entries);
+
+   // Every thread must have gotten the same entry for a string.
+   char buffer[64];
+   for(U32 i = 0; i < NumStrings; i++)
+   {
+      dSprintf(buffer, sizeof(buffer), "StringTableTest_Concurrent_%d", i);
+      StringTableEntry entry = StringTable->lookup(buffer);
+      ASSERT_TRUE(entry != NULL);
+      EXPECT_STREQ(buffer, entry);
+
+      for(U32 t = 0; t < NumThreads; t++)
+         EXPECT_EQ(entry, entries[t][i]);
+   }
+}
+
+TEST_FIX(StringTables, ContentionBenchmark)
+{
+   static StringTableEntry entries[NumThreads][NumStrings];
+
+   // New strings, then the same strings again, which is the common case
+   // of loaders resolving names that are already known.
+   const U32 single = insertFromThreads("StringTableTest_Bench1", 1, entries);
+   const U32 singleHits = insertFromThreads("StringTableTest_Bench1", 1, entries);
+   const U32 multi = insertFromThreads("StringTableTest_BenchN", NumThreads, entries);
+   const U32 multiHits = insertFromThreads("StringTableTest_BenchN", NumThreads, entries);
+
+   Con::printf("StringTableBenchmark: %d strings, 1 thread %d ms (%d ms again), "
+      "%d threads each inserting all %d ms (%d ms again)",
+      NumStrings, single, singleHits, NumThreads, multi, multiHits);
+}
+
+#endif
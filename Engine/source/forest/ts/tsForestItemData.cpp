@@ -66,6 +66,12 @@ void TSForestItemData::_updateCollisionDetails()
    mCollisionDetails.clear();
    mLOSDetails.clear();
    mShape->findColDetails( false, &mCollisionDetails, &mLOSDetails );
+
+   // Build the hull accelerators now, as ShapeBaseData does, so that
+   // ForestConvex::support() only reads the shape when it is called from
+   // the collision worker threads.
+   for ( U32 i = 0; i < mCollisionDetails.size(); i++ )
+      mShape->getAccelerator( mCollisionDetails[i] );
 }
 
 bool TSForestItemData::onAdd()
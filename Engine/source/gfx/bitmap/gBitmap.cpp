@@ -1081,7 +1081,9 @@ bool  GBitmap::writeBitmap( const String &bmType, Stream &ioStream, U32 compress
    return regInfo->writeFunc( this, ioStream, (compressionLevel == U32_MAX) ? regInfo->defaultCompression : compressionLevel );
 }
 
-template<> void *Resource<GBitmap>::create(const Torque::Path &path)
+/// Read and decode a bitmap file.  Only touches the stream and the new
+/// bitmap, so it is also used to decode bitmaps on worker threads.
+static GBitmap *_readBitmapFile(const Torque::Path &path)
 {
    PROFILE_SCOPE( ResourceGBitmap_create );
 
@@ -1111,6 +1113,19 @@ template<> void *Resource<GBitmap>::create(const Torque::Path &path)
    return bmp;
 }
 
+template<> void *Resource<GBitmap>::create(const Torque::Path &path)
+{
+   return _readBitmapFile( path );
+}
+
+static bool _decodeBitmapAsync(const Torque::Path &path, void **outDecoded)
+{
+   *outDecoded = _readBitmapFile( path );
+   return true;
+}
+
+static ResourceRegisterAsyncLoader< GBitmap > sgBitmapAsyncLoader( _decodeBitmapAsync );
+
 template<> ResourceBase::Signature  Resource<GBitmap>::signature()
 {
    return MakeFourCC('b','i','t','m');
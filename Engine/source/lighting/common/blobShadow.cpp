@@ -315,9 +315,9 @@ void BlobShadow::collisionCallback(SceneObject * obj, void* thisPtr)
    if (obj->getWorldBox().isOverlapped(gBlobShadowBox))
    {
       // only interiors clip...
-      ClippedPolyList::allowClipping = (obj->getTypeMask() & LIGHTMGR->getSceneLightingInterface()->mClippingMask) != 0;
+      smDepthSortList.mAllowClipping = (obj->getTypeMask() & LIGHTMGR->getSceneLightingInterface()->mClippingMask) != 0;
       obj->buildPolyList(PLC_Collision,&smDepthSortList,gBlobShadowBox,gBlobShadowSphere);
-      ClippedPolyList::allowClipping = true;
+      smDepthSortList.mAllowClipping = true;
    }
 }
 
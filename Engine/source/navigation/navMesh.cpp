@@ -22,6 +22,7 @@
 
 #include "navMesh.h"
 #include "navContext.h"
+#include "navPathService.h"
 #include <DetourDebugDraw.h>
 #include <RecastDebugDraw.h>
 
@@ -47,6 +48,8 @@ IMPLEMENT_CO_NETOBJECT_V1(NavMesh);
 
 const U32 NavMesh::mMaxVertsPerPoly = 3;
 
+U32 NavMesh::smMaxTileBuilds = 8;
+
 SimObjectPtr<SimSet> NavMesh::smServerSet = NULL;
 
 ImplementEnumType(NavMeshWaterMethod,
@@ -223,6 +226,8 @@ NavMesh::NavMesh()
 
 NavMesh::~NavMesh()
 {
+   cancelTileBuilds();
+   NavPathService::meshChanged(this);
    dtFreeNavMesh(nm);
    nm = NULL;
    delete ctx;
@@ -348,6 +353,14 @@ void NavMesh::initPersistFields()
    Parent::initPersistFields();
 }
 
+void NavMesh::consoleInit()
+{
+   Con::addVariable("$NavMesh::maxTileBuilds", TypeS32, &smMaxTileBuilds,
+      "@brief Maximum number of tiles generated in parallel by a background build.\n\n"
+      "Scene geometry for each tile is gathered on the main thread when its job starts.\n"
+      "@ingroup AI");
+}
+
 bool NavMesh::onAdd()
 {
    if(!Parent::onAdd())
@@ -385,6 +398,8 @@ void NavMesh::onRemove()
    if(getEventManager())
       getEventManager()->postEvent("NavMeshRemoved", getIdString());
 
+   cancelTileBuilds();
+
    removeFromScene();
 
    Parent::onRemove();
@@ -604,6 +619,10 @@ DefineEngineMethod(NavMesh, deleteLinks, void, (),,
 
 bool NavMesh::build(bool background, bool saveIntermediates)
 {
+   // Tile jobs read nm and cfg, which are replaced below. They may have
+   // been queued by buildTiles() without mBuilding being set.
+   cancelTileBuilds();
+
    if(mBuilding)
       cancelBuild();
    else
@@ -616,6 +635,7 @@ bool NavMesh::build(bool background, bool saveIntermediates)
 
    ctx->startTimer(RC_TIMER_TOTAL);
 
+   NavPathService::meshChanged(this);
    dtFreeNavMesh(nm);
    // Allocate a new navmesh.
    nm = dtAllocNavMesh();
@@ -659,8 +679,11 @@ bool NavMesh::build(bool background, bool saveIntermediates)
 
    if(!background)
    {
-      while(!mDirtyTiles.empty())
-         buildNextTile();
+      while(!mDirtyTiles.empty() || !mTileBuilds.empty())
+      {
+         startTileBuilds(U32_MAX);
+         finishTileBuilds(true);
+      }
    }
 
    return true;
@@ -675,6 +698,7 @@ DefineEngineMethod(NavMesh, build, bool, (bool background, bool save), (true, fa
 void NavMesh::cancelBuild()
 {
    mDirtyTiles.clear();
+   cancelTileBuilds();
    ctx->stopTimer(RC_TIMER_TOTAL);
    mBuilding = false;
 }
@@ -687,7 +711,7 @@ DefineEngineMethod(NavMesh, cancelBuild, void, (),,
 
 void NavMesh::inspectPostApply()
 {
-   if(mBuilding)
+   if(mBuilding || !mTileBuilds.empty())
       cancelBuild();
 }
 
@@ -742,6 +766,8 @@ void NavMesh::updateTiles(bool dirty)
    if(!isProperlyAdded())
       return;
 
+   cancelTileBuilds();
+
    mTiles.clear();
    mTileData.clear();
    mDirtyTiles.clear();
@@ -788,52 +814,125 @@ void NavMesh::updateTiles(bool dirty)
 
 void NavMesh::processTick(const Move *move)
 {
-   buildNextTile();
+   finishTileBuilds(false);
+   startTileBuilds(smMaxTileBuilds);
 }
 
-void NavMesh::buildNextTile()
+bool NavMesh::isTileBuilding(U32 tile) const
 {
-   if(!mDirtyTiles.empty())
+   for(U32 i = 0; i < mTileBuilds.size(); i++)
    {
-      // Pop a single dirty tile and process it.
-      U32 i = mDirtyTiles.front();
-      mDirtyTiles.pop_front();
-      const Tile &tile = mTiles[i];
-      // Intermediate data for tile build.
-      TileData tempdata;
-      TileData &tdata = mSaveIntermediates ? mTileData[i] : tempdata;
-      
+      if(mTileBuilds[i]->index == tile)
+         return true;
+   }
+   return false;
+}
+
+void NavMesh::startTileBuilds(U32 maxBuilds)
+{
+   for(U32 d = 0; d < mDirtyTiles.size() && mTileBuilds.size() < maxBuilds;)
+   {
+      // A tile can only be generated by one job at a time; it stays dirty
+      // until the current one is done.
+      const U32 i = mDirtyTiles[d];
+      if(isTileBuilding(i))
+      {
+         d++;
+         continue;
+      }
+      mDirtyTiles.erase(d);
+
+      TileBuild *build = new TileBuild;
+      build->mesh = this;
+      build->index = i;
+      build->tile = mTiles[i];
+      build->data = mSaveIntermediates && i < mTileData.size() ? &mTileData[i] : &build->tempData;
+      build->linkVerts = mLinkVerts;
+      build->linkRads = mLinkRads;
+      build->linkDirs = mLinkDirs;
+      build->linkAreas = mLinkAreas;
+      build->linkFlags = mLinkFlags;
+      build->linkIDs = mLinkIDs;
+      mTileBuilds.push_back(build);
+
+      // Scene queries aren't thread-safe, so geometry is gathered here.
+      if(gatherTileGeometry(build->tile, *build->data))
+         ThreadPool::GLOBAL().queueJob(&_buildTileJob, build, &mTileJobs);
+      else
+         build->done = 1;
+   }
+}
+
+void NavMesh::_buildTileJob(void *data, U32 begin, U32 end)
+{
+   TileBuild *build = reinterpret_cast<TileBuild*>(data);
+   NavMesh *mesh = build->mesh;
+
+   // Each job gets its own context so timers don't collide.
+   NavContext context;
+   context.startTimer(RC_TIMER_TOTAL);
+   build->navData = mesh->buildTileData(*build, *build->data, &context, build->navDataSize);
+   context.stopTimer(RC_TIMER_TOTAL);
+   build->buildTime = context.getAccumulatedTime(RC_TIMER_TOTAL);
+
+   if(build->data == &build->tempData)
+      build->tempData.freeAll();
+
+   dFetchAndAdd(build->done, 1);
+}
+
+void NavMesh::finishTileBuilds(bool wait)
+{
+   if(mTileBuilds.empty())
+      return;
+
+   if(wait)
+      ThreadPool::GLOBAL().waitForJobs(mTileJobs);
+
+   for(U32 b = 0; b < mTileBuilds.size();)
+   {
+      TileBuild *build = mTileBuilds[b];
+      if(!dAtomicRead(build->done))
+      {
+         b++;
+         continue;
+      }
+      mTileBuilds.erase(b);
+
+      const Tile &tile = build->tile;
+
       // Remove any previous data.
       nm->removeTile(nm->getTileRefAt(tile.x, tile.y, 0), 0, 0);
 
-      // Generate navmesh for this tile.
-      U32 dataSize = 0;
-      unsigned char* data = buildTileData(tile, tdata, dataSize);
-      if(data)
+      if(build->navData)
       {
          // Add new data (navmesh owns and deletes the data).
-         dtStatus status = nm->addTile(data, dataSize, DT_TILE_FREE_DATA, 0, 0);
+         dtStatus status = nm->addTile(build->navData, build->navDataSize, DT_TILE_FREE_DATA, 0, 0);
          int success = 1;
          if(dtStatusFailed(status))
          {
             success = 0;
-            dtFree(data);
+            dtFree(build->navData);
          }
          if(getEventManager())
          {
-            String str = String::ToString("%d %d %d (%d, %d) %d %.3f %s",
+            String str = String::ToString("%d %d %d (%d, %d) %d %.3f %s %.3f",
                getId(),
-               i, mTiles.size(),
+               build->index, mTiles.size(),
                tile.x, tile.y,
                success,
                ctx->getAccumulatedTime(RC_TIMER_TOTAL) / 1000.0f,
-               castConsoleTypeToString(tile.box));
+               castConsoleTypeToString(tile.box),
+               build->buildTime / 1000.0f);
             getEventManager()->postEvent("NavMeshTileUpdate", str.c_str());
             setMaskBits(LoadFlag);
          }
       }
+
+      delete build;
+
       // Did we just build the last tile?
-      if(mDirtyTiles.empty())
+      if(mDirtyTiles.empty() && mTileBuilds.empty())
       {
          ctx->stopTimer(RC_TIMER_TOTAL);
          if(getEventManager())
@@ -847,6 +946,21 @@ void NavMesh::buildNextTile()
    }
 }
 
+void NavMesh::cancelTileBuilds()
+{
+   if(mTileBuilds.empty())
+      return;
+
+   ThreadPool::GLOBAL().waitForJobs(mTileJobs);
+
+   for(U32 b = 0; b < mTileBuilds.size(); b++)
+   {
+      dtFree(mTileBuilds[b]->navData);
+      delete mTileBuilds[b];
+   }
+   mTileBuilds.clear();
+}
+
 static void buildCallback(SceneObject* object,void *key)
 {
    SceneContainer::CallbackInfo* info = reinterpret_cast<SceneContainer::CallbackInfo*>(key);
@@ -854,8 +968,11 @@ static void buildCallback(SceneObject* object,void *key)
    object->buildPolyList(info->context,info->polyList,info->boundingBox,info->boundingSphere);
 }
 
-unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dataSize)
+bool NavMesh::gatherTileGeometry(const Tile &tile, TileData &data)
 {
+   // Drop anything left over from a previous build of this tile.
+   data.freeAll();
+
    // Push out tile boundaries a bit.
    F32 tileBmin[3], tileBmax[3];
    rcVcopy(tileBmin, tile.bmin);
@@ -876,8 +993,8 @@ unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dat
    getContainer()->findObjects(box, StaticObjectType | DynamicShapeObjectType, buildCallback, &info);
 
    // Parse water objects into the same list, but remember how much geometry was /not/ water.
-   U32 nonWaterVertCount = data.geom.getVertCount();
-   U32 nonWaterTriCount = data.geom.getTriCount();
+   data.nonWaterVertCount = data.geom.getVertCount();
+   data.nonWaterTriCount = data.geom.getTriCount();
    if(mWaterMethod != Ignore)
    {
       getContainer()->findObjects(box, WaterObjectType, buildCallback, &info);
@@ -887,9 +1004,25 @@ unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dat
    if (!data.geom.getVertCount())
    {
       data.geom.clear();
-      return NULL;
+      return false;
    }
 
+   return true;
+}
+
+unsigned char *NavMesh::buildTileData(const TileBuild &build, TileData &data, rcContext *context, U32 &dataSize)
+{
+   const Tile &tile = build.tile;
+
+   // Push out tile boundaries a bit.
+   F32 tileBmin[3], tileBmax[3];
+   rcVcopy(tileBmin, tile.bmin);
+   rcVcopy(tileBmax, tile.bmax);
+   tileBmin[0] -= cfg.borderSize * cfg.cs;
+   tileBmin[2] -= cfg.borderSize * cfg.cs;
+   tileBmax[0] += cfg.borderSize * cfg.cs;
+   tileBmax[2] += cfg.borderSize * cfg.cs;
+
    // Figure out voxel dimensions of this tile.
    U32 width = 0, height = 0;
    width = cfg.tileSize + cfg.borderSize * 2;
@@ -902,7 +1035,7 @@ unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dat
       Con::errorf("Out of memory (rcHeightField) for NavMesh %s", getIdString());
       return NULL;
    }
-   if(!rcCreateHeightfield(ctx, *data.hf, width, height, tileBmin, tileBmax, cfg.cs, cfg.ch))
+   if(!rcCreateHeightfield(context, *data.hf, width, height, tileBmin, tileBmax, cfg.cs, cfg.ch))
    {
       Con::errorf("Could not generate rcHeightField for NavMesh %s", getIdString());
       return NULL;
@@ -916,18 +1049,18 @@ unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dat
    if(mWaterMethod == Solid)
    {
       // Treat water as solid: i.e. mark areas as walkable based on angle.
-      rcMarkWalkableTriangles(ctx, cfg.walkableSlopeAngle,
+      rcMarkWalkableTriangles(context, cfg.walkableSlopeAngle,
          data.geom.getVerts(), data.geom.getVertCount(),
          data.geom.getTris(), data.geom.getTriCount(), areas);
    }
    else
    {
       // Treat water as impassable: leave all area flags 0.
-      rcMarkWalkableTriangles(ctx, cfg.walkableSlopeAngle,
-         data.geom.getVerts(), nonWaterVertCount,
-         data.geom.getTris(), nonWaterTriCount, areas);
+      rcMarkWalkableTriangles(context, cfg.walkableSlopeAngle,
+         data.geom.getVerts(), data.nonWaterVertCount,
+         data.geom.getTris(), data.nonWaterTriCount, areas);
    }
-   rcRasterizeTriangles(ctx,
+   rcRasterizeTriangles(context,
       data.geom.getVerts(), data.geom.getVertCount(),
       data.geom.getTris(), areas, data.geom.getTriCount(),
       *data.hf, cfg.walkableClimb);
@@ -935,9 +1068,9 @@ unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dat
    delete[] areas;
 
    // Filter out areas with low ceilings and other stuff.
-   rcFilterLowHangingWalkableObstacles(ctx, cfg.walkableClimb, *data.hf);
-   rcFilterLedgeSpans(ctx, cfg.walkableHeight, cfg.walkableClimb, *data.hf);
-   rcFilterWalkableLowHeightSpans(ctx, cfg.walkableHeight, *data.hf);
+   rcFilterLowHangingWalkableObstacles(context, cfg.walkableClimb, *data.hf);
+   rcFilterLedgeSpans(context, cfg.walkableHeight, cfg.walkableClimb, *data.hf);
+   rcFilterWalkableLowHeightSpans(context, cfg.walkableHeight, *data.hf);
 
    data.chf = rcAllocCompactHeightfield();
    if(!data.chf)
@@ -945,12 +1078,12 @@ unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dat
       Con::errorf("Out of memory (rcCompactHeightField) for NavMesh %s", getIdString());
       return NULL;
    }
-   if(!rcBuildCompactHeightfield(ctx, cfg.walkableHeight, cfg.walkableClimb, *data.hf, *data.chf))
+   if(!rcBuildCompactHeightfield(context, cfg.walkableHeight, cfg.walkableClimb, *data.hf, *data.chf))
    {
       Con::errorf("Could not generate rcCompactHeightField for NavMesh %s", getIdString());
       return NULL;
    }
-   if(!rcErodeWalkableArea(ctx, cfg.walkableRadius, *data.chf))
+   if(!rcErodeWalkableArea(context, cfg.walkableRadius, *data.chf))
    {
       Con::errorf("Could not erode walkable area for NavMesh %s", getIdString());
       return NULL;
@@ -965,7 +1098,7 @@ unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dat
 
    if(false)
    {
-      if(!rcBuildRegionsMonotone(ctx, *data.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
+      if(!rcBuildRegionsMonotone(context, *data.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
       {
          Con::errorf("Could not build regions for NavMesh %s", getIdString());
          return NULL;
@@ -973,12 +1106,12 @@ unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dat
    }
    else
    {
-      if(!rcBuildDistanceField(ctx, *data.chf))
+      if(!rcBuildDistanceField(context, *data.chf))
       {
          Con::errorf("Could not build distance field for NavMesh %s", getIdString());
          return NULL;
       }
-      if(!rcBuildRegions(ctx, *data.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
+      if(!rcBuildRegions(context, *data.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
       {
          Con::errorf("Could not build regions for NavMesh %s", getIdString());
          return NULL;
@@ -991,7 +1124,7 @@ unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dat
       Con::errorf("Out of memory (rcContourSet) for NavMesh %s", getIdString());
       return NULL;
    }
-   if(!rcBuildContours(ctx, *data.chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *data.cs))
+   if(!rcBuildContours(context, *data.chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *data.cs))
    {
       Con::errorf("Could not construct rcContourSet for NavMesh %s", getIdString());
       return NULL;
@@ -1008,7 +1141,7 @@ unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dat
       Con::errorf("Out of memory (rcPolyMesh) for NavMesh %s", getIdString());
       return NULL;
    }
-   if(!rcBuildPolyMesh(ctx, *data.cs, cfg.maxVertsPerPoly, *data.pm))
+   if(!rcBuildPolyMesh(context, *data.cs, cfg.maxVertsPerPoly, *data.pm))
    {
       Con::errorf("Could not construct rcPolyMesh for NavMesh %s", getIdString());
       return NULL;
@@ -1020,7 +1153,7 @@ unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dat
       Con::errorf("Out of memory (rcPolyMeshDetail) for NavMesh %s", getIdString());
       return NULL;
    }
-   if(!rcBuildPolyMeshDetail(ctx, *data.pm, *data.chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *data.pmd))
+   if(!rcBuildPolyMeshDetail(context, *data.pm, *data.chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *data.pmd))
    {
       Con::errorf("Could not construct rcPolyMeshDetail for NavMesh %s", getIdString());
       return NULL;
@@ -1062,13 +1195,13 @@ unsigned char *NavMesh::buildTileData(const Tile &tile, TileData &data, U32 &dat
    params.detailTris = data.pmd->tris;
    params.detailTriCount = data.pmd->ntris;
 
-   params.offMeshConVerts = mLinkVerts.address();
-   params.offMeshConRad = mLinkRads.address();
-   params.offMeshConDir = mLinkDirs.address();
-   params.offMeshConAreas = mLinkAreas.address();
-   params.offMeshConFlags = mLinkFlags.address();
-   params.offMeshConUserID = mLinkIDs.address();
-   params.offMeshConCount = mLinkIDs.size();
+   params.offMeshConVerts = build.linkVerts.address();
+   params.offMeshConRad = build.linkRads.address();
+   params.offMeshConDir = build.linkDirs.address();
+   params.offMeshConAreas = build.linkAreas.address();
+   params.offMeshConFlags = build.linkFlags.address();
+   params.offMeshConUserID = build.linkIDs.address();
+   params.offMeshConCount = build.linkIDs.size();
 
    params.walkableHeight = mWalkableHeight;
    params.walkableRadius = mWalkableRadius;
@@ -1440,7 +1573,8 @@ void NavMesh::renderLinks(duDebugDraw &dd)
 
 void NavMesh::renderTileData(duDebugDrawTorque &dd, U32 tile)
 {
-   if(tile >= mTileData.size())
+   // A job may be writing to the data.
+   if(tile >= mTileData.size() || isTileBuilding(tile))
       return;
    if(nm)
    {
@@ -1526,6 +1660,9 @@ struct NavMeshTileHeader
 
 bool NavMesh::load()
 {
+   // Tile jobs read nm, which is replaced below.
+   cancelTileBuilds();
+
    if(!dStrlen(mFileName))
       return false;
 
@@ -1556,6 +1693,7 @@ bool NavMesh::load()
       return false;
    }
 
+   NavPathService::meshChanged(this);
    if(nm)
       dtFreeNavMesh(nm);
    nm = dtAllocNavMesh();
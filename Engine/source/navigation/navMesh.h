@@ -29,6 +29,7 @@
 #include "collision/concretePolyList.h"
 #include "recastPolyList.h"
 #include "util/messaging/eventManager.h"
+#include "platform/threads/threadPool.h"
 
 #include "torqueRecast.h"
 #include "duDebugDrawTorque.h"
@@ -47,6 +48,7 @@
 class NavMesh : public SceneObject {
    typedef SceneObject Parent;
    friend class NavPath;
+   friend class NavPathService;
 
 public:
    /// @name NavMesh build
@@ -199,6 +201,7 @@ public:
    /// @{
 
    static void initPersistFields();
+   static void consoleInit();
 
    bool onAdd();
    void onRemove();
@@ -257,8 +260,18 @@ private:
    /// mesh. Returns true if successful. Stores the created mesh in tnm.
    bool generateMesh();
 
-   /// Builds the next tile in the dirty list.
-   void buildNextTile();
+   /// Queues jobs for dirty tiles until maxBuilds tiles are in flight.
+   void startTileBuilds(U32 maxBuilds);
+
+   /// Swaps finished tiles into the navmesh. If wait is true, all tiles in
+   /// flight are finished first.
+   void finishTileBuilds(bool wait);
+
+   /// Waits for tiles in flight and throws their results away.
+   void cancelTileBuilds();
+
+   /// Is a job generating this tile right now?
+   bool isTileBuilding(U32 tile) const;
 
    /// Save imtermediate navmesh creation data?
    bool mSaveIntermediates;
@@ -290,6 +303,8 @@ private:
    /// Intermediate data for tile creation.
    struct TileData {
       RecastPolyList          geom;
+      /// Size of geom before water was added.
+      U32 nonWaterVertCount, nonWaterTriCount;
       rcHeightfield        *hf;
       rcCompactHeightfield *chf;
       rcContourSet         *cs;
@@ -297,6 +312,7 @@ private:
       rcPolyMeshDetail     *pmd;
       TileData()
       {
+         nonWaterVertCount = nonWaterTriCount = 0;
          hf = NULL;
          chf = NULL;
          cs = NULL;
@@ -311,6 +327,11 @@ private:
          rcFreeContourSet(cs);
          rcFreePolyMesh(pm);
          rcFreePolyMeshDetail(pmd);
+         hf = NULL;
+         chf = NULL;
+         cs = NULL;
+         pm = NULL;
+         pmd = NULL;
       }
       ~TileData()
       {
@@ -330,8 +351,55 @@ private:
    /// Update tile dimensions.
    void updateTiles(bool dirty = false);
 
-   /// Generates navmesh data for a single tile.
-   unsigned char *buildTileData(const Tile &tile, TileData &data, U32 &dataSize);
+   /// A tile being generated by a ThreadPool job. Geometry is gathered
+   /// from the scene on the main thread; the Recast and Detour steps run
+   /// on the job and only touch the data in here.
+   struct TileBuild {
+      NavMesh *mesh;
+      /// Index into mTiles.
+      U32 index;
+      Tile tile;
+      /// Intermediate data. Points into mTileData if we save intermediates.
+      TileData *data;
+      TileData tempData;
+      /// @name Off-mesh links when the build was started
+      /// @{
+      Vector<F32> linkVerts;
+      Vector<F32> linkRads;
+      Vector<U8> linkDirs;
+      Vector<U8> linkAreas;
+      Vector<U16> linkFlags;
+      Vector<U32> linkIDs;
+      /// @}
+      /// Detour tile data; NULL if the tile is empty or failed.
+      unsigned char *navData;
+      U32 navDataSize;
+      /// Milliseconds the job took to generate the tile.
+      S32 buildTime;
+      /// Set by the job when it is done with this build.
+      volatile U32 done;
+      TileBuild() : mesh(NULL), index(0), data(NULL), navData(NULL),
+         navDataSize(0), buildTime(0), done(0) {}
+   };
+
+   /// Tiles in flight.
+   Vector<TileBuild*> mTileBuilds;
+
+   /// Counts the jobs of mTileBuilds.
+   ThreadPool::JobCounter mTileJobs;
+
+   /// Maximum number of tiles generated at once during background builds.
+   static U32 smMaxTileBuilds;
+
+   /// Collects the scene geometry for a tile. Main thread only.
+   bool gatherTileGeometry(const Tile &tile, TileData &data);
+
+   /// Generates navmesh data for a single tile from its gathered geometry.
+   /// Safe to call from worker threads.
+   unsigned char *buildTileData(const TileBuild &build, TileData &data, rcContext *context, U32 &dataSize);
+
+   /// Job function that runs buildTileData on a TileBuild.
+   static void _buildTileJob(void *data, U32 begin, U32 end);
 
    /// @}
 
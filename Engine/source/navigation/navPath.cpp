@@ -64,6 +64,7 @@ NavPath::NavPath() :
    mIsSliced = false;
 
    mMaxIterations = 1;
+   mPriority = 1.0f;
 
    mAlwaysRender = false;
    mXray = false;
@@ -209,6 +210,8 @@ void NavPath::initPersistFields()
       "Plan this path over multiple updates instead of all at once.");
    addFieldV("maxIterations", TypeS32, Offset(mMaxIterations, NavPath), &ValidIterations,
       "Maximum iterations of path planning this path does per tick.");
+   addField("priority", TypeF32, Offset(mPriority, NavPath),
+      "Priority of this path in the shared planning queue when it is sliced.");
    addProtectedField("autoUpdate", TypeBool, Offset(mAutoUpdate, NavPath),
       &setProtectedAutoUpdate, &defaultProtectedGetFn,
       "If set, this path will automatically replan when its navigation mesh changes.");
@@ -262,9 +265,6 @@ bool NavPath::onAdd()
 
    if(isServerObject())
    {
-      mQuery = dtAllocNavMeshQuery();
-      if(!mQuery)
-         return false;
       checkAutoUpdate();
       if(!plan())
          setProcessTick(true);
@@ -275,6 +275,9 @@ bool NavPath::onAdd()
 
 void NavPath::onRemove()
 {
+   mRequest = NULL;
+   releaseQuery();
+
    Parent::onRemove();
 
    removeFromScene();
@@ -290,9 +293,16 @@ bool NavPath::init()
    if(!(mFromSet && mToSet) && !(mWaypoints && mWaypoints->size()))
       return false;
 
-   // Initialise our query.
-   if(dtStatusFailed(mQuery->init(mMesh->getNavMesh(), MaxPathLen)))
-      return false;
+   // Instant plans borrow a query; sliced plans queue their legs with the
+   // NavPathService instead.
+   mRequest = NULL;
+   releaseQuery();
+   if(!mIsSliced)
+   {
+      mQuery = NavPathService::get().acquireQuery(mMesh->getNavMesh());
+      if(!mQuery)
+         return false;
+   }
 
    mPoints.clear();
    mFlags.clear();
@@ -400,7 +410,20 @@ bool NavPath::planInstant()
    mMaxIterations = INT_MAX;
    while(update());
    mMaxIterations = store;
-   return finalise();
+   bool result = finalise();
+   // Hang on to the query if we want to render the search.
+   if(!mRenderSearch)
+      releaseQuery();
+   return result;
+}
+
+void NavPath::releaseQuery()
+{
+   if(mQuery)
+   {
+      NavPathService::get().releaseQuery(mQuery);
+      mQuery = NULL;
+   }
 }
 
 bool NavPath::visitNext()
@@ -420,6 +443,14 @@ bool NavPath::visitNext()
    if(getContainer()->castRay(end + Point3F(0, 0, 0.1f), end - Point3F(0, 0, mMesh->mWalkableHeight * 2.0f), StaticObjectType, &info))
       end = info.point;
 
+   if(mIsSliced)
+   {
+      mRequest = NavPathService::get().request(mMesh, start, end,
+         mLinkTypes.getFlags(), mPriority, mMaxIterations);
+      mStatus = DT_IN_PROGRESS;
+      return true;
+   }
+
    // Convert to Detour-friendly coordinates and data structures.
    F32 from[] = {start.x, start.z, -start.y};
    F32 to[] =   {end.x,   end.z,   -end.y};
@@ -452,6 +483,8 @@ bool NavPath::visitNext()
 
 bool NavPath::update()
 {
+   if(mRequest)
+      return updateRequest();
    if(dtStatusInProgress(mStatus))
       mStatus = mQuery->updateSlicedFindPath(mMaxIterations, NULL);
    if(dtStatusSucceed(mStatus))
@@ -516,6 +549,47 @@ bool NavPath::update()
    return true;
 }
 
+bool NavPath::updateRequest()
+{
+   if(!mRequest->isDone())
+      return true;
+
+   NavPathRequestPtr req = mRequest;
+   mRequest = NULL;
+   if(req->getStatus() != NavPathRequest::Succeeded)
+   {
+      mStatus = DT_FAILURE;
+      return false;
+   }
+   mStatus = DT_SUCCESS;
+
+   // Add points from this leg.
+   const Vector<Point3F> &points = req->getPoints();
+   const Vector<U16> &flags = req->getFlags();
+   U32 s = mPoints.size();
+   mPoints.increment(points.size());
+   mFlags.increment(points.size());
+   for(U32 i = 0; i < points.size(); i++)
+   {
+      mPoints[s + i] = points[i];
+      mFlags[s + i] = flags[i];
+      if(s > 0 || i > 0)
+         mLength += (mPoints[s+i] - mPoints[s+i-1]).len();
+   }
+
+   if(isServerObject())
+      setMaskBits(PathMask);
+
+   // Check to see where we still need to visit.
+   if(mVisitPoints.size() > 1)
+   {
+      //Next leg of the journey.
+      mVisitPoints.pop_back();
+      return visitNext();
+   }
+   return false;
+}
+
 bool NavPath::finalise()
 {
    setProcessTick(false);
@@ -530,8 +604,8 @@ void NavPath::processTick(const Move *move)
    if(!mMesh)
       if(Sim::findObject(mMeshName.c_str(), mMesh))
          plan();
-   if(dtStatusInProgress(mStatus))
-      update();
+   if(dtStatusInProgress(mStatus) && !update())
+      finalise();
 }
 
 Point3F NavPath::getNode(S32 idx) const
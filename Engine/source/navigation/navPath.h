@@ -26,6 +26,7 @@
 #include "scene/sceneObject.h"
 #include "scene/simPath.h"
 #include "navMesh.h"
+#include "navPathService.h"
 #include <DetourNavMeshQuery.h>
 
 class NavPath: public SceneObject {
@@ -51,6 +52,9 @@ public:
 
    S32 mMaxIterations;
 
+   /// Priority of sliced plans in the NavPathService queue.
+   F32 mPriority;
+
    bool mAlwaysRender;
    bool mXray;
    bool mRenderSearch;
@@ -149,7 +153,17 @@ private:
    /// 'Visit' the last two points on our visit list.
    bool visitNext();
 
+   /// Collect the leg planned by mRequest once it is done.
+   /// @return True if we need to keep updating, false if we can stop.
+   bool updateRequest();
+
+   /// Give our query back to the NavPathService.
+   void releaseQuery();
+
+   /// Query borrowed from the NavPathService for instant plans.
    dtNavMeshQuery *mQuery;
+   /// Current leg of a sliced plan.
+   NavPathRequestPtr mRequest;
    dtStatus mStatus;
    dtQueryFilter mFilter;
    S32 mCurIndex;
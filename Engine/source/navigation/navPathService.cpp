@@ -0,0 +1,541 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 Daniel Buckmaster
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "navPathService.h"
+#include "torqueRecast.h"
+
+#include "console/consoleTypes.h"
+#include "console/engineAPI.h"
+#include "core/module.h"
+#include "platform/profiler.h"
+#include "T3D/gameBase/gameProcess.h"
+
+MODULE_BEGIN( NavPathService )
+
+   MODULE_INIT_AFTER( ProcessList )
+   MODULE_SHUTDOWN_BEFORE( ProcessList )
+
+   MODULE_INIT
+   {
+      NavPathService::init();
+   }
+
+   MODULE_SHUTDOWN
+   {
+      NavPathService::shutdown();
+   }
+
+MODULE_END;
+
+NavPathService *NavPathService::smInstance = NULL;
+
+S32 NavPathService::smTickBudgetMS = 2;
+S32 NavPathService::smMaxPlanning = 16;
+S32 NavPathService::smSliceIterations = 64;
+S32 NavPathService::smMaxCachedPaths = 128;
+F32 NavPathService::smCoalesceDist = 0.5f;
+
+NavPathRequest::NavPathRequest()
+{
+   mIncludeFlags = 0;
+   mPriority = 1.0f;
+   mMaxIterations = 0;
+   mSequence = 0;
+   mSubmitTime = 0;
+   mStatus = Queued;
+   mQuery = NULL;
+   mStartRef = mEndRef = 0;
+   mLength = 0.0f;
+}
+
+F32 NavPathService::Stats::getAverageLatencyMS() const
+{
+   const U32 count = succeeded + failed;
+   return count ? (F32)totalLatencyMS / (F32)count : 0.0f;
+}
+
+void NavPathService::init()
+{
+   smInstance = new NavPathService();
+
+   Con::addVariable("$NavPathService::tickBudgetMS", TypeS32, &smTickBudgetMS,
+      "@brief Milliseconds the server spends planning queued paths per tick.\n\n"
+      "At least one search slice of every path being planned runs each tick.\n"
+      "@ingroup AI");
+   Con::addVariable("$NavPathService::maxPlanning", TypeS32, &smMaxPlanning,
+      "@brief Maximum number of paths planned at the same time.\n\n"
+      "@ingroup AI");
+   Con::addVariable("$NavPathService::sliceIterations", TypeS32, &smSliceIterations,
+      "@brief Search iterations per slice for paths that do not set their own.\n\n"
+      "@ingroup AI");
+   Con::addVariable("$NavPathService::maxCachedPaths", TypeS32, &smMaxCachedPaths,
+      "@brief Number of planned polygon corridors kept for reuse.\n\n"
+      "@ingroup AI");
+   Con::addVariable("$NavPathService::coalesceDistance", TypeF32, &smCoalesceDist,
+      "@brief Requests whose start and end points are this close to those of a "
+      "queued request share its result.\n\n"
+      "@ingroup AI");
+}
+
+void NavPathService::shutdown()
+{
+   delete smInstance;
+   smInstance = NULL;
+}
+
+NavPathService::NavPathService()
+{
+   mNextSequence = 0;
+   dMemset(&mStats, 0, sizeof(mStats));
+
+   if(ServerProcessList::get())
+      ServerProcessList::get()->preTickSignal().notify(this, &NavPathService::_onPreTick);
+}
+
+NavPathService::~NavPathService()
+{
+   if(ServerProcessList::get())
+      ServerProcessList::get()->preTickSignal().remove(this, &NavPathService::_onPreTick);
+
+   for(U32 i = 0; i < mPlanning.size(); i++)
+      releaseQuery(mPlanning[i]->mQuery);
+   mPlanning.clear();
+   mQueued.clear();
+
+   clearCache();
+
+   for(U32 i = 0; i < mFreeQueries.size(); i++)
+      dtFreeNavMeshQuery(mFreeQueries[i]);
+}
+
+dtNavMeshQuery *NavPathService::acquireQuery(const dtNavMesh *nm)
+{
+   dtNavMeshQuery *query;
+   if(mFreeQueries.size())
+   {
+      query = mFreeQueries.last();
+      mFreeQueries.pop_back();
+   }
+   else
+   {
+      query = dtAllocNavMeshQuery();
+      if(!query)
+         return NULL;
+   }
+
+   // The node pool is kept when the size doesn't change, so this is cheap.
+   if(dtStatusFailed(query->init(nm, MaxPathLen)))
+   {
+      mFreeQueries.push_back(query);
+      return NULL;
+   }
+
+   return query;
+}
+
+void NavPathService::releaseQuery(dtNavMeshQuery *query)
+{
+   if(query)
+      mFreeQueries.push_back(query);
+}
+
+NavPathRequestPtr NavPathService::request(NavMesh *mesh, const Point3F &from, const Point3F &to,
+   U16 includeFlags, F32 priority, S32 maxIterations)
+{
+   mStats.submitted++;
+
+   // Share the result of an identical request that hasn't started yet.
+   const F32 coalesceDistSq = smCoalesceDist * smCoalesceDist;
+   for(U32 i = 0; i < mQueued.size(); i++)
+   {
+      NavPathRequest *queued = mQueued[i];
+      if(queued->mMesh != mesh || queued->mIncludeFlags != includeFlags)
+         continue;
+      if((queued->mFrom - from).lenSquared() > coalesceDistSq ||
+         (queued->mTo - to).lenSquared() > coalesceDistSq)
+         continue;
+
+      queued->mPriority = getMax(queued->mPriority, priority);
+      mStats.coalesced++;
+      return queued;
+   }
+
+   NavPathRequest *req = new NavPathRequest;
+   req->mMesh = mesh;
+   req->mFrom = from;
+   req->mTo = to;
+   req->mIncludeFlags = includeFlags;
+   req->mPriority = priority;
+   req->mMaxIterations = maxIterations;
+   req->mSequence = mNextSequence++;
+   req->mSubmitTime = Platform::getRealMilliseconds();
+   req->mFilter.setIncludeFlags(includeFlags);
+
+   mQueued.push_back(req);
+   mStats.maxQueueDepth = getMax(mStats.maxQueueDepth, (U32)mQueued.size());
+
+   return req;
+}
+
+NavPathRequest *NavPathService::_popQueued()
+{
+   S32 best = -1;
+   for(U32 i = 0; i < mQueued.size();)
+   {
+      NavPathRequest *req = mQueued[i];
+
+      // Nobody is waiting for this one anymore.
+      if(req->getRefCount() == 1)
+      {
+         mStats.cancelled++;
+         mQueued.erase(i);
+         continue;
+      }
+
+      if(best < 0 ||
+         req->mPriority > mQueued[best]->mPriority ||
+         (req->mPriority == mQueued[best]->mPriority && req->mSequence < mQueued[best]->mSequence))
+         best = i;
+      i++;
+   }
+
+   if(best < 0)
+      return NULL;
+
+   NavPathRequestPtr req = mQueued[best];
+   mQueued.erase(best);
+   mPlanning.push_back(req);
+   return req;
+}
+
+void NavPathService::process()
+{
+   if(mQueued.empty() && mPlanning.empty())
+      return;
+
+   PROFILE_SCOPE(NavPathService_process);
+
+   const U32 startTime = Platform::getRealMilliseconds();
+   do
+   {
+      // Start as many requests as we have room for.
+      while((S32)mPlanning.size() < smMaxPlanning)
+      {
+         NavPathRequest *req = _popQueued();
+         if(!req)
+            break;
+         if(!_start(req))
+            mPlanning.remove(req);
+      }
+
+      if(mPlanning.empty())
+         break;
+
+      // Give every search a slice.
+      for(U32 i = 0; i < mPlanning.size();)
+      {
+         // Nobody is waiting for this one anymore.
+         if(mPlanning[i]->getRefCount() == 1)
+         {
+            mStats.cancelled++;
+            releaseQuery(mPlanning[i]->mQuery);
+            mPlanning[i]->mQuery = NULL;
+            mPlanning.erase(i);
+         }
+         else if(_update(mPlanning[i]))
+            i++;
+         else
+            mPlanning.erase(i);
+      }
+   } while((S32)(Platform::getRealMilliseconds() - startTime) < smTickBudgetMS);
+}
+
+bool NavPathService::_start(NavPathRequest *req)
+{
+   req->mStatus = NavPathRequest::Planning;
+
+   NavMesh *mesh = req->mMesh;
+   if(!mesh || !mesh->getNavMesh())
+   {
+      _fail(req);
+      return false;
+   }
+
+   const dtNavMesh *nm = mesh->getNavMesh();
+   req->mQuery = acquireQuery(nm);
+   if(!req->mQuery)
+   {
+      _fail(req);
+      return false;
+   }
+
+   Point3F from = DTStoRC(req->mFrom);
+   Point3F to = DTStoRC(req->mTo);
+   F32 extx = mesh->mWalkableRadius * 4.0f;
+   F32 extz = mesh->mWalkableHeight;
+   F32 extents[] = {extx, extz, extx};
+
+   if(dtStatusFailed(req->mQuery->findNearestPoly(from, extents, &req->mFilter, &req->mStartRef, NULL)) || !req->mStartRef)
+   {
+      Con::errorf("No NavMesh polygon near path start (%g, %g, %g) in NavMesh %s",
+         req->mFrom.x, req->mFrom.y, req->mFrom.z, mesh->getIdString());
+      _fail(req);
+      return false;
+   }
+
+   if(dtStatusFailed(req->mQuery->findNearestPoly(to, extents, &req->mFilter, &req->mEndRef, NULL)) || !req->mEndRef)
+   {
+      Con::errorf("No NavMesh polygon near path end (%g, %g, %g) in NavMesh %s",
+         req->mTo.x, req->mTo.y, req->mTo.z, mesh->getIdString());
+      _fail(req);
+      return false;
+   }
+
+   // Reuse a corridor we found before; only the string pulling is redone.
+   const CachedPath *cached = _findCached(nm, req);
+   if(cached)
+   {
+      mStats.cacheHits++;
+      _finish(req, cached->corridor.address(), cached->corridor.size());
+      return false;
+   }
+
+   if(dtStatusFailed(req->mQuery->initSlicedFindPath(req->mStartRef, req->mEndRef, from, to, &req->mFilter)))
+   {
+      _fail(req);
+      return false;
+   }
+
+   return true;
+}
+
+bool NavPathService::_update(NavPathRequest *req)
+{
+   if(!req->mMesh || !req->mMesh->getNavMesh())
+   {
+      _fail(req);
+      return false;
+   }
+
+   const S32 iterations = req->mMaxIterations > 0 ? req->mMaxIterations : smSliceIterations;
+   dtStatus status = req->mQuery->updateSlicedFindPath(getMax(iterations, 1), NULL);
+   if(dtStatusInProgress(status))
+      return true;
+
+   S32 pathLen = 0;
+   if(dtStatusSucceed(status))
+      status = req->mQuery->finalizeSlicedFindPath(mPath, &pathLen, MaxPathLen);
+
+   if(dtStatusFailed(status) || !pathLen)
+   {
+      _fail(req);
+      return false;
+   }
+
+   _cache(req->mMesh->getNavMesh(), req, mPath, pathLen);
+   _finish(req, mPath, pathLen);
+   return false;
+}
+
+void NavPathService::_finish(NavPathRequest *req, const dtPolyRef *path, S32 pathLen)
+{
+   S32 straightPathLen = 0;
+
+   Point3F from = DTStoRC(req->mFrom);
+   Point3F to = DTStoRC(req->mTo);
+
+   if(dtStatusFailed(req->mQuery->findStraightPath(from, to, path, pathLen,
+      mStraightPath, mStraightPathFlags,
+      mStraightPathPolys, &straightPathLen, MaxPathLen)))
+   {
+      _fail(req);
+      return;
+   }
+
+   const dtNavMesh *nm = req->mMesh->getNavMesh();
+   req->mPoints.setSize(straightPathLen);
+   req->mFlags.setSize(straightPathLen);
+   req->mLength = 0.0f;
+   for(U32 i = 0; i < straightPathLen; i++)
+   {
+      req->mPoints[i] = RCtoDTS(mStraightPath + i * 3);
+      req->mFlags[i] = 0;
+      nm->getPolyFlags(mStraightPathPolys[i], &req->mFlags[i]);
+      if(i > 0)
+         req->mLength += (req->mPoints[i] - req->mPoints[i-1]).len();
+   }
+
+   req->mStatus = NavPathRequest::Succeeded;
+   mStats.succeeded++;
+   _done(req);
+}
+
+void NavPathService::_fail(NavPathRequest *req)
+{
+   req->mStatus = NavPathRequest::Failed;
+   mStats.failed++;
+   _done(req);
+}
+
+void NavPathService::_done(NavPathRequest *req)
+{
+   releaseQuery(req->mQuery);
+   req->mQuery = NULL;
+   mStats.totalLatencyMS += Platform::getRealMilliseconds() - req->mSubmitTime;
+}
+
+const NavPathService::CachedPath *NavPathService::_findCached(const dtNavMesh *nm, const NavPathRequest *req) const
+{
+   for(U32 i = 0; i < mCache.size(); i++)
+   {
+      const CachedPath *cached = mCache[i];
+      if(cached->nm != nm ||
+         cached->startRef != req->mStartRef ||
+         cached->endRef != req->mEndRef ||
+         cached->includeFlags != req->mIncludeFlags)
+         continue;
+
+      // Tiles along the way may have been rebuilt since.
+      for(U32 j = 0; j < cached->corridor.size(); j++)
+      {
+         if(!nm->isValidPolyRef(cached->corridor[j]))
+            return NULL;
+      }
+      return cached;
+   }
+   return NULL;
+}
+
+void NavPathService::_cache(const dtNavMesh *nm, const NavPathRequest *req, const dtPolyRef *path, S32 pathLen)
+{
+   if(smMaxCachedPaths <= 0)
+      return;
+
+   // Partial paths end somewhere else; don't remember them.
+   if(path[pathLen - 1] != req->mEndRef)
+      return;
+
+   CachedPath *cached;
+   if((S32)mCache.size() >= smMaxCachedPaths)
+   {
+      // Recycle the oldest entry.
+      cached = mCache.first();
+      mCache.pop_front();
+   }
+   else
+      cached = new CachedPath;
+
+   cached->nm = nm;
+   cached->startRef = req->mStartRef;
+   cached->endRef = req->mEndRef;
+   cached->includeFlags = req->mIncludeFlags;
+   cached->corridor.setSize(pathLen);
+   dMemcpy(cached->corridor.address(), path, pathLen * sizeof(dtPolyRef));
+   mCache.push_back(cached);
+}
+
+void NavPathService::clearCache()
+{
+   for(U32 i = 0; i < mCache.size(); i++)
+      delete mCache[i];
+   mCache.clear();
+}
+
+void NavPathService::meshChanged(NavMesh *mesh)
+{
+   if(!smInstance || !mesh->getNavMesh())
+      return;
+
+   NavPathService &service = *smInstance;
+
+   // A new dtNavMesh may get the same address and poly refs, so the
+   // isValidPolyRef() check in _findCached() would not catch these.
+   const dtNavMesh *nm = mesh->getNavMesh();
+   for(U32 i = 0; i < service.mCache.size();)
+   {
+      if(service.mCache[i]->nm == nm)
+      {
+         delete service.mCache[i];
+         service.mCache.erase(i);
+      }
+      else
+         i++;
+   }
+
+   // Their queries point at the old mesh; plan them again on the new one.
+   for(U32 i = 0; i < service.mPlanning.size();)
+   {
+      NavPathRequest *req = service.mPlanning[i];
+      if(req->mMesh != mesh)
+      {
+         i++;
+         continue;
+      }
+
+      service.releaseQuery(req->mQuery);
+      req->mQuery = NULL;
+      req->mStatus = NavPathRequest::Queued;
+      service.mQueued.push_back(req);
+      service.mPlanning.erase(i);
+   }
+}
+
+const NavPathService::Stats &NavPathService::getStats()
+{
+   mStats.queued = mQueued.size();
+   mStats.planning = mPlanning.size();
+   return mStats;
+}
+
+void NavPathService::resetStats()
+{
+   dMemset(&mStats, 0, sizeof(mStats));
+}
+
+DefineEngineFunction(getNavPathServiceStats, String, (),,
+   "@brief Get statistics of the server's path planning queue.\n\n"
+   "@return A space-separated list: queued requests, requests being planned, "
+   "maximum queue depth, submitted, coalesced, cache hits, succeeded, failed, "
+   "cancelled, and the average milliseconds from submitting to finishing a request.\n\n"
+   "@ingroup AI")
+{
+   const NavPathService::Stats &stats = NavPathService::get().getStats();
+   return String::ToString("%d %d %d %d %d %d %d %d %d %.2f",
+      stats.queued, stats.planning, stats.maxQueueDepth,
+      stats.submitted, stats.coalesced, stats.cacheHits,
+      stats.succeeded, stats.failed, stats.cancelled,
+      stats.getAverageLatencyMS());
+}
+
+DefineEngineFunction(resetNavPathServiceStats, void, (),,
+   "@brief Reset the statistics returned by getNavPathServiceStats().\n\n"
+   "@ingroup AI")
+{
+   NavPathService::get().resetStats();
+}
+
+DefineEngineFunction(clearNavPathCache, void, (),,
+   "@brief Forget all paths cached by the server's path planner.\n\n"
+   "@ingroup AI")
+{
+   NavPathService::get().clearCache();
+}
@@ -0,0 +1,213 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 Daniel Buckmaster
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _NAVPATHSERVICE_H_
+#define _NAVPATHSERVICE_H_
+
+#include "navMesh.h"
+#include "core/util/refBase.h"
+#include <DetourNavMeshQuery.h>
+
+/// A single path between two points, planned by the NavPathService.
+class NavPathRequest : public StrongRefBase {
+public:
+   enum Status {
+      Queued,
+      Planning,
+      Succeeded,
+      Failed
+   };
+
+   Status getStatus() const { return mStatus; }
+
+   /// Has planning finished, successfully or not?
+   bool isDone() const { return mStatus == Succeeded || mStatus == Failed; }
+
+   /// World-space nodes of the planned path.
+   const Vector<Point3F> &getPoints() const { return mPoints; }
+
+   /// Navmesh flags of each node.
+   const Vector<U16> &getFlags() const { return mFlags; }
+
+   /// Length of the planned path.
+   F32 getLength() const { return mLength; }
+
+protected:
+   friend class NavPathService;
+
+   NavPathRequest();
+
+   SimObjectPtr<NavMesh> mMesh;
+   Point3F mFrom, mTo;
+   U16 mIncludeFlags;
+   F32 mPriority;
+   S32 mMaxIterations;
+
+   /// Submission order, used to plan equal priorities first-come first-served.
+   U32 mSequence;
+   /// Real time the request was submitted at.
+   U32 mSubmitTime;
+
+   Status mStatus;
+   dtNavMeshQuery *mQuery;
+   dtQueryFilter mFilter;
+   dtPolyRef mStartRef, mEndRef;
+
+   Vector<Point3F> mPoints;
+   Vector<U16> mFlags;
+   F32 mLength;
+};
+
+typedef StrongRefPtr<NavPathRequest> NavPathRequestPtr;
+
+/// Plans paths for all NavPaths on the server.
+///
+/// Requests are queued by priority and planned with sliced Detour queries
+/// taken from a shared pool, within a time budget every server tick.
+/// Requests that match one already in the queue share its result, and
+/// finished polygon corridors are cached by their start and end polygons so
+/// repeated paths only need the string-pulling step.
+///
+/// Dropping every reference to a queued request cancels it.
+class NavPathService {
+public:
+   /// Maximum number of polygons in a path, and of search nodes per query.
+   static const U32 MaxPathLen = 2048;
+
+   struct Stats {
+      /// Requests waiting for a query.
+      U32 queued;
+      /// Requests being planned.
+      U32 planning;
+      /// Deepest the queue has been.
+      U32 maxQueueDepth;
+      U32 submitted;
+      /// Requests that were merged into an identical queued request.
+      U32 coalesced;
+      U32 cacheHits;
+      U32 succeeded;
+      U32 failed;
+      U32 cancelled;
+      /// Sum of the milliseconds between submitting and finishing requests.
+      U32 totalLatencyMS;
+
+      F32 getAverageLatencyMS() const;
+   };
+
+   /// Queue a path from one world point to another.
+   /// @param maxIterations Search iterations per slice; 0 uses the default.
+   NavPathRequestPtr request(NavMesh *mesh, const Point3F &from, const Point3F &to,
+      U16 includeFlags, F32 priority = 1.0f, S32 maxIterations = 0);
+
+   /// Plan queued requests until the tick budget runs out.
+   void process();
+
+   /// Take a query from the pool, initialised for the given mesh.
+   dtNavMeshQuery *acquireQuery(const dtNavMesh *nm);
+
+   /// Return a query to the pool.
+   void releaseQuery(dtNavMeshQuery *query);
+
+   /// Forget all cached paths.
+   void clearCache();
+
+   /// Called before a NavMesh replaces or frees its dtNavMesh.  Drops the
+   /// corridors cached for it and restarts the searches running on it.
+   static void meshChanged(NavMesh *mesh);
+
+   const Stats &getStats();
+   void resetStats();
+
+   static NavPathService &get() { return *smInstance; }
+
+   static void init();
+   static void shutdown();
+
+   /// @name Settings
+   /// @{
+
+   /// Milliseconds of planning per tick; at least one slice always runs.
+   static S32 smTickBudgetMS;
+   /// Maximum number of requests being planned at once.
+   static S32 smMaxPlanning;
+   /// Default search iterations per slice.
+   static S32 smSliceIterations;
+   /// Number of corridors kept in the cache.
+   static S32 smMaxCachedPaths;
+   /// Requests whose ends are this close to a queued one are merged with it.
+   static F32 smCoalesceDist;
+
+   /// @}
+
+protected:
+   NavPathService();
+   ~NavPathService();
+
+   static NavPathService *smInstance;
+
+   struct CachedPath {
+      const dtNavMesh *nm;
+      dtPolyRef startRef, endRef;
+      U16 includeFlags;
+      Vector<dtPolyRef> corridor;
+   };
+
+   Vector<NavPathRequestPtr> mQueued;
+   Vector<NavPathRequestPtr> mPlanning;
+   Vector<dtNavMeshQuery*> mFreeQueries;
+   Vector<CachedPath*> mCache;
+   U32 mNextSequence;
+   Stats mStats;
+
+   /// @name Scratch buffers
+   /// Results of finishing a search, kept here as they are too big for the stack.
+   /// @{
+   dtPolyRef mPath[MaxPathLen];
+   F32 mStraightPath[MaxPathLen * 3];
+   dtPolyRef mStraightPathPolys[MaxPathLen];
+   U8 mStraightPathFlags[MaxPathLen];
+   /// @}
+
+   void _onPreTick() { process(); }
+
+   /// Pop the most urgent queued request, dropping cancelled ones.
+   NavPathRequest *_popQueued();
+
+   /// Find start and end polygons and begin the search.
+   /// @return False if the request finished straight away.
+   bool _start(NavPathRequest *req);
+
+   /// Run one slice of the search.
+   /// @return False once the request has finished.
+   bool _update(NavPathRequest *req);
+
+   /// Fill in the request's points from a polygon corridor and finish it.
+   void _finish(NavPathRequest *req, const dtPolyRef *path, S32 pathLen);
+
+   void _fail(NavPathRequest *req);
+   void _done(NavPathRequest *req);
+
+   const CachedPath *_findCached(const dtNavMesh *nm, const NavPathRequest *req) const;
+   void _cache(const dtNavMesh *nm, const NavPathRequest *req, const dtPolyRef *path, S32 pathLen);
+};
+
+#endif
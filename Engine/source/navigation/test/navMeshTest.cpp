@@ -0,0 +1,339 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "navigation/navMesh.h"
+#include "navigation/navPathService.h"
+#include "scene/sceneObject.h"
+#include "collision/abstractPolyList.h"
+#include "core/stringTable.h"
+
+#include "DetourNavMesh.h"
+
+FIXTURE(NavMeshBuild)
+{
+public:
+   /// A flat slab of ground for the nav mesh to cover.
+   class GroundObject : public SceneObject
+   {
+   public:
+      GroundObject()
+      {
+         mTypeMask |= StaticObjectType;
+         mObjBox.set(Point3F(-20.0f, -20.0f, -1.0f), Point3F(20.0f, 20.0f, 0.0f));
+      }
+
+      virtual bool onAdd()
+      {
+         if (!Parent::onAdd())
+            return false;
+         resetWorldBox();
+         addToScene();
+         return true;
+      }
+
+      virtual void onRemove()
+      {
+         removeFromScene();
+         Parent::onRemove();
+      }
+
+      virtual bool buildPolyList(PolyListContext context, AbstractPolyList* polyList, const Box3F& box, const SphereF& sphere)
+      {
+         polyList->setTransform(&mObjToWorld, mObjScale);
+         polyList->setObject(this);
+         polyList->addBox(mObjBox);
+         return true;
+      }
+   };
+
+   /// Gives the tests access to the Detour mesh.
+   class TestNavMesh : public NavMesh
+   {
+   public:
+      const dtNavMesh* getDetourMesh() { return getNavMesh(); }
+   };
+
+   GroundObject* mGround;
+   TestNavMesh* mMesh;
+
+   S32 mTickBudgetMS;
+   S32 mMaxPlanning;
+   S32 mSliceIterations;
+   S32 mMaxCachedPaths;
+
+   virtual void SetUp()
+   {
+      mTickBudgetMS = NavPathService::smTickBudgetMS;
+      mMaxPlanning = NavPathService::smMaxPlanning;
+      mSliceIterations = NavPathService::smSliceIterations;
+      mMaxCachedPaths = NavPathService::smMaxCachedPaths;
+
+      mGround = new GroundObject();
+      mGround->registerObject();
+
+      mMesh = new TestNavMesh();
+      mMesh->mTileSize = 8.0f;
+      mMesh->setScale(VectorF(32.0f, 32.0f, 8.0f));
+      mMesh->registerObject();
+   }
+
+   virtual void TearDown()
+   {
+      mMesh->deleteObject();
+      mGround->deleteObject();
+
+      NavPathService::smTickBudgetMS = mTickBudgetMS;
+      NavPathService::smMaxPlanning = mMaxPlanning;
+      NavPathService::smSliceIterations = mSliceIterations;
+      NavPathService::smMaxCachedPaths = mMaxCachedPaths;
+   }
+
+   /// Number of tiles in the Detour mesh with polygons in them.
+   U32 countTiles()
+   {
+      const dtNavMesh* nm = mMesh->getDetourMesh();
+      if (!nm)
+         return 0;
+
+      U32 count = 0;
+      for (S32 i = 0; i < nm->getMaxTiles(); i++)
+      {
+         const dtMeshTile* tile = nm->getTile(i);
+         if (tile && tile->header && tile->header->polyCount > 0)
+            count++;
+      }
+      return count;
+   }
+
+   /// Plan a path across the ground and wait for it.
+   NavPathRequestPtr planPath()
+   {
+      NavPathRequestPtr req = NavPathService::get().request(mMesh,
+         Point3F(-10.0f, -10.0f, 0.0f), Point3F(10.0f, 10.0f, 0.0f), 0xffff);
+      for (U32 i = 0; i < 1000 && !req->isDone(); i++)
+         NavPathService::get().process();
+      return req;
+   }
+
+   /// Queue a path with one-iteration slices, so it takes many ticks.
+   NavPathRequestPtr queueSlowPath(const Point3F& from, const Point3F& to, F32 priority = 1.0f)
+   {
+      return NavPathService::get().request(mMesh, from, to, 0xffff, priority, 1);
+   }
+
+   /// Process until all the requests are done.
+   void finishPaths()
+   {
+      for (U32 i = 0; i < 10000 && NavPathService::get().getStats().queued + NavPathService::get().getStats().planning; i++)
+         NavPathService::get().process();
+   }
+
+   /// Queue jobs for every tile without waiting for them.
+   void queueTileBuilds()
+   {
+      mMesh->buildTiles(mMesh->getWorldBox());
+      mMesh->processTick(NULL);
+   }
+};
+
+TEST_FIX(NavMeshBuild, RebuildWhileTilesBuild)
+{
+   ASSERT_TRUE(mMesh->build(false, false));
+   const U32 numTiles = countTiles();
+   EXPECT_GT(numTiles, 0);
+
+   // Rebuilding frees the Detour mesh the queued jobs would write into.
+   for (U32 i = 0; i < 4; i++)
+   {
+      queueTileBuilds();
+      EXPECT_TRUE(mMesh->build(false, false));
+      EXPECT_EQ(numTiles, countTiles());
+   }
+}
+
+TEST_FIX(NavMeshBuild, ReloadWhileTilesBuild)
+{
+   mMesh->mFileName = StringTable->insert("navMeshBuildTest.nav");
+
+   ASSERT_TRUE(mMesh->build(false, false));
+   const U32 numTiles = countTiles();
+   EXPECT_GT(numTiles, 0);
+   EXPECT_TRUE(mMesh->save());
+
+   queueTileBuilds();
+   EXPECT_TRUE(mMesh->load());
+   EXPECT_EQ(numTiles, countTiles());
+
+   // Nothing left over from before the load gets swapped in.
+   mMesh->processTick(NULL);
+   EXPECT_EQ(numTiles, countTiles());
+
+   dFileDelete("navMeshBuildTest.nav");
+}
+
+TEST_FIX(NavMeshBuild, PathCacheDroppedOnRebuild)
+{
+   ASSERT_TRUE(mMesh->build(false, false));
+   NavPathService::get().clearCache();
+
+   NavPathRequestPtr first = planPath();
+   ASSERT_EQ(NavPathRequest::Succeeded, first->getStatus());
+
+   // The same path again comes out of the cache.
+   U32 cacheHits = NavPathService::get().getStats().cacheHits;
+   NavPathRequestPtr second = planPath();
+   ASSERT_EQ(NavPathRequest::Succeeded, second->getStatus());
+   EXPECT_EQ(cacheHits + 1, NavPathService::get().getStats().cacheHits);
+
+   // After a rebuild the cached corridor refers to the old mesh and must
+   // not be used, even if the new mesh reuses its address.
+   ASSERT_TRUE(mMesh->build(false, false));
+   cacheHits = NavPathService::get().getStats().cacheHits;
+   NavPathRequestPtr third = planPath();
+   ASSERT_EQ(NavPathRequest::Succeeded, third->getStatus());
+   EXPECT_EQ(cacheHits, NavPathService::get().getStats().cacheHits);
+
+   ASSERT_EQ(first->getPoints().size(), third->getPoints().size());
+   for (U32 i = 0; i < first->getPoints().size(); i++)
+      EXPECT_TRUE(first->getPoints()[i].equal(third->getPoints()[i], 0.01f));
+}
+
+TEST_FIX(NavMeshBuild, PathPlanningRestartsOnRebuild)
+{
+   ASSERT_TRUE(mMesh->build(false, false));
+   NavPathService::get().clearCache();
+
+   // Start the search with the smallest slices so it is still running
+   // when the mesh is rebuilt under it.
+   NavPathRequestPtr req = NavPathService::get().request(mMesh,
+      Point3F(-10.0f, -10.0f, 0.0f), Point3F(10.0f, 10.0f, 0.0f), 0xffff, 1.0f, 1);
+   const S32 budget = NavPathService::smTickBudgetMS;
+   NavPathService::smTickBudgetMS = 0;
+   NavPathService::get().process();
+   NavPathService::smTickBudgetMS = budget;
+   ASSERT_EQ(NavPathRequest::Planning, req->getStatus());
+
+   ASSERT_TRUE(mMesh->build(false, false));
+   EXPECT_EQ(NavPathRequest::Queued, req->getStatus());
+
+   for (U32 i = 0; i < 1000 && !req->isDone(); i++)
+      NavPathService::get().process();
+   EXPECT_EQ(NavPathRequest::Succeeded, req->getStatus());
+}
+
+TEST_FIX(NavMeshBuild, PathRequestsCoalesce)
+{
+   ASSERT_TRUE(mMesh->build(false, false));
+
+   // Nothing gets planned until process() runs, so these stay queued.
+   const U32 coalesced = NavPathService::get().getStats().coalesced;
+   NavPathRequestPtr far = queueSlowPath(Point3F(-10.0f, 10.0f, 0.0f), Point3F(10.0f, -10.0f, 0.0f), 1.0f);
+   NavPathRequestPtr first = queueSlowPath(Point3F(-10.0f, -10.0f, 0.0f), Point3F(10.0f, 10.0f, 0.0f), 1.0f);
+   NavPathRequestPtr close = queueSlowPath(Point3F(-10.1f, -10.0f, 0.0f), Point3F(10.0f, 10.1f, 0.0f), 3.0f);
+   NavPathRequestPtr otherFlags = NavPathService::get().request(mMesh,
+      Point3F(-10.0f, -10.0f, 0.0f), Point3F(10.0f, 10.0f, 0.0f), 0x0001, 1.0f, 1);
+
+   EXPECT_EQ(first.getPointer(), close.getPointer());
+   EXPECT_NE(first.getPointer(), far.getPointer());
+   EXPECT_NE(first.getPointer(), otherFlags.getPointer());
+   EXPECT_EQ(coalesced + 1, NavPathService::get().getStats().coalesced);
+
+   // The merged request plans at the higher of the two priorities, ahead
+   // of the older request.
+   NavPathService::smMaxPlanning = 1;
+   NavPathService::smTickBudgetMS = 0;
+   NavPathService::get().process();
+   EXPECT_EQ(NavPathRequest::Planning, first->getStatus());
+   EXPECT_EQ(NavPathRequest::Queued, far->getStatus());
+
+   finishPaths();
+   EXPECT_EQ(NavPathRequest::Succeeded, close->getStatus());
+   EXPECT_EQ(NavPathRequest::Succeeded, far->getStatus());
+}
+
+TEST_FIX(NavMeshBuild, PathRequestsPlanByPriority)
+{
+   ASSERT_TRUE(mMesh->build(false, false));
+   NavPathService::get().clearCache();
+
+   // One search at a time, one slice per tick and no cached corridors, so
+   // exactly one request is in flight after every process().
+   NavPathService::smMaxPlanning = 1;
+   NavPathService::smTickBudgetMS = 0;
+   NavPathService::smMaxCachedPaths = 0;
+
+   NavPathRequestPtr low = queueSlowPath(Point3F(-10.0f, -10.0f, 0.0f), Point3F(10.0f, 10.0f, 0.0f), 1.0f);
+   NavPathRequestPtr high = queueSlowPath(Point3F(-10.0f, 10.0f, 0.0f), Point3F(10.0f, -10.0f, 0.0f), 5.0f);
+   NavPathRequestPtr highLater = queueSlowPath(Point3F(10.0f, 10.0f, 0.0f), Point3F(-10.0f, -10.0f, 0.0f), 5.0f);
+
+   // Highest priority first, then first come first served.
+   NavPathRequestPtr order[] = { high, highLater, low };
+   for (U32 i = 0; i < 3; i++)
+   {
+      NavPathService::get().process();
+      ASSERT_EQ(NavPathRequest::Planning, order[i]->getStatus());
+      for (U32 j = i + 1; j < 3; j++)
+         EXPECT_EQ(NavPathRequest::Queued, order[j]->getStatus());
+
+      for (U32 k = 0; k < 10000 && !order[i]->isDone(); k++)
+         NavPathService::get().process();
+      ASSERT_EQ(NavPathRequest::Succeeded, order[i]->getStatus());
+   }
+}
+
+TEST_FIX(NavMeshBuild, PathPlanningBudget)
+{
+   ASSERT_TRUE(mMesh->build(false, false));
+   NavPathService::get().clearCache();
+   NavPathService::smMaxCachedPaths = 0;
+   NavPathService::smMaxPlanning = 2;
+
+   NavPathRequestPtr reqs[] = {
+      queueSlowPath(Point3F(-10.0f, -10.0f, 0.0f), Point3F(10.0f, 10.0f, 0.0f)),
+      queueSlowPath(Point3F(-10.0f, 10.0f, 0.0f), Point3F(10.0f, -10.0f, 0.0f)),
+      queueSlowPath(Point3F(10.0f, 10.0f, 0.0f), Point3F(-10.0f, -10.0f, 0.0f)),
+      queueSlowPath(Point3F(10.0f, -10.0f, 0.0f), Point3F(-10.0f, 10.0f, 0.0f)),
+   };
+
+   // With no time budget a tick runs one slice of each search and stops,
+   // and no more than maxPlanning searches are started.
+   NavPathService::smTickBudgetMS = 0;
+   NavPathService::get().process();
+   EXPECT_EQ(2U, NavPathService::get().getStats().planning);
+   EXPECT_EQ(2U, NavPathService::get().getStats().queued);
+   for (U32 i = 0; i < 4; i++)
+      EXPECT_FALSE(reqs[i]->isDone());
+
+   // A generous budget keeps slicing until every request is planned.
+   NavPathService::smTickBudgetMS = 10000;
+   NavPathService::get().process();
+   EXPECT_EQ(0U, NavPathService::get().getStats().planning);
+   EXPECT_EQ(0U, NavPathService::get().getStats().queued);
+   for (U32 i = 0; i < 4; i++)
+      EXPECT_EQ(NavPathRequest::Succeeded, reqs[i]->getStatus());
+}
+
+#endif
@@ -0,0 +1,305 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2013 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "persistence/taml/binary/tamlMappedDocument.h"
+
+#ifndef _FILESTREAM_H_
+#include "core/stream/fileStream.h"
+#endif
+
+#ifndef _CONSOLE_H_
+#include "console/console.h"
+#endif
+
+// Debug Profiling.
+#include "platform/profiler.h"
+
+//-----------------------------------------------------------------------------
+
+TamlMappedDocument::TamlMappedDocument() :
+    mpBuffer( NULL ),
+    mpData( NULL ),
+    mDataSize( 0 ),
+    mpHeader( NULL ),
+    mpElements( NULL ),
+    mpAttributes( NULL ),
+    mpCustomNodes( NULL ),
+    mpIndices( NULL ),
+    mpStringOffsets( NULL ),
+    mpStringData( NULL )
+{
+}
+
+//-----------------------------------------------------------------------------
+
+TamlMappedDocument::~TamlMappedDocument()
+{
+    close();
+}
+
+//-----------------------------------------------------------------------------
+
+bool TamlMappedDocument::open( const char* pFilename )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedDocument_Open);
+
+    // Sanity!
+    AssertFatal( pFilename != NULL, "Cannot open a NULL filename." );
+
+    close();
+
+    // Fetch the native path.
+    char pathBuffer[1024];
+    Platform::makeFullPathName( pFilename, pathBuffer, sizeof(pathBuffer) );
+
+    const U8* pData = NULL;
+    U32 size = 0;
+
+    // Can we map the file?
+    if ( mMappedFile.open( pathBuffer ) )
+    {
+        // Yes, so use it in place.
+        pData = mMappedFile.getData();
+        size = mMappedFile.getSize();
+    }
+    else
+    {
+        // No, so read it through the file system instead.
+        FileStream stream;
+        if ( !stream.open( pFilename, Torque::FS::File::Read ) )
+        {
+            // Warn.
+            Con::warnf("Taml: Could not open mapped binary file '%s'.", pFilename );
+            return false;
+        }
+
+        size = stream.getStreamSize();
+        mpBuffer = (U8*)dMalloc( getMax( size, (U32)1 ) );
+        if ( !stream.read( size, mpBuffer ) )
+        {
+            // Warn.
+            Con::warnf("Taml: Could not read mapped binary file '%s'.", pFilename );
+            close();
+            return false;
+        }
+
+        pData = mpBuffer;
+    }
+
+    // Is the document valid?
+    if ( !validate( pData, size ) )
+    {
+        // No, so warn.
+        Con::warnf("Taml: Cannot read mapped binary file '%s' as it is invalid.", pFilename );
+        close();
+        return false;
+    }
+
+    mpData = pData;
+    mDataSize = size;
+
+    // Size the string table entry cache.
+    mStringEntries.setSize( mpHeader->getStringCount() );
+    dMemset( mStringEntries.address(), 0, mStringEntries.memSize() );
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+void TamlMappedDocument::close( void )
+{
+    mMappedFile.close();
+
+    if ( mpBuffer != NULL )
+    {
+        dFree( mpBuffer );
+        mpBuffer = NULL;
+    }
+
+    mpData = NULL;
+    mDataSize = 0;
+    mpHeader = NULL;
+    mpElements = NULL;
+    mpAttributes = NULL;
+    mpCustomNodes = NULL;
+    mpIndices = NULL;
+    mpStringOffsets = NULL;
+    mpStringData = NULL;
+
+    mStringEntries.clear();
+}
+
+//-----------------------------------------------------------------------------
+
+bool TamlMappedDocument::validate( const U8* pData, const U32 size )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedDocument_Validate);
+
+    // Is the header present and correct?
+    if ( size < sizeof(TamlMapped::Header) )
+        return false;
+
+    const TamlMapped::Header* pHeader = (const TamlMapped::Header*)pData;
+
+    if ( dMemcmp( pHeader->mSignature, TamlMapped::Signature, sizeof(TamlMapped::Signature) ) != 0 ||
+         pHeader->getVersion() != TamlMapped::Version ||
+         pHeader->getFileSize() > size )
+        return false;
+
+    const U32 fileSize = pHeader->getFileSize();
+
+    // Are the tables within the file and aligned?
+    const U32 tableOffsets[] = { pHeader->getElementsOffset(), pHeader->getAttributesOffset(), pHeader->getCustomNodesOffset(), pHeader->getIndicesOffset(), pHeader->getStringOffsetsOffset(), pHeader->getStringDataOffset() };
+    const U32 tableCounts[] = { pHeader->getElementCount(), pHeader->getAttributeCount(), pHeader->getCustomNodeCount(), pHeader->getIndexCount(), pHeader->getStringCount(), pHeader->getStringDataSize() };
+    const U32 tableStrides[] = { sizeof(TamlMapped::Element), sizeof(TamlMapped::Attribute), sizeof(TamlMapped::CustomNode), sizeof(U32), sizeof(U32), 1 };
+
+    for ( U32 table = 0; table < sizeof(tableOffsets) / sizeof(U32); ++table )
+    {
+        if ( ( tableOffsets[table] & 3 ) != 0 ||
+             (U64)tableOffsets[table] + (U64)tableCounts[table] * tableStrides[table] > fileSize )
+            return false;
+    }
+
+    mpHeader = pHeader;
+    mpElements = (const TamlMapped::Element*)( pData + pHeader->getElementsOffset() );
+    mpAttributes = (const TamlMapped::Attribute*)( pData + pHeader->getAttributesOffset() );
+    mpCustomNodes = (const TamlMapped::CustomNode*)( pData + pHeader->getCustomNodesOffset() );
+    mpIndices = (const U32*)( pData + pHeader->getIndicesOffset() );
+    mpStringOffsets = (const U32*)( pData + pHeader->getStringOffsetsOffset() );
+    mpStringData = (const char*)( pData + pHeader->getStringDataOffset() );
+
+    // Are the strings terminated?
+    const U32 stringCount = pHeader->getStringCount();
+    const U32 stringDataSize = pHeader->getStringDataSize();
+    if ( stringCount == 0 || stringDataSize == 0 || mpStringData[stringDataSize-1] != 0 )
+        return false;
+
+    for ( U32 index = 0; index < stringCount; ++index )
+    {
+        if ( TamlMapped::fromStored( mpStringOffsets[index] ) >= stringDataSize )
+            return false;
+    }
+
+    // Do the attributes refer to strings?
+    for ( U32 index = 0; index < pHeader->getAttributeCount(); ++index )
+    {
+        const TamlMapped::Attribute& attribute = mpAttributes[index];
+        if ( attribute.getName() >= stringCount || attribute.getValue() >= stringCount )
+            return false;
+    }
+
+    // Is there a root element?
+    if ( pHeader->getRootElement() >= pHeader->getElementCount() )
+        return false;
+
+    // Walk the document.  Every element and custom node must be reached once
+    // at most so that readers can recurse without guarding against cycles.
+    Vector<bool> elementsVisited;
+    Vector<bool> customNodesVisited;
+    elementsVisited.setSize( pHeader->getElementCount() );
+    customNodesVisited.setSize( pHeader->getCustomNodeCount() );
+    dMemset( elementsVisited.address(), 0, elementsVisited.memSize() );
+    dMemset( customNodesVisited.address(), 0, customNodesVisited.memSize() );
+
+    return validateElement( pHeader->getRootElement(), 0, elementsVisited, customNodesVisited );
+}
+
+//-----------------------------------------------------------------------------
+
+bool TamlMappedDocument::validateRange( const U32 first, const U32 count, const U32 limit ) const
+{
+    return (U64)first + (U64)count <= (U64)limit;
+}
+
+//-----------------------------------------------------------------------------
+
+bool TamlMappedDocument::validateElement( const U32 index, const U32 depth, Vector<bool>& elementsVisited, Vector<bool>& customNodesVisited ) const
+{
+    // Is the element valid, not nested too deep and not already used?
+    if ( index >= (U32)elementsVisited.size() || depth > TamlMapped::MaxDepth || elementsVisited[index] )
+        return false;
+
+    elementsVisited[index] = true;
+
+    const TamlMapped::Element& element = mpElements[index];
+    const U32 stringCount = mpHeader->getStringCount();
+
+    if ( element.getTypeName() >= stringCount ||
+         element.getObjectName() >= stringCount ||
+         !validateRange( element.getFirstAttribute(), element.getAttributeCount(), mpHeader->getAttributeCount() ) ||
+         !validateRange( element.getFirstChild(), element.getChildCount(), mpHeader->getIndexCount() ) ||
+         !validateRange( element.getFirstCustomNode(), element.getCustomNodeCount(), mpHeader->getIndexCount() ) )
+        return false;
+
+    // Validate children.
+    for ( U32 child = 0; child < element.getChildCount(); ++child )
+    {
+        if ( !validateElement( getIndex( element.getFirstChild() + child ), depth + 1, elementsVisited, customNodesVisited ) )
+            return false;
+    }
+
+    // Validate custom nodes.  These are read by name so cannot be proxy objects.
+    for ( U32 node = 0; node < element.getCustomNodeCount(); ++node )
+    {
+        if ( !validateCustomNode( getIndex( element.getFirstCustomNode() + node ), depth + 1, false, elementsVisited, customNodesVisited ) )
+            return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool TamlMappedDocument::validateCustomNode( const U32 index, const U32 depth, const bool allowProxy, Vector<bool>& elementsVisited, Vector<bool>& customNodesVisited ) const
+{
+    // Is the custom node valid, not nested too deep and not already used?
+    if ( index >= (U32)customNodesVisited.size() || depth > TamlMapped::MaxDepth || customNodesVisited[index] )
+        return false;
+
+    customNodesVisited[index] = true;
+
+    const TamlMapped::CustomNode& node = mpCustomNodes[index];
+    const U32 stringCount = mpHeader->getStringCount();
+
+    // Validate the node itself whatever kind it is.
+    if ( node.getName() >= stringCount ||
+         node.getText() >= stringCount ||
+         !validateRange( node.getFirstChild(), node.getChildCount(), mpHeader->getIndexCount() ) ||
+         !validateRange( node.getFirstField(), node.getFieldCount(), mpHeader->getAttributeCount() ) )
+        return false;
+
+    // Is this a proxy object?
+    if ( node.getProxyElement() != TamlMapped::InvalidIndex )
+        return allowProxy && validateElement( node.getProxyElement(), depth + 1, elementsVisited, customNodesVisited );
+
+    // Validate children nodes.
+    for ( U32 child = 0; child < node.getChildCount(); ++child )
+    {
+        if ( !validateCustomNode( getIndex( node.getFirstChild() + child ), depth + 1, true, elementsVisited, customNodesVisited ) )
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2013 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _TAML_MAPPEDDOCUMENT_H_
+#define _TAML_MAPPEDDOCUMENT_H_
+
+#ifndef _TAML_MAPPEDFORMAT_H_
+#include "persistence/taml/binary/tamlMappedFormat.h"
+#endif
+
+#ifndef _PLATFORMMAPPEDFILE_H_
+#include "platform/platformMappedFile.h"
+#endif
+
+#ifndef _STRINGTABLE_H_
+#include "core/stringTable.h"
+#endif
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+//-----------------------------------------------------------------------------
+
+/// A mapped binary Taml document opened for reading in place.
+///
+/// The file is memory mapped where possible, otherwise (e.g. for files inside
+/// zip archives) it is read into a single buffer.  The document is validated
+/// once when opened so the accessors do no checking of their own.
+///
+/// @ingroup tamlGroup
+/// @see tamlGroup
+class TamlMappedDocument
+{
+public:
+    TamlMappedDocument();
+    ~TamlMappedDocument();
+
+    /// Open the (expanded) file.
+    bool open( const char* pFilename );
+
+    /// Close the document.  Any strings fetched from it are invalid afterwards.
+    void close( void );
+
+    inline bool isOpen( void ) const { return mpHeader != NULL; }
+
+    /// Whether the document is used directly from a memory mapping.
+    inline bool isMapped( void ) const { return mMappedFile.isOpen(); }
+
+    /// The whole document as it is stored in the file.
+    inline const U8* getData( void ) const { return mpData; }
+    inline U32 getDataSize( void ) const { return mDataSize; }
+
+    inline const TamlMapped::Header& getHeader( void ) const { return *mpHeader; }
+    inline U32 getRootElement( void ) const { return mpHeader->getRootElement(); }
+
+    inline const TamlMapped::Element& getElement( const U32 index ) const { return mpElements[index]; }
+    inline const TamlMapped::Attribute& getAttribute( const U32 index ) const { return mpAttributes[index]; }
+    inline const TamlMapped::CustomNode& getCustomNode( const U32 index ) const { return mpCustomNodes[index]; }
+    inline U32 getIndex( const U32 index ) const { return TamlMapped::fromStored( mpIndices[index] ); }
+
+    /// Fetch a string in place.
+    inline const char* getString( const U32 index ) const { return mpStringData + TamlMapped::fromStored( mpStringOffsets[index] ); }
+
+    /// Fetch a string as a string table entry.  Entries are only inserted
+    /// into the string table the first time they are asked for.
+    inline StringTableEntry getStringEntry( const U32 index )
+    {
+        StringTableEntry& entry = mStringEntries[index];
+        if ( entry == NULL )
+            entry = StringTable->insert( getString( index ) );
+        return entry;
+    }
+
+private:
+    PlatformMappedFile              mMappedFile;
+    U8*                             mpBuffer;
+    const U8*                       mpData;
+    U32                             mDataSize;
+
+    const TamlMapped::Header*       mpHeader;
+    const TamlMapped::Element*      mpElements;
+    const TamlMapped::Attribute*    mpAttributes;
+    const TamlMapped::CustomNode*   mpCustomNodes;
+    const U32*                      mpIndices;
+    const U32*                      mpStringOffsets;
+    const char*                     mpStringData;
+
+    Vector<StringTableEntry>        mStringEntries;
+
+private:
+    bool validate( const U8* pData, const U32 size );
+    bool validateRange( const U32 first, const U32 count, const U32 limit ) const;
+    bool validateElement( const U32 index, const U32 depth, Vector<bool>& elementsVisited, Vector<bool>& customNodesVisited ) const;
+    bool validateCustomNode( const U32 index, const U32 depth, const bool allowProxy, Vector<bool>& elementsVisited, Vector<bool>& customNodesVisited ) const;
+};
+
+#endif // _TAML_MAPPEDDOCUMENT_H_
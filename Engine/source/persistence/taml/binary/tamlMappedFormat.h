@@ -0,0 +1,173 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2013 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _TAML_MAPPEDFORMAT_H_
+#define _TAML_MAPPEDFORMAT_H_
+
+#ifndef _TORQUE_TYPES_H_
+#include "platform/types.h"
+#endif
+
+#ifndef _ENDIAN_H_
+#include "core/util/endian.h"
+#endif
+
+//-----------------------------------------------------------------------------
+
+/// The mapped binary format is laid out so that a document can be used in
+/// place, directly from a memory mapping of the file.  It consists of a
+/// header followed by flat tables of fixed size records:
+///
+/// - Elements, one per object (or reference to an object).
+/// - Attributes, the field name/value pairs of the elements.
+/// - Custom nodes, the custom nodes of the elements and their children.
+/// - Indices, ranges of which list the child elements and child custom nodes.
+/// - String offsets and the string data itself.
+///
+/// All strings are stored once, NUL terminated, and are referred to by
+/// their index.  String zero is always the empty string.  All values are
+/// little-endian and all tables are four byte aligned.
+///
+/// @ingroup tamlGroup
+/// @see tamlGroup
+namespace TamlMapped
+{
+    /// File signature.
+    static const char Signature[4] = { 'T', 'M', 'A', 'P' };
+
+    /// Current format version.
+    static const U32 Version = 1;
+
+    /// Used for table indices that do not refer to anything.
+    static const U32 InvalidIndex = 0xFFFFFFFF;
+
+    /// Deepest nesting of elements and custom nodes that is read, so that
+    /// the recursive readers cannot run out of stack.
+    static const U32 MaxDepth = 256;
+
+    /// Fetch a stored value.
+    inline U32 fromStored( const U32 value ) { return convertLEndianToHost( value ); }
+
+    //-----------------------------------------------------------------------------
+
+    struct Header
+    {
+        char    mSignature[4];
+        U32     mVersion;
+        U32     mFileSize;
+        U32     mRootElement;
+        U32     mStringCount;
+        U32     mStringOffsetsOffset;
+        U32     mStringDataOffset;
+        U32     mStringDataSize;
+        U32     mElementCount;
+        U32     mElementsOffset;
+        U32     mAttributeCount;
+        U32     mAttributesOffset;
+        U32     mCustomNodeCount;
+        U32     mCustomNodesOffset;
+        U32     mIndexCount;
+        U32     mIndicesOffset;
+
+        inline U32 getVersion( void ) const             { return fromStored( mVersion ); }
+        inline U32 getFileSize( void ) const            { return fromStored( mFileSize ); }
+        inline U32 getRootElement( void ) const         { return fromStored( mRootElement ); }
+        inline U32 getStringCount( void ) const         { return fromStored( mStringCount ); }
+        inline U32 getStringOffsetsOffset( void ) const { return fromStored( mStringOffsetsOffset ); }
+        inline U32 getStringDataOffset( void ) const    { return fromStored( mStringDataOffset ); }
+        inline U32 getStringDataSize( void ) const      { return fromStored( mStringDataSize ); }
+        inline U32 getElementCount( void ) const        { return fromStored( mElementCount ); }
+        inline U32 getElementsOffset( void ) const      { return fromStored( mElementsOffset ); }
+        inline U32 getAttributeCount( void ) const      { return fromStored( mAttributeCount ); }
+        inline U32 getAttributesOffset( void ) const    { return fromStored( mAttributesOffset ); }
+        inline U32 getCustomNodeCount( void ) const     { return fromStored( mCustomNodeCount ); }
+        inline U32 getCustomNodesOffset( void ) const   { return fromStored( mCustomNodesOffset ); }
+        inline U32 getIndexCount( void ) const          { return fromStored( mIndexCount ); }
+        inline U32 getIndicesOffset( void ) const       { return fromStored( mIndicesOffset ); }
+    };
+
+    //-----------------------------------------------------------------------------
+
+    /// An object.  Elements with a non-zero reference-to Id only refer to
+    /// a previous element and have no attributes, children or custom nodes.
+    struct Element
+    {
+        U32     mTypeName;
+        U32     mObjectName;
+        U32     mRefId;
+        U32     mRefToId;
+        U32     mFirstAttribute;
+        U32     mAttributeCount;
+        U32     mFirstChild;
+        U32     mChildCount;
+        U32     mFirstCustomNode;
+        U32     mCustomNodeCount;
+
+        inline U32 getTypeName( void ) const        { return fromStored( mTypeName ); }
+        inline U32 getObjectName( void ) const      { return fromStored( mObjectName ); }
+        inline U32 getRefId( void ) const           { return fromStored( mRefId ); }
+        inline U32 getRefToId( void ) const         { return fromStored( mRefToId ); }
+        inline U32 getFirstAttribute( void ) const  { return fromStored( mFirstAttribute ); }
+        inline U32 getAttributeCount( void ) const  { return fromStored( mAttributeCount ); }
+        inline U32 getFirstChild( void ) const      { return fromStored( mFirstChild ); }
+        inline U32 getChildCount( void ) const      { return fromStored( mChildCount ); }
+        inline U32 getFirstCustomNode( void ) const { return fromStored( mFirstCustomNode ); }
+        inline U32 getCustomNodeCount( void ) const { return fromStored( mCustomNodeCount ); }
+    };
+
+    //-----------------------------------------------------------------------------
+
+    /// A field name/value pair of an element or custom node.
+    struct Attribute
+    {
+        U32     mName;
+        U32     mValue;
+
+        inline U32 getName( void ) const    { return fromStored( mName ); }
+        inline U32 getValue( void ) const   { return fromStored( mValue ); }
+    };
+
+    //-----------------------------------------------------------------------------
+
+    /// A custom node.  If the proxy element is valid then the node is a proxy
+    /// object and only refers to that element.
+    struct CustomNode
+    {
+        U32     mName;
+        U32     mText;
+        U32     mProxyElement;
+        U32     mFirstChild;
+        U32     mChildCount;
+        U32     mFirstField;
+        U32     mFieldCount;
+
+        inline U32 getName( void ) const            { return fromStored( mName ); }
+        inline U32 getText( void ) const            { return fromStored( mText ); }
+        inline U32 getProxyElement( void ) const    { return fromStored( mProxyElement ); }
+        inline U32 getFirstChild( void ) const      { return fromStored( mFirstChild ); }
+        inline U32 getChildCount( void ) const      { return fromStored( mChildCount ); }
+        inline U32 getFirstField( void ) const      { return fromStored( mFirstField ); }
+        inline U32 getFieldCount( void ) const      { return fromStored( mFieldCount ); }
+    };
+}
+
+#endif // _TAML_MAPPEDFORMAT_H_
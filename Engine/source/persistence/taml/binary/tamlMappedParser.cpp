@@ -0,0 +1,171 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2013 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "persistence/taml/binary/tamlMappedParser.h"
+#include "persistence/taml/tamlVisitor.h"
+#include "console/console.h"
+#include "core/util/hashFunction.h"
+
+// Debug Profiling.
+#include "platform/profiler.h"
+
+//-----------------------------------------------------------------------------
+
+bool TamlMappedParser::accept( const char* pFilename, TamlVisitor& visitor )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedParser_Accept);
+
+    // Sanity!
+    AssertFatal( pFilename != NULL, "Cannot parse a NULL filename." );
+
+    // Expand the file-path.
+    char filenameBuffer[1024];
+    Con::expandToolScriptFilename( filenameBuffer, sizeof(filenameBuffer), pFilename );
+
+    // Open the document.
+    if ( !mDocument.open( filenameBuffer ) )
+    {
+        // Warn!
+        Con::warnf("TamlMappedParser: Could not load Taml mapped binary file '%s'.", filenameBuffer );
+        return false;
+    }
+
+    // Hash the contents if requested.
+    if ( getHashContents() )
+        setContentHash( Torque::hash( mDocument.getData(), mDocument.getDataSize(), 0 ) );
+
+    // Set parsing filename.
+    setParsingFilename( filenameBuffer );
+
+    // Parse root element.
+    parseElement( mDocument.getRootElement(), visitor );
+
+    // Reset parsing filename.
+    setParsingFilename( StringTable->EmptyString() );
+
+    // Close the document.
+    mDocument.close();
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+inline bool TamlMappedParser::parseElement( const U32 elementIndex, TamlVisitor& visitor )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedParser_ParseElement);
+
+    // Fetch element.
+    const TamlMapped::Element& element = mDocument.getElement( elementIndex );
+
+    // Parse attributes (stop processing if instructed).
+    if ( !parseAttributes( mDocument.getString( element.getTypeName() ), elementIndex == mDocument.getRootElement(), element.getFirstAttribute(), element.getAttributeCount(), visitor ) )
+        return false;
+
+    // Finish if only the root is needed.
+    if ( visitor.wantsRootOnly() )
+        return false;
+
+    // Iterate children.
+    const U32 firstChild = element.getFirstChild();
+    for ( U32 index = 0; index < element.getChildCount(); ++index )
+    {
+        // Parse element (stop processing if instructed).
+        if ( !parseElement( mDocument.getIndex( firstChild + index ), visitor ) )
+            return false;
+    }
+
+    // Iterate custom nodes.
+    const U32 firstCustomNode = element.getFirstCustomNode();
+    for ( U32 index = 0; index < element.getCustomNodeCount(); ++index )
+    {
+        // Fetch custom node.
+        const TamlMapped::CustomNode& node = mDocument.getCustomNode( mDocument.getIndex( firstCustomNode + index ) );
+
+        // Iterate custom node children (stop processing if instructed).
+        const U32 firstNodeChild = node.getFirstChild();
+        for ( U32 childIndex = 0; childIndex < node.getChildCount(); ++childIndex )
+        {
+            if ( !parseCustomNode( mDocument.getIndex( firstNodeChild + childIndex ), visitor ) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+inline bool TamlMappedParser::parseCustomNode( const U32 nodeIndex, TamlVisitor& visitor )
+{
+    // Fetch custom node.
+    const TamlMapped::CustomNode& node = mDocument.getCustomNode( nodeIndex );
+
+    // Is this a proxy object?
+    if ( node.getProxyElement() != TamlMapped::InvalidIndex )
+        return parseElement( node.getProxyElement(), visitor );
+
+    // Parse fields (stop processing if instructed).
+    if ( !parseAttributes( mDocument.getString( node.getName() ), false, node.getFirstField(), node.getFieldCount(), visitor ) )
+        return false;
+
+    // Iterate children nodes.
+    const U32 firstChild = node.getFirstChild();
+    for ( U32 index = 0; index < node.getChildCount(); ++index )
+    {
+        // Parse custom node (stop processing if instructed).
+        if ( !parseCustomNode( mDocument.getIndex( firstChild + index ), visitor ) )
+            return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+inline bool TamlMappedParser::parseAttributes( const char* pObjectName, const bool isRoot, const U32 firstAttribute, const U32 attributeCount, TamlVisitor& visitor )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedParser_ParseAttribute);
+
+    // Create a visitor property state.
+    TamlVisitor::PropertyState propertyState;
+    propertyState.setObjectName( pObjectName, isRoot );
+
+    // Iterate attributes.
+    for ( U32 index = firstAttribute; index < firstAttribute + attributeCount; ++index )
+    {
+        // Fetch attribute.
+        const TamlMapped::Attribute& attribute = mDocument.getAttribute( index );
+
+        // Configure property state.
+        propertyState.setProperty( mDocument.getString( attribute.getName() ), mDocument.getString( attribute.getValue() ) );
+
+        // Visit this attribute (finish if requested).
+        if ( !visitor.visit( *this, propertyState ) )
+            return false;
+    }
+
+    return true;
+}
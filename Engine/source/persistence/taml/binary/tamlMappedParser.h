@@ -0,0 +1,59 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2013 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _TAML_MAPPEDPARSER_H_
+#define _TAML_MAPPEDPARSER_H_
+
+#ifndef _TAML_PARSER_H_
+#include "persistence/taml/tamlParser.h"
+#endif
+
+#ifndef _TAML_MAPPEDDOCUMENT_H_
+#include "persistence/taml/binary/tamlMappedDocument.h"
+#endif
+
+//-----------------------------------------------------------------------------
+
+/// Visits a mapped binary document in place without creating any objects.
+/// @ingroup tamlGroup
+/// @see tamlGroup
+class TamlMappedParser : public TamlParser
+{
+public:
+    TamlMappedParser() {}
+    virtual ~TamlMappedParser() {}
+
+    /// Whether the parser can change a property or not.
+    virtual bool canChangeProperty( void ) { return false; }
+
+    /// Accept visitor.
+    virtual bool accept( const char* pFilename, TamlVisitor& visitor );
+
+private:
+    inline bool parseElement( const U32 elementIndex, TamlVisitor& visitor );
+    inline bool parseCustomNode( const U32 nodeIndex, TamlVisitor& visitor );
+    inline bool parseAttributes( const char* pObjectName, const bool isRoot, const U32 firstAttribute, const U32 attributeCount, TamlVisitor& visitor );
+
+    TamlMappedDocument mDocument;
+};
+
+#endif // _TAML_MAPPEDPARSER_H_
@@ -0,0 +1,362 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2013 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "persistence/taml/binary/tamlMappedReader.h"
+
+// Debug Profiling.
+#include "platform/profiler.h"
+
+//-----------------------------------------------------------------------------
+
+SimObject* TamlMappedReader::read( const char* pFilename )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedReader_Read);
+
+    // Open the document.
+    if ( !mDocument.open( pFilename ) )
+        return NULL;
+
+    // Parse root element.
+    SimObject* pSimObject = parseElement( mDocument.getRootElement() );
+
+    // Reset parse.
+    resetParse();
+
+    return pSimObject;
+}
+
+//-----------------------------------------------------------------------------
+
+void TamlMappedReader::resetParse( void )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedReader_ResetParse);
+
+    // Clear object reference map.
+    mObjectReferenceMap.clear();
+
+    // Close the document.
+    mDocument.close();
+}
+
+//-----------------------------------------------------------------------------
+
+SimObject* TamlMappedReader::parseElement( const U32 elementIndex )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedReader_ParseElement);
+
+    SimObject* pSimObject = NULL;
+
+#ifdef TORQUE_DEBUG
+    // Format the type location.
+    char typeLocationBuffer[64];
+    dSprintf( typeLocationBuffer, sizeof(typeLocationBuffer), "Taml [format='mappedBinary' element=%u]", elementIndex );
+#endif
+
+    // Fetch element.
+    const TamlMapped::Element& element = mDocument.getElement( elementIndex );
+
+    // Do we have a reference to Id?
+    const U32 tamlRefToId = element.getRefToId();
+    if ( tamlRefToId != 0 )
+    {
+        // Yes, so fetch reference.
+        typeObjectReferenceHash::Iterator referenceItr = mObjectReferenceMap.find( tamlRefToId );
+
+        // Did we find the reference?
+        if ( referenceItr == mObjectReferenceMap.end() )
+        {
+            // No, so warn.
+            Con::warnf( "Taml: Could not find a reference Id of '%d'", tamlRefToId );
+            return NULL;
+        }
+
+        // Return object.
+        return referenceItr->value;
+    }
+
+    // Fetch element name.
+    StringTableEntry typeName = mDocument.getStringEntry( element.getTypeName() );
+
+#ifdef TORQUE_DEBUG
+    // Create type.
+    pSimObject = Taml::createType( typeName, mpTaml, typeLocationBuffer );
+#else
+    // Create type.
+    pSimObject = Taml::createType( typeName, mpTaml );
+#endif
+
+    // Finish if we couldn't create the type.
+    if ( pSimObject == NULL )
+        return NULL;
+
+    // Find Taml callbacks.
+    TamlCallbacks* pCallbacks = dynamic_cast<TamlCallbacks*>( pSimObject );
+
+    // Are there any Taml callbacks?
+    if ( pCallbacks != NULL )
+    {
+        // Yes, so call it.
+        mpTaml->tamlPreRead( pCallbacks );
+    }
+
+    // Parse attributes.
+    parseAttributes( element, pSimObject );
+
+    // Fetch object name.
+    StringTableEntry objectName = mDocument.getStringEntry( element.getObjectName() );
+
+    // Does the object require a name?
+    if ( objectName == StringTable->EmptyString() )
+    {
+        // No, so just register anonymously.
+        pSimObject->registerObject();
+    }
+    else
+    {
+        // Yes, so register a named object.
+        pSimObject->registerObject( objectName );
+
+        // Was the name assigned?
+        if ( pSimObject->getName() != objectName )
+        {
+            // No, so warn that the name was rejected.
+#ifdef TORQUE_DEBUG
+            Con::warnf( "Taml::parseElement() - Registered an instance of type '%s' but a request to name it '%s' was rejected.  This is typically because an object of that name already exists.  '%s'", typeName, objectName, typeLocationBuffer );
+#else
+            Con::warnf( "Taml::parseElement() - Registered an instance of type '%s' but a request to name it '%s' was rejected.  This is typically because an object of that name already exists.", typeName, objectName );
+#endif
+        }
+    }
+
+    // Do we have a reference Id?
+    const U32 tamlRefId = element.getRefId();
+    if ( tamlRefId != 0 )
+    {
+        // Yes, so insert reference.
+        mObjectReferenceMap.insertUnique( tamlRefId, pSimObject );
+    }
+
+    // Parse custom elements.
+    TamlCustomNodes customProperties;
+
+    // Parse children.
+    parseChildren( element, pSimObject );
+
+    // Parse custom elements.
+    parseCustomElements( element, pCallbacks, customProperties );
+
+    // Are there any Taml callbacks?
+    if ( pCallbacks != NULL )
+    {
+        // Yes, so call it.
+        mpTaml->tamlPostRead( pCallbacks, customProperties );
+    }
+
+    // Return object.
+    return pSimObject;
+}
+
+//-----------------------------------------------------------------------------
+
+void TamlMappedReader::parseAttributes( const TamlMapped::Element& element, SimObject* pSimObject )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedReader_ParseAttributes);
+
+    // Sanity!
+    AssertFatal( pSimObject != NULL, "Taml: Cannot parse attributes on a NULL object." );
+
+    // Fetch attribute range.
+    const U32 firstAttribute = element.getFirstAttribute();
+    const U32 lastAttribute = firstAttribute + element.getAttributeCount();
+
+    // Iterate attributes.
+    for ( U32 index = firstAttribute; index < lastAttribute; ++index )
+    {
+        // Fetch attribute.
+        const TamlMapped::Attribute& attribute = mDocument.getAttribute( index );
+
+        // We can assume this is a field for now.  The value is used in place.
+        pSimObject->setPrefixedDataField( mDocument.getStringEntry( attribute.getName() ), NULL, mDocument.getString( attribute.getValue() ) );
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void TamlMappedReader::parseChildren( const TamlMapped::Element& element, SimObject* pSimObject )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedReader_ParseChildren);
+
+    // Sanity!
+    AssertFatal( pSimObject != NULL, "Taml: Cannot parse children on a NULL object." );
+
+    // Fetch children count.
+    const U32 childrenCount = element.getChildCount();
+
+    // Finish if no children.
+    if ( childrenCount == 0 )
+        return;
+
+    // Fetch the Taml children.
+    TamlChildren* pChildren = dynamic_cast<TamlChildren*>( pSimObject );
+
+    // Is this a sim set?
+    if ( pChildren == NULL )
+    {
+        // No, so warn.
+        Con::warnf("Taml: Child element found under parent but object cannot have children." );
+        return;
+    }
+
+    // Fetch any container child class specifier.
+    AbstractClassRep* pContainerChildClass = pSimObject->getClassRep()->getContainerChildClass( true );
+
+    // Iterate children.
+    const U32 firstChild = element.getFirstChild();
+    for ( U32 index = 0; index < childrenCount; ++ index )
+    {
+        // Parse child element.
+        SimObject* pChildSimObject = parseElement( mDocument.getIndex( firstChild + index ) );
+
+        // Finish if child failed.
+        if ( pChildSimObject == NULL )
+            return;
+
+        // Do we have a container child class?
+        if ( pContainerChildClass != NULL )
+        {
+            // Yes, so is the child object the correctly derived type?
+            if ( !pChildSimObject->getClassRep()->isClass( pContainerChildClass ) )
+            {
+                // No, so warn.
+                Con::warnf("Taml: Child element '%s' found under parent '%s' but object is restricted to children of type '%s'.",
+                    pChildSimObject->getClassName(),
+                    pSimObject->getClassName(),
+                    pContainerChildClass->getClassName() );
+
+                // NOTE: We can't delete the object as it may be referenced elsewhere!
+                pChildSimObject = NULL;
+
+                // Skip.
+                continue;
+            }
+        }
+
+        // Add child.
+        pChildren->addTamlChild( pChildSimObject );
+
+        // Find Taml callbacks for child.
+        TamlCallbacks* pChildCallbacks = dynamic_cast<TamlCallbacks*>( pChildSimObject );
+
+        // Do we have callbacks on the child?
+        if ( pChildCallbacks != NULL )
+        {
+            // Yes, so perform callback.
+            mpTaml->tamlAddParent( pChildCallbacks, pSimObject );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void TamlMappedReader::parseCustomElements( const TamlMapped::Element& element, TamlCallbacks* pCallbacks, TamlCustomNodes& customNodes )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedReader_ParseCustomElement);
+
+    // Fetch custom node count.
+    const U32 customNodeCount = element.getCustomNodeCount();
+
+    // Finish if no custom nodes.
+    if ( customNodeCount == 0 )
+        return;
+
+    // Iterate custom nodes.
+    const U32 firstCustomNode = element.getFirstCustomNode();
+    for ( U32 index = 0; index < customNodeCount; ++index )
+    {
+        // Fetch custom node.
+        const TamlMapped::CustomNode& node = mDocument.getCustomNode( mDocument.getIndex( firstCustomNode + index ) );
+
+        // Add custom node.
+        TamlCustomNode* pCustomNode = customNodes.addNode( mDocument.getStringEntry( node.getName() ) );
+
+        // Parse the custom node children.
+        const U32 firstChild = node.getFirstChild();
+        for ( U32 childIndex = 0; childIndex < node.getChildCount(); ++childIndex )
+            parseCustomNode( mDocument.getIndex( firstChild + childIndex ), pCustomNode );
+    }
+
+    // Do we have callbacks?
+    if ( pCallbacks == NULL )
+    {
+        // No, so warn.
+        Con::warnf( "Taml: Encountered custom data but object does not support custom data." );
+        return;
+    }
+
+    // Custom read callback.
+    mpTaml->tamlCustomRead( pCallbacks, customNodes );
+}
+
+//-----------------------------------------------------------------------------
+
+void TamlMappedReader::parseCustomNode( const U32 nodeIndex, TamlCustomNode* pCustomNode )
+{
+    // Fetch custom node.
+    const TamlMapped::CustomNode& node = mDocument.getCustomNode( nodeIndex );
+
+    // Is this a proxy object?
+    if ( node.getProxyElement() != TamlMapped::InvalidIndex )
+    {
+        // Yes, so parse proxy object.
+        SimObject* pProxyObject = parseElement( node.getProxyElement() );
+
+        // Add child node.
+        pCustomNode->addNode( pProxyObject );
+
+        return;
+    }
+
+    // No, so add child node.
+    TamlCustomNode* pChildNode = pCustomNode->addNode( mDocument.getStringEntry( node.getName() ) );
+
+    // Set child node text.
+    pChildNode->setNodeText( mDocument.getString( node.getText() ) );
+
+    // Parse children nodes.
+    const U32 firstChild = node.getFirstChild();
+    for( U32 childIndex = 0; childIndex < node.getChildCount(); ++childIndex )
+        parseCustomNode( mDocument.getIndex( firstChild + childIndex ), pChildNode );
+
+    // Parse child fields.
+    const U32 firstField = node.getFirstField();
+    for( U32 fieldIndex = 0; fieldIndex < node.getFieldCount(); ++fieldIndex )
+    {
+        const TamlMapped::Attribute& field = mDocument.getAttribute( firstField + fieldIndex );
+        pChildNode->addField( mDocument.getStringEntry( field.getName() ), mDocument.getString( field.getValue() ) );
+    }
+}
@@ -0,0 +1,80 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2013 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _TAML_MAPPEDREADER_H_
+#define _TAML_MAPPEDREADER_H_
+
+#ifndef _TDICTIONARY_H_
+#include "core/util/tDictionary.h"
+#endif
+
+#ifndef _TAML_H_
+#include "persistence/taml/taml.h"
+#endif
+
+#ifndef _TAML_MAPPEDDOCUMENT_H_
+#include "persistence/taml/binary/tamlMappedDocument.h"
+#endif
+
+//-----------------------------------------------------------------------------
+
+/// Reads the mapped binary format.  Field values are passed to the objects
+/// straight from the document without being copied or decoded first.
+///
+/// Like the other readers, every element of the document is instantiated
+/// when it is read, since Taml::read() hands back a registered object tree.
+/// Callers that only need to look at a document, such as the declared
+/// asset scan, use TamlMappedParser instead and never create objects.
+/// @ingroup tamlGroup
+/// @see tamlGroup
+class TamlMappedReader
+{
+public:
+    TamlMappedReader( Taml* pTaml ) :
+        mpTaml( pTaml )
+    {
+    }
+
+    virtual ~TamlMappedReader() {}
+
+    /// Read.
+    SimObject* read( const char* pFilename );
+
+private:
+    Taml* mpTaml;
+
+    typedef HashTable<SimObjectId, SimObject*> typeObjectReferenceHash;
+
+    typeObjectReferenceHash mObjectReferenceMap;
+    TamlMappedDocument      mDocument;
+
+private:
+    void resetParse( void );
+
+    SimObject* parseElement( const U32 elementIndex );
+    void parseAttributes( const TamlMapped::Element& element, SimObject* pSimObject );
+    void parseChildren( const TamlMapped::Element& element, SimObject* pSimObject );
+    void parseCustomElements( const TamlMapped::Element& element, TamlCallbacks* pCallbacks, TamlCustomNodes& customNodes );
+    void parseCustomNode( const U32 nodeIndex, TamlCustomNode* pCustomNode );
+};
+
+#endif // _TAML_MAPPEDREADER_H_
@@ -0,0 +1,314 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2013 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "persistence/taml/binary/tamlMappedWriter.h"
+
+// Debug Profiling.
+#include "platform/profiler.h"
+
+//-----------------------------------------------------------------------------
+
+bool TamlMappedWriter::write( FileStream& stream, const TamlWriteNode* pTamlWriteNode )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedWriter_Write);
+
+    // Reset the tables.
+    resetWrite();
+
+    // Flatten the document.
+    const U32 rootElement = addElement( pTamlWriteNode );
+
+    // Calculate the string data size.
+    U32 stringDataSize = 0;
+    for ( U32 index = 0; index < (U32)mStrings.size(); ++index )
+        stringDataSize += dStrlen( mStrings[index] ) + 1;
+
+    // Calculate the table offsets.
+    const U32 elementsOffset = sizeof(TamlMapped::Header);
+    const U32 attributesOffset = elementsOffset + mElements.size() * sizeof(TamlMapped::Element);
+    const U32 customNodesOffset = attributesOffset + mAttributes.size() * sizeof(TamlMapped::Attribute);
+    const U32 indicesOffset = customNodesOffset + mCustomNodes.size() * sizeof(TamlMapped::CustomNode);
+    const U32 stringOffsetsOffset = indicesOffset + mIndices.size() * sizeof(U32);
+    const U32 stringDataOffset = stringOffsetsOffset + mStrings.size() * sizeof(U32);
+    const U32 stringPadding = ( 4 - ( stringDataSize & 3 ) ) & 3;
+    const U32 fileSize = stringDataOffset + stringDataSize + stringPadding;
+
+    // Write header.
+    stream.write( sizeof(TamlMapped::Signature), TamlMapped::Signature );
+    stream.write( TamlMapped::Version );
+    stream.write( fileSize );
+    stream.write( rootElement );
+    stream.write( (U32)mStrings.size() );
+    stream.write( stringOffsetsOffset );
+    stream.write( stringDataOffset );
+    stream.write( stringDataSize );
+    stream.write( (U32)mElements.size() );
+    stream.write( elementsOffset );
+    stream.write( (U32)mAttributes.size() );
+    stream.write( attributesOffset );
+    stream.write( (U32)mCustomNodes.size() );
+    stream.write( customNodesOffset );
+    stream.write( (U32)mIndices.size() );
+    stream.write( indicesOffset );
+
+    // Write elements.
+    for ( Vector<TamlMapped::Element>::const_iterator itr = mElements.begin(); itr != mElements.end(); ++itr )
+    {
+        stream.write( itr->mTypeName );
+        stream.write( itr->mObjectName );
+        stream.write( itr->mRefId );
+        stream.write( itr->mRefToId );
+        stream.write( itr->mFirstAttribute );
+        stream.write( itr->mAttributeCount );
+        stream.write( itr->mFirstChild );
+        stream.write( itr->mChildCount );
+        stream.write( itr->mFirstCustomNode );
+        stream.write( itr->mCustomNodeCount );
+    }
+
+    // Write attributes.
+    for ( Vector<TamlMapped::Attribute>::const_iterator itr = mAttributes.begin(); itr != mAttributes.end(); ++itr )
+    {
+        stream.write( itr->mName );
+        stream.write( itr->mValue );
+    }
+
+    // Write custom nodes.
+    for ( Vector<TamlMapped::CustomNode>::const_iterator itr = mCustomNodes.begin(); itr != mCustomNodes.end(); ++itr )
+    {
+        stream.write( itr->mName );
+        stream.write( itr->mText );
+        stream.write( itr->mProxyElement );
+        stream.write( itr->mFirstChild );
+        stream.write( itr->mChildCount );
+        stream.write( itr->mFirstField );
+        stream.write( itr->mFieldCount );
+    }
+
+    // Write indices.
+    for ( Vector<U32>::const_iterator itr = mIndices.begin(); itr != mIndices.end(); ++itr )
+        stream.write( *itr );
+
+    // Write string offsets.
+    U32 stringOffset = 0;
+    for ( U32 index = 0; index < (U32)mStrings.size(); ++index )
+    {
+        stream.write( stringOffset );
+        stringOffset += dStrlen( mStrings[index] ) + 1;
+    }
+
+    // Write string data including terminators.
+    for ( U32 index = 0; index < (U32)mStrings.size(); ++index )
+        stream.write( dStrlen( mStrings[index] ) + 1, mStrings[index] );
+
+    // Pad to the file size.
+    for ( U32 index = 0; index < stringPadding; ++index )
+        stream.write( (U8)0 );
+
+    // Release the tables.
+    resetWrite();
+
+    return stream.getStatus() == Stream::Ok;
+}
+
+//-----------------------------------------------------------------------------
+
+void TamlMappedWriter::resetWrite( void )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedWriter_ResetWrite);
+
+    mStringIndices.clear();
+    mStrings.clear();
+    mElements.clear();
+    mAttributes.clear();
+    mCustomNodes.clear();
+    mIndices.clear();
+
+    // String zero is always the empty string.
+    addString( StringTable->EmptyString() );
+}
+
+//-----------------------------------------------------------------------------
+
+U32 TamlMappedWriter::addString( const char* pString )
+{
+    // Treat no string as the empty string.
+    if ( pString == NULL )
+        pString = StringTable->EmptyString();
+
+    // Have we already stored the string?
+    const String string( pString );
+    typeStringIndexHash::Iterator stringItr = mStringIndices.find( string );
+    if ( stringItr != mStringIndices.end() )
+        return stringItr->value;
+
+    // No, so add it.
+    const U32 stringIndex = mStrings.size();
+    mStrings.push_back( pString );
+    mStringIndices.insertUnique( string, stringIndex );
+
+    return stringIndex;
+}
+
+//-----------------------------------------------------------------------------
+
+U32 TamlMappedWriter::addElement( const TamlWriteNode* pTamlWriteNode )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlMappedWriter_AddElement);
+
+    // Reserve the element.  Children are added after it so fetch it by index.
+    const U32 elementIndex = mElements.size();
+    mElements.increment();
+
+    TamlMapped::Element element;
+    element.mTypeName = addString( pTamlWriteNode->mpSimObject->getClassName() );
+    element.mObjectName = addString( pTamlWriteNode->mpObjectName );
+    element.mRefId = pTamlWriteNode->mRefId;
+    element.mRefToId = 0;
+    element.mFirstAttribute = 0;
+    element.mAttributeCount = 0;
+    element.mFirstChild = 0;
+    element.mChildCount = 0;
+    element.mFirstCustomNode = 0;
+    element.mCustomNodeCount = 0;
+
+    // Do we have a reference to node?
+    if ( pTamlWriteNode->mRefToNode != NULL )
+    {
+        // Yes, so fetch reference to Id.
+        element.mRefToId = pTamlWriteNode->mRefToNode->mRefId;
+
+        // Sanity!
+        AssertFatal( element.mRefToId != 0, "Taml: Invalid reference to Id." );
+
+        mElements[elementIndex] = element;
+        return elementIndex;
+    }
+
+    // Add attributes.
+    const Vector<TamlWriteNode::FieldValuePair*>& fields = pTamlWriteNode->mFields;
+    element.mFirstAttribute = mAttributes.size();
+    element.mAttributeCount = fields.size();
+    for( Vector<TamlWriteNode::FieldValuePair*>::const_iterator itr = fields.begin(); itr != fields.end(); ++itr )
+    {
+        TamlMapped::Attribute attribute;
+        attribute.mName = addString( (*itr)->mName );
+        attribute.mValue = addString( (*itr)->mpValue );
+        mAttributes.push_back( attribute );
+    }
+
+    // Add children.
+    if ( pTamlWriteNode->mChildren != NULL )
+    {
+        Vector<U32> children;
+        for( Vector<TamlWriteNode*>::iterator itr = pTamlWriteNode->mChildren->begin(); itr != pTamlWriteNode->mChildren->end(); ++itr )
+            children.push_back( addElement( *itr ) );
+
+        element.mFirstChild = addIndices( children );
+        element.mChildCount = children.size();
+    }
+
+    // Add custom nodes.
+    const TamlCustomNodeVector& nodes = pTamlWriteNode->mCustomNodes.getNodes();
+    if ( nodes.size() > 0 )
+    {
+        Vector<U32> customNodes;
+        for( TamlCustomNodeVector::const_iterator itr = nodes.begin(); itr != nodes.end(); ++itr )
+            customNodes.push_back( addCustomNode( *itr ) );
+
+        element.mFirstCustomNode = addIndices( customNodes );
+        element.mCustomNodeCount = customNodes.size();
+    }
+
+    mElements[elementIndex] = element;
+    return elementIndex;
+}
+
+//-----------------------------------------------------------------------------
+
+U32 TamlMappedWriter::addCustomNode( const TamlCustomNode* pCustomNode )
+{
+    // Reserve the custom node.
+    const U32 nodeIndex = mCustomNodes.size();
+    mCustomNodes.increment();
+
+    TamlMapped::CustomNode node;
+    node.mName = 0;
+    node.mText = 0;
+    node.mProxyElement = TamlMapped::InvalidIndex;
+    node.mFirstChild = 0;
+    node.mChildCount = 0;
+    node.mFirstField = 0;
+    node.mFieldCount = 0;
+
+    // Is the node a proxy object?
+    if ( pCustomNode->isProxyObject() )
+    {
+        // Yes, so add the element.
+        node.mProxyElement = addElement( pCustomNode->getProxyWriteNode() );
+
+        mCustomNodes[nodeIndex] = node;
+        return nodeIndex;
+    }
+
+    node.mName = addString( pCustomNode->getNodeName() );
+    node.mText = addString( pCustomNode->getNodeTextField().getFieldValue() );
+
+    // Add children nodes.
+    const TamlCustomNodeVector& nodeChildren = pCustomNode->getChildren();
+    if ( nodeChildren.size() > 0 )
+    {
+        Vector<U32> children;
+        for( TamlCustomNodeVector::const_iterator itr = nodeChildren.begin(); itr != nodeChildren.end(); ++itr )
+            children.push_back( addCustomNode( *itr ) );
+
+        node.mFirstChild = addIndices( children );
+        node.mChildCount = children.size();
+    }
+
+    // Add fields.
+    const TamlCustomFieldVector& fields = pCustomNode->getFields();
+    node.mFirstField = mAttributes.size();
+    node.mFieldCount = fields.size();
+    for ( TamlCustomFieldVector::const_iterator itr = fields.begin(); itr != fields.end(); ++itr )
+    {
+        TamlMapped::Attribute field;
+        field.mName = addString( (*itr)->getFieldName() );
+        field.mValue = addString( (*itr)->getFieldValue() );
+        mAttributes.push_back( field );
+    }
+
+    mCustomNodes[nodeIndex] = node;
+    return nodeIndex;
+}
+
+//-----------------------------------------------------------------------------
+
+U32 TamlMappedWriter::addIndices( const Vector<U32>& indices )
+{
+    const U32 firstIndex = mIndices.size();
+    mIndices.merge( indices );
+    return firstIndex;
+}
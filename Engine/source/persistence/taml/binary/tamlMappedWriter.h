@@ -0,0 +1,77 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2013 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _TAML_MAPPEDWRITER_H_
+#define _TAML_MAPPEDWRITER_H_
+
+#ifndef _TAML_H_
+#include "persistence/taml/taml.h"
+#endif
+
+#ifndef _TAML_MAPPEDFORMAT_H_
+#include "persistence/taml/binary/tamlMappedFormat.h"
+#endif
+
+#ifndef _TDICTIONARY_H_
+#include "core/util/tDictionary.h"
+#endif
+
+//-----------------------------------------------------------------------------
+
+/// Writes the mapped binary format.  The whole document is flattened into
+/// tables first and then written in one pass.
+/// @ingroup tamlGroup
+/// @see tamlGroup
+class TamlMappedWriter
+{
+public:
+    TamlMappedWriter( Taml* pTaml ) :
+        mpTaml( pTaml )
+    {
+    }
+    virtual ~TamlMappedWriter() {}
+
+    /// Write.
+    bool write( FileStream& stream, const TamlWriteNode* pTamlWriteNode );
+
+private:
+    Taml* mpTaml;
+
+    typedef HashTable<String, U32> typeStringIndexHash;
+
+    typeStringIndexHash                 mStringIndices;
+    Vector<const char*>                 mStrings;
+    Vector<TamlMapped::Element>         mElements;
+    Vector<TamlMapped::Attribute>       mAttributes;
+    Vector<TamlMapped::CustomNode>      mCustomNodes;
+    Vector<U32>                         mIndices;
+
+private:
+    void resetWrite( void );
+
+    U32 addString( const char* pString );
+    U32 addElement( const TamlWriteNode* pTamlWriteNode );
+    U32 addCustomNode( const TamlCustomNode* pCustomNode );
+    U32 addIndices( const Vector<U32>& indices );
+};
+
+#endif // _TAML_MAPPEDWRITER_H_
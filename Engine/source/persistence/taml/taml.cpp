@@ -42,6 +42,18 @@
 #include "persistence/taml/binary/tamlBinaryReader.h"
 #endif
 
+#ifndef _TAML_MAPPEDWRITER_H_
+#include "persistence/taml/binary/tamlMappedWriter.h"
+#endif
+
+#ifndef _TAML_MAPPEDREADER_H_
+#include "persistence/taml/binary/tamlMappedReader.h"
+#endif
+
+#ifndef _TAML_MAPPEDPARSER_H_
+#include "persistence/taml/binary/tamlMappedParser.h"
+#endif
+
 /*#ifndef _TAML_JSONWRITER_H_
 #include "taml/json/tamlJSONWriter.h"
 #endif
@@ -96,7 +108,8 @@ typedef Taml::TamlFormatMode _TamlFormatMode;
 ImplementEnumType( _TamlFormatMode,
    "")
    { Taml::XmlFormat, "xml" },
-   { Taml::BinaryFormat, "binary" }//,
+   { Taml::BinaryFormat, "binary" },
+   { Taml::MappedBinaryFormat, "mappedBinary" }//,
    //{ Taml::JSONFormat, "json" }
 EndImplementEnumType;
 
@@ -146,7 +159,8 @@ Taml::Taml() :
     mAutoFormat(true),
     mAutoFormatXmlExtension("taml"),    
     mAutoFormatBinaryExtension("baml"),
-    mAutoFormatJSONExtension("json")
+    mAutoFormatJSONExtension("json"),
+    mAutoFormatMappedBinaryExtension("mbaml")
 {
     // Reset the file-path buffer.
     mFilePathBuffer[0] = 0;
@@ -168,6 +182,7 @@ void Taml::initPersistFields()
     addField("AutoFormatXmlExtension", TypeString, Offset(mAutoFormatXmlExtension, Taml), "When using auto-format, this is the extension (end of filename) used to detect the XML format.\n");
     addField("AutoFormatBinaryExtension", TypeString, Offset(mAutoFormatBinaryExtension, Taml), "When using auto-format, this is the extension (end of filename) used to detect the BINARY format.\n");
     addField("AutoFormatJSONExtension", TypeString, Offset(mAutoFormatJSONExtension, Taml), "When using auto-format, this is the extension (end of filename) used to detect the JSON format.\n");
+    addField("AutoFormatMappedBinaryExtension", TypeString, Offset(mAutoFormatMappedBinaryExtension, Taml), "When using auto-format, this is the extension (end of filename) used to detect the MAPPED BINARY format.\n");
 }
 
 //-----------------------------------------------------------------------------
@@ -253,27 +268,42 @@ SimObject* Taml::read( const char* pFilename )
     // Expand the file-name into the file-path buffer.
     Con::expandToolScriptFilename( mFilePathBuffer, sizeof(mFilePathBuffer), pFilename );
 
-    FileStream stream;
+    // Get the file auto-format mode.
+    const TamlFormatMode formatMode = getFileAutoFormatMode( mFilePathBuffer );
 
-    // File opened?
-    if ( !stream.open( mFilePathBuffer, Torque::FS::File::Read ) )
+    SimObject* pSimObject = NULL;
+
+    // Is the file in the mapped binary format?
+    if ( formatMode == MappedBinaryFormat )
     {
-        // No, so warn.
-        Con::warnf("Taml::read() - Could not open filename '%s' for read.", mFilePathBuffer );
-        return NULL;
+        // Yes, so reset the compilation.
+        resetCompilation();
+
+        // Read object from the file in place.
+        TamlMappedReader reader( this );
+        pSimObject = reader.read( mFilePathBuffer );
     }
+    else
+    {
+        FileStream stream;
 
-    // Get the file auto-format mode.
-    const TamlFormatMode formatMode = getFileAutoFormatMode( mFilePathBuffer );
+        // File opened?
+        if ( !stream.open( mFilePathBuffer, Torque::FS::File::Read ) )
+        {
+            // No, so warn.
+            Con::warnf("Taml::read() - Could not open filename '%s' for read.", mFilePathBuffer );
+            return NULL;
+        }
 
-    // Reset the compilation.
-    resetCompilation();
+        // Reset the compilation.
+        resetCompilation();
 
-    // Write object.
-    SimObject* pSimObject = read( stream, formatMode );
+        // Write object.
+        pSimObject = read( stream, formatMode );
 
-    // Close file.
-    stream.close();
+        // Close file.
+        stream.close();
+    }
 
     // Reset the compilation.
     resetCompilation();
@@ -324,6 +354,16 @@ bool Taml::write( FileStream& stream, SimObject* pSimObject, const TamlFormatMod
             return writer.write( stream, pRootNode, mBinaryCompression );
         }
 
+        /// Mapped Binary.
+        case MappedBinaryFormat:
+        {
+            // Create writer.
+            TamlMappedWriter writer( this );
+
+            // Write.
+            return writer.write( stream, pRootNode );
+        }
+
         /// JSON.
         case JSONFormat:
         {
@@ -376,6 +416,14 @@ SimObject* Taml::read( FileStream& stream, const TamlFormatMode formatMode )
             return reader.read( stream );
         }
 
+        /// Mapped Binary.
+        case MappedBinaryFormat:
+        {
+            // Warn.
+            Con::warnf("Taml::read() - Cannot read the mapped binary format from a stream, read it by filename instead.");
+            return NULL;
+        }
+
         /// JSON.
         case JSONFormat:
         {
@@ -403,7 +451,7 @@ SimObject* Taml::read( FileStream& stream, const TamlFormatMode formatMode )
 
 //-----------------------------------------------------------------------------
 
-bool Taml::parse( const char* pFilename, TamlVisitor& visitor )
+bool Taml::parse( const char* pFilename, TamlVisitor& visitor, U32* pContentHash )
 {
     // Debug Profiling.
     PROFILE_SCOPE(Taml_Parse);
@@ -430,7 +478,15 @@ bool Taml::parse( const char* pFilename, TamlVisitor& visitor )
                 return false;
             }
 
-            return parser.accept( pFilename, visitor );            
+            // Parse, hashing the contents if requested.
+            parser.setHashContents( pContentHash != NULL );
+            if ( !parser.accept( pFilename, visitor ) )
+                return false;
+
+            if ( pContentHash != NULL )
+                *pContentHash = parser.getContentHash();
+
+            return true;
         }
 
         case JSONFormat:
@@ -450,6 +506,30 @@ bool Taml::parse( const char* pFilename, TamlVisitor& visitor )
            return false;
         }
 
+        case MappedBinaryFormat:
+        {
+            // Parse with the visitor.
+            TamlMappedParser parser;
+
+            // Are property changes needed but not supported?
+            if ( visitor.wantsPropertyChanges() && !parser.canChangeProperty() )
+            {
+                // Yes, so warn.
+                Con::warnf( "Taml::parse() - Cannot parse '%s' file-type for filename '%s' as a specified visitor requires property changes which are not supported by the parser.", getFormatModeDescription(formatMode), pFilename );
+                return false;
+            }
+
+            // Parse, hashing the contents if requested.
+            parser.setHashContents( pContentHash != NULL );
+            if ( !parser.accept( pFilename, visitor ) )
+                return false;
+
+            if ( pContentHash != NULL )
+                *pContentHash = parser.getContentHash();
+
+            return true;
+        }
+
         case BinaryFormat:
         default:
             break;
@@ -502,6 +582,7 @@ Taml::TamlFormatMode Taml::getFileAutoFormatMode( const char* pFilename )
         const U32 xmlExtensionLength = dStrlen( mAutoFormatXmlExtension );
         const U32 binaryExtensionLength = dStrlen( mAutoFormatBinaryExtension );
         const U32 jsonExtensionLength = dStrlen( mAutoFormatJSONExtension );
+        const U32 mappedBinaryExtensionLength = dStrlen( mAutoFormatMappedBinaryExtension );
 
         // Fetch filename length.
         const U32 filenameLength = dStrlen( pFilename );
@@ -513,6 +594,11 @@ Taml::TamlFormatMode Taml::getFileAutoFormatMode( const char* pFilename )
         if ( xmlExtensionLength <= filenameLength && dStricmp( pEndOfFilename - xmlExtensionLength, mAutoFormatXmlExtension ) == 0 )
             return Taml::XmlFormat;
 
+        // Check for the Mapped Binary format.  This is checked before the Binary
+        // format as the default extensions share the same ending.
+        if ( mappedBinaryExtensionLength <= filenameLength && dStricmp( pEndOfFilename - mappedBinaryExtensionLength, mAutoFormatMappedBinaryExtension ) == 0 )
+            return Taml::MappedBinaryFormat;
+
         // Check for the Binary format.
         if ( binaryExtensionLength <= filenameLength && dStricmp( pEndOfFilename - xmlExtensionLength, mAutoFormatBinaryExtension ) == 0 )
             return Taml::BinaryFormat;  
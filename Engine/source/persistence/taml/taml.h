@@ -82,6 +82,7 @@ public:
         XmlFormat,
         BinaryFormat,
         JSONFormat,
+        MappedBinaryFormat,
     };
 
 private:
@@ -96,6 +97,7 @@ private:
     StringTableEntry    mAutoFormatXmlExtension;
     StringTableEntry    mAutoFormatBinaryExtension;
     StringTableEntry    mAutoFormatJSONExtension;
+    StringTableEntry    mAutoFormatMappedBinaryExtension;
     bool                mJSONStrict;
     bool                mBinaryCompression;
     bool                mAutoFormat;
@@ -156,6 +158,8 @@ public:
     inline StringTableEntry getAutoFormatXmlExtension( void ) const { return mAutoFormatXmlExtension; }
     inline void setAutoFormatBinaryExtension( const char* pExtension ) { mAutoFormatBinaryExtension = StringTable->insert( pExtension ); }
     inline StringTableEntry getAutoFormatBinaryExtension( void ) const { return mAutoFormatBinaryExtension; }
+    inline void setAutoFormatMappedBinaryExtension( const char* pExtension ) { mAutoFormatMappedBinaryExtension = StringTable->insert( pExtension ); }
+    inline StringTableEntry getAutoFormatMappedBinaryExtension( void ) const { return mAutoFormatMappedBinaryExtension; }
 
     /// Compression.
     inline void setBinaryCompression( const bool compressed ) { mBinaryCompression = compressed; }
@@ -186,8 +190,9 @@ public:
     }
     SimObject* read( const char* pFilename );
 
-    /// Parse.
-    bool parse( const char* pFilename, TamlVisitor& visitor );
+    /// Parse.  If pContentHash is set, it receives a hash of the file contents
+    /// read by the parser.
+    bool parse( const char* pFilename, TamlVisitor& visitor, U32* pContentHash = NULL );
 
     /// Create type.
     static SimObject* createType( StringTableEntry typeName, const Taml* pTaml, const char* pProgenitorSuffix = NULL );
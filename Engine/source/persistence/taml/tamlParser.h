@@ -37,7 +37,9 @@ class TamlParser
 {
 public:
     TamlParser() :
-        mParsingFilename(StringTable->EmptyString())
+        mParsingFilename(StringTable->EmptyString()),
+        mHashContents(false),
+        mContentHash(0)
     {}
     virtual ~TamlParser() {}
 
@@ -51,8 +53,19 @@ public:
     inline void setParsingFilename( const char* pFilename ) { mParsingFilename = StringTable->insert(pFilename); }
     inline StringTableEntry getParsingFilename( void ) const { return mParsingFilename; }
 
+    /// Content hashing.  If set, accept() hashes the file bytes it reads so
+    /// callers don't have to read the file again.
+    inline void setHashContents( const bool hashContents ) { mHashContents = hashContents; }
+    inline bool getHashContents( void ) const { return mHashContents; }
+    inline U32 getContentHash( void ) const { return mContentHash; }
+
+protected:
+    inline void setContentHash( const U32 contentHash ) { mContentHash = contentHash; }
+
 private:
     StringTableEntry mParsingFilename;
+    bool mHashContents;
+    U32 mContentHash;
 };
 
 #endif // _TAML_PARSER_H_
\ No newline at end of file
@@ -142,6 +142,23 @@ DefineEngineMethod(Taml, getAutoFormatBinaryExtension, const char*, (), ,    "()
 
 //-----------------------------------------------------------------------------
 
+DefineEngineMethod(Taml, setAutoFormatMappedBinaryExtension, void, (const char* extension), ,   "(extension) Sets the extension (end of filename) used to detect the Mapped Binary format.\n"
+                                                                "@param extension The extension (end of filename) used to detect the Mapped Binary format.\n"
+                                                                "@return No return value." )
+{
+    object->setAutoFormatMappedBinaryExtension( extension );
+}
+
+//-----------------------------------------------------------------------------
+
+DefineEngineMethod(Taml, getAutoFormatMappedBinaryExtension, const char*, (), ,    "() Gets the extension (end of filename) used to detect the Mapped Binary format.\n"
+                                                                        "@return The extension (end of filename) used to detect the Mapped Binary format." )
+{
+    return object->getAutoFormatMappedBinaryExtension();
+}
+
+//-----------------------------------------------------------------------------
+
 DefineEngineMethod(Taml, setBinaryCompression, void, (bool compressed), ,   "(compressed) - Sets whether ZIP compression is used on binary formatting or not.\n"
                                                         "@param compressed Whether compression is on or off.\n"
                                                         "@return No return value.")
@@ -230,7 +247,7 @@ DefineEngineFunction(TamlWrite, bool, (SimObject* simObject, const char* filenam
                                         "(object, filename, [format], [compressed]) - Writes an object to a file using Taml.\n"
                                         "@param object The object to write.\n"
                                         "@param filename The filename to write to.\n"
-                                        "@param format The file format to use.  Optional: Defaults to 'xml'.  Can be set to 'binary'.\n"
+                                        "@param format The file format to use.  Optional: Defaults to 'xml'.  Can be set to 'binary' or 'mappedBinary'.\n"
                                         "@param compressed Whether ZIP compression is used on binary formatting or not.  Optional: Defaults to 'true'.\n"
                                         "@return Whether the write was successful or not.")
 {
@@ -271,7 +288,7 @@ DefineEngineFunction(TamlWrite, bool, (SimObject* simObject, const char* filenam
 
 DefineEngineFunction(TamlRead, const char*, (const char* filename, const char* format), ("xml"),    "(filename, [format]) - Read an object from a file using Taml.\n"
                                                 "@param filename The filename to read from.\n"
-                                                "@param format The file format to use.  Optional: Defaults to 'xml'.  Can be set to 'binary'.\n"
+                                                "@param format The file format to use.  Optional: Defaults to 'xml'.  Can be set to 'binary' or 'mappedBinary'.\n"
                                                 "@return (Object) The object read from the file or an empty string if read failed.")
 {
 
@@ -300,6 +317,40 @@ DefineEngineFunction(TamlRead, const char*, (const char* filename, const char* f
 
 //-----------------------------------------------------------------------------
 
+DefineEngineFunction(TamlConvertToMapped, bool, (const char* sourceFilename, const char* destinationFilename), ,
+                                        "(sourceFilename, destinationFilename) - Converts a Taml file to the mapped binary format.\n"
+                                        "The source format is detected from its extension.  The objects in the source file are "
+                                        "created temporarily to perform the conversion so any named objects must not already exist.\n"
+                                        "@param sourceFilename The Taml file to convert.\n"
+                                        "@param destinationFilename The mapped binary file to write.\n"
+                                        "@return Whether the conversion was successful or not.")
+{
+    Taml taml;
+
+    // Read the source object.
+    SimObject* pSimObject = taml.read( sourceFilename );
+
+    // Did we read the object?
+    if ( pSimObject == NULL )
+    {
+        // No, so warn.
+        Con::warnf( "TamlConvertToMapped() - Could not read object from file '%s'.", sourceFilename );
+        return false;
+    }
+
+    // Write the object as mapped binary.
+    taml.setFormatMode( Taml::MappedBinaryFormat );
+    taml.setAutoFormat( false );
+    const bool status = taml.write( pSimObject, destinationFilename );
+
+    // Remove the temporary object.
+    pSimObject->deleteObject();
+
+    return status;
+}
+
+//-----------------------------------------------------------------------------
+
 DefineEngineFunction(GenerateTamlSchema, bool, (), , "() - Generate a TAML schema file of all engine types.\n"
                                                 "The schema file is specified using the console variable '" TAML_SCHEMA_VARIABLE "'.\n"
                                                 "@return Whether the schema file was writtent or not." )
@@ -0,0 +1,354 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "persistence/taml/taml.h"
+#include "persistence/taml/tamlVisitor.h"
+#include "persistence/taml/binary/tamlMappedDocument.h"
+#include "core/stream/fileStream.h"
+#include "console/simSet.h"
+#include "console/console.h"
+
+FIXTURE(TamlMapped)
+{
+public:
+   // Counts the properties a parser visits.
+   class CountVisitor : public TamlVisitor
+   {
+   public:
+      U32 mCount;
+
+      CountVisitor() : mCount(0) {}
+
+      virtual bool wantsPropertyChanges() { return false; }
+      virtual bool wantsRootOnly() { return false; }
+      virtual bool visit(const TamlParser& parser, TamlVisitor::PropertyState& propertyState)
+      {
+         mCount++;
+         return true;
+      }
+   };
+
+   // Files written by the test, deleted even if it fails part way.
+   Vector<String> mFiles;
+
+   virtual void TearDown()
+   {
+      for (U32 i = 0; i < mFiles.size(); i++)
+         dFileDelete(mFiles[i]);
+      mFiles.clear();
+
+      Platform::deleteDirectory("tamlMappedTest");
+   }
+
+   const char* tempFile(const char* filename)
+   {
+      mFiles.push_back(filename);
+      return mFiles.last();
+   }
+
+   // Builds an object with the fields of a typical asset declaration.
+   static SimObject* createAsset(U32 index)
+   {
+      SimObject* object = new SimObject();
+      object->registerObject();
+
+      char buffer[256];
+      dSprintf(buffer, sizeof(buffer), "Asset%u", index);
+      object->setDataField(StringTable->insert("AssetName"), NULL, buffer);
+      dSprintf(buffer, sizeof(buffer), "Textures/asset%u.png", index);
+      object->setDataField(StringTable->insert("ImageFile"), NULL, buffer);
+      object->setDataField(StringTable->insert("AssetCategory"), NULL, (index & 1) ? "Images" : "Shapes");
+      dSprintf(buffer, sizeof(buffer), "%u %u", index % 64, index % 32);
+      object->setDataField(StringTable->insert("CellCount"), NULL, buffer);
+
+      return object;
+   }
+
+   static SimGroup* createDocument(U32 count)
+   {
+      SimGroup* group = new SimGroup();
+      group->registerObject();
+
+      for (U32 i = 0; i < count; i++)
+         group->addObject(createAsset(i));
+
+      return group;
+   }
+
+   static U32 countProperties(Taml& taml, const char* filename)
+   {
+      CountVisitor visitor;
+      taml.parse(filename, visitor);
+      return visitor.mCount;
+   }
+
+   static U32 store(U32 value) { return convertHostToLEndian(value); }
+
+   // Builds mapped documents by hand, for files the writer never produces.
+   // The strings are "", "SimObject" and "Node"; the root element has the
+   // first custom node.
+   class DocumentBuilder
+   {
+   public:
+      Vector<TamlMapped::Element> mElements;
+      Vector<TamlMapped::CustomNode> mCustomNodes;
+      Vector<U32> mIndices;
+
+      DocumentBuilder()
+      {
+         addElement(0, 1);
+         addIndex(0);
+      }
+
+      U32 addElement(U32 firstCustomNode, U32 customNodeCount)
+      {
+         TamlMapped::Element element;
+         dMemset(&element, 0, sizeof(element));
+         element.mTypeName = store(1);
+         element.mFirstCustomNode = store(firstCustomNode);
+         element.mCustomNodeCount = store(customNodeCount);
+         mElements.push_back(element);
+         return mElements.size() - 1;
+      }
+
+      U32 addCustomNode(U32 name, U32 firstChild, U32 childCount, U32 proxyElement = TamlMapped::InvalidIndex)
+      {
+         TamlMapped::CustomNode node;
+         dMemset(&node, 0, sizeof(node));
+         node.mName = store(name);
+         node.mProxyElement = store(proxyElement);
+         node.mFirstChild = store(firstChild);
+         node.mChildCount = store(childCount);
+         mCustomNodes.push_back(node);
+         return mCustomNodes.size() - 1;
+      }
+
+      U32 addIndex(U32 value)
+      {
+         mIndices.push_back(store(value));
+         return mIndices.size() - 1;
+      }
+
+      bool write(const char* filename)
+      {
+         static const char stringData[16] = "\0SimObject\0Node";
+         const U32 stringOffsets[] = { store(0), store(1), store(11) };
+
+         const U32 elementsSize = mElements.size() * sizeof(TamlMapped::Element);
+         const U32 customNodesSize = mCustomNodes.size() * sizeof(TamlMapped::CustomNode);
+         const U32 indicesSize = mIndices.size() * sizeof(U32);
+
+         TamlMapped::Header header;
+         dMemcpy(header.mSignature, TamlMapped::Signature, sizeof(header.mSignature));
+         header.mVersion = store(TamlMapped::Version);
+         header.mRootElement = store(0);
+         header.mElementCount = store(mElements.size());
+         header.mElementsOffset = store(sizeof(header));
+         header.mAttributeCount = store(0);
+         header.mAttributesOffset = store(sizeof(header));
+         header.mCustomNodeCount = store(mCustomNodes.size());
+         header.mCustomNodesOffset = store(sizeof(header) + elementsSize);
+         header.mIndexCount = store(mIndices.size());
+         header.mIndicesOffset = store(sizeof(header) + elementsSize + customNodesSize);
+         header.mStringCount = store(3);
+         header.mStringOffsetsOffset = store(sizeof(header) + elementsSize + customNodesSize + indicesSize);
+         header.mStringDataOffset = store(sizeof(header) + elementsSize + customNodesSize + indicesSize + sizeof(stringOffsets));
+         header.mStringDataSize = store(sizeof(stringData));
+         header.mFileSize = store(sizeof(header) + elementsSize + customNodesSize + indicesSize + sizeof(stringOffsets) + sizeof(stringData));
+
+         FileStream stream;
+         if (!stream.open(filename, Torque::FS::File::Write))
+            return false;
+
+         return stream.write(sizeof(header), &header) &&
+            stream.write(elementsSize, mElements.address()) &&
+            stream.write(customNodesSize, mCustomNodes.address()) &&
+            stream.write(indicesSize, mIndices.address()) &&
+            stream.write(sizeof(stringOffsets), stringOffsets) &&
+            stream.write(sizeof(stringData), stringData);
+      }
+   };
+
+   bool openDocument(DocumentBuilder& builder)
+   {
+      const char* filename = tempFile("tamlMappedCrafted.mbaml");
+      if (!builder.write(filename))
+         return false;
+
+      TamlMappedDocument document;
+      return document.open(filename);
+   }
+};
+
+TEST_FIX(TamlMapped, RoundTrip)
+{
+   SimGroup* source = createDocument(16);
+
+   Taml taml;
+   const char* filename = tempFile("tamlMappedTest.mbaml");
+   EXPECT_TRUE(taml.write(source, filename))
+      << "Should write the mapped binary format";
+
+   SimGroup* result = dynamic_cast<SimGroup*>(taml.read(filename));
+   if (result == NULL)
+      source->deleteObject();
+   ASSERT_TRUE(result != NULL)
+      << "Should read the mapped binary format back";
+   EXPECT_EQ(source->size(), result->size());
+
+   for (U32 i = 0; i < source->size() && i < result->size(); i++)
+   {
+      EXPECT_STREQ(source->at(i)->getDataField(StringTable->insert("ImageFile"), NULL),
+         result->at(i)->getDataField(StringTable->insert("ImageFile"), NULL))
+         << "Field values should survive the round trip";
+   }
+
+   result->deleteObject();
+   source->deleteObject();
+}
+
+TEST_FIX(TamlMapped, ParseAndReadTime)
+{
+   // One declaration per file, like the assets of a module.
+   const U32 numAssets = 2000;
+
+   Platform::createPath("tamlMappedTest/");
+
+   Taml taml;
+   char buffer[256];
+   for (U32 i = 0; i < numAssets; i++)
+   {
+      SimObject* source = createAsset(i);
+
+      dSprintf(buffer, sizeof(buffer), "tamlMappedTest/asset%u.asset.taml", i);
+      taml.write(source, tempFile(buffer));
+      dSprintf(buffer, sizeof(buffer), "tamlMappedTest/asset%u.asset.mbaml", i);
+      taml.write(source, tempFile(buffer));
+
+      source->deleteObject();
+   }
+
+   // Files alternate between the two formats.
+   const U32 numFiles = mFiles.size();
+
+   // Parse every file as the asset manager does when scanning declared assets.
+   U32 start = Platform::getRealMilliseconds();
+   U32 xmlCount = 0;
+   for (U32 i = 0; i < numFiles; i += 2)
+      xmlCount += countProperties(taml, mFiles[i]);
+   const U32 xmlParseMS = Platform::getRealMilliseconds() - start;
+
+   start = Platform::getRealMilliseconds();
+   U32 mappedCount = 0;
+   for (U32 i = 1; i < numFiles; i += 2)
+      mappedCount += countProperties(taml, mFiles[i]);
+   const U32 mappedParseMS = Platform::getRealMilliseconds() - start;
+
+   EXPECT_EQ(xmlCount, mappedCount)
+      << "Both formats should visit the same properties";
+
+   // Read the objects.
+   U32 xmlReadCount = 0;
+   start = Platform::getRealMilliseconds();
+   for (U32 i = 0; i < numFiles; i += 2)
+   {
+      SimObject* result = taml.read(mFiles[i]);
+      if (result != NULL)
+      {
+         xmlReadCount++;
+         result->deleteObject();
+      }
+   }
+   const U32 xmlReadMS = Platform::getRealMilliseconds() - start;
+
+   U32 mappedReadCount = 0;
+   start = Platform::getRealMilliseconds();
+   for (U32 i = 1; i < numFiles; i += 2)
+   {
+      SimObject* result = taml.read(mFiles[i]);
+      if (result != NULL)
+      {
+         mappedReadCount++;
+         result->deleteObject();
+      }
+   }
+   const U32 mappedReadMS = Platform::getRealMilliseconds() - start;
+
+   EXPECT_EQ(numAssets, xmlReadCount);
+   EXPECT_EQ(numAssets, mappedReadCount);
+
+   Con::printf("TamlMapped: %u asset files, parse xml %ums mapped %ums, read xml %ums mapped %ums",
+      numAssets, xmlParseMS, mappedParseMS, xmlReadMS, mappedReadMS);
+}
+
+TEST_FIX(TamlMapped, CustomNodeProxies)
+{
+   // A named node holding a proxy object is what the writer produces.
+   DocumentBuilder valid;
+   const U32 proxyElement = valid.addElement(0, 0);
+   valid.addCustomNode(2, valid.addIndex(1), 1);
+   valid.addCustomNode(0, 0, 0, proxyElement);
+   EXPECT_TRUE(openDocument(valid));
+
+   // Top-level nodes are read by name and cannot be proxies.
+   DocumentBuilder topLevel;
+   topLevel.addCustomNode(2, 0, 0, topLevel.addElement(0, 0));
+   EXPECT_FALSE(openDocument(topLevel));
+
+   // The name and ranges of a proxy node are checked as well.
+   DocumentBuilder badName;
+   const U32 badNameElement = badName.addElement(0, 0);
+   badName.addCustomNode(2, badName.addIndex(1), 1);
+   badName.addCustomNode(999, 0, 0, badNameElement);
+   EXPECT_FALSE(openDocument(badName));
+
+   DocumentBuilder badChildren;
+   const U32 badChildrenElement = badChildren.addElement(0, 0);
+   badChildren.addCustomNode(2, badChildren.addIndex(1), 1);
+   badChildren.addCustomNode(0, 0, 1000, badChildrenElement);
+   EXPECT_FALSE(openDocument(badChildren));
+}
+
+TEST_FIX(TamlMapped, NestingDepthLimit)
+{
+   // A chain of custom nodes, each the only child of the one before.
+   // Custom node n is nested n + 1 deep below the root element.
+   for (U32 depth = TamlMapped::MaxDepth; depth <= TamlMapped::MaxDepth + 1; depth++)
+   {
+      DocumentBuilder builder;
+      for (U32 node = 0; node < depth; node++)
+      {
+         if (node + 1 < depth)
+            builder.addCustomNode(2, builder.addIndex(node + 1), 1);
+         else
+            builder.addCustomNode(2, 0, 0);
+      }
+
+      EXPECT_EQ(depth <= TamlMapped::MaxDepth, openDocument(builder))
+         << "Nesting depth " << depth;
+   }
+}
+
+#endif
@@ -31,6 +31,14 @@
 #include "core/stream/fileStream.h"
 #endif
 
+#ifndef _VOLUME_H_
+#include "core/volume.h"
+#endif
+
+#ifndef _HASHFUNCTION_H_
+#include "core/util/hashFunction.h"
+#endif
+
 //-----------------------------------------------------------------------------
 
 bool TamlXmlParser::accept( const char* pFilename, TamlVisitor& visitor )
@@ -69,8 +77,19 @@ bool TamlXmlParser::accept( const char* pFilename, TamlVisitor& visitor )
 
     TiXmlDocument xmlDocument;
 
-    // Load document from stream.
-    if ( !xmlDocument.LoadFile( filenameBuffer ) )
+    // Are the contents to be hashed?
+    if ( getHashContents() )
+    {
+        // Yes, so read the file ourselves to hash the bytes parsed.
+        if ( !loadAndHash( filenameBuffer, xmlDocument ) )
+        {
+            // Warn!
+            Con::warnf("TamlXmlParser: Could not load Taml XML file '%s'.", filenameBuffer );
+            return false;
+        }
+    }
+    // No, so load document from file.
+    else if ( !xmlDocument.LoadFile( filenameBuffer ) )
     {
         // Warn!
         Con::warnf("TamlXmlParser: Could not load Taml XML file from stream.");
@@ -120,6 +139,52 @@ bool TamlXmlParser::accept( const char* pFilename, TamlVisitor& visitor )
 
 //-----------------------------------------------------------------------------
 
+bool TamlXmlParser::loadAndHash( const char* pFilename, TiXmlDocument& xmlDocument )
+{
+    // Debug Profiling.
+    PROFILE_SCOPE(TamlXmlParser_LoadAndHash);
+
+    void* pData = NULL;
+    U32 dataSize = 0;
+
+    // Read the file.
+    if ( !Torque::FS::ReadFile( pFilename, pData, dataSize, true ) || pData == NULL )
+        return false;
+
+    char* pBuffer = (char*)pData;
+
+    // Hash the contents as they are stored.
+    setContentHash( Torque::hash( (const U8*)pBuffer, dataSize, 0 ) );
+
+    // Normalize new lines in place as TiXmlDocument::LoadFile() does.
+    const char* p = pBuffer;
+    char* q = pBuffer;
+    while ( *p )
+    {
+        if ( *p == '\r' )
+        {
+            *q++ = '\n';
+            p++;
+            if ( *p == '\n' )
+                p++;
+        }
+        else
+        {
+            *q++ = *p++;
+        }
+    }
+    *q = 0;
+
+    // Parse the document.
+    xmlDocument.Parse( pBuffer );
+
+    delete [] pBuffer;
+
+    return !xmlDocument.Error();
+}
+
+//-----------------------------------------------------------------------------
+
 inline bool TamlXmlParser::parseElement( TiXmlElement* pXmlElement, TamlVisitor& visitor )
 {
     // Debug Profiling.
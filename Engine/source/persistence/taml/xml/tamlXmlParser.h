@@ -48,6 +48,7 @@ public:
     virtual bool accept( const char* pFilename, TamlVisitor& visitor );
 
 private:
+    bool loadAndHash( const char* pFilename, TiXmlDocument& xmlDocument );
     inline bool parseElement( TiXmlElement* pXmlElement, TamlVisitor& visitor );
     inline bool parseAttributes( TiXmlElement* pXmlElement, TamlVisitor& visitor );
 
@@ -197,6 +197,10 @@ namespace Platform
    /// @see PlatformTimer
    U32 getRealMilliseconds();
 
+   /// Returns a monotonic time in microseconds with the best resolution the
+   /// platform offers.  Only differences between two values are meaningful.
+   U64 getRealMicroseconds();
+
    void advanceTime(U32 delta);
    S32 getBackgroundSleepTime();
 
@@ -0,0 +1,64 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _PLATFORMMAPPEDFILE_H_
+#define _PLATFORMMAPPEDFILE_H_
+
+#ifndef _TORQUE_TYPES_H_
+#include "platform/types.h"
+#endif
+
+/// Platform independent read-only memory mapping of a file.
+///
+/// The file contents can be used in place for as long as the mapping is
+/// open; pages are loaded by the OS on first access.
+class PlatformMappedFile
+{
+public:
+   PlatformMappedFile();
+   ~PlatformMappedFile();
+
+   /// Map the file at the native OS path.
+   /// @return False if the file doesn't exist, is empty or can't be mapped.
+   bool open( const char *path );
+
+   /// Unmap the file.  Pointers into the data are invalid afterwards.
+   void close();
+
+   bool isOpen() const { return mData != NULL; }
+
+   /// Returns the first byte of the file.
+   const U8 *getData() const { return mData; }
+
+   /// Returns the size of the file in bytes.
+   U32 getSize() const { return mSize; }
+
+private:
+   const U8 *mData;
+   U32 mSize;
+
+   /// Platform handles kept for the lifetime of the mapping.
+   void *mFileHandle;
+   void *mMappingHandle;
+};
+
+#endif
@@ -25,6 +25,9 @@
 #include "core/strings/stringFunctions.h"
 #include "core/util/hashFunction.h"
 #include "console/consoleTypes.h"
+#include "platform/threads/thread.h"
+#include "platform/platformIntrinsics.h"
+#include "platform/platformNetIORing.h"
 
 // jamesu - debug DNS
 //#define TORQUE_DEBUG_LOOKUPS
@@ -79,6 +82,10 @@ typedef int SOCKET;
 #include <errno.h>
 #include <sys/ioctl.h>
 #include <net/if.h>
+#include <sys/eventfd.h>
+
+// Batch UDP traffic through recvmmsg/sendmmsg on a network thread.
+#define TORQUE_NET_BATCHED_IO
 
 typedef sockaddr_in SOCKADDR_IN;
 typedef sockaddr_in6 SOCKADDR_IN6;
@@ -520,6 +527,9 @@ PacketReceiveEvent& Net::getPacketReceiveEvent()
 // Multicast stuff
 bool Net::smMulticastEnabled = true;
 //
+// Batched UDP I/O
+bool Net::smBatchedIO = false;
+//
 // Protocol Stuff
 bool Net::smIpv4Enabled = true;
 bool Net::smIpv6Enabled = false;
@@ -591,6 +601,439 @@ bool netSocketWaitForWritable(NetSocket handleFd, S32 timeoutMs)
    return false;
 }
 
+#ifdef TORQUE_NET_BATCHED_IO
+
+/// A datagram buffer of the batched UDP path.
+///
+/// Received packets are handed to the packet receive event straight out of
+/// these buffers.
+struct NetIOPacket
+{
+   /// Source of a received packet.
+   NetAddress address;
+
+   /// Socket a queued packet is sent on.
+   SOCKET socketFd;
+
+   /// Destination of a queued packet.
+   sockaddr_storage sockAddr;
+   socklen_t sockAddrLen;
+
+   U32 size;
+   U8 data[ Net::MaxPacketDataSize ];
+};
+
+/// Thread that receives and sends the datagrams of the UDP sockets in
+/// batches.
+///
+/// Received packets are queued up for the main thread, which triggers the
+/// packet receive event for them in Net::process().  Packets sent from the
+/// main thread are queued up and written out with one sendmmsg() per batch.
+/// Every queue is a NetIORing, and the buffers travel back to their producer
+/// through a second ring, so no locks are taken on either side.
+class NetIOThread : public Thread
+{
+public:
+   typedef Thread Parent;
+
+   enum
+   {
+      /// Number of receive and of send buffers.
+      NumPackets = NetIORing< NetIOPacket >::Size,
+
+      /// Max number of datagrams per system call.
+      BatchSize = 32,
+   };
+
+protected:
+   SOCKET mSocketFds[ 2 ];
+   U32 mNumSockets;
+
+   /// eventfd used to wake the thread up for queued sends.
+   S32 mWakeFd;
+
+   /// Set while a wake up is pending so bursts of sends only write the
+   /// eventfd once.
+   volatile U32 mWakePending;
+
+   NetIOPacket* mPackets;
+
+   NetIORing< NetIOPacket > mRecvFree;    ///< main thread -> network thread
+   NetIORing< NetIOPacket > mRecvReady;   ///< network thread -> main thread
+   NetIORing< NetIOPacket > mSendFree;    ///< network thread -> main thread
+   NetIORing< NetIOPacket > mSendReady;   ///< main thread -> network thread
+
+   /// Number of packets queued for sending.  Only used by the main thread.
+   U32 mNumSendsQueued;
+
+   /// Number of queued packets the network thread is done with.
+   volatile U32 mNumSendsDone;
+
+   /// Receive buffers taken from mRecvFree but not filled by the last
+   /// recvmmsg().  Only used by the network thread.
+   NetIOPacket* mRecvSpare[ BatchSize ];
+   U32 mNumRecvSpare;
+
+   void _wake()
+   {
+      if ( dCompareAndSwap( mWakePending, 0, 1 ) )
+      {
+         U64 value = 1;
+         if ( ::write( mWakeFd, &value, sizeof( value ) ) < 0 )
+            dCompareAndSwap( mWakePending, 1, 0 );
+      }
+   }
+
+   /// Pull a batch of datagrams from the given socket.
+   void _receive( SOCKET socketFd );
+
+   /// Send all queued packets.
+   void _flushSends();
+
+public:
+
+   NetIOThread( SOCKET udpFd, SOCKET udp6Fd );
+   virtual ~NetIOThread();
+
+   /// Return true if the thread could be set up.
+   bool isValid() const { return mWakeFd >= 0 && mNumSockets > 0; }
+
+   /// Stop the thread and wait for it to exit.
+   void shutdown()
+   {
+      stop();
+      _wake();
+      join();
+   }
+
+   /// Trigger the packet receive event for all received packets.  Must be
+   /// called on the main thread.
+   void processReceived();
+
+   /// Queue a packet for sending.  Must be called on the main thread.
+   ///
+   /// If all send buffers are in use, this waits for the network thread to
+   /// free one.  Returns false if the packet cannot be queued at all; the
+   /// packets queued before it have been sent by then, so the caller can
+   /// send it directly without reordering the packets of the socket.
+   bool send( SOCKET socketFd, const sockaddr* sockAddr, socklen_t sockAddrLen, const U8* buffer, S32 bufferSize );
+
+   /// Wait until all queued packets have been sent.  Must be called on the
+   /// main thread.
+   void flushSends();
+
+   virtual void run( void* arg = 0 );
+};
+
+static NetIOThread* gNetIOThread = NULL;
+
+NetIOThread::NetIOThread( SOCKET udpFd, SOCKET udp6Fd )
+   : mNumSockets( 0 ),
+     mWakePending( 0 ),
+     mNumSendsQueued( 0 ),
+     mNumSendsDone( 0 ),
+     mNumRecvSpare( 0 )
+{
+   if ( udpFd != InvalidSocketHandle )
+      mSocketFds[ mNumSockets++ ] = udpFd;
+   if ( udp6Fd != InvalidSocketHandle )
+      mSocketFds[ mNumSockets++ ] = udp6Fd;
+
+   mWakeFd = eventfd( 0, EFD_NONBLOCK );
+
+   mPackets = new NetIOPacket[ NumPackets * 2 ];
+   for ( U32 i = 0; i < NumPackets; i++ )
+   {
+      mRecvFree.push( &mPackets[ i ] );
+      mSendFree.push( &mPackets[ NumPackets + i ] );
+   }
+}
+
+NetIOThread::~NetIOThread()
+{
+   if ( mWakeFd >= 0 )
+      ::close( mWakeFd );
+
+   delete [] mPackets;
+}
+
+void NetIOThread::run( void* arg )
+{
+   _setName( "NetIOThread" );
+
+   pollfd fds[ 3 ];
+   fds[ 0 ].fd = mWakeFd;
+   fds[ 0 ].events = POLLIN;
+
+   while ( !checkForStop() )
+   {
+      // Stop polling the sockets while the main thread holds on to all
+      // receive buffers.  The datagrams wait in the socket buffers.
+      bool canReceive = mNumRecvSpare > 0;
+      if ( !canReceive )
+      {
+         NetIOPacket* packet = mRecvFree.pop();
+         if ( packet )
+         {
+            mRecvSpare[ mNumRecvSpare++ ] = packet;
+            canReceive = true;
+         }
+      }
+
+      for ( U32 i = 0; i < mNumSockets; i++ )
+      {
+         fds[ i + 1 ].fd = canReceive ? mSocketFds[ i ] : -1;
+         fds[ i + 1 ].events = POLLIN;
+         fds[ i + 1 ].revents = 0;
+      }
+
+      if ( ::poll( fds, mNumSockets + 1, canReceive ? 100 : 1 ) < 0 )
+         continue;
+
+      if ( fds[ 0 ].revents & POLLIN )
+      {
+         U64 value;
+         if ( ::read( mWakeFd, &value, sizeof( value ) ) < 0 )
+            value = 0;
+      }
+
+      // Allow the next send to wake us up again before sending what has
+      // been queued so far.
+      dCompareAndSwap( mWakePending, 1, 0 );
+      _flushSends();
+
+      for ( U32 i = 0; i < mNumSockets; i++ )
+      {
+         if ( fds[ i + 1 ].revents & POLLIN )
+            _receive( mSocketFds[ i ] );
+      }
+   }
+
+   // Send what was queued after the last pass so disconnect packets and
+   // the like still go out before the port is closed.
+   _flushSends();
+}
+
+void NetIOThread::_receive( SOCKET socketFd )
+{
+   mmsghdr msgs[ BatchSize ];
+   iovec iovs[ BatchSize ];
+   sockaddr_storage addrs[ BatchSize ];
+
+   while ( mNumRecvSpare < BatchSize )
+   {
+      NetIOPacket* packet = mRecvFree.pop();
+      if ( !packet )
+         break;
+      mRecvSpare[ mNumRecvSpare++ ] = packet;
+   }
+
+   if ( !mNumRecvSpare )
+      return;
+
+   for ( U32 i = 0; i < mNumRecvSpare; i++ )
+   {
+      iovs[ i ].iov_base = mRecvSpare[ i ]->data;
+      iovs[ i ].iov_len = Net::MaxPacketDataSize;
+
+      dMemset( &msgs[ i ], 0, sizeof( mmsghdr ) );
+      msgs[ i ].msg_hdr.msg_name = &addrs[ i ];
+      msgs[ i ].msg_hdr.msg_namelen = sizeof( sockaddr_storage );
+      msgs[ i ].msg_hdr.msg_iov = &iovs[ i ];
+      msgs[ i ].msg_hdr.msg_iovlen = 1;
+   }
+
+   S32 numReceived = ::recvmmsg( socketFd, msgs, mNumRecvSpare, MSG_DONTWAIT, NULL );
+   if ( numReceived <= 0 )
+      return;
+
+   // Hand over the filled buffers and keep the ones that were not used
+   // or held packets we drop.
+   U32 numSpare = 0;
+   for ( U32 i = 0; i < mNumRecvSpare; i++ )
+   {
+      NetIOPacket* packet = mRecvSpare[ i ];
+      bool valid = i < U32( numReceived ) && msgs[ i ].msg_len > 0;
+
+      if ( valid )
+      {
+         if ( addrs[ i ].ss_family == AF_INET )
+            IPSocketToNetAddress( ( sockaddr_in* ) &addrs[ i ], &packet->address );
+         else if ( addrs[ i ].ss_family == AF_INET6 )
+            IPSocket6ToNetAddress( ( sockaddr_in6* ) &addrs[ i ], &packet->address );
+         else
+            valid = false;
+      }
+
+      // Ignore packets we sent to ourselves.
+      if ( valid &&
+           packet->address.type == NetAddress::IPAddress &&
+           packet->address.address.ipv4.netNum[0] == 127 &&
+           packet->address.address.ipv4.netNum[1] == 0 &&
+           packet->address.address.ipv4.netNum[2] == 0 &&
+           packet->address.address.ipv4.netNum[3] == 1 &&
+           packet->address.port == PlatformNetState::netPort )
+         valid = false;
+
+      if ( valid )
+      {
+         packet->size = msgs[ i ].msg_len;
+         valid = mRecvReady.push( packet );
+      }
+
+      if ( !valid )
+         mRecvSpare[ numSpare++ ] = packet;
+   }
+   mNumRecvSpare = numSpare;
+}
+
+void NetIOThread::_flushSends()
+{
+   mmsghdr msgs[ BatchSize ];
+   iovec iovs[ BatchSize ];
+   NetIOPacket* batch[ BatchSize ];
+
+   for ( ;; )
+   {
+      U32 count = 0;
+      while ( count < BatchSize && ( batch[ count ] = mSendReady.pop() ) != NULL )
+      {
+         NetIOPacket* packet = batch[ count ];
+
+         iovs[ count ].iov_base = packet->data;
+         iovs[ count ].iov_len = packet->size;
+
+         dMemset( &msgs[ count ], 0, sizeof( mmsghdr ) );
+         msgs[ count ].msg_hdr.msg_name = &packet->sockAddr;
+         msgs[ count ].msg_hdr.msg_namelen = packet->sockAddrLen;
+         msgs[ count ].msg_hdr.msg_iov = &iovs[ count ];
+         msgs[ count ].msg_hdr.msg_iovlen = 1;
+
+         count++;
+      }
+
+      if ( !count )
+         break;
+
+      // One call for each run of packets going out on the same socket.  Like
+      // with sendto(), a packet the socket does not take is dropped, but the
+      // ones behind it are still sent.
+      for ( U32 start = 0; start < count; )
+      {
+         U32 end = start + 1;
+         while ( end < count && batch[ end ]->socketFd == batch[ start ]->socketFd )
+            end++;
+
+         for ( U32 sent = start; sent < end; )
+         {
+            S32 numSent = ::sendmmsg( batch[ start ]->socketFd, &msgs[ sent ], end - sent, 0 );
+            if ( numSent <= 0 )
+               sent++;
+            else
+               sent += numSent;
+         }
+
+         start = end;
+      }
+
+      for ( U32 i = 0; i < count; i++ )
+         mSendFree.push( batch[ i ] );
+      dFetchAndAdd( mNumSendsDone, count );
+   }
+}
+
+void NetIOThread::processReceived()
+{
+   NetIOPacket* packet;
+   while ( ( packet = mRecvReady.pop() ) != NULL )
+   {
+      RawData data( ( S8* ) packet->data, packet->size );
+      smPacketReceive->trigger( packet->address, data );
+
+      mRecvFree.push( packet );
+   }
+}
+
+bool NetIOThread::send( SOCKET socketFd, const sockaddr* sockAddr, socklen_t sockAddrLen, const U8* buffer, S32 bufferSize )
+{
+   if ( bufferSize > Net::MaxPacketDataSize || sockAddrLen > sizeof( sockaddr_storage ) )
+   {
+      flushSends();
+      return false;
+   }
+
+   // Sending the packet directly while others are queued up would send it
+   // ahead of them, so wait for a buffer instead.
+   NetIOPacket* packet;
+   while ( ( packet = mSendFree.pop() ) == NULL )
+   {
+      _wake();
+      Platform::sleep( 0 );
+   }
+
+   packet->socketFd = socketFd;
+   dMemcpy( &packet->sockAddr, sockAddr, sockAddrLen );
+   packet->sockAddrLen = sockAddrLen;
+   dMemcpy( packet->data, buffer, bufferSize );
+   packet->size = bufferSize;
+
+   mNumSendsQueued++;
+   mSendReady.push( packet );
+   _wake();
+
+   return true;
+}
+
+void NetIOThread::flushSends()
+{
+   while ( dAtomicRead( mNumSendsDone ) != mNumSendsQueued )
+   {
+      _wake();
+      Platform::sleep( 0 );
+   }
+}
+
+#endif // TORQUE_NET_BATCHED_IO
+
+/// Start the batched UDP path on the open ports if it is enabled.
+static void startBatchedIO()
+{
+#ifdef TORQUE_NET_BATCHED_IO
+   if ( !Net::smBatchedIO || gNetIOThread || Journal::IsPlaying() )
+      return;
+
+   NetIOThread* thread = new NetIOThread(
+      PlatformNetState::smReservedSocketList.resolve( PlatformNetState::udpSocket ),
+      PlatformNetState::smReservedSocketList.resolve( PlatformNetState::udp6Socket ) );
+
+   if ( !thread->isValid() )
+   {
+      Con::errorf( "Unable to start batched UDP I/O - falling back to polling" );
+      delete thread;
+      return;
+   }
+
+   thread->start();
+   gNetIOThread = thread;
+#endif
+}
+
+/// Stop the batched UDP path, if running.
+static void stopBatchedIO()
+{
+#ifdef TORQUE_NET_BATCHED_IO
+   if ( !gNetIOThread )
+      return;
+
+   // Send the queued packets before closing the port; received ones still
+   // waiting are dropped like ones arriving at a closed port.
+   gNetIOThread->flushSends();
+   gNetIOThread->shutdown();
+   delete gNetIOThread;
+   gNetIOThread = NULL;
+#endif
+}
+
 bool Net::init()
 {
 #if defined(TORQUE_USE_WINSOCK)
@@ -950,6 +1393,8 @@ Net::Error Net::sendtoSocket(NetSocket handleFd, const U8 *buffer, S32  bufferSi
 
 bool Net::openPort(S32 port, bool doBind)
 {
+   stopBatchedIO();
+
    if (PlatformNetState::udpSocket != NetSocket::INVALID)
    {
       closeSocket(PlatformNetState::udpSocket);
@@ -965,6 +1410,7 @@ bool Net::openPort(S32 port, bool doBind)
    Net::smMulticastEnabled = Con::getBoolVariable("pref::Net::Multicast6Enabled", true);
    Net::smIpv4Enabled = Con::getBoolVariable("pref::Net::IPV4Enabled", true);
    Net::smIpv6Enabled = Con::getBoolVariable("pref::Net::IPV6Enabled", false);
+   Net::smBatchedIO = Con::getBoolVariable("pref::Net::BatchedIO", false);
 
    // we turn off VDP in non-release builds because VDP does not support broadcast packets
    // which are required for LAN queries (PC->Xbox connectivity).  The wire protocol still
@@ -1087,6 +1533,8 @@ bool Net::openPort(S32 port, bool doBind)
 
    PlatformNetState::netPort = port;
 
+   startBatchedIO();
+
    return PlatformNetState::udpSocket != NetSocket::INVALID || PlatformNetState::udp6Socket != NetSocket::INVALID;
 }
 
@@ -1097,6 +1545,8 @@ NetSocket Net::getPort()
 
 void Net::closePort()
 {
+   stopBatchedIO();
+
    if (PlatformNetState::udpSocket != NetSocket::INVALID)
       closeSocket(PlatformNetState::udpSocket);
    if (PlatformNetState::udp6Socket != NetSocket::INVALID)
@@ -1118,6 +1568,11 @@ Net::Error Net::sendto(const NetAddress *address, const U8 *buffer, S32  bufferS
          sockaddr_in ipAddr;
          NetAddressToIPSocket(address, &ipAddr);
 
+#ifdef TORQUE_NET_BATCHED_IO
+         if (gNetIOThread && gNetIOThread->send(socketFd, (sockaddr *)&ipAddr, sizeof(sockaddr_in), buffer, bufferSize))
+            return NoError;
+#endif
+
          if (::sendto(socketFd, (const char*)buffer, bufferSize, 0,
             (sockaddr *)&ipAddr, sizeof(sockaddr_in)) == SOCKET_ERROR)
             return PlatformNetState::getLastError();
@@ -1137,6 +1592,12 @@ Net::Error Net::sendto(const NetAddress *address, const U8 *buffer, S32  bufferS
       {
          sockaddr_in6 ipAddr;
          NetAddressToIPSocket6(address, &ipAddr);
+
+#ifdef TORQUE_NET_BATCHED_IO
+         if (gNetIOThread && gNetIOThread->send(socketFd, (sockaddr *)&ipAddr, sizeof(sockaddr_in6), buffer, bufferSize))
+            return NoError;
+#endif
+
          if (::sendto(socketFd, (const char*)buffer, bufferSize, 0,
           (struct sockaddr *) &ipAddr, sizeof(sockaddr_in6)) == SOCKET_ERROR)
             return PlatformNetState::getLastError();
@@ -1155,8 +1616,15 @@ Net::Error Net::sendto(const NetAddress *address, const U8 *buffer, S32  bufferS
 void Net::process()
 {
    // Process listening sockets
-   processListenSocket(PlatformNetState::udpSocket);
-   processListenSocket(PlatformNetState::udp6Socket);
+#ifdef TORQUE_NET_BATCHED_IO
+   if (gNetIOThread)
+      gNetIOThread->processReceived();
+   else
+#endif
+   {
+      processListenSocket(PlatformNetState::udpSocket);
+      processListenSocket(PlatformNetState::udp6Socket);
+   }
 
    // process the polled sockets.  This blob of code performs functions
    // similar to WinsockProc in winNet.cc
@@ -215,6 +215,11 @@ struct Net
    static bool smIpv4Enabled;
    static bool smIpv6Enabled;
 
+   /// If true, the UDP port is serviced by a network thread that receives
+   /// and sends datagrams in batches.  Only supported on Linux; read from
+   /// $pref::Net::BatchedIO when the port is opened.
+   static bool smBatchedIO;
+
    static bool init();
    static void shutdown();
 
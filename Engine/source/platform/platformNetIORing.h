@@ -0,0 +1,83 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _PLATFORMNETIORING_H_
+#define _PLATFORMNETIORING_H_
+
+#ifndef _PLATFORMINTRINSICS_H_
+#include "platform/platformIntrinsics.h"
+#endif
+
+/// Lock-free queue of pointers between exactly one producer and one consumer
+/// thread.
+///
+/// Used by the batched UDP path of the network layer to pass packet buffers
+/// between the main thread and the network thread.
+template< class T >
+class NetIORing
+{
+public:
+   enum { Size = 256 }; ///< Must be a power of two.
+
+protected:
+   /// Index of the next item to pop.  Only written by the consumer.
+   volatile U32 mHead;
+   U8 mHeadPad[ 64 - sizeof( U32 ) ];
+
+   /// Index of the next free slot.  Only written by the producer.
+   volatile U32 mTail;
+   U8 mTailPad[ 64 - sizeof( U32 ) ];
+
+   T* mItems[ Size ];
+
+public:
+   NetIORing() : mHead( 0 ), mTail( 0 ) {}
+
+   /// Append an item.  Must only be called by the producer.  Returns false
+   /// if the ring is full.
+   bool push( T* item )
+   {
+      const U32 tail = mTail;
+      if ( tail - dAtomicRead( mHead ) >= Size )
+         return false;
+
+      mItems[ tail & ( Size - 1 ) ] = item;
+      dFetchAndAdd( mTail, 1 );
+      return true;
+   }
+
+   /// Remove the oldest item.  Must only be called by the consumer.  Returns
+   /// NULL if the ring is empty.
+   T* pop()
+   {
+      const U32 head = mHead;
+      if ( head == dAtomicRead( mTail ) )
+         return NULL;
+
+      T* item = mItems[ head & ( Size - 1 ) ];
+      dFetchAndAdd( mHead, 1 );
+      return item;
+   }
+};
+
+#endif // _PLATFORMNETIORING_H_
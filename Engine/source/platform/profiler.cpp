@@ -37,6 +37,8 @@
 
 #include "platform/profiler.h"
 #include "platform/threads/thread.h"
+#include "platform/platformTLS.h"
+#include "platform/platformIntrinsics.h"
 
 #include "console/engineAPI.h"
 
@@ -172,6 +174,49 @@ U32 endHighResolutionTimer(U32 time[2])
 
 #endif
 
+//-----------------------------------------------------------------------------
+// Timeline trace storage.
+//-----------------------------------------------------------------------------
+
+struct ProfilerTraceEvent
+{
+   enum Type
+   {
+      Begin,
+      End,
+      Frame
+   };
+
+   ProfilerRootData *mRoot;
+   U64 mTime;
+   U32 mType;
+};
+
+/// The trace events of one thread.  Only the owning thread writes to a
+/// buffer.  The main thread reads the first mCount events once the trace
+/// is finished.
+struct ProfilerTraceBuffer
+{
+   U32 mThreadId;
+   bool mIsMainThread;
+   U32 mTraceId;              ///< Trace the recorded events belong to.
+   volatile U32 mCount;
+   U32 mDropped;              ///< Events lost because the buffer was full.
+   U32 mStackDepth;           ///< Blocks begun since the trace started and not yet ended.
+   ProfilerTraceEvent *mEvents;
+   ProfilerTraceBuffer *mNext;
+};
+
+// The buffers are created by their threads on the first event of a trace
+// and are kept for the life of the process, so worker threads never wait
+// on the thread writing the trace out.
+static ThreadStorage sTraceBufferStorage;
+static ProfilerTraceBuffer * volatile sTraceBufferList = NULL;
+
+/// Id of the trace being recorded, zero if none is.
+static volatile U32 sTraceId = 0;
+static U32 sLastTraceId = 0;
+
 Profiler::Profiler()
 {
    mMaxStackDepth = MaxStackDepth;
@@ -208,6 +253,10 @@ Profiler::Profiler()
    mDumpToConsole   = false;
    mDumpToFile      = false;
    mDumpFileName[0] = '\0';
+   mTraceFramesLeft = 0;
+   mTraceFrameCount = 0;
+   mTraceStartTime  = 0;
+   mTraceFileName[0] = '\0';
 }
 
 Profiler::~Profiler()
@@ -343,6 +392,9 @@ const char * Profiler::constructProfilePath(ProfilerData * pd)
 #endif
 void Profiler::hashPush(ProfilerRootData *root)
 {
+   if(sTraceId)
+      traceEvent(root, ProfilerTraceEvent::Begin);
+
 #ifdef TORQUE_MULTITHREAD
    // Ignore non-main-thread profiler activity.
    if( !ThreadManager::isMainThread() )
@@ -438,6 +490,9 @@ void Profiler::dumpToFile(const char* fileName)
 
 void Profiler::hashPop(ProfilerRootData *expected)
 {
+   if(sTraceId)
+      traceEvent(NULL, ProfilerTraceEvent::End);
+
 #ifdef TORQUE_MULTITHREAD
    // Ignore non-main-thread profiler activity.
    if( !ThreadManager::isMainThread() )
@@ -472,6 +527,9 @@ void Profiler::hashPop(ProfilerRootData *expected)
    }
    if(mStackDepth == 0)
    {
+      if(mTraceFramesLeft)
+         traceFrame();
+
       // apply the next enable...
       if(mDumpToConsole || mDumpToFile)
       {
@@ -686,6 +744,198 @@ void Profiler::dump()
    mDumpFileName[0] = '\0';
 }
 
+//-----------------------------------------------------------------------------
+
+bool Profiler::traceToFile(const char *fileName, U32 frameCount)
+{
+   AssertFatal(ThreadManager::isMainThread(), "Profiler::traceToFile - Traces must be started from the main thread!");
+
+   if(mTraceFramesLeft)
+   {
+      Con::errorf("Profiler::traceToFile - A trace to '%s' is already being recorded.", mTraceFileName);
+      return false;
+   }
+
+   if(dStrlen(fileName) >= DumpFileNameLength)
+   {
+      Con::errorf("Profiler::traceToFile - Trace filename too long.");
+      return false;
+   }
+
+   dStrcpy(mTraceFileName, fileName);
+   mTraceFramesLeft = getMax(frameCount, 1U);
+   mTraceFrameCount = 0;
+   mTraceStartTime = Platform::getRealMicroseconds();
+
+   // Zero means no trace, so skip it when the id wraps.
+   if(++sLastTraceId == 0)
+      sLastTraceId = 1;
+   dCompareAndSwap(sTraceId, 0, sLastTraceId);
+   return true;
+}
+
+void Profiler::traceEvent(ProfilerRootData *root, U32 type)
+{
+   const U32 traceId = dAtomicRead(sTraceId);
+   if(!traceId)
+      return;
+
+   ProfilerTraceBuffer *buffer = (ProfilerTraceBuffer *) sTraceBufferStorage.get();
+   if(!buffer)
+   {
+      buffer = (ProfilerTraceBuffer *) malloc(sizeof(ProfilerTraceBuffer));
+      buffer->mThreadId = ThreadManager::getCurrentThreadId();
+      buffer->mIsMainThread = ThreadManager::isMainThread();
+      buffer->mTraceId = 0;
+      buffer->mCount = 0;
+      buffer->mDropped = 0;
+      buffer->mStackDepth = 0;
+      buffer->mEvents = (ProfilerTraceEvent *) malloc(sizeof(ProfilerTraceEvent) * TraceEventsPerThread);
+
+      ProfilerTraceBuffer *head;
+      do
+      {
+         head = sTraceBufferList;
+         buffer->mNext = head;
+      }
+      while(!dCompareAndSwap(sTraceBufferList, head, buffer));
+
+      sTraceBufferStorage.set(buffer);
+   }
+
+   // First event of a new trace, so drop whatever is left of the last one.
+   if(buffer->mTraceId != traceId)
+   {
+      buffer->mCount = 0;
+      buffer->mDropped = 0;
+      buffer->mStackDepth = 0;
+      buffer->mTraceId = traceId;
+   }
+
+   // Blocks begun before the trace started are not in it.
+   if(type == ProfilerTraceEvent::Begin)
+      buffer->mStackDepth++;
+   else if(type == ProfilerTraceEvent::End)
+   {
+      if(!buffer->mStackDepth)
+         return;
+      buffer->mStackDepth--;
+   }
+
+   const U32 index = buffer->mCount;
+   if(index >= TraceEventsPerThread)
+   {
+      buffer->mDropped++;
+      return;
+   }
+
+   ProfilerTraceEvent &event = buffer->mEvents[index];
+   event.mRoot = root;
+   event.mTime = Platform::getRealMicroseconds();
+   event.mType = type;
+
+   // Publish the event.
+   dFetchAndAdd(buffer->mCount, 1);
+}
+
+void Profiler::traceFrame()
+{
+   traceEvent(NULL, ProfilerTraceEvent::Frame);
+   mTraceFrameCount++;
+
+   if(--mTraceFramesLeft == 0)
+   {
+      dCompareAndSwap(sTraceId, sLastTraceId, 0);
+      writeTrace();
+   }
+}
+
+void Profiler::writeTrace()
+{
+   const U64 endTime = Platform::getRealMicroseconds();
+
+   FileStream fws;
+   if(!fws.open(mTraceFileName, Torque::FS::File::Write))
+   {
+      Con::errorf("Profiler::writeTrace - Could not open '%s' for writing.", mTraceFileName);
+      return;
+   }
+
+   char buffer[1024];
+   dStrcpy(buffer, "{\"traceEvents\":[\n");
+   fws.write(dStrlen(buffer), buffer);
+
+   U32 numEvents = 0;
+   U32 numDropped = 0;
+   U32 workerIndex = 0;
+   const char *separator = "";
+
+   for(ProfilerTraceBuffer *walk = sTraceBufferList; walk; walk = walk->mNext)
+   {
+      if(walk->mTraceId != sLastTraceId)
+         continue;
+
+      // Name the thread.
+      if(walk->mIsMainThread)
+         dSprintf(buffer, 1023, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Main Thread\"}},\n"
+            "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"sort_index\":-1}}",
+            separator, walk->mThreadId, walk->mThreadId);
+      else
+         dSprintf(buffer, 1023, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Worker %u\"}}",
+            separator, walk->mThreadId, workerIndex++);
+      fws.write(dStrlen(buffer), buffer);
+      separator = ",\n";
+
+      const U32 count = dAtomicRead(walk->mCount);
+      U32 depth = 0;
+      for(U32 i = 0; i < count; i++)
+      {
+         const ProfilerTraceEvent &event = walk->mEvents[i];
+         const U32 time = event.mTime > mTraceStartTime ? (U32)(event.mTime - mTraceStartTime) : 0;
+
+         switch(event.mType)
+         {
+            case ProfilerTraceEvent::Begin:
+               depth++;
+               dSprintf(buffer, 1023, ",\n{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%u,\"pid\":0,\"tid\":%u}",
+                  event.mRoot->mName, time, walk->mThreadId);
+               break;
+
+            case ProfilerTraceEvent::End:
+               depth--;
+               dSprintf(buffer, 1023, ",\n{\"ph\":\"E\",\"ts\":%u,\"pid\":0,\"tid\":%u}",
+                  time, walk->mThreadId);
+               break;
+
+            default:
+               dSprintf(buffer, 1023, ",\n{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%u,\"pid\":0,\"tid\":%u}",
+                  time, walk->mThreadId);
+               break;
+         }
+         fws.write(dStrlen(buffer), buffer);
+      }
+
+      // Close the blocks still open when the trace ended.
+      const U32 endTs = (U32)(endTime - mTraceStartTime);
+      for(; depth > 0; depth--)
+      {
+         dSprintf(buffer, 1023, ",\n{\"ph\":\"E\",\"ts\":%u,\"pid\":0,\"tid\":%u}", endTs, walk->mThreadId);
+         fws.write(dStrlen(buffer), buffer);
+      }
+
+      numEvents += count;
+      numDropped += walk->mDropped;
+   }
+
+   dStrcpy(buffer, "\n],\"displayTimeUnit\":\"ms\"}\n");
+   fws.write(dStrlen(buffer), buffer);
+   fws.close();
+
+   Con::printf("Profiler trace of %d frames with %d events written to %s", mTraceFrameCount, numEvents, mTraceFileName);
+   if(numDropped)
+      Con::warnf("Profiler::writeTrace - %d events did not fit in the per-thread buffers and were dropped.", numDropped);
+}
+
 void Profiler::enableMarker(const char *marker, bool enable)
 {
    reset();
@@ -766,6 +1016,24 @@ DefineEngineFunction( profilerDumpToFile, void, ( const char* fileName ),,
       gProfiler->dumpToFile(fileName);
 }
 
+DefineEngineFunction( profilerTraceToFile, bool, ( const char* fileName, S32 frames ), ( 60 ),
+                "@brief Records a timeline of all profile markers on all threads and writes it to a file.\n\n"
+                "Unlike profilerDumpToFile(), the trace keeps every begin and end of a marker with its time, "
+                "including those run by the worker threads.  The file is written in Chrome trace event JSON "
+                "format, which chrome://tracing and Perfetto can open.  Tracing does not require profilerEnable().\n\n"
+                "@param fileName Name and path of the file to write the trace to.\n"
+                "@param frames The number of frames to record.\n"
+                "@return False if a trace is already being recorded.\n"
+                "@tsexample\n"
+                "profilerTraceToFile( \"C:/Torque/spike.json\", 120 );\n"
+                "@endtsexample\n\n"
+                "@ingroup Debugging" )
+{
+   if(gProfiler)
+      return gProfiler->traceToFile(fileName, getMax(frames, 1));
+   return false;
+}
+
 DefineEngineFunction( profilerReset, void, (),,
                 "@brief Resets the profiler, clearing it of all its data.\n\n"
                 "If the profiler is currently running, it will first be disabled. "
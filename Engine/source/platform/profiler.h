@@ -44,6 +44,7 @@ struct ProfilerRootData;
 /// profilerDump();                                         //dumps all profiler data to the console
 /// profilerDumpToFile(string filename);                    //dumps all profiler data to a given file
 /// profilerMarkerEnable((string markerName, bool enable);  //enables or disables a given profile tag
+/// profilerTraceToFile(string filename, int frames);       //records a timeline of all threads for the next frames
 /// @endcode
 ///
 /// The C++ code side of the profiler uses pairs of PROFILE_START() and PROFILE_END().
@@ -68,11 +69,19 @@ struct ProfilerRootData;
 /// //possibly some code here
 /// PROFILE_END();
 /// @endcode
+///
+/// The aggregated dumps only cover the main thread.  A timeline trace records
+/// the begin and end of every profile block on every thread, including the
+/// ThreadPool workers, into a buffer owned by that thread.  Recording takes no
+/// locks.  Once the requested number of frames has passed, the trace is
+/// written as Chrome trace event JSON, which chrome://tracing and Perfetto
+/// can open.  Tracing works whether or not the profiler is enabled.
 class Profiler
 {
    enum {
       MaxStackDepth = 256,
-      DumpFileNameLength = 256
+      DumpFileNameLength = 256,
+      TraceEventsPerThread = 256 * 1024
    };
    U32 mCurrentHash;
 
@@ -87,6 +96,24 @@ class Profiler
    bool mDumpToConsole;
    bool mDumpToFile;
    char mDumpFileName[DumpFileNameLength];
+
+   /// @name Timeline Trace
+   /// @{
+
+   /// Frames left in the current trace, zero if no trace is running.
+   U32 mTraceFramesLeft;
+   U32 mTraceFrameCount;
+   U64 mTraceStartTime;
+   char mTraceFileName[DumpFileNameLength];
+
+   void traceEvent(ProfilerRootData *root, U32 type);
+   void traceFrame();
+   void writeTrace();
+
+   /// @}
+
+   friend class ProfilerTraceFixture;
+
    void dump();
    void validate();
 public:
@@ -100,6 +127,14 @@ public:
    /// Dumps the profile data to a file
    /// @param fileName filename to dump data to
    void dumpToFile(const char *fileName);
+   /// Records a timeline of all threads for the given number of frames, then
+   /// writes it to a file in Chrome trace event format.
+   /// @param fileName filename to write the trace to
+   /// @param frameCount number of main loop frames to record
+   /// @return false if a trace is already being recorded
+   bool traceToFile(const char *fileName, U32 frameCount);
+   /// Returns true while a timeline trace is being recorded
+   bool isTracing() const { return mTraceFramesLeft != 0; }
    /// Enable profiling
    void enable(bool enabled);
    bool isEnabled() { return mNextEnable; }
@@ -0,0 +1,244 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platformNet.h"
+#include "platform/platformNetIORing.h"
+#include "platform/threads/thread.h"
+#include "console/console.h"
+#include "core/util/journal/process.h"
+
+#ifdef TORQUE_OS_LINUX
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+TEST(NetIORing, PushPop)
+{
+   NetIORing< U32 > ring;
+   U32 values[ NetIORing< U32 >::Size + 1 ];
+
+   EXPECT_EQ(NULL, ring.pop());
+
+   for (U32 i = 0; i < NetIORing< U32 >::Size; i++)
+   {
+      values[ i ] = i;
+      EXPECT_TRUE(ring.push(&values[ i ]));
+   }
+   EXPECT_FALSE(ring.push(&values[ NetIORing< U32 >::Size ]))
+      << "Pushed into a full ring!";
+
+   for (U32 i = 0; i < NetIORing< U32 >::Size; i++)
+      EXPECT_EQ(&values[ i ], ring.pop());
+   EXPECT_EQ(NULL, ring.pop());
+}
+
+TEST(NetIORing, ProducerConsumerOrder)
+{
+   enum { NumItems = 100000 };
+
+   struct producer : public Thread
+   {
+      NetIORing< U32 >* mRing;
+      U32* mValues;
+      producer(NetIORing< U32 >* ring, U32* values) : mRing(ring), mValues(values) {}
+
+      virtual void run(void*)
+      {
+         for (U32 i = 0; i < NumItems; i++)
+         {
+            mValues[ i ] = i;
+            while (!mRing->push(&mValues[ i ]))
+               Platform::sleep(0);
+         }
+      }
+   };
+
+   NetIORing< U32 > ring;
+   Vector< U32 > values;
+   values.setSize(NumItems);
+
+   producer thread(&ring, values.address());
+   thread.start();
+
+   // Keep popping until the producer is done, even if an item comes
+   // out of order, so the thread never writes to a dead ring.
+   U32 numPopped = 0;
+   U32 numOutOfOrder = 0;
+   while (numPopped < NumItems)
+   {
+      U32* value = ring.pop();
+      if (!value)
+         continue;
+
+      if (*value != numPopped)
+         numOutOfOrder++;
+      numPopped++;
+   }
+   thread.join();
+
+   EXPECT_EQ(0, numOutOfOrder);
+   EXPECT_EQ(NULL, ring.pop());
+}
+
+#ifdef TORQUE_OS_LINUX
+
+struct BatchedIOHandle
+{
+   U16 mPeerPort;
+   U32 mNumReceived;
+   U32 mNumOutOfOrder;
+
+   void receive(NetAddress address, RawData data)
+   {
+      if (address.port != mPeerPort || data.size != sizeof(U32))
+         return;
+
+      U32 seq;
+      dMemcpy(&seq, data.data, sizeof(U32));
+      if (seq != mNumReceived)
+         mNumOutOfOrder++;
+      mNumReceived++;
+   }
+};
+
+TEST(Net, BatchedIOKeepsPacketOrder)
+{
+   const U16 port = 28123;
+
+   // Open a plain socket to talk to the batched port.
+   S32 peer = ::socket(AF_INET, SOCK_DGRAM, 0);
+   ASSERT_GE(peer, 0);
+
+   sockaddr_in peerAddr;
+   dMemset(&peerAddr, 0, sizeof(peerAddr));
+   peerAddr.sin_family = AF_INET;
+   peerAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   socklen_t peerAddrLen = sizeof(peerAddr);
+   S32 rcvBuf = 4 * 1024 * 1024;
+   ::setsockopt(peer, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf));
+   const bool peerBound = ::bind(peer, (sockaddr*)&peerAddr, sizeof(peerAddr)) == 0 &&
+      ::getsockname(peer, (sockaddr*)&peerAddr, &peerAddrLen) == 0;
+
+   const bool wasBatched = Con::getBoolVariable("pref::Net::BatchedIO", false);
+   Con::setBoolVariable("pref::Net::BatchedIO", true);
+   const bool portOpen = peerBound && Net::openPort(port);
+   Con::setBoolVariable("pref::Net::BatchedIO", wasBatched);
+
+   EXPECT_TRUE(peerBound);
+   EXPECT_TRUE(portOpen);
+   if (!portOpen)
+   {
+      ::close(peer);
+      return;
+   }
+
+   // Send more packets than there are send buffers, with one packet too
+   // big for the buffers in between, and check they arrive in order.
+   enum { NumPackets = 1000 };
+
+   NetAddress peerNetAddr;
+   dMemset(&peerNetAddr, 0, sizeof(peerNetAddr));
+   peerNetAddr.type = NetAddress::IPAddress;
+   peerNetAddr.address.ipv4.netNum[0] = 127;
+   peerNetAddr.address.ipv4.netNum[3] = 1;
+   peerNetAddr.port = ntohs(peerAddr.sin_port);
+
+   U8 buffer[ Net::MaxPacketDataSize + 16 ];
+   dMemset(buffer, 0, sizeof(buffer));
+
+   U32 numReceived = 0;
+   U32 numOutOfOrder = 0;
+   S32 lastSeq = -1;
+   U8 recvBuffer[ Net::MaxPacketDataSize + 16 ];
+
+   for (U32 i = 0; i < NumPackets; i++)
+   {
+      dMemcpy(buffer, &i, sizeof(U32));
+      const S32 size = (i == NumPackets / 2) ? S32(sizeof(buffer)) : S32(sizeof(U32));
+      EXPECT_EQ(Net::NoError, Net::sendto(&peerNetAddr, buffer, size));
+
+      while (::recv(peer, recvBuffer, sizeof(recvBuffer), MSG_DONTWAIT) >= S32(sizeof(U32)))
+      {
+         S32 seq;
+         dMemcpy(&seq, recvBuffer, sizeof(S32));
+         if (seq <= lastSeq)
+            numOutOfOrder++;
+         lastSeq = seq;
+         numReceived++;
+      }
+   }
+
+   U32 limit = Platform::getRealMilliseconds() + 2000;
+   while (numReceived < NumPackets && Platform::getRealMilliseconds() < limit)
+   {
+      if (::recv(peer, recvBuffer, sizeof(recvBuffer), MSG_DONTWAIT) < S32(sizeof(U32)))
+      {
+         Platform::sleep(1);
+         continue;
+      }
+
+      S32 seq;
+      dMemcpy(&seq, recvBuffer, sizeof(S32));
+      if (seq <= lastSeq)
+         numOutOfOrder++;
+      lastSeq = seq;
+      numReceived++;
+   }
+
+   EXPECT_GT(numReceived, 0);
+   EXPECT_EQ(0, numOutOfOrder) << "Sent packets were reordered!";
+
+   // Receive a burst through the network thread.
+   BatchedIOHandle handler;
+   handler.mPeerPort = ntohs(peerAddr.sin_port);
+   handler.mNumReceived = 0;
+   handler.mNumOutOfOrder = 0;
+   Net::getPacketReceiveEvent().notify(&handler, &BatchedIOHandle::receive);
+
+   sockaddr_in portAddr = peerAddr;
+   portAddr.sin_port = htons(port);
+   for (U32 i = 0; i < 100; i++)
+      ::sendto(peer, &i, sizeof(U32), 0, (sockaddr*)&portAddr, sizeof(portAddr));
+
+   limit = Platform::getRealMilliseconds() + 2000;
+   while (handler.mNumReceived < 100 && Platform::getRealMilliseconds() < limit)
+   {
+      Process::processEvents();
+      Platform::sleep(1);
+   }
+
+   Net::getPacketReceiveEvent().remove(&handler, &BatchedIOHandle::receive);
+   Net::closePort();
+   ::close(peer);
+
+   EXPECT_EQ(100, handler.mNumReceived);
+   EXPECT_EQ(0, handler.mNumOutOfOrder) << "Received packets were reordered!";
+}
+
+#endif // TORQUE_OS_LINUX
+
+#endif
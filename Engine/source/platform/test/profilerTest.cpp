@@ -26,6 +26,9 @@
 #ifdef TORQUE_ENABLE_PROFILER
 #include "testing/unitTesting.h"
 #include "platform/profiler.h"
+#include "platform/threads/thread.h"
+#include "platform/threads/threadPool.h"
+#include "core/stream/fileStream.h"
 
 TEST(Profiler, ProfileStartEnd)
 {
@@ -45,5 +48,128 @@ TEST(Profiler, ProfileScope)
    // Do work and return whenever you want.
 }
 
+FIXTURE(ProfilerTrace)
+{
+public:
+   // Profiles a block on a worker thread that is still running when the
+   // next frame starts.
+   struct TraceItem : public ThreadPool::WorkItem
+   {
+      volatile U32 mThreadId;
+      TraceItem() : mThreadId(0) {}
+
+   protected:
+      virtual void execute()
+      {
+         PROFILE_SCOPE(ProfilerTraceTestJob);
+         mThreadId = ThreadManager::getCurrentThreadId();
+         Platform::sleep(20);
+      }
+   };
+
+   const char* mFileName;
+
+   virtual void SetUp()
+   {
+      mFileName = "profilerTraceTest.json";
+   }
+
+   virtual void TearDown()
+   {
+      dFileDelete(mFileName);
+   }
+
+   // Ends a frame the way the main loop does, by closing its outermost
+   // profile block.  Tests that run inside a block end the frame directly.
+   static void endFrame()
+   {
+      if (gProfiler->mStackDepth == 0)
+      {
+         PROFILE_START(ProfilerTraceTestFrame);
+         PROFILE_END();
+      }
+      else
+         gProfiler->traceFrame();
+   }
+
+   static String readFile(const char* fileName)
+   {
+      FileStream stream;
+      if (!stream.open(fileName, Torque::FS::File::Read))
+         return String();
+
+      Vector<char> text;
+      text.setSize(stream.getStreamSize() + 1);
+      stream.read(text.size() - 1, text.address());
+      text.last() = '\0';
+      return String(text.address());
+   }
+
+   static U32 countOf(const String& text, const char* pattern)
+   {
+      U32 count = 0;
+      for (String::SizeType pos = text.find(pattern); pos != String::NPos; pos = text.find(pattern, pos + 1))
+         count++;
+      return count;
+   }
+
+   // Returns true if the event starting at pos was recorded by the thread.
+   static bool isOnThread(const String& text, String::SizeType pos, U32 threadId)
+   {
+      const String tid = String::ToString("\"tid\":%u}", threadId);
+      const String::SizeType end = text.find('}', pos);
+      return end != String::NPos && end + 1 >= tid.length() &&
+         text.substr(end + 1 - tid.length(), tid.length()) == tid;
+   }
+};
+
+TEST_FIX(ProfilerTrace, WorkerEventsAndFrames)
+{
+   ThreadPool* pool = &ThreadPool::GLOBAL();
+   ASSERT_GT(pool->getNumThreads(), 0U)
+      << "Need worker threads to trace";
+
+   const U32 numFrames = 3;
+   ASSERT_TRUE(gProfiler->traceToFile(mFileName, numFrames));
+   EXPECT_TRUE(gProfiler->isTracing());
+
+   // The job spans the first frame boundary.
+   ThreadSafeRef<TraceItem> item(new TraceItem());
+   pool->queueWorkItem(item);
+   endFrame();
+   pool->waitForAllItems();
+
+   for (U32 i = 1; i < numFrames; i++)
+      endFrame();
+
+   EXPECT_FALSE(gProfiler->isTracing())
+      << "The trace should be written after its last frame";
+
+   const U32 workerId = item->mThreadId;
+   ASSERT_NE(workerId, 0U);
+   EXPECT_FALSE(ThreadManager::compare(workerId, ThreadManager::getCurrentThreadId()))
+      << "The job should have run on a worker thread";
+
+   const String trace = readFile(mFileName);
+   ASSERT_FALSE(trace.isEmpty()) << "The trace file should have been written";
+   EXPECT_EQ(0, trace.find("{\"traceEvents\":["));
+
+   // The job's block begins and ends on the worker's timeline, whose
+   // events are written together.
+   const String::SizeType begin = trace.find("{\"name\":\"ProfilerTraceTestJob\",\"ph\":\"B\"");
+   ASSERT_NE(String::NPos, begin) << "Missing the job's begin event";
+   EXPECT_TRUE(isOnThread(trace, begin, workerId))
+      << "The job's begin event should be on the worker thread";
+
+   const String::SizeType end = trace.find("{\"ph\":\"E\"", begin);
+   ASSERT_NE(String::NPos, end) << "Missing the job's end event";
+   EXPECT_TRUE(isOnThread(trace, end, workerId))
+      << "The job's end event should be on the worker thread";
+
+   // The worker is named, and every frame has a marker.
+   EXPECT_EQ(1U, countOf(trace, String::ToString("\"tid\":%u,\"args\":{\"name\":\"Worker", workerId)));
+   EXPECT_EQ(numFrames, countOf(trace, "{\"name\":\"Frame\",\"ph\":\"i\""));
+}
+
 #endif
 #endif
\ No newline at end of file
@@ -0,0 +1,155 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/threads/threadPool.h"
+#include "console/console.h"
+#include "core/util/tVector.h"
+#include "math/mMathFn.h"
+
+FIXTURE(ThreadPoolBenchmark)
+{
+public:
+   // A small, fixed amount of work per element, about the size of
+   // updating one object in a tick or culling one object.
+   static F32 work(U32 index)
+   {
+      F32 value = F32(index);
+      for (U32 i = 0; i < 64; i++)
+         value = mSqrt(value * value + 1.0f);
+      return value;
+   }
+
+   // One work item per batch of elements, as code has to do today.
+   struct WorkBatchItem : public ThreadPool::WorkItem
+   {
+      F32* mResults;
+      U32 mBegin;
+      U32 mEnd;
+      WorkBatchItem(F32* results, U32 begin, U32 end)
+         : mResults(results), mBegin(begin), mEnd(end) {}
+
+   protected:
+      virtual void execute()
+      {
+         for (U32 i = mBegin; i < mEnd; i++)
+            mResults[i] = work(i);
+      }
+   };
+
+   struct WorkRange
+   {
+      F32* mResults;
+      WorkRange(F32* results) : mResults(results) {}
+
+      void operator()(U32 begin, U32 end)
+      {
+         for (U32 i = begin; i < end; i++)
+            mResults[i] = work(i);
+      }
+   };
+
+   static F64 runWorkItems(F32* results, U32 count, U32 grainSize)
+   {
+      ThreadPool* pool = &ThreadPool::GLOBAL();
+      const U32 start = Platform::getRealMilliseconds();
+      for (U32 i = 0; i < count; i += grainSize)
+      {
+         ThreadSafeRef<WorkBatchItem> item(new WorkBatchItem(results, i, getMin(i + grainSize, count)));
+         pool->queueWorkItem(item);
+      }
+      pool->waitForAllItems();
+      return F64(Platform::getRealMilliseconds() - start);
+   }
+
+   static F64 runParallelFor(F32* results, U32 count, U32 grainSize)
+   {
+      WorkRange range(results);
+      const U32 start = Platform::getRealMilliseconds();
+      ThreadPool::GLOBAL().parallelFor(0, count, grainSize, range);
+      return F64(Platform::getRealMilliseconds() - start);
+   }
+
+   static F64 runSerial(F32* results, U32 count)
+   {
+      WorkRange range(results);
+      const U32 start = Platform::getRealMilliseconds();
+      range(0, count);
+      return F64(Platform::getRealMilliseconds() - start);
+   }
+};
+
+TEST_FIX(ThreadPoolBenchmark, WorkItemsVersusJobs)
+{
+   const U32 count = 1 << 18;
+   Vector<F32> results(__FILE__, __LINE__);
+   results.setSize(count);
+
+   // Warm up the threads and the result memory.
+   runParallelFor(results.address(), count, 1024);
+
+   const F64 serial = runSerial(results.address(), count);
+   Con::printf("ThreadPoolBenchmark: %u elements, serial %.0f ms, %u threads",
+      count, serial, ThreadPool::GLOBAL().getNumThreads());
+
+   const U32 grainSizes[] = { 16, 256, 4096 };
+   for (U32 i = 0; i < sizeof(grainSizes) / sizeof(grainSizes[0]); i++)
+   {
+      const F64 items = runWorkItems(results.address(), count, grainSizes[i]);
+      const F64 jobs = runParallelFor(results.address(), count, grainSizes[i]);
+
+      Con::printf("ThreadPoolBenchmark: grain %u, work items %.0f ms, parallelFor %.0f ms",
+         grainSizes[i], items, jobs);
+   }
+
+   for (U32 i = 0; i < count; i++)
+   {
+      if (results[i] != work(i))
+      {
+         ADD_FAILURE() << "result mismatch at " << i;
+         break;
+      }
+   }
+}
+
+TEST_FIX(ThreadPoolBenchmark, ForkJoinOverhead)
+{
+   // Many small parallel loops in a row, as a frame would issue them.
+   const U32 count = 4096;
+   const U32 loops = 500;
+   Vector<F32> results(__FILE__, __LINE__);
+   results.setSize(count);
+
+   WorkRange range(results.address());
+   const U32 start = Platform::getRealMilliseconds();
+   for (U32 i = 0; i < loops; i++)
+      ThreadPool::GLOBAL().parallelFor(0, count, 256, range);
+   const U32 elapsed = Platform::getRealMilliseconds() - start;
+
+   Con::printf("ThreadPoolBenchmark: %u parallelFor calls over %u elements, %.3f ms per call",
+      loops, count, F64(elapsed) / F64(loops));
+
+   EXPECT_EQ(work(count - 1), results[count - 1]);
+}
+
+#endif
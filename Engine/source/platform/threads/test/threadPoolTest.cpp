@@ -25,6 +25,7 @@
 #include "platform/threads/threadPool.h"
 #include "console/console.h"
 #include "core/util/tVector.h"
+#include "core/frameAllocator.h"
 
 FIXTURE(ThreadPool)
 {
@@ -58,6 +59,82 @@ public:
          Platform::sleep(ms);
       }
    };
+
+   // Fills frame allocated scratch memory and checks that no other thread
+   // wrote into it in the meantime.
+   struct ScratchItem : public ThreadPool::WorkItem
+   {
+      U32 mIndex;
+      Vector<U32>& mResults;
+      ScratchItem(U32 index, Vector<U32>& results)
+         : mIndex(index), mResults(results) {}
+
+   protected:
+      virtual void execute()
+      {
+         const U32 count = 1024;
+         FrameTemp<U32> scratch(count);
+         for (U32 i = 0; i < count; i++)
+            scratch[i] = mIndex;
+
+         Platform::sleep(1);
+
+         U32 matches = 0;
+         for (U32 i = 0; i < count; i++)
+            matches += (scratch[i] == mIndex);
+         mResults[mIndex] = matches;
+      }
+   };
+
+   // Counts how often each index of a range was visited.
+   struct VisitRange
+   {
+      Vector<U32>& mVisits;
+      VisitRange(Vector<U32>& visits) : mVisits(visits) {}
+
+      void operator()(U32 begin, U32 end)
+      {
+         for (U32 i = begin; i < end; i++)
+            dFetchAndAdd(mVisits[i], 1);
+      }
+   };
+
+   // Job functions for the dependency test; each stage checks that the
+   // stage before it has completely finished.
+   struct Stages
+   {
+      volatile U32 mFirst;
+      U32 mFirstPad;
+      volatile U32 mSecond;
+      U32 mSecondPad;
+      volatile U32 mOrderErrors;
+      U32 mOrderErrorsPad;
+   };
+
+   static void firstStage(void* data, U32 begin, U32 end)
+   {
+      Platform::sleep(1);
+      dFetchAndAdd(((Stages*)data)->mFirst, end - begin);
+   }
+
+   static void secondStage(void* data, U32 begin, U32 end)
+   {
+      Stages* stages = (Stages*)data;
+      if (dAtomicRead(stages->mFirst) != 64)
+         dFetchAndAdd(stages->mOrderErrors, 1);
+      dFetchAndAdd(stages->mSecond, end - begin);
+   }
+
+   // Forks a parallelFor from inside a job.
+   static void nestedJob(void* data, U32 begin, U32 end)
+   {
+      Vector<U32>& visits = *(Vector<U32>*)data;
+      for (U32 i = begin; i < end; i++)
+      {
+         VisitRange visit(visits);
+         ThreadPool::GLOBAL().parallelFor(i * 100, (i + 1) * 100, 10, visit);
+      }
+   }
 };
 
 TEST_FIX(ThreadPool, BasicAPI)
@@ -85,6 +162,77 @@ TEST_FIX(ThreadPool, BasicAPI)
    results.clear();
 }
 
+TEST_FIX(ThreadPool, FrameAllocatorPerThread)
+{
+   const U32 numItems = 100;
+   Vector<U32> results(__FILE__, __LINE__);
+   results.setSize(numItems);
+
+   const U32 mainWaterMark = FrameAllocator::getWaterMark();
+
+   ThreadPool* pool = &ThreadPool::GLOBAL();
+   for (U32 i = 0; i < numItems; i++)
+   {
+      ThreadSafeRef<ScratchItem> item(new ScratchItem(i, results));
+      pool->queueWorkItem(item);
+   }
+
+   pool->waitForAllItems();
+
+   for (U32 i = 0; i < numItems; i++)
+      EXPECT_EQ(U32(1024), results[i]) << "scratch memory was shared between threads";
+
+   EXPECT_EQ(mainWaterMark, FrameAllocator::getWaterMark())
+      << "work items should not allocate from the main thread's arena";
+}
+
+TEST_FIX(ThreadPool, ParallelFor)
+{
+   const U32 count = 10000;
+   Vector<U32> visits(__FILE__, __LINE__);
+   visits.setSize(count);
+   dMemset(visits.address(), 0, count * sizeof(U32));
+
+   VisitRange visit(visits);
+   ThreadPool::GLOBAL().parallelFor(0, count, 16, visit);
+
+   for (U32 i = 0; i < count; i++)
+      EXPECT_EQ(U32(1), visits[i]) << "every index should be visited exactly once";
+}
+
+TEST_FIX(ThreadPool, NestedJobs)
+{
+   const U32 count = 20;
+   Vector<U32> visits(__FILE__, __LINE__);
+   visits.setSize(count * 100);
+   dMemset(visits.address(), 0, visits.size() * sizeof(U32));
+
+   ThreadPool::GLOBAL().parallelFor(0, count, 1, nestedJob, &visits);
+
+   for (U32 i = 0; i < visits.size(); i++)
+      EXPECT_EQ(U32(1), visits[i]) << "jobs forked from jobs should all run";
+}
+
+TEST_FIX(ThreadPool, JobDependencies)
+{
+   Stages stages;
+   dMemset(&stages, 0, sizeof(stages));
+
+   ThreadPool* pool = &ThreadPool::GLOBAL();
+   ThreadPool::JobCounter first;
+   ThreadPool::JobCounter second;
+
+   pool->queueJob(firstStage, &stages, &first, 0, 64, 4);
+   pool->queueJobAfter(first, secondStage, &stages, &second, 0, 32, 4);
+
+   pool->waitForJobs(second);
+
+   EXPECT_TRUE(first.isDone());
+   EXPECT_EQ(U32(64), stages.mFirst);
+   EXPECT_EQ(U32(32), stages.mSecond);
+   EXPECT_EQ(U32(0), stages.mOrderErrors) << "dependent jobs ran before their dependency finished";
+}
+
 TEST_FIX(ThreadPool, Asynchronous)
 {
    const U32 delay = 500; //ms
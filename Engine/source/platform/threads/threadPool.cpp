@@ -25,6 +25,9 @@
 #include "platform/platformCPUCount.h"
 #include "core/strings/stringFunctions.h"
 #include "core/util/tSingleton.h"
+#include "core/frameAllocator.h"
+#include "platform/platformTLS.h"
+#include "platform/profiler.h"
 
 
 //#define DEBUG_SPEW
@@ -195,10 +198,122 @@ inline F32 ThreadPool::WorkItemWrapper::getPriority()
    return ( item->getContext()->getAccumulatedPriorityBias() * item->getPriority() );
 }
 
+//=============================================================================
+//    ThreadPool::JobDeque.
+//=============================================================================
+
+/// Double-ended queue of jobs.  The owning thread pushes and pops at the
+/// back while other threads steal from the front, so thieves take the
+/// biggest, least recently split ranges.
+///
+/// Accesses are guarded by a spin lock; they are all very short.
+///
+struct ThreadPool::JobDeque
+{
+   /// Jobs; the ones in front of mFront have already been taken.
+   Vector< Job > mJobs;
+   volatile U32 mFront;
+   U32 mFrontPad;
+
+   volatile U32 mLock;
+   U32 mLockPad;
+
+   JobDeque()
+      : mFront( 0 ), mLock( 0 ) {}
+
+   void lock()
+   {
+      while( !dCompareAndSwap( mLock, 0, 1 ) )
+         ;
+   }
+
+   void unlock()
+   {
+      dCompareAndSwap( mLock, 1, 0 );
+   }
+
+   bool isEmpty()
+   {
+      return ( dAtomicRead( mFront ) >= mJobs.size() );
+   }
+
+   void pushBack( const Job& job )
+   {
+      lock();
+      mJobs.push_back( job );
+      unlock();
+   }
+
+   bool popBack( Job& outJob )
+   {
+      lock();
+      const bool haveJob = ( mFront < mJobs.size() );
+      if( haveJob )
+      {
+         outJob = mJobs.last();
+         mJobs.pop_back();
+         if( mFront >= mJobs.size() )
+         {
+            mJobs.clear();
+            mFront = 0;
+         }
+      }
+      unlock();
+      return haveJob;
+   }
+
+   bool stealFront( Job& outJob )
+   {
+      if( isEmpty() )
+         return false;
+
+      lock();
+      const bool haveJob = ( mFront < mJobs.size() );
+      if( haveJob )
+      {
+         outJob = mJobs[ mFront ++ ];
+         if( mFront >= mJobs.size() )
+         {
+            mJobs.clear();
+            mFront = 0;
+         }
+      }
+      unlock();
+      return haveJob;
+   }
+};
+
+//=============================================================================
+//    ThreadPool::JobCounter.
+//=============================================================================
+
+ThreadPool::JobCounter::~JobCounter()
+{
+   AssertFatal( isDone(), "ThreadPool::JobCounter::~JobCounter - destroying counter with jobs in flight" );
+
+   // A thread finishing the last job may still be releasing the lock.
+   lock();
+   unlock();
+}
+
+void ThreadPool::JobCounter::lock()
+{
+   while( !dCompareAndSwap( mLock, 0, 1 ) )
+      ;
+}
+
+void ThreadPool::JobCounter::unlock()
+{
+   dCompareAndSwap( mLock, 1, 0 );
+}
+
 //=============================================================================
 //    ThreadPool::WorkerThread.
 //=============================================================================
 
+/// Worker thread running on the calling thread, if any.
+static ThreadStorage sgCurrentWorkerThread;
+
 ///
 ///
 struct ThreadPool::WorkerThread : public Thread
@@ -206,6 +321,8 @@ struct ThreadPool::WorkerThread : public Thread
    WorkerThread( ThreadPool* pool, U32 index );
 
    WorkerThread*     getNext();
+   ThreadPool*       getPool() const { return mPool; }
+   U32               getIndex() const { return mIndex; }
    virtual void      run( void* arg = 0 );
 
 private:
@@ -250,6 +367,9 @@ void ThreadPool::WorkerThread::run( void* arg )
    XSetThreadProcessor( GetCurrentThread(), sCoreAssignment );
    sCoreAssignment = sCoreAssignment < 6 ? sCoreAssignment + 1 : 2;
 #endif
+
+   sgCurrentWorkerThread.set( this );
+   JobDeque& jobDeque = mPool->mJobDeques[ mIndex ];
       
    while( 1 )
    {
@@ -258,10 +378,16 @@ void ThreadPool::WorkerThread::run( void* arg )
 #ifdef DEBUG_SPEW
          Platform::outputDebugString( "[ThreadPool::WorkerThread] thread '%i' exits", getId() );
 #endif
+         FrameAllocator::destroyThread();
+         sgCurrentWorkerThread.set( NULL );
          dFetchAndAdd( mPool->mNumThreads, ( U32 ) -1 );
          return;
       }
 
+      // Jobs go before work items as somebody is usually waiting on them.
+      if( mPool->runNextJob( jobDeque ) )
+         continue;
+
       // Mark us as potentially blocking.
       dFetchAndAdd( mPool->mNumThreadsReady, ( U32 ) -1 );
 
@@ -293,6 +419,15 @@ void ThreadPool::WorkerThread::run( void* arg )
       {
          dFetchAndAdd( mPool->mNumThreadsAwake, ( U32 ) -1 );
 
+         // Jobs only release the semaphore when a thread is asleep, so
+         // check again now that we are counted as one.
+         if( mPool->hasJobs() )
+         {
+            dFetchAndAdd( mPool->mNumThreadsAwake, 1 );
+            dFetchAndAdd( mPool->mNumThreadsReady, 1 );
+            continue;
+         }
+
 #ifdef DEBUG_SPEW
          Platform::outputDebugString( "[ThreadPool::WorkerThread] thread '%i' going to sleep", getId() );
 #endif
@@ -323,7 +458,9 @@ ThreadPool::ThreadPool( const char* name, U32 numThreads )
      mNumThreadsAwake( 0 ),
      mNumPendingItems( 0 ),
      mThreads( 0 ),
-     mSemaphore( 0 )
+     mSemaphore( 0 ),
+     mJobDeques( NULL ),
+     mNumJobDeques( 0 )
 {
    // Number of worker threads to create.
 
@@ -346,6 +483,11 @@ ThreadPool::ThreadPool( const char* name, U32 numThreads )
    Platform::outputDebugString( "[ThreadPool] spawning %i threads", mNumThreads );
    #endif
 
+   // Create the job deques.
+
+   mNumJobDeques = mNumThreads + 1;
+   mJobDeques = new JobDeque[ mNumJobDeques ];
+
    // Create the threads.
 
    mNumThreadsAwake = mNumThreads;
@@ -362,6 +504,8 @@ ThreadPool::ThreadPool( const char* name, U32 numThreads )
 ThreadPool::~ThreadPool()
 {
 	shutdown();
+
+   delete [] mJobDeques;
 }
 
 //--------------------------------------------------------------------------
@@ -490,3 +634,207 @@ void ThreadPool::processMainThreadWorkItems()
    }
    while( Platform::getRealMilliseconds() < timeLimit );
 }
+
+//=============================================================================
+//    ThreadPool jobs.
+//=============================================================================
+
+ThreadPool::JobDeque& ThreadPool::getLocalJobDeque()
+{
+   WorkerThread* thread = reinterpret_cast< WorkerThread* >( sgCurrentWorkerThread.get() );
+   if( thread && thread->getPool() == this )
+      return mJobDeques[ thread->getIndex() ];
+
+   // Not one of ours; use the shared deque.
+   return mJobDeques[ mNumJobDeques - 1 ];
+}
+
+//--------------------------------------------------------------------------
+
+void ThreadPool::pushJob( JobDeque& deque, const Job& job )
+{
+   deque.pushBack( job );
+
+   // Wake up a worker if there are any asleep.
+   if( dAtomicRead( mNumThreadsAwake ) < dAtomicRead( mNumThreads ) )
+      mSemaphore.release();
+}
+
+//--------------------------------------------------------------------------
+
+bool ThreadPool::hasJobs()
+{
+   for( U32 i = 0; i < mNumJobDeques; ++ i )
+      if( !mJobDeques[ i ].isEmpty() )
+         return true;
+   return false;
+}
+
+//--------------------------------------------------------------------------
+
+bool ThreadPool::runNextJob( JobDeque& deque )
+{
+   Job job;
+   bool haveJob = deque.popBack( job );
+
+   // Try the shared deque first, then steal from the other workers
+   // starting with our neighbour so thieves spread out.
+   if( !haveJob )
+   {
+      const U32 start = U32( &deque - mJobDeques );
+      const U32 shared = mNumJobDeques - 1;
+
+      if( start != shared )
+         haveJob = mJobDeques[ shared ].stealFront( job );
+
+      for( U32 i = 1; i < mNumJobDeques && !haveJob; ++ i )
+      {
+         const U32 index = ( start + i ) % mNumJobDeques;
+         if( index != shared )
+            haveJob = mJobDeques[ index ].stealFront( job );
+      }
+   }
+
+   if( !haveJob )
+      return false;
+
+   executeJob( deque, job );
+   return true;
+}
+
+//--------------------------------------------------------------------------
+
+void ThreadPool::executeJob( JobDeque& deque, Job job )
+{
+   // Fork off the upper halves of the range until what remains is small
+   // enough to run here.  The most recently pushed, smallest halves are
+   // popped back by this thread while others steal the biggest ones.
+
+   while( job.mGrainSize && job.mEnd - job.mBegin > job.mGrainSize )
+   {
+      Job upper = job;
+      upper.mBegin = job.mBegin + ( job.mEnd - job.mBegin ) / 2;
+      job.mEnd = upper.mBegin;
+
+      if( job.mCounter )
+         dFetchAndAdd( job.mCounter->mCount, 1 );
+      pushJob( deque, upper );
+   }
+
+   job.mFunction( job.mData, job.mBegin, job.mEnd );
+
+   if( job.mCounter )
+      finishJob( deque, *job.mCounter );
+}
+
+//--------------------------------------------------------------------------
+
+void ThreadPool::finishJob( JobDeque& deque, JobCounter& counter )
+{
+   // The lock is the last thing touched here; the counter may go out of
+   // scope on the waiting thread as soon as it has been released.
+
+   counter.lock();
+
+   AssertFatal( counter.mCount > 0, "ThreadPool::finishJob - counter underflow" );
+   dFetchAndAdd( counter.mCount, ( U32 ) -1 );
+
+   if( counter.mCount == 0 && !counter.mContinuations.empty() )
+   {
+      for( U32 i = 0; i < counter.mContinuations.size(); ++ i )
+         pushJob( deque, counter.mContinuations[ i ] );
+      counter.mContinuations.clear();
+   }
+
+   counter.unlock();
+}
+
+//--------------------------------------------------------------------------
+
+void ThreadPool::queueJob( JobFunction function, void* data, JobCounter* counter, U32 begin, U32 end, U32 grainSize )
+{
+   AssertFatal( function, "ThreadPool::queueJob - no job function" );
+
+   if( begin >= end )
+      return;
+
+   // Without workers, just run it.
+   if( getForceAllMainThread() || !dAtomicRead( mNumThreads ) )
+   {
+      function( data, begin, end );
+      return;
+   }
+
+   Job job;
+   job.mFunction = function;
+   job.mData = data;
+   job.mBegin = begin;
+   job.mEnd = end;
+   job.mGrainSize = grainSize;
+   job.mCounter = counter;
+
+   if( counter )
+      dFetchAndAdd( counter->mCount, 1 );
+
+   pushJob( getLocalJobDeque(), job );
+}
+
+//--------------------------------------------------------------------------
+
+void ThreadPool::queueJobAfter( JobCounter& dependency, JobFunction function, void* data, JobCounter* counter, U32 begin, U32 end, U32 grainSize )
+{
+   AssertFatal( function, "ThreadPool::queueJobAfter - no job function" );
+   AssertFatal( &dependency != counter, "ThreadPool::queueJobAfter - job cannot depend on its own counter" );
+
+   if( begin >= end )
+      return;
+
+   dependency.lock();
+   if( dependency.mCount == 0 )
+   {
+      dependency.unlock();
+      queueJob( function, data, counter, begin, end, grainSize );
+      return;
+   }
+
+   Job job;
+   job.mFunction = function;
+   job.mData = data;
+   job.mBegin = begin;
+   job.mEnd = end;
+   job.mGrainSize = grainSize;
+   job.mCounter = counter;
+
+   if( counter )
+      dFetchAndAdd( counter->mCount, 1 );
+
+   dependency.mContinuations.push_back( job );
+   dependency.unlock();
+}
+
+//--------------------------------------------------------------------------
+
+void ThreadPool::waitForJobs( JobCounter& counter )
+{
+   PROFILE_SCOPE( ThreadPool_waitForJobs );
+
+   JobDeque& deque = getLocalJobDeque();
+   while( !counter.isDone() )
+   {
+      // Help out.  If there is nothing to take, the remaining jobs are
+      // running on other threads.
+      if( !runNextJob( deque ) )
+         Platform::sleep( 0 );
+   }
+}
+
+//--------------------------------------------------------------------------
+
+void ThreadPool::parallelFor( U32 begin, U32 end, U32 grainSize, JobFunction function, void* data )
+{
+   PROFILE_SCOPE( ThreadPool_parallelFor );
+
+   JobCounter counter;
+   queueJob( function, data, &counter, begin, end, getMax( grainSize, U32( 1 ) ) );
+   waitForJobs( counter );
+}
@@ -35,6 +35,9 @@
 #ifndef _TSINGLETON_H_
    #include "core/util/tSingleton.h"
 #endif
+#ifndef _TVECTOR_H_
+   #include "core/util/tVector.h"
+#endif
 
 
 /// @file
@@ -70,6 +73,22 @@
 ///   automatically being released once the last concurrent work item has been
 ///   processed or discarded.
 ///
+/// Besides work items, the pool runs jobs.  Jobs are small, fire-and-join
+/// units of work meant for splitting a loop over the worker threads.  Each
+/// worker keeps its own deque of jobs and steals from the others when it runs
+/// dry, and a thread waiting on jobs runs them itself in the meantime.  Jobs
+/// always take precedence over queued work items.
+///
+/// @code
+/// struct UpdateObjects
+/// {
+///    void operator()( U32 begin, U32 end ) { ... }
+/// };
+///
+/// UpdateObjects update;
+/// ThreadPool::GLOBAL().parallelFor( 0, objects.size(), 64, update );
+/// @endcode
+///
 class ThreadPool
 {
    public:
@@ -243,11 +262,73 @@ class ThreadPool
 
       typedef ThreadSafeRef< WorkItem > WorkItemPtr;
       struct GlobalThreadPool;
-      
+
+      class JobCounter;
+
+      /// Function run by a job on the index range [begin, end).
+      typedef void ( *JobFunction )( void* data, U32 begin, U32 end );
+
+      /// A job waiting to run.
+      struct Job
+      {
+         JobFunction mFunction;
+         void* mData;
+         U32 mBegin;
+         U32 mEnd;
+
+         /// Ranges larger than this are split in two before running, with
+         /// the upper half left for other threads to take.  0 never splits.
+         U32 mGrainSize;
+
+         /// Counter to decrement when the job has finished; may be NULL.
+         JobCounter* mCounter;
+      };
+
+      /// Tracks a group of jobs.  Queueing a job against a counter
+      /// increments it and the job decrements it once it has finished.
+      /// Jobs may also be held back until a counter drops to zero.
+      ///
+      /// @see waitForJobs
+      /// @see queueJobAfter
+      class JobCounter
+      {
+         public:
+
+            JobCounter()
+               : mCount( 0 ), mLock( 0 ) {}
+
+            ~JobCounter();
+
+            /// Return true if all the jobs of the counter have finished.
+            bool isDone() const
+            {
+               return ( dAtomicRead( mCount ) == 0 );
+            }
+
+         protected:
+
+            friend class ThreadPool;
+
+            /// Number of jobs that have not yet finished.
+            mutable volatile U32 mCount;
+            U32 mCountPad;
+
+            /// Guards mContinuations and the decrement that releases them.
+            volatile U32 mLock;
+            U32 mLockPad;
+
+            /// Jobs to queue once mCount drops to zero.
+            Vector< Job > mContinuations;
+
+            void lock();
+            void unlock();
+      };
+
    protected:
    
       struct WorkItemWrapper;
       struct WorkerThread;
+      struct JobDeque;
 
       friend struct WorkerThread; // mSemaphore, mNumThreadsAwake, mThreads
 
@@ -277,6 +358,39 @@ class ThreadPool
       /// List of worker threads.
       WorkerThread* mThreads;
 
+      /// Job deques; one per worker thread plus a shared one at the end
+      /// for jobs queued from outside the pool.
+      JobDeque* mJobDeques;
+
+      /// Number of entries in mJobDeques.
+      U32 mNumJobDeques;
+
+      /// Return the deque the calling thread should push jobs to.
+      JobDeque& getLocalJobDeque();
+
+      /// Push a job and wake a sleeping worker to take it.
+      void pushJob( JobDeque& deque, const Job& job );
+
+      /// Take a job from the given deque or, failing that, from any other
+      /// and run it.  Return false if there was no job to run.
+      bool runNextJob( JobDeque& deque );
+
+      /// Split and run a job.
+      void executeJob( JobDeque& deque, Job job );
+
+      /// Return true if any deque has jobs waiting.
+      bool hasJobs();
+
+      /// Mark a job of the counter finished and release its continuations
+      /// if it was the last one.
+      void finishJob( JobDeque& deque, JobCounter& counter );
+
+      template< typename Functor >
+      static void _functorJob( void* data, U32 begin, U32 end )
+      {
+         ( *reinterpret_cast< Functor* >( data ) )( begin, end );
+      }
+
       /// Force all work items to execute on main thread;
       /// turns this into a single-threaded system.
       /// Primarily useful to find whether malfunctions are caused
@@ -305,6 +419,9 @@ class ThreadPool
       /// Manually shutdown threads outside of static destructors.
       void shutdown();
 
+      /// Return the number of worker threads in the pool.
+      U32 getNumThreads() const { return mNumThreads; }
+
       ///
       void queueWorkItem( WorkItem* item );
       
@@ -357,6 +474,47 @@ class ThreadPool
       /// @see ThreadPool::getMainThreadThesholdTimeMS
       static void processMainThreadWorkItems();
 
+      /// @name Jobs
+      /// @{
+
+      /// Queue a job on the range [begin, end).
+      ///
+      /// Unlike queueWorkItem, this may be called from any thread including
+      /// the pool's own workers, which lets jobs fork off more jobs.
+      ///
+      /// @param function Function to run.
+      /// @param data Passed through to the function.
+      /// @param counter Counter to track the job with; may be NULL.
+      /// @param grainSize Split ranges larger than this across threads; 0 runs
+      ///   the whole range in one call.
+      void queueJob( JobFunction function, void* data, JobCounter* counter,
+                     U32 begin = 0, U32 end = 1, U32 grainSize = 0 );
+
+      /// Queue a job that runs once all the jobs of the dependency counter
+      /// have finished.  The job is counted on counter right away.
+      void queueJobAfter( JobCounter& dependency, JobFunction function, void* data, JobCounter* counter,
+                          U32 begin = 0, U32 end = 1, U32 grainSize = 0 );
+
+      /// Run jobs until all the jobs of the counter have finished.
+      ///
+      /// The calling thread takes part in the work, so this can be used on
+      /// the main thread as well as from within jobs and work items.
+      void waitForJobs( JobCounter& counter );
+
+      /// Call function on every sub-range of [begin, end), split into runs
+      /// of at most grainSize indices, and wait until all of them are done.
+      void parallelFor( U32 begin, U32 end, U32 grainSize, JobFunction function, void* data );
+
+      /// Call functor( begin, end ) on every sub-range of [begin, end) and wait
+      /// until all of them are done.
+      template< typename Functor >
+      void parallelFor( U32 begin, U32 end, U32 grainSize, Functor& functor )
+      {
+         parallelFor( begin, end, grainSize, &_functorJob< Functor >, &functor );
+      }
+
+      /// @}
+
       /// Return the interval in which item priorities are updated on the queue.
       /// @return update interval in milliseconds.
       U32 getQueueUpdateInterval() const
@@ -94,6 +94,19 @@ U32 Platform::getRealMilliseconds()
    return (U32)((mach_absolute_time() * s_timebase_info.numer) / (oneMillion * s_timebase_info.denom));
 }
 
+U64 Platform::getRealMicroseconds()
+{
+   static mach_timebase_info_data_t s_timebase_info;
+   
+   if (s_timebase_info.denom == 0) {
+      (void) mach_timebase_info(&s_timebase_info);
+   }
+   
+   // mach_absolute_time() returns billionth of seconds,
+   // so divide by one thousand to get microseconds
+   return (mach_absolute_time() / 1000) * s_timebase_info.numer / s_timebase_info.denom;
+}
+
 U32 Platform::getVirtualMilliseconds()
 {
    return sgCurrentTime;   
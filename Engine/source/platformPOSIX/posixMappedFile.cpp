@@ -0,0 +1,81 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "platform/platformMappedFile.h"
+
+//-----------------------------------------------------------------------------
+
+PlatformMappedFile::PlatformMappedFile()
+   : mData( NULL ),
+     mSize( 0 ),
+     mFileHandle( NULL ),
+     mMappingHandle( NULL )
+{
+}
+
+PlatformMappedFile::~PlatformMappedFile()
+{
+   close();
+}
+
+bool PlatformMappedFile::open( const char *path )
+{
+   close();
+
+   int fd = ::open( path, O_RDONLY );
+   if ( fd == -1 )
+      return false;
+
+   struct stat info;
+   if ( fstat( fd, &info ) != 0 || info.st_size <= 0 || (U64)info.st_size > U32_MAX )
+   {
+      ::close( fd );
+      return false;
+   }
+
+   void *data = mmap( NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+   // The mapping keeps its own reference to the file.
+   ::close( fd );
+
+   if ( data == MAP_FAILED )
+      return false;
+
+   mData = (const U8*)data;
+   mSize = (U32)info.st_size;
+   return true;
+}
+
+void PlatformMappedFile::close()
+{
+   if ( !mData )
+      return;
+
+   munmap( (void*)mData, mSize );
+   mData = NULL;
+   mSize = 0;
+}
@@ -0,0 +1,91 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platformMappedFile.h"
+#include "platformWin32/platformWin32.h"
+
+//-----------------------------------------------------------------------------
+
+PlatformMappedFile::PlatformMappedFile()
+   : mData( NULL ),
+     mSize( 0 ),
+     mFileHandle( NULL ),
+     mMappingHandle( NULL )
+{
+}
+
+PlatformMappedFile::~PlatformMappedFile()
+{
+   close();
+}
+
+bool PlatformMappedFile::open( const char *path )
+{
+   close();
+
+   HANDLE file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+   if ( file == INVALID_HANDLE_VALUE )
+      return false;
+
+   LARGE_INTEGER size;
+   if ( !GetFileSizeEx( file, &size ) || size.QuadPart <= 0 || size.QuadPart > U32_MAX )
+   {
+      CloseHandle( file );
+      return false;
+   }
+
+   HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+   if ( mapping == NULL )
+   {
+      CloseHandle( file );
+      return false;
+   }
+
+   const void *data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+   if ( data == NULL )
+   {
+      CloseHandle( mapping );
+      CloseHandle( file );
+      return false;
+   }
+
+   mFileHandle = file;
+   mMappingHandle = mapping;
+   mData = (const U8*)data;
+   mSize = (U32)size.QuadPart;
+   return true;
+}
+
+void PlatformMappedFile::close()
+{
+   if ( !mData )
+      return;
+
+   UnmapViewOfFile( mData );
+   CloseHandle( (HANDLE)mMappingHandle );
+   CloseHandle( (HANDLE)mFileHandle );
+
+   mData = NULL;
+   mSize = 0;
+   mFileHandle = NULL;
+   mMappingHandle = NULL;
+}
@@ -156,6 +156,21 @@ U32 Platform::getRealMilliseconds()
    return GetTickCount();
 }
 
+U64 Platform::getRealMicroseconds()
+{
+   static LARGE_INTEGER sFrequency = { 0 };
+   if ( sFrequency.QuadPart == 0 )
+      QueryPerformanceFrequency( &sFrequency );
+
+   LARGE_INTEGER count;
+   QueryPerformanceCounter( &count );
+
+   // Split the conversion so the multiply does not overflow.
+   const U64 seconds = count.QuadPart / sFrequency.QuadPart;
+   const U64 remainder = count.QuadPart % sFrequency.QuadPart;
+   return seconds * 1000000 + ( remainder * 1000000 ) / sFrequency.QuadPart;
+}
+
 U32 Platform::getVirtualMilliseconds()
 {
    return winState.currentTime;
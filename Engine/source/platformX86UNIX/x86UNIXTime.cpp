@@ -85,6 +85,13 @@ U32 Platform::getRealMilliseconds()
    return x86UNIXGetTickCount();
 }
 
+U64 Platform::getRealMicroseconds()
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (U64)t.tv_sec * 1000000 + (U64)(t.tv_nsec / 1000);
+}
+
 U32 Platform::getVirtualMilliseconds()
 {
    return sgCurrentTime;
@@ -27,19 +27,23 @@
 #include "materials/matInstance.h"
 #include "scene/sceneManager.h"
 #include "console/engineAPI.h"
+#include "platform/profiler.h"
 
 
 IMPLEMENT_CONOBJECT(RenderBinManager);
 
 
 RenderBinManager::RenderBinManager( const RenderInstType& ritype, F32 renderOrder, F32 processAddOrder ) :
-   mRenderInstType( ritype ),
-   mRenderOrder( renderOrder ),
    mProcessAddOrder( processAddOrder ),
+   mRenderOrder( renderOrder ),
+   mSortedCount( 0 ),
+   mSortTime( 0 ),
+   mRenderInstType( ritype ),
    mRenderPass( NULL ),
    mBasicOnly ( false )
 {
    VECTOR_SET_ASSOCIATION( mElementList );
+   VECTOR_SET_ASSOCIATION( mSortScratch );
    mElementList.reserve( 2048 );
 }
 
@@ -138,7 +142,81 @@ void RenderBinManager::clear()
 
 void RenderBinManager::sort()
 {
-   dQsort( mElementList.address(), mElementList.size(), sizeof(MainSortElem), cmpKeyFunc);
+   PROFILE_SCOPE( RenderBinManager_Sort );
+   sortElements( mElementList );
+}
+
+void RenderBinManager::sortElements( Vector< MainSortElem > &list )
+{
+   const U32 count = list.size();
+   mSortedCount += count;
+
+   if ( count < 2 )
+      return;
+
+   MainSortElem *elems = list.address();
+
+   // Short lists are cheaper to insertion sort.
+   if ( count <= 32 )
+   {
+      for ( U32 i = 1; i < count; i++ )
+      {
+         const MainSortElem elem = elems[i];
+         const U64 key = getSortKey( elem );
+
+         U32 j = i;
+         for ( ; j > 0 && getSortKey( elems[j-1] ) > key; j-- )
+            elems[j] = elems[j-1];
+
+         elems[j] = elem;
+      }
+
+      return;
+   }
+
+   // Build the histograms of all eight key bytes in one pass.
+   U32 histograms[8][256];
+   dMemset( histograms, 0, sizeof( histograms ) );
+
+   for ( U32 i = 0; i < count; i++ )
+   {
+      const U64 key = getSortKey( elems[i] );
+      for ( U32 b = 0; b < 8; b++ )
+         histograms[b][ ( key >> ( b * 8 ) ) & 0xFF ]++;
+   }
+
+   mSortScratch.setSize( count );
+   MainSortElem *src = elems;
+   MainSortElem *dst = mSortScratch.address();
+
+   for ( U32 b = 0; b < 8; b++ )
+   {
+      U32 *hist = histograms[b];
+      const U32 shift = b * 8;
+
+      // Skip the byte if every key shares it, which is common
+      // for the exponent bytes of the distance keys.
+      if ( hist[ ( getSortKey( src[0] ) >> shift ) & 0xFF ] == count )
+         continue;
+
+      U32 offset = 0;
+      for ( U32 i = 0; i < 256; i++ )
+      {
+         const U32 bucketSize = hist[i];
+         hist[i] = offset;
+         offset += bucketSize;
+      }
+
+      for ( U32 i = 0; i < count; i++ )
+         dst[ hist[ ( getSortKey( src[i] ) >> shift ) & 0xFF ]++ ] = src[i];
+
+      MainSortElem *temp = src;
+      src = dst;
+      dst = temp;
+   }
+
+   if ( src != elems )
+      dMemcpy( elems, src, count * sizeof( MainSortElem ) );
 }
 
 S32 FN_CDECL RenderBinManager::cmpKeyFunc(const void* p1, const void* p2)
@@ -179,3 +257,15 @@ DefineEngineMethod( RenderBinManager, getBinType, const char*, (),,
 {
    return object->getRenderInstType().getName();
 }
+
+DefineEngineMethod( RenderBinManager, getSortedCount, S32, (),,
+   "Returns the number of render instances sorted by the bin last frame." )
+{
+   return object->getSortedCount();
+}
+
+DefineEngineMethod( RenderBinManager, getSortTime, S32, (),,
+   "Returns the time spent sorting the bin last frame in microseconds." )
+{
+   return object->getSortTime();
+}
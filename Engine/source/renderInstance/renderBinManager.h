@@ -62,7 +62,13 @@ public:
    void onRemove();
 
    virtual void addElement( RenderInst *inst );
+
+   /// Sorts the instances added this frame.
+   ///
+   /// The render pass sorts its bins concurrently on the worker
+   /// threads, so this may only touch the bin's own lists.
    virtual void sort();
+
    virtual void render( SceneRenderState *state ) {}
    virtual void clear();
 
@@ -81,6 +87,12 @@ public:
    /// QSort callback function
    static S32 FN_CDECL cmpKeyFunc(const void* p1, const void* p2);
 
+   /// Returns the number of instances sorted in the last frame.
+   U32 getSortedCount() const { return mSortedCount; }
+
+   /// Returns the time spent in sort() last frame in microseconds.
+   U32 getSortTime() const { return mSortTime; }
+
    DECLARE_CONOBJECT(RenderBinManager);
    static void initPersistFields();
 
@@ -97,6 +109,17 @@ protected:
 
    void setRenderPass( RenderPassManager *rpm );
 
+   /// Returns the 64-bit key sortElements() orders by, which puts
+   /// the primary key in descending and the secondary key in
+   /// ascending order like cmpKeyFunc does.
+   static inline U64 getSortKey( const MainSortElem &elem )
+   {
+      return ( U64( ~elem.key ) << 32 ) | U64( elem.key2 );
+   }
+
+   /// Does a stable radix sort of the list by getSortKey().
+   void sortElements( Vector< MainSortElem > &list );
+
    /// Called from derived bins to add additional
    /// render instance types to be notified about.
    void notifyType( const RenderInstType &type );
@@ -105,6 +128,14 @@ protected:
    F32 mProcessAddOrder;   // Where in the list do we process RenderInstance additions?
    F32 mRenderOrder;       // Where in the list do we render?
 
+   /// The scratch buffer used by sortElements().
+   Vector< MainSortElem > mSortScratch;
+
+   /// The instances sorted and the microseconds spent sorting
+   /// them last frame.
+   U32 mSortedCount;
+   U32 mSortTime;
+
    /// The primary render instance type this bin supports.
    RenderInstType mRenderInstType;
 
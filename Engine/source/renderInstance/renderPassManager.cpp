@@ -40,6 +40,9 @@
 #include "core/util/safeDelete.h"
 #include "math/util/matrixSet.h"
 #include "console/engineAPI.h"
+#include "console/consoleTypes.h"
+#include "core/module.h"
+#include "platform/threads/threadPool.h"
 
 
 const RenderInstType RenderInstType::Invalid( "" );
@@ -103,6 +106,26 @@ void OccluderRenderInst::clear()
 }
 
 
+bool RenderPassManager::smParallelSort = true;
+U32 RenderPassManager::smMinParallelSortElements = 1024;
+
+
+MODULE_BEGIN( RenderPassManager )
+
+   MODULE_INIT
+   {
+      Con::addVariable( "$RenderPass::parallelSort", TypeBool, &RenderPassManager::smParallelSort,
+         "If true, the render bins of a pass are sorted concurrently on the worker threads.\n"
+         "@ingroup RenderBin" );
+
+      Con::addVariable( "$RenderPass::minParallelSortElements", TypeS32, &RenderPassManager::smMinParallelSortElements,
+         "Render passes with fewer render instances than this are sorted on the main thread.\n"
+         "@ingroup RenderBin" );
+   }
+
+MODULE_END;
+
+
 IMPLEMENT_CONOBJECT(RenderPassManager);
 
 
@@ -130,6 +153,7 @@ void RenderPassManager::initPersistFields()
 RenderPassManager::RenderPassManager()
 {   
    mSceneManager = NULL;
+   mSortTime = 0;
    VECTOR_SET_ASSOCIATION( mRenderBins );
 
    mMatrixSet = reinterpret_cast<MatrixSet *>(dMalloc_aligned(sizeof(MatrixSet), 16));
@@ -214,11 +238,41 @@ void RenderPassManager::sort()
 {
    PROFILE_SCOPE( RenderPassManager_Sort );
 
+   const U64 startTime = Platform::getRealMicroseconds();
+
+   // The bins only sort their own lists, so they can be
+   // sorted independently of each other.
+   U32 numElements = 0;
+   U32 numBusyBins = 0;
    for (Vector<RenderBinManager *>::iterator itr = mRenderBins.begin();
       itr != mRenderBins.end(); itr++)
    {
       AssertFatal(*itr, "Render manager invalid!");
-      (*itr)->sort();
+      numElements += (*itr)->mElementList.size();
+      if ( (*itr)->mElementList.size() > 1 )
+         numBusyBins++;
+   }
+
+   if ( smParallelSort && numBusyBins > 1 && numElements >= smMinParallelSortElements )
+      ThreadPool::GLOBAL().parallelFor( 0, mRenderBins.size(), 1, &_sortBinsJob, mRenderBins.address() );
+   else
+      _sortBinsJob( mRenderBins.address(), 0, mRenderBins.size() );
+
+   mSortTime = U32( Platform::getRealMicroseconds() - startTime );
+}
+
+void RenderPassManager::_sortBinsJob( void *data, U32 begin, U32 end )
+{
+   RenderBinManager **bins = reinterpret_cast< RenderBinManager** >( data );
+
+   for ( U32 i = begin; i < end; i++ )
+   {
+      RenderBinManager *bin = bins[i];
+      const U64 startTime = Platform::getRealMicroseconds();
+
+      bin->mSortedCount = 0;
+      bin->sort();
+      bin->mSortTime = U32( Platform::getRealMicroseconds() - startTime );
    }
 }
 
@@ -365,3 +419,21 @@ DefineEngineMethod( RenderPassManager, removeManager, void, ( RenderBinManager *
       object->removeManager( renderBin );
 }
 
+
+DefineEngineMethod( RenderPassManager, getSortTime, S32, (),,
+   "Returns the time spent sorting the render bins last frame in microseconds." )
+{
+   return object->getSortTime();
+}
+
+DefineEngineMethod( RenderPassManager, dumpSortStats, void, (),,
+   "Prints the instance count and sort time of each render bin from the last frame to the console." )
+{
+   Con::printf( "RenderPassManager %s - sorted in %d us", object->getIdString(), object->getSortTime() );
+
+   for ( U32 i = 0; i < object->getManagerCount(); i++ )
+   {
+      RenderBinManager *bin = object->getManager( i );
+      Con::printf( "   %-24s %6d instances %6d us", bin->getRenderInstType().getName(), bin->getSortedCount(), bin->getSortTime() );
+   }
+}
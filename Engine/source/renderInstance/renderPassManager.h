@@ -168,6 +168,16 @@ public:
    /// Sorts the list of RenderInst's per bin. (Normally, one should just call renderPass)
    void sort();
 
+   /// If true the bins are sorted concurrently on the worker threads.
+   static bool smParallelSort;
+
+   /// Passes with fewer render instances than this are sorted
+   /// on the main thread.
+   static U32 smMinParallelSortElements;
+
+   /// Returns the time spent sorting the bins last frame in microseconds.
+   U32 getSortTime() const { return mSortTime; }
+
    /// Renders the list of RenderInsts (Normally, one should just call renderPass)
    void render( SceneRenderState *state );
 
@@ -256,6 +266,12 @@ protected:
    GFXTexHandle mDepthBuff;
    MatrixSet *mMatrixSet;
 
+   /// The time spent in sort() last frame in microseconds.
+   U32 mSortTime;
+
+   /// Sorts the bins in the range, timing each of them.
+   static void _sortBinsJob( void *data, U32 begin, U32 end );
+
    /// Do a sorted insert into a vector, renderOrder bool controls which test we run for insertion.
    void _insertSort(Vector<RenderBinManager*>& list, RenderBinManager* mgr, bool renderOrder);
 };
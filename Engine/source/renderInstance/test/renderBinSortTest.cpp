@@ -0,0 +1,124 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "renderInstance/renderBinManager.h"
+#include "renderInstance/renderPassManager.h"
+#include "math/mRandom.h"
+
+/// Exposes the protected sort of the bin to the tests.
+class TestSortBin : public RenderBinManager
+{
+public:
+   typedef RenderBinManager::MainSortElem Elem;
+
+   void sortList( Vector< Elem > &list ) { sortElements( list ); }
+};
+
+FIXTURE(RenderBinSort)
+{
+public:
+   MRandomLCG mRandom;
+   TestSortBin mBin;
+
+   /// Backs the inst pointers so the tests can recover the
+   /// original position of each element.
+   Vector<RenderInst> mInsts;
+
+   virtual void SetUp()
+   {
+      mRandom.setSeed(1376312589);
+   }
+
+   /// Fills the list with keys drawn from a small range so that many
+   /// elements share a key and only differ by key2, and some share both.
+   ///
+   /// The keys stay below 2^30 since cmpKeyFunc compares by signed
+   /// subtraction and would overflow on the full U32 range.
+   void populate(Vector<TestSortBin::Elem> &list, U32 count, U32 keyRange, U32 key2Range)
+   {
+      mInsts.setSize(count);
+      list.setSize(count);
+
+      for (U32 i = 0; i < count; i++)
+      {
+         list[i].inst = &mInsts[i];
+         list[i].key = mRandom.randI(0, keyRange) * ((1 << 30) / (keyRange + 1));
+         list[i].key2 = mRandom.randI(0, key2Range);
+      }
+   }
+
+   void checkMatchesQsort(U32 count, U32 keyRange, U32 key2Range)
+   {
+      Vector<TestSortBin::Elem> radix;
+      populate(radix, count, keyRange, key2Range);
+
+      Vector<TestSortBin::Elem> reference(radix);
+      dQsort(reference.address(), reference.size(), sizeof(TestSortBin::Elem), RenderBinManager::cmpKeyFunc);
+
+      mBin.sortList(radix);
+      ASSERT_EQ(reference.size(), radix.size());
+
+      for (U32 i = 0; i < count; i++)
+      {
+         EXPECT_EQ(reference[i].key, radix[i].key) << "Key mismatch at " << i;
+         EXPECT_EQ(reference[i].key2, radix[i].key2) << "Key2 mismatch at " << i;
+      }
+
+      // dQsort is not stable, so the order of fully equal elements
+      // is only checked against the original order.
+      for (U32 i = 1; i < count; i++)
+      {
+         if (radix[i-1].key == radix[i].key && radix[i-1].key2 == radix[i].key2)
+         {
+            EXPECT_LT(radix[i-1].inst, radix[i].inst) << "Unstable at " << i;
+         }
+      }
+   }
+};
+
+TEST_FIX(RenderBinSort, InsertionMatchesQsort)
+{
+   // Short lists take the insertion sort path.
+   checkMatchesQsort(2, 3, 3);
+   checkMatchesQsort(17, 3, 3);
+   checkMatchesQsort(32, 4, 8);
+}
+
+TEST_FIX(RenderBinSort, RadixMatchesQsort)
+{
+   checkMatchesQsort(33, 3, 3);
+   checkMatchesQsort(1000, 8, 16);
+   checkMatchesQsort(5000, 200, 100000);
+}
+
+TEST_FIX(RenderBinSort, EqualKeysSortByKey2)
+{
+   // A single key forces the whole order onto key2.
+   checkMatchesQsort(500, 0, 1000);
+   checkMatchesQsort(500, 0, 0);
+}
+
+#endif
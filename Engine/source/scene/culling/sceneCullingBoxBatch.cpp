@@ -0,0 +1,192 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "platform/platform.h"
+#include "scene/culling/sceneCullingBoxBatch.h"
+
+#if defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )
+#include <xmmintrin.h>
+#endif
+
+
+namespace
+{
+   /// The distance PlaneF::whichSide() treats as lying on the plane.
+   const F32 SideEpsilon = 0.005f;
+}
+
+
+//-----------------------------------------------------------------------------
+
+SceneCullingBoxBatch::SceneCullingBoxBatch()
+   : mMinX( NULL ),
+     mMinY( NULL ),
+     mMinZ( NULL ),
+     mMaxX( NULL ),
+     mMaxY( NULL ),
+     mMaxZ( NULL ),
+     mSize( 0 ),
+     mCapacity( 0 )
+{
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneCullingBoxBatch::setStorage( F32* storage, U32 capacity )
+{
+   mMinX = storage;
+   mMinY = mMinX + capacity;
+   mMinZ = mMinY + capacity;
+   mMaxX = mMinZ + capacity;
+   mMaxY = mMaxX + capacity;
+   mMaxZ = mMaxY + capacity;
+
+   mSize = 0;
+   mCapacity = capacity;
+}
+
+//-----------------------------------------------------------------------------
+
+U32 SceneCullingBoxBatch::push( const Box3F& box )
+{
+   AssertFatal( mSize < mCapacity, "SceneCullingBoxBatch::push - Batch is full!" );
+
+   mMinX[ mSize ] = box.minExtents.x;
+   mMinY[ mSize ] = box.minExtents.y;
+   mMinZ[ mSize ] = box.minExtents.z;
+   mMaxX[ mSize ] = box.maxExtents.x;
+   mMaxY[ mSize ] = box.maxExtents.y;
+   mMaxZ[ mSize ] = box.maxExtents.z;
+
+   return mSize ++;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneCullingBoxBatch::pad()
+{
+   if( !mSize )
+      return;
+
+   AssertFatal( ( mSize + GroupSize - 1 ) / GroupSize * GroupSize <= mCapacity,
+      "SceneCullingBoxBatch::pad - No room for the padding!" );
+
+   const U32 last = mSize - 1;
+   for( ; mSize % GroupSize; ++ mSize )
+   {
+      mMinX[ mSize ] = mMinX[ last ];
+      mMinY[ mSize ] = mMinY[ last ];
+      mMinZ[ mSize ] = mMinZ[ last ];
+      mMaxX[ mSize ] = mMaxX[ last ];
+      mMaxY[ mSize ] = mMaxY[ last ];
+      mMaxZ[ mSize ] = mMaxZ[ last ];
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+U32 SceneCullingBoxBatch::getOutsideMask( U32 group, const PlaneF* planes, U32 numPlanes ) const
+{
+   AssertFatal( ( group + 1 ) * GroupSize <= size(), "SceneCullingBoxBatch::getOutsideMask - Group out of range; forgot to pad()?" );
+
+   const U32 first = group * GroupSize;
+   U32 outside = 0;
+
+   // A box is behind the plane if the corner farthest along the
+   // plane normal is.  Stop once all boxes are outside.
+
+   for( U32 i = 0; i < numPlanes && outside != GroupMask; ++ i )
+   {
+      const PlaneF& plane = planes[ i ];
+
+      const F32* xs = ( ( plane.x > 0.0f ) ? mMaxX : mMinX ) + first;
+      const F32* ys = ( ( plane.y > 0.0f ) ? mMaxY : mMinY ) + first;
+      const F32* zs = ( ( plane.z > 0.0f ) ? mMaxZ : mMinZ ) + first;
+
+#if defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )
+
+      // Same operation order as PlaneF::distToPlane() so that the
+      // results match the scalar tests exactly.
+      __m128 dist = _mm_mul_ps( _mm_set1_ps( plane.x ), _mm_loadu_ps( xs ) );
+      dist = _mm_add_ps( dist, _mm_mul_ps( _mm_set1_ps( plane.y ), _mm_loadu_ps( ys ) ) );
+      dist = _mm_add_ps( dist, _mm_mul_ps( _mm_set1_ps( plane.z ), _mm_loadu_ps( zs ) ) );
+      dist = _mm_add_ps( dist, _mm_set1_ps( plane.d ) );
+
+      outside |= U32( _mm_movemask_ps( _mm_cmple_ps( dist, _mm_set1_ps( - SideEpsilon ) ) ) );
+
+#else
+
+      for( U32 n = 0; n < GroupSize; ++ n )
+      {
+         if( plane.distToPlane( Point3F( xs[ n ], ys[ n ], zs[ n ] ) ) <= - SideEpsilon )
+            outside |= 1 << n;
+      }
+
+#endif
+   }
+
+   return outside;
+}
+
+//-----------------------------------------------------------------------------
+
+U32 SceneCullingBoxBatch::getContainedMask( U32 group, const PlaneF* planes, U32 numPlanes ) const
+{
+   AssertFatal( ( group + 1 ) * GroupSize <= size(), "SceneCullingBoxBatch::getContainedMask - Group out of range; forgot to pad()?" );
+
+   const U32 first = group * GroupSize;
+   U32 contained = GroupMask;
+
+   // A box is in front of the plane if the corner farthest against
+   // the plane normal is.  Stop once no box is contained.
+
+   for( U32 i = 0; i < numPlanes && contained != 0; ++ i )
+   {
+      const PlaneF& plane = planes[ i ];
+
+      const F32* xs = ( ( plane.x > 0.0f ) ? mMinX : mMaxX ) + first;
+      const F32* ys = ( ( plane.y > 0.0f ) ? mMinY : mMaxY ) + first;
+      const F32* zs = ( ( plane.z > 0.0f ) ? mMinZ : mMaxZ ) + first;
+
+#if defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )
+
+      __m128 dist = _mm_mul_ps( _mm_set1_ps( plane.x ), _mm_loadu_ps( xs ) );
+      dist = _mm_add_ps( dist, _mm_mul_ps( _mm_set1_ps( plane.y ), _mm_loadu_ps( ys ) ) );
+      dist = _mm_add_ps( dist, _mm_mul_ps( _mm_set1_ps( plane.z ), _mm_loadu_ps( zs ) ) );
+      dist = _mm_add_ps( dist, _mm_set1_ps( plane.d ) );
+
+      contained &= U32( _mm_movemask_ps( _mm_cmpge_ps( dist, _mm_set1_ps( SideEpsilon ) ) ) );
+
+#else
+
+      for( U32 n = 0; n < GroupSize; ++ n )
+      {
+         if( plane.distToPlane( Point3F( xs[ n ], ys[ n ], zs[ n ] ) ) < SideEpsilon )
+            contained &= ~( 1 << n );
+      }
+
+#endif
+   }
+
+   return contained;
+}
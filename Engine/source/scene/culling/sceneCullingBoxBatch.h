@@ -0,0 +1,116 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _SCENECULLINGBOXBATCH_H_
+#define _SCENECULLINGBOXBATCH_H_
+
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+
+#ifndef _MPLANE_H_
+#include "math/mPlane.h"
+#endif
+
+
+
+/// A list of AABBs stored as structure-of-arrays so that a plane can be
+/// tested against a group of boxes at once.
+///
+/// Boxes are tested in groups of #GroupSize.  The results are bit masks with
+/// one bit per box of the group.  The tests give the same results as
+/// PlaneF::whichSide() on each box.
+///
+/// The batch does not own its memory.  The caller hands it a block of
+/// getStorageSize() floats with setStorage() so that the boxes of a
+/// frame can live in FrameAllocator memory.
+///
+/// @note After adding boxes, call pad() before running any tests.
+class SceneCullingBoxBatch
+{
+   public:
+
+      enum
+      {
+         /// Number of boxes tested together.
+         GroupSize = 4,
+
+         /// Mask with a bit set for every box in a group.
+         GroupMask = ( 1 << GroupSize ) - 1
+      };
+
+   protected:
+
+      F32* mMinX;
+      F32* mMinY;
+      F32* mMinZ;
+      F32* mMaxX;
+      F32* mMaxY;
+      F32* mMaxZ;
+
+      U32 mSize;
+      U32 mCapacity;
+
+   public:
+
+      SceneCullingBoxBatch();
+
+      /// Return the number of floats of storage needed for @a capacity boxes.
+      static U32 getStorageSize( U32 capacity ) { return capacity * 6; }
+
+      /// Set the memory the boxes are stored in and remove all boxes.
+      ///
+      /// @param storage Block of getStorageSize( @a capacity ) floats.  It must
+      ///   stay valid for as long as the batch is used.
+      /// @param capacity Maximum number of boxes including the padding.
+      void setStorage( F32* storage, U32 capacity );
+
+      /// Remove all boxes.
+      void clear() { mSize = 0; }
+
+      /// Add a box and return its index.
+      U32 push( const Box3F& box );
+
+      /// Fill the last group up with copies of the last box.  If the batch is
+      /// empty, nothing is added.
+      void pad();
+
+      /// Return the number of boxes including the padding.
+      U32 size() const { return mSize; }
+
+      /// Return the maximum number of boxes.
+      U32 getCapacity() const { return mCapacity; }
+
+      /// Return the number of groups.
+      U32 getNumGroups() const { return ( size() + GroupSize - 1 ) / GroupSize; }
+
+      /// Return a bit for each box of the group that lies on the back side
+      /// of any of the given planes.
+      U32 getOutsideMask( U32 group, const PlaneF* planes, U32 numPlanes ) const;
+
+      /// Return a bit for each box of the group that lies on the front side
+      /// of all of the given planes.
+      U32 getContainedMask( U32 group, const PlaneF* planes, U32 numPlanes ) const;
+};
+
+#endif // !_SCENECULLINGBOXBATCH_H_
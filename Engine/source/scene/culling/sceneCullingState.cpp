@@ -23,6 +23,7 @@
 #include "platform/platform.h"
 #include "scene/culling/sceneCullingState.h"
 
+#include "scene/culling/sceneCullingBoxBatch.h"
 #include "scene/sceneManager.h"
 #include "scene/sceneObject.h"
 #include "scene/zones/sceneZoneSpace.h"
@@ -30,7 +31,9 @@
 #include "platform/profiler.h"
 #include "terrain/terrData.h"
 #include "util/tempAlloc.h"
+#include "core/frameAllocator.h"
 #include "gfx/sim/debugDraw.h"
+#include "platform/threads/threadPool.h"
 
 
 extern bool gEditingMission;
@@ -41,6 +44,10 @@ bool SceneCullingState::smDisableZoneCulling = false;
 U32 SceneCullingState::smMaxOccludersPerZone = 4;
 F32 SceneCullingState::smOccluderMinWidthPercentage = 0.1f;
 F32 SceneCullingState::smOccluderMinHeightPercentage = 0.1f;
+bool SceneCullingState::smBatchCulling = true;
+U32 SceneCullingState::smMinBatchCullObjects = 64;
+U32 SceneCullingState::smMinParallelCullObjects = 2048;
+U32 SceneCullingState::smBoxesPerCullJob = 256;
 
 
 
@@ -712,6 +719,16 @@ U32 SceneCullingState::cullObjects( SceneObject** objects, U32 numObjects, U32 c
 {
    PROFILE_SCOPE( SceneCullingState_cullObjects );
 
+   if( smBatchCulling && numObjects >= smMinBatchCullObjects )
+      return _cullObjectsBatched( objects, numObjects, cullOptions );
+
+   return _cullObjects( objects, numObjects, cullOptions );
+}
+
+//-----------------------------------------------------------------------------
+
+U32 SceneCullingState::_cullObjects( SceneObject** objects, U32 numObjects, U32 cullOptions ) const
+{
    U32 numRemainingObjects = 0;
 
    // We test near and far planes separately in order to not do the tests
@@ -798,6 +815,368 @@ U32 SceneCullingState::cullObjects( SceneObject** objects, U32 numObjects, U32 c
 
 //-----------------------------------------------------------------------------
 
+/// The boxes and tests of a batched cullObjects() call.
+struct SceneCullingState::CullBatch
+{
+   /// Tests run on a segment of the boxes.
+   enum Test
+   {
+      /// Only test the extra culling planes.
+      TestExtraPlanes,
+
+      /// Test against the root culling frustum.
+      TestFrustum,
+
+      /// Test against the culling volumes of a single zone.
+      TestZone,
+
+      /// Test each object against the volumes of all its zones.
+      TestZones
+   };
+
+   /// A run of groups that all get the same test.
+   struct Segment
+   {
+      Test test;
+      U32 zone;
+   };
+
+   const SceneCullingState* state;
+   SceneObject** objects;
+
+   SceneCullingBoxBatch boxes;
+
+   /// Index of the object of each box or U32_MAX for padding.
+   U32* boxObjects;
+
+   /// Index of the segment of each group.
+   U32* groupSegments;
+
+   Segment* segments;
+
+   /// Mask of the culled boxes of each group.
+   U8* groupCulled;
+
+   const PlaneF* frustumPlanes;
+   PlaneF nearPlane;
+   PlaneF farPlane;
+};
+
+//-----------------------------------------------------------------------------
+
+U32 SceneCullingState::_cullObjectsBatched( SceneObject** objects, U32 numObjects, U32 cullOptions ) const
+{
+   PROFILE_SCOPE( SceneCullingState_cullObjectsBatched );
+
+   // Objects are bucketed by the test they need.  Objects in a single
+   // zone get a bucket per zone so that a group of boxes always shares
+   // the same culling volumes.
+
+   enum
+   {
+      KeyExtraPlanes,
+      KeyFrustum,
+      KeyZones,
+      KeyFirstZone,
+
+      KeyCulled = U32_MAX
+   };
+
+   const bool zoneCulling = !disableZoneCulling();
+   const U32 numZones = mZoneStates.size();
+   const U32 numKeys = KeyFirstZone + ( zoneCulling ? numZones : 0 );
+
+   // All the scratch memory comes off the FrameAllocator, which
+   // can't hand out empty blocks.
+
+   if( !numObjects )
+      return 0;
+
+   FrameTemp< U32 > objectKeys( numObjects );
+   FrameTemp< U32 > objectBoxes( numObjects );
+
+   FrameTemp< U32 > keyCounts( numKeys );
+   FrameTemp< U32 > keyEnds( numKeys );
+   dMemset( keyCounts.address(), 0, numKeys * sizeof( U32 ) );
+
+   PROFILE_START( SceneCullingState_cullObjectsBatched_classify );
+
+   for( U32 i = 0; i < numObjects; ++ i )
+   {
+      SceneObject* object = objects[ i ];
+      U32 key;
+
+      // Same order of checks as _cullObjects() except that terrain
+      // occlusion is deferred until after the box tests.  It is the
+      // most expensive test and only ever culls more objects.
+
+      if( !( cullOptions & CullEditorOverrides ) &&
+          gEditingMission &&
+          ( ( object->isCullingDisabledInEditor() && object->isRenderEnabled() ) || object->isSelected() ) )
+         key = KeyExtraPlanes;
+      else if( !( cullOptions & DontCullRenderDisabled ) &&
+               !object->isRenderEnabled() )
+         key = KeyCulled;
+      else if( object->isGlobalBounds() )
+         key = KeyExtraPlanes;
+      else if( !( object->getTypeMask() & CULLING_INCLUDE_TYPEMASK ) ||
+               ( object->getTypeMask() & CULLING_EXCLUDE_TYPEMASK ) ||
+               !zoneCulling )
+         key = KeyFrustum;
+      else
+      {
+         // An object that is not in any zone can't be visible.
+
+         SceneObject::ObjectZonesIterator iter( object );
+         if( !iter.isValid() )
+            key = KeyCulled;
+         else
+         {
+            const U32 zone = *iter;
+            AssertFatal( zone < numZones, "SceneCullingState::_cullObjectsBatched - Zone out of range!" );
+
+            ++ iter;
+            key = iter.isValid() ? KeyZones : KeyFirstZone + zone;
+         }
+      }
+
+      objectKeys[ i ] = key;
+      if( key != KeyCulled )
+         keyCounts[ key ] ++;
+   }
+
+   // Sort the object indices by key.
+
+   U32 numTested = 0;
+   for( U32 i = 0; i < numKeys; ++ i )
+   {
+      keyEnds[ i ] = numTested;
+      numTested += keyCounts[ i ];
+   }
+
+   FrameTemp< U32 > order( getMax( numTested, 1U ) );
+
+   for( U32 i = 0; i < numObjects; ++ i )
+   {
+      if( objectKeys[ i ] != KeyCulled )
+         order[ keyEnds[ objectKeys[ i ] ] ++ ] = i;
+   }
+
+   // Gather the boxes with every bucket starting on a new group.  The
+   // padding adds less than a group per bucket.
+
+   const U32 maxBoxes = numTested + numKeys * SceneCullingBoxBatch::GroupSize;
+   const U32 maxGroups = maxBoxes / SceneCullingBoxBatch::GroupSize;
+
+   FrameTemp< F32 > boxStorage( SceneCullingBoxBatch::getStorageSize( maxBoxes ) );
+   FrameTemp< U32 > boxObjects( maxBoxes );
+   FrameTemp< U32 > groupSegments( maxGroups );
+   FrameTemp< CullBatch::Segment > segments( numKeys );
+   FrameTemp< U8 > groupCulled( maxGroups );
+
+   CullBatch batch;
+   batch.state = this;
+   batch.objects = objects;
+   batch.boxes.setStorage( boxStorage, maxBoxes );
+   batch.boxObjects = boxObjects;
+   batch.groupSegments = groupSegments;
+   batch.segments = segments;
+   batch.groupCulled = groupCulled;
+
+   U32 numBoxes = 0;
+   U32 numSegmentGroups = 0;
+   U32 numSegments = 0;
+
+   for( U32 key = 0, start = 0; key < numKeys; start = keyEnds[ key ], ++ key )
+   {
+      if( !keyCounts[ key ] )
+         continue;
+
+      CullBatch::Segment segment;
+      segment.zone = 0;
+
+      if( key == KeyExtraPlanes )
+         segment.test = CullBatch::TestExtraPlanes;
+      else if( key == KeyFrustum )
+         segment.test = CullBatch::TestFrustum;
+      else if( key == KeyZones )
+         segment.test = CullBatch::TestZones;
+      else
+      {
+         segment.test = CullBatch::TestZone;
+         segment.zone = key - KeyFirstZone;
+      }
+
+      for( U32 i = start; i < keyEnds[ key ]; ++ i )
+      {
+         objectBoxes[ order[ i ] ] = batch.boxes.push( objects[ order[ i ] ]->getWorldBox() );
+         batch.boxObjects[ numBoxes ++ ] = order[ i ];
+      }
+
+      batch.boxes.pad();
+      while( numBoxes < batch.boxes.size() )
+         batch.boxObjects[ numBoxes ++ ] = U32_MAX;
+
+      while( numSegmentGroups < batch.boxes.getNumGroups() )
+         batch.groupSegments[ numSegmentGroups ++ ] = numSegments;
+
+      batch.segments[ numSegments ++ ] = segment;
+   }
+
+   PROFILE_END();
+
+   // Do the lazy updates of the frustum and the zone volume
+   // lists now so that the jobs only read them.
+
+   batch.frustumPlanes = getCullingFrustum().getPlanes();
+   batch.nearPlane = batch.frustumPlanes[ Frustum::PlaneNear ];
+   batch.farPlane = batch.frustumPlanes[ Frustum::PlaneFar ];
+
+   if( zoneCulling )
+   {
+      for( U32 i = 0; i < numZones; ++ i )
+      {
+         const SceneZoneCullingState& zoneState = mZoneStates[ i ];
+         if( zoneState.mCullingVolumes && !zoneState.mHaveSortedVolumes )
+            zoneState._sortVolumes();
+      }
+   }
+
+   // Run the box tests.
+
+   const U32 numGroups = batch.boxes.getNumGroups();
+
+   if( numObjects >= smMinParallelCullObjects )
+   {
+      const U32 groupsPerJob = getMax( smBoxesPerCullJob / SceneCullingBoxBatch::GroupSize, 1U );
+      ThreadPool::GLOBAL().parallelFor( 0, numGroups, groupsPerJob, &_cullBatchJob, &batch );
+   }
+   else
+      _cullBatchJob( &batch, 0, numGroups );
+
+   // Compact the list, keeping the original order.
+
+   PROFILE_START( SceneCullingState_cullObjectsBatched_compact );
+
+   U32 numRemainingObjects = 0;
+
+   for( U32 i = 0; i < numObjects; ++ i )
+   {
+      SceneObject* object = objects[ i ];
+      const U32 key = objectKeys[ i ];
+
+      if( key == KeyCulled )
+         continue;
+
+      const U32 box = objectBoxes[ i ];
+      if( batch.groupCulled[ box / SceneCullingBoxBatch::GroupSize ] & BIT( box % SceneCullingBoxBatch::GroupSize ) )
+         continue;
+
+      if( key != KeyExtraPlanes &&
+          !mDisableTerrainOcclusion &&
+          object->getWorldBox().minExtents.x > -1e5 &&
+          isOccludedByTerrain( object ) )
+         continue;
+
+      objects[ numRemainingObjects ++ ] = object;
+   }
+
+   PROFILE_END();
+
+   return numRemainingObjects;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneCullingState::_cullBatchJob( void* data, U32 begin, U32 end )
+{
+   CullBatch* batch = reinterpret_cast< CullBatch* >( data );
+   const SceneCullingState* state = batch->state;
+   const SceneCullingBoxBatch& boxes = batch->boxes;
+   const PlaneSetF& extraPlanes = state->mExtraPlanesCull;
+
+   for( U32 group = begin; group < end; ++ group )
+   {
+      const CullBatch::Segment& segment = batch->segments[ batch->groupSegments[ group ] ];
+
+      U32 culled = boxes.getOutsideMask( group, extraPlanes.getPlanes(), extraPlanes.getNumPlanes() );
+
+      switch( segment.test )
+      {
+         case CullBatch::TestExtraPlanes:
+            break;
+
+         case CullBatch::TestFrustum:
+            culled |= boxes.getOutsideMask( group, batch->frustumPlanes, Frustum::PlaneCount );
+            break;
+
+         case CullBatch::TestZone:
+         {
+            const SceneZoneCullingState& zoneState = state->getZoneState( segment.zone );
+            if( !zoneState.hasIncluders() )
+            {
+               culled = SceneCullingBoxBatch::GroupMask;
+               break;
+            }
+
+            const PlaneF nearFar[ 2 ] = { batch->nearPlane, batch->farPlane };
+            culled |= boxes.getOutsideMask( group, nearFar, 2 );
+
+            // Walk the volumes like SceneZoneCullingState::testVolumes() does
+            // for each box.  The first volume that accepts a box decides it.
+
+            U32 undecided = ~culled & SceneCullingBoxBatch::GroupMask;
+
+            for( SceneZoneCullingState::CullingVolumeLink* link = zoneState.mCullingVolumes;
+                 link != NULL && undecided != 0; link = link->mNext )
+            {
+               const SceneCullingVolume& volume = link->mVolume;
+               const PlaneSetF& planes = volume.getPlanes();
+
+               if( volume.isOccluder() )
+               {
+                  const U32 occluded = undecided & boxes.getContainedMask( group, planes.getPlanes(), planes.getNumPlanes() );
+                  culled |= occluded;
+                  undecided &= ~occluded;
+               }
+               else
+                  undecided &= boxes.getOutsideMask( group, planes.getPlanes(), planes.getNumPlanes() );
+            }
+
+            culled |= undecided;
+            break;
+         }
+
+         case CullBatch::TestZones:
+         {
+            for( U32 n = 0; n < SceneCullingBoxBatch::GroupSize; ++ n )
+            {
+               const U32 objectIndex = batch->boxObjects[ group * SceneCullingBoxBatch::GroupSize + n ];
+               if( objectIndex == U32_MAX || ( culled & BIT( n ) ) )
+                  continue;
+
+               SceneObject* object = batch->objects[ objectIndex ];
+               CullingTestResult result = state->_test(
+                  object->getWorldBox(),
+                  SceneObject::ObjectZonesIterator( object ),
+                  batch->nearPlane,
+                  batch->farPlane
+               );
+
+               if( result == SceneZoneCullingState::CullingTestNegative ||
+                   result == SceneZoneCullingState::CullingTestPositiveByOcclusion )
+                  culled |= BIT( n );
+            }
+            break;
+         }
+      }
+
+      batch->groupCulled[ group ] = U8( culled );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
 bool SceneCullingState::isOccludedByTerrain( SceneObject* object ) const
 {
    PROFILE_SCOPE( SceneCullingState_isOccludedByTerrain );
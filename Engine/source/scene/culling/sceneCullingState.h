@@ -92,6 +92,26 @@ class SceneCullingState
 
       /// @}
 
+      /// @name Batch Culling
+      /// Large object lists are culled by testing their world boxes in
+      /// groups with SceneCullingBoxBatch.
+      /// @{
+
+      /// Whether cullObjects() may use the batched tests.
+      static bool smBatchCulling;
+
+      /// Object lists shorter than this are culled one object at a time.
+      static U32 smMinBatchCullObjects;
+
+      /// Object lists at least this long have their box tests split
+      /// across the worker threads.
+      static U32 smMinParallelCullObjects;
+
+      /// The number of boxes tested by each culling job.
+      static U32 smBoxesPerCullJob;
+
+      /// @}
+
    protected:
 
       /// Scene which is being culled.
@@ -323,6 +343,18 @@ class SceneCullingState
 
       typedef SceneZoneCullingState::CullingTestResult CullingTestResult;
 
+      struct CullBatch;
+
+      /// Cull the objects one at a time.
+      U32 _cullObjects( SceneObject** objects, U32 numObjects, U32 cullOptions ) const;
+
+      /// Cull the objects by testing their boxes in groups.  The scratch
+      /// lists are allocated off the calling thread's FrameAllocator.
+      U32 _cullObjectsBatched( SceneObject** objects, U32 numObjects, U32 cullOptions ) const;
+
+      /// Run the box tests for the given range of groups of a CullBatch.
+      static void _cullBatchJob( void* data, U32 begin, U32 end );
+
       // Helper methods to avoid code duplication.
 
       template< bool OCCLUDERS_ONLY, typename T > CullingTestResult _test( const T& bounds, const U32* zones, U32 numZones ) const;
@@ -29,6 +29,11 @@
 #include "platform/profiler.h"
 #include "console/engineAPI.h"
 #include "math/util/frustum.h"
+#include "scene/sceneLooseOctree.h"
+
+#if defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )
+#include <xmmintrin.h>
+#endif
 
 
 // [rene, 02-Mar-11]
@@ -41,11 +46,6 @@
 SceneContainer gServerContainer;
 SceneContainer gClientContainer;
 
-const U32 SceneContainer::csmNumBins = 16;
-const F32 SceneContainer::csmBinSize = 64;
-const F32 SceneContainer::csmTotalBinSize = SceneContainer::csmBinSize * SceneContainer::csmNumBins;
-const U32 SceneContainer::csmRefPoolBlockSize = 4096;
-
 // Statics used by buildPolyList methods
 static AbstractPolyList* sPolyList;
 static SphereF sBoundingSphere;
@@ -91,35 +91,16 @@ void SceneContainer::Link::linkAfter(SceneContainer::Link* ptr)
 SceneContainer::SceneContainer()
 {
    mSearchInProgress = false;
-   mCurrSeqKey = 0;
 
    mEnd.next = mEnd.prev = &mStart;
    mStart.next = mStart.prev = &mEnd;
 
-   mBinArray = new SceneObjectRef[csmNumBins * csmNumBins];
-   for (U32 i = 0; i < csmNumBins; i++) 
-   {
-      U32 base = i * csmNumBins;
-      for (U32 j = 0; j < csmNumBins; j++) 
-      {
-         mBinArray[base + j].object    = NULL;
-         mBinArray[base + j].nextInBin = NULL;
-         mBinArray[base + j].prevInBin = NULL;
-         mBinArray[base + j].nextInObj = NULL;
-      }
-   }
-   mOverflowBin.object    = NULL;
-   mOverflowBin.nextInBin = NULL;
-   mOverflowBin.prevInBin = NULL;
-   mOverflowBin.nextInObj = NULL;
+   mIndex = new SceneLooseOctree;
 
-   VECTOR_SET_ASSOCIATION( mRefPoolBlocks );
    VECTOR_SET_ASSOCIATION( mSearchList );
    VECTOR_SET_ASSOCIATION( mWaterAndZones );
    VECTOR_SET_ASSOCIATION( mTerrains );
-
-   mFreeRefPool = NULL;
-   addRefPoolBlock();
+   VECTOR_SET_ASSOCIATION( mQueryList );
 
    cleanupSearchVectors();
 }
@@ -128,28 +109,7 @@ SceneContainer::SceneContainer()
 
 SceneContainer::~SceneContainer()
 {
-   delete[] mBinArray;
-
-   for (U32 i = 0; i < mRefPoolBlocks.size(); i++)
-   {
-      SceneObjectRef* pool = mRefPoolBlocks[i];
-      for (U32 j = 0; j < csmRefPoolBlockSize; j++)
-      {
-         // Depressingly, this can give weird results if its pointing at bad memory...
-         if(pool[j].object != NULL)
-            Con::warnf("Error, a %s (%x) isn't properly out of the bins!", pool[j].object->getClassName(), pool[j].object);
-
-         // If you're getting this it means that an object created didn't
-         // remove itself from its container before we destroyed the
-         // container. Typically you get this behavior from particle
-         // emitters, as they try to hang around until all their particles
-         // die. In general it's benign, though if you get it for things
-         // that aren't particle emitters it can be a bad sign!
-      }
-
-      delete [] pool;
-   }
-   mFreeRefPool = NULL;
+   delete mIndex;
 
    cleanupSearchVectors();
 }
@@ -162,7 +122,7 @@ bool SceneContainer::addObject(SceneObject* obj)
    obj->mContainer = this;
    obj->linkAfter(&mStart);
 
-   insertIntoBins(obj);
+   mIndex->insertObject(obj);
 
    // Also insert water and physical zone types into the special vector.
    if ( obj->getTypeMask() & ( WaterObjectType | PhysicalZoneObjectType ) )
@@ -178,7 +138,7 @@ bool SceneContainer::addObject(SceneObject* obj)
 bool SceneContainer::removeObject(SceneObject* obj)
 {
    AssertFatal(obj->mContainer == this, "Trying to remove from wrong container.");
-   removeFromBins(obj);
+   mIndex->removeObject(obj);
 
    // Remove water and physical zone types from the special vector.
    if ( obj->getTypeMask() & ( WaterObjectType | PhysicalZoneObjectType ) )
@@ -203,210 +163,75 @@ bool SceneContainer::removeObject(SceneObject* obj)
 
 //-----------------------------------------------------------------------------
 
-void SceneContainer::addRefPoolBlock()
+void SceneContainer::checkBins(SceneObject* obj)
 {
-   mRefPoolBlocks.push_back(new SceneObjectRef[csmRefPoolBlockSize]);
-   for (U32 i = 0; i < csmRefPoolBlockSize-1; i++)
-   {
-      mRefPoolBlocks.last()[i].object    = NULL;
-      mRefPoolBlocks.last()[i].prevInBin = NULL;
-      mRefPoolBlocks.last()[i].nextInBin = NULL;
-      mRefPoolBlocks.last()[i].nextInObj = &(mRefPoolBlocks.last()[i+1]);
-   }
-   mRefPoolBlocks.last()[csmRefPoolBlockSize-1].object    = NULL;
-   mRefPoolBlocks.last()[csmRefPoolBlockSize-1].prevInBin = NULL;
-   mRefPoolBlocks.last()[csmRefPoolBlockSize-1].nextInBin = NULL;
-   mRefPoolBlocks.last()[csmRefPoolBlockSize-1].nextInObj = mFreeRefPool;
-
-   mFreeRefPool = &(mRefPoolBlocks.last()[0]);
+   AssertFatal(obj != NULL, "No object?");
+   mIndex->updateObject(obj);
 }
 
 //-----------------------------------------------------------------------------
 
-void SceneContainer::insertIntoBins(SceneObject* obj)
+void SceneContainer::setSpatialIndex( SceneSpatialIndex* index )
 {
-   AssertFatal(obj != NULL, "No object?");
-   AssertFatal(obj->mBinRefHead == NULL, "Error, already have a bin chain!");
-
-   // The first thing we do is find which bins are covered in x and y...
-   const Box3F* pWBox = &obj->getWorldBox();
+   AssertFatal( index != NULL, "SceneContainer::setSpatialIndex - Got no index!" );
+   AssertFatal( !mSearchInProgress, "SceneContainer::setSpatialIndex - Cannot change the index during a query" );
 
-   U32 minX, maxX, minY, maxY;
-   getBinRange(pWBox->minExtents.x, pWBox->maxExtents.x, minX, maxX);
-   getBinRange(pWBox->minExtents.y, pWBox->maxExtents.y, minY, maxY);
-
-   // Store the current regions for later queries
-   obj->mBinMinX = minX;
-   obj->mBinMaxX = maxX;
-   obj->mBinMinY = minY;
-   obj->mBinMaxY = maxY;
-
-   // For huge objects, dump them into the overflow bin.  Otherwise, everything
-   //  goes into the grid...
-   if (!obj->isGlobalBounds() && ((maxX - minX + 1) < csmNumBins || (maxY - minY + 1) < csmNumBins))
+   for ( Link* itr = mStart.next; itr != &mEnd; itr = itr->next )
    {
-      SceneObjectRef** pCurrInsert = &obj->mBinRefHead;
-
-      for (U32 i = minY; i <= maxY; i++)
-      {
-         U32 insertY = i % csmNumBins;
-         U32 base    = insertY * csmNumBins;
-         for (U32 j = minX; j <= maxX; j++)
-         {
-            U32 insertX = j % csmNumBins;
-
-            SceneObjectRef* ref = allocateObjectRef();
-
-            ref->object    = obj;
-            ref->nextInBin = mBinArray[base + insertX].nextInBin;
-            ref->prevInBin = &mBinArray[base + insertX];
-            ref->nextInObj = NULL;
-
-            if (mBinArray[base + insertX].nextInBin)
-               mBinArray[base + insertX].nextInBin->prevInBin = ref;
-            mBinArray[base + insertX].nextInBin = ref;
-
-            *pCurrInsert = ref;
-            pCurrInsert  = &ref->nextInObj;
-         }
-      }
+      SceneObject* object = static_cast<SceneObject*>( itr );
+      mIndex->removeObject( object );
+      index->insertObject( object );
    }
-   else
-   {
-      SceneObjectRef* ref = allocateObjectRef();
-
-      ref->object    = obj;
-      ref->nextInBin = mOverflowBin.nextInBin;
-      ref->prevInBin = &mOverflowBin;
-      ref->nextInObj = NULL;
 
-      if (mOverflowBin.nextInBin)
-         mOverflowBin.nextInBin->prevInBin = ref;
-      mOverflowBin.nextInBin = ref;
-
-      obj->mBinRefHead = ref;
-   }
+   delete mIndex;
+   mIndex = index;
 }
 
 //-----------------------------------------------------------------------------
 
-void SceneContainer::insertIntoBins(SceneObject* obj,
-                               U32 minX, U32 maxX,
-                               U32 minY, U32 maxY)
-{
-   PROFILE_START(InsertBins);
-   AssertFatal(obj != NULL, "No object?");
+namespace {
 
-   AssertFatal(obj->mBinRefHead == NULL, "Error, already have a bin chain!");
-   // Store the current regions for later queries
-   obj->mBinMinX = minX;
-   obj->mBinMaxX = maxX;
-   obj->mBinMinY = minY;
-   obj->mBinMaxY = maxY;
-
-   // For huge objects, dump them into the overflow bin.  Otherwise, everything
-   //  goes into the grid...
-   //
-   if ((maxX - minX + 1) < csmNumBins || ((maxY - minY + 1) < csmNumBins && !obj->isGlobalBounds()))
+   /// Filter for the candidates returned by the spatial index.
+   struct QueryFilter
    {
-      SceneObjectRef** pCurrInsert = &obj->mBinRefHead;
-
-      for (U32 i = minY; i <= maxY; i++)
-      {
-         U32 insertY = i % csmNumBins;
-         U32 base    = insertY * csmNumBins;
-         for (U32 j = minX; j <= maxX; j++)
-         {
-            U32 insertX = j % csmNumBins;
-
-            SceneObjectRef* ref = allocateObjectRef();
-
-            ref->object    = obj;
-            ref->nextInBin = mBinArray[base + insertX].nextInBin;
-            ref->prevInBin = &mBinArray[base + insertX];
-            ref->nextInObj = NULL;
-
-            if (mBinArray[base + insertX].nextInBin)
-               mBinArray[base + insertX].nextInBin->prevInBin = ref;
-            mBinArray[base + insertX].nextInBin = ref;
-
-            *pCurrInsert = ref;
-            pCurrInsert  = &ref->nextInObj;
-         }
-      }
-   }
-   else
+      U32 mask;
+      Box3F box;
+      Point3F start;
+      Point3F end;
+      Vector< SceneObject* >* outFound;
+   };
+
+   inline bool passesMask( SceneObject* object, U32 mask )
    {
-      SceneObjectRef* ref = allocateObjectRef();
-
-      ref->object    = obj;
-      ref->nextInBin = mOverflowBin.nextInBin;
-      ref->prevInBin = &mOverflowBin;
-      ref->nextInObj = NULL;
-
-      if (mOverflowBin.nextInBin)
-         mOverflowBin.nextInBin->prevInBin = ref;
-      mOverflowBin.nextInBin = ref;
-      obj->mBinRefHead = ref;
+      return ( object->getTypeMask() & mask ) != 0 && object->isCollisionEnabled();
    }
-   PROFILE_END();
-}
-
-//-----------------------------------------------------------------------------
-
-void SceneContainer::removeFromBins(SceneObject* obj)
-{
-   PROFILE_START(RemoveFromBins);
-   AssertFatal(obj != NULL, "No object?");
-
-   SceneObjectRef* chain = obj->mBinRefHead;
-   obj->mBinRefHead = NULL;
 
-   while (chain)
+   void filterBoxCandidate( SceneObject* object, void* key )
    {
-      SceneObjectRef* trash = chain;
-      chain = chain->nextInObj;
-
-      AssertFatal(trash->prevInBin != NULL, "Error, must have a previous entry in the bin!");
-      if (trash->nextInBin)
-         trash->nextInBin->prevInBin = trash->prevInBin;
-      trash->prevInBin->nextInBin = trash->nextInBin;
-
-      freeObjectRef(trash);
+      QueryFilter* filter = reinterpret_cast< QueryFilter* >( key );
+      if ( passesMask( object, filter->mask ) &&
+           ( object->isGlobalBounds() || object->getWorldBox().isOverlapped( filter->box ) ) )
+         filter->outFound->push_back( object );
    }
-   PROFILE_END();
-}
-
-//-----------------------------------------------------------------------------
-
-void SceneContainer::checkBins(SceneObject* obj)
-{
-   AssertFatal(obj != NULL, "No object?");
 
-   PROFILE_START(CheckBins);
-   if (obj->mBinRefHead == NULL)
+   void filterLineCandidate( SceneObject* object, void* key )
    {
-      insertIntoBins(obj);
-      PROFILE_END();
-      return;
+      QueryFilter* filter = reinterpret_cast< QueryFilter* >( key );
+      if ( passesMask( object, filter->mask ) &&
+           ( object->isGlobalBounds() || object->getWorldBox().collideLine( filter->start, filter->end ) ) )
+         filter->outFound->push_back( object );
    }
 
-   // Otherwise, the object is already in the bins.  Let's see if it has strayed out of
-   //  the bins that it's currently in...
-   const Box3F* pWBox = &obj->getWorldBox();
+} // namespace
 
-   U32 minX, maxX, minY, maxY;
-   getBinRange(pWBox->minExtents.x, pWBox->maxExtents.x, minX, maxX);
-   getBinRange(pWBox->minExtents.y, pWBox->maxExtents.y, minY, maxY);
+void SceneContainer::_findInBox( const Box3F& box, U32 mask, Vector< SceneObject* >* outFound )
+{
+   QueryFilter filter;
+   filter.mask = mask;
+   filter.box = box;
+   filter.outFound = outFound;
 
-   if (obj->mBinMinX != minX || obj->mBinMaxX != maxX ||
-       obj->mBinMinY != minY || obj->mBinMaxY != maxY)
-   {
-      // We have to rebin the object
-      removeFromBins(obj);
-      insertIntoBins(obj, minX, maxX, minY, maxY);
-   }
-   PROFILE_END();
+   mIndex->findInBox( box, filterBoxCandidate, &filter );
 }
 
 //-----------------------------------------------------------------------------
@@ -433,56 +258,11 @@ void SceneContainer::findObjects(const Box3F& box, U32 mask, FindCallback callba
    AssertFatal( !mSearchInProgress, "SceneContainer::findObjects - Container queries are not re-entrant" );
    mSearchInProgress = true;
 
-   U32 minX, maxX, minY, maxY;
-   getBinRange(box.minExtents.x, box.maxExtents.x, minX, maxX);
-   getBinRange(box.minExtents.y, box.maxExtents.y, minY, maxY);
-   mCurrSeqKey++;
-   for (U32 i = minY; i <= maxY; i++)
-   {
-      U32 insertY = i % csmNumBins;
-      U32 base    = insertY * csmNumBins;
-      for (U32 j = minX; j <= maxX; j++)
-      {
-         U32 insertX = j % csmNumBins;
-
-         SceneObjectRef* chain = mBinArray[base + insertX].nextInBin;
-         while (chain)
-         {
-            if (chain->object->getContainerSeqKey() != mCurrSeqKey)
-            {
-               chain->object->setContainerSeqKey(mCurrSeqKey);
-
-               if ((chain->object->getTypeMask() & mask) != 0 &&
-                   chain->object->isCollisionEnabled())
-               {
-                  if (chain->object->getWorldBox().isOverlapped(box) || chain->object->isGlobalBounds())
-                  {
-                     (*callback)(chain->object,key);
-                  }
-               }
-            }
-            chain = chain->nextInBin;
-         }
-      }
-   }
-   SceneObjectRef* chain = mOverflowBin.nextInBin;
-   while (chain)
-   {
-      if (chain->object->getContainerSeqKey() != mCurrSeqKey)
-      {
-         chain->object->setContainerSeqKey(mCurrSeqKey);
+   mQueryList.clear();
+   _findInBox( box, mask, &mQueryList );
 
-         if ((chain->object->getTypeMask() & mask) != 0 &&
-             chain->object->isCollisionEnabled())
-         {
-            if (chain->object->getWorldBox().isOverlapped(box) || chain->object->isGlobalBounds())
-            {
-               (*callback)(chain->object,key);
-            }
-         }
-      }
-      chain = chain->nextInBin;
-   }
+   for ( U32 i = 0; i < mQueryList.size(); i++ )
+      (*callback)( mQueryList[i], key );
 
    mSearchInProgress = false;
 }
@@ -511,66 +291,13 @@ void SceneContainer::findObjects( const Frustum &frustum, U32 mask, FindCallback
    AssertFatal( !mSearchInProgress, "SceneContainer::findObjects - Container queries are not re-entrant" );
    mSearchInProgress = true;
 
-   U32 minX, maxX, minY, maxY;
-   getBinRange(searchBox.minExtents.x, searchBox.maxExtents.x, minX, maxX);
-   getBinRange(searchBox.minExtents.y, searchBox.maxExtents.y, minY, maxY);
-   mCurrSeqKey++;
-
-   for (U32 i = minY; i <= maxY; i++)
-   {
-      U32 insertY = i % csmNumBins;
-      U32 base    = insertY * csmNumBins;
-      for (U32 j = minX; j <= maxX; j++)
-      {
-         U32 insertX = j % csmNumBins;
-
-         SceneObjectRef* chain = mBinArray[base + insertX].nextInBin;
-         while (chain)
-         {
-            SceneObject *object = chain->object;
-
-            if (object->getContainerSeqKey() != mCurrSeqKey)
-            {
-               object->setContainerSeqKey(mCurrSeqKey);
-
-               if ((object->getTypeMask() & mask) != 0 &&
-                  object->isCollisionEnabled())
-               {
-                  const Box3F &worldBox = object->getWorldBox();
-                  if ( object->isGlobalBounds() || worldBox.isOverlapped(searchBox) )
-                  {
-                     if ( !frustum.isCulled( worldBox ) )
-                        (*callback)(chain->object,key);
-                  }
-               }
-            }
-            chain = chain->nextInBin;
-         }
-      }
-   }
+   mQueryList.clear();
+   _findInBox( searchBox, mask, &mQueryList );
 
-   SceneObjectRef* chain = mOverflowBin.nextInBin;
-   while (chain)
+   for ( U32 i = 0; i < mQueryList.size(); i++ )
    {
-      SceneObject *object = chain->object;
-
-      if (object->getContainerSeqKey() != mCurrSeqKey)
-      {
-         object->setContainerSeqKey(mCurrSeqKey);
-
-         if ((object->getTypeMask() & mask) != 0 &&
-            object->isCollisionEnabled())
-         {
-            const Box3F &worldBox = object->getWorldBox();
-
-            if ( object->isGlobalBounds() || worldBox.isOverlapped(searchBox) )
-            {
-               if ( !frustum.isCulled( worldBox ) )
-                  (*callback)(object,key);
-            }
-         }
-      }
-      chain = chain->nextInBin;
+      if ( !frustum.isCulled( mQueryList[i]->getWorldBox() ) )
+         (*callback)( mQueryList[i], key );
    }
 
    mSearchInProgress = false;
@@ -608,56 +335,11 @@ void SceneContainer::polyhedronFindObjects(const Polyhedron& polyhedron, U32 mas
    AssertFatal( !mSearchInProgress, "SceneContainer::polyhedronFindObjects - Container queries are not re-entrant" );
    mSearchInProgress = true;
 
-   U32 minX, maxX, minY, maxY;
-   getBinRange(box.minExtents.x, box.maxExtents.x, minX, maxX);
-   getBinRange(box.minExtents.y, box.maxExtents.y, minY, maxY);
-   mCurrSeqKey++;
-   for (i = minY; i <= maxY; i++)
-   {
-      U32 insertY = i % csmNumBins;
-      U32 base    = insertY * csmNumBins;
-      for (U32 j = minX; j <= maxX; j++)
-      {
-         U32 insertX = j % csmNumBins;
+   mQueryList.clear();
+   _findInBox( box, mask, &mQueryList );
 
-         SceneObjectRef* chain = mBinArray[base + insertX].nextInBin;
-         while (chain)
-         {
-            if (chain->object->getContainerSeqKey() != mCurrSeqKey)
-            {
-               chain->object->setContainerSeqKey(mCurrSeqKey);
-
-               if ((chain->object->getTypeMask() & mask) != 0 &&
-                   chain->object->isCollisionEnabled())
-               {
-                  if (chain->object->getWorldBox().isOverlapped(box) || chain->object->isGlobalBounds())
-                  {
-                     (*callback)(chain->object,key);
-                  }
-               }
-            }
-            chain = chain->nextInBin;
-         }
-      }
-   }
-   SceneObjectRef* chain = mOverflowBin.nextInBin;
-   while (chain)
-   {
-      if (chain->object->getContainerSeqKey() != mCurrSeqKey)
-      {
-         chain->object->setContainerSeqKey(mCurrSeqKey);
-
-         if ((chain->object->getTypeMask() & mask) != 0 &&
-             chain->object->isCollisionEnabled())
-         {
-            if (chain->object->getWorldBox().isOverlapped(box) || chain->object->isGlobalBounds())
-            {
-               (*callback)(chain->object,key);
-            }
-         }
-      }
-      chain = chain->nextInBin;
-   }
+   for ( i = 0; i < mQueryList.size(); i++ )
+      (*callback)( mQueryList[i], key );
 
    mSearchInProgress = false;
 }
@@ -673,65 +355,7 @@ void SceneContainer::findObjectList( const Box3F& searchBox, U32 mask, Vector<Sc
 
    // TODO: Optimize for water and zones?
 
-   U32 minX, maxX, minY, maxY;
-   getBinRange(searchBox.minExtents.x, searchBox.maxExtents.x, minX, maxX);
-   getBinRange(searchBox.minExtents.y, searchBox.maxExtents.y, minY, maxY);
-   mCurrSeqKey++;
-
-   for (U32 i = minY; i <= maxY; i++)
-   {
-      U32 insertY = i % csmNumBins;
-      U32 base    = insertY * csmNumBins;
-      for (U32 j = minX; j <= maxX; j++)
-      {
-         U32 insertX = j % csmNumBins;
-
-         SceneObjectRef* chain = mBinArray[base + insertX].nextInBin;
-         while (chain)
-         {
-            SceneObject *object = chain->object;
-
-            if (object->getContainerSeqKey() != mCurrSeqKey)
-            {
-               object->setContainerSeqKey(mCurrSeqKey);
-
-               if ((object->getTypeMask() & mask) != 0 &&
-                  object->isCollisionEnabled())
-               {
-                  const Box3F &worldBox = object->getWorldBox();
-                  if ( object->isGlobalBounds() || worldBox.isOverlapped( searchBox ) )
-                  {
-                     outFound->push_back( object );
-                  }
-               }
-            }
-            chain = chain->nextInBin;
-         }
-      }
-   }
-
-   SceneObjectRef* chain = mOverflowBin.nextInBin;
-   while (chain)
-   {
-      SceneObject *object = chain->object;
-
-      if (object->getContainerSeqKey() != mCurrSeqKey)
-      {
-         object->setContainerSeqKey(mCurrSeqKey);
-
-         if ((object->getTypeMask() & mask) != 0 &&
-            object->isCollisionEnabled())
-         {
-            const Box3F &worldBox = object->getWorldBox();
-
-            if ( object->isGlobalBounds() || worldBox.isOverlapped( searchBox ) )
-            {
-               outFound->push_back( object );
-            }
-         }
-      }
-      chain = chain->nextInBin;
-   }
+   _findInBox( searchBox, mask, outFound );
 
    mSearchInProgress = false;
 }
@@ -839,295 +463,326 @@ bool SceneContainer::castRayRendered( const Point3F& start, const Point3F& end,
 
 //-----------------------------------------------------------------------------
 
-// DMMNOTE: There are still some optimizations to be done here.  In particular:
-//           - After checking the overflow bin, we can potentially shorten the line
-//             that we rasterize against the grid if there is a collision with say,
-//             the terrain.
-//           - The optimal grid size isn't necessarily what we have set here. possibly
-//             a resolution of 16 meters would give better results
-//           - The line rasterizer is pretty lame.  Unfortunately we can't use a
-//             simple bres. here, since we need to check every grid element that the line
-//             passes through, which bres does _not_ do for us.  Possibly there's a
-//             rasterizer for anti-aliased lines that will serve better than what
-//             we have below.
+/// Move the normal of a hit from object space into world space.
+static void transformHitNormal( RayInfo* info )
+{
+   PlaneF fakePlane;
+   fakePlane.x = info->normal.x;
+   fakePlane.y = info->normal.y;
+   fakePlane.z = info->normal.z;
+   fakePlane.d = 0;
+
+   PlaneF result;
+   mTransformPlane(info->object->getTransform(), info->object->getScale(), fakePlane, &result);
+   info->normal = result;
+}
 
 bool SceneContainer::_castRay( U32 type, const Point3F& start, const Point3F& end, U32 mask, RayInfo* info, CastRayCallback callback )
 {
    AssertFatal( !mSearchInProgress, "SceneContainer::_castRay - Container queries are not re-entrant" );
    mSearchInProgress = true;
 
-   F32 currentT = 2.0;
-   mCurrSeqKey++;
+   QueryFilter filter;
+   filter.mask = mask;
+   filter.start = start;
+   filter.end = end;
+   filter.outFound = &mQueryList;
+
+   mQueryList.clear();
+   mIndex->findOnLine( start, end, filterLineCandidate, &filter );
 
-   SceneObjectRef* chain = mOverflowBin.nextInBin;
-   while (chain)
+   F32 currentT = 2.0;
+   for ( U32 i = 0; i < mQueryList.size(); i++ )
    {
-      SceneObject* ptr = chain->object;
-      if (ptr->getContainerSeqKey() != mCurrSeqKey)
+      SceneObject* ptr = mQueryList[i];
+
+      Point3F xformedStart, xformedEnd;
+      ptr->mWorldToObj.mulP(start, &xformedStart);
+      ptr->mWorldToObj.mulP(end,   &xformedEnd);
+      xformedStart.convolveInverse(ptr->mObjScale);
+      xformedEnd.convolveInverse(ptr->mObjScale);
+
+      RayInfo ri;
+      ri.generateTexCoord  = info->generateTexCoord;
+      bool result = false;
+      if (type == CollisionGeometry)
+         result = ptr->castRay(xformedStart, xformedEnd, &ri);
+      else if (type == RenderedGeometry)
+         result = ptr->castRayRendered(xformedStart, xformedEnd, &ri);
+      if (result)
       {
-         ptr->setContainerSeqKey(mCurrSeqKey);
-
-         // In the overflow bin, the world box is always going to intersect the line,
-         //  so we can omit that test...
-         if ((ptr->getTypeMask() & mask) != 0 &&
-             ptr->isCollisionEnabled() == true)
+         if( ri.t < currentT && ( !callback || callback( &ri ) ) )
          {
-            Point3F xformedStart, xformedEnd;
-            ptr->mWorldToObj.mulP(start, &xformedStart);
-            ptr->mWorldToObj.mulP(end,   &xformedEnd);
-            xformedStart.convolveInverse(ptr->mObjScale);
-            xformedEnd.convolveInverse(ptr->mObjScale);
-
-            RayInfo ri;
-            ri.generateTexCoord  = info->generateTexCoord;
-            bool result = false;
-            if (type == CollisionGeometry)
-               result = ptr->castRay(xformedStart, xformedEnd, &ri);
-            else if (type == RenderedGeometry)
-               result = ptr->castRayRendered(xformedStart, xformedEnd, &ri);
-            if (result)
-            {
-               if( ri.t < currentT && ( !callback || callback( &ri ) ) )
-               {
-                  *info = ri;
-                  info->point.interpolate(start, end, info->t);
-                  currentT = ri.t;
-                  info->distance = (start - info->point).len();
-               }
-            }
+            *info = ri;
+            info->point.interpolate(start, end, info->t);
+            currentT = ri.t;
+            info->distance = (start - info->point).len();
          }
       }
-      chain = chain->nextInBin;
    }
 
-   // These are just for rasterizing the line against the grid.  We want the x coord
-   //  of the start to be <= the x coord of the end
-   Point3F normalStart, normalEnd;
-   if (start.x <= end.x)
+   mSearchInProgress = false;
+
+   // Bump the normal into worldspace if appropriate.
+   if(currentT != 2)
    {
-      normalStart = start;
-      normalEnd   = end;
+      transformHitNormal(info);
+      return true;
    }
    else
    {
-      normalStart = end;
-      normalEnd   = start;
+      // Do nothing and exit...
+      return false;
    }
+}
+
+//-----------------------------------------------------------------------------
 
-   // Ok, let's scan the grids.  The simplest way to do this will be to scan across in
-   //  x, finding the y range for each affected bin...
-   U32 minX, maxX;
-   U32 minY, maxY;
-//if (normalStart.x == normalEnd.x)
-//   Con::printf("X start = %g, end = %g", normalStart.x, normalEnd.x);
-
-   getBinRange(normalStart.x, normalEnd.x, minX, maxX);
-   getBinRange(getMin(normalStart.y, normalEnd.y),
-               getMax(normalStart.y, normalEnd.y), minY, maxY);
-
-//if (normalStart.x == normalEnd.x && minX != maxX)
-//   Con::printf("X min = %d, max = %d", minX, maxX);
-//if (normalStart.y == normalEnd.y && minY != maxY)
-//   Con::printf("Y min = %d, max = %d", minY, maxY);
-
-   // We'll optimize the case that the line is contained in one bin row or column, which
-   //  will be quite a few lines.  No sense doing more work than we have to...
-   //
-   if ((mFabs(normalStart.x - normalEnd.x) < csmTotalBinSize && minX == maxX) ||
-       (mFabs(normalStart.y - normalEnd.y) < csmTotalBinSize && minY == maxY))
+namespace {
+
+   /// The rays of a packet laid out for the slab tests.  Unused lanes have a
+   /// negative #bestT so they never hit.
+   struct RayPacket
    {
+      F32 originX[ SceneContainer::csmRayPacketSize ];
+      F32 originY[ SceneContainer::csmRayPacketSize ];
+      F32 originZ[ SceneContainer::csmRayPacketSize ];
+      F32 invDirX[ SceneContainer::csmRayPacketSize ];
+      F32 invDirY[ SceneContainer::csmRayPacketSize ];
+      F32 invDirZ[ SceneContainer::csmRayPacketSize ];
+
+      /// Closest hit found so far along each ray.
+      F32 bestT[ SceneContainer::csmRayPacketSize ];
+
+      /// Index of each lane's ray in the batch.
+      U32 ray[ SceneContainer::csmRayPacketSize ];
+
       U32 count;
-      U32 incX, incY;
-      if (minX == maxX)
-      {
-         count = maxY - minY + 1;
-         incX  = 0;
-         incY  = 1;
-      }
-      else
+   };
+
+   /// Reciprocal that stays finite for axis aligned rays.
+   inline F32 safeInverse( F32 value )
+   {
+      if ( mFabs( value ) < 1e-20f )
+         value = value < 0.0f ? -1e-20f : 1e-20f;
+      return 1.0f / value;
+   }
+
+   /// Return a bit for every ray of the packet that enters the box before
+   /// its closest hit so far.
+   U32 rayPacketHitsBox( const RayPacket& packet, const Box3F& box )
+   {
+      U32 hits = 0;
+
+#if defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )
+
+      const __m128 zero = _mm_setzero_ps();
+      const __m128 minX = _mm_set1_ps( box.minExtents.x );
+      const __m128 minY = _mm_set1_ps( box.minExtents.y );
+      const __m128 minZ = _mm_set1_ps( box.minExtents.z );
+      const __m128 maxX = _mm_set1_ps( box.maxExtents.x );
+      const __m128 maxY = _mm_set1_ps( box.maxExtents.y );
+      const __m128 maxZ = _mm_set1_ps( box.maxExtents.z );
+
+      for ( U32 i = 0; i < packet.count; i += 4 )
       {
-         count = maxX - minX + 1;
-         incX  = 1;
-         incY  = 0;
+         __m128 origin = _mm_loadu_ps( packet.originX + i );
+         __m128 invDir = _mm_loadu_ps( packet.invDirX + i );
+         __m128 t1 = _mm_mul_ps( _mm_sub_ps( minX, origin ), invDir );
+         __m128 t2 = _mm_mul_ps( _mm_sub_ps( maxX, origin ), invDir );
+         __m128 tNear = _mm_min_ps( t1, t2 );
+         __m128 tFar = _mm_max_ps( t1, t2 );
+
+         origin = _mm_loadu_ps( packet.originY + i );
+         invDir = _mm_loadu_ps( packet.invDirY + i );
+         t1 = _mm_mul_ps( _mm_sub_ps( minY, origin ), invDir );
+         t2 = _mm_mul_ps( _mm_sub_ps( maxY, origin ), invDir );
+         tNear = _mm_max_ps( tNear, _mm_min_ps( t1, t2 ) );
+         tFar = _mm_min_ps( tFar, _mm_max_ps( t1, t2 ) );
+
+         origin = _mm_loadu_ps( packet.originZ + i );
+         invDir = _mm_loadu_ps( packet.invDirZ + i );
+         t1 = _mm_mul_ps( _mm_sub_ps( minZ, origin ), invDir );
+         t2 = _mm_mul_ps( _mm_sub_ps( maxZ, origin ), invDir );
+         tNear = _mm_max_ps( tNear, _mm_min_ps( t1, t2 ) );
+         tFar = _mm_min_ps( tFar, _mm_max_ps( t1, t2 ) );
+
+         tNear = _mm_max_ps( tNear, zero );
+         tFar = _mm_min_ps( tFar, _mm_loadu_ps( packet.bestT + i ) );
+
+         hits |= U32( _mm_movemask_ps( _mm_cmple_ps( tNear, tFar ) ) ) << i;
       }
 
-      U32 x = minX;
-      U32 y = minY;
-      for (U32 i = 0; i < count; i++)
+#else
+
+      for ( U32 i = 0; i < packet.count; i++ )
       {
-         U32 checkX = x % csmNumBins;
-         U32 checkY = y % csmNumBins;
+         F32 t1 = ( box.minExtents.x - packet.originX[ i ] ) * packet.invDirX[ i ];
+         F32 t2 = ( box.maxExtents.x - packet.originX[ i ] ) * packet.invDirX[ i ];
+         F32 tNear = getMin( t1, t2 );
+         F32 tFar = getMax( t1, t2 );
+
+         t1 = ( box.minExtents.y - packet.originY[ i ] ) * packet.invDirY[ i ];
+         t2 = ( box.maxExtents.y - packet.originY[ i ] ) * packet.invDirY[ i ];
+         tNear = getMax( tNear, getMin( t1, t2 ) );
+         tFar = getMin( tFar, getMax( t1, t2 ) );
+
+         t1 = ( box.minExtents.z - packet.originZ[ i ] ) * packet.invDirZ[ i ];
+         t2 = ( box.maxExtents.z - packet.originZ[ i ] ) * packet.invDirZ[ i ];
+         tNear = getMax( tNear, getMin( t1, t2 ) );
+         tFar = getMin( tFar, getMax( t1, t2 ) );
+
+         if ( getMax( tNear, 0.0f ) <= getMin( tFar, packet.bestT[ i ] ) )
+            hits |= 1 << i;
+      }
 
-         SceneObjectRef* chain = mBinArray[(checkY * csmNumBins) + checkX].nextInBin;
-         while (chain)
-         {
-            SceneObject* ptr = chain->object;
-            if (ptr->getContainerSeqKey() != mCurrSeqKey)
-            {
-               ptr->setContainerSeqKey(mCurrSeqKey);
-
-               if ((ptr->getTypeMask() & mask) != 0      &&
-                   ptr->isCollisionEnabled() == true)
-               {
-                  if (ptr->getWorldBox().collideLine(start, end) || chain->object->isGlobalBounds())
-                  {
-                     Point3F xformedStart, xformedEnd;
-                     ptr->mWorldToObj.mulP(start, &xformedStart);
-                     ptr->mWorldToObj.mulP(end,   &xformedEnd);
-                     xformedStart.convolveInverse(ptr->mObjScale);
-                     xformedEnd.convolveInverse(ptr->mObjScale);
-
-                     RayInfo ri;
-                     ri.generateTexCoord  = info->generateTexCoord;
-                     bool result = false;
-                     if (type == CollisionGeometry)
-                        result = ptr->castRay(xformedStart, xformedEnd, &ri);
-                     else if (type == RenderedGeometry)
-                        result = ptr->castRayRendered(xformedStart, xformedEnd, &ri);
-                     if (result)
-                     {
-                        if( ri.t < currentT && ( !callback || callback( &ri ) ) )
-                        {
-                           *info = ri;
-                           info->point.interpolate(start, end, info->t);
-                           currentT = ri.t;
-                           info->distance = (start - info->point).len();
-                        }
-                     }
-                  }
-               }
-            }
-            chain = chain->nextInBin;
-         }
+#endif
 
-         x += incX;
-         y += incY;
-      }
+      return hits;
    }
-   else
+
+   struct RaySortKey
    {
-      // Oh well, let's earn our keep.  We know that after the above conditional, we're
-      //  going to cross at least one boundary, so that simplifies our job...
+      U32 key;
+      U32 ray;
+   };
 
-      F32 currStartX = normalStart.x;
+   S32 QSORT_CALLBACK compareRaySortKeys( const void* a, const void* b )
+   {
+      const RaySortKey* keyA = reinterpret_cast< const RaySortKey* >( a );
+      const RaySortKey* keyB = reinterpret_cast< const RaySortKey* >( b );
+      if ( keyA->key != keyB->key )
+         return keyA->key < keyB->key ? -1 : 1;
+      return S32( keyA->ray ) - S32( keyB->ray );
+   }
 
-      AssertFatal(currStartX != normalEnd.x, "This is going to cause problems in SceneContainer::castRay");
-      if(mIsNaN_F(currStartX))
-      {
-         PROFILE_END();
-         return false;
-      }
-      while (currStartX != normalEnd.x)
-      {
-         F32 currEndX   = getMin(currStartX + csmTotalBinSize, normalEnd.x);
+   /// Interleave the low 16 bits of x and y.
+   inline U32 mortonCode( U32 x, U32 y )
+   {
+      U32 code = 0;
+      for ( U32 i = 0; i < 16; i++ )
+         code |= ( ( x >> i ) & 1 ) << ( i * 2 ) | ( ( y >> i ) & 1 ) << ( i * 2 + 1 );
+      return code;
+   }
 
-         F32 currStartT = (currStartX - normalStart.x) / (normalEnd.x - normalStart.x);
-         F32 currEndT   = (currEndX   - normalStart.x) / (normalEnd.x - normalStart.x);
+} // namespace
 
-         F32 y1 = normalStart.y + (normalEnd.y - normalStart.y) * currStartT;
-         F32 y2 = normalStart.y + (normalEnd.y - normalStart.y) * currEndT;
+U32 SceneContainer::castRayBatch( const RayQuery* rays, U32 numRays, RayInfo* outInfo )
+{
+   PROFILE_SCOPE( SceneContainer_CastRayBatch );
 
-         U32 subMinX, subMaxX;
-         getBinRange(currStartX, currEndX, subMinX, subMaxX);
+   AssertFatal( !mSearchInProgress, "SceneContainer::castRayBatch - Container queries are not re-entrant" );
+   mSearchInProgress = true;
+
+   // Order the rays along a z-curve over their midpoints so the rays of
+   // a packet are close to each other.
+   Vector< RaySortKey > order;
+   order.setSize( numRays );
+   for ( U32 i = 0; i < numRays; i++ )
+   {
+      Point3F mid = ( rays[ i ].start + rays[ i ].end ) * 0.5f;
+      order[ i ].key = mortonCode( U32( S32( mFloor( mid.x / 32.0f ) ) ), U32( S32( mFloor( mid.y / 32.0f ) ) ) );
+      order[ i ].ray = i;
 
-         F32 subStartX = currStartX;
-         F32 subEndX   = currStartX;
+      outInfo[ i ].object = NULL;
+      outInfo[ i ].t = 1.0f;
+   }
+   dQsort( order.address(), numRays, sizeof( RaySortKey ), compareRaySortKeys );
 
-         if (currStartX < 0.0f)
-            subEndX -= mFmod(subEndX, csmBinSize);
-         else
-            subEndX += (csmBinSize - mFmod(subEndX, csmBinSize));
+   U32 numHits = 0;
+   RayPacket packet;
+   for ( U32 first = 0; first < numRays; first += csmRayPacketSize )
+   {
+      // Set up the packet.
+      packet.count = getMin( numRays - first, csmRayPacketSize );
 
-         for (U32 currXBin = subMinX; currXBin <= subMaxX; currXBin++)
+      Box3F bounds( Box3F::Invalid );
+      U32 mask = 0;
+      for ( U32 lane = 0; lane < csmRayPacketSize; lane++ )
+      {
+         if ( lane >= packet.count )
          {
-            U32 checkX = currXBin % csmNumBins;
+            packet.originX[ lane ] = packet.originY[ lane ] = packet.originZ[ lane ] = 0.0f;
+            packet.invDirX[ lane ] = packet.invDirY[ lane ] = packet.invDirZ[ lane ] = 0.0f;
+            packet.bestT[ lane ] = -1.0f;
+            packet.ray[ lane ] = 0;
+            continue;
+         }
+
+         const RayQuery& ray = rays[ order[ first + lane ].ray ];
+         packet.ray[ lane ] = order[ first + lane ].ray;
+         packet.originX[ lane ] = ray.start.x;
+         packet.originY[ lane ] = ray.start.y;
+         packet.originZ[ lane ] = ray.start.z;
+         packet.invDirX[ lane ] = safeInverse( ray.end.x - ray.start.x );
+         packet.invDirY[ lane ] = safeInverse( ray.end.y - ray.start.y );
+         packet.invDirZ[ lane ] = safeInverse( ray.end.z - ray.start.z );
+         packet.bestT[ lane ] = 1.0f;
+
+         // A ray that matches no object types can't hit anything, so
+         // don't grow the packet's query box for it.
+         if ( !ray.mask )
+            continue;
+
+         bounds.extend( ray.start );
+         bounds.extend( ray.end );
+         mask |= ray.mask;
+      }
+
+      if ( !mask )
+         continue;
 
-            F32 subStartT = (subStartX - currStartX) / (currEndX - currStartX);
-            F32 subEndT   = getMin(F32((subEndX   - currStartX) / (currEndX - currStartX)), 1.f);
+      // Gather the candidates for the whole packet.
+      mQueryList.clear();
+      _findInBox( bounds, mask, &mQueryList );
 
-            F32 subY1 = y1 + (y2 - y1) * subStartT;
-            F32 subY2 = y1 + (y2 - y1) * subEndT;
+      for ( U32 i = 0; i < mQueryList.size(); i++ )
+      {
+         SceneObject* ptr = mQueryList[ i ];
+         U32 hits = rayPacketHitsBox( packet, ptr->getWorldBox() );
+
+         for ( U32 lane = 0; hits; lane++, hits >>= 1 )
+         {
+            if ( !( hits & 1 ) )
+               continue;
 
-            U32 newMinY, newMaxY;
-            getBinRange(getMin(subY1, subY2), getMax(subY1, subY2), newMinY, newMaxY);
+            const RayQuery& ray = rays[ packet.ray[ lane ] ];
+            if ( !( ptr->getTypeMask() & ray.mask ) )
+               continue;
 
-            for (U32 i = newMinY; i <= newMaxY; i++)
+            Point3F xformedStart, xformedEnd;
+            ptr->mWorldToObj.mulP( ray.start, &xformedStart );
+            ptr->mWorldToObj.mulP( ray.end,   &xformedEnd );
+            xformedStart.convolveInverse( ptr->mObjScale );
+            xformedEnd.convolveInverse( ptr->mObjScale );
+
+            RayInfo ri;
+            ri.generateTexCoord = outInfo[ packet.ray[ lane ] ].generateTexCoord;
+            if ( ptr->castRay( xformedStart, xformedEnd, &ri ) && ri.t < packet.bestT[ lane ] )
             {
-               U32 checkY = i % csmNumBins;
-
-               SceneObjectRef* chain = mBinArray[(checkY * csmNumBins) + checkX].nextInBin;
-               while (chain)
-               {
-                  SceneObject* ptr = chain->object;
-                  if (ptr->getContainerSeqKey() != mCurrSeqKey)
-                  {
-                     ptr->setContainerSeqKey(mCurrSeqKey);
-
-                     if ((ptr->getTypeMask() & mask) != 0      &&
-                         ptr->isCollisionEnabled() == true)
-                     {
-                        if (ptr->getWorldBox().collideLine(start, end))
-                        {
-                           Point3F xformedStart, xformedEnd;
-                           ptr->mWorldToObj.mulP(start, &xformedStart);
-                           ptr->mWorldToObj.mulP(end,   &xformedEnd);
-                           xformedStart.convolveInverse(ptr->mObjScale);
-                           xformedEnd.convolveInverse(ptr->mObjScale);
-
-                           RayInfo ri;
-                           ri.generateTexCoord  = info->generateTexCoord;
-                           bool result = false;
-                           if (type == CollisionGeometry)
-                              result = ptr->castRay(xformedStart, xformedEnd, &ri);
-                           else if (type == RenderedGeometry)
-                              result = ptr->castRayRendered(xformedStart, xformedEnd, &ri);
-                           if (result)
-                           {
-                              if( ri.t < currentT && ( !callback || callback( &ri ) ) )
-                              {
-                                 *info = ri;
-                                 info->point.interpolate(start, end, info->t);
-                                 currentT = ri.t;
-                                 info->distance = (start - info->point).len();
-                              }
-                           }
-                        }
-                     }
-                  }
-                  chain = chain->nextInBin;
-               }
+               RayInfo& info = outInfo[ packet.ray[ lane ] ];
+               info = ri;
+               info.point.interpolate( ray.start, ray.end, info.t );
+               info.distance = ( ray.start - info.point ).len();
+               packet.bestT[ lane ] = ri.t;
             }
-
-            subStartX = subEndX;
-            subEndX   = getMin(subEndX + csmBinSize, currEndX);
          }
-
-         currStartX = currEndX;
       }
    }
 
    mSearchInProgress = false;
 
-   // Bump the normal into worldspace if appropriate.
-   if(currentT != 2)
+   // Bump the normals into worldspace.
+   for ( U32 i = 0; i < numRays; i++ )
    {
-      PlaneF fakePlane;
-      fakePlane.x = info->normal.x;
-      fakePlane.y = info->normal.y;
-      fakePlane.z = info->normal.z;
-      fakePlane.d = 0;
-
-      PlaneF result;
-      mTransformPlane(info->object->getTransform(), info->object->getScale(), fakePlane, &result);
-      info->normal = result;
-
-      return true;
-   }
-   else
-   {
-      // Do nothing and exit...
-      return false;
+      if ( outInfo[ i ].object )
+      {
+         transformHitNormal( &outInfo[ i ] );
+         numHits++;
+      }
    }
+
+   return numHits;
 }
 
 //-----------------------------------------------------------------------------
@@ -1376,75 +1031,6 @@ F32 SceneContainer::containerSearchCurrRadiusDist()
    return dist;
 }
 
-//-----------------------------------------------------------------------------
-
-void SceneContainer::getBinRange( const F32 min, const F32 max, U32& minBin, U32& maxBin )
-{
-   AssertFatal(max >= min, avar("Error, bad range in getBinRange. min: %f, max: %f", min, max));
-
-   if ((max - min) >= (SceneContainer::csmTotalBinSize - SceneContainer::csmBinSize))
-   {
-      F32 minCoord = mFmod(min, SceneContainer::csmTotalBinSize);
-      if (minCoord < 0.0f) 
-      {
-         minCoord += SceneContainer::csmTotalBinSize;
-
-         // This is truly lame, but it can happen.  There must be a better way to
-         //  deal with this.
-         if (minCoord == SceneContainer::csmTotalBinSize)
-            minCoord = SceneContainer::csmTotalBinSize - 0.01;
-      }
-
-      AssertFatal(minCoord >= 0.0 && minCoord < SceneContainer::csmTotalBinSize, "Bad minCoord");
-
-      minBin = U32(minCoord / SceneContainer::csmBinSize);
-      AssertFatal(minBin < SceneContainer::csmNumBins, avar("Error, bad clipping! (%g, %d)", minCoord, minBin));
-
-      maxBin = minBin + (SceneContainer::csmNumBins - 1);
-      return;
-   }
-   else 
-   {
-
-      F32 minCoord = mFmod(min, SceneContainer::csmTotalBinSize);
-      
-      if (minCoord < 0.0f) 
-      {
-         minCoord += SceneContainer::csmTotalBinSize;
-
-         // This is truly lame, but it can happen.  There must be a better way to
-         //  deal with this.
-         if (minCoord == SceneContainer::csmTotalBinSize)
-            minCoord = SceneContainer::csmTotalBinSize - 0.01;
-      }
-      AssertFatal(minCoord >= 0.0 && minCoord < SceneContainer::csmTotalBinSize, "Bad minCoord");
-
-      F32 maxCoord = mFmod(max, SceneContainer::csmTotalBinSize);
-      if (maxCoord < 0.0f) {
-         maxCoord += SceneContainer::csmTotalBinSize;
-
-         // This is truly lame, but it can happen.  There must be a better way to
-         //  deal with this.
-         if (maxCoord == SceneContainer::csmTotalBinSize)
-            maxCoord = SceneContainer::csmTotalBinSize - 0.01;
-      }
-      AssertFatal(maxCoord >= 0.0 && maxCoord < SceneContainer::csmTotalBinSize, "Bad maxCoord");
-
-      minBin = U32(minCoord / SceneContainer::csmBinSize);
-      maxBin = U32(maxCoord / SceneContainer::csmBinSize);
-      AssertFatal(minBin < SceneContainer::csmNumBins, avar("Error, bad clipping(min)! (%g, %d)", maxCoord, minBin));
-      AssertFatal(minBin < SceneContainer::csmNumBins, avar("Error, bad clipping(max)! (%g, %d)", maxCoord, maxBin));
-
-      // MSVC6 seems to be generating some bad floating point code around
-      // here when full optimizations are on.  The min != max test should
-      // not be needed, but it clears up the VC issue.
-      if (min != max && minCoord > maxCoord)
-         maxBin += SceneContainer::csmNumBins;
-
-      AssertFatal(maxBin >= minBin, "Error, min should always be less than max!");
-   }
-}
-
 //=============================================================================
 //    Console API.
 //=============================================================================
@@ -1654,4 +1240,129 @@ DefineEngineFunction( containerRayCast, const char*,
    return(returnBuffer);
 }
 
+//-----------------------------------------------------------------------------
+
+DefineEngineFunction( containerRayCastBatch, const char*,
+   ( const char* rays, U32 mask, bool useClientContainer ), ( false ),
+   "@brief Cast many rays at once, checking for collision against items matching mask.\n\n"
+
+   "This is much faster than calling containerRayCast() for each ray when there are many "
+   "rays to cast, such as line of sight checks for a group of AI players.\n"
+
+   "@param rays A list of rays separated by tabs or newlines.  Each ray is given as the "
+   "six numbers \"startX startY startZ endX endY endZ\".\n"
+   "@param mask A bitmask corresponding to the type of objects to check for\n"
+   "@param useClientContainer Optionally indicates the search should be within the "
+   "client container.\n"
+
+   "@returns A newline separated list with one result per ray in the format returned by "
+   "containerRayCast(): either 0 if nothing was struck, or the ID of the object struck "
+   "followed by the hit position, the normal and the distance.\n"
+
+   "@ingroup Game")
+{
+   Vector< SceneContainer::RayQuery > queries;
+
+   // Parse the rays in one pass rather than with getUnit() per ray.
+   const char* ptr = rays;
+   while ( *ptr )
+   {
+      SceneContainer::RayQuery query;
+      query.mask = mask;
+      if ( dSscanf( ptr, "%g %g %g %g %g %g",
+              &query.start.x, &query.start.y, &query.start.z,
+              &query.end.x, &query.end.y, &query.end.z ) != 6 )
+      {
+         // Keep the results lined up with the rays.  A ray that matches
+         // no object types never hits, so the slot reports 0.
+         Con::warnf( "containerRayCastBatch - Invalid ray %d", queries.size() );
+         query.start.zero();
+         query.end.zero();
+         query.mask = 0;
+      }
+
+      queries.push_back( query );
+
+      while ( *ptr && *ptr != '\t' && *ptr != '\n' )
+         ptr++;
+      while ( *ptr == '\t' || *ptr == '\n' )
+         ptr++;
+   }
+
+   if ( queries.empty() )
+      return "";
+
+   Vector< RayInfo > infos;
+   infos.setSize( queries.size() );
+
+   SceneContainer* pContainer = useClientContainer ? &gClientContainer : &gServerContainer;
+   pContainer->castRayBatch( queries.address(), queries.size(), infos.address() );
+
+   static const U32 lineSize = 128;
+   const U32 bufSize = queries.size() * lineSize;
+   char *returnBuffer = Con::getReturnBuffer( bufSize );
+   U32 length = 0;
+   for ( U32 i = 0; i < infos.size(); i++ )
+   {
+      const RayInfo& rinfo = infos[ i ];
+      const char* separator = i ? "\n" : "";
+      if ( rinfo.object )
+         length += dSprintf( returnBuffer + length, bufSize - length, "%s%d %g %g %g %g %g %g %g",
+            separator, rinfo.object->getId(), rinfo.point.x, rinfo.point.y, rinfo.point.z,
+            rinfo.normal.x, rinfo.normal.y, rinfo.normal.z, rinfo.distance );
+      else
+         length += dSprintf( returnBuffer + length, bufSize - length, "%s0", separator );
+   }
+
+   return returnBuffer;
+}
+
+//-----------------------------------------------------------------------------
+
+DefineEngineFunction( containerSetSpatialIndex, bool, ( const char* type, bool useClientContainer ), ( false ),
+   "@brief Change the spatial index used to look up objects in a container.\n\n"
+   "@param type Either \"octree\" for the adaptive loose octree (the default) or \"bins\" "
+   "for the fixed 16x16 grid of bins.\n"
+   "@param useClientContainer Optionally indicates the client container should be changed.\n"
+   "@return True if the index type is known.\n"
+   "@ingroup Game")
+{
+   SceneSpatialIndex* index = SceneSpatialIndex::create( type );
+   if ( !index )
+   {
+      Con::errorf( "containerSetSpatialIndex - Unknown index type '%s'", type );
+      return false;
+   }
+
+   SceneContainer* pContainer = useClientContainer ? &gClientContainer : &gServerContainer;
+   pContainer->setSpatialIndex( index );
+   return true;
+}
+
+//-----------------------------------------------------------------------------
+
+DefineEngineFunction( containerGetQueryStats, const char*, ( bool useClientContainer ), ( false ),
+   "@brief Get the work done by the spatial index of a container.\n\n"
+   "@param useClientContainer Optionally indicates the client container should be used.\n"
+   "@return A string with the nodes and objects visited by the last query followed by "
+   "the average nodes and objects visited per query since the last call.\n"
+   "@ingroup Game")
+{
+   SceneContainer* pContainer = useClientContainer ? &gClientContainer : &gServerContainer;
+   SceneSpatialIndex* index = pContainer->getSpatialIndex();
+
+   const SceneSpatialIndex::QueryStats& last = index->getLastQueryStats();
+   const SceneSpatialIndex::QueryStats& total = index->getTotalQueryStats();
+   const F32 numQueries = getMax( index->getNumQueries(), U32( 1 ) );
+
+   static const U32 bufSize = 128;
+   char *returnBuffer = Con::getReturnBuffer(bufSize);
+   dSprintf( returnBuffer, bufSize, "%d %d %g %g",
+      last.nodesVisited, last.objectsVisited,
+      total.nodesVisited / numQueries, total.objectsVisited / numQueries );
+
+   index->resetQueryStats();
+   return returnBuffer;
+}
+
 ConsoleFunctionGroupEnd( Containers );
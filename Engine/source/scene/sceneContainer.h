@@ -43,6 +43,10 @@
 #include "console/simObject.h"
 #endif
 
+#ifndef _SCENESPATIALINDEX_H_
+#include "scene/sceneSpatialIndex.h"
+#endif
+
 
 /// @file
 /// SceneObject database.
@@ -133,7 +137,8 @@ class SimpleQueryList
 
 /// Database for SceneObjects.
 ///
-/// ScenceContainer implements a grid-based spatial subdivision for the contents of a scene.
+/// SceneContainer keeps the contents of a scene in a SceneSpatialIndex, by
+/// default an adaptive loose octree.
 class SceneContainer
 {
       enum CastRayType
@@ -171,14 +176,11 @@ class SceneContainer
       /// this is used to detect when it happens.
       bool mSearchInProgress;
 
-      /// Current sequence key.
-      U32 mCurrSeqKey;
+      /// Spatial index of the objects.
+      SceneSpatialIndex* mIndex;
 
-      SceneObjectRef* mFreeRefPool;
-      Vector< SceneObjectRef* > mRefPoolBlocks;
-
-      SceneObjectRef* mBinArray;
-      SceneObjectRef mOverflowBin;
+      /// Objects found by the current query.
+      Vector< SceneObject* > mQueryList;
 
       /// A vector that contains just the water and physical zone
       /// object types which is used to optimize searches.
@@ -187,11 +189,6 @@ class SceneContainer
       /// Vector that contains just the terrain objects in the container.
       Vector< SceneObject* > mTerrains;
 
-      static const U32 csmNumBins;
-      static const F32 csmBinSize;
-      static const F32 csmTotalBinSize;
-      static const U32 csmRefPoolBlockSize;
-
    public:
 
       SceneContainer();
@@ -247,6 +244,35 @@ class SceneContainer
 
       bool collideBox(const Point3F &start, const Point3F &end, U32 mask, RayInfo* info);
 
+      /// A ray for castRayBatch().
+      struct RayQuery
+      {
+         Point3F start;
+         Point3F end;
+
+         /// Object type mask (@see SimObjectTypes).
+         U32 mask;
+      };
+
+      /// Number of rays tested together against an object's world box.
+      static const U32 csmRayPacketSize = 8;
+
+      /// Test many rays against collision geometry at once.
+      ///
+      /// Rays are sorted by position and grouped into packets.  The spatial
+      /// index is traversed once per packet and each candidate object's world
+      /// box is tested against all rays of the packet at once before the
+      /// per object castRay() is run for the rays that reach it.
+      ///
+      /// @param rays The rays to cast.
+      /// @param numRays Number of rays.
+      /// @param outInfo Receives the closest hit of each ray.  The object of
+      ///    rays that do not hit anything is set to NULL.  As with castRay(),
+      ///    the generateTexCoord flag of each entry is passed on to the
+      ///    objects' castRay().
+      /// @return The number of rays that hit something.
+      U32 castRayBatch( const RayQuery* rays, U32 numRays, RayInfo* outInfo );
+
       /// @}
 
       /// @name Poly list
@@ -268,17 +294,16 @@ class SceneContainer
       /// @param object A SceneObject.
       bool removeObject( SceneObject* object );
 
-      void addRefPoolBlock();
-      SceneObjectRef* allocateObjectRef();
-      void freeObjectRef(SceneObjectRef*);
-      void insertIntoBins( SceneObject* object );
-      void removeFromBins( SceneObject* object );
-
-      /// Make sure that we're not just sticking the object right back
-      /// where it came from.  The overloaded insertInto is so we don't calculate
-      /// the ranges twice.
+      /// Update the object in the spatial index after its world box changed.
       void checkBins( SceneObject* object );
-      void insertIntoBins(SceneObject*, U32, U32, U32, U32);
+
+      /// Replace the spatial index, moving all objects over to it.
+      /// The container takes ownership of the index.
+      void setSpatialIndex( SceneSpatialIndex* index );
+
+      /// Return the spatial index.  Its query stats tell how much work the
+      /// last queries took.
+      SceneSpatialIndex* getSpatialIndex() const { return mIndex; }
 
       void initRadiusSearch(const Point3F& searchPoint,
          const F32      searchRadius,
@@ -297,13 +322,14 @@ class SceneContainer
 
       void cleanupSearchVectors();
 
+      /// Add the objects matching the mask that overlap the box to the list.
+      void _findInBox( const Box3F& box, U32 mask, Vector< SceneObject* >* outFound );
+
       /// Base cast ray code
       bool _castRay( U32 type, const Point3F &start, const Point3F &end, U32 mask, RayInfo* info, CastRayCallback callback );
 
       void _findSpecialObjects( const Vector< SceneObject* >& vector, U32 mask, FindCallback, void *key = NULL );
       void _findSpecialObjects( const Vector< SceneObject* >& vector, const Box3F &box, U32 mask, FindCallback callback, void *key = NULL );   
-
-      static void getBinRange( const F32 min, const F32 max, U32& minBin, U32& maxBin );
 };
 
 //-----------------------------------------------------------------------------
@@ -311,30 +337,4 @@ class SceneContainer
 extern SceneContainer gServerContainer;
 extern SceneContainer gClientContainer;
 
-//-----------------------------------------------------------------------------
-
-inline void SceneContainer::freeObjectRef(SceneObjectRef* trash)
-{
-   trash->object = NULL;
-   trash->nextInBin = NULL;
-   trash->prevInBin = NULL;
-   trash->nextInObj = mFreeRefPool;
-   mFreeRefPool     = trash;
-}
-
-//-----------------------------------------------------------------------------
-
-inline SceneObjectRef* SceneContainer::allocateObjectRef()
-{
-   if( mFreeRefPool == NULL )
-      addRefPoolBlock();
-   AssertFatal( mFreeRefPool!=NULL, "Error, should always have a free reference here!" );
-
-   SceneObjectRef* ret = mFreeRefPool;
-   mFreeRefPool = mFreeRefPool->nextInObj;
-
-   ret->nextInObj = NULL;
-   return ret;
-}
-
 #endif // !_SCENECONTAINER_H_
\ No newline at end of file
@@ -0,0 +1,362 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "scene/sceneLooseOctree.h"
+
+#include "scene/sceneObject.h"
+#include "platform/profiler.h"
+
+
+const F32 SceneLooseOctree::csmInitialHalfSize = 512.0f;
+const F32 SceneLooseOctree::csmMinHalfSize = 4.0f;
+const F32 SceneLooseOctree::csmMaxHalfSize = 1048576.0f;
+
+//-----------------------------------------------------------------------------
+
+SceneLooseOctree::SceneLooseOctree()
+{
+   mNumNodes = 0;
+
+   mOverflow.center.zero();
+   mOverflow.halfSize = 0.0f;
+   mOverflow.parent = NULL;
+   mOverflow.numChildren = 0;
+   for ( U32 i = 0; i < 8; i++ )
+      mOverflow.children[ i ] = NULL;
+
+   VECTOR_SET_ASSOCIATION( mStack );
+
+   mRoot = _allocNode( NULL, Point3F::Zero, csmInitialHalfSize );
+}
+
+//-----------------------------------------------------------------------------
+
+SceneLooseOctree::~SceneLooseOctree()
+{
+   mStack.clear();
+   mStack.push_back( mRoot );
+   mStack.push_back( &mOverflow );
+
+   while ( mStack.size() )
+   {
+      Node* node = mStack.last();
+      mStack.pop_back();
+
+      for ( U32 i = 0; i < node->objects.size(); i++ )
+         Con::warnf( "Error, a %s (%x) isn't properly out of the octree!", node->objects[ i ]->getClassName(), node->objects[ i ] );
+
+      for ( U32 i = 0; i < 8; i++ )
+         if ( node->children[ i ] )
+            mStack.push_back( node->children[ i ] );
+
+      if ( node != &mOverflow )
+         _freeNode( node );
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+SceneLooseOctree::Node* SceneLooseOctree::_allocNode( Node* parent, const Point3F& center, F32 halfSize )
+{
+   Node* node = mNodeChunker.alloc();
+
+   node->center = center;
+   node->halfSize = halfSize;
+   node->parent = parent;
+   node->numChildren = 0;
+   for ( U32 i = 0; i < 8; i++ )
+      node->children[ i ] = NULL;
+
+   mNumNodes++;
+   return node;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneLooseOctree::_freeNode( Node* node )
+{
+   mNodeChunker.free( node );
+   mNumNodes--;
+}
+
+//-----------------------------------------------------------------------------
+
+static inline bool isInCell( const SceneOctreeNode* node, const Point3F& point )
+{
+   const F32 size = node->halfSize;
+   return point.x >= node->center.x - size && point.x < node->center.x + size &&
+          point.y >= node->center.y - size && point.y < node->center.y + size &&
+          point.z >= node->center.z - size && point.z < node->center.z + size;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneLooseOctree::_growRoot( const Point3F& towards )
+{
+   Node* oldRoot = mRoot;
+   const F32 size = oldRoot->halfSize;
+
+   Point3F offset( towards.x >= oldRoot->center.x ? size : -size,
+                   towards.y >= oldRoot->center.y ? size : -size,
+                   towards.z >= oldRoot->center.z ? size : -size );
+
+   mRoot = _allocNode( NULL, oldRoot->center + offset, size * 2.0f );
+
+   // An empty root is not worth keeping around as a child.
+   if ( oldRoot->objects.empty() && !oldRoot->numChildren )
+      _freeNode( oldRoot );
+   else
+   {
+      mRoot->children[ _getChildIndex( mRoot, oldRoot->center ) ] = oldRoot;
+      mRoot->numChildren = 1;
+      oldRoot->parent = mRoot;
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+SceneLooseOctree::Node* SceneLooseOctree::_findNode( const Box3F& worldBox, bool globalBounds )
+{
+   if ( globalBounds )
+      return &mOverflow;
+
+   Point3F center = worldBox.getCenter();
+   const F32 halfExtent = _getHalfExtent( worldBox );
+
+   // This also catches NaNs.
+   if ( !( halfExtent <= csmMaxHalfSize ) || mIsNaN_F( center.x ) || mIsNaN_F( center.y ) || mIsNaN_F( center.z ) )
+      return &mOverflow;
+
+   while ( !isInCell( mRoot, center ) || halfExtent > mRoot->halfSize )
+   {
+      if ( mRoot->halfSize >= csmMaxHalfSize )
+         return &mOverflow;
+
+      _growRoot( center );
+   }
+
+   // Walk down while the object fits into the children.
+   Node* node = mRoot;
+   for ( ;; )
+   {
+      const F32 childSize = node->halfSize * 0.5f;
+      if ( childSize < csmMinHalfSize || halfExtent > childSize )
+         break;
+
+      const U32 index = _getChildIndex( node, center );
+      if ( !node->children[ index ] )
+      {
+         Point3F childCenter( node->center.x + ( index & 1 ? childSize : -childSize ),
+                              node->center.y + ( index & 2 ? childSize : -childSize ),
+                              node->center.z + ( index & 4 ? childSize : -childSize ) );
+
+         node->children[ index ] = _allocNode( node, childCenter, childSize );
+         node->numChildren++;
+      }
+
+      node = node->children[ index ];
+   }
+
+   return node;
+}
+
+//-----------------------------------------------------------------------------
+
+bool SceneLooseOctree::_isInPlace( const Node* node, const Box3F& worldBox, bool globalBounds ) const
+{
+   if ( node == &mOverflow )
+      return globalBounds;
+   if ( globalBounds )
+      return false;
+
+   const F32 halfExtent = _getHalfExtent( worldBox );
+   if ( !( halfExtent <= node->halfSize ) || !isInCell( node, worldBox.getCenter() ) )
+      return false;
+
+   // It also has to be too big for the children.
+   const F32 childSize = node->halfSize * 0.5f;
+   return childSize < csmMinHalfSize || halfExtent > childSize;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneLooseOctree::_addToNode( Node* node, SceneObject* object )
+{
+   object->mOctreeNode = node;
+   object->mOctreeSlot = node->objects.size();
+   node->objects.push_back( object );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneLooseOctree::_removeFromNode( SceneObject* object )
+{
+   Node* node = object->mOctreeNode;
+   const U32 slot = object->mOctreeSlot;
+   AssertFatal( node->objects[ slot ] == object, "SceneLooseOctree::_removeFromNode - Object is not where it should be!" );
+
+   SceneObject* last = node->objects.last();
+   node->objects[ slot ] = last;
+   last->mOctreeSlot = slot;
+   node->objects.pop_back();
+
+   object->mOctreeNode = NULL;
+
+   if ( node != &mOverflow )
+      _pruneNode( node );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneLooseOctree::_pruneNode( Node* node )
+{
+   while ( node != mRoot && node->objects.empty() && !node->numChildren )
+   {
+      Node* parent = node->parent;
+      for ( U32 i = 0; i < 8; i++ )
+      {
+         if ( parent->children[ i ] == node )
+         {
+            parent->children[ i ] = NULL;
+            parent->numChildren--;
+            break;
+         }
+      }
+
+      _freeNode( node );
+      node = parent;
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneLooseOctree::insertObject( SceneObject* object )
+{
+   PROFILE_SCOPE( SceneLooseOctree_InsertObject );
+   AssertFatal( object->mOctreeNode == NULL, "SceneLooseOctree::insertObject - Object is already in the tree!" );
+
+   _addToNode( _findNode( object->getWorldBox(), object->isGlobalBounds() ), object );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneLooseOctree::removeObject( SceneObject* object )
+{
+   if ( object->mOctreeNode )
+      _removeFromNode( object );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneLooseOctree::updateObject( SceneObject* object )
+{
+   PROFILE_SCOPE( SceneLooseOctree_UpdateObject );
+
+   if ( object->mOctreeNode )
+   {
+      if ( _isInPlace( object->mOctreeNode, object->getWorldBox(), object->isGlobalBounds() ) )
+         return;
+
+      _removeFromNode( object );
+   }
+
+   _addToNode( _findNode( object->getWorldBox(), object->isGlobalBounds() ), object );
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneLooseOctree::findInBox( const Box3F& box, VisitCallback callback, void* key )
+{
+   _beginQuery();
+
+   mStack.clear();
+   mStack.push_back( &mOverflow );
+   mStack.push_back( mRoot );
+
+   Box3F looseBox;
+   while ( mStack.size() )
+   {
+      Node* node = mStack.last();
+      mStack.pop_back();
+      mLastQuery.nodesVisited++;
+
+      if ( node != &mOverflow )
+      {
+         _getLooseBox( node, looseBox );
+         if ( !looseBox.isOverlapped( box ) )
+            continue;
+      }
+
+      for ( U32 i = 0; i < node->objects.size(); i++ )
+         callback( node->objects[ i ], key );
+      mLastQuery.objectsVisited += node->objects.size();
+
+      if ( node->numChildren )
+      {
+         for ( U32 i = 0; i < 8; i++ )
+            if ( node->children[ i ] )
+               mStack.push_back( node->children[ i ] );
+      }
+   }
+
+   _endQuery();
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneLooseOctree::findOnLine( const Point3F& start, const Point3F& end, VisitCallback callback, void* key )
+{
+   _beginQuery();
+
+   mStack.clear();
+   mStack.push_back( &mOverflow );
+   mStack.push_back( mRoot );
+
+   Box3F looseBox;
+   while ( mStack.size() )
+   {
+      Node* node = mStack.last();
+      mStack.pop_back();
+      mLastQuery.nodesVisited++;
+
+      if ( node != &mOverflow )
+      {
+         _getLooseBox( node, looseBox );
+         if ( !looseBox.collideLine( start, end ) )
+            continue;
+      }
+
+      for ( U32 i = 0; i < node->objects.size(); i++ )
+         callback( node->objects[ i ], key );
+      mLastQuery.objectsVisited += node->objects.size();
+
+      if ( node->numChildren )
+      {
+         for ( U32 i = 0; i < 8; i++ )
+            if ( node->children[ i ] )
+               mStack.push_back( node->children[ i ] );
+      }
+   }
+
+   _endQuery();
+}
@@ -0,0 +1,154 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SCENELOOSEOCTREE_H_
+#define _SCENELOOSEOCTREE_H_
+
+#ifndef _SCENESPATIALINDEX_H_
+#include "scene/sceneSpatialIndex.h"
+#endif
+
+#ifndef _DATACHUNKER_H_
+#include "core/dataChunker.h"
+#endif
+
+
+/// A node of a SceneLooseOctree.
+struct SceneOctreeNode
+{
+   /// Center of the node's cell.
+   Point3F center;
+
+   /// Half the edge length of the node's cell.  Objects in the node may
+   /// extend up to twice this far from the center.
+   F32 halfSize;
+
+   SceneOctreeNode* parent;
+   SceneOctreeNode* children[ 8 ];
+
+   /// Number of non-NULL entries in #children.
+   U32 numChildren;
+
+   /// The objects stored at this node.
+   Vector< SceneObject* > objects;
+};
+
+
+/// A loose octree that grows to cover the objects inserted into it.
+///
+/// Each object is stored once, in the deepest node whose cell contains the
+/// center of the object's world box and whose half size is at least the
+/// object's largest half extent.  Node bounds are loosened to twice the cell
+/// size, so an object never needs to be split across nodes and moving
+/// objects rarely change nodes.
+///
+/// The root starts out covering the area around the origin and doubles in
+/// size towards objects placed outside of it, so the tree follows the
+/// extents of the level instead of wrapping like the bin grid.  Objects
+/// with global bounds or positions beyond csmMaxHalfSize are kept in an
+/// overflow list that every query visits.
+class SceneLooseOctree : public SceneSpatialIndex
+{
+   public:
+
+      typedef SceneOctreeNode Node;
+
+      /// Half size of the root node when the tree is created.
+      static const F32 csmInitialHalfSize;
+
+      /// Half size below which nodes are not subdivided further.
+      static const F32 csmMinHalfSize;
+
+      /// Half size beyond which the root does not grow.
+      static const F32 csmMaxHalfSize;
+
+      SceneLooseOctree();
+      virtual ~SceneLooseOctree();
+
+      // SceneSpatialIndex.
+      virtual const char* getName() const { return "octree"; }
+      virtual void insertObject( SceneObject* object );
+      virtual void removeObject( SceneObject* object );
+      virtual void updateObject( SceneObject* object );
+      virtual void findInBox( const Box3F& box, VisitCallback callback, void* key );
+      virtual void findOnLine( const Point3F& start, const Point3F& end, VisitCallback callback, void* key );
+
+      /// Return the root node.
+      const Node* getRoot() const { return mRoot; }
+
+      /// Return the number of nodes in the tree.
+      U32 getNumNodes() const { return mNumNodes; }
+
+   protected:
+
+      ClassChunker< Node > mNodeChunker;
+
+      Node* mRoot;
+
+      /// Objects that do not fit into the tree.
+      Node mOverflow;
+
+      U32 mNumNodes;
+
+      /// Stack used by the queries.
+      Vector< Node* > mStack;
+
+      Node* _allocNode( Node* parent, const Point3F& center, F32 halfSize );
+      void _freeNode( Node* node );
+
+      /// Return the node the object belongs in, growing the tree if needed.
+      Node* _findNode( const Box3F& worldBox, bool globalBounds );
+
+      /// Return true if an object with the given world box is in the node
+      /// it would be inserted into.
+      bool _isInPlace( const Node* node, const Box3F& worldBox, bool globalBounds ) const;
+
+      /// Double the root towards the point.
+      void _growRoot( const Point3F& towards );
+
+      void _addToNode( Node* node, SceneObject* object );
+      void _removeFromNode( SceneObject* object );
+
+      /// Free empty leaf nodes, walking up from the given node.
+      void _pruneNode( Node* node );
+
+      static void _getLooseBox( const Node* node, Box3F& outBox )
+      {
+         const F32 size = node->halfSize * 2.0f;
+         outBox.minExtents = node->center - Point3F( size, size, size );
+         outBox.maxExtents = node->center + Point3F( size, size, size );
+      }
+
+      static U32 _getChildIndex( const Node* node, const Point3F& point )
+      {
+         return ( point.x >= node->center.x ? 1 : 0 ) |
+                ( point.y >= node->center.y ? 2 : 0 ) |
+                ( point.z >= node->center.z ? 4 : 0 );
+      }
+
+      static F32 _getHalfExtent( const Box3F& box )
+      {
+         return getMax( box.len_x(), getMax( box.len_y(), box.len_z() ) ) * 0.5f;
+      }
+};
+
+#endif // _SCENELOOSEOCTREE_H_
@@ -86,6 +86,22 @@ MODULE_BEGIN( Scene )
       Con::addVariable( "$Scene::occluderMinHeightPercentage", TypeF32, &SceneCullingState::smOccluderMinHeightPercentage,
          "TODO\n\n"
          "@ingroup Rendering" );
+
+      Con::addVariable( "$Scene::batchCulling", TypeBool, &SceneCullingState::smBatchCulling,
+         "If true, large object lists are culled by testing groups of bounding boxes at once.\n\n"
+         "@ingroup Rendering" );
+
+      Con::addVariable( "$Scene::minBatchCullObjects", TypeS32, &SceneCullingState::smMinBatchCullObjects,
+         "Object lists shorter than this are culled one object at a time.\n\n"
+         "@ingroup Rendering" );
+
+      Con::addVariable( "$Scene::minParallelCullObjects", TypeS32, &SceneCullingState::smMinParallelCullObjects,
+         "Object lists at least this long are culled on the worker threads.\n\n"
+         "@ingroup Rendering" );
+
+      Con::addVariable( "$Scene::boxesPerCullJob", TypeS32, &SceneCullingState::smBoxesPerCullJob,
+         "The number of bounding boxes tested by each culling job.\n\n"
+         "@ingroup Rendering" );
    }
    
    MODULE_SHUTDOWN
@@ -469,6 +485,9 @@ void SceneManager::_renderScene( SceneRenderState* state, U32 objectMask, SceneZ
 
    // Render the remaining objects.
 
+   // Animate the shapes across the worker threads before they are batched.
+   ShapeBase::animateRenderList( mBatchQueryList.address(), numRenderObjects );
+
    PROFILE_START( Scene_renderObjects );
    state->renderObjects( mBatchQueryList.address(), numRenderObjects );
    PROFILE_END();
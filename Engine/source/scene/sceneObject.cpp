@@ -129,6 +129,8 @@ SceneObject::SceneObject()
    mBinMaxX = 0xFFFFFFFF;
    mBinMinY = 0xFFFFFFFF;
    mBinMaxY = 0xFFFFFFFF;
+   mOctreeNode = NULL;
+   mOctreeSlot = 0;
    mLightPlugin = NULL;
 
    mMount.object = NULL;
@@ -151,7 +153,7 @@ SceneObject::SceneObject()
 
 SceneObject::~SceneObject()
 {
-   AssertFatal( mZoneRefHead == NULL && mBinRefHead == NULL,
+   AssertFatal( mZoneRefHead == NULL && mBinRefHead == NULL && mOctreeNode == NULL,
       "SceneObject::~SceneObject - Object still linked in reference lists!");
    AssertFatal( !mSceneObjectLinks,
       "SceneObject::~SceneObject() - object is still linked to SceneTrackers" );
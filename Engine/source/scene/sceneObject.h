@@ -68,6 +68,7 @@ class LightInfo;
 class SFXAmbience;
 
 struct ObjectRenderInst;
+struct SceneOctreeNode;
 struct Move;
 
 
@@ -102,6 +103,8 @@ class SceneObject : public NetObject, private SceneContainer::Link, public Proce
 
       friend class SceneManager;
       friend class SceneContainer;
+      friend class SceneBinGrid;
+      friend class SceneLooseOctree;
       friend class SceneZoneSpaceManager;
       friend class SceneCullingState; // _getZoneRefHead
       friend class SceneObjectLink; // mSceneObjectLinks
@@ -349,6 +352,12 @@ class SceneObject : public NetObject, private SceneContainer::Link, public Proce
       U32 mBinMinY;
       U32 mBinMaxY;
 
+      /// Octree node holding the object if the container uses a SceneLooseOctree.
+      SceneOctreeNode* mOctreeNode;
+
+      /// Index of the object in the objects of #mOctreeNode.
+      U32 mOctreeSlot;
+
       /// Returns the container sequence key.
       U32 getContainerSeqKey() const { return mContainerSeqKey; }
 
@@ -0,0 +1,558 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "scene/sceneSpatialIndex.h"
+
+#include "scene/sceneContainer.h"
+#include "scene/sceneObject.h"
+#include "scene/sceneLooseOctree.h"
+#include "platform/profiler.h"
+
+
+//=============================================================================
+//    SceneSpatialIndex.
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+
+SceneSpatialIndex::SceneSpatialIndex()
+{
+   _beginQuery();
+   resetQueryStats();
+}
+
+//-----------------------------------------------------------------------------
+
+SceneSpatialIndex* SceneSpatialIndex::create( const char* name )
+{
+   if ( dStricmp( name, "bins" ) == 0 )
+      return new SceneBinGrid;
+   if ( dStricmp( name, "octree" ) == 0 )
+      return new SceneLooseOctree;
+
+   return NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneSpatialIndex::resetQueryStats()
+{
+   mTotalQuery.nodesVisited = 0;
+   mTotalQuery.objectsVisited = 0;
+   mNumQueries = 0;
+}
+
+//=============================================================================
+//    SceneBinGrid.
+//=============================================================================
+
+const U32 SceneBinGrid::csmNumBins = 16;
+const F32 SceneBinGrid::csmBinSize = 64;
+const F32 SceneBinGrid::csmTotalBinSize = SceneBinGrid::csmBinSize * SceneBinGrid::csmNumBins;
+const U32 SceneBinGrid::csmRefPoolBlockSize = 4096;
+
+//-----------------------------------------------------------------------------
+
+SceneBinGrid::SceneBinGrid()
+{
+   mCurrSeqKey = 0;
+
+   mBinArray = new SceneObjectRef[csmNumBins * csmNumBins + 1];
+   for (U32 i = 0; i < csmNumBins * csmNumBins + 1; i++) 
+   {
+      mBinArray[i].object    = NULL;
+      mBinArray[i].nextInBin = NULL;
+      mBinArray[i].prevInBin = NULL;
+      mBinArray[i].nextInObj = NULL;
+   }
+
+   // The overflow bin lives at the end of the bin array.
+   mOverflowBin = &mBinArray[csmNumBins * csmNumBins];
+
+   VECTOR_SET_ASSOCIATION( mRefPoolBlocks );
+
+   mFreeRefPool = NULL;
+   addRefPoolBlock();
+}
+
+//-----------------------------------------------------------------------------
+
+SceneBinGrid::~SceneBinGrid()
+{
+   delete[] mBinArray;
+
+   for (U32 i = 0; i < mRefPoolBlocks.size(); i++)
+   {
+      SceneObjectRef* pool = mRefPoolBlocks[i];
+      for (U32 j = 0; j < csmRefPoolBlockSize; j++)
+      {
+         // Depressingly, this can give weird results if its pointing at bad memory...
+         if(pool[j].object != NULL)
+            Con::warnf("Error, a %s (%x) isn't properly out of the bins!", pool[j].object->getClassName(), pool[j].object);
+
+         // If you're getting this it means that an object created didn't
+         // remove itself from its container before we destroyed the
+         // container. Typically you get this behavior from particle
+         // emitters, as they try to hang around until all their particles
+         // die. In general it's benign, though if you get it for things
+         // that aren't particle emitters it can be a bad sign!
+      }
+
+      delete [] pool;
+   }
+   mFreeRefPool = NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneBinGrid::addRefPoolBlock()
+{
+   mRefPoolBlocks.push_back(new SceneObjectRef[csmRefPoolBlockSize]);
+   for (U32 i = 0; i < csmRefPoolBlockSize-1; i++)
+   {
+      mRefPoolBlocks.last()[i].object    = NULL;
+      mRefPoolBlocks.last()[i].prevInBin = NULL;
+      mRefPoolBlocks.last()[i].nextInBin = NULL;
+      mRefPoolBlocks.last()[i].nextInObj = &(mRefPoolBlocks.last()[i+1]);
+   }
+   mRefPoolBlocks.last()[csmRefPoolBlockSize-1].object    = NULL;
+   mRefPoolBlocks.last()[csmRefPoolBlockSize-1].prevInBin = NULL;
+   mRefPoolBlocks.last()[csmRefPoolBlockSize-1].nextInBin = NULL;
+   mRefPoolBlocks.last()[csmRefPoolBlockSize-1].nextInObj = mFreeRefPool;
+
+   mFreeRefPool = &(mRefPoolBlocks.last()[0]);
+}
+
+//-----------------------------------------------------------------------------
+
+inline void SceneBinGrid::freeObjectRef(SceneObjectRef* trash)
+{
+   trash->object = NULL;
+   trash->nextInBin = NULL;
+   trash->prevInBin = NULL;
+   trash->nextInObj = mFreeRefPool;
+   mFreeRefPool     = trash;
+}
+
+//-----------------------------------------------------------------------------
+
+inline SceneObjectRef* SceneBinGrid::allocateObjectRef()
+{
+   if( mFreeRefPool == NULL )
+      addRefPoolBlock();
+   AssertFatal( mFreeRefPool!=NULL, "Error, should always have a free reference here!" );
+
+   SceneObjectRef* ret = mFreeRefPool;
+   mFreeRefPool = mFreeRefPool->nextInObj;
+
+   ret->nextInObj = NULL;
+   return ret;
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneBinGrid::insertObject(SceneObject* obj)
+{
+   AssertFatal(obj != NULL, "No object?");
+
+   // The first thing we do is find which bins are covered in x and y...
+   const Box3F* pWBox = &obj->getWorldBox();
+
+   U32 minX, maxX, minY, maxY;
+   getBinRange(pWBox->minExtents.x, pWBox->maxExtents.x, minX, maxX);
+   getBinRange(pWBox->minExtents.y, pWBox->maxExtents.y, minY, maxY);
+
+   insertIntoBins(obj, minX, maxX, minY, maxY);
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneBinGrid::insertIntoBins(SceneObject* obj,
+                                  U32 minX, U32 maxX,
+                                  U32 minY, U32 maxY)
+{
+   PROFILE_START(InsertBins);
+   AssertFatal(obj != NULL, "No object?");
+
+   AssertFatal(obj->mBinRefHead == NULL, "Error, already have a bin chain!");
+   // Store the current regions for later queries
+   obj->mBinMinX = minX;
+   obj->mBinMaxX = maxX;
+   obj->mBinMinY = minY;
+   obj->mBinMaxY = maxY;
+
+   // For huge objects, dump them into the overflow bin.  Otherwise, everything
+   //  goes into the grid...
+   if (!obj->isGlobalBounds() && ((maxX - minX + 1) < csmNumBins || (maxY - minY + 1) < csmNumBins))
+   {
+      SceneObjectRef** pCurrInsert = &obj->mBinRefHead;
+
+      for (U32 i = minY; i <= maxY; i++)
+      {
+         U32 insertY = i % csmNumBins;
+         U32 base    = insertY * csmNumBins;
+         for (U32 j = minX; j <= maxX; j++)
+         {
+            U32 insertX = j % csmNumBins;
+
+            SceneObjectRef* ref = allocateObjectRef();
+
+            ref->object    = obj;
+            ref->nextInBin = mBinArray[base + insertX].nextInBin;
+            ref->prevInBin = &mBinArray[base + insertX];
+            ref->nextInObj = NULL;
+
+            if (mBinArray[base + insertX].nextInBin)
+               mBinArray[base + insertX].nextInBin->prevInBin = ref;
+            mBinArray[base + insertX].nextInBin = ref;
+
+            *pCurrInsert = ref;
+            pCurrInsert  = &ref->nextInObj;
+         }
+      }
+   }
+   else
+   {
+      SceneObjectRef* ref = allocateObjectRef();
+
+      ref->object    = obj;
+      ref->nextInBin = mOverflowBin->nextInBin;
+      ref->prevInBin = mOverflowBin;
+      ref->nextInObj = NULL;
+
+      if (mOverflowBin->nextInBin)
+         mOverflowBin->nextInBin->prevInBin = ref;
+      mOverflowBin->nextInBin = ref;
+      obj->mBinRefHead = ref;
+   }
+   PROFILE_END();
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneBinGrid::removeObject(SceneObject* obj)
+{
+   PROFILE_START(RemoveFromBins);
+   AssertFatal(obj != NULL, "No object?");
+
+   SceneObjectRef* chain = obj->mBinRefHead;
+   obj->mBinRefHead = NULL;
+
+   while (chain)
+   {
+      SceneObjectRef* trash = chain;
+      chain = chain->nextInObj;
+
+      AssertFatal(trash->prevInBin != NULL, "Error, must have a previous entry in the bin!");
+      if (trash->nextInBin)
+         trash->nextInBin->prevInBin = trash->prevInBin;
+      trash->prevInBin->nextInBin = trash->nextInBin;
+
+      freeObjectRef(trash);
+   }
+   PROFILE_END();
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneBinGrid::updateObject(SceneObject* obj)
+{
+   AssertFatal(obj != NULL, "No object?");
+
+   PROFILE_START(CheckBins);
+   if (obj->mBinRefHead == NULL)
+   {
+      insertObject(obj);
+      PROFILE_END();
+      return;
+   }
+
+   // Otherwise, the object is already in the bins.  Let's see if it has strayed out of
+   //  the bins that it's currently in...
+   const Box3F* pWBox = &obj->getWorldBox();
+
+   U32 minX, maxX, minY, maxY;
+   getBinRange(pWBox->minExtents.x, pWBox->maxExtents.x, minX, maxX);
+   getBinRange(pWBox->minExtents.y, pWBox->maxExtents.y, minY, maxY);
+
+   if (obj->mBinMinX != minX || obj->mBinMaxX != maxX ||
+       obj->mBinMinY != minY || obj->mBinMaxY != maxY)
+   {
+      // We have to rebin the object
+      removeObject(obj);
+      insertIntoBins(obj, minX, maxX, minY, maxY);
+   }
+   PROFILE_END();
+}
+
+//-----------------------------------------------------------------------------
+
+inline void SceneBinGrid::_visitChain(SceneObjectRef* chain, VisitCallback callback, void* key)
+{
+   mLastQuery.nodesVisited++;
+
+   for ( ; chain; chain = chain->nextInBin)
+   {
+      SceneObject* object = chain->object;
+      if (object->getContainerSeqKey() == mCurrSeqKey)
+         continue;
+
+      object->setContainerSeqKey(mCurrSeqKey);
+      mLastQuery.objectsVisited++;
+      callback(object, key);
+   }
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneBinGrid::findInBox(const Box3F& box, VisitCallback callback, void* key)
+{
+   _beginQuery();
+
+   U32 minX, maxX, minY, maxY;
+   getBinRange(box.minExtents.x, box.maxExtents.x, minX, maxX);
+   getBinRange(box.minExtents.y, box.maxExtents.y, minY, maxY);
+   mCurrSeqKey++;
+
+   for (U32 i = minY; i <= maxY; i++)
+   {
+      U32 base = (i % csmNumBins) * csmNumBins;
+      for (U32 j = minX; j <= maxX; j++)
+         _visitChain(mBinArray[base + (j % csmNumBins)].nextInBin, callback, key);
+   }
+
+   _visitChain(mOverflowBin->nextInBin, callback, key);
+
+   _endQuery();
+}
+
+//-----------------------------------------------------------------------------
+
+// DMMNOTE: There are still some optimizations to be done here.  In particular:
+//           - After checking the overflow bin, we can potentially shorten the line
+//             that we rasterize against the grid if there is a collision with say,
+//             the terrain.
+//           - The optimal grid size isn't necessarily what we have set here. possibly
+//             a resolution of 16 meters would give better results
+//           - The line rasterizer is pretty lame.  Unfortunately we can't use a
+//             simple bres. here, since we need to check every grid element that the line
+//             passes through, which bres does _not_ do for us.  Possibly there's a
+//             rasterizer for anti-aliased lines that will serve better than what
+//             we have below.
+
+void SceneBinGrid::findOnLine(const Point3F& start, const Point3F& end, VisitCallback callback, void* key)
+{
+   _beginQuery();
+   mCurrSeqKey++;
+
+   _visitChain(mOverflowBin->nextInBin, callback, key);
+
+   // These are just for rasterizing the line against the grid.  We want the x coord
+   //  of the start to be <= the x coord of the end
+   Point3F normalStart, normalEnd;
+   if (start.x <= end.x)
+   {
+      normalStart = start;
+      normalEnd   = end;
+   }
+   else
+   {
+      normalStart = end;
+      normalEnd   = start;
+   }
+
+   // Ok, let's scan the grids.  The simplest way to do this will be to scan across in
+   //  x, finding the y range for each affected bin...
+   U32 minX, maxX;
+   U32 minY, maxY;
+
+   getBinRange(normalStart.x, normalEnd.x, minX, maxX);
+   getBinRange(getMin(normalStart.y, normalEnd.y),
+               getMax(normalStart.y, normalEnd.y), minY, maxY);
+
+   // We'll optimize the case that the line is contained in one bin row or column, which
+   //  will be quite a few lines.  No sense doing more work than we have to...
+   //
+   if ((mFabs(normalStart.x - normalEnd.x) < csmTotalBinSize && minX == maxX) ||
+       (mFabs(normalStart.y - normalEnd.y) < csmTotalBinSize && minY == maxY))
+   {
+      U32 count;
+      U32 incX, incY;
+      if (minX == maxX)
+      {
+         count = maxY - minY + 1;
+         incX  = 0;
+         incY  = 1;
+      }
+      else
+      {
+         count = maxX - minX + 1;
+         incX  = 1;
+         incY  = 0;
+      }
+
+      U32 x = minX;
+      U32 y = minY;
+      for (U32 i = 0; i < count; i++)
+      {
+         U32 checkX = x % csmNumBins;
+         U32 checkY = y % csmNumBins;
+
+         _visitChain(mBinArray[(checkY * csmNumBins) + checkX].nextInBin, callback, key);
+
+         x += incX;
+         y += incY;
+      }
+   }
+   else
+   {
+      // Oh well, let's earn our keep.  We know that after the above conditional, we're
+      //  going to cross at least one boundary, so that simplifies our job...
+
+      F32 currStartX = normalStart.x;
+
+      AssertFatal(currStartX != normalEnd.x, "This is going to cause problems in SceneBinGrid::findOnLine");
+      if(mIsNaN_F(currStartX))
+      {
+         _endQuery();
+         return;
+      }
+      while (currStartX != normalEnd.x)
+      {
+         F32 currEndX   = getMin(currStartX + csmTotalBinSize, normalEnd.x);
+
+         F32 currStartT = (currStartX - normalStart.x) / (normalEnd.x - normalStart.x);
+         F32 currEndT   = (currEndX   - normalStart.x) / (normalEnd.x - normalStart.x);
+
+         F32 y1 = normalStart.y + (normalEnd.y - normalStart.y) * currStartT;
+         F32 y2 = normalStart.y + (normalEnd.y - normalStart.y) * currEndT;
+
+         U32 subMinX, subMaxX;
+         getBinRange(currStartX, currEndX, subMinX, subMaxX);
+
+         F32 subStartX = currStartX;
+         F32 subEndX   = currStartX;
+
+         if (currStartX < 0.0f)
+            subEndX -= mFmod(subEndX, csmBinSize);
+         else
+            subEndX += (csmBinSize - mFmod(subEndX, csmBinSize));
+
+         for (U32 currXBin = subMinX; currXBin <= subMaxX; currXBin++)
+         {
+            U32 checkX = currXBin % csmNumBins;
+
+            F32 subStartT = (subStartX - currStartX) / (currEndX - currStartX);
+            F32 subEndT   = getMin(F32((subEndX   - currStartX) / (currEndX - currStartX)), 1.f);
+
+            F32 subY1 = y1 + (y2 - y1) * subStartT;
+            F32 subY2 = y1 + (y2 - y1) * subEndT;
+
+            U32 newMinY, newMaxY;
+            getBinRange(getMin(subY1, subY2), getMax(subY1, subY2), newMinY, newMaxY);
+
+            for (U32 i = newMinY; i <= newMaxY; i++)
+            {
+               U32 checkY = i % csmNumBins;
+               _visitChain(mBinArray[(checkY * csmNumBins) + checkX].nextInBin, callback, key);
+            }
+
+            subStartX = subEndX;
+            subEndX   = getMin(subEndX + csmBinSize, currEndX);
+         }
+
+         currStartX = currEndX;
+      }
+   }
+
+   _endQuery();
+}
+
+//-----------------------------------------------------------------------------
+
+void SceneBinGrid::getBinRange( const F32 min, const F32 max, U32& minBin, U32& maxBin )
+{
+   AssertFatal(max >= min, avar("Error, bad range in getBinRange. min: %f, max: %f", min, max));
+
+   if ((max - min) >= (SceneBinGrid::csmTotalBinSize - SceneBinGrid::csmBinSize))
+   {
+      F32 minCoord = mFmod(min, SceneBinGrid::csmTotalBinSize);
+      if (minCoord < 0.0f) 
+      {
+         minCoord += SceneBinGrid::csmTotalBinSize;
+
+         // This is truly lame, but it can happen.  There must be a better way to
+         //  deal with this.
+         if (minCoord == SceneBinGrid::csmTotalBinSize)
+            minCoord = SceneBinGrid::csmTotalBinSize - 0.01;
+      }
+
+      AssertFatal(minCoord >= 0.0 && minCoord < SceneBinGrid::csmTotalBinSize, "Bad minCoord");
+
+      minBin = U32(minCoord / SceneBinGrid::csmBinSize);
+      AssertFatal(minBin < SceneBinGrid::csmNumBins, avar("Error, bad clipping! (%g, %d)", minCoord, minBin));
+
+      maxBin = minBin + (SceneBinGrid::csmNumBins - 1);
+      return;
+   }
+   else 
+   {
+
+      F32 minCoord = mFmod(min, SceneBinGrid::csmTotalBinSize);
+      
+      if (minCoord < 0.0f) 
+      {
+         minCoord += SceneBinGrid::csmTotalBinSize;
+
+         // This is truly lame, but it can happen.  There must be a better way to
+         //  deal with this.
+         if (minCoord == SceneBinGrid::csmTotalBinSize)
+            minCoord = SceneBinGrid::csmTotalBinSize - 0.01;
+      }
+      AssertFatal(minCoord >= 0.0 && minCoord < SceneBinGrid::csmTotalBinSize, "Bad minCoord");
+
+      F32 maxCoord = mFmod(max, SceneBinGrid::csmTotalBinSize);
+      if (maxCoord < 0.0f) {
+         maxCoord += SceneBinGrid::csmTotalBinSize;
+
+         // This is truly lame, but it can happen.  There must be a better way to
+         //  deal with this.
+         if (maxCoord == SceneBinGrid::csmTotalBinSize)
+            maxCoord = SceneBinGrid::csmTotalBinSize - 0.01;
+      }
+      AssertFatal(maxCoord >= 0.0 && maxCoord < SceneBinGrid::csmTotalBinSize, "Bad maxCoord");
+
+      minBin = U32(minCoord / SceneBinGrid::csmBinSize);
+      maxBin = U32(maxCoord / SceneBinGrid::csmBinSize);
+      AssertFatal(minBin < SceneBinGrid::csmNumBins, avar("Error, bad clipping(min)! (%g, %d)", maxCoord, minBin));
+      AssertFatal(minBin < SceneBinGrid::csmNumBins, avar("Error, bad clipping(max)! (%g, %d)", maxCoord, maxBin));
+
+      // MSVC6 seems to be generating some bad floating point code around
+      // here when full optimizations are on.  The min != max test should
+      // not be needed, but it clears up the VC issue.
+      if (min != max && minCoord > maxCoord)
+         maxBin += SceneBinGrid::csmNumBins;
+
+      AssertFatal(maxBin >= minBin, "Error, min should always be less than max!");
+   }
+}
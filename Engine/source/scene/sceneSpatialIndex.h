@@ -0,0 +1,170 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SCENESPATIALINDEX_H_
+#define _SCENESPATIALINDEX_H_
+
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+
+/// @file
+/// Spatial indices used by SceneContainer to find candidate objects for queries.
+
+
+class SceneObject;
+class SceneObjectRef;
+
+
+/// Spatial subdivision of the objects in a SceneContainer.
+///
+/// An index only narrows down the objects a query has to look at.  Queries
+/// return every object whose world box may touch the query volume, each
+/// object at most once, and leave the exact tests to the container.
+class SceneSpatialIndex
+{
+   public:
+
+      /// Invoked for every candidate object of a query.
+      typedef void ( *VisitCallback )( SceneObject* object, void* key );
+
+      /// Work done by a query.
+      struct QueryStats
+      {
+         /// Number of bins or tree nodes looked at.
+         U32 nodesVisited;
+
+         /// Number of candidate objects returned.
+         U32 objectsVisited;
+      };
+
+      SceneSpatialIndex();
+      virtual ~SceneSpatialIndex() {}
+
+      /// Create an index by name; "bins" or "octree".
+      /// @return The new index or NULL if the name is not known.
+      static SceneSpatialIndex* create( const char* name );
+
+      /// Return the name the index is created with.
+      virtual const char* getName() const = 0;
+
+      /// Add an object based on its current world box.
+      virtual void insertObject( SceneObject* object ) = 0;
+
+      /// Remove an object from the index.
+      virtual void removeObject( SceneObject* object ) = 0;
+
+      /// Update the position of an object after its world box has changed.
+      virtual void updateObject( SceneObject* object ) = 0;
+
+      /// Visit all objects that may overlap the box.
+      virtual void findInBox( const Box3F& box, VisitCallback callback, void* key ) = 0;
+
+      /// Visit all objects that may intersect the line segment.
+      virtual void findOnLine( const Point3F& start, const Point3F& end, VisitCallback callback, void* key ) = 0;
+
+      /// Return the work done by the last query.
+      const QueryStats& getLastQueryStats() const { return mLastQuery; }
+
+      /// Return the work done by all queries since the last resetQueryStats().
+      const QueryStats& getTotalQueryStats() const { return mTotalQuery; }
+
+      /// Return the number of queries since the last resetQueryStats().
+      U32 getNumQueries() const { return mNumQueries; }
+
+      void resetQueryStats();
+
+   protected:
+
+      QueryStats mLastQuery;
+      QueryStats mTotalQuery;
+      U32 mNumQueries;
+
+      void _beginQuery()
+      {
+         mLastQuery.nodesVisited = 0;
+         mLastQuery.objectsVisited = 0;
+      }
+
+      void _endQuery()
+      {
+         mTotalQuery.nodesVisited += mLastQuery.nodesVisited;
+         mTotalQuery.objectsVisited += mLastQuery.objectsVisited;
+         mNumQueries++;
+      }
+};
+
+
+/// The original fixed grid of bins.
+///
+/// Objects are hashed into a 16x16 grid of 64 unit bins that wraps every
+/// 1024 units in x and y.  Objects that cover the whole grid go into a
+/// single overflow bin that is visited by every query.
+class SceneBinGrid : public SceneSpatialIndex
+{
+   public:
+
+      SceneBinGrid();
+      virtual ~SceneBinGrid();
+
+      // SceneSpatialIndex.
+      virtual const char* getName() const { return "bins"; }
+      virtual void insertObject( SceneObject* object );
+      virtual void removeObject( SceneObject* object );
+      virtual void updateObject( SceneObject* object );
+      virtual void findInBox( const Box3F& box, VisitCallback callback, void* key );
+      virtual void findOnLine( const Point3F& start, const Point3F& end, VisitCallback callback, void* key );
+
+      static const U32 csmNumBins;
+      static const F32 csmBinSize;
+      static const F32 csmTotalBinSize;
+      static const U32 csmRefPoolBlockSize;
+
+      static void getBinRange( const F32 min, const F32 max, U32& minBin, U32& maxBin );
+
+   protected:
+
+      /// Sequence key used to visit objects spanning several bins only once.
+      U32 mCurrSeqKey;
+
+      SceneObjectRef* mFreeRefPool;
+      Vector< SceneObjectRef* > mRefPoolBlocks;
+
+      SceneObjectRef* mBinArray;
+      SceneObjectRef* mOverflowBin;
+
+      void addRefPoolBlock();
+      SceneObjectRef* allocateObjectRef();
+      void freeObjectRef( SceneObjectRef* ref );
+
+      void insertIntoBins( SceneObject* object, U32 minX, U32 maxX, U32 minY, U32 maxY );
+
+      /// Visit the objects in a bin chain that have not been seen yet.
+      void _visitChain( SceneObjectRef* chain, VisitCallback callback, void* key );
+};
+
+#endif // _SCENESPATIALINDEX_H_
@@ -0,0 +1,171 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "scene/sceneContainer.h"
+#include "scene/sceneObject.h"
+#include "collision/collision.h"
+#include "math/mRandom.h"
+#include "console/console.h"
+#include "core/strings/stringUnit.h"
+
+FIXTURE(SceneContainerRays)
+{
+public:
+   /// A scene object whose collision geometry is its box.
+   class BoxObject : public SceneObject
+   {
+   public:
+      void place(const Point3F& pos, const Point3F& halfExtents)
+      {
+         mTypeMask |= StaticObjectType;
+         mObjBox.set(-halfExtents, halfExtents);
+         mObjToWorld.identity();
+         mObjToWorld.setPosition(pos);
+         mWorldToObj = mObjToWorld;
+         mWorldToObj.inverse();
+         resetWorldBox();
+      }
+
+      virtual bool castRay(const Point3F& start, const Point3F& end, RayInfo* info)
+      {
+         F32 t;
+         Point3F normal;
+         if (!mObjBox.collideLine(start, end, &t, &normal))
+            return false;
+
+         info->t = t;
+         info->normal = normal;
+         info->object = this;
+         if (info->generateTexCoord)
+            info->texCoord.set(t, 1.0f - t);
+         return true;
+      }
+   };
+
+   MRandomLCG mRandom;
+   SceneContainer* mContainer;
+   Vector<BoxObject*> mObjects;
+
+   virtual void SetUp()
+   {
+      mRandom.setSeed(20150213);
+      mContainer = new SceneContainer();
+
+      for (U32 i = 0; i < 1000; i++)
+      {
+         BoxObject* object = new BoxObject();
+         object->place(randomPoint(), Point3F(mRandom.randF(0.5f, 8.0f), mRandom.randF(0.5f, 8.0f), mRandom.randF(0.5f, 8.0f)));
+         mContainer->addObject(object);
+         mObjects.push_back(object);
+      }
+   }
+
+   virtual void TearDown()
+   {
+      for (U32 i = 0; i < mObjects.size(); i++)
+      {
+         mContainer->removeObject(mObjects[i]);
+         delete mObjects[i];
+      }
+      mObjects.clear();
+      delete mContainer;
+   }
+
+   Point3F randomPoint()
+   {
+      return Point3F(mRandom.randF(-256.0f, 256.0f), mRandom.randF(-256.0f, 256.0f), mRandom.randF(0.0f, 32.0f));
+   }
+};
+
+TEST_FIX(SceneContainerRays, BatchMatchesCastRay)
+{
+   const U32 numRays = 500;
+
+   Vector<SceneContainer::RayQuery> queries;
+   Vector<RayInfo> batchInfos;
+   queries.setSize(numRays);
+   batchInfos.setSize(numRays);
+
+   for (U32 i = 0; i < numRays; i++)
+   {
+      queries[i].start = randomPoint();
+      queries[i].end = queries[i].start + Point3F(mRandom.randF(-100.0f, 100.0f), mRandom.randF(-100.0f, 100.0f), mRandom.randF(-30.0f, 30.0f));
+      queries[i].mask = StaticObjectType;
+
+      batchInfos[i] = RayInfo();
+      batchInfos[i].generateTexCoord = (i % 2) == 0;
+   }
+
+   const U32 numHits = mContainer->castRayBatch(queries.address(), numRays, batchInfos.address());
+
+   U32 numExpectedHits = 0;
+   for (U32 i = 0; i < numRays; i++)
+   {
+      RayInfo info;
+      info.generateTexCoord = batchInfos[i].generateTexCoord;
+      const bool hit = mContainer->castRay(queries[i].start, queries[i].end, StaticObjectType, &info);
+
+      ASSERT_EQ(hit, batchInfos[i].object != NULL) << "ray " << i;
+      if (!hit)
+         continue;
+
+      numExpectedHits++;
+      EXPECT_EQ(info.object, batchInfos[i].object) << "ray " << i;
+      EXPECT_FLOAT_EQ(info.t, batchInfos[i].t) << "ray " << i;
+      EXPECT_FLOAT_EQ(info.distance, batchInfos[i].distance) << "ray " << i;
+      EXPECT_TRUE(info.normal.equal(batchInfos[i].normal)) << "ray " << i;
+      EXPECT_EQ(info.generateTexCoord, batchInfos[i].generateTexCoord) << "ray " << i;
+      EXPECT_TRUE(info.texCoord.equal(batchInfos[i].texCoord)) << "ray " << i;
+   }
+
+   EXPECT_EQ(numExpectedHits, numHits);
+   EXPECT_GT(numHits, 0);
+}
+
+TEST_FIX(SceneContainerRays, ScriptBatchKeepsInvalidRaysInPlace)
+{
+   BoxObject* object = new BoxObject();
+   object->place(Point3F(0.0f, 0.0f, 0.0f), Point3F(1.0f, 1.0f, 1.0f));
+   gServerContainer.addObject(object);
+
+   // The second ray doesn't parse.  It still gets a line of its own so
+   // that the hits of the other rays stay at their indices.
+   const char* rays = "-5 0 0 5 0 0\tnot a ray\t0 -5 0 0 5 0\t10 10 10 20 20 20";
+   String result = Con::executef("containerRayCastBatch", rays, Con::getIntArg(StaticObjectType));
+
+   gServerContainer.removeObject(object);
+   delete object;
+
+   ASSERT_EQ(4, StringUnit::getUnitCount(result.c_str(), "\n"));
+
+   // A hit is the object id followed by eight numbers, a miss just 0.
+   EXPECT_EQ(9, StringUnit::getUnitCount(StringUnit::getUnit(result.c_str(), 0, "\n"), " "));
+   EXPECT_STREQ("0", StringUnit::getUnit(result.c_str(), 1, "\n"));
+   EXPECT_EQ(9, StringUnit::getUnitCount(StringUnit::getUnit(result.c_str(), 2, "\n"), " "));
+   EXPECT_STREQ("0", StringUnit::getUnit(result.c_str(), 3, "\n"));
+}
+
+#endif
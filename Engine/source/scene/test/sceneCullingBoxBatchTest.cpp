@@ -0,0 +1,175 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "scene/culling/sceneCullingBoxBatch.h"
+#include "math/util/frustum.h"
+#include "math/mPlaneSet.h"
+#include "math/mRandom.h"
+#include "core/util/tVector.h"
+#include "console/console.h"
+
+FIXTURE(SceneCullingBoxBatch)
+{
+public:
+   MRandomLCG mRandom;
+   Vector<Box3F> mBoxes;
+   Vector<F32> mStorage;
+   SceneCullingBoxBatch mBatch;
+
+   virtual void SetUp()
+   {
+      mRandom.setSeed(1376312589);
+   }
+
+   void populate(U32 count, F32 worldSize)
+   {
+      // Room for the padding of the last group.
+      const U32 capacity = count + SceneCullingBoxBatch::GroupSize;
+      mStorage.setSize(SceneCullingBoxBatch::getStorageSize(capacity));
+
+      mBoxes.clear();
+      mBatch.setStorage(mStorage.address(), capacity);
+
+      for (U32 i = 0; i < count; i++)
+      {
+         Point3F center(mRandom.randF(-worldSize, worldSize),
+                        mRandom.randF(-worldSize, worldSize),
+                        mRandom.randF(-worldSize, worldSize));
+         Point3F halfExtents(mRandom.randF(0.1f, 10.0f),
+                             mRandom.randF(0.1f, 10.0f),
+                             mRandom.randF(0.1f, 10.0f));
+
+         mBoxes.push_back(Box3F(center - halfExtents, center + halfExtents));
+         mBatch.push(mBoxes.last());
+      }
+
+      mBatch.pad();
+   }
+
+   Frustum makeFrustum()
+   {
+      Frustum frustum;
+      frustum.set(false, mDegToRad(70.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+      return frustum;
+   }
+};
+
+TEST_FIX(SceneCullingBoxBatch, MatchesWhichSide)
+{
+   populate(1001, 100.0f);
+   EXPECT_EQ(0, mBatch.size() % SceneCullingBoxBatch::GroupSize);
+
+   // Random planes, including ones through the box corners that
+   // land inside the epsilon of PlaneF::whichSide().
+   for (U32 p = 0; p < 64; p++)
+   {
+      Point3F normal(mRandom.randF(-1.0f, 1.0f), mRandom.randF(-1.0f, 1.0f), mRandom.randF(-1.0f, 1.0f));
+      if (p % 8 == 0)
+         normal.set(0.0f, 0.0f, 1.0f);
+      normal.normalizeSafe();
+
+      PlaneF plane(Point3F(mRandom.randF(-50.0f, 50.0f), 0.0f, 0.0f), normal);
+      if (p % 8 == 0)
+         plane = PlaneF(mBoxes[p].maxExtents, normal);
+
+      for (U32 g = 0; g < mBatch.getNumGroups(); g++)
+      {
+         const U32 outside = mBatch.getOutsideMask(g, &plane, 1);
+         const U32 contained = mBatch.getContainedMask(g, &plane, 1);
+
+         for (U32 n = 0; n < SceneCullingBoxBatch::GroupSize; n++)
+         {
+            const U32 index = getMin(g * SceneCullingBoxBatch::GroupSize + n, U32(mBoxes.size() - 1));
+            const PlaneF::Side side = plane.whichSide(mBoxes[index]);
+            EXPECT_EQ(side == PlaneF::Back, (outside & BIT(n)) != 0);
+            EXPECT_EQ(side == PlaneF::Front, (contained & BIT(n)) != 0);
+         }
+      }
+   }
+}
+
+TEST_FIX(SceneCullingBoxBatch, MatchesFrustumCulling)
+{
+   populate(4096, 500.0f);
+   const Frustum frustum = makeFrustum();
+
+   U32 numCulled = 0;
+   for (U32 g = 0; g < mBatch.getNumGroups(); g++)
+   {
+      const U32 outside = mBatch.getOutsideMask(g, frustum.getPlanes(), Frustum::PlaneCount);
+      for (U32 n = 0; n < SceneCullingBoxBatch::GroupSize; n++)
+      {
+         const Box3F& box = mBoxes[g * SceneCullingBoxBatch::GroupSize + n];
+         EXPECT_EQ(frustum.isCulled(box), (outside & BIT(n)) != 0);
+         if (outside & BIT(n))
+            numCulled++;
+      }
+   }
+
+   // Make sure the test covers both outcomes.
+   EXPECT_GT(numCulled, 0);
+   EXPECT_LT(numCulled, mBoxes.size());
+}
+
+TEST_FIX(SceneCullingBoxBatch, FrustumCullingBenchmark)
+{
+   const U32 numBoxes = 16384;
+   const U32 numPasses = 100;
+   populate(numBoxes, 500.0f);
+   const Frustum frustum = makeFrustum();
+
+   U32 start = Platform::getRealMilliseconds();
+   U32 scalarCulled = 0;
+   for (U32 pass = 0; pass < numPasses; pass++)
+   {
+      for (U32 i = 0; i < numBoxes; i++)
+      {
+         if (frustum.isCulled(mBoxes[i]))
+            scalarCulled++;
+      }
+   }
+   const U32 scalarTime = Platform::getRealMilliseconds() - start;
+
+   start = Platform::getRealMilliseconds();
+   U32 batchCulled = 0;
+   for (U32 pass = 0; pass < numPasses; pass++)
+   {
+      for (U32 g = 0; g < mBatch.getNumGroups(); g++)
+      {
+         const U32 outside = mBatch.getOutsideMask(g, frustum.getPlanes(), Frustum::PlaneCount);
+         for (U32 n = 0; n < SceneCullingBoxBatch::GroupSize; n++)
+            batchCulled += (outside >> n) & 1;
+      }
+   }
+   const U32 batchTime = Platform::getRealMilliseconds() - start;
+
+   EXPECT_EQ(scalarCulled, batchCulled);
+
+   Con::printf("SceneCullingBoxBatch: %u boxes x %u passes: scalar %ums, batched %ums",
+      numBoxes, numPasses, scalarTime, batchTime);
+}
+
+#endif
@@ -0,0 +1,277 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "scene/culling/sceneCullingState.h"
+#include "scene/sceneManager.h"
+#include "scene/sceneObject.h"
+#include "scene/zones/sceneSimpleZone.h"
+#include "scene/zones/sceneZoneSpaceManager.h"
+#include "math/util/frustum.h"
+#include "math/mRandom.h"
+#include "T3D/objectTypes.h"
+
+FIXTURE(SceneCullingStateBatch)
+{
+public:
+   /// A box shaped object.
+   class BoxObject : public SceneObject
+   {
+   public:
+      void place(const Point3F& pos, const Point3F& halfExtents, U32 typeMask, bool renderEnabled)
+      {
+         mTypeMask |= typeMask;
+         if (!renderEnabled)
+            mObjectFlags.clear(RenderEnabledFlag);
+
+         mObjBox.set(-halfExtents, halfExtents);
+         MatrixF mat(true);
+         mat.setPosition(pos);
+         setTransform(mat);
+      }
+   };
+
+   /// A box zone placed without going through the networked setters.
+   class BoxZone : public SceneSimpleZone
+   {
+   public:
+      void place(const Point3F& pos, const Point3F& size)
+      {
+         mTypeMask |= ZoneObjectType;
+         mObjScale = size;
+         MatrixF mat(true);
+         mat.setPosition(pos);
+         setTransform(mat);
+      }
+   };
+
+   MRandomLCG mRandom;
+   SceneManager* mScene;
+   Vector<BoxZone*> mZones;
+   Vector<BoxObject*> mObjects;
+
+   bool mSavedBatchCulling;
+   U32 mSavedMinBatchCullObjects;
+   U32 mSavedMinParallelCullObjects;
+
+   virtual void SetUp()
+   {
+      mRandom.setSeed(20110427);
+
+      mSavedBatchCulling = SceneCullingState::smBatchCulling;
+      mSavedMinBatchCullObjects = SceneCullingState::smMinBatchCullObjects;
+      mSavedMinParallelCullObjects = SceneCullingState::smMinParallelCullObjects;
+
+      // The scene shares the client container, so this assumes
+      // no mission is loaded while the tests run.
+      mScene = new SceneManager(true);
+
+      // A grid of zones with gaps in between so that objects end up in
+      // the outdoor zone, in a single zone or straddling several zones.
+      for (S32 x = -2; x < 2; x++)
+      {
+         for (S32 y = 0; y < 3; y++)
+         {
+            BoxZone* zone = new BoxZone();
+            zone->place(Point3F(x * 70.0f + 35.0f, y * 70.0f, 20.0f), Point3F(60.0f, 60.0f, 40.0f));
+            mScene->addObjectToScene(zone);
+            mZones.push_back(zone);
+         }
+      }
+
+      for (U32 i = 0; i < 2000; i++)
+      {
+         const Point3F pos(mRandom.randF(-160.0f, 160.0f), mRandom.randF(-40.0f, 200.0f), mRandom.randF(0.0f, 40.0f));
+         const Point3F halfExtents(mRandom.randF(0.5f, 8.0f), mRandom.randF(0.5f, 8.0f), mRandom.randF(0.5f, 8.0f));
+
+         // Mostly zone culled objects, some that only get the
+         // frustum test and a few that are render-disabled.
+         const U32 typeMask = (mRandom.randI(0, 9) == 0) ? EnvironmentObjectType : StaticShapeObjectType;
+         const bool renderEnabled = mRandom.randI(0, 19) != 0;
+
+         BoxObject* object = new BoxObject();
+         object->place(pos, halfExtents, typeMask, renderEnabled);
+         mScene->addObjectToScene(object);
+         mObjects.push_back(object);
+      }
+
+      mScene->getZoneManager()->updateZoningState();
+   }
+
+   virtual void TearDown()
+   {
+      for (U32 i = 0; i < mObjects.size(); i++)
+      {
+         mScene->removeObjectFromScene(mObjects[i]);
+         delete mObjects[i];
+      }
+      mObjects.clear();
+
+      for (U32 i = 0; i < mZones.size(); i++)
+      {
+         mScene->removeObjectFromScene(mZones[i]);
+         delete mZones[i];
+      }
+      mZones.clear();
+
+      delete mScene;
+
+      SceneCullingState::smBatchCulling = mSavedBatchCulling;
+      SceneCullingState::smMinBatchCullObjects = mSavedMinBatchCullObjects;
+      SceneCullingState::smMinParallelCullObjects = mSavedMinParallelCullObjects;
+   }
+
+   SceneCameraState makeCameraState(const Point3F& pos)
+   {
+      MatrixF cameraToWorld(true);
+      cameraToWorld.setPosition(pos);
+
+      Frustum frustum;
+      frustum.set(false, mDegToRad(70.0f), 16.0f / 9.0f, 0.1f, 300.0f, cameraToWorld);
+
+      MatrixF worldView = cameraToWorld;
+      worldView.inverse();
+
+      MatrixF projection;
+      frustum.getProjectionMatrix(&projection);
+
+      return SceneCameraState(RectI(0, 0, 1280, 720), frustum, worldView, projection);
+   }
+
+   /// Return the side planes of a frustum looking along +Y from @a pos.
+   PlaneF* makeIncluderPlanes(SceneCullingState* state, const Point3F& pos)
+   {
+      MatrixF mat(true);
+      mat.setPosition(pos);
+
+      Frustum frustum;
+      frustum.set(false, mDegToRad(mRandom.randF(10.0f, 60.0f)), 1.0f, 0.1f, 300.0f, mat);
+
+      PlaneF* planes = state->allocateData<PlaneF>(4);
+      planes[0] = frustum.getPlanes()[Frustum::PlaneLeft];
+      planes[1] = frustum.getPlanes()[Frustum::PlaneRight];
+      planes[2] = frustum.getPlanes()[Frustum::PlaneTop];
+      planes[3] = frustum.getPlanes()[Frustum::PlaneBottom];
+      return planes;
+   }
+
+   /// Return the inward facing planes of @a box.
+   PlaneF* makeOccluderPlanes(SceneCullingState* state, const Box3F& box)
+   {
+      PlaneF* planes = state->allocateData<PlaneF>(6);
+      planes[0] = PlaneF(box.minExtents, Point3F(1.0f, 0.0f, 0.0f));
+      planes[1] = PlaneF(box.minExtents, Point3F(0.0f, 1.0f, 0.0f));
+      planes[2] = PlaneF(box.minExtents, Point3F(0.0f, 0.0f, 1.0f));
+      planes[3] = PlaneF(box.maxExtents, Point3F(-1.0f, 0.0f, 0.0f));
+      planes[4] = PlaneF(box.maxExtents, Point3F(0.0f, -1.0f, 0.0f));
+      planes[5] = PlaneF(box.maxExtents, Point3F(0.0f, 0.0f, -1.0f));
+      return planes;
+   }
+
+   /// Set up the zone culling volumes like a traversal would, with some
+   /// zones left invisible and some with several includers and occluders.
+   void addZoneVolumes(SceneCullingState* state, const Point3F& cameraPos)
+   {
+      state->addCullingVolumeToZone(0, state->getRootVolume());
+
+      const U32 numZones = mScene->getZoneManager()->getNumZones();
+      for (U32 zone = 1; zone < numZones; zone++)
+      {
+         if (mRandom.randI(0, 4) == 0)
+            continue;
+
+         const U32 numIncluders = mRandom.randI(1, 2);
+         for (U32 i = 0; i < numIncluders; i++)
+         {
+            const Point3F pos = cameraPos + Point3F(mRandom.randF(-20.0f, 20.0f), 0.0f, mRandom.randF(-5.0f, 5.0f));
+            state->addCullingVolumeToZone(zone, SceneCullingVolume(SceneCullingVolume::Includer,
+               PlaneSetF(makeIncluderPlanes(state, pos), 4)));
+         }
+
+         const U32 numOccluders = mRandom.randI(0, 2);
+         for (U32 i = 0; i < numOccluders; i++)
+         {
+            const Point3F center(mRandom.randF(-140.0f, 140.0f), mRandom.randF(0.0f, 180.0f), mRandom.randF(0.0f, 40.0f));
+            const Point3F halfExtents(mRandom.randF(5.0f, 30.0f), mRandom.randF(5.0f, 30.0f), mRandom.randF(5.0f, 30.0f));
+            state->addCullingVolumeToZone(zone, SceneCullingVolume(SceneCullingVolume::Occluder,
+               PlaneSetF(makeOccluderPlanes(state, Box3F(center - halfExtents, center + halfExtents)), 6)));
+         }
+      }
+   }
+
+   /// Cull the objects with both paths and check that the batched
+   /// path keeps the same objects in the same order.
+   void checkMatches(bool disableZoneCulling, U32 cullOptions)
+   {
+      const Point3F cameraPos(0.0f, -60.0f, 20.0f);
+      SceneCullingState state(mScene, makeCameraState(cameraPos));
+      state.disableZoneCulling(disableZoneCulling);
+      addZoneVolumes(&state, cameraPos);
+
+      Vector<SceneObject*> expected;
+      Vector<SceneObject*> batched;
+      for (U32 i = 0; i < mObjects.size(); i++)
+      {
+         expected.push_back(mObjects[i]);
+         batched.push_back(mObjects[i]);
+      }
+
+      SceneCullingState::smBatchCulling = false;
+      const U32 numExpected = state.cullObjects(expected.address(), expected.size(), cullOptions);
+
+      SceneCullingState::smBatchCulling = true;
+      SceneCullingState::smMinBatchCullObjects = 1;
+      const U32 numBatched = state.cullObjects(batched.address(), batched.size(), cullOptions);
+
+      // Make sure the test actually culls something.
+      EXPECT_GT(numExpected, 0U);
+      EXPECT_LT(numExpected, U32(mObjects.size()));
+
+      ASSERT_EQ(numExpected, numBatched);
+      for (U32 i = 0; i < numExpected; i++)
+      {
+         EXPECT_EQ(expected[i], batched[i]) << "Mismatch at " << i;
+      }
+   }
+};
+
+TEST_FIX(SceneCullingStateBatch, MatchesSerialCull)
+{
+   SceneCullingState::smMinParallelCullObjects = U32_MAX;
+
+   checkMatches(false, 0);
+   checkMatches(false, SceneCullingState::DontCullRenderDisabled);
+   checkMatches(true, 0);
+}
+
+TEST_FIX(SceneCullingStateBatch, ParallelMatchesSerialCull)
+{
+   SceneCullingState::smMinParallelCullObjects = 0;
+
+   checkMatches(false, 0);
+   checkMatches(false, SceneCullingState::DontCullRenderDisabled);
+}
+
+#endif
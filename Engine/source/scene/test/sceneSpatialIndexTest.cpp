@@ -0,0 +1,224 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2014 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "scene/sceneContainer.h"
+#include "scene/sceneObject.h"
+#include "scene/sceneSpatialIndex.h"
+#include "math/mRandom.h"
+
+FIXTURE(SceneSpatialIndex)
+{
+public:
+   /// A scene object with a box that can be placed freely.
+   class BoxObject : public SceneObject
+   {
+   public:
+      void place(const Point3F& pos, const Point3F& halfExtents)
+      {
+         mTypeMask |= StaticObjectType;
+         mObjBox.set(-halfExtents, halfExtents);
+         mObjToWorld.identity();
+         mObjToWorld.setPosition(pos);
+         mWorldToObj = mObjToWorld;
+         mWorldToObj.inverse();
+         resetWorldBox();
+      }
+   };
+
+   static S32 QSORT_CALLBACK compareObjects(const void* a, const void* b)
+   {
+      const SceneObject* objA = *(const SceneObject**)a;
+      const SceneObject* objB = *(const SceneObject**)b;
+      return objA < objB ? -1 : (objA > objB ? 1 : 0);
+   }
+
+   MRandomLCG mRandom;
+   SceneContainer* mContainer;
+   Vector<BoxObject*> mObjects;
+   F32 mWorldSize;
+
+   virtual void SetUp()
+   {
+      mRandom.setSeed(1376312589);
+      mContainer = new SceneContainer();
+   }
+
+   virtual void TearDown()
+   {
+      for (U32 i = 0; i < mObjects.size(); i++)
+      {
+         mContainer->removeObject(mObjects[i]);
+         delete mObjects[i];
+      }
+      mObjects.clear();
+      delete mContainer;
+   }
+
+   Point3F randomPoint()
+   {
+      const F32 half = mWorldSize * 0.5f;
+      return Point3F(mRandom.randF(-half, half), mRandom.randF(-half, half), mRandom.randF(0.0f, 50.0f));
+   }
+
+   /// Mostly small objects with the odd building sized one.
+   Point3F randomExtents()
+   {
+      if (mRandom.randI(0, 49) == 0)
+         return Point3F(mRandom.randF(50.0f, 150.0f), mRandom.randF(50.0f, 150.0f), 20.0f);
+      return Point3F(mRandom.randF(0.5f, 4.0f), mRandom.randF(0.5f, 4.0f), 2.0f);
+   }
+
+   void populate(U32 numObjects, F32 worldSize)
+   {
+      mWorldSize = worldSize;
+      for (U32 i = 0; i < numObjects; i++)
+      {
+         BoxObject* object = new BoxObject();
+         object->place(randomPoint(), randomExtents());
+         mContainer->addObject(object);
+         mObjects.push_back(object);
+      }
+   }
+
+   void setIndex(const char* name)
+   {
+      mContainer->setSpatialIndex(SceneSpatialIndex::create(name));
+   }
+
+   /// Check a box query against testing every object.
+   void checkBoxQuery(const Box3F& box)
+   {
+      Vector<SceneObject*> found;
+      mContainer->findObjectList(box, StaticObjectType, &found);
+
+      Vector<SceneObject*> expected;
+      for (U32 i = 0; i < mObjects.size(); i++)
+         if (mObjects[i]->getWorldBox().isOverlapped(box))
+            expected.push_back(mObjects[i]);
+
+      ASSERT_EQ(expected.size(), found.size()) << mContainer->getSpatialIndex()->getName();
+
+      dQsort(found.address(), found.size(), sizeof(SceneObject*), compareObjects);
+      dQsort(expected.address(), expected.size(), sizeof(SceneObject*), compareObjects);
+      for (U32 i = 0; i < found.size(); i++)
+         EXPECT_EQ(expected[i], found[i]) << mContainer->getSpatialIndex()->getName();
+   }
+
+   Box3F randomQueryBox(F32 halfSize)
+   {
+      Point3F center = randomPoint();
+      return Box3F(center - Point3F(halfSize, halfSize, halfSize), center + Point3F(halfSize, halfSize, halfSize));
+   }
+};
+
+TEST_FIX(SceneSpatialIndex, QueriesMatchBruteForce)
+{
+   const char* indices[] = { "bins", "octree" };
+
+   populate(2000, 4096.0f);
+
+   for (U32 i = 0; i < 2; i++)
+   {
+      setIndex(indices[i]);
+
+      for (U32 j = 0; j < 50; j++)
+         checkBoxQuery(randomQueryBox(mRandom.randF(1.0f, 200.0f)));
+
+      // Move half the objects, some of them far outside the initial bounds.
+      for (U32 j = 0; j < mObjects.size(); j += 2)
+      {
+         Point3F pos = randomPoint();
+         if (j % 64 == 0)
+            pos *= 20.0f;
+         mObjects[j]->place(pos, randomExtents());
+         mContainer->checkBins(mObjects[j]);
+      }
+
+      for (U32 j = 0; j < 50; j++)
+         checkBoxQuery(randomQueryBox(mRandom.randF(1.0f, 200.0f)));
+   }
+}
+
+TEST_FIX(SceneSpatialIndex, QueryCostBenchmark)
+{
+   const U32 numQueries = 2000;
+   const U32 objectCounts[] = { 1000, 10000 };
+   const F32 worldSizes[] = { 1024.0f, 8192.0f };
+   const char* indices[] = { "bins", "octree" };
+
+   for (U32 c = 0; c < 2; c++)
+   {
+      for (U32 w = 0; w < 2; w++)
+      {
+         TearDown();
+         SetUp();
+         populate(objectCounts[c], worldSizes[w]);
+
+         for (U32 i = 0; i < 2; i++)
+         {
+            setIndex(indices[i]);
+            SceneSpatialIndex* index = mContainer->getSpatialIndex();
+
+            // Use the same queries for both indices.
+            mRandom.setSeed(8675309);
+
+            index->resetQueryStats();
+            Vector<SceneObject*> found;
+            U32 start = Platform::getRealMilliseconds();
+            for (U32 q = 0; q < numQueries; q++)
+            {
+               found.clear();
+               mContainer->findObjectList(randomQueryBox(16.0f), StaticObjectType, &found);
+            }
+            const U32 boxTime = Platform::getRealMilliseconds() - start;
+            const F32 boxNodes = F32(index->getTotalQueryStats().nodesVisited) / numQueries;
+            const F32 boxObjects = F32(index->getTotalQueryStats().objectsVisited) / numQueries;
+
+            index->resetQueryStats();
+            start = Platform::getRealMilliseconds();
+            for (U32 q = 0; q < numQueries; q++)
+            {
+               Point3F rayStart = randomPoint();
+               Point3F rayEnd = rayStart + Point3F(mRandom.randF(-200.0f, 200.0f), mRandom.randF(-200.0f, 200.0f), -20.0f);
+               RayInfo info;
+               mContainer->castRay(rayStart, rayEnd, StaticObjectType, &info);
+            }
+            const U32 rayTime = Platform::getRealMilliseconds() - start;
+            const F32 rayNodes = F32(index->getTotalQueryStats().nodesVisited) / numQueries;
+            const F32 rayObjects = F32(index->getTotalQueryStats().objectsVisited) / numQueries;
+
+            Con::printf("SceneSpatialIndex: %-6s %5u objects, %4.0f world: box %3ums (%.1f nodes, %.1f objects), "
+               "ray %3ums (%.1f nodes, %.1f objects)",
+               indices[i], objectCounts[c], worldSizes[w],
+               boxTime, boxNodes, boxObjects, rayTime, rayNodes, rayObjects);
+
+            EXPECT_GT(index->getNumQueries(), 0);
+         }
+      }
+   }
+}
+
+#endif
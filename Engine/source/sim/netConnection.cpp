@@ -294,6 +294,15 @@ void NetConnection::consoleInit()
 
       "@ingroup Networking");
 
+   Con::addVariable("$NetConnection::scopeQueryInterval", TypeS32, &smScopeQueryInterval,
+      "@brief The number of packets sent to a client that reuse the result of one scope query.\n\n"
+
+      "Higher values save the cost of running the scope query for every packet but delay "
+      "objects coming into or going out of scope.  The query is always rerun when the scope "
+      "object of a connection changes.\n"
+
+      "@ingroup Networking");
+
    Con::addVariable("$Stats::netGhostUpdates", TypeS32, &gGhostUpdates,
       "@brief The total number of ghosts added, removed, and/or updated on the client "
       "during the last packet process operation.\n\n"
@@ -418,6 +427,9 @@ NetConnection::NetConnection()
 
    mGhostsActive = 0;
 
+   mScopeQueryCountdown = 0;
+   resetGhostStats();
+
    mMissionPathsSent = false;
    mDemoWriteStream = NULL;
    mDemoReadStream = NULL;
@@ -806,6 +806,28 @@ protected:
    /// that the player is driving.
    SimObjectPtr<NetObject> mScopeObject;
 
+   /// @name Ghost Scheduling
+   /// @{
+
+   /// The scope object of the last scope query.
+   SimObjectPtr<NetObject> mScopeQueryObject;
+
+   /// The camera of the last scope query, used to prioritize ghosts until
+   /// the next one.
+   CameraScopeQuery mScopeQueryCamera;
+
+   /// Number of packets left until the scope query has to be rerun.
+   U32 mScopeQueryCountdown;
+
+   /// Max heap by priority of the ghosts that can be written into the
+   /// current packet.
+   Vector<GhostInfo*> mGhostSchedule;
+
+   /// Restore the max heap property of a ghost schedule below the given index.
+   static void siftGhostDown(GhostInfo **heap, S32 count, S32 index);
+
+   /// @}
+
    void clearGhostInfo();
    bool validateGhostArray();
 
@@ -855,8 +877,14 @@ public:
    virtual void doneScopingScene() { /* null */ }
 
    /// Set the object around which we are currently scoping network traffic.
+   ///
+   /// A new scope object is queried on the next packet.
    void setScopeObject(NetObject *object);
 
+   /// Rerun the scope query on the next packet instead of reusing the
+   /// last one, e.g. when the scope object has been moved a long way.
+   void invalidateScopeQuery() { mScopeQueryCountdown = 0; }
+
    /// Get the object around which we are currently scoping network traffic.
    NetObject *getScopeObject();
 
@@ -940,6 +968,38 @@ public:
    /// before performing an operation.
    static Signal<void()> smGhostAlwaysDone;
 
+   /// Number of packets that reuse the result of a scope query before it is
+   /// run again.  1 reruns it for every packet.
+   static S32 smScopeQueryInterval;
+
+   /// Ghost update statistics of a connection.
+   struct GhostStats
+   {
+      /// Packets written with ghost updates.
+      U32 packets;
+
+      /// Scope queries run.
+      U32 scopeQueries;
+
+      /// Ghosts whose update priority was evaluated.
+      U32 considered;
+
+      /// Ghost updates written.
+      U32 written;
+
+      /// Bits used by ghost updates.
+      U32 bits;
+   };
+
+   /// Return the ghost update statistics accumulated since the last call
+   /// to resetGhostStats().
+   const GhostStats& getGhostStats() const { return mGhostStats; }
+
+   void resetGhostStats() { dMemset( &mGhostStats, 0, sizeof( mGhostStats ) ); }
+
+protected:
+   GhostStats mGhostStats;
+
    /// @}
 public:
 //----------------------------------------------------------------
@@ -30,6 +30,7 @@
 #include "console/console.h"
 #include "console/consoleTypes.h"
 #include "console/engineAPI.h"
+#include "platform/profiler.h"
 
 #define DebugChecksum 0xF00DBAAD
 
@@ -161,6 +162,27 @@ DefineEngineMethod( NetConnection, getGhostsActive, S32, (),,
 	return object->getGhostsActive();
 }
 
+DefineEngineMethod( NetConnection, getGhostStats, const char*, (bool reset), (false),
+   "@brief Provides statistics on the ghost updates sent over the connection.\n\n"
+   "@param reset If true, the statistics are reset after they have been read.\n"
+   "@returns A string in the format \"packets scopeQueries considered written bits\" "
+   "counting the packets written with ghost updates, the scope queries run, the ghosts "
+   "whose update priority was evaluated, the ghost updates written and the bits they used.\n"
+   "@see @ref ghosting_scoping for a description of the ghosting system.\n\n")
+{
+   const NetConnection::GhostStats &stats = object->getGhostStats();
+
+   static const U32 bufSize = 128;
+   char *returnBuffer = Con::getReturnBuffer( bufSize );
+   dSprintf( returnBuffer, bufSize, "%u %u %u %u %u",
+      stats.packets, stats.scopeQueries, stats.considered, stats.written, stats.bits );
+
+   if ( reset )
+      object->resetGhostStats();
+
+   return returnBuffer;
+}
+
 void NetConnection::setGhostTo(bool ghostTo)
 {
    if(mLocalGhosts) // if ghosting to this is already enabled, silently return
@@ -310,13 +332,24 @@ struct UpdateQueueEntry
       { priority = in_priority; obj = in_obj; }
 };
 
-static S32 QSORT_CALLBACK UQECompare(const void *a,const void *b)
-{
-   GhostInfo *ga = *((GhostInfo **) a);
-   GhostInfo *gb = *((GhostInfo **) b);
+S32 NetConnection::smScopeQueryInterval = 3;
 
-   F32 ret = ga->priority - gb->priority;
-   return (ret < 0) ? -1 : ((ret > 0) ? 1 : 0);
+void NetConnection::siftGhostDown(GhostInfo **heap, S32 count, S32 index)
+{
+   GhostInfo *ghost = heap[index];
+   for(;;)
+   {
+      S32 child = index * 2 + 1;
+      if(child >= count)
+         break;
+      if(child + 1 < count && heap[child + 1]->priority > heap[child]->priority)
+         child++;
+      if(heap[child]->priority <= ghost->priority)
+         break;
+      heap[index] = heap[child];
+      index = child;
+   }
+   heap[index] = ghost;
 }
 
 void NetConnection::ghostWritePacket(BitStream *bstream, PacketNotify *notify)
@@ -338,21 +371,18 @@ void NetConnection::ghostWritePacket(BitStream *bstream, PacketNotify *notify)
    // first step is to check all our polled ghosts:
 
    // 1. Scope query - find if any new objects have come into
-   //    scope and if any have gone out.
+   //    scope and if any have gone out.  The result of a query
+   //    is reused for smScopeQueryInterval packets unless the
+   //    scope object changes.
    // 2. call scoped objects' priority functions if the flag set is nonzero
    //    A removed ghost is assumed to have a high priority
-   // 3. call updates based on sorted priority until the packet is
+   // 3. pop updates off a priority heap until the packet is
    //    full.  set flags to zero for all updated objects
 
-   CameraScopeQuery camInfo;
+   PROFILE_SCOPE( NetConnection_GhostWritePacket );
 
-   camInfo.camera = NULL;
-   camInfo.pos.set(0,0,0);
-   camInfo.orientation.set(0,1,0);
-   camInfo.visibleDistance = 1;
-   camInfo.fov = (F32)(3.1415f / 4.0f);
-   camInfo.sinFov = 0.7071f;
-   camInfo.cosFov = 0.7071f;
+   const U32 ghostStartPos = bstream->getBitPosition();
+   mGhostStats.packets++;
 
    GhostInfo *walk;
 
@@ -360,30 +390,53 @@ void NetConnection::ghostWritePacket(BitStream *bstream, PacketNotify *notify)
    S32 maxIndex = 0;
    S32 i;
    for(i = 0; i < mGhostZeroUpdateIndex; i++)
+      mGhostArray[i]->updateSkipCount++;
+
+   if(mScopeQueryCountdown == 0 || (NetObject *) mScopeQueryObject != (NetObject *) mScopeObject)
    {
-      // increment the updateSkip for everyone... it's all good
-      walk = mGhostArray[i];
-      walk->updateSkipCount++;
-      if(!(walk->flags & (GhostInfo::ScopeAlways | GhostInfo::ScopeLocalAlways)))
-         walk->flags &= ~GhostInfo::InScope;
-   }
+      PROFILE_SCOPE( NetConnection_GhostScopeQuery );
 
-   if( mScopeObject )
-      mScopeObject->onCameraScopeQuery( this, &camInfo );
-   doneScopingScene();
+      mScopeQueryCountdown = getMax( smScopeQueryInterval, 1 ) - 1;
+      mScopeQueryObject = mScopeObject;
+      mGhostStats.scopeQueries++;
 
-   for(i = mGhostZeroUpdateIndex - 1; i >= 0; i--)
-   {
-      // [rene, 07-Mar-11] Killing ghosts depending on the camera scope queries
-      //    seems like a bad thing to me and something that definitely has the potential
-      //    of causing scoping to eat into bandwidth rather than preserve it.  As soon
-      //    as an object comes back into scope, it will have to completely retransmit its
-      //    full server-side state from scratch.
-
-      if(!(mGhostArray[i]->flags & GhostInfo::InScope))
-         detachObject(mGhostArray[i]);
+      CameraScopeQuery &camInfo = mScopeQueryCamera;
+
+      camInfo.camera = NULL;
+      camInfo.pos.set(0,0,0);
+      camInfo.orientation.set(0,1,0);
+      camInfo.visibleDistance = 1;
+      camInfo.fov = (F32)(3.1415f / 4.0f);
+      camInfo.sinFov = 0.7071f;
+      camInfo.cosFov = 0.7071f;
+
+      for(i = 0; i < mGhostZeroUpdateIndex; i++)
+      {
+         walk = mGhostArray[i];
+         if(!(walk->flags & (GhostInfo::ScopeAlways | GhostInfo::ScopeLocalAlways)))
+            walk->flags &= ~GhostInfo::InScope;
+      }
+
+      if( mScopeObject )
+         mScopeObject->onCameraScopeQuery( this, &camInfo );
+      doneScopingScene();
+
+      for(i = mGhostZeroUpdateIndex - 1; i >= 0; i--)
+      {
+         // [rene, 07-Mar-11] Killing ghosts depending on the camera scope queries
+         //    seems like a bad thing to me and something that definitely has the potential
+         //    of causing scoping to eat into bandwidth rather than preserve it.  As soon
+         //    as an object comes back into scope, it will have to completely retransmit its
+         //    full server-side state from scratch.
+
+         if(!(mGhostArray[i]->flags & GhostInfo::InScope))
+            detachObject(mGhostArray[i]);
+      }
    }
+   else
+      mScopeQueryCountdown--;
 
+   mGhostSchedule.clear();
    for(i = mGhostZeroUpdateIndex - 1; i >= 0; i--)
    {
       walk = mGhostArray[i];
@@ -403,17 +456,22 @@ void NetConnection::ghostWritePacket(BitStream *bstream, PacketNotify *notify)
          if(walk->flags & GhostInfo::KillGhost)
             walk->priority = 10000;
          else
-            walk->priority = walk->obj->getUpdatePriority(&camInfo, walk->updateMask, walk->updateSkipCount);
+            walk->priority = walk->obj->getUpdatePriority(&mScopeQueryCamera, walk->updateMask, walk->updateSkipCount);
+         mGhostSchedule.push_back(walk);
       }
       else
          walk->priority = 0;
    }
-   GhostRef *updateList = NULL;
-   dQsort(mGhostArray, mGhostZeroUpdateIndex, sizeof(GhostInfo *), UQECompare);
+   mGhostStats.considered += mGhostSchedule.size();
 
-   // reset the array indices...
-   for(i = mGhostZeroUpdateIndex - 1; i >= 0; i--)
-      mGhostArray[i]->arrayIndex = i;
+   // Only the ghosts that fit into the packet are taken off the heap, so
+   // building it is linear and each update written costs a log.
+   GhostInfo **schedule = mGhostSchedule.address();
+   S32 scheduleCount = mGhostSchedule.size();
+   for(i = scheduleCount / 2 - 1; i >= 0; i--)
+      siftGhostDown(schedule, scheduleCount, i);
+
+   GhostRef *updateList = NULL;
 
    S32 sendSize = 1;
    while(maxIndex >>= 1)
@@ -426,11 +484,12 @@ void NetConnection::ghostWritePacket(BitStream *bstream, PacketNotify *notify)
 
    U32 count = 0;
    //
-   for(i = mGhostZeroUpdateIndex - 1; i >= 0 && !bstream->isFull(); i--)
+   while(scheduleCount > 0 && !bstream->isFull())
    {
-      GhostInfo *walk = mGhostArray[i];
-		if(walk->flags & (GhostInfo::KillingGhost | GhostInfo::Ghosting))
-		   continue;
+      GhostInfo *walk = schedule[0];
+      schedule[0] = schedule[--scheduleCount];
+      if(scheduleCount > 0)
+         siftGhostDown(schedule, scheduleCount, 0);
 		
       bstream->writeFlag(true);
 
@@ -514,6 +573,9 @@ void NetConnection::ghostWritePacket(BitStream *bstream, PacketNotify *notify)
    // no more objects...
    bstream->writeFlag(false);
    notify->ghostList = updateList;
+
+   mGhostStats.written += count;
+   mGhostStats.bits += bstream->getBitPosition() - ghostStartPos;
 }
 
 void NetConnection::ghostReadPacket(BitStream *bstream)
@@ -671,6 +733,7 @@ void NetConnection::setScopeObject(NetObject *obj)
    if(((NetObject *) mScopeObject) == obj)
       return;
    mScopeObject = obj;
+   invalidateScopeQuery();
 }
 
 void NetConnection::detachObject(GhostInfo *info)
@@ -939,6 +1002,7 @@ void NetConnection::activateGhosting()
       mGhostArray[j]->arrayIndex = j;
    }
    mScoping = true; // so that objectInScope will work
+   mScopeQueryCountdown = 0;
    for(i = ghostAlwaysSet->begin(); i != ghostAlwaysSet->end(); i++)
    {
       AssertFatal(dynamic_cast<NetObject *>(*i) != NULL, avar("Non NetObject in GhostAlwaysSet: %s", (*i)->getClassName()));
@@ -0,0 +1,200 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "platform/platform.h"
+#include "sim/netConnection.h"
+#include "sim/netObject.h"
+#include "core/stream/bitStream.h"
+#include "math/mRandom.h"
+
+FIXTURE(NetGhost)
+{
+public:
+   /// Counts the scope queries it is asked to run.
+   class TestScopeObject : public NetObject
+   {
+   public:
+      U32 mQueries;
+
+      TestScopeObject() : mQueries(0) {}
+
+      virtual void onCameraScopeQuery(NetConnection*, CameraScopeQuery*) { mQueries++; }
+   };
+
+   /// Exposes the ghost scheduling of the connection.
+   class TestConnection : public NetConnection
+   {
+   public:
+      void startGhosting()
+      {
+         setGhostFrom(true);
+         mGhosting = true;
+      }
+
+      void writePacket()
+      {
+         U8 buffer[1500];
+         BitStream stream(buffer, sizeof(buffer));
+         PacketNotify notify;
+         ghostWritePacket(&stream, &notify);
+      }
+
+      static void siftDown(GhostInfo** heap, S32 count, S32 index)
+      {
+         siftGhostDown(heap, count, index);
+      }
+   };
+
+   MRandomLCG mRandom;
+   S32 mSavedScopeQueryInterval;
+
+   virtual void SetUp()
+   {
+      mRandom.setSeed(19930714);
+      mSavedScopeQueryInterval = NetConnection::smScopeQueryInterval;
+   }
+
+   virtual void TearDown()
+   {
+      NetConnection::smScopeQueryInterval = mSavedScopeQueryInterval;
+   }
+
+   /// Heapify the ghosts like ghostWritePacket() and pop them all.
+   void popAll(Vector<GhostInfo*>& heap, Vector<F32>& outPriorities)
+   {
+      S32 count = heap.size();
+      for (S32 i = count / 2 - 1; i >= 0; i--)
+         TestConnection::siftDown(heap.address(), count, i);
+
+      outPriorities.clear();
+      while (count > 0)
+      {
+         outPriorities.push_back(heap[0]->priority);
+         heap[0] = heap[--count];
+         if (count > 0)
+            TestConnection::siftDown(heap.address(), count, 0);
+      }
+   }
+};
+
+TEST_FIX(NetGhost, HeapPopsInPriorityOrder)
+{
+   static const U32 numGhosts = 500;
+
+   GhostInfo* ghosts = new GhostInfo[numGhosts];
+   Vector<GhostInfo*> heap;
+   Vector<F32> expected;
+
+   for (U32 i = 0; i < numGhosts; i++)
+   {
+      // Plenty of ties, like the priority of untouched ghosts.
+      ghosts[i].priority = (i % 7 == 0) ? 1.0f : mRandom.randF(0.0f, 100.0f);
+      heap.push_back(&ghosts[i]);
+      expected.push_back(ghosts[i].priority);
+   }
+
+   Vector<F32> popped;
+   popAll(heap, popped);
+
+   // A full sort by descending priority.
+   for (U32 i = 1; i < expected.size(); i++)
+   {
+      const F32 priority = expected[i];
+      U32 j = i;
+      for (; j > 0 && expected[j - 1] < priority; j--)
+         expected[j] = expected[j - 1];
+      expected[j] = priority;
+   }
+
+   ASSERT_EQ(expected.size(), popped.size());
+   for (U32 i = 0; i < expected.size(); i++)
+   {
+      EXPECT_EQ(expected[i], popped[i]) << "Pop " << i;
+   }
+
+   delete [] ghosts;
+}
+
+TEST_FIX(NetGhost, ScopeQueryIsReused)
+{
+   NetConnection::smScopeQueryInterval = 3;
+
+   TestScopeObject scope;
+   TestConnection* connection = new TestConnection();
+   connection->startGhosting();
+   connection->setScopeObject(&scope);
+
+   for (U32 i = 0; i < 7; i++)
+      connection->writePacket();
+
+   // Packets 0, 3 and 6 query.
+   EXPECT_EQ(3, scope.mQueries);
+   EXPECT_EQ(3, connection->getGhostStats().scopeQueries);
+   EXPECT_EQ(7, connection->getGhostStats().packets);
+
+   // An interval of one queries on every packet.
+   NetConnection::smScopeQueryInterval = 1;
+   scope.mQueries = 0;
+   connection->invalidateScopeQuery();
+   for (U32 i = 0; i < 4; i++)
+      connection->writePacket();
+   EXPECT_EQ(4, scope.mQueries);
+
+   delete connection;
+}
+
+TEST_FIX(NetGhost, StaleScopeQueryIsRerun)
+{
+   NetConnection::smScopeQueryInterval = 100;
+
+   TestScopeObject first;
+   TestScopeObject second;
+   TestConnection* connection = new TestConnection();
+   connection->startGhosting();
+   connection->setScopeObject(&first);
+
+   connection->writePacket();
+   connection->writePacket();
+   EXPECT_EQ(1, first.mQueries);
+
+   // A new scope object, e.g. from switching to another camera, is
+   // queried on the next packet.
+   connection->setScopeObject(&second);
+   connection->writePacket();
+   EXPECT_EQ(1, first.mQueries);
+   EXPECT_EQ(1, second.mQueries);
+
+   connection->writePacket();
+   EXPECT_EQ(1, second.mQueries);
+
+   // So is the current one once its result is invalidated.
+   connection->invalidateScopeQuery();
+   connection->writePacket();
+   EXPECT_EQ(2, second.mQueries);
+
+   delete connection;
+}
+
+#endif
@@ -43,6 +43,21 @@ template<> ResourceBase::Signature Resource<TerrainFile>::signature()
    return MakeFourCC('t','e','r','d');
 }
 
+static bool _decodeTerrainFileAsync( const Torque::Path &path, void **outDecoded )
+{
+   *outDecoded = TerrainFile::loadData( path );
+   return true;
+}
+
+static void* _finishTerrainFileAsync( const Torque::Path &path, void *decoded )
+{
+   TerrainFile *file = reinterpret_cast<TerrainFile*>( decoded );
+   file->finishLoad();
+   return file;
+}
+
+static ResourceRegisterAsyncLoader<TerrainFile> sgTerrainFileAsyncLoader( _decodeTerrainFileAsync, _finishTerrainFileAsync );
+
 
 TerrainFile::TerrainFile()
    : mSize( 256 ),
@@ -293,6 +308,15 @@ bool TerrainFile::save( const char *filename )
 }
 
 TerrainFile* TerrainFile::load( const Torque::Path &path )
+{
+   TerrainFile *ret = loadData( path );
+   if ( ret )
+      ret->finishLoad();
+
+   return ret;
+}
+
+TerrainFile* TerrainFile::loadData( const Torque::Path &path )
 {
    FileStream stream;
 
@@ -322,13 +346,20 @@ TerrainFile* TerrainFile::load( const Torque::Path &path )
 
    // Update the collision structures.
    ret->_buildGridMap();
-   
-   // Do the material mapping.
-   ret->_initMaterialInstMapping();
-   
+
    return ret;
 }
 
+void TerrainFile::finishLoad()
+{
+   // Resolve the TerrainMaterial objects from the names.
+   _resolveMaterials( mMaterialNames );
+   mMaterialNames.clear();
+
+   // Do the material mapping.
+   _initMaterialInstMapping();
+}
+
 void TerrainFile::_load( FileStream &stream )
 {
    // NOTE: We read using a loop instad of in one large chunk
@@ -357,8 +388,9 @@ void TerrainFile::_load( FileStream &stream )
    for ( U32 i=0; i < materialCount; i++ )
       stream.read( &materials[i] );
 
-   // Resolve the TerrainMaterial objects from the names.
-   _resolveMaterials( materials );
+   // The TerrainMaterial objects are resolved from the
+   // names on the main thread in finishLoad().
+   mMaterialNames = materials;
 }
 
 void TerrainFile::_loadLegacy(  FileStream &stream )
@@ -555,8 +587,9 @@ void TerrainFile::_loadLegacy(  FileStream &stream )
    // Force resaving on these old file versions.
    //mNeedsResaving = false;
 
-   // Resolve the TerrainMaterial objects from the names.
-   _resolveMaterials( materials );
+   // The TerrainMaterial objects are resolved from the
+   // names on the main thread in finishLoad().
+   mMaterialNames = materials;
 }
 
 void TerrainFile::_resolveMaterials( const Vector<String> &materials )
@@ -111,6 +111,10 @@ protected:
    /// The full path and name of the TerrainFile
    Torque::Path mFilePath;
 
+   /// The material names read from the file until they
+   /// are resolved by finishLoad().
+   Vector<String> mMaterialNames;
+
    /// The internal loading function.
    void _load( FileStream &stream );
 
@@ -146,6 +150,16 @@ public:
    ///
    static TerrainFile* load( const Torque::Path &path );
 
+   /// Reads the file and builds the collision structures
+   /// without touching any sim objects, so it can be called
+   /// from a worker thread.  Call finishLoad() on the main
+   /// thread before using the result.
+   static TerrainFile* loadData( const Torque::Path &path );
+
+   /// Resolves the terrain materials for a file read
+   /// with loadData().
+   void finishLoad();
+
    bool save( const char *filename );
 
    ///
@@ -65,6 +65,57 @@ void zero_vert_normal_bulk_SSE(const dsize_t count, U8 * __restrict const outPtr
    }
 }
 
+void skin_verts_bulk_SSE(const TSSkinBatch &batch, const dsize_t start, const dsize_t count, U8 * __restrict const outPtr, const dsize_t outStride)
+{
+   // The fourth lane of the position holds the tangent W and the fourth lane
+   // of the normal holds the tangent X, so those are kept from the buffer.
+   static const union { U32 u[4]; __m128 v; } _keep_w_mask = { { 0, 0, 0, 0xFFFFFFFF } };
+   const __m128 vKeepMask = _keep_w_mask.v;
+
+   for(dsize_t i = start; i < start + count; i++)
+   {
+      const S32 vidx = batch.vertexIndex[i];
+      const F32 *inVert = batch.inVerts + vidx * 3;
+      const F32 *inNorm = batch.inNorms + vidx * 3;
+
+      // blend the bone columns by weight
+      __m128 vC0 = _mm_setzero_ps();
+      __m128 vC1 = _mm_setzero_ps();
+      __m128 vC2 = _mm_setzero_ps();
+      __m128 vC3 = _mm_setzero_ps();
+
+      const U32 endInfluence = batch.influenceStart[i + 1];
+      for(U32 j = batch.influenceStart[i]; j < endInfluence; j++)
+      {
+         const F32 *c = batch.boneColumns + batch.boneIndex[j] * 16;
+         const __m128 vW = _mm_set1_ps(batch.weight[j]);
+
+         vC0 = _mm_add_ps(vC0, _mm_mul_ps(_mm_load_ps(c), vW));
+         vC1 = _mm_add_ps(vC1, _mm_mul_ps(_mm_load_ps(c + 4), vW));
+         vC2 = _mm_add_ps(vC2, _mm_mul_ps(_mm_load_ps(c + 8), vW));
+         vC3 = _mm_add_ps(vC3, _mm_mul_ps(_mm_load_ps(c + 12), vW));
+      }
+
+      // transform the bind pose position and normal by the blended matrix
+      __m128 vPos = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vC0, _mm_set1_ps(inVert[0])),
+                                          _mm_mul_ps(vC1, _mm_set1_ps(inVert[1]))),
+                               _mm_add_ps(_mm_mul_ps(vC2, _mm_set1_ps(inVert[2])), vC3));
+      __m128 vNrm = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vC0, _mm_set1_ps(inNorm[0])),
+                                          _mm_mul_ps(vC1, _mm_set1_ps(inNorm[1]))),
+                               _mm_mul_ps(vC2, _mm_set1_ps(inNorm[2])));
+
+      TSMesh::__TSMeshVertexBase *curElem = reinterpret_cast<TSMesh::__TSMeshVertexBase *>(outPtr + outStride * vidx);
+      F32 *outVert = curElem->_vert;
+      F32 *outNorm = curElem->_normal;
+
+      // merge and store
+      vPos = _mm_or_ps(_mm_andnot_ps(vKeepMask, vPos), _mm_and_ps(vKeepMask, _mm_loadu_ps(outVert)));
+      vNrm = _mm_or_ps(_mm_andnot_ps(vKeepMask, vNrm), _mm_and_ps(vKeepMask, _mm_loadu_ps(outNorm)));
+      _mm_storeu_ps(outVert, vPos);
+      _mm_storeu_ps(outNorm, vNrm);
+   }
+}
+
 //------------------------------------------------------------------------------
 
 #endif // TORQUE_CPU_X86
\ No newline at end of file
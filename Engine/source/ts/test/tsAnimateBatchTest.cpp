@@ -0,0 +1,193 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "ts/tsShape.h"
+#include "ts/tsShapeInstance.h"
+#include "math/mRandom.h"
+
+FIXTURE(TSAnimateBatch)
+{
+public:
+   enum
+   {
+      NumNodes = 12,
+      NumKeyframes = 8,
+      NumInstances = 24,
+   };
+
+   MRandomLCG mRandom;
+
+   TSShape *mShape;
+   TSShapeInstance *mBatch[NumInstances];
+   TSShapeInstance *mSerial[NumInstances];
+
+   bool mSavedParallelAnimate;
+   S32 mSavedMinParallelAnimate;
+
+   virtual void SetUp()
+   {
+      mSavedParallelAnimate = TSShapeInstance::smParallelAnimate;
+      mSavedMinParallelAnimate = TSShapeInstance::smMinParallelAnimate;
+      TSShapeInstance::smParallelAnimate = true;
+      TSShapeInstance::smMinParallelAnimate = 2;
+
+      mRandom.setSeed(1138);
+
+      // A single subshape with a chain of nodes.
+      mShape = new TSShape();
+      mShape->mSmallestVisibleDL = 0;
+      mShape->subShapeFirstNode.push_back(0);
+      mShape->subShapeNumNodes.push_back(0);
+      mShape->subShapeFirstObject.push_back(0);
+      mShape->subShapeNumObjects.push_back(0);
+
+      for (S32 i = 0; i < NumNodes; i++)
+      {
+         String parent = i ? String::ToString("node%d", i - 1) : String("");
+         mShape->addNode(String::ToString("node%d", i), parent, Point3F(0.0f, 0.0f, 1.0f), QuatF(0.0f, 0.0f, 0.0f, 1.0f));
+      }
+
+      TSShape::Detail detail;
+      dMemset(&detail, 0, sizeof(detail));
+      detail.nameIndex = mShape->addName("detail2");
+      detail.subShapeNum = 0;
+      detail.objectDetailNum = 0;
+      detail.size = 2.0f;
+      detail.averageError = -1.0f;
+      detail.maxError = -1.0f;
+      detail.bbDetailLevel = -1;
+      mShape->details.push_back(detail);
+
+      // One cyclic sequence rotating and moving every node.
+      TSShape::Sequence seq;
+      seq.nameIndex = mShape->addName("wave");
+      seq.numKeyframes = NumKeyframes;
+      seq.duration = 1.0f;
+      seq.baseRotation = mShape->nodeRotations.size();
+      seq.baseTranslation = mShape->nodeTranslations.size();
+      seq.baseScale = 0;
+      seq.baseObjectState = 0;
+      seq.baseDecalState = 0;
+      seq.firstGroundFrame = mShape->groundTranslations.size();
+      seq.numGroundFrames = 0;
+      seq.firstTrigger = mShape->triggers.size();
+      seq.numTriggers = 0;
+      seq.toolBegin = 0.0f;
+      seq.rotationMatters.setAll(NumNodes);
+      seq.translationMatters.setAll(NumNodes);
+      seq.priority = 0;
+      seq.flags = TSShape::Cyclic;
+      seq.dirtyFlags = TSShapeInstance::TransformDirty;
+      mShape->sequences.push_back(seq);
+
+      for (S32 i = 0; i < NumNodes; i++)
+      {
+         for (S32 j = 0; j < NumKeyframes; j++)
+         {
+            Point3F axis(mRandom.randF(-1.0f, 1.0f), mRandom.randF(-1.0f, 1.0f), 1.0f);
+            axis.normalize();
+
+            Quat16 rot;
+            rot.set(QuatF(AngAxisF(axis, mRandom.randF(-M_PI_F, M_PI_F))));
+            mShape->nodeRotations.push_back(rot);
+            mShape->nodeTranslations.push_back(Point3F(mRandom.randF(-1.0f, 1.0f), 0.0f, 1.0f));
+         }
+      }
+
+      // Pairs of instances at the same sequence positions.
+      for (U32 i = 0; i < NumInstances; i++)
+      {
+         F32 pos = F32(i) / NumInstances;
+         mBatch[i] = _createInstance(pos);
+         mSerial[i] = _createInstance(pos);
+      }
+   }
+
+   virtual void TearDown()
+   {
+      for (U32 i = 0; i < NumInstances; i++)
+      {
+         delete mBatch[i];
+         delete mSerial[i];
+      }
+      delete mShape;
+
+      TSShapeInstance::smParallelAnimate = mSavedParallelAnimate;
+      TSShapeInstance::smMinParallelAnimate = mSavedMinParallelAnimate;
+   }
+
+   TSShapeInstance* _createInstance(F32 pos)
+   {
+      TSShapeInstance *inst = new TSShapeInstance(mShape, false);
+      inst->setSequence(inst->addThread(), 0, pos);
+      return inst;
+   }
+
+   void compareNodeTransforms()
+   {
+      for (U32 i = 0; i < NumInstances; i++)
+      {
+         ASSERT_EQ(mSerial[i]->mNodeTransforms.size(), mBatch[i]->mNodeTransforms.size());
+         for (S32 j = 0; j < mSerial[i]->mNodeTransforms.size(); j++)
+         {
+            const F32 *expected = mSerial[i]->mNodeTransforms[j];
+            const F32 *actual = mBatch[i]->mNodeTransforms[j];
+            for (U32 k = 0; k < 16; k++)
+               EXPECT_FLOAT_EQ(expected[k], actual[k]) << "instance " << i << ", node " << j;
+         }
+      }
+   }
+};
+
+TEST_FIX(TSAnimateBatch, ParallelMatchesSerial)
+{
+   TSShapeInstance::animateBatch(mBatch, NumInstances);
+   for (U32 i = 0; i < NumInstances; i++)
+      mSerial[i]->animate();
+
+   compareNodeTransforms();
+
+   // The sequence moves the nodes, so the pose must differ along the batch.
+   Point3F first = mBatch[0]->mNodeTransforms.last().getPosition();
+   Point3F middle = mBatch[NumInstances / 2]->mNodeTransforms.last().getPosition();
+   EXPECT_GT((first - middle).len(), 0.001f);
+}
+
+TEST_FIX(TSAnimateBatch, NodeSubtreesMatchSerial)
+{
+   for (U32 i = 0; i < NumInstances; i++)
+   {
+      mBatch[i]->setPos(mBatch[i]->getThread(0), 0.5f);
+      mSerial[i]->setPos(mSerial[i]->getThread(0), 0.5f);
+   }
+
+   TSShapeInstance::animateBatch(mBatch, NumInstances, true);
+   for (U32 i = 0; i < NumInstances; i++)
+      mSerial[i]->animateNodeSubtrees();
+
+   compareNodeTransforms();
+}
+
+#endif
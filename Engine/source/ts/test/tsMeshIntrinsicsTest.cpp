@@ -0,0 +1,174 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "ts/tsMesh.h"
+#include "ts/tsMeshIntrinsics.h"
+#include "ts/arch/tsMeshIntrinsics.arch.h"
+#include "math/mRandom.h"
+
+extern void skin_verts_bulk_C(const TSSkinBatch &batch, const dsize_t start, const dsize_t count, U8 * __restrict const outPtr, const dsize_t outStride);
+
+FIXTURE(TSMeshIntrinsics)
+{
+public:
+   enum
+   {
+      NumVerts = 301,
+      NumBones = 24,
+   };
+
+   MRandomLCG mRandom;
+
+   Vector<F32> mBoneColumnData;
+   F32 *mBoneColumns;
+   Vector<S32> mVertexIndex;
+   Vector<U32> mInfluenceStart;
+   Vector<U32> mBoneIndex;
+   Vector<F32> mWeight;
+   Vector<Point3F> mInVerts;
+   Vector<Point3F> mInNorms;
+
+   TSSkinBatch mBatch;
+
+   virtual void SetUp()
+   {
+      mRandom.setSeed(1138);
+
+      // Random bone transforms, stored as padded columns.
+      mBoneColumnData.setSize(NumBones * 16 + 4);
+      mBoneColumns = (F32*)(((dsize_t)mBoneColumnData.address() + 15) & ~(dsize_t)15);
+      for (U32 i = 0; i < NumBones; i++)
+      {
+         MatrixF mat(EulerF(mRandom.randF(-M_PI_F, M_PI_F), mRandom.randF(-M_PI_F, M_PI_F), mRandom.randF(-M_PI_F, M_PI_F)));
+         mat.setPosition(Point3F(mRandom.randF(-10.0f, 10.0f), mRandom.randF(-10.0f, 10.0f), mRandom.randF(-10.0f, 10.0f)));
+
+         const F32 *m = mat;
+         F32 *c = mBoneColumns + i * 16;
+         for (U32 col = 0; col < 4; col++)
+         {
+            c[col * 4 + 0] = m[col];
+            c[col * 4 + 1] = m[col + 4];
+            c[col * 4 + 2] = m[col + 8];
+            c[col * 4 + 3] = 0.0f;
+         }
+      }
+
+      // Bind pose, visited in a shuffled order.
+      mInVerts.setSize(NumVerts);
+      mInNorms.setSize(NumVerts);
+      mVertexIndex.setSize(NumVerts);
+      for (U32 i = 0; i < NumVerts; i++)
+      {
+         mInVerts[i].set(mRandom.randF(-2.0f, 2.0f), mRandom.randF(-2.0f, 2.0f), mRandom.randF(-2.0f, 2.0f));
+         mInNorms[i].set(mRandom.randF(-1.0f, 1.0f), mRandom.randF(-1.0f, 1.0f), mRandom.randF(-1.0f, 1.0f));
+         mInNorms[i].normalizeSafe();
+         mVertexIndex[i] = i;
+      }
+      for (U32 i = NumVerts - 1; i > 0; i--)
+      {
+         U32 j = mRandom.randI(0, i);
+         S32 tmp = mVertexIndex[i];
+         mVertexIndex[i] = mVertexIndex[j];
+         mVertexIndex[j] = tmp;
+      }
+
+      // One to four influences per vertex with weights summing to one.
+      mInfluenceStart.setSize(NumVerts + 1);
+      for (U32 i = 0; i < NumVerts; i++)
+      {
+         mInfluenceStart[i] = mBoneIndex.size();
+
+         const U32 numInfluences = mRandom.randI(1, 4);
+         F32 total = 0.0f;
+         for (U32 j = 0; j < numInfluences; j++)
+         {
+            mBoneIndex.push_back(mRandom.randI(0, NumBones - 1));
+            mWeight.push_back(mRandom.randF(0.1f, 1.0f));
+            total += mWeight.last();
+         }
+         for (U32 j = mInfluenceStart[i]; j < mWeight.size(); j++)
+            mWeight[j] /= total;
+      }
+      mInfluenceStart[NumVerts] = mBoneIndex.size();
+
+      mBatch.boneColumns = mBoneColumns;
+      mBatch.vertexIndex = mVertexIndex.address();
+      mBatch.influenceStart = mInfluenceStart.address();
+      mBatch.boneIndex = mBoneIndex.address();
+      mBatch.weight = mWeight.address();
+      mBatch.inVerts = (const F32*)mInVerts.address();
+      mBatch.inNorms = (const F32*)mInNorms.address();
+   }
+
+   /// Skin the entries [start, start + count) with both kernels and compare
+   /// the vertex buffers they write.
+   void compareKernels(void (*kernel)(const TSSkinBatch &, const dsize_t, const dsize_t, U8 * __restrict const, const dsize_t),
+                       U32 start, U32 count)
+   {
+      const dsize_t stride = sizeof(TSMesh::__TSMeshVertexBase);
+
+      Vector<TSMesh::__TSMeshVertexBase> expected;
+      Vector<TSMesh::__TSMeshVertexBase> actual;
+      expected.setSize(NumVerts);
+      actual.setSize(NumVerts);
+      dMemset(expected.address(), 0, NumVerts * stride);
+      dMemset(actual.address(), 0, NumVerts * stride);
+
+      skin_verts_bulk_C(mBatch, start, count, (U8*)expected.address(), stride);
+      kernel(mBatch, start, count, (U8*)actual.address(), stride);
+
+      for (U32 i = 0; i < NumVerts; i++)
+      {
+         EXPECT_TRUE(expected[i]._vert.equal(actual[i]._vert, 0.0001f))
+            << "vertex " << i << " position differs";
+         EXPECT_TRUE(expected[i]._normal.equal(actual[i]._normal, 0.0001f))
+            << "vertex " << i << " normal differs";
+      }
+   }
+};
+
+#if defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )
+
+TEST_FIX(TSMeshIntrinsics, SkinVertsSSEMatchesC)
+{
+   if (!(Platform::SystemInfo.processor.properties & CPU_PROP_SSE))
+      return;
+
+   compareKernels(skin_verts_bulk_SSE, 0, NumVerts);
+
+   // Runs that do not start or end on a multiple of four entries.
+   compareKernels(skin_verts_bulk_SSE, 7, 93);
+   compareKernels(skin_verts_bulk_SSE, NumVerts - 3, 3);
+}
+
+#endif
+
+TEST_FIX(TSMeshIntrinsics, SkinVertsDispatchMatchesC)
+{
+   ASSERT_TRUE(skin_verts_bulk != NULL);
+   compareKernels(skin_verts_bulk, 0, NumVerts);
+}
+
+#endif
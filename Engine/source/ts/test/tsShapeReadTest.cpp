@@ -0,0 +1,175 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2012 GarageGames, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifdef TORQUE_TESTS_ENABLED
+#include "testing/unitTesting.h"
+#include "ts/tsShape.h"
+#include "ts/tsShapeInstance.h"
+#include "ts/tsMaterialList.h"
+#include "core/stream/memStream.h"
+#include "platform/threads/threadPool.h"
+
+FIXTURE(TSShapeRead)
+{
+public:
+   enum
+   {
+      NumNodes = 6,
+      NumKeyframes = 4,
+      NumReads = 16,
+   };
+
+   TSShape *mShape;
+   Vector<U8> mData;
+
+   virtual void SetUp()
+   {
+      // A single subshape with a chain of nodes and one sequence.
+      mShape = new TSShape();
+      mShape->mSmallestVisibleDL = 0;
+      mShape->materialList = new TSMaterialList();
+      mShape->subShapeFirstNode.push_back(0);
+      mShape->subShapeNumNodes.push_back(0);
+      mShape->subShapeFirstObject.push_back(0);
+      mShape->subShapeNumObjects.push_back(0);
+
+      for (S32 i = 0; i < NumNodes; i++)
+      {
+         String parent = i ? String::ToString("node%d", i - 1) : String("");
+         mShape->addNode(String::ToString("node%d", i), parent, Point3F(0.0f, 0.0f, F32(i)), QuatF(0.0f, 0.0f, 0.0f, 1.0f));
+      }
+
+      TSShape::Detail detail;
+      dMemset(&detail, 0, sizeof(detail));
+      detail.nameIndex = mShape->addName("detail2");
+      detail.size = 2.0f;
+      detail.averageError = -1.0f;
+      detail.maxError = -1.0f;
+      detail.bbDetailLevel = -1;
+      mShape->details.push_back(detail);
+
+      TSShape::Sequence seq;
+      seq.nameIndex = mShape->addName("wave");
+      seq.numKeyframes = NumKeyframes;
+      seq.duration = 1.0f;
+      seq.baseRotation = 0;
+      seq.baseTranslation = 0;
+      seq.baseScale = 0;
+      seq.baseObjectState = 0;
+      seq.baseDecalState = 0;
+      seq.firstGroundFrame = 0;
+      seq.numGroundFrames = 0;
+      seq.firstTrigger = 0;
+      seq.numTriggers = 0;
+      seq.toolBegin = 0.0f;
+      seq.rotationMatters.setAll(NumNodes);
+      seq.translationMatters.setAll(NumNodes);
+      seq.priority = 0;
+      seq.flags = TSShape::Cyclic;
+      seq.dirtyFlags = TSShapeInstance::TransformDirty;
+      mShape->sequences.push_back(seq);
+
+      for (S32 i = 0; i < NumNodes * NumKeyframes; i++)
+      {
+         Quat16 rot;
+         rot.set(QuatF(AngAxisF(Point3F(0.0f, 0.0f, 1.0f), F32(i) * 0.1f)));
+         mShape->nodeRotations.push_back(rot);
+         mShape->nodeTranslations.push_back(Point3F(F32(i), 0.0f, 1.0f));
+      }
+
+      // Shapes without meshes have no vertex format, so write the
+      // format from before it was stored.
+      MemStream stream(4096);
+      mShape->write(&stream, true);
+      mData.setSize(stream.getPosition());
+      dMemcpy(mData.address(), stream.getBuffer(), mData.size());
+   }
+
+   virtual void TearDown()
+   {
+      delete mShape;
+      mData.clear();
+   }
+
+   /// Reads a copy of the shape for every index of the range.
+   struct ReadRange
+   {
+      const Vector<U8> &mData;
+      TSShape **mShapes;
+      bool *mResults;
+
+      ReadRange(const Vector<U8> &data, TSShape **shapes, bool *results)
+         : mData(data), mShapes(shapes), mResults(results) {}
+
+      void operator()(U32 begin, U32 end)
+      {
+         for (U32 i = begin; i < end; i++)
+         {
+            MemStream stream(mData.size(), (void*)mData.address(), true, false);
+            mShapes[i] = new TSShape();
+            mResults[i] = mShapes[i]->read(&stream, false);
+         }
+      }
+   };
+};
+
+TEST_FIX(TSShapeRead, ParallelReadsMatchShape)
+{
+   ASSERT_GT(mData.size(), 0U);
+
+   TSShape *shapes[NumReads];
+   bool results[NumReads];
+   ReadRange read(mData, shapes, results);
+   ThreadPool::GLOBAL().parallelFor(0, NumReads, 1, read);
+
+   for (U32 i = 0; i < NumReads; i++)
+   {
+      TSShape *shape = shapes[i];
+      EXPECT_TRUE(results[i]) << "read " << i << " failed";
+      EXPECT_EQ(24, shape->mReadVersion);
+
+      ASSERT_EQ(mShape->nodes.size(), shape->nodes.size());
+      for (S32 j = 0; j < shape->nodes.size(); j++)
+      {
+         EXPECT_EQ(mShape->nodes[j].parentIndex, shape->nodes[j].parentIndex);
+         EXPECT_TRUE(mShape->getNodeName(j) == shape->getNodeName(j));
+         EXPECT_TRUE(mShape->defaultTranslations[j] == shape->defaultTranslations[j]);
+      }
+
+      ASSERT_EQ(1, shape->sequences.size());
+      EXPECT_EQ(S32(NumKeyframes), shape->sequences[0].numKeyframes);
+      EXPECT_TRUE(shape->sequences[0].isCyclic());
+
+      ASSERT_EQ(mShape->nodeRotations.size(), shape->nodeRotations.size());
+      ASSERT_EQ(mShape->nodeTranslations.size(), shape->nodeTranslations.size());
+      for (S32 j = 0; j < shape->nodeRotations.size(); j++)
+      {
+         EXPECT_EQ(0, dMemcmp(&mShape->nodeRotations[j], &shape->nodeRotations[j], sizeof(Quat16)));
+         EXPECT_TRUE(mShape->nodeTranslations[j] == shape->nodeTranslations[j]);
+      }
+
+      delete shape;
+   }
+}
+
+#endif
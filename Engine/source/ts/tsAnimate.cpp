@@ -21,6 +21,7 @@
 //-----------------------------------------------------------------------------
 
 #include "ts/tsShapeInstance.h"
+#include "platform/threads/threadPool.h"
 
 //----------------------------------------------------------------------------------
 // some utility functions
@@ -69,11 +70,11 @@ void TSShapeInstance::animateNodes(S32 ss)
    mNodeTransforms.setSize(mShape->nodes.size());
 
    // temporary storage for node transforms
-   smNodeCurrentRotations.setSize(mShape->nodes.size());
-   smNodeCurrentTranslations.setSize(mShape->nodes.size());
-   smNodeLocalTransforms.setSize(mShape->nodes.size());
-   smRotationThreads.setSize(mShape->nodes.size());
-   smTranslationThreads.setSize(mShape->nodes.size());
+   mNodeCurrentRotations.setSize(mShape->nodes.size());
+   mNodeCurrentTranslations.setSize(mShape->nodes.size());
+   mNodeLocalTransforms.setSize(mShape->nodes.size());
+   mRotationThreads.setSize(mShape->nodes.size());
+   mTranslationThreads.setSize(mShape->nodes.size());
 
    TSIntegerSet rotBeenSet;
    TSIntegerSet tranBeenSet;
@@ -81,7 +82,7 @@ void TSShapeInstance::animateNodes(S32 ss)
    rotBeenSet.setAll(mShape->nodes.size());
    tranBeenSet.setAll(mShape->nodes.size());
    scaleBeenSet.setAll(mShape->nodes.size());
-   smNodeLocalTransformDirty.clearAll();
+   mNodeLocalTransformDirty.clearAll();
 
    S32 i,j,nodeIndex,a,b,start,end,firstBlend = mThreadList.size();
    for (i=0; i<mThreadList.size(); i++)
@@ -122,13 +123,13 @@ void TSShapeInstance::animateNodes(S32 ss)
    {
       if (rotBeenSet.test(i))
       {
-         mShape->defaultRotations[i].getQuatF(&smNodeCurrentRotations[i]);
-         smRotationThreads[i] = NULL;
+         mShape->defaultRotations[i].getQuatF(&mNodeCurrentRotations[i]);
+         mRotationThreads[i] = NULL;
       }
       if (tranBeenSet.test(i))
       {
-         smNodeCurrentTranslations[i] = mShape->defaultTranslations[i];
-         smTranslationThreads[i] = NULL;
+         mNodeCurrentTranslations[i] = mShape->defaultTranslations[i];
+         mTranslationThreads[i] = NULL;
       }
    }
 
@@ -161,9 +162,9 @@ void TSShapeInstance::animateNodes(S32 ss)
             QuatF q1,q2;
             mShape->getRotation(*th->getSequence(),th->keyNum1,j,&q1);
             mShape->getRotation(*th->getSequence(),th->keyNum2,j,&q2);
-            TSTransform::interpolate(q1,q2,th->keyPos,&smNodeCurrentRotations[nodeIndex]);
+            TSTransform::interpolate(q1,q2,th->keyPos,&mNodeCurrentRotations[nodeIndex]);
             rotBeenSet.set(nodeIndex);
-            smRotationThreads[nodeIndex] = th;
+            mRotationThreads[nodeIndex] = th;
          }
       }
 
@@ -182,8 +183,8 @@ void TSShapeInstance::animateNodes(S32 ss)
             {
                const Point3F & p1 = mShape->getTranslation(*th->getSequence(),th->keyNum1,j);
                const Point3F & p2 = mShape->getTranslation(*th->getSequence(),th->keyNum2,j);
-               TSTransform::interpolate(p1,p2,th->keyPos,&smNodeCurrentTranslations[nodeIndex]);
-               smTranslationThreads[nodeIndex] = th;
+               TSTransform::interpolate(p1,p2,th->keyPos,&mNodeCurrentTranslations[nodeIndex]);
+               mTranslationThreads[nodeIndex] = th;
             }
             tranBeenSet.set(nodeIndex);
          }
@@ -197,9 +198,9 @@ void TSShapeInstance::animateNodes(S32 ss)
    for (i=a; i<b; i++)
    {
       if (!mHandsOffNodes.test(i))
-         TSTransform::setMatrix(smNodeCurrentRotations[i],smNodeCurrentTranslations[i],&smNodeLocalTransforms[i]);
+         TSTransform::setMatrix(mNodeCurrentRotations[i],mNodeCurrentTranslations[i],&mNodeLocalTransforms[i]);
       else
-         smNodeLocalTransforms[i] = mNodeTransforms[i];     // in case mNodeTransform was changed externally
+         mNodeLocalTransforms[i] = mNodeTransforms[i];     // in case mNodeTransform was changed externally
    }
 
    // add scale onto transforms
@@ -215,8 +216,8 @@ void TSShapeInstance::animateNodes(S32 ss)
       S32 nodeIndex = mNodeCallbacks[i].nodeIndex;
       if (nodeIndex>=start && nodeIndex<end)
       {
-         mNodeCallbacks[i].callback->setNodeTransform(this, nodeIndex, smNodeLocalTransforms[nodeIndex]);
-         smNodeLocalTransformDirty.set(nodeIndex);
+         mNodeCallbacks[i].callback->setNodeTransform(this, nodeIndex, mNodeLocalTransforms[nodeIndex]);
+         mNodeLocalTransformDirty.set(nodeIndex);
       }
    }
 
@@ -239,9 +240,9 @@ void TSShapeInstance::animateNodes(S32 ss)
    {
       S32 parentIdx = mShape->nodes[i].parentIndex;
       if (parentIdx < 0)
-         mNodeTransforms[i] = smNodeLocalTransforms[i];
+         mNodeTransforms[i] = mNodeLocalTransforms[i];
       else
-         mNodeTransforms[i].mul(mNodeTransforms[parentIdx],smNodeLocalTransforms[i]);
+         mNodeTransforms[i].mul(mNodeTransforms[parentIdx],mNodeLocalTransforms[i]);
    }
 }
 
@@ -250,37 +251,37 @@ void TSShapeInstance::handleDefaultScale(S32 a, S32 b, TSIntegerSet & scaleBeenS
    // set default scale values (i.e., identity) and do any initialization
    // relating to animated scale (since scale normally not animated)
 
-   smScaleThreads.setSize(mShape->nodes.size());
+   mScaleThreads.setSize(mShape->nodes.size());
    scaleBeenSet.takeAway(mCallbackNodes);
    scaleBeenSet.takeAway(mHandsOffNodes);
    if (animatesUniformScale())
    {
-      smNodeCurrentUniformScales.setSize(mShape->nodes.size());
+      mNodeCurrentUniformScales.setSize(mShape->nodes.size());
       for (S32 i=a; i<b; i++)
          if (scaleBeenSet.test(i))
          {
-            smNodeCurrentUniformScales[i] = 1.0f;
-            smScaleThreads[i] = NULL;
+            mNodeCurrentUniformScales[i] = 1.0f;
+            mScaleThreads[i] = NULL;
          }
    }
    else if (animatesAlignedScale())
    {
-      smNodeCurrentAlignedScales.setSize(mShape->nodes.size());
+      mNodeCurrentAlignedScales.setSize(mShape->nodes.size());
       for (S32 i=a; i<b; i++)
          if (scaleBeenSet.test(i))
          {
-            smNodeCurrentAlignedScales[i].set(1.0f,1.0f,1.0f);
-            smScaleThreads[i] = NULL;
+            mNodeCurrentAlignedScales[i].set(1.0f,1.0f,1.0f);
+            mScaleThreads[i] = NULL;
          }
    }
    else
    {
-      smNodeCurrentArbitraryScales.setSize(mShape->nodes.size());
+      mNodeCurrentArbitraryScales.setSize(mShape->nodes.size());
       for (S32 i=a; i<b; i++)
          if (scaleBeenSet.test(i))
          {
-            smNodeCurrentArbitraryScales[i].identity();
-            smScaleThreads[i] = NULL;
+            mNodeCurrentArbitraryScales[i].identity();
+            mScaleThreads[i] = NULL;
          }
    }
 
@@ -301,19 +302,19 @@ void TSShapeInstance::updateTransitionNodeTransforms(TSIntegerSet& transitionNod
    // for blended or scale-animated nodes, as all others are already up to date
    for (S32 i=transitionNodes.start(); i<MAX_TS_SET_SIZE; transitionNodes.next(i))
    {
-      if (smNodeLocalTransformDirty.test(i))
+      if (mNodeLocalTransformDirty.test(i))
       {
          if (scaleCurrentlyAnimated())
          {
             // @todo:No support for scale yet => need to do proper affine decomposition here
-            smNodeCurrentTranslations[i] = smNodeLocalTransforms[i].getPosition();
-            smNodeCurrentRotations[i].set(smNodeLocalTransforms[i]);
+            mNodeCurrentTranslations[i] = mNodeLocalTransforms[i].getPosition();
+            mNodeCurrentRotations[i].set(mNodeLocalTransforms[i]);
          }
          else
          {
             // Scale is identity => can do a cheap decomposition
-            smNodeCurrentTranslations[i] = smNodeLocalTransforms[i].getPosition();
-            smNodeCurrentRotations[i].set(smNodeLocalTransforms[i]);
+            mNodeCurrentTranslations[i] = mNodeLocalTransforms[i].getPosition();
+            mNodeCurrentRotations[i].set(mNodeLocalTransforms[i]);
          }
       }
    }
@@ -331,7 +332,7 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
    {
       if (nodeIndex<a)
          continue;
-      TSThread * thread = smRotationThreads[nodeIndex];
+      TSThread * thread = mRotationThreads[nodeIndex];
       thread = thread && thread->transitionData.inTransition ? thread : NULL;
       if (!thread)
       {
@@ -349,7 +350,7 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
          AssertFatal(thread!=NULL,"TSShapeInstance::handleRotTransitionNodes (rotation)");
       }
       QuatF tmpQ;
-      TSTransform::interpolate(mNodeReferenceRotations[nodeIndex].getQuatF(&tmpQ),smNodeCurrentRotations[nodeIndex],thread->transitionData.pos,&smNodeCurrentRotations[nodeIndex]);
+      TSTransform::interpolate(mNodeReferenceRotations[nodeIndex].getQuatF(&tmpQ),mNodeCurrentRotations[nodeIndex],thread->transitionData.pos,&mNodeCurrentRotations[nodeIndex]);
    }
 
    // then translation
@@ -357,7 +358,7 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
    end   = b;
    for (nodeIndex=start; nodeIndex<end; mTransitionTranslationNodes.next(nodeIndex))
    {
-      TSThread * thread = smTranslationThreads[nodeIndex];
+      TSThread * thread = mTranslationThreads[nodeIndex];
       thread = thread && thread->transitionData.inTransition ? thread : NULL;
       if (!thread)
       {
@@ -374,7 +375,7 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
          }
          AssertFatal(thread!=NULL,"TSShapeInstance::handleTransitionNodes (translation).");
       }
-      Point3F & p = smNodeCurrentTranslations[nodeIndex];
+      Point3F & p = mNodeCurrentTranslations[nodeIndex];
       Point3F & p1 = mNodeReferenceTranslations[nodeIndex];
       Point3F & p2 = p;
       F32 k = thread->transitionData.pos;
@@ -390,7 +391,7 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
       end   = b;
       for (nodeIndex=start; nodeIndex<end; mTransitionScaleNodes.next(nodeIndex))
       {
-         TSThread * thread = smScaleThreads[nodeIndex];
+         TSThread * thread = mScaleThreads[nodeIndex];
          thread = thread && thread->transitionData.inTransition ? thread : NULL;
          if (!thread)
          {
@@ -408,14 +409,14 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
             AssertFatal(thread!=NULL,"TSShapeInstance::handleTransitionNodes (scale).");
          }
          if (animatesUniformScale())
-            smNodeCurrentUniformScales[nodeIndex] += thread->transitionData.pos * (mNodeReferenceUniformScales[nodeIndex]-smNodeCurrentUniformScales[nodeIndex]);
+            mNodeCurrentUniformScales[nodeIndex] += thread->transitionData.pos * (mNodeReferenceUniformScales[nodeIndex]-mNodeCurrentUniformScales[nodeIndex]);
          else if (animatesAlignedScale())
-            TSTransform::interpolate(mNodeReferenceScaleFactors[nodeIndex],smNodeCurrentAlignedScales[nodeIndex],thread->transitionData.pos,&smNodeCurrentAlignedScales[nodeIndex]);
+            TSTransform::interpolate(mNodeReferenceScaleFactors[nodeIndex],mNodeCurrentAlignedScales[nodeIndex],thread->transitionData.pos,&mNodeCurrentAlignedScales[nodeIndex]);
          else
          {
             QuatF q;
-            TSTransform::interpolate(mNodeReferenceScaleFactors[nodeIndex],smNodeCurrentArbitraryScales[nodeIndex].mScale,thread->transitionData.pos,&smNodeCurrentArbitraryScales[nodeIndex].mScale);
-            TSTransform::interpolate(mNodeReferenceArbitraryScaleRots[nodeIndex].getQuatF(&q),smNodeCurrentArbitraryScales[nodeIndex].mRotate,thread->transitionData.pos,&smNodeCurrentArbitraryScales[nodeIndex].mRotate);
+            TSTransform::interpolate(mNodeReferenceScaleFactors[nodeIndex],mNodeCurrentArbitraryScales[nodeIndex].mScale,thread->transitionData.pos,&mNodeCurrentArbitraryScales[nodeIndex].mScale);
+            TSTransform::interpolate(mNodeReferenceArbitraryScaleRots[nodeIndex].getQuatF(&q),mNodeCurrentArbitraryScales[nodeIndex].mRotate,thread->transitionData.pos,&mNodeCurrentArbitraryScales[nodeIndex].mRotate);
          }
       }
    }
@@ -425,15 +426,15 @@ void TSShapeInstance::handleTransitionNodes(S32 a, S32 b)
    end   = b;
    for (nodeIndex=start; nodeIndex<end; transitionNodes.next(nodeIndex))
    {
-      TSTransform::setMatrix(smNodeCurrentRotations[nodeIndex], smNodeCurrentTranslations[nodeIndex], &smNodeLocalTransforms[nodeIndex]);
+      TSTransform::setMatrix(mNodeCurrentRotations[nodeIndex], mNodeCurrentTranslations[nodeIndex], &mNodeLocalTransforms[nodeIndex]);
       if (scaleCurrentlyAnimated())
       {
          if (animatesUniformScale())
-            TSTransform::applyScale(smNodeCurrentUniformScales[nodeIndex],&smNodeLocalTransforms[nodeIndex]);
+            TSTransform::applyScale(mNodeCurrentUniformScales[nodeIndex],&mNodeLocalTransforms[nodeIndex]);
          else if (animatesAlignedScale())
-               TSTransform::applyScale(smNodeCurrentAlignedScales[nodeIndex],&smNodeLocalTransforms[nodeIndex]);
+               TSTransform::applyScale(mNodeCurrentAlignedScales[nodeIndex],&mNodeLocalTransforms[nodeIndex]);
          else
-            TSTransform::applyScale(smNodeCurrentArbitraryScales[nodeIndex],&smNodeLocalTransforms[nodeIndex]);
+            TSTransform::applyScale(mNodeCurrentArbitraryScales[nodeIndex],&mNodeLocalTransforms[nodeIndex]);
       }
    }
 }
@@ -444,24 +445,24 @@ void TSShapeInstance::handleNodeScale(S32 a, S32 b)
    {
       for (S32 i=a; i<b; i++)
          if (!mHandsOffNodes.test(i))
-            TSTransform::applyScale(smNodeCurrentUniformScales[i],&smNodeLocalTransforms[i]);
+            TSTransform::applyScale(mNodeCurrentUniformScales[i],&mNodeLocalTransforms[i]);
    }
    else if (animatesAlignedScale())
    {
       for (S32 i=a; i<b; i++)
          if (!mHandsOffNodes.test(i))
-            TSTransform::applyScale(smNodeCurrentAlignedScales[i],&smNodeLocalTransforms[i]);
+            TSTransform::applyScale(mNodeCurrentAlignedScales[i],&mNodeLocalTransforms[i]);
    }
    else
    {
       for (S32 i=a; i<b; i++)
          if (!mHandsOffNodes.test(i))
-            TSTransform::applyScale(smNodeCurrentArbitraryScales[i],&smNodeLocalTransforms[i]);
+            TSTransform::applyScale(mNodeCurrentArbitraryScales[i],&mNodeLocalTransforms[i]);
    }
 
    TSIntegerSet scaledNodes;
    scaledNodes.difference(mHandsOffNodes);
-   smNodeLocalTransformDirty.overlap(scaledNodes);
+   mNodeLocalTransformDirty.overlap(scaledNodes);
 }
 
 void TSShapeInstance::handleAnimatedScale(TSThread * thread, S32 a, S32 b, TSIntegerSet & scaleBeenSet)
@@ -529,28 +530,28 @@ void TSShapeInstance::handleAnimatedScale(TSThread * thread, S32 a, S32 b, TSInt
          {
             case 0:  // uniform -> uniform
             {
-               smNodeCurrentUniformScales[nodeIndex] = uniformScale;
+               mNodeCurrentUniformScales[nodeIndex] = uniformScale;
                break;
             }
             case 4:  // uniform -> aligned
             case 5:  // aligned -> aligned
-               smNodeCurrentAlignedScales[nodeIndex] = alignedScale;
+               mNodeCurrentAlignedScales[nodeIndex] = alignedScale;
                break;
             case 8:  // uniform -> arbitrary
             case 9:  // aligned -> arbitrary
             {
-               smNodeCurrentArbitraryScales[nodeIndex].identity();
-               smNodeCurrentArbitraryScales[nodeIndex].mScale = alignedScale;
+               mNodeCurrentArbitraryScales[nodeIndex].identity();
+               mNodeCurrentArbitraryScales[nodeIndex].mScale = alignedScale;
                break;
             }
             case 10: // arbitrary -> arbitary
             {
-               smNodeCurrentArbitraryScales[nodeIndex] = arbitraryScale;
+               mNodeCurrentArbitraryScales[nodeIndex] = arbitraryScale;
                break;
             }
             default: AssertFatal(0,"TSShapeInstance::handleAnimatedScale"); break;
          }
-         smScaleThreads[nodeIndex] = thread;
+         mScaleThreads[nodeIndex] = thread;
          scaleBeenSet.set(nodeIndex);
       }
    }
@@ -564,13 +565,13 @@ void TSShapeInstance::handleMaskedPositionNode(TSThread * th, S32 nodeIndex, S32
    TSTransform::interpolate(p1,p2,th->keyPos,&p);
 
    if (!mMaskPosXNodes.test(nodeIndex))
-      smNodeCurrentTranslations[nodeIndex].x = p.x;
+      mNodeCurrentTranslations[nodeIndex].x = p.x;
 
    if (!mMaskPosYNodes.test(nodeIndex))
-      smNodeCurrentTranslations[nodeIndex].y = p.y;
+      mNodeCurrentTranslations[nodeIndex].y = p.y;
 
    if (!mMaskPosZNodes.test(nodeIndex))
-      smNodeCurrentTranslations[nodeIndex].z = p.z;
+      mNodeCurrentTranslations[nodeIndex].z = p.z;
 }
 
 void TSShapeInstance::handleBlendSequence(TSThread * thread, S32 a, S32 b)
@@ -653,8 +654,8 @@ void TSShapeInstance::handleBlendSequence(TSThread * thread, S32 a, S32 b)
       }
 
       // apply blend transform
-      smNodeLocalTransforms[nodeIndex].mul(mat);
-      smNodeLocalTransformDirty.set(nodeIndex);
+      mNodeLocalTransforms[nodeIndex].mul(mat);
+      mNodeLocalTransformDirty.set(nodeIndex);
    }
 }
 
@@ -917,6 +918,69 @@ void TSShapeInstance::animateSubtrees(bool forceFull)
    }
 }
 
+//-------------------------------------------------------------------------------------
+// Batch animation
+//-------------------------------------------------------------------------------------
+
+namespace {
+
+   /// A batch of instances shared by the threads animating it.
+   struct AnimateBatch
+   {
+      TSShapeInstance* const* instances;
+      bool nodeSubtrees;
+   };
+
+   inline void animateBatchInstance( const AnimateBatch& batch, TSShapeInstance* inst )
+   {
+      if ( batch.nodeSubtrees )
+         inst->animateNodeSubtrees();
+      else
+         inst->animate();
+   }
+
+   /// ThreadPool::parallelFor job animating the thread safe instances
+   /// [begin, end) of the batch.
+   void animateBatchJob( void* data, U32 begin, U32 end )
+   {
+      const AnimateBatch& batch = *reinterpret_cast< const AnimateBatch* >( data );
+      for ( U32 i = begin; i < end; i++ )
+      {
+         TSShapeInstance* inst = batch.instances[ i ];
+         if ( inst->isAnimateThreadSafe() )
+            animateBatchInstance( batch, inst );
+      }
+   }
+
+} // namespace
+
+void TSShapeInstance::animateBatch( TSShapeInstance* const* instances, U32 count, bool nodeSubtrees )
+{
+   PROFILE_SCOPE( TSShapeInstance_animateBatch );
+
+   AnimateBatch batch;
+   batch.instances = instances;
+   batch.nodeSubtrees = nodeSubtrees;
+
+   if ( !smParallelAnimate || (S32)count < getMax( smMinParallelAnimate, 2 ) )
+   {
+      for ( U32 i = 0; i < count; i++ )
+         animateBatchInstance( batch, instances[ i ] );
+      return;
+   }
+
+   // A few instances per job keeps the scheduling cost well below the
+   // cost of animating them.
+   ThreadPool::GLOBAL().parallelFor( 0, count, 4, &animateBatchJob, &batch );
+
+   // Instances with node callbacks run game code and stay on this thread.
+   for ( U32 i = 0; i < count; i++ )
+   {
+      if ( !instances[ i ]->isAnimateThreadSafe() )
+         animateBatchInstance( batch, instances[ i ] );
+   }
+}
+
 void TSShapeInstance::addPath(TSThread *gt, F32 start, F32 end, MatrixF *mat)
 {
    // never get here while in transition...
@@ -57,8 +57,8 @@ public:
    /// DEPRECATED
    // void render(S32 frame, S32 decalFrame, TSMaterialList *);
 
-   void disassemble();
-   void assemble(bool skip);
+   void disassemble(TSShapeAlloc* alloc);
+   void assemble(TSShapeAlloc* alloc, bool skip);
 };
 
 
@@ -151,7 +151,7 @@ void TSMaterialList::setFlags(U32 index, U32 value)
    mFlags[index] = value;
 }
 
-bool TSMaterialList::write(Stream & s)
+bool TSMaterialList::write(Stream & s, S32 version)
 {
    if (!Parent::write(s))
       return false;
@@ -172,7 +172,7 @@ bool TSMaterialList::write(Stream & s)
    // MDF - This used to write mLightmaps
    // We never ended up using it but it is
    // still part of the version 25 standard
-   if (TSShape::smVersion == 25)
+   if (version == 25)
    {
       for (i=0; i<size(); i++)
          s.write(0xFFFFFFFF);
@@ -187,7 +187,7 @@ bool TSMaterialList::write(Stream & s)
    return (s.getStatus() == Stream::Ok);
 }
 
-bool TSMaterialList::read(Stream & s)
+bool TSMaterialList::read(Stream & s, S32 version)
 {
    if (!Parent::read(s))
       return false;
@@ -195,7 +195,7 @@ bool TSMaterialList::read(Stream & s)
    allocate(size());
 
    U32 i;
-   if (TSShape::smReadVersion < 2)
+   if (version < 2)
    {
       for (i=0; i<size(); i++)
          setFlags(i,S_Wrap|T_Wrap);
@@ -206,7 +206,7 @@ bool TSMaterialList::read(Stream & s)
          s.read(&mFlags[i]);
    }
 
-   if (TSShape::smReadVersion < 5)
+   if (version < 5)
    {
       for (i=0; i<size(); i++)
       {
@@ -224,7 +224,7 @@ bool TSMaterialList::read(Stream & s)
       for (i=0; i<size(); i++)
          s.read(&mDetailMaps[i]);
 
-      if (TSShape::smReadVersion == 25)
+      if (version == 25)
       {
          U32 dummy = 0;
 
@@ -233,7 +233,7 @@ bool TSMaterialList::read(Stream & s)
       }
    }
 
-   if (TSShape::smReadVersion > 11)
+   if (version > 11)
    {
       for (i=0; i<size(); i++)
          s.read(&mDetailScales[i]);
@@ -244,7 +244,7 @@ bool TSMaterialList::read(Stream & s)
          mDetailScales[i] = 1.0f;
    }
 
-   if (TSShape::smReadVersion > 20)
+   if (version > 20)
    {
       for (i=0; i<size(); i++)
          s.read(&mReflectionAmounts[i]);
@@ -255,7 +255,7 @@ bool TSMaterialList::read(Stream & s)
          mReflectionAmounts[i] = 1.0f;
    }
 
-   if (TSShape::smReadVersion < 16)
+   if (version < 16)
    {
       // make sure emapping is off for translucent materials on old shapes
       for (i=0; i<size(); i++)
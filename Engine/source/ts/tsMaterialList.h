@@ -86,8 +86,9 @@ class TSMaterialList : public MaterialList
    /// Functions for reading/writing to/from streams
    /// @{
 
-   bool write(Stream &);
-   bool read(Stream &);
+   /// @param version DTS version of the shape the list is part of.
+   bool write(Stream &, S32 version);
+   bool read(Stream &, S32 version);
    /// @}
 
 protected:
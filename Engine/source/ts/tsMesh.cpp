@@ -41,6 +41,7 @@
 #include "collision/optimizedPolyList.h"
 #include "core/frameAllocator.h"
 #include "platform/profiler.h"
+#include "platform/threads/threadPool.h"
 #include "materials/sceneData.h"
 #include "materials/materialManager.h"
 #include "scene/sceneManager.h"
@@ -62,23 +63,6 @@ GFXPrimitiveType drawTypes[] = { GFXTriangleList, GFXTriangleStrip };
 #define getDrawType(a) (drawTypes[a])
 
 
-// structures used to share data between detail levels...
-// used (and valid) during load only
-Vector<Point3F*> TSMesh::smVertsList;
-Vector<Point3F*> TSMesh::smNormsList;
-Vector<U8*>      TSMesh::smEncodedNormsList;
-Vector<Point2F*> TSMesh::smTVertsList;
-Vector<Point2F*> TSMesh::smTVerts2List;
-Vector<ColorI*> TSMesh::smColorsList;
-
-Vector<bool>     TSMesh::smDataCopied;
-
-Vector<MatrixF*> TSSkinMesh::smInitTransformList;
-Vector<S32*>     TSSkinMesh::smVertexIndexList;
-Vector<S32*>     TSSkinMesh::smBoneIndexList;
-Vector<F32*>     TSSkinMesh::smWeightList;
-Vector<S32*>     TSSkinMesh::smNodeIndexList;
-
 bool TSSkinMesh::smDebugSkinVerts = false;
 
 Vector<Point3F> gNormalStore;
@@ -91,6 +75,8 @@ bool TSMesh::smUseEncodedNormals = false;
 const F32 TSMesh::VISIBILITY_EPSILON = 0.0001f;
 
 S32 TSMesh::smMaxInstancingVerts = 200;
+bool TSSkinMesh::smParallelSkinning = true;
+S32 TSSkinMesh::smMinParallelSkinVerts = 8192;
 MatrixF TSMesh::smDummyNodeTransform(1);
 
 // quick function to force object to face camera -- currently throws out roll :(
@@ -1206,73 +1192,152 @@ TSMesh::~TSMesh()
 // TSSkinMesh methods
 //-----------------------------------------------------
 
-void TSSkinMesh::updateSkinBuffer( const Vector<MatrixF> &transforms, U8* buffer )
-{
-   PROFILE_SCOPE(TSSkinMesh_UpdateSkinBuffer);
-
-   AssertFatal(batchData.initialized, "Batch data not initialized. Call createSkinBatchData() before any skin update is called.");
+namespace {
 
-   if (TSShape::smUseHardwareSkinning || mNumVerts == 0)
-      return;
+   /// A skin mesh of a batch, resolved to the input of skin_verts_bulk.
+   struct SkinBatchMesh
+   {
+      TSSkinBatch batch;
+      U32 numEntries;
+      U8 *dest;
+      U32 vertSize;
+   };
 
-   const MatrixF *matrices = NULL;
+   /// A run of batch entries of one mesh.
+   struct SkinBatchChunk
+   {
+      U32 mesh;
+      U32 start;
+      U32 count;
+   };
 
-   static Vector<MatrixF> sBoneTransforms;
-   sBoneTransforms.setSize(batchData.nodeIndex.size());
+   /// The chunks of a skinning batch, shared by the threads skinning it.
+   struct SkinBatch
+   {
+      const SkinBatchMesh *meshes;
+      const SkinBatchChunk *chunks;
+   };
 
-   // set up bone transforms
-   PROFILE_START(TSSkinMesh_UpdateTransforms);
-   for (S32 i = 0; i < batchData.nodeIndex.size(); i++)
+   /// ThreadPool::parallelFor job skinning the chunks [begin, end).
+   void skinBatchJob( void *data, U32 begin, U32 end )
    {
-      S32 node = batchData.nodeIndex[i];
-      sBoneTransforms[i].mul(transforms[node], batchData.initialTransforms[i]);
+      const SkinBatch &batch = *reinterpret_cast< const SkinBatch* >( data );
+      for ( U32 i = begin; i < end; i++ )
+      {
+         const SkinBatchChunk &chunk = batch.chunks[ i ];
+         const SkinBatchMesh &mesh = batch.meshes[ chunk.mesh ];
+         skin_verts_bulk( mesh.batch, chunk.start, chunk.count, mesh.dest, mesh.vertSize );
+      }
    }
 
-   matrices = &sBoneTransforms[0];
-   PROFILE_END();
+} // namespace
+
+void TSSkinMesh::updateSkinBuffer( const Vector<MatrixF> &transforms, U8* buffer )
+{
+   SkinJob job;
+   job.mesh = this;
+   job.transforms = &transforms;
+   job.buffer = buffer;
 
-   const Point3F *inVerts = batchData.initialVerts.address();
-   const Point3F *inNorms = batchData.initialNorms.address();
+   updateSkinBuffers( &job, 1 );
+}
 
-   AssertFatal(inVerts, "Something went wrong, verts should be valid");
+void TSSkinMesh::updateSkinBuffers( const SkinJob *jobs, U32 count )
+{
+   PROFILE_SCOPE(TSSkinMesh_UpdateSkinBuffer);
 
-   U8 *dest = buffer + mVertOffset;
-   if (!dest)
+   if (TSShape::smUseHardwareSkinning || count == 0)
       return;
 
-   Point3F srcVtx, srcNrm;
+   FrameAllocatorMarker marker;
+   SkinBatchMesh *meshes = marker.alloc<SkinBatchMesh>(count);
+   U32 numMeshes = 0;
+   U32 numChunks = 0;
+   U32 numVerts = 0;
+
+   // set up bone transforms, stored as columns for the kernels
+   PROFILE_START(TSSkinMesh_UpdateTransforms);
+   for (U32 i = 0; i < count; i++)
+   {
+      TSSkinMesh *mesh = jobs[i].mesh;
+      const BatchData &data = mesh->batchData;
 
-   AssertFatal(batchData.vertexBatchOperations.size() == batchData.initialVerts.size(), "Assumption failed!");
+      AssertFatal(data.initialized, "Batch data not initialized. Call createSkinBatchData() before any skin update is called.");
+      AssertFatal(data.vertexBatchOperations.size() == data.initialVerts.size(), "Assumption failed!");
 
-   Point3F skinnedVert;
-   Point3F skinnedNorm;
+      if (mesh->mNumVerts == 0 || data.skinVertexIndex.empty() || !jobs[i].buffer)
+         continue;
 
-   for (Vector<BatchData::BatchedVertex>::const_iterator itr = batchData.vertexBatchOperations.begin();
-      itr != batchData.vertexBatchOperations.end(); itr++)
-   {
-      const BatchData::BatchedVertex &curVert = *itr;
+      const Vector<MatrixF> &transforms = *jobs[i].transforms;
+      const U32 numBones = data.nodeIndex.size();
 
-      skinnedVert.zero();
-      skinnedNorm.zero();
+      // The SSE kernel wants the columns 16 byte aligned
+      dsize_t columnsPtr = (dsize_t)marker.alloc(numBones * 16 * sizeof(F32) + 15);
+      F32 *columns = (F32*)((columnsPtr + 15) & ~(dsize_t)15);
 
-      for (S32 tOp = 0; tOp < curVert.transformCount; tOp++)
+      MatrixF boneTransform;
+      for (U32 j = 0; j < numBones; j++)
       {
-         const BatchData::TransformOp &transformOp = curVert.transform[tOp];
+         boneTransform.mul(transforms[data.nodeIndex[j]], data.initialTransforms[j]);
+
+         const F32 *m = boneTransform;
+         F32 *c = columns + j * 16;
+         for (U32 col = 0; col < 4; col++)
+         {
+            c[col * 4 + 0] = m[col];
+            c[col * 4 + 1] = m[col + 4];
+            c[col * 4 + 2] = m[col + 8];
+            c[col * 4 + 3] = 0.0f;
+         }
+      }
 
-         const MatrixF& deltaTransform = matrices[transformOp.transformIndex];
+      SkinBatchMesh &batchMesh = meshes[numMeshes++];
+      batchMesh.batch.boneColumns = columns;
+      batchMesh.batch.vertexIndex = data.skinVertexIndex.address();
+      batchMesh.batch.influenceStart = data.skinInfluenceStart.address();
+      batchMesh.batch.boneIndex = data.skinBoneIndex.address();
+      batchMesh.batch.weight = data.skinWeight.address();
+      batchMesh.batch.inVerts = (const F32*)data.initialVerts.address();
+      batchMesh.batch.inNorms = (const F32*)data.initialNorms.address();
+      batchMesh.numEntries = data.skinVertexIndex.size();
+      batchMesh.dest = jobs[i].buffer + mesh->mVertOffset;
+      batchMesh.vertSize = mesh->mVertSize;
 
-         deltaTransform.mulP(inVerts[curVert.vertexIndex], &srcVtx);
-         skinnedVert += (srcVtx * transformOp.weight);
+      numVerts += batchMesh.numEntries;
+      numChunks += (batchMesh.numEntries + csmSkinChunkSize - 1) / csmSkinChunkSize;
+   }
+   PROFILE_END();
 
-         deltaTransform.mulV(inNorms[curVert.vertexIndex], &srcNrm);
-         skinnedNorm += srcNrm * transformOp.weight;
+   if ( !smParallelSkinning || (S32)numVerts < smMinParallelSkinVerts || numChunks < 2 )
+   {
+      for (U32 i = 0; i < numMeshes; i++)
+      {
+         const SkinBatchMesh &batchMesh = meshes[i];
+         skin_verts_bulk(batchMesh.batch, 0, batchMesh.numEntries, batchMesh.dest, batchMesh.vertSize);
       }
+      return;
+   }
 
-      // Assign results 
-      __TSMeshVertexBase *dvert = (__TSMeshVertexBase*)(dest + (mVertSize * curVert.vertexIndex));
-      dvert->vert(skinnedVert);
-      dvert->normal(skinnedNorm);
+   // Split the meshes into chunks, small meshes are a single chunk
+   SkinBatchChunk *chunks = marker.alloc<SkinBatchChunk>(numChunks);
+   U32 chunkIndex = 0;
+   for (U32 i = 0; i < numMeshes; i++)
+   {
+      for (U32 start = 0; start < meshes[i].numEntries; start += csmSkinChunkSize)
+      {
+         SkinBatchChunk &chunk = chunks[chunkIndex++];
+         chunk.mesh = i;
+         chunk.start = start;
+         chunk.count = getMin(csmSkinChunkSize, meshes[i].numEntries - start);
+      }
    }
+   AssertFatal(chunkIndex == numChunks, "TSSkinMesh::updateSkinBuffers - chunk count mismatch");
+
+   SkinBatch batch;
+   batch.meshes = meshes;
+   batch.chunks = chunks;
+
+   ThreadPool::GLOBAL().parallelFor( 0, numChunks, 1, &skinBatchJob, &batch );
 }
 
 void TSSkinMesh::updateSkinBones( const Vector<MatrixF> &transforms, Vector<MatrixF>& destTransforms )
@@ -1421,6 +1486,25 @@ void TSSkinMesh::createSkinBatchData()
 
    batchData.vertexBatchOperations.set(batchOperations.address(), batchOperations.size());
 
+   // Flatten the batch operations for the skinning kernels
+   batchData.skinVertexIndex.setSize(batchOperations.size());
+   batchData.skinInfluenceStart.setSize(batchOperations.size() + 1);
+   batchData.skinBoneIndex.clear();
+   batchData.skinWeight.clear();
+   for (U32 i = 0; i < batchOperations.size(); i++)
+   {
+      const BatchData::BatchedVertex &batchOp = batchOperations[i];
+
+      batchData.skinVertexIndex[i] = batchOp.vertexIndex;
+      batchData.skinInfluenceStart[i] = batchData.skinBoneIndex.size();
+      for (S32 j = 0; j < batchOp.transformCount; j++)
+      {
+         batchData.skinBoneIndex.push_back(batchOp.transform[j].transformIndex);
+         batchData.skinWeight.push_back(batchOp.transform[j].weight);
+      }
+   }
+   batchData.skinInfluenceStart.last() = batchData.skinBoneIndex.size();
+
    U32 maxValue = 0;
    for (U32 i = 0; i<batchData.vertexBatchOperations.size(); i++)
    {
@@ -1851,16 +1935,15 @@ U8 TSMesh::encodeNormal( const Point3F &normal )
 // TSMesh assemble from/ dissemble to memory buffer
 //-----------------------------------------------------
 
-#define tsalloc TSShape::smTSAlloc
 
-TSMesh* TSMesh::assembleMesh( U32 meshType, bool skip )
+TSMesh* TSMesh::assembleMesh( TSShapeAlloc* alloc, U32 meshType, bool skip )
 {
    static TSMesh tempStandardMesh;
    static TSSkinMesh tempSkinMesh;
    static TSDecalMesh tempDecalMesh;
    static TSSortedMesh tempSortedMesh;
 
-   bool justSize = skip || !tsalloc.allocShape32(0); // if this returns NULL, we're just sizing memory block
+   bool justSize = skip || !alloc->allocShape32(0); // if this returns NULL, we're just sizing memory block
 
    // a little funny business because we pretend decals are derived from meshes
    S32 * ret = NULL;
@@ -1875,28 +1958,28 @@ TSMesh* TSMesh::assembleMesh( U32 meshType, bool skip )
          {
             ret = (S32*)&tempStandardMesh;
             mesh = &tempStandardMesh;
-            tsalloc.allocShape32( sizeof(TSMesh) >> 2 );
+            alloc->allocShape32( sizeof(TSMesh) >> 2 );
             break;
          }
          case SkinMeshType     :
          {
             ret = (S32*)&tempSkinMesh;
             mesh = &tempSkinMesh;
-            tsalloc.allocShape32( sizeof(TSSkinMesh) >> 2 );
+            alloc->allocShape32( sizeof(TSSkinMesh) >> 2 );
             break;
          }
          case DecalMeshType    :
          {
             ret = (S32*)&tempDecalMesh;
             decal = &tempDecalMesh;
-            tsalloc.allocShape32( sizeof(TSDecalMesh) >> 2 );
+            alloc->allocShape32( sizeof(TSDecalMesh) >> 2 );
             break;
          }
          case SortedMeshType   :
          {
             ret = (S32*)&tempSortedMesh;
             mesh = &tempSortedMesh;
-            tsalloc.allocShape32( sizeof(TSSortedMesh) >> 2 );
+            alloc->allocShape32( sizeof(TSSortedMesh) >> 2 );
             break;
          }
       }
@@ -1907,28 +1990,28 @@ TSMesh* TSMesh::assembleMesh( U32 meshType, bool skip )
       {
          case StandardMeshType :
          {
-            ret = tsalloc.allocShape32( sizeof(TSMesh) >> 2 );
+            ret = alloc->allocShape32( sizeof(TSMesh) >> 2 );
             constructInPlace( (TSMesh*)ret );
             mesh = (TSMesh*)ret;
             break;
          }
          case SkinMeshType     :
          {
-            ret = tsalloc.allocShape32( sizeof(TSSkinMesh) >> 2 );
+            ret = alloc->allocShape32( sizeof(TSSkinMesh) >> 2 );
             constructInPlace( (TSSkinMesh*)ret );
             mesh = (TSSkinMesh*)ret;
             break;
          }
          case DecalMeshType    :
          {
-            ret = tsalloc.allocShape32( sizeof(TSDecalMesh) >> 2 );
+            ret = alloc->allocShape32( sizeof(TSDecalMesh) >> 2 );
             constructInPlace((TSDecalMesh*)ret);
             decal = (TSDecalMesh*)ret;
             break;
          }
          case SortedMeshType   :
          {
-            ret = tsalloc.allocShape32( sizeof(TSSortedMesh) >> 2 );
+            ret = alloc->allocShape32( sizeof(TSSortedMesh) >> 2 );
             constructInPlace( (TSSortedMesh*)ret );
             mesh = (TSSortedMesh*)ret;
             break;
@@ -1936,15 +2019,15 @@ TSMesh* TSMesh::assembleMesh( U32 meshType, bool skip )
       }
    }
 
-   tsalloc.setSkipMode( skip );
+   alloc->setSkipMode( skip );
 
    if ( mesh )
-      mesh->assemble( skip );
+      mesh->assemble( alloc, skip );
 
    if ( decal )
-      decal->assemble( skip );
+      decal->assemble( alloc, skip );
 
-   tsalloc.setSkipMode( false );
+   alloc->setSkipMode( false );
 
    return (TSMesh*)ret;
 }
@@ -2325,20 +2408,20 @@ void TSMesh::leaveAsMultipleStrips(	const TSDrawPrimitive *primitivesIn,
 // that pointer (in the case that we don't skip this mesh).
 // If we do have a parent mesh, then we return a pointer to the data in the shape buffer,
 // copying the data in there ourselves if our parent didn't already do it (i.e., if it was skipped).
-S32 * TSMesh::getSharedData32( S32 parentMesh, S32 size, S32 **source, bool skip )
+S32 * TSMesh::getSharedData32( TSShapeAlloc* alloc, S32 parentMesh, S32 size, S32 **source, bool skip )
 {
    S32 * ptr;
    if( parentMesh < 0 )
-      ptr = skip ? tsalloc.getPointer32( size ) : tsalloc.copyToShape32( size );
+      ptr = skip ? alloc->getPointer32( size ) : alloc->copyToShape32( size );
    else
    {
       ptr = source[parentMesh];
       // if we skipped the previous mesh (and we're not skipping this one) then
       // we still need to copy points into the shape...
-      if ( !smDataCopied[parentMesh] && !skip )
+      if ( !alloc->mDataCopied[parentMesh] && !skip )
       {
          S32 * tmp = ptr;
-         ptr = tsalloc.allocShape32( size );
+         ptr = alloc->allocShape32( size );
          if ( ptr && tmp )
             dMemcpy(ptr, tmp, size * sizeof(S32) );
       } 
@@ -2346,20 +2429,20 @@ S32 * TSMesh::getSharedData32( S32 parentMesh, S32 size, S32 **source, bool skip
    return ptr;
 }
 
-S8 * TSMesh::getSharedData8( S32 parentMesh, S32 size, S8 **source, bool skip )
+S8 * TSMesh::getSharedData8( TSShapeAlloc* alloc, S32 parentMesh, S32 size, S8 **source, bool skip )
 {
    S8 * ptr;
    if( parentMesh < 0 )
-      ptr = skip ? tsalloc.getPointer8( size ) : tsalloc.copyToShape8( size );
+      ptr = skip ? alloc->getPointer8( size ) : alloc->copyToShape8( size );
    else
    {
       ptr = source[parentMesh];
       // if we skipped the previous mesh (and we're not skipping this one) then
       // we still need to copy points into the shape...
-      if ( !smDataCopied[parentMesh] && !skip )
+      if ( !alloc->mDataCopied[parentMesh] && !skip )
       {
          S8 * tmp = ptr;
-         ptr = tsalloc.allocShape8( size );
+         ptr = alloc->allocShape8( size );
          if ( ptr && tmp )
             dMemcpy( ptr, tmp, size * sizeof(S32) );
       }
@@ -2413,23 +2496,23 @@ void TSMesh::dumpPrimitives(U32 startVertex, U32 startIndex, GFXPrimitive *piArr
    dCopyArray(ibIndices, indices.address(), indices.size());
 }
 
-void TSMesh::assemble( bool skip )
+void TSMesh::assemble( TSShapeAlloc* alloc, bool skip )
 {
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
-   numFrames = tsalloc.get32();
-   numMatFrames = tsalloc.get32();
-   parentMesh = tsalloc.get32();
-   tsalloc.get32( (S32*)&mBounds, 6 );
-   tsalloc.get32( (S32*)&mCenter, 3 );
-   mRadius = (F32)tsalloc.get32();
+   numFrames = alloc->get32();
+   numMatFrames = alloc->get32();
+   parentMesh = alloc->get32();
+   alloc->get32( (S32*)&mBounds, 6 );
+   alloc->get32( (S32*)&mCenter, 3 );
+   mRadius = (F32)alloc->get32();
 
-   if (TSShape::smReadVersion >= 27)
+   if (alloc->getVersion() >= 27)
    {
       // Offsetted
-      mVertOffset = tsalloc.get32();
-      mNumVerts = tsalloc.get32();
-      mVertSize = tsalloc.get32();
+      mVertOffset = alloc->get32();
+      mNumVerts = alloc->get32();
+      mVertSize = alloc->get32();
    }
    else
    {
@@ -2438,50 +2521,50 @@ void TSMesh::assemble( bool skip )
       mVertSize = 0;
    }
 
-   S32 numVerts = tsalloc.get32();
-   S32 *ptr32 = getSharedData32( parentMesh, 3 * numVerts, (S32**)smVertsList.address(), skip );
+   S32 numVerts = alloc->get32();
+   S32 *ptr32 = getSharedData32( alloc, parentMesh, 3 * numVerts, (S32**)alloc->mVertsList.address(), skip );
    verts.set( (Point3F*)ptr32, numVerts );
 
-   S32 numTVerts = tsalloc.get32();
-   ptr32 = getSharedData32( parentMesh, 2 * numTVerts, (S32**)smTVertsList.address(), skip );
+   S32 numTVerts = alloc->get32();
+   ptr32 = getSharedData32( alloc, parentMesh, 2 * numTVerts, (S32**)alloc->mTVertsList.address(), skip );
    tverts.set( (Point2F*)ptr32, numTVerts );
 
-   if ( TSShape::smReadVersion > 25 )
+   if ( alloc->getVersion() > 25 )
    {
-      numTVerts = tsalloc.get32();
-      ptr32 = getSharedData32( parentMesh, 2 * numTVerts, (S32**)smTVerts2List.address(), skip );
+      numTVerts = alloc->get32();
+      ptr32 = getSharedData32( alloc, parentMesh, 2 * numTVerts, (S32**)alloc->mTVerts2List.address(), skip );
       tverts2.set( (Point2F*)ptr32, numTVerts );
 
-      S32 numVColors = tsalloc.get32();
-      ptr32 = getSharedData32( parentMesh, numVColors, (S32**)smColorsList.address(), skip );
+      S32 numVColors = alloc->get32();
+      ptr32 = getSharedData32( alloc, parentMesh, numVColors, (S32**)alloc->mColorsList.address(), skip );
       colors.set( (ColorI*)ptr32, numVColors );
    }
 
    S8 *ptr8;
-   if ( TSShape::smReadVersion > 21 && TSMesh::smUseEncodedNormals)
+   if ( alloc->getVersion() > 21 && TSMesh::smUseEncodedNormals)
    {
       // we have encoded normals and we want to use them...
       if ( parentMesh < 0 )
-         tsalloc.getPointer32( numVerts * 3 ); // adva  nce past norms, don't use
+         alloc->getPointer32( numVerts * 3 ); // adva  nce past norms, don't use
       norms.set( NULL, 0 );
 
-      ptr8 = getSharedData8( parentMesh, numVerts, (S8**)smEncodedNormsList.address(), skip );
+      ptr8 = getSharedData8( alloc, parentMesh, numVerts, (S8**)alloc->mEncodedNormsList.address(), skip );
       encodedNorms.set( ptr8, numVerts );
    }
-   else if ( TSShape::smReadVersion > 21 )
+   else if ( alloc->getVersion() > 21 )
    {
       // we have encoded normals but we don't want to use them...
-      ptr32 = getSharedData32( parentMesh, 3 * numVerts, (S32**)smNormsList.address(), skip );
+      ptr32 = getSharedData32( alloc, parentMesh, 3 * numVerts, (S32**)alloc->mNormsList.address(), skip );
       norms.set( (Point3F*)ptr32, numVerts );
 
       if ( parentMesh < 0 )
-         tsalloc.getPointer8( numVerts ); // advance past encoded normls, don't use
+         alloc->getPointer8( numVerts ); // advance past encoded normls, don't use
       encodedNorms.set( NULL, 0 );
    }
    else
    {
       // no encoded normals...
-      ptr32 = getSharedData32( parentMesh, 3 * numVerts, (S32**)smNormsList.address(), skip );
+      ptr32 = getSharedData32( alloc, parentMesh, 3 * numVerts, (S32**)alloc->mNormsList.address(), skip );
       norms.set( (Point3F*)ptr32, numVerts );
       encodedNorms.set( NULL, 0 );
    }
@@ -2493,21 +2576,21 @@ void TSMesh::assemble( bool skip )
    S32 *indIn;
    bool deleteInputArrays = false;
 
-   if (TSShape::smReadVersion > 25)
+   if (alloc->getVersion() > 25)
    {
       // mesh primitives (start, numElements) and indices are stored as 32 bit values
-      szPrimIn = tsalloc.get32();
-      primIn = (TSDrawPrimitive*)tsalloc.getPointer32(szPrimIn*3);
-      szIndIn = tsalloc.get32();
-      indIn = tsalloc.getPointer32(szIndIn);
+      szPrimIn = alloc->get32();
+      primIn = (TSDrawPrimitive*)alloc->getPointer32(szPrimIn*3);
+      szIndIn = alloc->get32();
+      indIn = alloc->getPointer32(szIndIn);
    }
    else
    {
       // mesh primitives (start, numElements) indices are stored as 16 bit values
-      szPrimIn = tsalloc.get32();
-      S16 *prim16 = tsalloc.getPointer16(szPrimIn*2);   // primitive: start, numElements
-      S32 *prim32 = tsalloc.getPointer32(szPrimIn);     // primitive: matIndex
-      szIndIn = tsalloc.get32();
+      szPrimIn = alloc->get32();
+      S16 *prim16 = alloc->getPointer16(szPrimIn*2);   // primitive: start, numElements
+      S32 *prim32 = alloc->getPointer32(szPrimIn);     // primitive: matIndex
+      szIndIn = alloc->get32();
 
       // warn about non-addressable indices
       if ( !skip && szIndIn >= 0x10000 )
@@ -2517,7 +2600,7 @@ void TSMesh::assemble( bool skip )
             "unique verts prior to export, or use COLLADA.");
       }
 
-      S16 *ind16 = tsalloc.getPointer16(szIndIn);
+      S16 *ind16 = alloc->getPointer16(szIndIn);
 
       // need to copy to temporary arrays
       deleteInputArrays = true;
@@ -2543,8 +2626,8 @@ void TSMesh::assemble( bool skip )
       leaveAsMultipleStrips(primIn, indIn, szPrimIn, szPrimOut, szIndOut, NULL, NULL);
 
    // allocate enough space for the new primitives and indices (all 32 bits)
-   TSDrawPrimitive *primOut = (TSDrawPrimitive*)tsalloc.allocShape32(3*szPrimOut);
-   S32 *indOut = tsalloc.allocShape32(szIndOut);
+   TSDrawPrimitive *primOut = (TSDrawPrimitive*)alloc->allocShape32(3*szPrimOut);
+   S32 *indOut = alloc->allocShape32(szIndOut);
 
    // copy output primitives and indices
    S32 chkPrim = szPrimOut, chkInd = szIndOut;
@@ -2567,45 +2650,45 @@ void TSMesh::assemble( bool skip )
       delete [] indIn;
    }
 
-   S32 sz = tsalloc.get32();
-   tsalloc.getPointer16( sz ); // skip deprecated merge indices
-   tsalloc.align32();
+   S32 sz = alloc->get32();
+   alloc->getPointer16( sz ); // skip deprecated merge indices
+   alloc->align32();
 
-   vertsPerFrame = tsalloc.get32();
-   U32 flags = (U32)tsalloc.get32();
+   vertsPerFrame = alloc->get32();
+   U32 flags = (U32)alloc->get32();
    if ( encodedNorms.size() )
       flags |= UseEncodedNormals;
    
    setFlags( flags );
 
    // Set color & tvert2 flags if we have an old version
-   if (TSShape::smReadVersion < 27)
+   if (alloc->getVersion() < 27)
    {
       if (colors.size() > 0) setFlags(HasColor);
       if (tverts2.size() > 0) setFlags(HasTVert2);
       mNumVerts = verts.size();
    }
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
-   if ( tsalloc.allocShape32( 0 ) && TSShape::smReadVersion < 19 )
+   if ( alloc->allocShape32( 0 ) && alloc->getVersion() < 19 )
       computeBounds(); // only do this if we copied the data...
 
    createTangents(verts, norms);
 }
 
-void TSMesh::disassemble()
+void TSMesh::disassemble( TSShapeAlloc* alloc )
 {
-   tsalloc.setGuard();
+   alloc->setGuard();
 
-   tsalloc.set32( numFrames );
-   tsalloc.set32( numMatFrames );
-   tsalloc.set32( parentMesh );
-   tsalloc.copyToBuffer32( (S32*)&mBounds, 6 );
-   tsalloc.copyToBuffer32( (S32*)&mCenter, 3 );
-   tsalloc.set32( (S32)mRadius );
+   alloc->set32( numFrames );
+   alloc->set32( numMatFrames );
+   alloc->set32( parentMesh );
+   alloc->copyToBuffer32( (S32*)&mBounds, 6 );
+   alloc->copyToBuffer32( (S32*)&mCenter, 3 );
+   alloc->set32( (S32)mRadius );
 
-   bool shouldMakeEditable = TSShape::smVersion < 27 || mVertSize == 0;
+   bool shouldMakeEditable = alloc->getVersion() < 27 || mVertSize == 0;
 
    // Re-create the vectors
    if (shouldMakeEditable)
@@ -2613,58 +2696,58 @@ void TSMesh::disassemble()
       makeEditable();
 
       // No Offset
-      if (TSShape::smVersion >= 27)
+      if (alloc->getVersion() >= 27)
       {
-         tsalloc.set32(0);
-         tsalloc.set32(0);
-         tsalloc.set32(0);
+         alloc->set32(0);
+         alloc->set32(0);
+         alloc->set32(0);
       }
    }
    else
    {
       // Offsetted
-      tsalloc.set32(mVertOffset);
-      tsalloc.set32(mNumVerts);
-      tsalloc.set32(mVertSize);
+      alloc->set32(mVertOffset);
+      alloc->set32(mNumVerts);
+      alloc->set32(mVertSize);
       AssertFatal(mNumVerts >= vertsPerFrame, "invalid mNumVerts");
    }
 
-   if (TSShape::smVersion >= 27 && mVertexData.isReady())
+   if (alloc->getVersion() >= 27 && mVertexData.isReady())
    {
       // If not editable  all arrays are effectively 0.
-      tsalloc.set32(0); // verts
-      tsalloc.set32(0); // tverts
-      tsalloc.set32(0); // tverts2
-      tsalloc.set32(0); // colors
+      alloc->set32(0); // verts
+      alloc->set32(0); // tverts
+      alloc->set32(0); // tverts2
+      alloc->set32(0); // colors
    }
    else
    {
       // verts...
-      tsalloc.set32(verts.size());
+      alloc->set32(verts.size());
       if (parentMesh < 0)
-         tsalloc.copyToBuffer32((S32*)verts.address(), 3 * verts.size()); // if no parent mesh, then save off our verts
+         alloc->copyToBuffer32((S32*)verts.address(), 3 * verts.size()); // if no parent mesh, then save off our verts
 
       // tverts...
-      tsalloc.set32(tverts.size());
+      alloc->set32(tverts.size());
       if (parentMesh < 0)
-         tsalloc.copyToBuffer32((S32*)tverts.address(), 2 * tverts.size()); // if no parent mesh, then save off our tverts
+         alloc->copyToBuffer32((S32*)tverts.address(), 2 * tverts.size()); // if no parent mesh, then save off our tverts
 
-      if (TSShape::smVersion > 25)
+      if (alloc->getVersion() > 25)
       {
          // tverts2...
-         tsalloc.set32(tverts2.size());
+         alloc->set32(tverts2.size());
          if (parentMesh < 0)
-            tsalloc.copyToBuffer32((S32*)tverts2.address(), 2 * tverts2.size()); // if no parent mesh, then save off our tverts
+            alloc->copyToBuffer32((S32*)tverts2.address(), 2 * tverts2.size()); // if no parent mesh, then save off our tverts
 
                                                                                  // colors
-         tsalloc.set32(colors.size());
+         alloc->set32(colors.size());
          if (parentMesh < 0)
-            tsalloc.copyToBuffer32((S32*)colors.address(), colors.size()); // if no parent mesh, then save off our tverts
+            alloc->copyToBuffer32((S32*)colors.address(), colors.size()); // if no parent mesh, then save off our tverts
       }
 
       // norms...
       if (parentMesh < 0) // if no parent mesh, then save off our norms
-         tsalloc.copyToBuffer32((S32*)norms.address(), 3 * norms.size()); // norms.size()==verts.size() or error...
+         alloc->copyToBuffer32((S32*)norms.address(), 3 * norms.size()); // norms.size()==verts.size() or error...
 
                                                                           // encoded norms...
       if (parentMesh < 0)
@@ -2673,7 +2756,7 @@ void TSMesh::disassemble()
          for (S32 i = 0; i < norms.size(); i++)
          {
             U8 normIdx = encodedNorms.size() ? encodedNorms[i] : encodeNormal(norms[i]);
-            tsalloc.copyToBuffer8((S8*)&normIdx, 1);
+            alloc->copyToBuffer8((S8*)&normIdx, 1);
          }
       }
    }
@@ -2696,61 +2779,61 @@ void TSMesh::disassemble()
       }
    }
 
-   if (TSShape::smVersion > 25)
+   if (alloc->getVersion() > 25)
    {
       // primitives...
-      tsalloc.set32( primitives.size() );
-      tsalloc.copyToBuffer32((S32*)primitives.address(),3*primitives.size());
+      alloc->set32( primitives.size() );
+      alloc->copyToBuffer32((S32*)primitives.address(),3*primitives.size());
 
       // indices...
-      tsalloc.set32(indices.size());
-      tsalloc.copyToBuffer32((S32*)indices.address(),indices.size());
+      alloc->set32(indices.size());
+      alloc->copyToBuffer32((S32*)indices.address(),indices.size());
    }
    else
    {
       // primitives
-      tsalloc.set32( primitives.size() );
+      alloc->set32( primitives.size() );
       for (S32 i=0; i<primitives.size(); i++)
       {
          S16 start = (S16)primitives[i].start;
          S16 numElements = (S16)primitives[i].numElements;
 
-         tsalloc.copyToBuffer16(&start, 1);
-         tsalloc.copyToBuffer16(&numElements, 1);
-         tsalloc.copyToBuffer32(&(primitives[i].matIndex), 1);
+         alloc->copyToBuffer16(&start, 1);
+         alloc->copyToBuffer16(&numElements, 1);
+         alloc->copyToBuffer32(&(primitives[i].matIndex), 1);
       }
 
       // indices
-      tsalloc.set32(indices.size());
+      alloc->set32(indices.size());
       Vector<S16> s16_indices(indices.size());
       for (S32 i=0; i<indices.size(); i++)
          s16_indices.push_back((S16)indices[i]);
-      tsalloc.copyToBuffer16(s16_indices.address(), s16_indices.size());
+      alloc->copyToBuffer16(s16_indices.address(), s16_indices.size());
    }
 
    // merge indices...DEPRECATED
-   tsalloc.set32( 0 );
+   alloc->set32( 0 );
 
    // small stuff...
-   tsalloc.set32( vertsPerFrame );
-   tsalloc.set32( getFlags() );
+   alloc->set32( vertsPerFrame );
+   alloc->set32( getFlags() );
 
-   tsalloc.setGuard();
+   alloc->setGuard();
 }
 
 //-----------------------------------------------------------------------------
 // TSSkinMesh assemble from/ dissemble to memory buffer
 //-----------------------------------------------------------------------------
-void TSSkinMesh::assemble( bool skip )
+void TSSkinMesh::assemble( TSShapeAlloc* alloc, bool skip )
 {
    // avoid a crash on computeBounds...
    batchData.initialVerts.set( NULL, 0 );
 
-   TSMesh::assemble( skip );
+   TSMesh::assemble( alloc, skip );
 
-   if (TSShape::smReadVersion >= 27)
+   if (alloc->getVersion() >= 27)
    {
-      maxBones = tsalloc.get32();
+      maxBones = alloc->get32();
    }
    else
    {
@@ -2760,41 +2843,41 @@ void TSSkinMesh::assemble( bool skip )
    S32 sz;
    S32 * ptr32;
 
-   if (TSShape::smReadVersion < 27)
+   if (alloc->getVersion() < 27)
    {
-      sz = tsalloc.get32();
+      sz = alloc->get32();
       S32 numVerts = sz;
-      ptr32 = getSharedData32(parentMesh, 3 * numVerts, (S32**)smVertsList.address(), skip);
+      ptr32 = getSharedData32( alloc, parentMesh, 3 * numVerts, (S32**)alloc->mVertsList.address(), skip);
       batchData.initialVerts.set((Point3F*)ptr32, sz);
 
       S8 * ptr8;
-      if (TSShape::smReadVersion > 21 && TSMesh::smUseEncodedNormals)
+      if (alloc->getVersion() > 21 && TSMesh::smUseEncodedNormals)
       {
          // we have encoded normals and we want to use them...
          if (parentMesh < 0)
-            tsalloc.getPointer32(numVerts * 3); // advance past norms, don't use
+            alloc->getPointer32(numVerts * 3); // advance past norms, don't use
          batchData.initialNorms.set(NULL, 0);
 
-         ptr8 = getSharedData8(parentMesh, numVerts, (S8**)smEncodedNormsList.address(), skip);
+         ptr8 = getSharedData8( alloc, parentMesh, numVerts, (S8**)alloc->mEncodedNormsList.address(), skip);
          encodedNorms.set(ptr8, numVerts);
          // Note: we don't set the encoded normals flag because we handle them in updateSkin and
          //       hide the fact that we are using them from base class (TSMesh)
       }
-      else if (TSShape::smReadVersion > 21)
+      else if (alloc->getVersion() > 21)
       {
          // we have encoded normals but we don't want to use them...
-         ptr32 = getSharedData32(parentMesh, 3 * numVerts, (S32**)smNormsList.address(), skip);
+         ptr32 = getSharedData32( alloc, parentMesh, 3 * numVerts, (S32**)alloc->mNormsList.address(), skip);
          batchData.initialNorms.set((Point3F*)ptr32, numVerts);
 
          if (parentMesh < 0)
-            tsalloc.getPointer8(numVerts); // advance past encoded normls, don't use
+            alloc->getPointer8(numVerts); // advance past encoded normls, don't use
 
          encodedNorms.set(NULL, 0);
       }
       else
       {
          // no encoded normals...
-         ptr32 = getSharedData32(parentMesh, 3 * numVerts, (S32**)smNormsList.address(), skip);
+         ptr32 = getSharedData32( alloc, parentMesh, 3 * numVerts, (S32**)alloc->mNormsList.address(), skip);
          batchData.initialNorms.set((Point3F*)ptr32, numVerts);
          encodedNorms.set(NULL, 0);
       }
@@ -2818,25 +2901,25 @@ void TSSkinMesh::assemble( bool skip )
       batchData.initialNorms = norms;
    }
 
-   sz = tsalloc.get32();
-   ptr32 = getSharedData32( parentMesh, 16 * sz, (S32**)smInitTransformList.address(), skip );
+   sz = alloc->get32();
+   ptr32 = getSharedData32( alloc, parentMesh, 16 * sz, (S32**)alloc->mInitTransformList.address(), skip );
    batchData.initialTransforms.set( ptr32, sz );
 
-   sz = tsalloc.get32();
-   ptr32 = getSharedData32( parentMesh, sz, (S32**)smVertexIndexList.address(), skip );
+   sz = alloc->get32();
+   ptr32 = getSharedData32( alloc, parentMesh, sz, (S32**)alloc->mVertexIndexList.address(), skip );
    vertexIndex.set( ptr32, sz );
 
-   ptr32 = getSharedData32( parentMesh, sz, (S32**)smBoneIndexList.address(), skip );
+   ptr32 = getSharedData32( alloc, parentMesh, sz, (S32**)alloc->mBoneIndexList.address(), skip );
    boneIndex.set( ptr32, sz );
 
-   ptr32 = getSharedData32( parentMesh, sz, (S32**)smWeightList.address(), skip );
+   ptr32 = getSharedData32( alloc, parentMesh, sz, (S32**)alloc->mWeightList.address(), skip );
    weight.set( (F32*)ptr32, sz );
 
-   sz = tsalloc.get32();
-   ptr32 = getSharedData32( parentMesh, sz, (S32**)smNodeIndexList.address(), skip );
+   sz = alloc->get32();
+   ptr32 = getSharedData32( alloc, parentMesh, sz, (S32**)alloc->mNodeIndexList.address(), skip );
    batchData.nodeIndex.set( ptr32, sz );
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
    if (smDebugSkinVerts && ptr32 != NULL)
    {
@@ -2866,79 +2949,79 @@ void TSSkinMesh::assemble( bool skip )
       Con::printf("---");
    }
 
-   if ( tsalloc.allocShape32( 0 ) && TSShape::smReadVersion < 19 )
+   if ( alloc->allocShape32( 0 ) && alloc->getVersion() < 19 )
       TSMesh::computeBounds(); // only do this if we copied the data...c
 }
 
 //-----------------------------------------------------------------------------
 // disassemble
 //-----------------------------------------------------------------------------
-void TSSkinMesh::disassemble()
+void TSSkinMesh::disassemble( TSShapeAlloc* alloc )
 {
-   TSMesh::disassemble();
+   TSMesh::disassemble( alloc );
 
-   if (TSShape::smVersion >= 27)
+   if (alloc->getVersion() >= 27)
    {
       AssertFatal(maxBones != 0, "Skin mesh with no bones? No way!");
-      tsalloc.set32(maxBones);
+      alloc->set32(maxBones);
    }
 
-   if (TSShape::smVersion < 27)
+   if (alloc->getVersion() < 27)
    {
-      tsalloc.set32(batchData.initialVerts.size());
+      alloc->set32(batchData.initialVerts.size());
       // if we have no parent mesh, then save off our verts & norms
       if (parentMesh < 0)
       {
-         tsalloc.copyToBuffer32((S32*)verts.address(), 3 * verts.size());
+         alloc->copyToBuffer32((S32*)verts.address(), 3 * verts.size());
 
          // no longer do this here...let tsmesh handle this
-         tsalloc.copyToBuffer32((S32*)norms.address(), 3 * norms.size());
+         alloc->copyToBuffer32((S32*)norms.address(), 3 * norms.size());
 
          // if no parent mesh, compute encoded normals and copy over
          for (S32 i = 0; i < norms.size(); i++)
          {
             U8 normIdx = encodedNorms.size() ? encodedNorms[i] : encodeNormal(norms[i]);
-            tsalloc.copyToBuffer8((S8*)&normIdx, 1);
+            alloc->copyToBuffer8((S8*)&normIdx, 1);
          }
       }
    }
 
-   tsalloc.set32( batchData.initialTransforms.size() );
+   alloc->set32( batchData.initialTransforms.size() );
    if ( parentMesh < 0 )
-      tsalloc.copyToBuffer32( (S32*)batchData.initialTransforms.address(), batchData.initialTransforms.size() * 16 );
+      alloc->copyToBuffer32( (S32*)batchData.initialTransforms.address(), batchData.initialTransforms.size() * 16 );
 
    if (!mVertexData.isReady())
    {
-      tsalloc.set32(vertexIndex.size());
+      alloc->set32(vertexIndex.size());
 
-      tsalloc.copyToBuffer32((S32*)vertexIndex.address(), vertexIndex.size());
+      alloc->copyToBuffer32((S32*)vertexIndex.address(), vertexIndex.size());
 
-      tsalloc.copyToBuffer32((S32*)boneIndex.address(), boneIndex.size());
+      alloc->copyToBuffer32((S32*)boneIndex.address(), boneIndex.size());
 
-      tsalloc.copyToBuffer32((S32*)weight.address(), weight.size());
+      alloc->copyToBuffer32((S32*)weight.address(), weight.size());
    }
    else
    {
-      tsalloc.set32(0);
+      alloc->set32(0);
    }
 
-   if (TSShape::smVersion < 27)
+   if (alloc->getVersion() < 27)
    {
       if (parentMesh < 0)
       {
-         tsalloc.copyToBuffer32((S32*)vertexIndex.address(), vertexIndex.size());
+         alloc->copyToBuffer32((S32*)vertexIndex.address(), vertexIndex.size());
 
-         tsalloc.copyToBuffer32((S32*)boneIndex.address(), boneIndex.size());
+         alloc->copyToBuffer32((S32*)boneIndex.address(), boneIndex.size());
 
-         tsalloc.copyToBuffer32((S32*)weight.address(), weight.size());
+         alloc->copyToBuffer32((S32*)weight.address(), weight.size());
       }
    }
 
-   tsalloc.set32( batchData.nodeIndex.size() );
+   alloc->set32( batchData.nodeIndex.size() );
    if ( parentMesh < 0 )
-      tsalloc.copyToBuffer32( (S32*)batchData.nodeIndex.address(), batchData.nodeIndex.size() );
+      alloc->copyToBuffer32( (S32*)batchData.nodeIndex.address(), batchData.nodeIndex.size() );
 
-   tsalloc.setGuard();
+   alloc->setGuard();
 }
 
 TSSkinMesh::TSSkinMesh()
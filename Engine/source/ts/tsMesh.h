@@ -417,9 +417,9 @@ protected:
    virtual U32 getMaxBonesPerVert() { return 0; }
 
    /// persist methods...
-   virtual void assemble( bool skip );
-   static TSMesh* assembleMesh( U32 meshType, bool skip );
-   virtual void disassemble();
+   virtual void assemble( TSShapeAlloc* alloc, bool skip );
+   static TSMesh* assembleMesh( TSShapeAlloc* alloc, U32 meshType, bool skip );
+   virtual void disassemble( TSShapeAlloc* alloc );
 
    void createTangents(const Vector<Point3F> &_verts, const Vector<Point3F> &_norms);
    void findTangent( U32 index1, 
@@ -463,30 +463,10 @@ protected:
 
    /// methods used during assembly to share vertexand other info
    /// between meshes (and for skipping detail levels on load)
-   S32* getSharedData32( S32 parentMesh, S32 size, S32 **source, bool skip );
-   S8* getSharedData8( S32 parentMesh, S32 size, S8  **source, bool skip );
-
-   /// @name Assembly Variables
-   /// variables used during assembly (for skipping mesh detail levels
-   /// on load and for sharing verts between meshes)
-   /// @{
-
-   static Vector<Point3F*> smVertsList;
-   static Vector<Point3F*> smNormsList;
-   static Vector<U8*>      smEncodedNormsList;
-   
-   static Vector<Point2F*> smTVertsList;
-
-   // Optional second texture uvs.
-   static Vector<Point2F*> smTVerts2List;
-
-   // Optional vertex colors.
-   static Vector<ColorI*> smColorsList;
-
-   static Vector<bool>     smDataCopied;
+   S32* getSharedData32( TSShapeAlloc* alloc, S32 parentMesh, S32 size, S32 **source, bool skip );
+   S8* getSharedData8( TSShapeAlloc* alloc, S32 parentMesh, S32 size, S8  **source, bool skip );
 
    static const Point3F smU8ToNormalTable[];
-   /// @}
 
 
    TSMesh();
@@ -544,6 +524,17 @@ public:
       Vector<BatchedVertex> vertexBatchOperations;
       /// @}
 
+      /// @name Batch by vertex, structure of arrays
+      /// vertexBatchOperations flattened for the skinning kernels.  Entry i
+      /// writes vertex skinVertexIndex[i] from the influences
+      /// skinInfluenceStart[i] up to skinInfluenceStart[i+1].
+      /// @{
+      Vector<S32> skinVertexIndex;
+      Vector<U32> skinInfluenceStart;  ///< # = skinVertexIndex.size() + 1
+      Vector<U32> skinBoneIndex;
+      Vector<F32> skinWeight;
+      /// @}
+
       // # = num bones
       Vector<S32> nodeIndex;
       Vector<MatrixF> initialTransforms;
@@ -593,9 +584,33 @@ public:
    /// Structure containing data needed to batch skinning
    BatchData batchData;
 
+   /// A request to skin one mesh into a vertex buffer.
+   /// @see updateSkinBuffers
+   struct SkinJob
+   {
+      TSSkinMesh *mesh;
+      const Vector<MatrixF> *transforms;
+      U8 *buffer;
+   };
+
+   /// If true, large skinning batches are spread across the worker threads.
+   static bool smParallelSkinning;
+
+   /// The least number of skinned vertices in a batch before the work is
+   /// spread across the worker threads.
+   static S32 smMinParallelSkinVerts;
+
+   /// Number of vertices a worker skins at a time.
+   static const U32 csmSkinChunkSize = 1024;
+
    /// set verts and normals...
    void updateSkinBuffer( const Vector<MatrixF> &transforms, U8 *buffer );
 
+   /// Set verts and normals for several meshes at once.  The vertices of
+   /// all the jobs are split into chunks which are shared with the global
+   /// ThreadPool when the batch is big enough.
+   static void updateSkinBuffers( const SkinJob *jobs, U32 count );
+
    /// update bone transforms for this mesh
    void updateSkinBones( const Vector<MatrixF> &transforms, Vector<MatrixF>& destTransforms );
 
@@ -616,8 +631,8 @@ public:
    void computeBounds( const MatrixF &transform, Box3F &bounds, S32 frame, Point3F *center, F32 *radius );
 
    /// persist methods...
-   void assemble( bool skip );
-   void disassemble();
+   void assemble( TSShapeAlloc* alloc, bool skip );
+   void disassemble( TSShapeAlloc* alloc );
 
    /// Helper method to add a blend tuple for a vertex
    inline void addWeightForVert(U32 vi, U32 bi, F32 w)
@@ -627,14 +642,6 @@ public:
       vertexIndex.push_back(vi);
    }
 
-   /// variables used during assembly (for skipping mesh detail levels
-   /// on load and for sharing verts between meshes)
-   static Vector<MatrixF*> smInitTransformList;
-   static Vector<S32*>     smVertexIndexList;
-   static Vector<S32*>     smBoneIndexList;
-   static Vector<F32*>     smWeightList;
-   static Vector<S32*>     smNodeIndexList;
-
    static bool smDebugSkinVerts;
 
    TSSkinMesh();
@@ -26,6 +26,7 @@
 
 
 void (*zero_vert_normal_bulk)(const dsize_t count, U8 * __restrict const outPtr, const dsize_t outStride) = NULL;
+void (*skin_verts_bulk)(const TSSkinBatch &batch, const dsize_t start, const dsize_t count, U8 * __restrict const outPtr, const dsize_t outStride) = NULL;
 
 //------------------------------------------------------------------------------
 // Default C++ Implementations (pretty slow)
@@ -46,6 +47,37 @@ void zero_vert_normal_bulk_C(const dsize_t count, U8 * __restrict const outPtr,
    }
 }
 
+void skin_verts_bulk_C(const TSSkinBatch &batch, const dsize_t start, const dsize_t count, U8 * __restrict const outPtr, const dsize_t outStride)
+{
+   for(dsize_t i = start; i < start + count; i++)
+   {
+      const S32 vidx = batch.vertexIndex[i];
+      const F32 *inVert = batch.inVerts + vidx * 3;
+      const F32 *inNorm = batch.inNorms + vidx * 3;
+
+      Point3F skinnedVert(0.0f, 0.0f, 0.0f);
+      Point3F skinnedNorm(0.0f, 0.0f, 0.0f);
+
+      for(U32 j = batch.influenceStart[i]; j < batch.influenceStart[i + 1]; j++)
+      {
+         const F32 *c = batch.boneColumns + batch.boneIndex[j] * 16;
+         const F32 w = batch.weight[j];
+
+         skinnedVert.x += w * (c[0] * inVert[0] + c[4] * inVert[1] + c[8] * inVert[2] + c[12]);
+         skinnedVert.y += w * (c[1] * inVert[0] + c[5] * inVert[1] + c[9] * inVert[2] + c[13]);
+         skinnedVert.z += w * (c[2] * inVert[0] + c[6] * inVert[1] + c[10] * inVert[2] + c[14]);
+
+         skinnedNorm.x += w * (c[0] * inNorm[0] + c[4] * inNorm[1] + c[8] * inNorm[2]);
+         skinnedNorm.y += w * (c[1] * inNorm[0] + c[5] * inNorm[1] + c[9] * inNorm[2]);
+         skinnedNorm.z += w * (c[2] * inNorm[0] + c[6] * inNorm[1] + c[10] * inNorm[2]);
+      }
+
+      TSMesh::__TSMeshVertexBase *outElem = reinterpret_cast<TSMesh::__TSMeshVertexBase *>(outPtr + outStride * vidx);
+      outElem->_vert = skinnedVert;
+      outElem->_normal = skinnedNorm;
+   }
+}
+
 //------------------------------------------------------------------------------
 // Initializer.
 //------------------------------------------------------------------------------
@@ -58,6 +90,7 @@ MODULE_BEGIN( TSMeshIntrinsics )
    {
       // Assign defaults (C++ versions)
       zero_vert_normal_bulk = zero_vert_normal_bulk_C;
+      skin_verts_bulk = skin_verts_bulk_C;
 
    #if defined(TORQUE_OS_XENON)
       zero_vert_normal_bulk = zero_vert_normal_bulk_X360;
@@ -68,6 +101,7 @@ MODULE_BEGIN( TSMeshIntrinsics )
    #if (defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 )) 
          
          zero_vert_normal_bulk = zero_vert_normal_bulk_SSE;
+         skin_verts_bulk = skin_verts_bulk_SSE;
    #endif
       }
       else if(Platform::SystemInfo.processor.properties & CPU_PROP_ALTIVEC)
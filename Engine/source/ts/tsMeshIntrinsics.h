@@ -33,5 +33,37 @@ extern void (*zero_vert_normal_bulk)
                            U8 * __restrict const outPtr, 
                            const dsize_t outStride);
 
+/// Structure of arrays view of a skin mesh's batch data, as consumed
+/// by skin_verts_bulk.
+struct TSSkinBatch
+{
+   /// 16 floats per bone: the four columns of the bone transform, each
+   /// padded to four floats.  Must be 16 byte aligned.
+   const F32 *boneColumns;
+
+   const S32 *vertexIndex;       ///< Output vertex of each entry
+   const U32 *influenceStart;    ///< First influence of each entry, plus one past the end
+   const U32 *boneIndex;         ///< Bone of each influence
+   const F32 *weight;            ///< Weight of each influence
+
+   const F32 *inVerts;           ///< Bind pose positions, 3 floats per vertex
+   const F32 *inNorms;           ///< Bind pose normals, 3 floats per vertex
+};
+
+/// Skin the position and normal of a run of batch entries.  Only the
+/// xyz components of the position and normal are written.
+///
+/// @param batch     Batch data to skin
+/// @param start     First batch entry
+/// @param count     Number of batch entries
+/// @param outPtr    Pointer to a TSMesh aligned vertex buffer
+/// @param outStride Size, in bytes, of one entry in the vertex buffer
+extern void (*skin_verts_bulk)
+                          (const TSSkinBatch &batch,
+                           const dsize_t start,
+                           const dsize_t count,
+                           U8 * __restrict const outPtr,
+                           const dsize_t outStride);
+
 #endif
 
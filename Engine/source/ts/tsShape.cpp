@@ -44,7 +44,6 @@ extern TSShape* loadColladaShape(const Torque::Path &path);
 /// most recent version -- this is the version we write
 S32 TSShape::smVersion = 28;
 /// the version currently being read...valid only during a read
-S32 TSShape::smReadVersion = -1;
 const U32 TSShape::smMostRecentExporterVersion = DTS_EXPORTER_CURRENT_VERSION;
 
 F32 TSShape::smAlphaOutLastDetail = -1.0f;
@@ -1101,10 +1100,6 @@ void TSShape::computeBounds(S32 dl, Box3F & bounds) const
    }
 }
 
-TSShapeAlloc TSShape::smTSAlloc;
-
-#define tsalloc TSShape::smTSAlloc
-
 
 // messy stuff: check to see if we should "skip" meshNum
 // this assumes that meshes for a given object are in a row
@@ -1146,155 +1141,155 @@ bool TSShape::checkSkip(S32 meshNum, S32 & curObject, S32 skipDL)
    return false;
 }
 
-void TSShape::assembleShape()
+void TSShape::assembleShape(TSShapeAlloc* alloc)
 {
    S32 i,j;
 
    // get counts...
-   S32 numNodes = tsalloc.get32();
-   S32 numObjects = tsalloc.get32();
-   S32 numDecals = tsalloc.get32();
-   S32 numSubShapes = tsalloc.get32();
-   S32 numIflMaterials = tsalloc.get32();
+   S32 numNodes = alloc->get32();
+   S32 numObjects = alloc->get32();
+   S32 numDecals = alloc->get32();
+   S32 numSubShapes = alloc->get32();
+   S32 numIflMaterials = alloc->get32();
    S32 numNodeRots;
    S32 numNodeTrans;
    S32 numNodeUniformScales;
    S32 numNodeAlignedScales;
    S32 numNodeArbitraryScales;
-   if (smReadVersion<22)
+   if (alloc->getVersion()<22)
    {
-      numNodeRots = numNodeTrans = tsalloc.get32() - numNodes;
+      numNodeRots = numNodeTrans = alloc->get32() - numNodes;
       numNodeUniformScales = numNodeAlignedScales = numNodeArbitraryScales = 0;
    }
    else
    {
-      numNodeRots = tsalloc.get32();
-      numNodeTrans = tsalloc.get32();
-      numNodeUniformScales = tsalloc.get32();
-      numNodeAlignedScales = tsalloc.get32();
-      numNodeArbitraryScales = tsalloc.get32();
+      numNodeRots = alloc->get32();
+      numNodeTrans = alloc->get32();
+      numNodeUniformScales = alloc->get32();
+      numNodeAlignedScales = alloc->get32();
+      numNodeArbitraryScales = alloc->get32();
    }
    S32 numGroundFrames = 0;
-   if (smReadVersion>23)
-      numGroundFrames = tsalloc.get32();
-   S32 numObjectStates = tsalloc.get32();
-   S32 numDecalStates = tsalloc.get32();
-   S32 numTriggers = tsalloc.get32();
-   S32 numDetails = tsalloc.get32();
-   S32 numMeshes = tsalloc.get32();
+   if (alloc->getVersion()>23)
+      numGroundFrames = alloc->get32();
+   S32 numObjectStates = alloc->get32();
+   S32 numDecalStates = alloc->get32();
+   S32 numTriggers = alloc->get32();
+   S32 numDetails = alloc->get32();
+   S32 numMeshes = alloc->get32();
    S32 numSkins = 0;
-   if (smReadVersion<23)
+   if (alloc->getVersion()<23)
       // in later versions, skins are kept with other meshes
-      numSkins = tsalloc.get32();
-   S32 numNames = tsalloc.get32();
+      numSkins = alloc->get32();
+   S32 numNames = alloc->get32();
 
    // Note that we are recalculating these values later on for safety.
-   mSmallestVisibleSize = (F32)tsalloc.get32();
-   mSmallestVisibleDL   = tsalloc.get32();
+   mSmallestVisibleSize = (F32)alloc->get32();
+   mSmallestVisibleDL   = alloc->get32();
    
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
    // get bounds...
-   tsalloc.get32((S32*)&radius,1);
-   tsalloc.get32((S32*)&tubeRadius,1);
-   tsalloc.get32((S32*)&center,3);
-   tsalloc.get32((S32*)&bounds,6);
+   alloc->get32((S32*)&radius,1);
+   alloc->get32((S32*)&tubeRadius,1);
+   alloc->get32((S32*)&center,3);
+   alloc->get32((S32*)&bounds,6);
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
    // copy various vectors...
-   S32 * ptr32 = tsalloc.copyToShape32(numNodes*5);
+   S32 * ptr32 = alloc->copyToShape32(numNodes*5);
    nodes.set(ptr32,numNodes);
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
-   ptr32 = tsalloc.copyToShape32(numObjects*6,true);
+   ptr32 = alloc->copyToShape32(numObjects*6,true);
    if (!ptr32)
-      ptr32 = tsalloc.allocShape32(numSkins*6); // pre v23 shapes store skins and meshes separately...no longer
+      ptr32 = alloc->allocShape32(numSkins*6); // pre v23 shapes store skins and meshes separately...no longer
    else
-      tsalloc.allocShape32(numSkins*6);
+      alloc->allocShape32(numSkins*6);
    objects.set(ptr32,numObjects);
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
    // DEPRECATED decals
-   ptr32 = tsalloc.getPointer32(numDecals*5);
+   ptr32 = alloc->getPointer32(numDecals*5);
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
    // DEPRECATED ifl materials
-   ptr32 = tsalloc.copyToShape32(numIflMaterials*5);
+   ptr32 = alloc->copyToShape32(numIflMaterials*5);
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
-   ptr32 = tsalloc.copyToShape32(numSubShapes,true);
+   ptr32 = alloc->copyToShape32(numSubShapes,true);
    subShapeFirstNode.set(ptr32,numSubShapes);
-   ptr32 = tsalloc.copyToShape32(numSubShapes,true);
+   ptr32 = alloc->copyToShape32(numSubShapes,true);
    subShapeFirstObject.set(ptr32,numSubShapes);
    // DEPRECATED subShapeFirstDecal
-   ptr32 = tsalloc.getPointer32(numSubShapes);
+   ptr32 = alloc->getPointer32(numSubShapes);
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
-   ptr32 = tsalloc.copyToShape32(numSubShapes);
+   ptr32 = alloc->copyToShape32(numSubShapes);
    subShapeNumNodes.set(ptr32,numSubShapes);
-   ptr32 = tsalloc.copyToShape32(numSubShapes);
+   ptr32 = alloc->copyToShape32(numSubShapes);
    subShapeNumObjects.set(ptr32,numSubShapes);
    // DEPRECATED subShapeNumDecals
-   ptr32 = tsalloc.getPointer32(numSubShapes);
+   ptr32 = alloc->getPointer32(numSubShapes);
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
-   ptr32 = tsalloc.allocShape32(numSubShapes);
+   ptr32 = alloc->allocShape32(numSubShapes);
    subShapeFirstTranslucentObject.set(ptr32,numSubShapes);
 
    // get default translation and rotation
-   S16 * ptr16 = tsalloc.allocShape16(0);
+   S16 * ptr16 = alloc->allocShape16(0);
    for (i=0;i<numNodes;i++)
-      tsalloc.copyToShape16(4);
+      alloc->copyToShape16(4);
    defaultRotations.set(ptr16,numNodes);
-   tsalloc.align32();
-   ptr32 = tsalloc.allocShape32(0);
+   alloc->align32();
+   ptr32 = alloc->allocShape32(0);
    for (i=0;i<numNodes;i++)
    {
-      tsalloc.copyToShape32(3);
-      tsalloc.copyToShape32(sizeof(Point3F)-12); // handle alignment issues w/ point3f
+      alloc->copyToShape32(3);
+      alloc->copyToShape32(sizeof(Point3F)-12); // handle alignment issues w/ point3f
    }
    defaultTranslations.set(ptr32,numNodes);
 
    // get any node sequence data stored in shape
    nodeTranslations.setSize(numNodeTrans);
    for (i=0;i<numNodeTrans;i++)
-      tsalloc.get32((S32*)&nodeTranslations[i],3);
+      alloc->get32((S32*)&nodeTranslations[i],3);
    nodeRotations.setSize(numNodeRots);
    for (i=0;i<numNodeRots;i++)
-      tsalloc.get16((S16*)&nodeRotations[i],4);
-   tsalloc.align32();
+      alloc->get16((S16*)&nodeRotations[i],4);
+   alloc->align32();
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
-   if (smReadVersion>21)
+   if (alloc->getVersion()>21)
    {
       // more node sequence data...scale
       nodeUniformScales.setSize(numNodeUniformScales);
       for (i=0;i<numNodeUniformScales;i++)
-         tsalloc.get32((S32*)&nodeUniformScales[i],1);
+         alloc->get32((S32*)&nodeUniformScales[i],1);
       nodeAlignedScales.setSize(numNodeAlignedScales);
       for (i=0;i<numNodeAlignedScales;i++)
-         tsalloc.get32((S32*)&nodeAlignedScales[i],3);
+         alloc->get32((S32*)&nodeAlignedScales[i],3);
       nodeArbitraryScaleFactors.setSize(numNodeArbitraryScales);
       for (i=0;i<numNodeArbitraryScales;i++)
-         tsalloc.get32((S32*)&nodeArbitraryScaleFactors[i],3);
+         alloc->get32((S32*)&nodeArbitraryScaleFactors[i],3);
       nodeArbitraryScaleRots.setSize(numNodeArbitraryScales);
       for (i=0;i<numNodeArbitraryScales;i++)
-         tsalloc.get16((S16*)&nodeArbitraryScaleRots[i],4);
-      tsalloc.align32();
+         alloc->get16((S16*)&nodeArbitraryScaleRots[i],4);
+      alloc->align32();
 
-      tsalloc.checkGuard();
+      alloc->checkGuard();
    }
 
    // old shapes need ground transforms moved to ground arrays...but only do it once
-   if (smReadVersion<22 && tsalloc.allocShape32(0))
+   if (alloc->getVersion()<22 && alloc->allocShape32(0))
    {
       for (i=0; i<sequences.size(); i++)
       {
@@ -1317,43 +1312,43 @@ void TSShape::assembleShape()
 
    // version 22 & 23 shapes accidentally had no ground transforms, and ground for
    // earlier shapes is handled just above, so...
-   if (smReadVersion>23)
+   if (alloc->getVersion()>23)
    {
       groundTranslations.setSize(numGroundFrames);
       for (i=0;i<numGroundFrames;i++)
-         tsalloc.get32((S32*)&groundTranslations[i],3);
+         alloc->get32((S32*)&groundTranslations[i],3);
       groundRotations.setSize(numGroundFrames);
       for (i=0;i<numGroundFrames;i++)
-         tsalloc.get16((S16*)&groundRotations[i],4);
-      tsalloc.align32();
+         alloc->get16((S16*)&groundRotations[i],4);
+      alloc->align32();
 
-      tsalloc.checkGuard();
+      alloc->checkGuard();
    }
 
    // object states
-   ptr32 = tsalloc.copyToShape32(numObjectStates*3);
+   ptr32 = alloc->copyToShape32(numObjectStates*3);
    objectStates.set(ptr32,numObjectStates);
-   tsalloc.allocShape32(numSkins*3); // provide buffer after objectStates for older shapes
+   alloc->allocShape32(numSkins*3); // provide buffer after objectStates for older shapes
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
    // DEPRECATED decal states
-   ptr32 = tsalloc.getPointer32(numDecalStates);
+   ptr32 = alloc->getPointer32(numDecalStates);
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
    // frame triggers
-   ptr32 = tsalloc.getPointer32(numTriggers*2);
+   ptr32 = alloc->getPointer32(numTriggers*2);
    triggers.setSize(numTriggers);
    dMemcpy(triggers.address(),ptr32,sizeof(S32)*numTriggers*2);
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
    // details
-   if ( smReadVersion >= 26 )
+   if ( alloc->getVersion() >= 26 )
    {
       U32 alignedSize32 = sizeof( Detail ) / 4;
-      ptr32 = tsalloc.copyToShape32( numDetails * alignedSize32, true );
+      ptr32 = alloc->copyToShape32( numDetails * alignedSize32, true );
       details.set( ptr32, numDetails );
    }
    else
@@ -1375,7 +1370,7 @@ void TSShape::assembleShape()
       // In the code below we're reading just these 7 values and
       // copying them to the new larger structure.
 
-      ptr32 = tsalloc.copyToShape32( numDetails * 7, true );
+      ptr32 = alloc->copyToShape32( numDetails * 7, true );
 
       details.setSize( numDetails );
       for ( U32 i = 0; i < details.size(); i++, ptr32 += 7 )
@@ -1427,25 +1422,25 @@ void TSShape::assembleShape()
       skipDL = 0;
 
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
-   if (TSShape::smReadVersion >= 27)
+   if (alloc->getVersion() >= 27)
    {
       // Vertex format is set here
       S8 *vboData = NULL;
       S32 vboSize = 0;
 
-      mBasicVertexFormat.readAlloc(&tsalloc);
+      mBasicVertexFormat.readAlloc(alloc);
       mVertexFormat.clear();
       mBasicVertexFormat.getFormat(mVertexFormat);
       mVertexSize = mVertexFormat.getSizeInBytes();
 
       AssertFatal(mVertexSize == mBasicVertexFormat.vertexSize, "vertex size mismatch");
 
-      vboSize = tsalloc.get32();
-      vboData = tsalloc.getPointer8(vboSize);
+      vboSize = alloc->get32();
+      vboData = alloc->getPointer8(vboSize);
 
-      if (tsalloc.getBuffer() && vboSize > 0)
+      if (alloc->getBuffer() && vboSize > 0)
       {
          U8 *vertexData = (U8*)dMalloc_aligned(vboSize, 16);
          dMemcpy(vertexData, vboData, vboSize);
@@ -1464,55 +1459,55 @@ void TSShape::assembleShape()
 
    // about to read in the meshes...first must allocate some scratch space
    S32 scratchSize = getMax(numSkins,numMeshes);
-   TSMesh::smVertsList.setSize(scratchSize);
-   TSMesh::smTVertsList.setSize(scratchSize);
+   alloc->mVertsList.setSize(scratchSize);
+   alloc->mTVertsList.setSize(scratchSize);
 
-   if ( smReadVersion >= 26 )
+   if ( alloc->getVersion() >= 26 )
    {
-      TSMesh::smTVerts2List.setSize(scratchSize);
-      TSMesh::smColorsList.setSize(scratchSize);
+      alloc->mTVerts2List.setSize(scratchSize);
+      alloc->mColorsList.setSize(scratchSize);
    }
 
-   TSMesh::smNormsList.setSize(scratchSize);
-   TSMesh::smEncodedNormsList.setSize(scratchSize);
-   TSMesh::smDataCopied.setSize(scratchSize);
-   TSSkinMesh::smInitTransformList.setSize(scratchSize);
-   TSSkinMesh::smVertexIndexList.setSize(scratchSize);
-   TSSkinMesh::smBoneIndexList.setSize(scratchSize);
-   TSSkinMesh::smWeightList.setSize(scratchSize);
-   TSSkinMesh::smNodeIndexList.setSize(scratchSize);
+   alloc->mNormsList.setSize(scratchSize);
+   alloc->mEncodedNormsList.setSize(scratchSize);
+   alloc->mDataCopied.setSize(scratchSize);
+   alloc->mInitTransformList.setSize(scratchSize);
+   alloc->mVertexIndexList.setSize(scratchSize);
+   alloc->mBoneIndexList.setSize(scratchSize);
+   alloc->mWeightList.setSize(scratchSize);
+   alloc->mNodeIndexList.setSize(scratchSize);
    for (i=0; i<numMeshes; i++)
    {
-      TSMesh::smVertsList[i]=NULL;
-      TSMesh::smTVertsList[i]=NULL;
+      alloc->mVertsList[i]=NULL;
+      alloc->mTVertsList[i]=NULL;
       
-      if ( smReadVersion >= 26 )
+      if ( alloc->getVersion() >= 26 )
       {
-         TSMesh::smTVerts2List[i] = NULL;
-         TSMesh::smColorsList[i] = NULL;
+         alloc->mTVerts2List[i] = NULL;
+         alloc->mColorsList[i] = NULL;
       }
       
-      TSMesh::smNormsList[i]=NULL;
-      TSMesh::smEncodedNormsList[i]=NULL;
-      TSMesh::smDataCopied[i]=false;
-      TSSkinMesh::smInitTransformList[i] = NULL;
-      TSSkinMesh::smVertexIndexList[i] = NULL;
-      TSSkinMesh::smBoneIndexList[i] = NULL;
-      TSSkinMesh::smWeightList[i] = NULL;
-      TSSkinMesh::smNodeIndexList[i] = NULL;
+      alloc->mNormsList[i]=NULL;
+      alloc->mEncodedNormsList[i]=NULL;
+      alloc->mDataCopied[i]=false;
+      alloc->mInitTransformList[i] = NULL;
+      alloc->mVertexIndexList[i] = NULL;
+      alloc->mBoneIndexList[i] = NULL;
+      alloc->mWeightList[i] = NULL;
+      alloc->mNodeIndexList[i] = NULL;
    }
 
    // read in the meshes (sans skins)...straightforward read one at a time
-   TSMesh **ptrmesh = (TSMesh**)tsalloc.allocShape32((numMeshes + numSkins*numDetails) * (sizeof(TSMesh*) / 4));
+   TSMesh **ptrmesh = (TSMesh**)alloc->allocShape32((numMeshes + numSkins*numDetails) * (sizeof(TSMesh*) / 4));
    S32 curObject = 0; // for tracking skipped meshes
    for (i=0; i<numMeshes; i++)
    {
       bool skip = checkSkip(i,curObject,skipDL); // skip this mesh?
-      S32 meshType = tsalloc.get32();
+      S32 meshType = alloc->get32();
       if (meshType == TSMesh::DecalMeshType)
          // decal mesh deprecated
          skip = true;
-      TSMesh * mesh = TSMesh::assembleMesh(meshType,skip);
+      TSMesh * mesh = TSMesh::assembleMesh(alloc,meshType,skip);
       if (ptrmesh)
       {
          ptrmesh[i] = skip ?  0 : mesh;
@@ -1521,35 +1516,35 @@ void TSShape::assembleShape()
       // fill in location of verts, tverts, and normals for detail levels
       if (mesh && meshType!=TSMesh::DecalMeshType)
       {
-         TSMesh::smVertsList[i]  = mesh->verts.address();
-         TSMesh::smTVertsList[i] = mesh->tverts.address();
-         if (smReadVersion >= 26)
+         alloc->mVertsList[i]  = mesh->verts.address();
+         alloc->mTVertsList[i] = mesh->tverts.address();
+         if (alloc->getVersion() >= 26)
          {
-            TSMesh::smTVerts2List[i] = mesh->tverts2.address();
-            TSMesh::smColorsList[i] = mesh->colors.address();
+            alloc->mTVerts2List[i] = mesh->tverts2.address();
+            alloc->mColorsList[i] = mesh->colors.address();
          }
-         TSMesh::smNormsList[i]  = mesh->norms.address();
-         TSMesh::smEncodedNormsList[i] = mesh->encodedNorms.address();
-         TSMesh::smDataCopied[i] = !skip; // as long as we didn't skip this mesh, the data should be in shape now
+         alloc->mNormsList[i]  = mesh->norms.address();
+         alloc->mEncodedNormsList[i] = mesh->encodedNorms.address();
+         alloc->mDataCopied[i] = !skip; // as long as we didn't skip this mesh, the data should be in shape now
          if (meshType==TSMesh::SkinMeshType)
          {
             TSSkinMesh * skin = (TSSkinMesh*)mesh;
-            TSMesh::smVertsList[i]  = skin->batchData.initialVerts.address();
-            TSMesh::smNormsList[i]  = skin->batchData.initialNorms.address();
-            TSSkinMesh::smInitTransformList[i] = skin->batchData.initialTransforms.address();
-            TSSkinMesh::smVertexIndexList[i] = skin->vertexIndex.address();
-            TSSkinMesh::smBoneIndexList[i] = skin->boneIndex.address();
-            TSSkinMesh::smWeightList[i] = skin->weight.address();
-            TSSkinMesh::smNodeIndexList[i] = skin->batchData.nodeIndex.address();
+            alloc->mVertsList[i]  = skin->batchData.initialVerts.address();
+            alloc->mNormsList[i]  = skin->batchData.initialNorms.address();
+            alloc->mInitTransformList[i] = skin->batchData.initialTransforms.address();
+            alloc->mVertexIndexList[i] = skin->vertexIndex.address();
+            alloc->mBoneIndexList[i] = skin->boneIndex.address();
+            alloc->mWeightList[i] = skin->weight.address();
+            alloc->mNodeIndexList[i] = skin->batchData.nodeIndex.address();
          }
       }
    }
    meshes.set(ptrmesh, numMeshes);
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
    // names
-   char * nameBufferStart = (char*)tsalloc.getPointer8(0);
+   char * nameBufferStart = (char*)alloc->getPointer8(0);
    char * name = nameBufferStart;
    S32 nameBufferSize = 0;
    names.setSize(numNames);
@@ -1563,48 +1558,48 @@ void TSShape::assembleShape()
       name += j + 1;
    }
 
-   tsalloc.getPointer8(nameBufferSize);
-   tsalloc.align32();
+   alloc->getPointer8(nameBufferSize);
+   alloc->align32();
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 
-   if (smReadVersion<23)
+   if (alloc->getVersion()<23)
    {
       // get detail information about skins...
-      S32 * detFirstSkin = tsalloc.getPointer32(numDetails);
-      S32 * detailNumSkins = tsalloc.getPointer32(numDetails);
+      S32 * detFirstSkin = alloc->getPointer32(numDetails);
+      S32 * detailNumSkins = alloc->getPointer32(numDetails);
 
-      tsalloc.checkGuard();
+      alloc->checkGuard();
 
       // about to read in skins...clear out scratch space...
       if (numSkins)
       {
-         TSSkinMesh::smInitTransformList.setSize(numSkins);
-         TSSkinMesh::smVertexIndexList.setSize(numSkins);
-         TSSkinMesh::smBoneIndexList.setSize(numSkins);
-         TSSkinMesh::smWeightList.setSize(numSkins);
-         TSSkinMesh::smNodeIndexList.setSize(numSkins);
+         alloc->mInitTransformList.setSize(numSkins);
+         alloc->mVertexIndexList.setSize(numSkins);
+         alloc->mBoneIndexList.setSize(numSkins);
+         alloc->mWeightList.setSize(numSkins);
+         alloc->mNodeIndexList.setSize(numSkins);
       }
       for (i=0; i<numSkins; i++)
       {
-         TSMesh::smVertsList[i]=NULL;
-         TSMesh::smTVertsList[i]=NULL;
-         TSMesh::smNormsList[i]=NULL;
-         TSMesh::smEncodedNormsList[i]=NULL;
-         TSMesh::smDataCopied[i]=false;
-         TSSkinMesh::smInitTransformList[i] = NULL;
-         TSSkinMesh::smVertexIndexList[i] = NULL;
-         TSSkinMesh::smBoneIndexList[i] = NULL;
-         TSSkinMesh::smWeightList[i] = NULL;
-         TSSkinMesh::smNodeIndexList[i] = NULL;
+         alloc->mVertsList[i]=NULL;
+         alloc->mTVertsList[i]=NULL;
+         alloc->mNormsList[i]=NULL;
+         alloc->mEncodedNormsList[i]=NULL;
+         alloc->mDataCopied[i]=false;
+         alloc->mInitTransformList[i] = NULL;
+         alloc->mVertexIndexList[i] = NULL;
+         alloc->mBoneIndexList[i] = NULL;
+         alloc->mWeightList[i] = NULL;
+         alloc->mNodeIndexList[i] = NULL;
       }
 
       // skins
-      ptr32 = tsalloc.allocShape32(numSkins);
+      ptr32 = alloc->allocShape32(numSkins);
       for (i=0; i<numSkins; i++)
       {
          bool skip = i<detFirstSkin[skipDL];
-         TSSkinMesh * skin = (TSSkinMesh*)TSMesh::assembleMesh(TSMesh::SkinMeshType,skip);
+         TSSkinMesh * skin = (TSSkinMesh*)TSMesh::assembleMesh(alloc,TSMesh::SkinMeshType,skip);
          if (meshes.address())
          {
             // add pointer to skin in shapes list of meshes
@@ -1616,144 +1611,144 @@ void TSShape::assembleShape()
          // fill in location of verts, tverts, and normals for shared detail levels
          if (skin)
          {
-            TSMesh::smVertsList[i]  = skin->batchData.initialVerts.address();
-            TSMesh::smTVertsList[i] = skin->tverts.address();
-            TSMesh::smNormsList[i]  = skin->batchData.initialNorms.address();
-            TSMesh::smEncodedNormsList[i]  = skin->encodedNorms.address();
-            TSMesh::smDataCopied[i] = !skip; // as long as we didn't skip this mesh, the data should be in shape now
-            TSSkinMesh::smInitTransformList[i] = skin->batchData.initialTransforms.address();
-            TSSkinMesh::smVertexIndexList[i] = skin->vertexIndex.address();
-            TSSkinMesh::smBoneIndexList[i] = skin->boneIndex.address();
-            TSSkinMesh::smWeightList[i] = skin->weight.address();
-            TSSkinMesh::smNodeIndexList[i] = skin->batchData.nodeIndex.address();
+            alloc->mVertsList[i]  = skin->batchData.initialVerts.address();
+            alloc->mTVertsList[i] = skin->tverts.address();
+            alloc->mNormsList[i]  = skin->batchData.initialNorms.address();
+            alloc->mEncodedNormsList[i]  = skin->encodedNorms.address();
+            alloc->mDataCopied[i] = !skip; // as long as we didn't skip this mesh, the data should be in shape now
+            alloc->mInitTransformList[i] = skin->batchData.initialTransforms.address();
+            alloc->mVertexIndexList[i] = skin->vertexIndex.address();
+            alloc->mBoneIndexList[i] = skin->boneIndex.address();
+            alloc->mWeightList[i] = skin->weight.address();
+            alloc->mNodeIndexList[i] = skin->batchData.nodeIndex.address();
          }
       }
 
-      tsalloc.checkGuard();
+      alloc->checkGuard();
 
       // we now have skins in mesh list...add skin objects to object list and patch things up
       fixupOldSkins(numMeshes,numSkins,numDetails,detFirstSkin,detailNumSkins);
    }
 
    // allocate storage space for some arrays (filled in during Shape::init)...
-   ptr32 = tsalloc.allocShape32(numDetails);
+   ptr32 = alloc->allocShape32(numDetails);
    alphaIn.set(ptr32,numDetails);
-   ptr32 = tsalloc.allocShape32(numDetails);
+   ptr32 = alloc->allocShape32(numDetails);
    alphaOut.set(ptr32,numDetails);
 }
 
-void TSShape::disassembleShape()
+void TSShape::disassembleShape(TSShapeAlloc* alloc)
 {
    S32 i;
 
    // set counts...
-   S32 numNodes = tsalloc.set32(nodes.size());
-   S32 numObjects = tsalloc.set32(objects.size());
-   tsalloc.set32(0); // DEPRECATED decals
-   S32 numSubShapes = tsalloc.set32(subShapeFirstNode.size());
-   tsalloc.set32(0); // DEPRECATED ifl materials
-   S32 numNodeRotations = tsalloc.set32(nodeRotations.size());
-   S32 numNodeTranslations = tsalloc.set32(nodeTranslations.size());
-   S32 numNodeUniformScales = tsalloc.set32(nodeUniformScales.size());
-   S32 numNodeAlignedScales = tsalloc.set32(nodeAlignedScales.size());
-   S32 numNodeArbitraryScales = tsalloc.set32(nodeArbitraryScaleFactors.size());
-   S32 numGroundFrames = tsalloc.set32(groundTranslations.size());
-   S32 numObjectStates = tsalloc.set32(objectStates.size());
-   tsalloc.set32(0); // DEPRECATED decals
-   S32 numTriggers = tsalloc.set32(triggers.size());
-   S32 numDetails = tsalloc.set32(details.size());
-   S32 numMeshes = tsalloc.set32(meshes.size());
-   S32 numNames = tsalloc.set32(names.size());
-   tsalloc.set32((S32)mSmallestVisibleSize);
-   tsalloc.set32(mSmallestVisibleDL);
-
-   tsalloc.setGuard();
+   S32 numNodes = alloc->set32(nodes.size());
+   S32 numObjects = alloc->set32(objects.size());
+   alloc->set32(0); // DEPRECATED decals
+   S32 numSubShapes = alloc->set32(subShapeFirstNode.size());
+   alloc->set32(0); // DEPRECATED ifl materials
+   S32 numNodeRotations = alloc->set32(nodeRotations.size());
+   S32 numNodeTranslations = alloc->set32(nodeTranslations.size());
+   S32 numNodeUniformScales = alloc->set32(nodeUniformScales.size());
+   S32 numNodeAlignedScales = alloc->set32(nodeAlignedScales.size());
+   S32 numNodeArbitraryScales = alloc->set32(nodeArbitraryScaleFactors.size());
+   S32 numGroundFrames = alloc->set32(groundTranslations.size());
+   S32 numObjectStates = alloc->set32(objectStates.size());
+   alloc->set32(0); // DEPRECATED decals
+   S32 numTriggers = alloc->set32(triggers.size());
+   S32 numDetails = alloc->set32(details.size());
+   S32 numMeshes = alloc->set32(meshes.size());
+   S32 numNames = alloc->set32(names.size());
+   alloc->set32((S32)mSmallestVisibleSize);
+   alloc->set32(mSmallestVisibleDL);
+
+   alloc->setGuard();
 
    // get bounds...
-   tsalloc.copyToBuffer32((S32*)&radius,1);
-   tsalloc.copyToBuffer32((S32*)&tubeRadius,1);
-   tsalloc.copyToBuffer32((S32*)&center,3);
-   tsalloc.copyToBuffer32((S32*)&bounds,6);
+   alloc->copyToBuffer32((S32*)&radius,1);
+   alloc->copyToBuffer32((S32*)&tubeRadius,1);
+   alloc->copyToBuffer32((S32*)&center,3);
+   alloc->copyToBuffer32((S32*)&bounds,6);
 
-   tsalloc.setGuard();
+   alloc->setGuard();
 
    // copy various vectors...
-   tsalloc.copyToBuffer32((S32*)nodes.address(),numNodes*5);
-   tsalloc.setGuard();
-   tsalloc.copyToBuffer32((S32*)objects.address(),numObjects*6);
-   tsalloc.setGuard();
+   alloc->copyToBuffer32((S32*)nodes.address(),numNodes*5);
+   alloc->setGuard();
+   alloc->copyToBuffer32((S32*)objects.address(),numObjects*6);
+   alloc->setGuard();
    // DEPRECATED: no copy decals
-   tsalloc.setGuard();
-   tsalloc.copyToBuffer32(0,0); // DEPRECATED: ifl materials!
-   tsalloc.setGuard();
-   tsalloc.copyToBuffer32((S32*)subShapeFirstNode.address(),numSubShapes);
-   tsalloc.copyToBuffer32((S32*)subShapeFirstObject.address(),numSubShapes);
-   tsalloc.copyToBuffer32(0, numSubShapes); // DEPRECATED: no copy subShapeFirstDecal
-   tsalloc.setGuard();
-   tsalloc.copyToBuffer32((S32*)subShapeNumNodes.address(),numSubShapes);
-   tsalloc.copyToBuffer32((S32*)subShapeNumObjects.address(),numSubShapes);
-   tsalloc.copyToBuffer32(0, numSubShapes); // DEPRECATED: no copy subShapeNumDecals
-   tsalloc.setGuard();
+   alloc->setGuard();
+   alloc->copyToBuffer32(0,0); // DEPRECATED: ifl materials!
+   alloc->setGuard();
+   alloc->copyToBuffer32((S32*)subShapeFirstNode.address(),numSubShapes);
+   alloc->copyToBuffer32((S32*)subShapeFirstObject.address(),numSubShapes);
+   alloc->copyToBuffer32(0, numSubShapes); // DEPRECATED: no copy subShapeFirstDecal
+   alloc->setGuard();
+   alloc->copyToBuffer32((S32*)subShapeNumNodes.address(),numSubShapes);
+   alloc->copyToBuffer32((S32*)subShapeNumObjects.address(),numSubShapes);
+   alloc->copyToBuffer32(0, numSubShapes); // DEPRECATED: no copy subShapeNumDecals
+   alloc->setGuard();
 
    // default transforms...
-   tsalloc.copyToBuffer16((S16*)defaultRotations.address(),numNodes*4);
-   tsalloc.copyToBuffer32((S32*)defaultTranslations.address(),numNodes*3);
+   alloc->copyToBuffer16((S16*)defaultRotations.address(),numNodes*4);
+   alloc->copyToBuffer32((S32*)defaultTranslations.address(),numNodes*3);
 
    // animated transforms...
-   tsalloc.copyToBuffer16((S16*)nodeRotations.address(),numNodeRotations*4);
-   tsalloc.copyToBuffer32((S32*)nodeTranslations.address(),numNodeTranslations*3);
+   alloc->copyToBuffer16((S16*)nodeRotations.address(),numNodeRotations*4);
+   alloc->copyToBuffer32((S32*)nodeTranslations.address(),numNodeTranslations*3);
 
-   tsalloc.setGuard();
+   alloc->setGuard();
 
    // ...with scale
-   tsalloc.copyToBuffer32((S32*)nodeUniformScales.address(),numNodeUniformScales);
-   tsalloc.copyToBuffer32((S32*)nodeAlignedScales.address(),numNodeAlignedScales*3);
-   tsalloc.copyToBuffer32((S32*)nodeArbitraryScaleFactors.address(),numNodeArbitraryScales*3);
-   tsalloc.copyToBuffer16((S16*)nodeArbitraryScaleRots.address(),numNodeArbitraryScales*4);
+   alloc->copyToBuffer32((S32*)nodeUniformScales.address(),numNodeUniformScales);
+   alloc->copyToBuffer32((S32*)nodeAlignedScales.address(),numNodeAlignedScales*3);
+   alloc->copyToBuffer32((S32*)nodeArbitraryScaleFactors.address(),numNodeArbitraryScales*3);
+   alloc->copyToBuffer16((S16*)nodeArbitraryScaleRots.address(),numNodeArbitraryScales*4);
 
-   tsalloc.setGuard();
+   alloc->setGuard();
 
-   tsalloc.copyToBuffer32((S32*)groundTranslations.address(),3*numGroundFrames);
-   tsalloc.copyToBuffer16((S16*)groundRotations.address(),4*numGroundFrames);
+   alloc->copyToBuffer32((S32*)groundTranslations.address(),3*numGroundFrames);
+   alloc->copyToBuffer16((S16*)groundRotations.address(),4*numGroundFrames);
 
-   tsalloc.setGuard();
+   alloc->setGuard();
 
    // object states..
-   tsalloc.copyToBuffer32((S32*)objectStates.address(),numObjectStates*3);
-   tsalloc.setGuard();
+   alloc->copyToBuffer32((S32*)objectStates.address(),numObjectStates*3);
+   alloc->setGuard();
 
    // decal states...
    // DEPRECATED (numDecalStates = 0)
-   tsalloc.setGuard();
+   alloc->setGuard();
 
    // frame triggers
-   tsalloc.copyToBuffer32((S32*)triggers.address(),numTriggers*2);
-   tsalloc.setGuard();
+   alloc->copyToBuffer32((S32*)triggers.address(),numTriggers*2);
+   alloc->setGuard();
 
    // details
-   if (TSShape::smVersion > 25)
+   if (alloc->getVersion() > 25)
    {
       U32 alignedSize32 = sizeof( Detail ) / 4;
-      tsalloc.copyToBuffer32((S32*)details.address(),numDetails * alignedSize32 );
+      alloc->copyToBuffer32((S32*)details.address(),numDetails * alignedSize32 );
    }
    else
    {
       // Legacy details => no explicit autobillboard parameters
       U32 legacyDetailSize32 = 7;   // only store the first 7 4-byte values of each detail
       for ( S32 i = 0; i < details.size(); i++ )
-         tsalloc.copyToBuffer32( (S32*)&details[i], legacyDetailSize32 );
+         alloc->copyToBuffer32( (S32*)&details[i], legacyDetailSize32 );
    }
-   tsalloc.setGuard();
+   alloc->setGuard();
 
-   if (TSShape::smVersion >= 27)
+   if (alloc->getVersion() >= 27)
    {
       // Vertex format now included with mesh data. Note this doesn't include index data which
       // is constructed directly in the buffer from the meshes
 
-      mBasicVertexFormat.writeAlloc(&tsalloc);
+      mBasicVertexFormat.writeAlloc(alloc);
 
-      tsalloc.set32(mShapeVertexData.size);
-      tsalloc.copyToBuffer8((S8*)mShapeVertexData.base, mShapeVertexData.size);
+      alloc->set32(mShapeVertexData.size);
+      alloc->copyToBuffer8((S8*)mShapeVertexData.base, mShapeVertexData.size);
    }
 
    // read in the meshes (sans skins)...
@@ -1772,18 +1767,18 @@ void TSShape::disassembleShape()
       // decal mesh deprecated
       if (isMesh[i])
          mesh = meshes[i];
-      tsalloc.set32( (mesh && mesh->getMeshType() != TSMesh::DecalMeshType) ? mesh->getMeshType() : TSMesh::NullMeshType);
+      alloc->set32( (mesh && mesh->getMeshType() != TSMesh::DecalMeshType) ? mesh->getMeshType() : TSMesh::NullMeshType);
       if (mesh)
-         mesh->disassemble();
+         mesh->disassemble(alloc);
    }
    delete [] isMesh;
-   tsalloc.setGuard();
+   alloc->setGuard();
 
    // names
    for (i=0; i<numNames; i++)
-      tsalloc.copyToBuffer8((S8 *)(names[i].c_str()),names[i].length()+1);
+      alloc->copyToBuffer8((S8 *)(names[i].c_str()),names[i].length()+1);
 
-   tsalloc.setGuard();
+   alloc->setGuard();
 }
 
 //-------------------------------------------------
@@ -1825,23 +1820,23 @@ bool TSShape::canWriteOldFormat() const
 
 void TSShape::write(Stream * s, bool saveOldFormat)
 {
-   S32 currentVersion = smVersion;
-   if (saveOldFormat)
-      smVersion = 24;
+   S32 version = saveOldFormat ? 24 : smVersion;
 
    // write version
-   s->write(smVersion | (mExporterVersion<<16));
+   s->write(version | (mExporterVersion<<16));
 
-   tsalloc.setWrite();
-   disassembleShape();
+   TSShapeAlloc alloc;
+   alloc.setVersion(version);
+   alloc.setWrite();
+   disassembleShape(&alloc);
 
-   S32     * buffer32 = tsalloc.getBuffer32();
-   S16     * buffer16 = tsalloc.getBuffer16();
-   S8      * buffer8  = tsalloc.getBuffer8();
+   S32     * buffer32 = alloc.getBuffer32();
+   S16     * buffer16 = alloc.getBuffer16();
+   S8      * buffer8  = alloc.getBuffer8();
 
-   S32 size32 = tsalloc.getBufferSize32();
-   S32 size16 = tsalloc.getBufferSize16();
-   S32 size8  = tsalloc.getBufferSize8();
+   S32 size32 = alloc.getBufferSize32();
+   S32 size16 = alloc.getBufferSize16();
+   S32 size8  = alloc.getBufferSize8();
 
    // convert sizes to dwords...
    if (size16 & 1)
@@ -1875,34 +1870,33 @@ void TSShape::write(Stream * s, bool saveOldFormat)
       sequences[i].write(s);
 
    // write material list - write will properly endian-flip.
-   materialList->write(*s);
+   materialList->write(*s, version);
 
    delete [] buffer32;
    delete [] buffer16;
    delete [] buffer8;
-
-   smVersion = currentVersion;
 }
 
 //-------------------------------------------------
 // read whole shape
 //-------------------------------------------------
 
-bool TSShape::read(Stream * s)
+bool TSShape::read(Stream * s, bool initShape)
 {
    // read version - read handles endian-flip
-   s->read(&smReadVersion);
-   mExporterVersion = smReadVersion >> 16;
-   smReadVersion &= 0xFF;
-   if (smReadVersion>smVersion)
+   S32 readVersion;
+   s->read(&readVersion);
+   mExporterVersion = readVersion >> 16;
+   readVersion &= 0xFF;
+   if (readVersion>smVersion)
    {
       // error -- don't support future versions yet :>
       Con::errorf(ConsoleLogEntry::General,
                   "Error: attempt to load a version %i dts-shape, can currently only load version %i and before.",
-                   smReadVersion,smVersion);
+                   readVersion,smVersion);
       return false;
    }
-   mReadVersion = smReadVersion;
+   mReadVersion = readVersion;
 
    S32 * memBuffer32;
    S16 * memBuffer16;
@@ -1945,7 +1939,7 @@ bool TSShape::read(Stream * s)
       sequences.setSize(numSequences);
       for (i=0; i<numSequences; i++)
       {
-         sequences[i].read(s);
+         sequences[i].read(s, mReadVersion);
 
          // Store initial (empty) source data
          sequences[i].sourceData.total = sequences[i].numKeyframes;
@@ -1955,24 +1949,26 @@ bool TSShape::read(Stream * s)
       // read material list
       delete materialList; // just in case...
       materialList = new TSMaterialList;
-      materialList->read(*s);
+      materialList->read(*s, mReadVersion);
    }
 
 	// since we read in the buffers, we need to endian-flip their entire contents...
    fixEndian(memBuffer32,memBuffer16,memBuffer8,count32,count16,count8);
 
-   tsalloc.setRead(memBuffer32,memBuffer16,memBuffer8,true);
-   assembleShape(); // determine size of buffer needed
-   mShapeDataSize = tsalloc.getSize();
-   tsalloc.doAlloc();
-   mShapeData = tsalloc.getBuffer();
-   tsalloc.setRead(memBuffer32,memBuffer16,memBuffer8,false);
-   assembleShape(); // copy to buffer
-   AssertFatal(tsalloc.getSize()==mShapeDataSize,"TSShape::read: shape data buffer size mis-calculated");
+   TSShapeAlloc alloc;
+   alloc.setVersion(mReadVersion);
+   alloc.setRead(memBuffer32,memBuffer16,memBuffer8,true);
+   assembleShape(&alloc); // determine size of buffer needed
+   mShapeDataSize = alloc.getSize();
+   alloc.doAlloc();
+   mShapeData = alloc.getBuffer();
+   alloc.setRead(memBuffer32,memBuffer16,memBuffer8,false);
+   assembleShape(&alloc); // copy to buffer
+   AssertFatal(alloc.getSize()==mShapeDataSize,"TSShape::read: shape data buffer size mis-calculated");
 
    delete [] memBuffer32;
 
-   if (smInitOnRead)
+   if (smInitOnRead && initShape)
    {
       init();
    }
@@ -2097,9 +2093,9 @@ void TSShape::fixEndian(S32 * buff32, S16 * buff16, S8 *, S32 count32, S32 count
    }
 }
 
-template<> void *Resource<TSShape>::create(const Torque::Path &path)
+/// Execute the shape script if it exists.
+static void _execShapeScript(const Torque::Path &path)
 {
-   // Execute the shape script if it exists
    Torque::Path scriptPath(path);
    scriptPath.setExtension("cs");
 
@@ -2120,57 +2116,46 @@ template<> void *Resource<TSShape>::create(const Torque::Path &path)
          Con::setVariable("InstantGroup", instantGroup.c_str());
       }
    }
+}
 
-   // Attempt to load the shape
-   TSShape * ret = 0;
-   bool readSuccess = false;
+/// Return the DTS file to read for the shape at path, or an empty path
+/// if the shape is not read from a DTS file.
+static Torque::Path _getShapeDTSPath(const Torque::Path &path)
+{
    const String extension = path.getExtension();
 
    if ( extension.equal( "dts", String::NoCase ) )
-   {
-      FileStream stream;
-      stream.open( path.getFullPath(), Torque::FS::File::Read );
-      if ( stream.getStatus() != Stream::Ok )
-      {
-         Con::errorf( "Resource<TSShape>::create - Could not open '%s'", path.getFullPath().c_str() );
-         return NULL;
-      }
+      return path;
 
-      ret = new TSShape;
-      readSuccess = ret->read(&stream);
-   }
-   else if ( extension.equal( "dae", String::NoCase ) || extension.equal( "kmz", String::NoCase ) )
+#ifndef TORQUE_COLLADA
+   // No COLLADA support => attempt to load the cached DTS file instead
+   if ( extension.equal( "dae", String::NoCase ) || extension.equal( "kmz", String::NoCase ) )
    {
-#ifdef TORQUE_COLLADA
-      // Attempt to load the DAE file
-      ret = loadColladaShape(path);
-      readSuccess = (ret != NULL);
-#else
-      // No COLLADA support => attempt to load the cached DTS file instead
       Torque::Path cachedPath = path;
       cachedPath.setExtension("cached.dts");
-       
-      FileStream stream;
-      stream.open( cachedPath.getFullPath(), Torque::FS::File::Read );
-      if ( stream.getStatus() != Stream::Ok )
-      {
-         Con::errorf( "Resource<TSShape>::create - Could not open '%s'", cachedPath.getFullPath().c_str() );
-         return NULL;
-      }
-      ret = new TSShape;
-      readSuccess = ret->read(&stream);
-#endif
+      return cachedPath;
    }
-   else
+#endif
+
+   return Torque::Path();
+}
+
+/// Read a DTS file.  This does not need the main thread when initShape
+/// is false.
+static TSShape *_readShapeDTS(const Torque::Path &dtsPath, bool initShape)
+{
+   FileStream stream;
+   stream.open( dtsPath.getFullPath(), Torque::FS::File::Read );
+   if ( stream.getStatus() != Stream::Ok )
    {
-      Con::errorf( "Resource<TSShape>::create - '%s' has an unknown file format", path.getFullPath().c_str() );
-      delete ret;
+      Con::errorf( "Resource<TSShape>::create - Could not open '%s'", dtsPath.getFullPath().c_str() );
       return NULL;
    }
 
-   if( !readSuccess )
+   TSShape *ret = new TSShape;
+   if ( !ret->read( &stream, initShape ) )
    {
-      Con::errorf( "Resource<TSShape>::create - Error reading '%s'", path.getFullPath().c_str() );
+      Con::errorf( "Resource<TSShape>::create - Error reading '%s'", dtsPath.getFullPath().c_str() );
       delete ret;
       ret = NULL;
    }
@@ -2178,6 +2163,65 @@ template<> void *Resource<TSShape>::create(const Torque::Path &path)
    return ret;
 }
 
+template<> void *Resource<TSShape>::create(const Torque::Path &path)
+{
+   _execShapeScript(path);
+
+   // Attempt to load the shape
+   const Torque::Path dtsPath = _getShapeDTSPath(path);
+   if ( !dtsPath.isEmpty() )
+      return _readShapeDTS( dtsPath, true );
+
+   const String extension = path.getExtension();
+
+#ifdef TORQUE_COLLADA
+   if ( extension.equal( "dae", String::NoCase ) || extension.equal( "kmz", String::NoCase ) )
+   {
+      // Attempt to load the DAE file
+      TSShape *ret = loadColladaShape(path);
+      if ( !ret )
+         Con::errorf( "Resource<TSShape>::create - Error reading '%s'", path.getFullPath().c_str() );
+      return ret;
+   }
+#endif
+
+   Con::errorf( "Resource<TSShape>::create - '%s' has an unknown file format", path.getFullPath().c_str() );
+   return NULL;
+}
+
+/// Reads DTS files on a worker thread.  COLLADA import stays on the
+/// main thread.
+static bool _decodeShapeAsync(const Torque::Path &path, void **outDecoded)
+{
+   const Torque::Path dtsPath = _getShapeDTSPath(path);
+   if ( dtsPath.isEmpty() )
+      return false;
+
+   *outDecoded = _readShapeDTS( dtsPath, false );
+   return true;
+}
+
+/// Runs the shape script before the DTS file is read, like create() does.
+/// Shapes that are not read from a DTS file go through create() and run
+/// it there.
+static void _startShapeAsync(const Torque::Path &path)
+{
+   if ( !_getShapeDTSPath(path).isEmpty() )
+      _execShapeScript(path);
+}
+
+/// Sets up the vertex buffers.
+static void *_finishShapeAsync(const Torque::Path &path, void *decoded)
+{
+   TSShape *shape = reinterpret_cast<TSShape*>(decoded);
+   if ( TSShape::smInitOnRead )
+      shape->init();
+
+   return shape;
+}
+
+static ResourceRegisterAsyncLoader<TSShape> sgShapeAsyncLoader( _decodeShapeAsync, _finishShapeAsync, _startShapeAsync );
+
 template<> ResourceBase::Signature  Resource<TSShape>::signature()
 {
    return MakeFourCC('t','s','s','h');
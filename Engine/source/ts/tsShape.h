@@ -211,7 +211,7 @@ class TSShape
       /// @name IO
       /// @{
 
-      void read(Stream *, bool readNameIndex = true);
+      void read(Stream *, S32 version, bool readNameIndex = true);
       void write(Stream *, bool writeNameIndex = true) const;
       /// @}
    };
@@ -592,8 +592,6 @@ class TSShape
 
    /// Most recent version...the one we write
    static S32 smVersion;
-   /// Version currently being read, only valid during read
-   static S32 smReadVersion;
    static const U32 smMostRecentExporterVersion;
    ///@}
 
@@ -603,7 +601,9 @@ class TSShape
 
    bool canWriteOldFormat() const;
    void write(Stream *, bool saveOldFormat=false);
-   bool read(Stream *);
+   /// @param initShape If false, init() is not called and must be called
+   ///   on the main thread before the shape is used.
+   bool read(Stream *, bool initShape = true);
    void readOldShape(Stream * s, S32 * &, S16 * &, S8 * &, S32 &, S32 &, S32 &);
    void writeName(Stream *, S32 nameIndex);
    S32  readName(Stream *, bool addName);
@@ -620,8 +620,6 @@ class TSShape
    /// @name Persist Helper Functions
    /// @{
 
-   static TSShapeAlloc smTSAlloc;
-
    void fixEndian(S32 *, S16 *, S8 *, S32, S32, S32);
    /// @}
 
@@ -629,8 +627,8 @@ class TSShape
    /// uses TSShape::Alloc structure
    /// @{
 
-   void assembleShape();
-   void disassembleShape();
+   void assembleShape(TSShapeAlloc* alloc);
+   void disassembleShape(TSShapeAlloc* alloc);
    ///@}
 
    /// mem buffer transfer helper (indicate when we don't want to include a particular mesh/decal)
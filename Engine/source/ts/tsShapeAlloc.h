@@ -29,6 +29,11 @@
 #ifndef _MMATH_H_
 #include "math/mMath.h"
 #endif
+#ifndef _TVECTOR_H_
+#include "core/util/tVector.h"
+#endif
+
+class ColorI;
 
 /// Alloc structure used in the reading/writing of shapes.
 ///
@@ -57,10 +62,16 @@
 ///    16-bit, 8-bit (getBuffer16, getBuffer8).
 ///
 /// TSShape::assesmbleShape and TSShape::dissembleShape can be used as examples
+///
+/// An alloc holds all the state of one read or write, so shapes can be read
+/// on several threads at once, each with its own alloc.
 class TSShapeAlloc
 {
    S32 mMode; ///< read or write
 
+   /// DTS version of the data being read or written.
+   S32 mVersion;
+
    /// reading and writing (when reading these are the input; when writing these are the output)
    S32     * mMemBuffer32;
    S16     * mMemBuffer16;
@@ -94,6 +105,39 @@ class TSShapeAlloc
    enum { ReadMode = 0, WriteMode = 1, PageSize = 1024 }; ///< PageSize must be multiple of 4 so that we can always
                                                           ///< "over-read" up to next dword
 
+   TSShapeAlloc() : mVersion( 0 ) {}
+
+   /// Set the DTS version of the data; older versions are laid out differently.
+   void setVersion(S32 version) { mVersion = version; }
+   S32 getVersion() const { return mVersion; }
+
+   /// @name Assembly Variables
+   /// Used while reading a shape, for skipping mesh detail levels and for
+   /// sharing verts between meshes.  Indexed by mesh.
+   /// @{
+
+   Vector<Point3F*> mVertsList;
+   Vector<Point3F*> mNormsList;
+   Vector<U8*>      mEncodedNormsList;
+
+   Vector<Point2F*> mTVertsList;
+
+   // Optional second texture uvs.
+   Vector<Point2F*> mTVerts2List;
+
+   // Optional vertex colors.
+   Vector<ColorI*>  mColorsList;
+
+   Vector<bool>     mDataCopied;
+
+   // Skin meshes.
+   Vector<MatrixF*> mInitTransformList;
+   Vector<S32*>     mVertexIndexList;
+   Vector<S32*>     mBoneIndexList;
+   Vector<F32*>     mWeightList;
+   Vector<S32*>     mNodeIndexList;
+   /// @}
+
    void setRead(S32 * buff32, S16 * buff16, S8 * buff8, bool clear);
    void setWrite();
 
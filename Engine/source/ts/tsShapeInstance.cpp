@@ -75,6 +75,24 @@ MODULE_BEGIN( TSShapeInstance )
          "@brief Enables mesh instancing on non-skin meshes that have less that this count of verts.\n"
          "The default value is 200.  Higher values can degrade performance.\n"
          "@ingroup Rendering\n" );
+
+      Con::addVariable("$TSShapeInstance::parallelAnimate", TypeBool, &TSShapeInstance::smParallelAnimate,
+         "@brief If true, batches of shape instances are animated across the worker threads.\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable("$TSShapeInstance::minParallelAnimate", TypeS32, &TSShapeInstance::smMinParallelAnimate,
+         "@brief The least number of shape instances in a batch for which animation is "
+         "spread across the worker threads.\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable("$TSSkinMesh::parallelSkinning", TypeBool, &TSSkinMesh::smParallelSkinning,
+         "@brief If true, software skinning of large batches is spread across the worker threads.\n"
+         "@ingroup Rendering\n" );
+
+      Con::addVariable("$TSSkinMesh::minParallelSkinVerts", TypeS32, &TSSkinMesh::smMinParallelSkinVerts,
+         "@brief The least number of skinned vertices in a batch for which software skinning is "
+         "spread across the worker threads.\n"
+         "@ingroup Rendering\n" );
    }
 
 MODULE_END;
@@ -88,17 +106,8 @@ F32                           TSShapeInstance::smLastScreenErrorTolerance = 0.0f
 F32                           TSShapeInstance::smLastScaledDistance = 0.0f;
 F32                           TSShapeInstance::smLastPixelSize = 0.0f;
 
-Vector<QuatF>                 TSShapeInstance::smNodeCurrentRotations(__FILE__, __LINE__);
-Vector<Point3F>               TSShapeInstance::smNodeCurrentTranslations(__FILE__, __LINE__);
-Vector<F32>                   TSShapeInstance::smNodeCurrentUniformScales(__FILE__, __LINE__);
-Vector<Point3F>               TSShapeInstance::smNodeCurrentAlignedScales(__FILE__, __LINE__);
-Vector<TSScale>               TSShapeInstance::smNodeCurrentArbitraryScales(__FILE__, __LINE__);
-Vector<MatrixF>               TSShapeInstance::smNodeLocalTransforms(__FILE__, __LINE__);
-TSIntegerSet                  TSShapeInstance::smNodeLocalTransformDirty;
-
-Vector<TSThread*>             TSShapeInstance::smRotationThreads(__FILE__, __LINE__);
-Vector<TSThread*>             TSShapeInstance::smTranslationThreads(__FILE__, __LINE__);
-Vector<TSThread*>             TSShapeInstance::smScaleThreads(__FILE__, __LINE__);
+bool                          TSShapeInstance::smParallelAnimate = true;
+S32                           TSShapeInstance::smMinParallelAnimate = 16;
 
 //-------------------------------------------------------------------------------------
 // constructors, destructors, initialization
@@ -556,12 +565,19 @@ void TSShapeInstance::render( const TSRenderState &rdata, S32 dl, F32 intraDL )
          // Base vertex data
          dMemcpy(buffer, mShape->mShapeVertexData.base, mShape->mShapeVertexData.size);
 
-         // Apply skinned verts (where applicable)
+         // Apply skinned verts (where applicable), as one batch so the
+         // vertices of all the meshes can be shared with the worker threads
+         FrameAllocatorMarker jobMarker;
+         TSSkinMesh::SkinJob *jobs = jobMarker.alloc<TSSkinMesh::SkinJob>(end - start);
+         U32 numJobs = 0;
          for (i = start; i < end; i++)
          {
-            mMeshObjects[i].updateVertexBuffer(od, buffer);
+            if (mMeshObjects[i].getSkinJob(od, buffer, jobs[numJobs]))
+               numJobs++;
          }
 
+         TSSkinMesh::updateSkinBuffers(jobs, numJobs);
+
          realBuffer->unlock();
       }
    }
@@ -840,20 +856,29 @@ void TSShapeInstance::MeshObjectInstance::updateVertexBuffer(S32 objectDetail, U
 {
    PROFILE_SCOPE(TSShapeInstance_MeshObjectInstance_updateVertexBuffer);
 
+   TSSkinMesh::SkinJob job;
+   if (getSkinJob(objectDetail, buffer, job))
+      TSSkinMesh::updateSkinBuffers(&job, 1);
+}
+
+bool TSShapeInstance::MeshObjectInstance::getSkinJob(S32 objectDetail, U8 *buffer, TSSkinMesh::SkinJob &job)
+{
    if (forceHidden || ((visible) <= 0.01f))
-      return;
+      return false;
 
    TSMesh *mesh = getMesh(objectDetail);
    if (!mesh)
-      return;
-
-   // Update the buffer here
-   if (mesh->getMeshType() == TSMesh::SkinMeshType)
-   {
-      static_cast<TSSkinMesh*>(mesh)->updateSkinBuffer(*mTransforms, buffer);
-   }
+      return false;
 
    mLastTime = Sim::getCurrentTime();
+
+   if (mesh->getMeshType() != TSMesh::SkinMeshType)
+      return false;
+
+   job.mesh = static_cast<TSSkinMesh*>(mesh);
+   job.transforms = mTransforms;
+   job.buffer = buffer;
+   return true;
 }
 
 bool TSShapeInstance::MeshObjectInstance::bufferNeedsUpdate( S32 objectDetail )
@@ -175,6 +175,10 @@ class TSShapeInstance
 
       void updateVertexBuffer( S32 objectDetail, U8 *buffer );
 
+      /// Fills in the job for skinning this mesh into the buffer, returns
+      /// false if there is nothing to skin.
+      bool getSkinJob( S32 objectDetail, U8 *buffer, TSSkinMesh::SkinJob &job );
+
       bool bufferNeedsUpdate(S32 objectDetail);
 
       /// Gets the mesh with specified detail level
@@ -226,22 +230,24 @@ class TSShapeInstance
    /// @}
 
    /// @name Workspace for Node Transforms
+   /// These are kept per instance so that instances can be animated on
+   /// different threads at the same time.
    /// @{
-   static Vector<QuatF>   smNodeCurrentRotations;
-   static Vector<Point3F> smNodeCurrentTranslations;
-   static Vector<F32>     smNodeCurrentUniformScales;
-   static Vector<Point3F> smNodeCurrentAlignedScales;
-   static Vector<TSScale> smNodeCurrentArbitraryScales;
-   static Vector<MatrixF> smNodeLocalTransforms;
-   static TSIntegerSet    smNodeLocalTransformDirty;
+   Vector<QuatF>   mNodeCurrentRotations;
+   Vector<Point3F> mNodeCurrentTranslations;
+   Vector<F32>     mNodeCurrentUniformScales;
+   Vector<Point3F> mNodeCurrentAlignedScales;
+   Vector<TSScale> mNodeCurrentArbitraryScales;
+   Vector<MatrixF> mNodeLocalTransforms;
+   TSIntegerSet    mNodeLocalTransformDirty;
    /// @}
 
    /// @name Threads
    /// keep track of who controls what on currently animating shape
    /// @{
-   static Vector<TSThread*> smRotationThreads;
-   static Vector<TSThread*> smTranslationThreads;
-   static Vector<TSThread*> smScaleThreads;
+   Vector<TSThread*> mRotationThreads;
+   Vector<TSThread*> mTranslationThreads;
+   Vector<TSThread*> mScaleThreads;
    /// @}
 	
 	TSMaterialList* mMaterialList;    ///< by default, points to hShape material list
@@ -510,6 +516,34 @@ protected:
    void animateSubtrees(bool forceFull = true);
    void animateNodeSubtrees(bool forceFull = true);
 
+   /// @name Batch Animation
+   /// @{
+
+   /// If false, animateBatch() animates all instances on the calling thread.
+   static bool smParallelAnimate;
+
+   /// The least number of instances for which animateBatch() spreads the
+   /// work across the ThreadPool.
+   static S32 smMinParallelAnimate;
+
+   /// Returns true if the instance can be animated on a worker thread.
+   ///
+   /// Instances with node callbacks are not as the callbacks run game code.
+   bool isAnimateThreadSafe() const { return mNodeCallbacks.empty(); }
+
+   /// Animate many instances at once, spreading them across the ThreadPool.
+   ///
+   /// Each instance is animated at its current detail level as animate()
+   /// does, or all of its node subtrees as animateNodeSubtrees() does if
+   /// @a nodeSubtrees is set.  The call returns when all instances are done.
+   /// An instance must not appear twice in the batch and nothing else may
+   /// touch the instances while the batch runs.
+   ///
+   /// @see isAnimateThreadSafe
+   static void animateBatch( TSShapeInstance* const* instances, U32 count, bool nodeSubtrees = false );
+
+   /// @}
+
    /// Sets the 'forceHidden' state on the named mesh.
    /// @see MeshObjectInstance::forceHidden
    void setMeshForceHidden( const char *meshName, bool hidden );
@@ -295,12 +295,8 @@ void TSShape::exportSequences(Stream * s)
 //-------------------------------------------------
 void TSShape::exportSequence(Stream * s, const TSShape::Sequence& seq, bool saveOldFormat)
 {
-   S32 currentVersion = smVersion;
-   if ( saveOldFormat )
-      smVersion = 24;
-
    // write version
-   s->write(smVersion);
+   s->write(saveOldFormat ? 24 : smVersion);
 
    // write node names
    s->write( nodes.size() );
@@ -420,8 +416,6 @@ void TSShape::exportSequence(Stream * s, const TSShape::Sequence& seq, bool save
       s->write( triggers[i].state );
       s->write( triggers[i].pos );
    }
-
-   smVersion = currentVersion;
 }
 
 //-------------------------------------------------
@@ -430,19 +424,20 @@ void TSShape::exportSequence(Stream * s, const TSShape::Sequence& seq, bool save
 bool TSShape::importSequences(Stream * s, const String& sequencePath)
 {
    // write version
-   s->read(&smReadVersion);
-   if (smReadVersion>smVersion)
+   S32 readVersion;
+   s->read(&readVersion);
+   if (readVersion>smVersion)
    {
       // error -- don't support future version yet :>
       Con::errorf(ConsoleLogEntry::General,
                   "Sequence import failed:  shape exporter newer than running executable.");
       return false;
    }
-   if (smReadVersion<19)
+   if (readVersion<19)
    {
       // error -- don't support future version yet :>
       Con::errorf(ConsoleLogEntry::General,
-         "Sequence import failed:  deprecated version (%i).",smReadVersion);
+         "Sequence import failed:  deprecated version (%i).",readVersion);
       return false;
    }
 
@@ -487,9 +482,9 @@ bool TSShape::importSequences(Stream * s, const String& sequencePath)
    s->read(&oldShapeNumObjects);
 
    // adjust all the new keyframes
-   S32 adjNodeRots = smReadVersion<22 ? nodeRotations.size() - nodeMap.size() : nodeRotations.size();
-   S32 adjNodeTrans = smReadVersion<22 ? nodeTranslations.size() - nodeMap.size() : nodeTranslations.size();
-   S32 adjGroundStates = smReadVersion<22 ? 0 : groundTranslations.size(); // groundTrans==groundRot
+   S32 adjNodeRots = readVersion<22 ? nodeRotations.size() - nodeMap.size() : nodeRotations.size();
+   S32 adjNodeTrans = readVersion<22 ? nodeTranslations.size() - nodeMap.size() : nodeTranslations.size();
+   S32 adjGroundStates = readVersion<22 ? 0 : groundTranslations.size(); // groundTrans==groundRot
 
    // Read the node states into temporary vectors, then use the
    // nodeMap to discard unused transforms and map others to our nodes
@@ -500,7 +495,7 @@ bool TSShape::importSequences(Stream * s, const String& sequencePath)
    Vector<Quat16>    seqArbitraryScaleRots;
    Vector<Point3F>   seqArbitraryScaleFactors;
 
-   if (smReadVersion>21)
+   if (readVersion>21)
    {
       s->read(&sz);
       seqRotations.setSize(sz);
@@ -600,11 +595,11 @@ bool TSShape::importSequences(Stream * s, const String& sequencePath)
       seq.nameIndex = readName(s,true);
 
       // read the rest of the sequence
-      seq.read(s,false);
+      seq.read(s,readVersion,false);
       seq.baseRotation = nodeRotations.size();
       seq.baseTranslation = nodeTranslations.size();
 
-      if (smReadVersion > 21)
+      if (readVersion > 21)
       {
          if (seq.animatesUniformScale())
             seq.baseScale = nodeUniformScales.size();
@@ -691,7 +686,7 @@ bool TSShape::importSequences(Stream * s, const String& sequencePath)
       seq.firstGroundFrame += adjGroundStates;
    }
 
-   if (smReadVersion<22)
+   if (readVersion<22)
    {
       for (i=startSeqNum; i<sequences.size(); i++)
       {
@@ -728,14 +723,14 @@ bool TSShape::importSequences(Stream * s, const String& sequencePath)
 //-------------------------------------------------
 // read/write sequence
 //-------------------------------------------------
-void TSShape::Sequence::read(Stream * s, bool readNameIndex)
+void TSShape::Sequence::read(Stream * s, S32 version, bool readNameIndex)
 {
-   AssertISV(smReadVersion>=19,"Reading old sequence");
+   AssertISV(version>=19,"Reading old sequence");
 
    if (readNameIndex)
       s->read(&nameIndex);
    flags = 0;
-   if (TSShape::smReadVersion>21)
+   if (version>21)
       s->read(&flags);
    else
       flags=0;
@@ -743,7 +738,7 @@ void TSShape::Sequence::read(Stream * s, bool readNameIndex)
    s->read(&numKeyframes);
    s->read(&duration);
 
-   if (TSShape::smReadVersion<22)
+   if (version<22)
    {
       bool tmp = false;
       s->read(&tmp);
@@ -760,7 +755,7 @@ void TSShape::Sequence::read(Stream * s, bool readNameIndex)
    s->read(&priority);
    s->read(&firstGroundFrame);
    s->read(&numGroundFrames);
-   if (TSShape::smReadVersion>21)
+   if (version>21)
    {
       s->read(&baseRotation);
       s->read(&baseTranslation);
@@ -782,7 +777,7 @@ void TSShape::Sequence::read(Stream * s, bool readNameIndex)
 
    // now the membership sets:
    rotationMatters.read(s);
-   if (TSShape::smReadVersion<22)
+   if (version<22)
       translationMatters=rotationMatters;
    else
    {
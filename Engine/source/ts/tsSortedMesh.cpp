@@ -101,67 +101,66 @@ S32 TSSortedMesh::getNumPolys()
 // used for transfer to/from memory buffers
 //-----------------------------------------------------
 
-#define tsalloc TSShape::smTSAlloc
 
-void TSSortedMesh::assemble(bool skip)
+void TSSortedMesh::assemble(TSShapeAlloc* alloc, bool skip)
 {
    bool save1 = TSMesh::smUseTriangles;
    bool save2 = TSMesh::smUseOneStrip;
    TSMesh::smUseTriangles = false;
    TSMesh::smUseOneStrip = false;
 
-   TSMesh::assemble(skip);
+   TSMesh::assemble(alloc, skip);
 
    TSMesh::smUseTriangles = save1;
    TSMesh::smUseOneStrip = save2;
 
-   S32 numClusters = tsalloc.get32();
-   S32 * ptr32 = tsalloc.copyToShape32(numClusters*8);
+   S32 numClusters = alloc->get32();
+   S32 * ptr32 = alloc->copyToShape32(numClusters*8);
    clusters.set(ptr32,numClusters);
 
-   S32 sz = tsalloc.get32();
-   ptr32 = tsalloc.copyToShape32(sz);
+   S32 sz = alloc->get32();
+   ptr32 = alloc->copyToShape32(sz);
    startCluster.set(ptr32,sz);
 
-   sz = tsalloc.get32();
-   ptr32 = tsalloc.copyToShape32(sz);
+   sz = alloc->get32();
+   ptr32 = alloc->copyToShape32(sz);
    firstVerts.set(ptr32,sz);
 
-   sz = tsalloc.get32();
-   ptr32 = tsalloc.copyToShape32(sz);
+   sz = alloc->get32();
+   ptr32 = alloc->copyToShape32(sz);
    numVerts.set(ptr32,sz);
 
-   sz = tsalloc.get32();
-   ptr32 = tsalloc.copyToShape32(sz);
+   sz = alloc->get32();
+   ptr32 = alloc->copyToShape32(sz);
    firstTVerts.set(ptr32,sz);
 
-   alwaysWriteDepth = tsalloc.get32()!=0;
+   alwaysWriteDepth = alloc->get32()!=0;
 
-   tsalloc.checkGuard();
+   alloc->checkGuard();
 }
 
-void TSSortedMesh::disassemble()
+void TSSortedMesh::disassemble(TSShapeAlloc* alloc)
 {
-   TSMesh::disassemble();
+   TSMesh::disassemble(alloc);
 
-   tsalloc.set32(clusters.size());
-   tsalloc.copyToBuffer32((S32*)clusters.address(),clusters.size()*8);
+   alloc->set32(clusters.size());
+   alloc->copyToBuffer32((S32*)clusters.address(),clusters.size()*8);
 
-   tsalloc.set32(startCluster.size());
-   tsalloc.copyToBuffer32((S32*)startCluster.address(),startCluster.size());
+   alloc->set32(startCluster.size());
+   alloc->copyToBuffer32((S32*)startCluster.address(),startCluster.size());
 
-   tsalloc.set32(firstVerts.size());
-   tsalloc.copyToBuffer32((S32*)firstVerts.address(),firstVerts.size());
+   alloc->set32(firstVerts.size());
+   alloc->copyToBuffer32((S32*)firstVerts.address(),firstVerts.size());
 
-   tsalloc.set32(numVerts.size());
-   tsalloc.copyToBuffer32((S32*)numVerts.address(),numVerts.size());
+   alloc->set32(numVerts.size());
+   alloc->copyToBuffer32((S32*)numVerts.address(),numVerts.size());
 
-   tsalloc.set32(firstTVerts.size());
-   tsalloc.copyToBuffer32((S32*)firstTVerts.address(),firstTVerts.size());
+   alloc->set32(firstTVerts.size());
+   alloc->copyToBuffer32((S32*)firstTVerts.address(),firstTVerts.size());
 
-   tsalloc.set32(alwaysWriteDepth ? 1 : 0);
+   alloc->set32(alwaysWriteDepth ? 1 : 0);
 
-   tsalloc.setGuard();
+   alloc->setGuard();
 }
 
 
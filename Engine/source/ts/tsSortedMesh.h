@@ -67,8 +67,8 @@ public:
                            ///  @returns false ALWAYS
    S32 getNumPolys();
 
-   void assemble(bool skip);
-   void disassemble();
+   void assemble(TSShapeAlloc* alloc, bool skip);
+   void disassemble(TSShapeAlloc* alloc);
 
    TSSortedMesh() {
       meshType = SortedMeshType;
@@ -665,9 +665,9 @@ void TSShapeInstance::updateTransitions()
    for (i=0; i<mShape->nodes.size(); i++)
    {
       if (mTransitionRotationNodes.test(i))
-         mNodeReferenceRotations[i].set(smNodeCurrentRotations[i]);
+         mNodeReferenceRotations[i].set(mNodeCurrentRotations[i]);
       if (mTransitionTranslationNodes.test(i))
-         mNodeReferenceTranslations[i] = smNodeCurrentTranslations[i];
+         mNodeReferenceTranslations[i] = mNodeCurrentTranslations[i];
    }
 
    if (animatesScale())
@@ -682,7 +682,7 @@ void TSShapeInstance::updateTransitions()
          for (i=0; i<mShape->nodes.size(); i++)
          {
             if (mTransitionScaleNodes.test(i))
-               mNodeReferenceUniformScales[i] = smNodeCurrentUniformScales[i];
+               mNodeReferenceUniformScales[i] = mNodeCurrentUniformScales[i];
          }
       }
       else if (animatesAlignedScale())
@@ -691,7 +691,7 @@ void TSShapeInstance::updateTransitions()
          for (i=0; i<mShape->nodes.size(); i++)
          {
             if (mTransitionScaleNodes.test(i))
-               mNodeReferenceScaleFactors[i] = smNodeCurrentAlignedScales[i];
+               mNodeReferenceScaleFactors[i] = mNodeCurrentAlignedScales[i];
          }
       }
       else
@@ -702,8 +702,8 @@ void TSShapeInstance::updateTransitions()
          {
             if (mTransitionScaleNodes.test(i))
             {
-               mNodeReferenceScaleFactors[i] = smNodeCurrentArbitraryScales[i].mScale;
-               mNodeReferenceArbitraryScaleRots[i].set(smNodeCurrentArbitraryScales[i].mRotate);
+               mNodeReferenceScaleFactors[i] = mNodeCurrentArbitraryScales[i].mScale;
+               mNodeReferenceArbitraryScaleRots[i].set(mNodeCurrentArbitraryScales[i].mRotate);
             }
          }
       }
@@ -153,6 +153,11 @@
 /// texture manager.
 #define TORQUE_FRAME_SIZE     32 << 20
 
+/// This #define sets the size of the FrameAllocator arenas of threads other
+/// than the main thread, such as ThreadPool workers. It can be changed at
+/// runtime with $FrameAllocator::threadFrameSize.
+#define TORQUE_THREAD_FRAME_SIZE     4 << 20
+
 // Finally, we define some dependent #defines. This enables some subsidiary
 // functionality to get automatically turned on in certain configurations.
 
@@ -241,7 +241,9 @@ addPath("${srcDir}/sfx/media")
 addPath("${srcDir}/sfx/null")
 addPath("${srcDir}/sfx")
 addPath("${srcDir}/console")
+addPath("${srcDir}/console/test")
 addPath("${srcDir}/core")
+addPath("${srcDir}/core/test")
 addPath("${srcDir}/core/stream")
 addPath("${srcDir}/core/strings")
 addPath("${srcDir}/core/util")
@@ -253,6 +255,7 @@ addPath("${srcDir}/core/util/zip/test")
 addPath("${srcDir}/core/util/zip/compressors")
 addPath("${srcDir}/i18n")
 addPath("${srcDir}/sim")
+addPath("${srcDir}/sim/test")
 addPath("${srcDir}/util")
 addPath("${srcDir}/windowManager")
 addPath("${srcDir}/windowManager/torque")
@@ -301,14 +304,17 @@ addPath("${srcDir}/gui/shiny")
 addPath("${srcDir}/gui/utility")
 addPath("${srcDir}/gui")
 addPath("${srcDir}/collision")
+addPath("${srcDir}/collision/test")
 addPath("${srcDir}/materials")
 addPath("${srcDir}/lighting")
 addPath("${srcDir}/lighting/common")
 addPath("${srcDir}/renderInstance")
+addPath("${srcDir}/renderInstance/test")
 addPath("${srcDir}/scene")
 addPath("${srcDir}/scene/culling")
 addPath("${srcDir}/scene/zones")
 addPath("${srcDir}/scene/mixin")
+addPath("${srcDir}/scene/test")
 addPath("${srcDir}/shaderGen")
 addPath("${srcDir}/terrain")
 addPath("${srcDir}/environment")
@@ -316,6 +322,7 @@ addPath("${srcDir}/forest")
 addPath("${srcDir}/forest/ts")
 addPath("${srcDir}/ts")
 addPath("${srcDir}/ts/arch")
+addPath("${srcDir}/ts/test")
 addPath("${srcDir}/physics")
 addPath("${srcDir}/gui/3d")
 addPath("${srcDir}/postFx")
@@ -332,8 +339,11 @@ addPath("${srcDir}/T3D/fx")
 addPath("${srcDir}/T3D/vehicles")
 addPath("${srcDir}/T3D/physics")
 addPath("${srcDir}/T3D/decal")
+addPath("${srcDir}/T3D/decal/test")
 addPath("${srcDir}/T3D/sfx")
 addPath("${srcDir}/T3D/gameBase")
+addPath("${srcDir}/T3D/gameBase/test")
+addPath("${srcDir}/T3D/fx/test")
 addPath("${srcDir}/T3D/turret")
 
 if( TORQUE_EXPERIMENTAL_EC )
@@ -348,6 +358,7 @@ endif()
 
 addPath("${srcDir}/main/")
 addPath("${srcDir}/assets")
+addPath("${srcDir}/assets/test")
 addPath("${srcDir}/module")
 addPath("${srcDir}/T3D/assets")
 addPathRec("${srcDir}/persistence")